@@ -610,16 +610,12 @@ int32_t ad469x_exit_conversion_mode(struct ad469x_dev *dev)
 
 	commands_data[0] = AD469x_CMD_REG_CONFIG_MODE << 8;
 
-	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
-	if (ret != SUCCESS)
-		return ret;
-
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
 	msg.rx_addr = (uint32_t)&buf;
 	msg.commands_data = commands_data;
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, 1);
+	ret = spi_engine_session_transfer(dev->offload, &msg, 1);
 	if (ret != SUCCESS)
 		return ret;
 
@@ -722,25 +718,105 @@ int32_t ad469x_read_data(struct ad469x_dev *dev,
 
 	pwm_enable(dev->trigger_pwm_desc);
 
-	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
+	msg.commands = spi_eng_msg_cmds;
+	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
+	msg.rx_addr = (uint32_t)buf;
+	msg.commands_data = commands_data;
+
+	ret = spi_engine_session_transfer(dev->offload, &msg, samples * 2);
 	if (ret != SUCCESS)
 		return ret;
 
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range(msg.rx_addr, samples * 4);
+
+	return ret;
+}
+
+/**
+ * @brief Start sampling a channel continuously in a ring buffer.
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] channel - ad469x selected channel.
+ * @param [in] param - Ring buffer, the period size is in executions of the
+ * read program, as the samples of ad469x_read_data().
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad469x_stream_start(struct ad469x_dev *dev,
+			    uint8_t channel,
+			    const struct spi_engine_stream_init_param *param)
+{
+	int32_t ret;
+	uint32_t commands_data[1];
+	struct spi_engine_offload_message msg;
+	uint32_t spi_eng_msg_cmds[3] = {
+		CS_LOW,
+		WRITE_READ(1),
+		CS_HIGH
+	};
+	if (channel < AD469x_CHANNEL_NO)
+		commands_data[0] = AD469x_CMD_CONFIG_CH_SEL(channel) << 8;
+	else if (channel == AD469x_CHANNEL_TEMP)
+		commands_data[0] = AD469x_CMD_SEL_TEMP_SNSOR_CH << 8;
+	else
+		return FAILURE;
+
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
-	msg.rx_addr = (uint32_t)buf;
 	msg.commands_data = commands_data;
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples * 2);
+	ret = spi_engine_session_load(dev->offload, &msg);
 	if (ret != SUCCESS)
 		return ret;
 
+	pwm_enable(dev->trigger_pwm_desc);
+
+	return spi_engine_stream_start(dev->offload, param);
+}
+
+/**
+ * @brief Get a slice of the samples captured since ad469x_stream_start().
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] size - Maximum size of the slice in bytes.
+ * @param [out] buf - Address of the slice.
+ * @param [out] avail - Size of the slice in bytes.
+ * @return \ref SUCCESS in case of success, -EOVERRUN if samples were lost
+ *         before the slice, -EAGAIN if no sample is available yet.
+ */
+int32_t ad469x_stream_read(struct ad469x_dev *dev, uint32_t size,
+			   uint32_t **buf, uint32_t *avail)
+{
+	int32_t ret;
+
+	ret = spi_engine_stream_read(dev->offload, size, (void **)buf, avail);
+	if (ret != SUCCESS && ret != -EOVERRUN)
+		return ret;
+
 	if (dev->dcache_invalidate_range)
-		dev->dcache_invalidate_range(msg.rx_addr, samples * 4);
+		dev->dcache_invalidate_range((uint32_t)*buf, *avail);
 
 	return ret;
 }
 
+/**
+ * @brief Release the slice returned by ad469x_stream_read().
+ * @param [in] dev - ad469x_dev device handler.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad469x_stream_release(struct ad469x_dev *dev)
+{
+	return spi_engine_stream_release(dev->offload);
+}
+
+/**
+ * @brief Stop the continuous sampling.
+ * @param [in] dev - ad469x_dev device handler.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad469x_stream_stop(struct ad469x_dev *dev)
+{
+	return spi_engine_stream_stop(dev->offload);
+}
+
 /**
  * Initialize the device.
  * @param [out] device - The device structure.
@@ -783,6 +859,11 @@ int32_t ad469x_init(struct ad469x_dev **device,
 
 	dev->offload_init_param = init_param->offload_init_param;
 
+	ret = spi_engine_session_init(&dev->offload, dev->spi_desc,
+				      dev->offload_init_param);
+	if (ret != SUCCESS)
+		goto error_offload;
+
 	dev->reg_access_speed = init_param->reg_access_speed;
 	dev->reg_data_width = init_param->reg_data_width;
 	dev->capture_data_width = init_param->capture_data_width;
@@ -825,6 +906,8 @@ int32_t ad469x_init(struct ad469x_dev **device,
 	return ret;
 
 error_spi:
+	spi_engine_session_remove(dev->offload);
+error_offload:
 	spi_remove(dev->spi_desc);
 error_gpio:
 	gpio_remove(dev->gpio_resetn);
@@ -852,6 +935,10 @@ int32_t ad469x_remove(struct ad469x_dev *dev)
 	if (ret != SUCCESS)
 		return ret;
 
+	ret = spi_engine_session_remove(dev->offload);
+	if (ret != SUCCESS)
+		return ret;
+
 	ret = spi_remove(dev->spi_desc);
 	if (ret != SUCCESS)
 		return ret;
@@ -234,6 +234,8 @@ struct ad469x_dev {
 	struct pwm_desc		*trigger_pwm_desc;
 	/* SPI module offload init */
 	struct spi_engine_offload_init_param *offload_init_param;
+	/* SPI module offload session */
+	struct spi_engine_session *offload;
 	/* Register access speed */
 	uint32_t		reg_access_speed;
 	/* Register data width */
@@ -290,6 +292,21 @@ int32_t ad469x_read_data(struct ad469x_dev *dev,
 			 uint32_t *buf,
 			 uint16_t samples);
 
+/* Start sampling a channel continuously in a ring buffer */
+int32_t ad469x_stream_start(struct ad469x_dev *dev,
+			    uint8_t channel,
+			    const struct spi_engine_stream_init_param *param);
+
+/* Get a slice of the samples of the ring buffer */
+int32_t ad469x_stream_read(struct ad469x_dev *dev, uint32_t size,
+			   uint32_t **buf, uint32_t *avail);
+
+/* Release the slice returned by ad469x_stream_read() */
+int32_t ad469x_stream_release(struct ad469x_dev *dev);
+
+/* Stop the continuous sampling */
+int32_t ad469x_stream_stop(struct ad469x_dev *dev);
+
 /* Read from device when converter has the channel sequencer activated */
 int32_t ad469x_seq_read_data(struct ad469x_dev *dev,
 			     uint32_t *buf,
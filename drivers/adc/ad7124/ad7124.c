@@ -45,6 +45,7 @@
 #include <stdbool.h>
 #include "ad7124.h"
 #include "delay.h"
+#include "crc8.h"
 
 /* Error codes */
 #define INVALID_VAL -1 /* Invalid argument */
@@ -58,6 +59,10 @@
  */
 #define AD7124_POST_RESET_DELAY      4
 
+/* Register access CRC table, created by the first ad7124_compute_crc8() */
+DECLARE_CRC8_TABLE(ad7124_crc8);
+static bool ad7124_crc8_populated;
+
 
 /***************************************************************************//**
  * @brief Reads the value of the specified register without checking if the
@@ -472,24 +477,13 @@ int32_t ad7124_get_read_chan_id(struct ad7124_dev *dev, uint32_t *status)
 *******************************************************************************/
 uint8_t ad7124_compute_crc8(uint8_t * p_buf, uint8_t buf_size)
 {
-	uint8_t i = 0;
-	uint8_t crc = 0;
-
-	while(buf_size) {
-		for(i = 0x80; i != 0; i >>= 1) {
-			bool cmp1 = (crc & 0x80) != 0;
-			bool cmp2 = (*p_buf & i) != 0;
-			if(cmp1 != cmp2) { /* MSB of CRC register XOR input Bit from Data */
-				crc <<= 1;
-				crc ^= AD7124_CRC8_POLYNOMIAL_REPRESENTATION;
-			} else {
-				crc <<= 1;
-			}
-		}
-		p_buf++;
-		buf_size--;
+	if (!ad7124_crc8_populated) {
+		crc8_populate_msb(ad7124_crc8,
+				  AD7124_CRC8_POLYNOMIAL_REPRESENTATION);
+		ad7124_crc8_populated = true;
 	}
-	return crc;
+
+	return crc8(ad7124_crc8, p_buf, buf_size, 0);
 }
 
 /***************************************************************************//**
@@ -50,6 +50,7 @@
 #include "error.h"
 #include "util.h"
 #include "iio_types.h"
+#include "iio_demux.h"
 #include "spi_engine.h"
 #include "iio_dual_ad713x.h"
 #include "delay.h"
@@ -60,6 +61,15 @@
 
 #define BITS_PER_SAMPLE 32
 
+/* Offload words, 24 bits of data starting at bit 7 */
+static const struct scan_type adc_raw_scan_type = {
+	.sign = 'u',
+	.realbits = 24,
+	.storagebits = BITS_PER_SAMPLE,
+	.shift = 7,
+	.is_big_endian = false
+};
+
 static struct scan_type adc_scan_type = {
 	.sign = 'u',
 	.realbits = BITS_PER_SAMPLE,
@@ -97,9 +107,15 @@ static struct iio_channel iio_adc_channels[] = {
 static int32_t _iio_ad713x_prepare_transfer(struct iio_ad713x *desc,
 		uint32_t mask)
 {
+	int32_t ret;
+
 	if (!desc)
 		return -EINVAL;
 
+	ret = iio_demux_compile(desc->demux, mask);
+	if (ret != SUCCESS)
+		return ret;
+
 	desc->mask = mask;
 
 	return SUCCESS;
@@ -109,37 +125,28 @@ static int32_t _iio_ad713x_read_dev(struct iio_ad713x *desc, uint32_t *buff,
 				    uint32_t nb_samples)
 {
 	struct spi_engine_offload_message *msg;
+	uint32_t no_samples;
 	uint32_t bytes;
-	uint32_t data;
 	int32_t  ret;
-	uint8_t  ch;
-	uint32_t i;
-	uint32_t j;
-	uint32_t *rx;
 
 	if (!desc)
 		return FAILURE;
 
-	bytes = nb_samples * desc->iio_dev_desc.num_ch *
-		(BITS_PER_SAMPLE / 8);
+	/* The program reads one channel on each execution */
+	no_samples = nb_samples * desc->iio_dev_desc.num_ch;
+	bytes = no_samples * (BITS_PER_SAMPLE / 8);
 	msg = desc->spi_engine_offload_message;
-	ret = spi_engine_offload_transfer(desc->spi_eng_desc, *msg, bytes);
+	ret = spi_engine_session_transfer(desc->offload, msg, no_samples);
 	if (ret < 0)
 		return ret;
 
 	if (desc->dcache_invalidate_range)
 		desc->dcache_invalidate_range(msg->rx_addr, bytes);
 
-	rx = (uint32_t *)desc->spi_engine_offload_message->rx_addr;
-	for (i = 0, j = 0; i < nb_samples; i++)
-		for (ch = 0; ch < desc->iio_dev_desc.num_ch; ch++)
-			if (desc->mask & BIT(ch)) {
-				data = rx[i * desc->iio_dev_desc.num_ch + ch];
-				data <<= 1;
-				data &= 0xffffff00;
-				data >>= 8;
-				buff[j++] = data;
-			}
+	ret = iio_demux_run(desc->demux, (void *)msg->rx_addr, buff,
+			    nb_samples);
+	if (ret != SUCCESS)
+		return ret;
 
 	return nb_samples;
 }
@@ -165,13 +172,26 @@ void iio_dual_ad713x_get_dev_descriptor(struct iio_ad713x *desc,
 int32_t iio_dual_ad713x_init(struct iio_ad713x **desc,
 			     struct iio_ad713x_init_par *param)
 {
+	struct iio_demux_init_param demux_param;
 	struct iio_ad713x *iio_ad713x;
+	int32_t ret;
 
 	iio_ad713x = (struct iio_ad713x *)calloc(1, sizeof(struct iio_ad713x));
 	if (!iio_ad713x)
 		return FAILURE;
 
-	iio_ad713x->spi_eng_desc = param->spi_eng_desc;
+	demux_param = (struct iio_demux_init_param) {
+		.nb_channels = param->num_channels,
+		.raw = &adc_raw_scan_type,
+		.out = &adc_scan_type
+	};
+	ret = iio_demux_init(&iio_ad713x->demux, &demux_param);
+	if (ret != SUCCESS) {
+		free(iio_ad713x);
+		return ret;
+	}
+
+	iio_ad713x->offload = param->offload;
 	iio_ad713x->spi_engine_offload_message = param->spi_engine_offload_message;
 	iio_ad713x->dcache_invalidate_range = param->dcache_invalidate_range;
 
@@ -197,6 +217,7 @@ int32_t iio_dual_ad713x_remove(struct iio_ad713x *desc)
 	if (!desc)
 		return FAILURE;
 
+	iio_demux_remove(desc->demux);
 	free(desc);
 
 	return SUCCESS;
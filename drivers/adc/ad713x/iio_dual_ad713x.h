@@ -48,6 +48,7 @@
 #include <stdio.h>
 #include "ad713x.h"
 #include "iio_types.h"
+#include "iio_demux.h"
 #include "spi.h"
 
 /******************************************************************************/
@@ -63,8 +64,8 @@ struct iio_ad713x_init_par {
 	uint8_t	num_channels;
 	/* Device instance */
 	struct ad713x_dev *dev;
-	/** Spi engine descriptor */
-	struct spi_desc *spi_eng_desc;
+	/** Spi engine offload session */
+	struct spi_engine_session *offload;
 	/** Spi engine message descriptor */
 	struct spi_engine_offload_message *spi_engine_offload_message;
 	/** Invalidate the Data cache for the given address range */
@@ -76,12 +77,14 @@ struct iio_ad713x {
 	uint32_t mask;
 	/** iio device descriptor */
 	struct iio_device iio_dev_desc;
-	/** Spi engine descriptor */
-	struct spi_desc *spi_eng_desc;
+	/** Spi engine offload session */
+	struct spi_engine_session *offload;
 	/** Spi engine message descriptor */
 	struct spi_engine_offload_message *spi_engine_offload_message;
 	/** Invalidate the Data cache for the given address range */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** Converts the offload words to samples of the active channels */
+	struct iio_demux *demux;
 };
 
 /******************************************************************************/
@@ -288,25 +288,94 @@ int32_t ad738x_read_data(struct ad738x_dev *dev,
 		CS_HIGH,
 	};
 
-	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
+	msg.commands_data = commands_data;
+	msg.commands = spi_eng_msg_cmds;
+	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
+	msg.rx_addr = (uint32_t)buf;
+
+	ret = spi_engine_session_transfer(dev->offload, &msg, samples);
 	if (ret != SUCCESS)
 		return ret;
 
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range(msg.rx_addr, samples * 2);
+
+	return ret;
+}
+
+
+/**
+ * @brief Start sampling continuously in a ring buffer.
+ * @param dev - ad738x_dev device handler.
+ * @param param - Ring buffer, the period size is in samples.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad738x_stream_start(struct ad738x_dev *dev,
+			    const struct spi_engine_stream_init_param *param)
+{
+	int32_t ret;
+	uint32_t commands_data[2] = {0, 0};
+	struct spi_engine_offload_message msg;
+	uint32_t spi_eng_msg_cmds[3] = {
+		CS_LOW,
+		WRITE_READ(2),
+		CS_HIGH,
+	};
+
 	msg.commands_data = commands_data;
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
-	msg.rx_addr = (uint32_t)buf;
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples);
+	ret = spi_engine_session_load(dev->offload, &msg);
 	if (ret != SUCCESS)
 		return ret;
 
+	return spi_engine_stream_start(dev->offload, param);
+}
+
+/**
+ * @brief Get a slice of the samples captured since ad738x_stream_start().
+ * @param dev - ad738x_dev device handler.
+ * @param size - Maximum size of the slice in bytes.
+ * @param buf - Address of the slice.
+ * @param avail - Size of the slice in bytes.
+ * @return \ref SUCCESS in case of success, -EOVERRUN if samples were lost
+ *         before the slice, -EAGAIN if no sample is available yet.
+ */
+int32_t ad738x_stream_read(struct ad738x_dev *dev, uint32_t size,
+			   uint32_t **buf, uint32_t *avail)
+{
+	int32_t ret;
+
+	ret = spi_engine_stream_read(dev->offload, size, (void **)buf, avail);
+	if (ret != SUCCESS && ret != -EOVERRUN)
+		return ret;
+
 	if (dev->dcache_invalidate_range)
-		dev->dcache_invalidate_range(msg.rx_addr, samples * 2);
+		dev->dcache_invalidate_range((uint32_t)*buf, *avail);
 
 	return ret;
 }
 
+/**
+ * @brief Release the slice returned by ad738x_stream_read().
+ * @param dev - ad738x_dev device handler.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad738x_stream_release(struct ad738x_dev *dev)
+{
+	return spi_engine_stream_release(dev->offload);
+}
+
+/**
+ * @brief Stop the continuous sampling.
+ * @param dev - ad738x_dev device handler.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad738x_stream_stop(struct ad738x_dev *dev)
+{
+	return spi_engine_stream_stop(dev->offload);
+}
 
 /**
  * Initialize the device.
@@ -331,6 +400,18 @@ int32_t ad738x_init(struct ad738x_dev **device,
 	dev->ref_sel = init_param->ref_sel;
 
 	ret = spi_init(&dev->spi_desc, init_param->spi_param);
+	if (ret != SUCCESS) {
+		free(dev);
+		return ret;
+	}
+
+	ret = spi_engine_session_init(&dev->offload, dev->spi_desc,
+				      dev->offload_init_param);
+	if (ret != SUCCESS) {
+		spi_remove(dev->spi_desc);
+		free(dev);
+		return ret;
+	}
 
 	ret |= ad738x_reset(dev, HARD_RESET);
 	mdelay(1000);
@@ -356,7 +437,8 @@ int32_t ad738x_remove(struct ad738x_dev *dev)
 {
 	int32_t ret;
 
-	ret = spi_remove(dev->spi_desc);
+	ret = spi_engine_session_remove(dev->offload);
+	ret |= spi_remove(dev->spi_desc);
 
 	free(dev);
 
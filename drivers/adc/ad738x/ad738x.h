@@ -45,6 +45,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include "util.h"
+#include "spi_engine.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -157,6 +158,8 @@ struct ad738x_dev {
 	spi_desc		*spi_desc;
 	/** SPI module offload init */
 	struct spi_engine_offload_init_param *offload_init_param;
+	/** SPI module offload session */
+	struct spi_engine_session *offload;
 	/* Device Settings */
 	enum ad738x_conv_mode 	conv_mode;
 	enum ad738x_ref_sel		ref_sel;
@@ -222,4 +225,14 @@ int32_t ad738x_reference_sel(struct ad738x_dev *dev,
 int32_t ad738x_read_data(struct ad738x_dev *dev,
 			 uint32_t *buf,
 			 uint16_t samples);
+/** Start sampling continuously in a ring buffer. */
+int32_t ad738x_stream_start(struct ad738x_dev *dev,
+			    const struct spi_engine_stream_init_param *param);
+/** Get a slice of the samples of the ring buffer. */
+int32_t ad738x_stream_read(struct ad738x_dev *dev, uint32_t size,
+			   uint32_t **buf, uint32_t *avail);
+/** Release the slice returned by ad738x_stream_read(). */
+int32_t ad738x_stream_release(struct ad738x_dev *dev);
+/** Stop the continuous sampling. */
+int32_t ad738x_stream_stop(struct ad738x_dev *dev);
 #endif /* SRC_AD738X_H_ */
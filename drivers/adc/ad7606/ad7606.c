@@ -50,6 +50,7 @@
 #include "error.h"
 #include "util.h"
 #include "crc.h"
+#include "sample_unpack.h"
 
 struct ad7606_chip_info {
 	uint8_t num_channels;
@@ -65,7 +66,7 @@ struct ad7606_chip_info {
 };
 
 DECLARE_CRC8_TABLE(ad7606_crc8);
-DECLARE_CRC16_TABLE(ad7606_crc16);
+DECLARE_CRC_TABLE(ad7606_crc16, 4);
 
 static const struct ad7606_range ad7606_range_table[] = {
 	{-5000, 5000, false},	/* RANGE pin LOW */
@@ -354,52 +355,6 @@ int32_t ad7606_spi_write_mask(struct ad7606_dev *dev,
 	return ad7606_spi_reg_write(dev, addr, reg_data);
 }
 
-/* Internal function to copy the content of a buffer in 18-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy18b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 9)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 9) {
-		j = 4 * (i / 9);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 10) | ((uint32_t)psrc[i+1] << 2)
-			    | ((uint32_t)psrc[i+2] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+2] & 0x3f) << 12) | ((uint32_t)psrc[i+3] << 4)
-			    | ((uint32_t)psrc[i+4] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+4] & 0x0f) << 14) | ((uint32_t)psrc[i+5] << 6)
-			    | ((uint32_t)psrc[i+6] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+6] & 0x03) << 16) | ((uint32_t)psrc[i+7] << 8)
-			    | ((uint32_t)psrc[i+8] >> 0);
-	}
-	return SUCCESS;
-}
-
-/* Internal function to copy the content of a buffer in 26-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy26b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
-{
-	unsigned int i, j;
-
-	if (srcsz % 13)
-		return -EINVAL;
-
-	for(i = 0; i < srcsz; i += 13) {
-		j = 4 * (i / 13);
-		pdst[j+0] = ((uint32_t)(psrc[i+0] & 0xff) << 18) | ((uint32_t)psrc[i+1] << 10)
-			    | ((uint32_t)psrc[i+2] << 2) | ((uint32_t)psrc[i+3] >> 6);
-		pdst[j+1] = ((uint32_t)(psrc[i+3] & 0x3f) << 20) | ((uint32_t)psrc[i+4] << 12)
-			    | ((uint32_t)psrc[i+5] << 4) | ((uint32_t)psrc[i+6] >> 4);
-		pdst[j+2] = ((uint32_t)(psrc[i+6] & 0x0f) << 22) | ((uint32_t)psrc[i+7] << 14)
-			    | ((uint32_t)psrc[i+8] << 6) | ((uint32_t)psrc[i+9] >> 2);
-		pdst[j+3] = ((uint32_t)(psrc[i+9] & 0x03) << 24) | ((uint32_t)psrc[i+10] << 16)
-			    | ((uint32_t)psrc[i+11] << 8) | ((uint32_t)psrc[i+12] >> 0);
-	}
-	return SUCCESS;
-}
-
 /***************************************************************************//**
  * @brief Toggle the CONVST pin to start a conversion.
  *
@@ -459,7 +414,7 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 {
 	uint32_t sz;
-	int32_t ret, i;
+	int32_t ret;
 	uint16_t crc, icrc;
 	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
 	uint8_t sbits = dev->config.status_header ? 8 : 0;
@@ -488,7 +443,7 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 
 	if (dev->digital_diag_enable.int_crc_err_en) {
 		sz -= 2;
-		crc = crc16(ad7606_crc16, dev->data, sz, 0);
+		crc = crc_compute(&ad7606_crc16, dev->data, sz, 0);
 		icrc = ((uint16_t)dev->data[sz] << 8) |
 		       dev->data[sz+1];
 		if (icrc != crc)
@@ -497,24 +452,9 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 
 	switch(bits) {
 	case 18:
-		if (dev->config.status_header)
-			ret = cpy26b32b(dev->data, sz, data);
-		else
-			ret = cpy18b32b(dev->data, sz, data);
-		if (ret < 0)
-			return ret;
-		break;
 	case 16:
-		for(i = 0; i < nchannels; i++) {
-			if (dev->config.status_header) {
-				data[i] = (uint32_t)dev->data[i*3] << 16;
-				data[i] |= (uint32_t)dev->data[i*3+1] << 8;
-				data[i] |= (uint32_t)dev->data[i*3+2];
-			} else {
-				data[i] = (uint32_t)dev->data[i*2] << 8;
-				data[i] |= (uint32_t)dev->data[i*2+1];
-			}
-		}
+		/* The status, when enabled, stays in the lowest 8 bits */
+		ret = sample_unpack(dev->data, data, nchannels, bits + sbits, 0);
 		break;
 	default:
 		ret = -ENOTSUP;
@@ -1110,7 +1050,7 @@ int32_t ad7606_init(struct ad7606_dev **device,
 	int32_t i, ret;
 
 	crc8_populate_msb(ad7606_crc8, 0x7);
-	crc16_populate_msb(ad7606_crc16, 0x755b);
+	crc_populate_msb(&ad7606_crc16, 16, 0x755b);
 
 	dev = (struct ad7606_dev *)calloc(1, sizeof(*dev));
 	if (!dev)
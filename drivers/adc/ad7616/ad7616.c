@@ -399,10 +399,6 @@ int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
 	dev->spi_desc->mode = SPI_MODE_3;
 	spi_engine_set_speed(dev->spi_desc, dev->spi_desc->max_speed_hz);
 
-	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
-	if (ret != SUCCESS)
-		return ret;
-
 	msg.commands_data = commands_data;
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
@@ -411,7 +407,7 @@ int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
 	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
 		     AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples);
+	ret = spi_engine_session_transfer(dev->offload, &msg, samples);
 	if (ret != SUCCESS)
 		return ret;
 
@@ -423,6 +419,92 @@ int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
 	return ret;
 }
 
+/**
+ * @brief Start sampling continuously in a ring buffer in serial mode.
+ * @param dev - ad7616_dev device handler.
+ * @param param - Ring buffer, the period size is in samples.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad7616_stream_start_serial(struct ad7616_dev *dev,
+		const struct spi_engine_stream_init_param *param)
+{
+	int32_t ret;
+	uint32_t commands_data[1] = {0x00};
+	struct spi_engine_offload_message msg;
+	uint32_t spi_eng_msg_cmds[3] = {
+		CS_LOW,
+		READ(2),
+		CS_HIGH,
+	};
+
+	dev->spi_desc->mode = SPI_MODE_3;
+	spi_engine_set_speed(dev->spi_desc, dev->spi_desc->max_speed_hz);
+
+	msg.commands_data = commands_data;
+	msg.commands = spi_eng_msg_cmds;
+	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
+
+	ret = spi_engine_session_load(dev->offload, &msg);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = spi_engine_stream_start(dev->offload, param);
+	if (ret != SUCCESS)
+		return ret;
+
+	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL,
+		     AD7616_CTRL_RESETN | AD7616_CTRL_CNVST_EN);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get a slice of the samples captured since
+ *        ad7616_stream_start_serial().
+ * @param dev - ad7616_dev device handler.
+ * @param size - Maximum size of the slice in bytes.
+ * @param buf - Address of the slice.
+ * @param avail - Size of the slice in bytes.
+ * @return \ref SUCCESS in case of success, -EOVERRUN if samples were lost
+ *         before the slice, -EAGAIN if no sample is available yet.
+ */
+int32_t ad7616_stream_read(struct ad7616_dev *dev, uint32_t size,
+			   uint32_t **buf, uint32_t *avail)
+{
+	int32_t ret;
+
+	ret = spi_engine_stream_read(dev->offload, size, (void **)buf, avail);
+	if (ret != SUCCESS && ret != -EOVERRUN)
+		return ret;
+
+	if (dev->dcache_invalidate_range)
+		dev->dcache_invalidate_range((uint32_t)*buf, *avail);
+
+	return ret;
+}
+
+/**
+ * @brief Release the slice returned by ad7616_stream_read().
+ * @param dev - ad7616_dev device handler.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad7616_stream_release(struct ad7616_dev *dev)
+{
+	return spi_engine_stream_release(dev->offload);
+}
+
+/**
+ * @brief Stop the continuous sampling.
+ * @param dev - ad7616_dev device handler.
+ * @return \ref SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad7616_stream_stop(struct ad7616_dev *dev)
+{
+	axi_io_write(dev->core_baseaddr, AD7616_REG_UP_CTRL, AD7616_CTRL_RESETN);
+
+	return spi_engine_stream_stop(dev->offload);
+}
+
 /**
  * @brief Read from device in parallel mode.
  *        Enter register mode to read/write registers
@@ -515,12 +597,20 @@ int32_t ad7616_setup(struct ad7616_dev **device,
 
 	ad7616_core_setup(dev);
 
-	if (dev->interface == AD7616_SERIAL)
+	if (dev->interface == AD7616_SERIAL) {
 		ret = spi_init(&dev->spi_desc, init_param->spi_param);
+		if (ret != SUCCESS) {
+			free(dev);
+			return ret;
+		}
 
-	if (ret != SUCCESS) {
-		free(dev);
-		return ret;
+		ret = spi_engine_session_init(&dev->offload, dev->spi_desc,
+					      dev->offload_init_param);
+		if (ret != SUCCESS) {
+			spi_remove(dev->spi_desc);
+			free(dev);
+			return ret;
+		}
 	}
 
 	spi_engine_set_speed(dev->spi_desc, dev->reg_access_speed);
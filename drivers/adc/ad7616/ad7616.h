@@ -41,6 +41,7 @@
 #define AD7616_H_
 
 #include "gpio.h"
+#include "spi_engine.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -143,6 +144,7 @@ struct ad7616_dev {
 	/* SPI */
 	struct spi_desc		*spi_desc;
 	struct spi_engine_offload_init_param *offload_init_param;
+	struct spi_engine_session *offload;
 	uint32_t reg_access_speed;
 	/* GPIO */
 	struct gpio_desc	*gpio_hw_rngsel0;
@@ -237,6 +239,16 @@ int32_t ad7616_set_oversampling_ratio(struct ad7616_dev *dev,
 int32_t ad7616_read_data_serial(struct ad7616_dev *dev,
 				uint32_t *buf,
 				uint32_t samples);
+/* Start sampling continuously in a ring buffer in serial mode. */
+int32_t ad7616_stream_start_serial(struct ad7616_dev *dev,
+		const struct spi_engine_stream_init_param *param);
+/* Get a slice of the samples of the ring buffer. */
+int32_t ad7616_stream_read(struct ad7616_dev *dev, uint32_t size,
+			   uint32_t **buf, uint32_t *avail);
+/* Release the slice returned by ad7616_stream_read(). */
+int32_t ad7616_stream_release(struct ad7616_dev *dev);
+/* Stop the continuous sampling. */
+int32_t ad7616_stream_stop(struct ad7616_dev *dev);
 /* Read data in parallel mode. */
 int32_t ad7616_read_data_parallel(struct ad7616_dev *dev,
 				  uint32_t *buf,
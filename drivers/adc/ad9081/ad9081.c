@@ -853,12 +853,14 @@ static int32_t ad9081_spi_xfer(void *user_data, uint8_t *in_data,
 			       uint8_t *out_data, uint32_t size_bytes)
 {
 	struct ad9081_phy *phy = user_data;
-	uint8_t data[6];
+	uint8_t data[AD9081_HAL_STREAM_MAX + 2];
 	uint16_t bytes_number;
 	int32_t ret;
 	int32_t i;
 
 	bytes_number = (size_bytes & 0xFF);
+	if (bytes_number > sizeof(data))
+		return FAILURE;
 
 	if (phy->ad9081.hal_info.msb == SPI_MSB_FIRST) {
 		for (i = 0; i < bytes_number; i++)
@@ -874,6 +876,9 @@ static int32_t ad9081_spi_xfer(void *user_data, uint8_t *in_data,
 	if (ret != SUCCESS)
 		return FAILURE;
 
+	if (!out_data)
+		return SUCCESS;
+
 	if (phy->ad9081.hal_info.msb == SPI_MSB_FIRST) {
 		for (i = 0; i < bytes_number; i++)
 			out_data[i] =  data[i];
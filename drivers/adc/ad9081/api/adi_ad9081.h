@@ -41,6 +41,14 @@
 #define AD9081_USE_FLOATING_TYPE 0
 #define AD9081_USE_SPI_BURST_MODE 0
 
+#define AD9081_HAL_STREAM_MAX 64
+#define AD9081_HAL_TXN_BYTES 256
+#define AD9081_HAL_TXN_RUNS 32
+#define AD9081_HAL_SHADOW_REGS 64
+#define AD9081_HAL_SHADOW_PAGES 8
+#define AD9081_HAL_PAGE_REGS 10
+#define AD9081_HAL_BF_BYTES 16
+
 /*!
  * @brief Enumerates Chip Output Resolution
  */
@@ -608,6 +616,81 @@ typedef struct {
 	uint8_t dev_rev; /*!< Device revision, 0:r0, 1:r1, 2:r1r, 3:r2 */
 } adi_ad9081_info_t;
 
+/*!
+ * @brief Enumerates HAL Entry Points Counted By The SPI Statistics
+ */
+typedef enum {
+	AD9081_HAL_CALL_REG_GET = 0, /*!< adi_ad9081_hal_reg_get() */
+	AD9081_HAL_CALL_REG_SET = 1, /*!< adi_ad9081_hal_reg_set() */
+	AD9081_HAL_CALL_BF_GET = 2, /*!< adi_ad9081_hal_bf_get() */
+	AD9081_HAL_CALL_BF_SET = 3, /*!< adi_ad9081_hal_bf_set() */
+	AD9081_HAL_CALL_MULTI_BF_GET = 4, /*!< adi_ad9081_hal_Nbf_get() */
+	AD9081_HAL_CALL_MULTI_BF_SET = 5, /*!< adi_ad9081_hal_Nbf_set() */
+	AD9081_HAL_CALL_TXN_FLUSH = 6, /*!< Flush of the queued writes */
+	AD9081_HAL_CALL_NUM = 7 /*!< Number of entry points */
+} adi_ad9081_hal_call_e;
+
+/*!
+ * @brief SPI Traffic Of A HAL Entry Point
+ */
+typedef struct {
+	uint32_t calls; /*!< Number of calls */
+	uint32_t xfers; /*!< Number of SPI transfers issued by the calls */
+	uint32_t bytes; /*!< Number of SPI bytes, instructions included */
+} adi_ad9081_hal_call_stats_t;
+
+/*!
+ * @brief HAL SPI Statistics Structure
+ */
+typedef struct {
+	adi_ad9081_hal_call_stats_t
+		call[AD9081_HAL_CALL_NUM]; /*!< Per entry point traffic */
+	uint32_t shadow_hits; /*!< Register reads elided by the shadow */
+} adi_ad9081_hal_stats_t;
+
+/*!
+ * @brief Shadow Register Entry
+ */
+typedef struct {
+	uint16_t reg; /*!< Register address */
+	uint8_t page; /*!< Index of the page selection in the page table */
+	uint8_t val; /*!< Register value */
+} adi_ad9081_hal_shadow_t;
+
+/*!
+ * @brief HAL Transaction Structure
+ *
+ * Between adi_ad9081_hal_txn_begin() and adi_ad9081_hal_txn_end(), writes
+ * to the 8-bit register space are queued and flushed as multi-byte streaming
+ * transfers, and the read-modify-write of bitfields uses a shadow of the
+ * registers accessed, keyed by the value of the page registers. Streaming is
+ * used once adi_ad9081_device_spi_config() has set the address ascension;
+ * outside the transactions, the registers are accessed one by one.
+ */
+typedef struct {
+	uint8_t disabled; /*!< Access the registers one by one, as legacy */
+	uint8_t spi_stream; /*!< Register 0 set for ascending, msb first */
+	uint8_t depth; /*!< Nesting level of the open transactions */
+	uint8_t call; /*!< Entry point being counted plus one, 0 if none */
+	uint8_t num_runs; /*!< Number of queued runs of registers */
+	uint16_t num_bytes; /*!< Number of queued bytes */
+	uint16_t run_reg[AD9081_HAL_TXN_RUNS]; /*!< First register of the run */
+	uint8_t run_len[AD9081_HAL_TXN_RUNS]; /*!< Length of the run */
+	uint8_t data[AD9081_HAL_TXN_BYTES]; /*!< Queued bytes */
+	uint8_t page[AD9081_HAL_PAGE_REGS]; /*!< Current page registers */
+	uint16_t page_valid; /*!< Mask of the page registers known */
+	uint8_t page_id; /*!< Index of the current pages in the page table */
+	uint8_t num_pages; /*!< Number of page selections in the page table */
+	uint8_t pages[AD9081_HAL_SHADOW_PAGES]
+		     [AD9081_HAL_PAGE_REGS]; /*!< Page table */
+	uint16_t pages_valid
+		[AD9081_HAL_SHADOW_PAGES]; /*!< Known registers of the pages */
+	uint8_t num_shadow; /*!< Number of valid shadow entries */
+	uint8_t next_shadow; /*!< Entry replaced when the shadow is full */
+	adi_ad9081_hal_shadow_t
+		shadow[AD9081_HAL_SHADOW_REGS]; /*!< Shadow registers */
+} adi_ad9081_hal_txn_t;
+
 /*!
  * @brief Device Structure
  */
@@ -615,6 +698,8 @@ typedef struct {
 	adi_ad9081_hal_t hal_info;
 	adi_ad9081_info_t dev_info;
 	adi_ad9081_serdes_settings_t serdes_info;
+	adi_ad9081_hal_txn_t hal_txn; /*!< SPI transaction, zero initialized */
+	adi_ad9081_hal_stats_t hal_stats; /*!< SPI statistics */
 } adi_ad9081_device_t;
 
 /*============= E X P O R T S ==============*/
@@ -1099,13 +1099,12 @@ int32_t adi_ad9081_adc_ddc_coarse_trig_hop_en_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_adc_ddc_coarse_nco_set(adi_ad9081_device_t *device,
-					  uint8_t cddcs, int64_t cddc_shift_hz)
+static int32_t adi_ad9081_adc_ddc_coarse_nco_set_txn(
+	adi_ad9081_device_t *device, uint8_t cddcs, int64_t cddc_shift_hz)
 {
 	int32_t err;
 	uint64_t ftw;
 	AD9081_NULL_POINTER_RETURN(device);
-	AD9081_LOG_FUNC();
 
 	err = adi_ad9081_hal_calc_rx_nco_ftw(
 		device, device->dev_info.adc_freq_hz, cddc_shift_hz, &ftw);
@@ -1116,6 +1115,22 @@ int32_t adi_ad9081_adc_ddc_coarse_nco_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_adc_ddc_coarse_nco_set(adi_ad9081_device_t *device,
+					  uint8_t cddcs, int64_t cddc_shift_hz)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_LOG_FUNC();
+
+	/* gather the register updates into one spi transaction */
+	err = adi_ad9081_hal_txn_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_adc_ddc_coarse_nco_set_txn(device, cddcs,
+						    cddc_shift_hz);
+
+	return adi_ad9081_hal_txn_end(device, err);
+}
+
 #if AD9081_USE_FLOATING_TYPE > 0
 int32_t adi_ad9081_adc_ddc_coarse_nco_set_f(adi_ad9081_device_t *device,
 					    uint8_t cddcs, double cddc_shift_hz)
@@ -1800,14 +1815,14 @@ int32_t adi_ad9081_adc_ddc_fine_trig_hop_en_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_adc_ddc_fine_nco_set(adi_ad9081_device_t *device,
-					uint8_t fddcs, int64_t fddc_shift_hz)
+static int32_t adi_ad9081_adc_ddc_fine_nco_set_txn(adi_ad9081_device_t *device,
+						   uint8_t fddcs,
+						   int64_t fddc_shift_hz)
 {
 	int32_t err;
 	uint8_t i, fddc, cddc, cc2r_en, cddc_dcm;
 	uint64_t ftw, adc_freq_hz;
 	AD9081_NULL_POINTER_RETURN(device);
-	AD9081_LOG_FUNC();
 
 	for (i = 0; i < 8; i++) {
 		fddc = fddcs & (AD9081_ADC_FDDC_0 << i);
@@ -1850,6 +1865,21 @@ int32_t adi_ad9081_adc_ddc_fine_nco_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_adc_ddc_fine_nco_set(adi_ad9081_device_t *device,
+					uint8_t fddcs, int64_t fddc_shift_hz)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_LOG_FUNC();
+
+	/* gather the register updates into one spi transaction */
+	err = adi_ad9081_hal_txn_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_adc_ddc_fine_nco_set_txn(device, fddcs, fddc_shift_hz);
+
+	return adi_ad9081_hal_txn_end(device, err);
+}
+
 #if AD9081_USE_FLOATING_TYPE > 0
 int32_t adi_ad9081_adc_ddc_fine_nco_set_f(adi_ad9081_device_t *device,
 					  uint8_t fddcs, double fddc_shift_hz)
@@ -576,14 +576,14 @@ int32_t adi_ad9081_dac_duc_nco_ftw_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_dac_duc_nco_set(adi_ad9081_device_t *device, uint8_t dacs,
-				   uint8_t channels, int64_t nco_shift_hz)
+static int32_t adi_ad9081_dac_duc_nco_set_txn(adi_ad9081_device_t *device,
+					      uint8_t dacs, uint8_t channels,
+					      int64_t nco_shift_hz)
 {
 	int32_t err;
 	uint64_t ftw;
 	uint8_t main_interp = 0;
 	AD9081_NULL_POINTER_RETURN(device);
-	AD9081_LOG_FUNC();
 	AD9081_INVALID_PARAM_RETURN(device->dev_info.dac_freq_hz == 0);
 
 	/* set main nco */
@@ -621,6 +621,22 @@ int32_t adi_ad9081_dac_duc_nco_set(adi_ad9081_device_t *device, uint8_t dacs,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_dac_duc_nco_set(adi_ad9081_device_t *device, uint8_t dacs,
+				   uint8_t channels, int64_t nco_shift_hz)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_LOG_FUNC();
+
+	/* gather the register updates into one spi transaction */
+	err = adi_ad9081_hal_txn_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_dac_duc_nco_set_txn(device, dacs, channels,
+					     nco_shift_hz);
+
+	return adi_ad9081_hal_txn_end(device, err);
+}
+
 #if AD9081_USE_FLOATING_TYPE > 0
 int32_t adi_ad9081_dac_duc_nco_set_f(adi_ad9081_device_t *device, uint8_t dacs,
 				     uint8_t channels, double nco_shift_hz)
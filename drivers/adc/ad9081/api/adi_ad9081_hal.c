@@ -16,6 +16,576 @@
 #include "adi_ad9081_hal.h"
 
 /*============= C O D E ====================*/
+static uint8_t adi_ad9081_hal_call_enter(adi_ad9081_device_t *device,
+					 adi_ad9081_hal_call_e call)
+{
+	uint8_t prev = device->hal_txn.call;
+
+	/* nested hal calls are counted as part of the outermost one */
+	if (prev == 0) {
+		device->hal_txn.call = call + 1;
+		device->hal_stats.call[call].calls++;
+	}
+
+	return prev;
+}
+
+static void adi_ad9081_hal_call_exit(adi_ad9081_device_t *device, uint8_t prev)
+{
+	device->hal_txn.call = prev;
+}
+
+static int32_t adi_ad9081_hal_spi_xfer(adi_ad9081_device_t *device,
+				       uint8_t *in_data, uint8_t *out_data,
+				       uint32_t size_bytes)
+{
+	adi_ad9081_hal_call_stats_t *stats;
+
+	if (device->hal_txn.call > 0) {
+		stats = &device->hal_stats.call[device->hal_txn.call - 1];
+		stats->xfers++;
+		stats->bytes += size_bytes & 0xFF;
+	}
+	if (API_CMS_ERROR_OK !=
+	    device->hal_info.spi_xfer(device->hal_info.user_data, in_data,
+				      out_data, size_bytes))
+		return API_CMS_ERROR_SPI_XFER;
+
+	return API_CMS_ERROR_OK;
+}
+
+static uint8_t adi_ad9081_hal_txn_active(adi_ad9081_device_t *device)
+{
+	return (device->hal_txn.depth > 0) && (device->hal_txn.disabled == 0);
+}
+
+static uint8_t adi_ad9081_hal_stream_ok(adi_ad9081_device_t *device)
+{
+	/* only the transactions stream, once the device is configured */
+	return adi_ad9081_hal_txn_active(device) &&
+	       (device->hal_txn.spi_stream > 0);
+}
+
+static int8_t adi_ad9081_hal_page_index(uint32_t reg)
+{
+	/* page registers and the dac/adc spi enables select the paged cores */
+	if ((reg >= REG_ADC_COARSE_PAGE_ADDR) &&
+	    (reg <= REG_PFILT_COEFF_PAGE_ADDR))
+		return (int8_t)(reg - REG_ADC_COARSE_PAGE_ADDR);
+	if ((reg == REG_SPI_ENABLE_DAC_ADDR) ||
+	    (reg == REG_SPI_ENABLE_ADC_ADDR))
+		return (int8_t)(8 + reg - REG_SPI_ENABLE_DAC_ADDR);
+
+	return -1;
+}
+
+static void adi_ad9081_hal_shadow_drop(adi_ad9081_device_t *device)
+{
+	adi_ad9081_hal_txn_t *txn = &device->hal_txn;
+
+	txn->num_shadow = 0;
+	txn->next_shadow = 0;
+	txn->page_valid = 0;
+	txn->page_id = 0;
+	txn->num_pages = 1;
+	txn->pages_valid[0] = 0;
+}
+
+static void adi_ad9081_hal_page_set(adi_ad9081_device_t *device, uint8_t idx,
+				    uint8_t val)
+{
+	adi_ad9081_hal_txn_t *txn = &device->hal_txn;
+	uint8_t i, j;
+
+	if (((txn->page_valid & (1 << idx)) > 0) && (txn->page[idx] == val))
+		return;
+	txn->page[idx] = val;
+	txn->page_valid |= 1 << idx;
+
+	/* shadow entries are tagged with the page selection they belong to */
+	for (i = 0; i < txn->num_pages; i++) {
+		if (txn->pages_valid[i] != txn->page_valid)
+			continue;
+		for (j = 0; j < AD9081_HAL_PAGE_REGS; j++) {
+			if (((txn->page_valid & (1 << j)) > 0) &&
+			    (txn->pages[i][j] != txn->page[j]))
+				break;
+		}
+		if (j == AD9081_HAL_PAGE_REGS) {
+			txn->page_id = i;
+			return;
+		}
+	}
+	if (txn->num_pages == AD9081_HAL_SHADOW_PAGES) {
+		txn->num_pages = 0;
+		txn->num_shadow = 0;
+		txn->next_shadow = 0;
+	}
+	i = txn->num_pages++;
+	for (j = 0; j < AD9081_HAL_PAGE_REGS; j++)
+		txn->pages[i][j] = txn->page[j];
+	txn->pages_valid[i] = txn->page_valid;
+	txn->page_id = i;
+}
+
+static int16_t adi_ad9081_hal_shadow_find(adi_ad9081_device_t *device,
+					  uint32_t reg)
+{
+	adi_ad9081_hal_txn_t *txn = &device->hal_txn;
+	uint8_t i;
+
+	for (i = 0; i < txn->num_shadow; i++) {
+		if ((txn->shadow[i].reg == reg) &&
+		    (txn->shadow[i].page == txn->page_id))
+			return i;
+	}
+
+	return -1;
+}
+
+static uint8_t adi_ad9081_hal_shadow_get(adi_ad9081_device_t *device,
+					 uint32_t reg, uint8_t *val)
+{
+	adi_ad9081_hal_txn_t *txn = &device->hal_txn;
+	int8_t idx = adi_ad9081_hal_page_index(reg);
+	int16_t i;
+
+	if (idx >= 0) {
+		if ((txn->page_valid & (1 << idx)) == 0)
+			return 0;
+		*val = txn->page[idx];
+		return 1;
+	}
+	i = adi_ad9081_hal_shadow_find(device, reg);
+	if (i < 0)
+		return 0;
+	*val = txn->shadow[i].val;
+
+	return 1;
+}
+
+static void adi_ad9081_hal_shadow_put(adi_ad9081_device_t *device,
+				      uint32_t reg, uint8_t val)
+{
+	adi_ad9081_hal_txn_t *txn = &device->hal_txn;
+	int8_t idx = adi_ad9081_hal_page_index(reg);
+	int16_t i;
+
+	if (idx >= 0) {
+		adi_ad9081_hal_page_set(device, idx, val);
+		return;
+	}
+	i = adi_ad9081_hal_shadow_find(device, reg);
+	if (i < 0) {
+		if (txn->num_shadow < AD9081_HAL_SHADOW_REGS) {
+			i = txn->num_shadow++;
+		} else {
+			i = txn->next_shadow;
+			txn->next_shadow =
+				(txn->next_shadow + 1) % AD9081_HAL_SHADOW_REGS;
+		}
+		txn->shadow[i].reg = (uint16_t)reg;
+		txn->shadow[i].page = txn->page_id;
+	}
+	txn->shadow[i].val = val;
+}
+
+static int32_t adi_ad9081_hal_stream_write(adi_ad9081_device_t *device,
+					   uint32_t reg, uint8_t *data,
+					   uint16_t len)
+{
+	int32_t err;
+	uint8_t in_data[AD9081_HAL_STREAM_MAX + 2],
+		out_data[AD9081_HAL_STREAM_MAX + 2];
+	uint16_t i, n;
+
+	while (len > 0) {
+		n = adi_ad9081_hal_stream_ok(device) ? len : 1;
+		n = (n > AD9081_HAL_STREAM_MAX) ? AD9081_HAL_STREAM_MAX : n;
+		in_data[0] = (reg >> 8) & 0x3F;
+		in_data[1] = (reg >> 0) & 0xFF;
+		for (i = 0; i < n; i++)
+			in_data[2 + i] = data[i];
+		err = adi_ad9081_hal_spi_xfer(device, in_data, out_data, n + 2);
+		AD9081_ERROR_RETURN(err);
+		for (i = 0; i < n; i++) {
+			if (API_CMS_ERROR_OK !=
+			    AD9081_LOG_SPIW((reg + i) & 0x3fff, data[i]))
+				return API_CMS_ERROR_LOG_WRITE;
+		}
+		reg += n;
+		data += n;
+		len -= n;
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_stream_read(adi_ad9081_device_t *device,
+					  uint32_t reg, uint8_t *data,
+					  uint16_t len)
+{
+	int32_t err;
+	uint8_t in_data[AD9081_HAL_STREAM_MAX + 2] = { 0 },
+		out_data[AD9081_HAL_STREAM_MAX + 2] = { 0 };
+	uint16_t i, n;
+
+	while (len > 0) {
+		n = adi_ad9081_hal_stream_ok(device) ? len : 1;
+		n = (n > AD9081_HAL_STREAM_MAX) ? AD9081_HAL_STREAM_MAX : n;
+		in_data[0] = ((reg >> 8) & 0x3F) | 0x80;
+		in_data[1] = ((reg >> 0) & 0xFF);
+		err = adi_ad9081_hal_spi_xfer(device, in_data, out_data, n + 2);
+		AD9081_ERROR_RETURN(err);
+		for (i = 0; i < n; i++) {
+			data[i] = out_data[2 + i];
+			if (adi_ad9081_hal_txn_active(device))
+				adi_ad9081_hal_shadow_put(device, reg + i,
+							  data[i]);
+			if (API_CMS_ERROR_OK !=
+			    AD9081_LOG_SPIR((in_data[0] << 8) + in_data[1] + i,
+					    data[i]))
+				return API_CMS_ERROR_LOG_WRITE;
+		}
+		reg += n;
+		data += n;
+		len -= n;
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_txn_flush(adi_ad9081_device_t *device)
+{
+	int32_t err = API_CMS_ERROR_OK;
+	adi_ad9081_hal_txn_t *txn = &device->hal_txn;
+	uint16_t offset = 0;
+	uint8_t i, call;
+
+	if (txn->num_runs == 0)
+		return API_CMS_ERROR_OK;
+
+	call = txn->call;
+	txn->call = AD9081_HAL_CALL_TXN_FLUSH + 1;
+	device->hal_stats.call[AD9081_HAL_CALL_TXN_FLUSH].calls++;
+	for (i = 0; i < txn->num_runs; i++) {
+		err = adi_ad9081_hal_stream_write(device, txn->run_reg[i],
+						  &txn->data[offset],
+						  txn->run_len[i]);
+		if (err != API_CMS_ERROR_OK)
+			break;
+		offset += txn->run_len[i];
+	}
+	txn->num_runs = 0;
+	txn->num_bytes = 0;
+	txn->call = call;
+
+	return err;
+}
+
+static int32_t adi_ad9081_hal_txn_queue(adi_ad9081_device_t *device,
+					uint32_t reg, uint8_t *data,
+					uint16_t len)
+{
+	int32_t err;
+	adi_ad9081_hal_txn_t *txn = &device->hal_txn;
+	uint8_t last;
+	uint16_t i;
+
+	for (i = 0; i < len; i++, reg++) {
+		last = txn->num_runs - 1;
+		/* writes to the next register extend the last streamed run */
+		if ((txn->num_runs == 0) ||
+		    (txn->run_reg[last] + txn->run_len[last] != reg) ||
+		    (txn->run_len[last] == AD9081_HAL_STREAM_MAX) ||
+		    (txn->num_bytes == AD9081_HAL_TXN_BYTES)) {
+			if ((txn->num_runs == AD9081_HAL_TXN_RUNS) ||
+			    (txn->num_bytes == AD9081_HAL_TXN_BYTES)) {
+				err = adi_ad9081_hal_txn_flush(device);
+				AD9081_ERROR_RETURN(err);
+			}
+			last = txn->num_runs++;
+			txn->run_reg[last] = (uint16_t)reg;
+			txn->run_len[last] = 0;
+		}
+		txn->run_len[last]++;
+		txn->data[txn->num_bytes++] = data[i];
+		adi_ad9081_hal_shadow_put(device, reg, data[i]);
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_write(adi_ad9081_device_t *device, uint32_t reg,
+				    uint8_t *data, uint16_t len)
+{
+	int32_t err;
+
+	if (reg == REG_SPI_INTFCONFA_ADDR) { /* soft reset, spi configuration */
+		err = adi_ad9081_hal_txn_flush(device);
+		AD9081_ERROR_RETURN(err);
+		adi_ad9081_hal_shadow_drop(device);
+		/* streamed bytes go to ascending addresses, msb first */
+		device->hal_txn.spi_stream = ((data[0] & 0xE7) == 0x24);
+		return adi_ad9081_hal_stream_write(device, reg, data, len);
+	}
+
+	if (adi_ad9081_hal_txn_active(device) == 0)
+		return adi_ad9081_hal_stream_write(device, reg, data, len);
+
+	return adi_ad9081_hal_txn_queue(device, reg, data, len);
+}
+
+static int32_t adi_ad9081_hal_read(adi_ad9081_device_t *device, uint32_t reg,
+				   uint8_t *data, uint16_t len)
+{
+	int32_t err;
+	uint16_t i;
+
+	if (adi_ad9081_hal_txn_active(device) == 0)
+		return adi_ad9081_hal_stream_read(device, reg, data, len);
+
+	/* the page registers only change when written, read their shadow */
+	for (i = 0; i < len; i++) {
+		if ((adi_ad9081_hal_page_index(reg + i) < 0) ||
+		    !adi_ad9081_hal_shadow_get(device, reg + i, &data[i]))
+			break;
+	}
+	if (i == len) {
+		device->hal_stats.shadow_hits += len;
+		return API_CMS_ERROR_OK;
+	}
+
+	/* other reads go to the device, after the writes queued before them */
+	err = adi_ad9081_hal_txn_flush(device);
+	AD9081_ERROR_RETURN(err);
+
+	return adi_ad9081_hal_stream_read(device, reg, data, len);
+}
+
+static int32_t adi_ad9081_hal_rmw_read(adi_ad9081_device_t *device,
+				       uint32_t reg, uint8_t *data,
+				       uint8_t *need, uint8_t len)
+{
+	int32_t err;
+	uint8_t i, j, active = adi_ad9081_hal_txn_active(device);
+
+	for (i = 0; i < len; i = j) {
+		j = i + 1;
+		if (need[i] == 0)
+			continue;
+		if (active && adi_ad9081_hal_shadow_get(device, reg + i,
+							&data[i])) {
+			device->hal_stats.shadow_hits++;
+			continue;
+		}
+		/* one streamed read of the adjacent bytes not in the shadow */
+		while ((j < len) && (need[j] > 0) &&
+		       !(active &&
+			 adi_ad9081_hal_shadow_get(device, reg + j, &data[j])))
+			j++;
+		err = adi_ad9081_hal_read(device, reg + i, &data[i], j - i);
+		AD9081_ERROR_RETURN(err);
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_bf_span(uint32_t *info, uint8_t num_bfs,
+				      uint8_t *len)
+{
+	uint8_t i, offset, width, bytes;
+
+	*len = 0;
+	for (i = 0; i < num_bfs; i++) {
+		offset = (uint8_t)(info[i] >> 0);
+		width = (uint8_t)(info[i] >> 8);
+		if ((width > 64) || (width < 1))
+			return API_CMS_ERROR_INVALID_PARAM;
+		bytes = (uint8_t)((offset + width + 7) >> 3);
+		if (bytes > AD9081_HAL_BF_BYTES)
+			return API_CMS_ERROR_INVALID_PARAM;
+		*len = (bytes > *len) ? bytes : *len;
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_bfs_get(adi_ad9081_device_t *device,
+				      uint32_t reg, uint32_t *info,
+				      uint8_t **value, uint8_t value_size_bytes,
+				      uint8_t num_bfs)
+{
+	int32_t err;
+	uint8_t data[AD9081_HAL_BF_BYTES];
+	uint8_t i, j, k, len, bit, width, shift, n, filled;
+	uint32_t endian_test_val = 0x11223344;
+	uint64_t bf_val;
+	AD9081_INVALID_PARAM_RETURN(value_size_bytes > 8);
+
+	err = adi_ad9081_hal_bf_span(info, num_bfs, &len);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_hal_read(device, reg, data, len);
+	AD9081_ERROR_RETURN(err);
+
+	for (k = 0; k < num_bfs; k++) {
+		bit = (uint8_t)(info[k] >> 0);
+		width = (uint8_t)(info[k] >> 8);
+		bf_val = 0;
+		filled = 0;
+		while (width > 0) {
+			shift = bit & 7;
+			n = ((8 - shift) < width) ? (8 - shift) : width;
+			bf_val |= (uint64_t)((data[bit >> 3] >> shift) &
+					     ((1 << n) - 1))
+				  << filled;
+			filled += n;
+			bit += n;
+			width -= n;
+		}
+
+		/* save bitfield value to buffer */
+		for (i = 0; i < value_size_bytes; i++) {
+			j = (*(uint8_t *)&endian_test_val == 0x44) ?
+				    (i) :
+				    (value_size_bytes - 1 - i);
+			value[k][j] = (uint8_t)(bf_val >> (i << 3));
+		}
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_bfs_set(adi_ad9081_device_t *device,
+				      uint32_t reg, uint32_t *info,
+				      uint64_t *value, uint8_t num_bfs)
+{
+	int32_t err;
+	uint8_t data[AD9081_HAL_BF_BYTES] = { 0 },
+		mask[AD9081_HAL_BF_BYTES] = { 0 },
+		need[AD9081_HAL_BF_BYTES];
+	uint8_t i, j, k, len, bit, width, shift, n, bits;
+	uint64_t val;
+
+	err = adi_ad9081_hal_bf_span(info, num_bfs, &len);
+	AD9081_ERROR_RETURN(err);
+
+	/* merge the bitfields into a single read-modify-write of the span */
+	for (k = 0; k < num_bfs; k++) {
+		bit = (uint8_t)(info[k] >> 0);
+		width = (uint8_t)(info[k] >> 8);
+		while (width > 0) {
+			shift = bit & 7;
+			n = ((8 - shift) < width) ? (8 - shift) : width;
+			mask[bit >> 3] |= ((1 << n) - 1) << shift;
+			bit += n;
+			width -= n;
+		}
+	}
+	for (i = 0; i < len; i++)
+		need[i] = (mask[i] != 0) && (mask[i] != 0xFF);
+	err = adi_ad9081_hal_rmw_read(device, reg, data, need, len);
+	AD9081_ERROR_RETURN(err);
+
+	for (k = 0; k < num_bfs; k++) {
+		bit = (uint8_t)(info[k] >> 0);
+		width = (uint8_t)(info[k] >> 8);
+		val = value[k];
+		while (width > 0) {
+			shift = bit & 7;
+			n = ((8 - shift) < width) ? (8 - shift) : width;
+			bits = (uint8_t)(((1 << n) - 1) << shift);
+			data[bit >> 3] = (data[bit >> 3] & ~bits) |
+					 ((uint8_t)(val << shift) & bits);
+			val >>= n;
+			bit += n;
+			width -= n;
+		}
+	}
+
+	/* write the runs of modified registers */
+	for (i = 0; i < len; i = j) {
+		j = i + 1;
+		if (mask[i] == 0)
+			continue;
+		while ((j < len) && (mask[j] != 0))
+			j++;
+		err = adi_ad9081_hal_write(device, reg + i, &data[i], j - i);
+		AD9081_ERROR_RETURN(err);
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_txn_begin(adi_ad9081_device_t *device)
+{
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_INVALID_PARAM_RETURN(device->hal_txn.depth == 0xFF);
+
+	if (device->hal_txn.depth++ == 0)
+		adi_ad9081_hal_shadow_drop(device);
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_txn_end(adi_ad9081_device_t *device, int32_t err)
+{
+	int32_t ret;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_INVALID_PARAM_RETURN(device->hal_txn.depth == 0);
+
+	if (device->hal_txn.depth > 1) {
+		device->hal_txn.depth--;
+		return err;
+	}
+	/* flushed while still open, so that the queued runs are streamed */
+	ret = adi_ad9081_hal_txn_flush(device);
+	device->hal_txn.depth = 0;
+	adi_ad9081_hal_shadow_drop(device);
+
+	return (err != API_CMS_ERROR_OK) ? err : ret;
+}
+
+int32_t adi_ad9081_hal_txn_enable_set(adi_ad9081_device_t *device,
+				      uint8_t enable)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	err = adi_ad9081_hal_txn_flush(device);
+	AD9081_ERROR_RETURN(err);
+	adi_ad9081_hal_shadow_drop(device);
+	device->hal_txn.disabled = (enable > 0) ? 0 : 1;
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_stats_get(adi_ad9081_device_t *device,
+				 adi_ad9081_hal_stats_t *stats)
+{
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(stats);
+
+	*stats = device->hal_stats;
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_stats_reset(adi_ad9081_device_t *device)
+{
+	uint8_t i;
+	AD9081_NULL_POINTER_RETURN(device);
+
+	for (i = 0; i < AD9081_HAL_CALL_NUM; i++) {
+		device->hal_stats.call[i].calls = 0;
+		device->hal_stats.call[i].xfers = 0;
+		device->hal_stats.call[i].bytes = 0;
+	}
+	device->hal_stats.shadow_hits = 0;
+
+	return API_CMS_ERROR_OK;
+}
+
 int32_t adi_ad9081_hal_hw_open(adi_ad9081_device_t *device)
 {
 	AD9081_NULL_POINTER_RETURN(device);
@@ -42,8 +612,13 @@ int32_t adi_ad9081_hal_hw_close(adi_ad9081_device_t *device)
 
 int32_t adi_ad9081_hal_delay_us(adi_ad9081_device_t *device, uint32_t us)
 {
+	int32_t err;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.delay_us);
+
+	/* the delay is relative to the writes issued before it */
+	err = adi_ad9081_hal_txn_flush(device);
+	AD9081_ERROR_RETURN(err);
 	if (API_CMS_ERROR_OK !=
 	    device->hal_info.delay_us(device->hal_info.user_data, us)) {
 		return API_CMS_ERROR_DELAY_US;
@@ -55,8 +630,14 @@ int32_t adi_ad9081_hal_delay_us(adi_ad9081_device_t *device, uint32_t us)
 int32_t adi_ad9081_hal_reset_pin_ctrl(adi_ad9081_device_t *device,
 				      uint8_t enable)
 {
+	int32_t err;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.reset_pin_ctrl);
+
+	err = adi_ad9081_hal_txn_flush(device);
+	AD9081_ERROR_RETURN(err);
+	adi_ad9081_hal_shadow_drop(device);
+	device->hal_txn.spi_stream = 0;
 	if (API_CMS_ERROR_OK != device->hal_info.reset_pin_ctrl(
 					device->hal_info.user_data, enable)) {
 		return API_CMS_ERROR_RESET_PIN_CTRL;
@@ -65,6 +646,7 @@ int32_t adi_ad9081_hal_reset_pin_ctrl(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+
 int32_t adi_ad9081_hal_log_write(adi_ad9081_device_t *device,
 				 adi_cms_log_type_e log_type,
 				 const char *comment, ...)
@@ -85,65 +667,179 @@ int32_t adi_ad9081_hal_log_write(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_hal_bf_get(adi_ad9081_device_t *device, uint32_t reg,
-			      uint32_t info, uint8_t *value,
-			      uint8_t value_size_bytes)
+static int32_t adi_ad9081_hal_reg_get_ext(adi_ad9081_device_t *device,
+					  uint32_t reg, uint8_t *data)
+{
+	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
+
+	in_data[0] = 0x3D;
+	in_data[1] = 0x21;
+	in_data[2] = (reg >> 8) & 0xC0;
+	if (API_CMS_ERROR_OK !=
+	    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+		return API_CMS_ERROR_SPI_XFER;
+	if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d21, in_data[2]))
+		return API_CMS_ERROR_LOG_WRITE;
+	in_data[0] = 0x3D;
+	in_data[1] = 0x22;
+	in_data[2] = (reg >> 16) & 0xFF;
+	if (API_CMS_ERROR_OK !=
+	    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+		return API_CMS_ERROR_SPI_XFER;
+	if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d22, in_data[2]))
+		return API_CMS_ERROR_LOG_WRITE;
+	in_data[0] = 0x3D;
+	in_data[1] = 0x23;
+	in_data[2] = (reg >> 24) & 0xFF;
+	if (API_CMS_ERROR_OK !=
+	    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+		return API_CMS_ERROR_SPI_XFER;
+	if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d23, in_data[2]))
+		return API_CMS_ERROR_LOG_WRITE;
+	if (((reg >= 0x4F00000) && (reg <= 0x4FFFFFF)) ||
+	    ((reg >= 0x6001000) && (reg <= 0x60010FF))) {
+		/* 32-bit address, 8-bit data */
+		in_data[0] = ((reg >> 8) & 0x3F) | 0xC0;
+		in_data[1] = ((reg >> 0) & 0xFF);
+		if (API_CMS_ERROR_OK !=
+		    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+			return API_CMS_ERROR_SPI_XFER;
+		*data = out_data[2];
+		if (API_CMS_ERROR_OK !=
+		    AD9081_LOG_SPIR((in_data[0] << 8) + in_data[1],
+				    out_data[2]))
+			return API_CMS_ERROR_LOG_WRITE;
+	} else {
+		/* 32-bit address, 32-bit data */
+		reg += (device->hal_info.addr_inc == SPI_ADDR_INC_AUTO) ? 0 : 3;
+		in_data[0] = ((reg >> 8) & 0x3F) | 0xC0;
+		in_data[1] = ((reg >> 0) & 0xFF);
+		if (API_CMS_ERROR_OK !=
+		    adi_ad9081_hal_spi_xfer(device, in_data, out_data,
+					    0x20000006))
+			return API_CMS_ERROR_SPI_XFER;
+		if (device->hal_info.addr_inc == SPI_ADDR_INC_AUTO) {
+			*(uint32_t *)data = (out_data[2]) +
+					    (out_data[3] << 8) +
+					    (out_data[4] << 16) +
+					    (out_data[5] << 24);
+		} else { /* streaming addresses are decremented */
+			*(uint32_t *)data = (out_data[5]) +
+					    (out_data[4] << 8) +
+					    (out_data[3] << 16) +
+					    (out_data[2] << 24);
+		}
+		if (API_CMS_ERROR_OK !=
+		    AD9081_LOG_SPIR32((in_data[0] << 8) + in_data[1],
+				      *(uint32_t *)data))
+			return API_CMS_ERROR_LOG_WRITE;
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_reg_set_ext(adi_ad9081_device_t *device,
+					  uint32_t reg, uint32_t data)
+{
+	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
+
+	in_data[0] = 0x3D;
+	in_data[1] = 0x21;
+	in_data[2] = (reg >> 8) & 0xC0;
+	if (API_CMS_ERROR_OK !=
+	    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+		return API_CMS_ERROR_SPI_XFER;
+	if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d21, in_data[2]))
+		return API_CMS_ERROR_LOG_WRITE;
+	in_data[0] = 0x3D;
+	in_data[1] = 0x22;
+	in_data[2] = (reg >> 16) & 0xFF;
+	if (API_CMS_ERROR_OK !=
+	    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+		return API_CMS_ERROR_SPI_XFER;
+	if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d22, in_data[2]))
+		return API_CMS_ERROR_LOG_WRITE;
+	in_data[0] = 0x3D;
+	in_data[1] = 0x23;
+	in_data[2] = (reg >> 24) & 0xFF;
+	if (API_CMS_ERROR_OK !=
+	    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+		return API_CMS_ERROR_SPI_XFER;
+	if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d23, in_data[2]))
+		return API_CMS_ERROR_LOG_WRITE;
+	if (((reg >= 0x4F00000) && (reg <= 0x4FFFFFF)) ||
+	    ((reg >= 0x6001000) && (reg <= 0x60010FF))) {
+		/* 32-bit address, 8-bit data */
+		in_data[0] = ((reg >> 8) & 0x3F) | 0x40;
+		in_data[1] = ((reg >> 0) & 0xFF);
+		in_data[2] = (uint8_t)(data & 0xFF);
+		if (API_CMS_ERROR_OK !=
+		    adi_ad9081_hal_spi_xfer(device, in_data, out_data, 0x3))
+			return API_CMS_ERROR_SPI_XFER;
+		if (API_CMS_ERROR_OK !=
+		    AD9081_LOG_SPIW((in_data[0] << 8) + in_data[1],
+				    in_data[2]))
+			return API_CMS_ERROR_LOG_WRITE;
+	} else {
+		/* 32-bit address, 32-bit data */
+		if (device->hal_info.addr_inc == SPI_ADDR_INC_AUTO) {
+			in_data[0] = ((reg >> 8) & 0x3F) | 0x40;
+			in_data[1] = ((reg >> 0) & 0xFF);
+			in_data[2] = (uint8_t)((data >> 0) & 0xFF);
+			in_data[3] = (uint8_t)((data >> 8) & 0xFF);
+			in_data[4] = (uint8_t)((data >> 16) & 0xFF);
+			in_data[5] = (uint8_t)((data >> 24) & 0xFF);
+		} else { /* streaming addresses are decremented */
+			in_data[0] = (((reg + 3) >> 8) & 0x3F) | 0x40;
+			in_data[1] = (((reg + 3) >> 0) & 0xFF);
+			in_data[2] = (uint8_t)((data >> 24) & 0xFF);
+			in_data[3] = (uint8_t)((data >> 16) & 0xFF);
+			in_data[4] = (uint8_t)((data >> 8) & 0xFF);
+			in_data[5] = (uint8_t)((data >> 0) & 0xFF);
+		}
+		if (API_CMS_ERROR_OK !=
+		    adi_ad9081_hal_spi_xfer(device, in_data, out_data,
+					    0x20000006))
+			return API_CMS_ERROR_SPI_XFER;
+		if (API_CMS_ERROR_OK !=
+		    AD9081_LOG_SPIW32((in_data[0] << 8) + in_data[1],
+				      data))
+			return API_CMS_ERROR_LOG_WRITE;
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9081_hal_bf_get_ext(adi_ad9081_device_t *device,
+					 uint32_t reg, uint32_t info,
+					 uint8_t *value,
+					 uint8_t value_size_bytes)
 {
 	int32_t err;
-	uint8_t reg_offset = 0, data8 = 0;
+	uint8_t reg_offset = 0;
 	uint8_t offset = (uint8_t)(info >> 0), width = (uint8_t)(info >> 8);
 	uint32_t data32 = 0, mask = 0, endian_test_val = 0x11223344;
 	uint64_t bf_val = 0;
 	uint8_t reg_bytes =
 		((width + offset) >> 3) + (((width + offset) & 7) == 0 ? 0 : 1);
 	uint8_t i = 0, j = 0, filled_bits = 0;
-	AD9081_NULL_POINTER_RETURN(device);
-	AD9081_NULL_POINTER_RETURN(value);
-	AD9081_INVALID_PARAM_RETURN(width > 64);
-	AD9081_INVALID_PARAM_RETURN(width < 1);
-	AD9081_INVALID_PARAM_RETURN(value_size_bytes > 8);
 
-	if (reg < 0x4000) {
-		for (reg_offset = 0; reg_offset < reg_bytes; reg_offset++) {
-			err = adi_ad9081_hal_reg_get(device, reg + reg_offset,
-						     &data8);
-			AD9081_ERROR_RETURN(err);
-			if ((offset + width) <= 8) { /* last 8bits */
-				mask = (1 << width) - 1;
-				data8 = (data8 >> offset) & mask;
-				bf_val = bf_val +
-					 ((uint64_t)data8 << filled_bits);
-				filled_bits = filled_bits + width;
-			} else {
-				mask = (1 << (8 - offset)) - 1;
-				data8 = (data8 >> offset) & mask;
-				bf_val = bf_val +
-					 ((uint64_t)data8 << filled_bits);
-				width = offset + width - 8;
-				filled_bits = filled_bits + (8 - offset);
-				offset = 0;
-			}
-		}
-	} else { /* access extended space */
-		for (reg_offset = 0; reg_offset < reg_bytes; reg_offset += 4) {
-			err = adi_ad9081_hal_reg_get(device, reg + reg_offset,
-						     (uint8_t *)&data32);
-			AD9081_ERROR_RETURN(err);
-			if ((offset + width) <= 32) { /* last 32bits */
-				mask = ((uint64_t)1 << width) - 1;
-				data32 = (data32 >> offset) & mask;
-				bf_val = bf_val +
-					 ((uint64_t)data32 << filled_bits);
-				filled_bits = filled_bits + width;
-			} else {
-				mask = ((uint64_t)1 << (32 - offset)) - 1;
-				data32 = (data32 >> offset) & mask;
-				bf_val = bf_val +
-					 ((uint64_t)data32 << filled_bits);
-				width = offset + width - 32;
-				filled_bits = filled_bits + (32 - offset);
-				offset = 0;
-			}
+	for (reg_offset = 0; reg_offset < reg_bytes; reg_offset += 4) {
+		err = adi_ad9081_hal_reg_get(device, reg + reg_offset,
+					     (uint8_t *)&data32);
+		AD9081_ERROR_RETURN(err);
+		if ((offset + width) <= 32) { /* last 32bits */
+			mask = ((uint64_t)1 << width) - 1;
+			data32 = (data32 >> offset) & mask;
+			bf_val = bf_val + ((uint64_t)data32 << filled_bits);
+			filled_bits = filled_bits + width;
+		} else {
+			mask = ((uint64_t)1 << (32 - offset)) - 1;
+			data32 = (data32 >> offset) & mask;
+			bf_val = bf_val + ((uint64_t)data32 << filled_bits);
+			width = offset + width - 32;
+			filled_bits = filled_bits + (32 - offset);
+			offset = 0;
 		}
 	}
 
@@ -158,8 +854,9 @@ int32_t adi_ad9081_hal_bf_get(adi_ad9081_device_t *device, uint32_t reg,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
-			      uint32_t info, uint64_t value)
+static int32_t adi_ad9081_hal_bf_set_ext(adi_ad9081_device_t *device,
+					 uint32_t reg, uint32_t info,
+					 uint64_t value)
 {
 	int32_t err;
 	uint8_t reg_offset = 0, data8 = 0;
@@ -167,263 +864,132 @@ int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 	uint32_t data32 = 0, mask = 0;
 	uint8_t reg_bytes =
 		((width + offset) >> 3) + (((width + offset) & 7) == 0 ? 0 : 1);
+
+	for (reg_offset = 0; reg_offset < reg_bytes; reg_offset += 4) {
+		if ((offset + width) <= 32) { /* last 32bits */
+			if ((offset > 0) || ((offset + width) < 32)) {
+				err = adi_ad9081_hal_reg_get(
+					device, reg + reg_offset,
+					(uint8_t *)&data32);
+				AD9081_ERROR_RETURN(err);
+			}
+			mask = ((uint64_t)1 << width) - 1;
+			data32 = data32 & (~(mask << offset));
+			data32 = data32 | ((value & mask) << offset);
+		} else {
+			if (offset > 0) {
+				err = adi_ad9081_hal_reg_get(
+					device, reg + reg_offset, &data8);
+				AD9081_ERROR_RETURN(err);
+			}
+			mask = ((uint64_t)1 << (32 - offset)) - 1;
+			data32 = data32 & (~(mask << offset));
+			data32 = data32 | ((value & mask) << offset);
+			value = value >> (32 - offset);
+			width = offset + width - 32;
+			offset = 0;
+		}
+		err = adi_ad9081_hal_reg_set(device, reg + reg_offset, data32);
+		AD9081_ERROR_RETURN(err);
+	}
+
+	return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9081_hal_bf_get(adi_ad9081_device_t *device, uint32_t reg,
+			      uint32_t info, uint8_t *value,
+			      uint8_t value_size_bytes)
+{
+	int32_t err;
+	uint8_t width = (uint8_t)(info >> 8), call;
 	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_NULL_POINTER_RETURN(value);
 	AD9081_INVALID_PARAM_RETURN(width > 64);
 	AD9081_INVALID_PARAM_RETURN(width < 1);
+	AD9081_INVALID_PARAM_RETURN(value_size_bytes > 8);
 
+	call = adi_ad9081_hal_call_enter(device, AD9081_HAL_CALL_BF_GET);
 	if (reg < 0x4000) {
-		for (reg_offset = 0; reg_offset < reg_bytes; reg_offset++) {
-			if ((offset + width) <= 8) { /* last 8bits */
-				if ((offset > 0) || ((offset + width) < 8)) {
-					err = adi_ad9081_hal_reg_get(
-						device, reg + reg_offset,
-						&data8);
-					AD9081_ERROR_RETURN(err);
-				}
-				mask = (1 << width) - 1;
-				data8 = data8 & (~(mask << offset));
-				data8 = data8 | ((value & mask) << offset);
-			} else {
-				if (offset > 0) {
-					err = adi_ad9081_hal_reg_get(
-						device, reg + reg_offset,
-						&data8);
-					AD9081_ERROR_RETURN(err);
-				}
-				mask = (1 << (8 - offset)) - 1;
-				data8 = data8 & (~(mask << offset));
-				data8 = data8 | ((value & mask) << offset);
-				value = value >> (8 - offset);
-				width = offset + width - 8;
-				offset = 0;
-			}
-			err = adi_ad9081_hal_reg_set(device, reg + reg_offset,
-						     data8);
-			AD9081_ERROR_RETURN(err);
-		}
+		/* one streamed read of all the bytes of the bitfield */
+		err = adi_ad9081_hal_bfs_get(device, reg, &info, &value,
+					     value_size_bytes, 1);
 	} else { /* access extended space */
-		for (reg_offset = 0; reg_offset < reg_bytes; reg_offset += 4) {
-			if ((offset + width) <= 32) { /* last 32bits */
-				if ((offset > 0) || ((offset + width) < 32)) {
-					err = adi_ad9081_hal_reg_get(
-						device, reg + reg_offset,
-						(uint8_t *)&data32);
-					AD9081_ERROR_RETURN(err);
-				}
-				mask = ((uint64_t)1 << width) - 1;
-				data32 = data32 & (~(mask << offset));
-				data32 = data32 | ((value & mask) << offset);
-			} else {
-				if (offset > 0) {
-					err = adi_ad9081_hal_reg_get(
-						device, reg + reg_offset,
-						&data8);
-					AD9081_ERROR_RETURN(err);
-				}
-				mask = ((uint64_t)1 << (32 - offset)) - 1;
-				data32 = data32 & (~(mask << offset));
-				data32 = data32 | ((value & mask) << offset);
-				value = value >> (32 - offset);
-				width = offset + width - 32;
-				offset = 0;
-			}
-			err = adi_ad9081_hal_reg_set(device, reg + reg_offset,
-						     data32);
-			AD9081_ERROR_RETURN(err);
-		}
+		err = adi_ad9081_hal_bf_get_ext(device, reg, info, value,
+						value_size_bytes);
 	}
+	adi_ad9081_hal_call_exit(device, call);
 
-	return API_CMS_ERROR_OK;
+	return err;
+}
+
+int32_t adi_ad9081_hal_bf_set(adi_ad9081_device_t *device, uint32_t reg,
+			      uint32_t info, uint64_t value)
+{
+	int32_t err;
+	uint8_t width = (uint8_t)(info >> 8), call;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_INVALID_PARAM_RETURN(width > 64);
+	AD9081_INVALID_PARAM_RETURN(width < 1);
+
+	call = adi_ad9081_hal_call_enter(device, AD9081_HAL_CALL_BF_SET);
+	if (reg < 0x4000) {
+		/* only the partially written bytes are read back */
+		err = adi_ad9081_hal_bfs_set(device, reg, &info, &value, 1);
+	} else { /* access extended space */
+		err = adi_ad9081_hal_bf_set_ext(device, reg, info, value);
+	}
+	adi_ad9081_hal_call_exit(device, call);
+
+	return err;
 }
 
 int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 			       uint8_t *data)
 {
-	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
+	int32_t err;
+	uint8_t call;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
 	AD9081_NULL_POINTER_RETURN(data);
 
+	call = adi_ad9081_hal_call_enter(device, AD9081_HAL_CALL_REG_GET);
 	if (reg < 0x4000) {
-		in_data[0] = ((reg >> 8) & 0x3F) | 0x80;
-		in_data[1] = ((reg >> 0) & 0xFF);
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		*data = out_data[2];
-		if (API_CMS_ERROR_OK !=
-		    AD9081_LOG_SPIR((in_data[0] << 8) + in_data[1],
-				    out_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
+		err = adi_ad9081_hal_read(device, reg, data, 1);
 	} else { /* access extended 32-bit data space */
-		in_data[0] = 0x3D;
-		in_data[1] = 0x21;
-		in_data[2] = (reg >> 8) & 0xC0;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d21, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x22;
-		in_data[2] = (reg >> 16) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d22, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x23;
-		in_data[2] = (reg >> 24) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d23, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		if (((reg >= 0x4F00000) && (reg <= 0x4FFFFFF)) ||
-		    ((reg >= 0x6001000) && (reg <= 0x60010FF))) {
-			/* 32-bit address, 8-bit data */
-			in_data[0] = ((reg >> 8) & 0x3F) | 0xC0;
-			in_data[1] = ((reg >> 0) & 0xFF);
-			if (API_CMS_ERROR_OK !=
-			    device->hal_info.spi_xfer(device->hal_info.user_data,
-						      in_data, out_data, 0x3))
-				return API_CMS_ERROR_SPI_XFER;
-			*data = out_data[2];
-			if (API_CMS_ERROR_OK !=
-			    AD9081_LOG_SPIR((in_data[0] << 8) + in_data[1],
-					    out_data[2]))
-				return API_CMS_ERROR_LOG_WRITE;
-		} else {
-			/* 32-bit address, 32-bit data */
-			reg += (device->hal_info.addr_inc ==
-				SPI_ADDR_INC_AUTO) ?
-				       0 :
-				       3;
-			in_data[0] = ((reg >> 8) & 0x3F) | 0xC0;
-			in_data[1] = ((reg >> 0) & 0xFF);
-			if (API_CMS_ERROR_OK !=
-			    device->hal_info.spi_xfer(
-				    device->hal_info.user_data, in_data,
-				    out_data, 0x20000006))
-				return API_CMS_ERROR_SPI_XFER;
-			if (device->hal_info.addr_inc == SPI_ADDR_INC_AUTO) {
-				*(uint32_t *)data = (out_data[2]) +
-						    (out_data[3] << 8) +
-						    (out_data[4] << 16) +
-						    (out_data[5] << 24);
-			} else { /* streaming addresses are decremented */
-				*(uint32_t *)data = (out_data[5]) +
-						    (out_data[4] << 8) +
-						    (out_data[3] << 16) +
-						    (out_data[2] << 24);
-			}
-			if (API_CMS_ERROR_OK !=
-			    AD9081_LOG_SPIR32((in_data[0] << 8) + in_data[1],
-					      *(uint32_t *)data))
-				return API_CMS_ERROR_LOG_WRITE;
-		}
+		/* 0x3d21..0x3d23 are written behind the shadow */
+		err = adi_ad9081_hal_txn_flush(device);
+		adi_ad9081_hal_shadow_drop(device);
+		if (err == API_CMS_ERROR_OK)
+			err = adi_ad9081_hal_reg_get_ext(device, reg, data);
 	}
+	adi_ad9081_hal_call_exit(device, call);
 
-	return API_CMS_ERROR_OK;
+	return err;
 }
 
 int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
 			       uint32_t data)
 {
-	uint8_t in_data[6] = { 0 }, out_data[6] = { 0 };
+	int32_t err;
+	uint8_t data8 = (uint8_t)(data & 0xFF), call;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
 
+	call = adi_ad9081_hal_call_enter(device, AD9081_HAL_CALL_REG_SET);
 	if (reg < 0x4000) {
-		in_data[0] = (reg >> 8) & 0x3F;
-		in_data[1] = (reg >> 0) & 0xFF;
-		in_data[2] = (uint8_t)(data & 0xFF);
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK !=
-		    AD9081_LOG_SPIW(reg & 0x3fff, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
+		err = adi_ad9081_hal_write(device, reg, &data8, 1);
 	} else { /* access extended 32-bit data space */
-		in_data[0] = 0x3D;
-		in_data[1] = 0x21;
-		in_data[2] = (reg >> 8) & 0xC0;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d21, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x22;
-		in_data[2] = (reg >> 16) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d22, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		in_data[0] = 0x3D;
-		in_data[1] = 0x23;
-		in_data[2] = (reg >> 24) & 0xFF;
-		if (API_CMS_ERROR_OK !=
-		    device->hal_info.spi_xfer(device->hal_info.user_data,
-					      in_data, out_data, 0x3))
-			return API_CMS_ERROR_SPI_XFER;
-		if (API_CMS_ERROR_OK != AD9081_LOG_SPIW(0x3d23, in_data[2]))
-			return API_CMS_ERROR_LOG_WRITE;
-		if (((reg >= 0x4F00000) && (reg <= 0x4FFFFFF)) ||
-		    ((reg >= 0x6001000) && (reg <= 0x60010FF))) {
-			/* 32-bit address, 8-bit data */
-			in_data[0] = ((reg >> 8) & 0x3F) | 0x40;
-			in_data[1] = ((reg >> 0) & 0xFF);
-			in_data[2] = (uint8_t)(data & 0xFF);
-			if (API_CMS_ERROR_OK !=
-			    device->hal_info.spi_xfer(device->hal_info.user_data,
-						      in_data, out_data, 0x3))
-				return API_CMS_ERROR_SPI_XFER;
-			if (API_CMS_ERROR_OK !=
-			    AD9081_LOG_SPIW((in_data[0] << 8) + in_data[1],
-					    in_data[2]))
-				return API_CMS_ERROR_LOG_WRITE;
-		} else {
-			/* 32-bit address, 32-bit data */
-			if (device->hal_info.addr_inc == SPI_ADDR_INC_AUTO) {
-				in_data[0] = ((reg >> 8) & 0x3F) | 0x40;
-				in_data[1] = ((reg >> 0) & 0xFF);
-				in_data[2] = (uint8_t)((data >> 0) & 0xFF);
-				in_data[3] = (uint8_t)((data >> 8) & 0xFF);
-				in_data[4] = (uint8_t)((data >> 16) & 0xFF);
-				in_data[5] = (uint8_t)((data >> 24) & 0xFF);
-			} else { /* streaming addresses are decremented */
-				in_data[0] = (((reg + 3) >> 8) & 0x3F) | 0x40;
-				in_data[1] = (((reg + 3) >> 0) & 0xFF);
-				in_data[2] = (uint8_t)((data >> 24) & 0xFF);
-				in_data[3] = (uint8_t)((data >> 16) & 0xFF);
-				in_data[4] = (uint8_t)((data >> 8) & 0xFF);
-				in_data[5] = (uint8_t)((data >> 0) & 0xFF);
-			}
-			if (API_CMS_ERROR_OK !=
-			    device->hal_info.spi_xfer(
-				    device->hal_info.user_data, in_data,
-				    out_data, 0x20000006))
-				return API_CMS_ERROR_SPI_XFER;
-			if (API_CMS_ERROR_OK !=
-			    AD9081_LOG_SPIW32((in_data[0] << 8) + in_data[1],
-					      data))
-				return API_CMS_ERROR_LOG_WRITE;
-		}
+		err = adi_ad9081_hal_txn_flush(device);
+		adi_ad9081_hal_shadow_drop(device);
+		if (err == API_CMS_ERROR_OK)
+			err = adi_ad9081_hal_reg_set_ext(device, reg, data);
 	}
+	adi_ad9081_hal_call_exit(device, call);
 
-	return API_CMS_ERROR_OK;
+	return err;
 }
 
+
 int32_t adi_ad9081_hal_cbusjrx_reg_get(adi_ad9081_device_t *device,
 				       uint32_t reg, uint8_t *data,
 				       uint8_t lane)
@@ -1034,9 +1600,7 @@ int32_t adi_ad9081_hal_multi_bf_get(adi_ad9081_device_t *device, uint32_t reg,
 				    uint8_t value_size_bytes, uint8_t num_bfs)
 {
 	int32_t err;
-	uint32_t mask = 0;
-	uint8_t data8 = 0, offset = 0, width = 0;
-	uint8_t i = 0, reg_bytes = 0, reg_read_reqd = 1;
+	uint8_t call;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(info);
 	AD9081_NULL_POINTER_RETURN(value);
@@ -1048,34 +1612,13 @@ int32_t adi_ad9081_hal_multi_bf_get(adi_ad9081_device_t *device, uint32_t reg,
 					     value_size_bytes);
 	}
 
-	/* Extract the mulit bit-fields from a single reg, or use standard method for more complex situations. */
-	for (i = 0; i < num_bfs; i++) {
-		offset = (uint8_t)(*(info + i) >> 0);
-		width = (uint8_t)(*(info + i) >> 8);
-		reg_bytes = ((width + offset) >> 3) +
-			    (((width + offset) & 7) == 0 ? 0 : 1);
-
-		if ((reg_bytes == 1) && (value_size_bytes == 1)) {
-			if (reg_read_reqd == 1) {
-				reg_read_reqd = 0;
-				err = adi_ad9081_hal_reg_get(device, reg,
-							     &data8);
-				AD9081_ERROR_RETURN(err);
-			}
-			mask = (1 << width) - 1;
-			**(value + i) = (data8 >> offset) & mask;
-		} else {
-			/* Use non-multi bf get */
-			AD9081_LOG_WARN(
-				"Multi bit-field get doesn't support cross register access. Will use standard, but incurs extra SPI reads.");
-			err = adi_ad9081_hal_bf_get(device, reg, *(info + i),
-						    *(value + i),
-						    value_size_bytes);
-			AD9081_ERROR_RETURN(err);
-		}
-	}
+	/* Extract the multi bit-fields from a single read of their registers */
+	call = adi_ad9081_hal_call_enter(device, AD9081_HAL_CALL_MULTI_BF_GET);
+	err = adi_ad9081_hal_bfs_get(device, reg, info, value, value_size_bytes,
+				     num_bfs);
+	adi_ad9081_hal_call_exit(device, call);
 
-	return API_CMS_ERROR_OK;
+	return err;
 }
 
 int32_t adi_ad9081_hal_multi_bf_set(adi_ad9081_device_t *device, uint32_t reg,
@@ -1083,9 +1626,7 @@ int32_t adi_ad9081_hal_multi_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 				    uint8_t num_bfs)
 {
 	int32_t err;
-	uint32_t mask = 0;
-	uint8_t data8 = 0, offset = 0, width = 0;
-	uint8_t i = 0, reg_bytes = 0, reg_read_reqd = 1;
+	uint8_t call;
 	AD9081_NULL_POINTER_RETURN(device);
 	AD9081_NULL_POINTER_RETURN(info);
 	AD9081_NULL_POINTER_RETURN(value);
@@ -1096,40 +1637,12 @@ int32_t adi_ad9081_hal_multi_bf_set(adi_ad9081_device_t *device, uint32_t reg,
 		return adi_ad9081_hal_bf_set(device, reg, *info, *value);
 	}
 
-	/* Write the bit fields */
-	for (i = 0; i < num_bfs; i++) {
-		offset = (uint8_t)(*(info + i) >> 0);
-		width = (uint8_t)(*(info + i) >> 8);
-		reg_bytes = ((width + offset) >> 3) +
-			    (((width + offset) & 7) == 0 ? 0 : 1);
-
-		if (reg_bytes == 1) {
-			if ((reg_read_reqd == 1) &&
-			    ((offset > 0) || ((offset + width) < 8))) {
-				reg_read_reqd = 0;
-				err = adi_ad9081_hal_reg_get(device, reg,
-							     &data8);
-				AD9081_ERROR_RETURN(err);
-			}
-			mask = (1 << width) - 1;
-			data8 = data8 & (~(mask << offset));
-			data8 = data8 | ((*(value + i) & mask) << offset);
-		} else {
-			/* Use non-multi bf set */
-			AD9081_LOG_WARN(
-				"multi bit-field set doesn't support cross register bit-fields.Will use standard, but incurs extra SPI reads.");
-			err = adi_ad9081_hal_bf_set(device, reg, *(info + i),
-						    *(value + i));
-			AD9081_ERROR_RETURN(err);
-		}
-	}
-
-	if (reg_read_reqd == 0) {
-		err = adi_ad9081_hal_reg_set(device, reg, data8);
-		AD9081_ERROR_RETURN(err);
-	}
+	/* Merge the bit fields into one read-modify-write of their registers */
+	call = adi_ad9081_hal_call_enter(device, AD9081_HAL_CALL_MULTI_BF_SET);
+	err = adi_ad9081_hal_bfs_set(device, reg, info, value, num_bfs);
+	adi_ad9081_hal_call_exit(device, call);
 
-	return API_CMS_ERROR_OK;
+	return err;
 }
 
-/*! @} */
\ No newline at end of file
+/*! @} */
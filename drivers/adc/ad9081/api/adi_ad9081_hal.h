@@ -126,6 +126,14 @@ int32_t adi_ad9081_hal_reg_get(adi_ad9081_device_t *device, uint32_t reg,
 int32_t adi_ad9081_hal_reg_set(adi_ad9081_device_t *device, uint32_t reg,
 			       uint32_t data);
 
+int32_t adi_ad9081_hal_txn_begin(adi_ad9081_device_t *device);
+int32_t adi_ad9081_hal_txn_end(adi_ad9081_device_t *device, int32_t err);
+int32_t adi_ad9081_hal_txn_enable_set(adi_ad9081_device_t *device,
+				      uint8_t enable);
+int32_t adi_ad9081_hal_stats_get(adi_ad9081_device_t *device,
+				 adi_ad9081_hal_stats_t *stats);
+int32_t adi_ad9081_hal_stats_reset(adi_ad9081_device_t *device);
+
 int32_t adi_ad9081_hal_cbusjrx_reg_get(adi_ad9081_device_t *device,
 				       uint32_t reg, uint8_t *data,
 				       uint8_t lane);
@@ -203,14 +203,13 @@ adi_ad9081_jesd_rx_syncb_driver_powerdown_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_jesd_rx_link_config_set(adi_ad9081_device_t *device,
-					   adi_ad9081_jesd_link_select_e links,
-					   adi_cms_jesd_param_t *jesd_param)
+static int32_t adi_ad9081_jesd_rx_link_config_set_txn(
+	adi_ad9081_device_t *device, adi_ad9081_jesd_link_select_e links,
+	adi_cms_jesd_param_t *jesd_param)
 {
 	int32_t err;
 	uint8_t i, link, not_in_table;
 	AD9081_NULL_POINTER_RETURN(device);
-	AD9081_LOG_FUNC();
 	AD9081_NULL_POINTER_RETURN(jesd_param);
 
 	if (jesd_param->jesd_duallink == 0) {
@@ -359,6 +358,22 @@ int32_t adi_ad9081_jesd_rx_link_config_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_jesd_rx_link_config_set(adi_ad9081_device_t *device,
+					   adi_ad9081_jesd_link_select_e links,
+					   adi_cms_jesd_param_t *jesd_param)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_LOG_FUNC();
+
+	/* gather the register updates into one spi transaction */
+	err = adi_ad9081_hal_txn_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_jesd_rx_link_config_set_txn(device, links, jesd_param);
+
+	return adi_ad9081_hal_txn_end(device, err);
+}
+
 int32_t adi_ad9081_jesd_rx_lmfc_delay_set(adi_ad9081_device_t *device,
 					  adi_ad9081_jesd_link_select_e links,
 					  uint16_t delay)
@@ -2114,9 +2129,9 @@ int32_t adi_ad9081_jesd_tx_link_conv_sel_set(
 	return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9081_jesd_tx_link_config_set(adi_ad9081_device_t *device,
-					   adi_ad9081_jesd_link_select_e links,
-					   adi_cms_jesd_param_t *jesd_param)
+static int32_t adi_ad9081_jesd_tx_link_config_set_txn(
+	adi_ad9081_device_t *device, adi_ad9081_jesd_link_select_e links,
+	adi_cms_jesd_param_t *jesd_param)
 {
 	int32_t err;
 	uint8_t i, j, link;
@@ -2127,7 +2142,6 @@ int32_t adi_ad9081_jesd_tx_link_config_set(adi_ad9081_device_t *device,
 	uint32_t a, b, c;
 	uint64_t bit_rate[2];
 	AD9081_NULL_POINTER_RETURN(device);
-	AD9081_LOG_FUNC();
 	AD9081_NULL_POINTER_RETURN(jesd_param);
 
 	/* calculate bit rate, _calcJtxLinkLaneRate()@ad9081_rx_r1.py */
@@ -2497,6 +2511,22 @@ int32_t adi_ad9081_jesd_tx_link_config_set(adi_ad9081_device_t *device,
 	return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9081_jesd_tx_link_config_set(adi_ad9081_device_t *device,
+					   adi_ad9081_jesd_link_select_e links,
+					   adi_cms_jesd_param_t *jesd_param)
+{
+	int32_t err;
+	AD9081_NULL_POINTER_RETURN(device);
+	AD9081_LOG_FUNC();
+
+	/* gather the register updates into one spi transaction */
+	err = adi_ad9081_hal_txn_begin(device);
+	AD9081_ERROR_RETURN(err);
+	err = adi_ad9081_jesd_tx_link_config_set_txn(device, links, jesd_param);
+
+	return adi_ad9081_hal_txn_end(device, err);
+}
+
 int32_t adi_ad9081_jesd_tx_link_reset(adi_ad9081_device_t *device,
 				      uint8_t reset)
 {
@@ -138,12 +138,13 @@ static int32_t ad9083_spi_xfer(void *user_data, uint8_t *in_data,
 			       uint8_t *out_data, uint32_t size_bytes)
 {
 	struct ad9083_phy *phy = user_data;
-	uint8_t data[6];
+	uint8_t data[AD9083_HAL_STREAM_MAX + 2];
 	uint8_t bytes_number;
 	int32_t ret;
 	int32_t i;
 
-	if (size_bytes > 6)
+	/* address and up to AD9083_HAL_STREAM_MAX streamed register bytes */
+	if (size_bytes > sizeof(data))
 		return FAILURE;
 
 	bytes_number = size_bytes;
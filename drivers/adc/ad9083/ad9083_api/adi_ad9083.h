@@ -112,6 +112,10 @@
 #define AD9083_ADC_CLK_FREQ_HZ_MAX    2000000000ull   /*!< 2  GHz */
 
 #define AD9083_JESD_SER_COUNT         4
+#define AD9083_HAL_STREAM_MAX         64
+#define AD9083_HAL_TXN_BYTES          128
+#define AD9083_HAL_TXN_RUNS           32
+#define AD9083_HAL_SHADOW_REGS        64
 
 /*!
  * @brief Enumerates Link select
@@ -351,12 +355,43 @@ typedef struct {
     uint32_t adc_freq_hz;                            /*!< ADC Clock Frequency in KHz. Valid range 1GHz to 2GHz */
 }adi_ad9083_info_t;
 
+/*!
+ * @brief Shadow register entry
+ */
+typedef struct {
+    uint16_t reg;                                    /*!< Register address */
+    uint8_t  val;                                    /*!< Register value */
+}adi_ad9083_hal_shadow_t;
+
+/*!
+ * @brief HAL transaction structure
+ *
+ * Between adi_ad9083_hal_txn_begin() and adi_ad9083_hal_txn_end(), register
+ * writes are queued and flushed as runs of consecutive registers, streamed
+ * once adi_ad9083_device_spi_config() has set the address ascension, and the
+ * read-modify-write of bitfields reads a shadow of the registers accessed.
+ */
+typedef struct {
+    uint8_t  disabled;                               /*!< Access the registers one by one, as legacy */
+    uint8_t  spi_stream;                             /*!< Register 0 set for ascending, msb first */
+    uint8_t  depth;                                  /*!< Nesting level of the open transactions */
+    uint8_t  num_runs;                               /*!< Number of queued runs of registers */
+    uint16_t num_bytes;                              /*!< Number of queued bytes */
+    uint16_t run_reg[AD9083_HAL_TXN_RUNS];           /*!< First register of the run */
+    uint8_t  run_len[AD9083_HAL_TXN_RUNS];           /*!< Length of the run */
+    uint8_t  data[AD9083_HAL_TXN_BYTES];             /*!< Queued bytes */
+    uint8_t  num_shadow;                             /*!< Number of valid shadow entries */
+    uint8_t  next_shadow;                            /*!< Entry replaced when the shadow is full */
+    adi_ad9083_hal_shadow_t shadow[AD9083_HAL_SHADOW_REGS]; /*!< Shadow registers */
+}adi_ad9083_hal_txn_t;
+
 /*!
  * @brief Device structure
  */
 typedef struct {
     adi_ad9083_hal_t  hal_info;
     adi_ad9083_info_t dev_info;
+    adi_ad9083_hal_txn_t hal_txn;                    /*!< SPI transaction, zero initialized */
 }adi_ad9083_device_t;
 
 /*============= E X P O R T S ==============*/
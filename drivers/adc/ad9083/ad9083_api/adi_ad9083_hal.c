@@ -17,6 +17,183 @@
 #include "adi_ad9083_hal.h"
 
 /*============= C O D E ====================*/
+static uint8_t adi_ad9083_hal_txn_active(adi_ad9083_device_t *device) {
+  return (device->hal_txn.depth > 0) && (device->hal_txn.disabled == 0);
+}
+
+static void adi_ad9083_hal_shadow_drop(adi_ad9083_device_t *device) {
+  device->hal_txn.num_shadow = 0;
+  device->hal_txn.next_shadow = 0;
+}
+
+static uint8_t adi_ad9083_hal_shadow_get(adi_ad9083_device_t *device,
+                                         uint32_t reg, uint8_t *val) {
+  adi_ad9083_hal_txn_t *txn = &device->hal_txn;
+  uint8_t i;
+
+  for (i = 0; i < txn->num_shadow; i++) {
+    if (txn->shadow[i].reg == reg) {
+      *val = txn->shadow[i].val;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void adi_ad9083_hal_shadow_put(adi_ad9083_device_t *device,
+                                      uint32_t reg, uint8_t val) {
+  adi_ad9083_hal_txn_t *txn = &device->hal_txn;
+  uint8_t i;
+
+  for (i = 0; i < txn->num_shadow; i++) {
+    if (txn->shadow[i].reg == reg)
+      break;
+  }
+  if (i == txn->num_shadow) {
+    if (txn->num_shadow < AD9083_HAL_SHADOW_REGS) {
+      i = txn->num_shadow++;
+    } else {
+      i = txn->next_shadow;
+      txn->next_shadow = (i + 1) % AD9083_HAL_SHADOW_REGS;
+    }
+    txn->shadow[i].reg = (uint16_t)reg;
+  }
+  txn->shadow[i].val = val;
+}
+
+static int32_t adi_ad9083_hal_stream_write(adi_ad9083_device_t *device,
+                                           uint32_t reg, uint8_t *data,
+                                           uint16_t len) {
+  uint8_t in_data[AD9083_HAL_STREAM_MAX + 2] = {0};
+  uint8_t out_data[AD9083_HAL_STREAM_MAX + 2] = {0};
+  uint16_t i, n;
+
+  while (len > 0) {
+    /* only the transactions stream, once the device is configured */
+    n = (adi_ad9083_hal_txn_active(device) && device->hal_txn.spi_stream)
+            ? len
+            : 1;
+    n = (n > AD9083_HAL_STREAM_MAX) ? AD9083_HAL_STREAM_MAX : n;
+    in_data[0] = ((reg >> 8) & 0xFF);
+    in_data[1] = (reg & 0xFF);
+    for (i = 0; i < n; i++)
+      in_data[2 + i] = data[i];
+    if (API_CMS_ERROR_OK !=
+        device->hal_info.spi_xfer(device->hal_info.user_data, in_data, out_data,
+                                  (n == 1) ? SPI_IN_OUT_BUFF_SZ : n + 2)) {
+      return API_CMS_ERROR_SPI_XFER;
+    }
+    reg += n;
+    data += n;
+    len -= n;
+  }
+  return API_CMS_ERROR_OK;
+}
+
+static int32_t adi_ad9083_hal_txn_flush(adi_ad9083_device_t *device) {
+  int32_t err = API_CMS_ERROR_OK;
+  adi_ad9083_hal_txn_t *txn = &device->hal_txn;
+  uint16_t offset = 0;
+  uint8_t i;
+
+  for (i = 0; i < txn->num_runs; i++) {
+    err = adi_ad9083_hal_stream_write(device, txn->run_reg[i],
+                                      &txn->data[offset], txn->run_len[i]);
+    if (err != API_CMS_ERROR_OK)
+      break;
+    offset += txn->run_len[i];
+  }
+  txn->num_runs = 0;
+  txn->num_bytes = 0;
+
+  return err;
+}
+
+static int32_t adi_ad9083_hal_txn_queue(adi_ad9083_device_t *device,
+                                        uint32_t reg, uint8_t data) {
+  int32_t err;
+  adi_ad9083_hal_txn_t *txn = &device->hal_txn;
+  uint8_t last = txn->num_runs - 1;
+
+  adi_ad9083_hal_shadow_put(device, reg, data);
+
+  /* a register written again at the end of the queue is written once */
+  if ((txn->num_runs > 0) &&
+      (txn->run_reg[last] + txn->run_len[last] - 1 == reg)) {
+    txn->data[txn->num_bytes - 1] = data;
+    return API_CMS_ERROR_OK;
+  }
+
+  /* writes to the next register extend the last streamed run */
+  if ((txn->num_runs == 0) ||
+      (txn->run_reg[last] + txn->run_len[last] != reg) ||
+      (txn->run_len[last] == AD9083_HAL_STREAM_MAX) ||
+      (txn->num_bytes == AD9083_HAL_TXN_BYTES)) {
+    if ((txn->num_runs == AD9083_HAL_TXN_RUNS) ||
+        (txn->num_bytes == AD9083_HAL_TXN_BYTES)) {
+      err = adi_ad9083_hal_txn_flush(device);
+      AD9083_ERROR_RETURN(err);
+    }
+    last = txn->num_runs++;
+    txn->run_reg[last] = (uint16_t)reg;
+    txn->run_len[last] = 0;
+  }
+  txn->run_len[last]++;
+  txn->data[txn->num_bytes++] = data;
+
+  return API_CMS_ERROR_OK;
+}
+
+/* read of a register modified by a bitfield write */
+static int32_t adi_ad9083_hal_rmw_get(adi_ad9083_device_t *device,
+                                      uint32_t reg, uint8_t *data) {
+  if (adi_ad9083_hal_txn_active(device) &&
+      adi_ad9083_hal_shadow_get(device, reg, data))
+    return API_CMS_ERROR_OK;
+
+  return adi_ad9083_hal_reg_get(device, reg, data);
+}
+
+int32_t adi_ad9083_hal_txn_begin(adi_ad9083_device_t *device) {
+  AD9083_NULL_POINTER_RETURN(device);
+  AD9083_INVALID_PARAM_RETURN(device->hal_txn.depth == 0xFF);
+
+  if (device->hal_txn.depth++ == 0)
+    adi_ad9083_hal_shadow_drop(device);
+
+  return API_CMS_ERROR_OK;
+}
+
+int32_t adi_ad9083_hal_txn_end(adi_ad9083_device_t *device, int32_t err) {
+  int32_t ret;
+  AD9083_NULL_POINTER_RETURN(device);
+  AD9083_INVALID_PARAM_RETURN(device->hal_txn.depth == 0);
+
+  if (device->hal_txn.depth > 1) {
+    device->hal_txn.depth--;
+    return err;
+  }
+  /* flushed while still open, so that the queued runs are streamed */
+  ret = adi_ad9083_hal_txn_flush(device);
+  device->hal_txn.depth = 0;
+  adi_ad9083_hal_shadow_drop(device);
+
+  return (err != API_CMS_ERROR_OK) ? err : ret;
+}
+
+int32_t adi_ad9083_hal_txn_enable_set(adi_ad9083_device_t *device,
+                                      uint8_t enable) {
+  int32_t err;
+  AD9083_NULL_POINTER_RETURN(device);
+
+  err = adi_ad9083_hal_txn_flush(device);
+  AD9083_ERROR_RETURN(err);
+  adi_ad9083_hal_shadow_drop(device);
+  device->hal_txn.disabled = (enable > 0) ? 0 : 1;
+
+  return API_CMS_ERROR_OK;
+}
+
 int32_t adi_ad9083_hal_hw_open(adi_ad9083_device_t *device) {
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.hw_open);
@@ -38,8 +215,13 @@ int32_t adi_ad9083_hal_hw_close(adi_ad9083_device_t *device) {
 }
 
 int32_t adi_ad9083_hal_delay_us(adi_ad9083_device_t *device, uint32_t us) {
+  int32_t err;
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.delay_us);
+
+  /* the delay is relative to the writes issued before it */
+  err = adi_ad9083_hal_txn_flush(device);
+  AD9083_ERROR_RETURN(err);
   if (API_CMS_ERROR_OK !=
       device->hal_info.delay_us(device->hal_info.user_data, us)) {
     return API_CMS_ERROR_DELAY_US;
@@ -49,8 +231,14 @@ int32_t adi_ad9083_hal_delay_us(adi_ad9083_device_t *device, uint32_t us) {
 
 int32_t adi_ad9083_hal_reset_pin_ctrl(adi_ad9083_device_t *device,
                                       uint8_t enable) {
+  int32_t err;
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.reset_pin_ctrl);
+
+  err = adi_ad9083_hal_txn_flush(device);
+  AD9083_ERROR_RETURN(err);
+  adi_ad9083_hal_shadow_drop(device);
+  device->hal_txn.spi_stream = 0;
   if (API_CMS_ERROR_OK !=
       device->hal_info.reset_pin_ctrl(device->hal_info.user_data, enable)) {
     return API_CMS_ERROR_RESET_PIN_CTRL;
@@ -138,7 +326,7 @@ int32_t adi_ad9083_hal_bf_set(adi_ad9083_device_t *device, uint32_t reg,
     for (reg_offset = 0; reg_offset < reg_bytes; reg_offset++) {
       if ((offset + width) <= 8) { /* last 8bits */
         if ((offset > 0) || ((offset + width) < 8)) {
-          err = adi_ad9083_hal_reg_get(device, reg + reg_offset, &data8);
+          err = adi_ad9083_hal_rmw_get(device, reg + reg_offset, &data8);
           AD9083_ERROR_RETURN(err);
         }
         mask = (1 << width) - 1;
@@ -146,7 +334,7 @@ int32_t adi_ad9083_hal_bf_set(adi_ad9083_device_t *device, uint32_t reg,
         data8 = data8 | ((value & mask) << offset);
       } else {
         if (offset > 0) {
-          err = adi_ad9083_hal_reg_get(device, reg + reg_offset, &data8);
+          err = adi_ad9083_hal_rmw_get(device, reg + reg_offset, &data8);
           AD9083_ERROR_RETURN(err);
         }
         mask = (1 << (8 - offset)) - 1;
@@ -166,6 +354,7 @@ int32_t adi_ad9083_hal_bf_set(adi_ad9083_device_t *device, uint32_t reg,
 
 int32_t adi_ad9083_hal_reg_get(adi_ad9083_device_t *device, uint32_t reg,
                                uint8_t *data) {
+  int32_t err;
   uint8_t in_data[SPI_IN_OUT_BUFF_SZ] = {0};
   uint8_t out_data[SPI_IN_OUT_BUFF_SZ] = {0};
   AD9083_NULL_POINTER_RETURN(device);
@@ -173,6 +362,9 @@ int32_t adi_ad9083_hal_reg_get(adi_ad9083_device_t *device, uint32_t reg,
   AD9083_NULL_POINTER_RETURN(data);
 
   if (reg < 0x1000) {
+    /* reads go to the device, after the writes queued before them */
+    err = adi_ad9083_hal_txn_flush(device);
+    AD9083_ERROR_RETURN(err);
     in_data[0] = (((reg >> 8) | 0x80) & 0xFF);
     in_data[1] = (reg & 0xFF);
     if (API_CMS_ERROR_OK !=
@@ -181,28 +373,32 @@ int32_t adi_ad9083_hal_reg_get(adi_ad9083_device_t *device, uint32_t reg,
       return API_CMS_ERROR_SPI_XFER;
     }
     *data = out_data[2];
+    if (adi_ad9083_hal_txn_active(device))
+      adi_ad9083_hal_shadow_put(device, reg, *data);
   }
   return API_CMS_ERROR_OK;
 }
 
 int32_t adi_ad9083_hal_reg_set(adi_ad9083_device_t *device, uint32_t reg,
                                uint8_t data) {
-  uint8_t in_data[SPI_IN_OUT_BUFF_SZ] = {0};
-  uint8_t out_data[SPI_IN_OUT_BUFF_SZ] = {0};
+  int32_t err;
   AD9083_NULL_POINTER_RETURN(device);
   AD9083_NULL_POINTER_RETURN(device->hal_info.spi_xfer);
 
-  if (reg < 0x1000) {
-    in_data[0] = ((reg >> 8) & 0xFF);
-    in_data[1] = (reg & 0xFF);
-    in_data[2] = data;
-    if (API_CMS_ERROR_OK !=
-        device->hal_info.spi_xfer(device->hal_info.user_data, in_data, out_data,
-                                  SPI_IN_OUT_BUFF_SZ)) {
-      return API_CMS_ERROR_SPI_XFER;
-    }
+  if (reg >= 0x1000)
+    return API_CMS_ERROR_OK;
+
+  if (reg == REG_SPI_INTERFACE_CONFIG_A_ADDR) { /* soft reset, spi config */
+    err = adi_ad9083_hal_txn_flush(device);
+    AD9083_ERROR_RETURN(err);
+    adi_ad9083_hal_shadow_drop(device);
+    /* streamed bytes go to ascending addresses, msb first */
+    device->hal_txn.spi_stream = ((data & 0xE7) == 0x24);
+  } else if (adi_ad9083_hal_txn_active(device)) {
+    return adi_ad9083_hal_txn_queue(device, reg, data);
   }
-  return API_CMS_ERROR_OK;
+
+  return adi_ad9083_hal_stream_write(device, reg, &data, 1);
 }
 
 int32_t adi_ad9083_hal_error_report(adi_ad9083_device_t *device,
@@ -49,6 +49,11 @@ int32_t adi_ad9083_hal_reg_get(adi_ad9083_device_t *device, uint32_t reg,
 int32_t adi_ad9083_hal_reg_set(adi_ad9083_device_t *device, uint32_t reg,
                                uint8_t data);
 
+int32_t adi_ad9083_hal_txn_begin(adi_ad9083_device_t *device);
+int32_t adi_ad9083_hal_txn_end(adi_ad9083_device_t *device, int32_t err);
+int32_t adi_ad9083_hal_txn_enable_set(adi_ad9083_device_t *device,
+                                      uint8_t enable);
+
 int32_t adi_ad9083_hal_error_report(adi_ad9083_device_t *device,
                                     adi_cms_log_type_e log_type, int32_t error,
                                     const char *file_name,
@@ -114,11 +114,11 @@ int32_t adi_ad9083_jesd_tx_cbus_default_set(adi_ad9083_device_t *device) {
   return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9083_jesd_tx_link_config_set(adi_ad9083_device_t *device,
-                                           adi_cms_jesd_param_t *jesd_param) {
+static int32_t
+adi_ad9083_jesd_tx_link_config_set_txn(adi_ad9083_device_t *device,
+                                       adi_cms_jesd_param_t *jesd_param) {
   int32_t err;
   AD9083_NULL_POINTER_RETURN(device);
-  AD9083_LOG_FUNC();
   AD9083_INVALID_PARAM_RETURN(jesd_param->jesd_l > 4);
 
   err =
@@ -173,6 +173,20 @@ int32_t adi_ad9083_jesd_tx_link_config_set(adi_ad9083_device_t *device,
   return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9083_jesd_tx_link_config_set(adi_ad9083_device_t *device,
+                                           adi_cms_jesd_param_t *jesd_param) {
+  int32_t err;
+  AD9083_NULL_POINTER_RETURN(device);
+  AD9083_LOG_FUNC();
+
+  /* gather the register updates into one spi transaction */
+  err = adi_ad9083_hal_txn_begin(device);
+  AD9083_ERROR_RETURN(err);
+  err = adi_ad9083_jesd_tx_link_config_set_txn(device, jesd_param);
+
+  return adi_ad9083_hal_txn_end(device, err);
+}
+
 int32_t adi_ad9083_jesd_tx_lan_xbar_set(adi_ad9083_device_t *device,
                                         uint8_t physical_lane,
                                         uint8_t logical_lane) {
@@ -1044,10 +1044,10 @@ int32_t adi_ad9083_rx_get_num_tones(adi_ad9083_device_t *device,
   return API_CMS_ERROR_OK;
 }
 
-int32_t adi_ad9083_rx_datapath_config_set(adi_ad9083_device_t *device,
-                                          adi_ad9083_datapath_mode_e mode,
-                                          uint8_t dec[4],
-                                          uint64_t nco_freq_hz[3]) {
+static int32_t
+adi_ad9083_rx_datapath_config_set_txn(adi_ad9083_device_t *device,
+                                      adi_ad9083_datapath_mode_e mode,
+                                      uint8_t dec[4], uint64_t nco_freq_hz[3]) {
   int32_t err;
   uint8_t fbw_sel, cic_sel, average_sel, fbw_div_sel, cic_div_sel, out_div_sel;
   uint8_t sample_order, deci_adc_data, no_ddc_mode, burst_mode, zstuff_en,
@@ -1055,7 +1055,6 @@ int32_t adi_ad9083_rx_datapath_config_set(adi_ad9083_device_t *device,
   uint8_t i, cic_dec, non_zero_tones;
   uint64_t ftw, adc_clk_hz;
   AD9083_NULL_POINTER_RETURN(device);
-  AD9083_LOG_FUNC();
   AD9083_INVALID_PARAM_RETURN(mode > AD9083_DATAPATH_ADC_CIC_NCO_G_H);
   AD9083_INVALID_PARAM_RETURN(dec[0] > AD9083_CIC_DEC_16);
 
@@ -1209,4 +1208,20 @@ int32_t adi_ad9083_rx_datapath_config_set(adi_ad9083_device_t *device,
   return API_CMS_ERROR_OK;
 }
 
+int32_t adi_ad9083_rx_datapath_config_set(adi_ad9083_device_t *device,
+                                          adi_ad9083_datapath_mode_e mode,
+                                          uint8_t dec[4],
+                                          uint64_t nco_freq_hz[3]) {
+  int32_t err;
+  AD9083_NULL_POINTER_RETURN(device);
+  AD9083_LOG_FUNC();
+
+  /* gather the register updates into one spi transaction */
+  err = adi_ad9083_hal_txn_begin(device);
+  AD9083_ERROR_RETURN(err);
+  err = adi_ad9083_rx_datapath_config_set_txn(device, mode, dec, nco_freq_hz);
+
+  return adi_ad9083_hal_txn_end(device, err);
+}
+
 /*! @} */
\ No newline at end of file
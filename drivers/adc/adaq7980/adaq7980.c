@@ -63,16 +63,12 @@ int32_t ad7980_read_data(struct adaq7980_dev *dev,
 	uint32_t commands_data[2] = {0xFF, 0xFF};
 	int32_t ret;
 
-	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
-	if (ret != SUCCESS)
-		return ret;
-
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
 	msg.rx_addr = (uint32_t)buf;
 	msg.commands_data = commands_data;
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples);
+	ret = spi_engine_session_transfer(dev->offload, &msg, samples);
 	if (ret != SUCCESS)
 		return ret;
 
@@ -124,10 +120,17 @@ int32_t adaq7980_setup(struct adaq7980_dev **device,
 
 	dev->offload_init_param = init_param->offload_init_param;
 
+	ret = spi_engine_session_init(&dev->offload, dev->spi_desc,
+				      dev->offload_init_param);
+	if (ret != SUCCESS)
+		goto error_pwm;
+
 	*device = dev;
 
 	return SUCCESS;
 
+error_pwm:
+	pwm_remove(dev->trigger_pwm_desc);
 error_spi:
 	spi_remove(dev->spi_desc);
 error_dev:
@@ -75,6 +75,8 @@ struct adaq7980_dev {
 	struct pwm_desc		*trigger_pwm_desc;
 	/* SPI module offload init */
 	struct spi_engine_offload_init_param *offload_init_param;
+	/* SPI module offload session */
+	struct spi_engine_session *offload;
 	/** Power down GPIO handler. */
 	struct gpio_desc	*gpio_pd_ldo;
 };
@@ -182,29 +182,40 @@ static bool get_next_ch_idx(uint32_t ch_mask, uint32_t last_idx,
 int32_t adc_read_samples(void* dev, uint16_t* buff, uint32_t samples)
 {
 	struct adc_demo_desc *desc;
+	uint32_t active[TOTAL_ADC_CHANNELS];
+	uint32_t nb_active = 0;
 	uint32_t k = 0;
 	uint32_t ch = -1;
+	uint32_t idx;
+	uint32_t j;
 
 	if(!dev)
 		return -ENODEV;
 
 	desc = dev;
 
+	/* Walk the channel mask once instead of once per sample */
+	while(get_next_ch_idx(desc->active_ch, ch, &ch) &&
+	      ch < TOTAL_ADC_CHANNELS)
+		active[nb_active++] = ch;
+
 	if(desc->loopback_buffers == NULL) {
 		//default sin function
 		int offset_per_ch = ARRAY_SIZE(sine_lut) / TOTAL_ADC_CHANNELS;
+		for(j = 0; j < nb_active; j++)
+			active[j] *= offset_per_ch;
 		for(int i = 0; i < samples; i++) {
-			while(get_next_ch_idx(desc->active_ch, ch, &ch))
-				buff[k++] = sine_lut[(i + ch * offset_per_ch ) % ARRAY_SIZE(sine_lut)];
+			for(j = 0; j < nb_active; j++)
+				buff[k++] = sine_lut[(i + active[j]) % ARRAY_SIZE(sine_lut)];
 		}
 
 		return samples;
 	}
 
 	for(int i = 0; i < samples; i++) {
-		while(get_next_ch_idx(desc->active_ch, ch, &ch))
-			buff[k++] = desc->loopback_buffers[ch]
-				    [i % desc->loopback_buffer_len];
+		idx = i % desc->loopback_buffer_len;
+		for(j = 0; j < nb_active; j++)
+			buff[k++] = desc->loopback_buffers[active[j]][idx];
 	}
 	return samples;
 }
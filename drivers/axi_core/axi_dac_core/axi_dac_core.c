@@ -52,6 +52,9 @@
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
+/* Words of the sine LUT written to the DAC memory at once */
+#define AXI_DAC_SINE_LUT_CHUNK			32
+
 #define AXI_DAC_REG_RSTN				0x40
 #define AXI_DAC_MMCM_RSTN				BIT(1)
 #define AXI_DAC_RSTN					BIT(0)
@@ -691,7 +694,6 @@ uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
 {
 	uint32_t length;
 	uint32_t tx_count;
-	uint32_t index_mem;
 	uint32_t index;
 	uint32_t index_i1;
 	uint32_t index_q1;
@@ -701,10 +703,12 @@ uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
 	uint32_t data_q1;
 	uint32_t data_i2;
 	uint32_t data_q2;
+	uint32_t lut[AXI_DAC_SINE_LUT_CHUNK];
+	uint32_t nb_words = 0;
+	uint32_t mem_offset = 0;
 	tx_count = sizeof(sine_lut) / sizeof(uint16_t);
 	if(dac->num_channels == 4) {
-		for(index = 0, index_mem = 0; index < (tx_count * 2);
-		    index += 2, index_mem += 2) {
+		for(index = 0; index < (tx_count * 2); index += 2) {
 			index_i1 = index;
 			index_q1 = index + (tx_count / 2);
 			if(index_q1 >= (tx_count * 2))
@@ -712,7 +716,7 @@ uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
 			data_i1 = (sine_lut[index_i1 / 2] << 20);
 			data_q1 = (sine_lut[index_q1 / 2] << 4);
 
-			axi_io_write(address, index_mem * 4, data_i1 | data_q1);
+			lut[nb_words++] = data_i1 | data_q1;
 
 			index_i2 = index_i1;
 			index_q2 = index_q1;
@@ -723,8 +727,15 @@ uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
 			data_i2 = (sine_lut[index_i2 / 2] << 20);
 			data_q2 = (sine_lut[index_q2 / 2] << 4);
 
-			axi_io_write(address, (index_mem + 1) * 4, data_i2 | data_q2);
+			lut[nb_words++] = data_i2 | data_q2;
 
+			/* The words are consecutive registers */
+			if (nb_words == AXI_DAC_SINE_LUT_CHUNK) {
+				axi_io_write_block(address, mem_offset * 4,
+						   lut, nb_words);
+				mem_offset += nb_words;
+				nb_words = 0;
+			}
 		}
 	} else {
 		for(index = 0; index < tx_count; index += 1) {
@@ -735,9 +746,18 @@ uint32_t axi_dac_set_sine_lut(struct axi_dac *dac,
 			data_i1 = (sine_lut[index_i1] << 20);
 			data_q1 = (sine_lut[index_q1] << 4);
 
-			axi_io_write(address, index * 4, data_i1 | data_q1);
+			lut[nb_words++] = data_i1 | data_q1;
+
+			if (nb_words == AXI_DAC_SINE_LUT_CHUNK) {
+				axi_io_write_block(address, mem_offset * 4,
+						   lut, nb_words);
+				mem_offset += nb_words;
+				nb_words = 0;
+			}
 		}
 	}
+	if (nb_words)
+		axi_io_write_block(address, mem_offset * 4, lut, nb_words);
 
 	length = tx_count * dac->num_channels * 2;
 	return length;
@@ -49,6 +49,11 @@
 #include "delay.h"
 #include "axi_dmac.h"
 
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+static int32_t axi_dmac_process(struct axi_dmac *dmac);
+
 /***************************************************************************//**
  * @brief dma_isr
 *******************************************************************************/
@@ -91,6 +96,13 @@ void axi_dmac_default_isr(void *instance)
 
 		axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
 	}
+	if (dmac->nb_active || dmac->queue_head) {
+		/* Polled again by the interrupted call once it is done */
+		if (dmac->queue_busy)
+			dmac->poll_pending = true;
+		else
+			axi_dmac_process(dmac);
+	}
 	if (reg_val & AXI_DMAC_IRQ_EOT) {
 		dmac->big_transfer.transfer_done = true;
 		dmac->big_transfer.address = 0;
@@ -143,6 +155,7 @@ int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
 
 	axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
 	if (!(reg_val & 1)) {
+		dmac->big_transfer.transfer_done = false;
 		switch (dmac->direction) {
 		case DMA_DEV_TO_MEM:
 			axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
@@ -286,6 +299,235 @@ int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 	return SUCCESS;
 }
 
+/***************************************************************************//**
+ * @brief Program one hardware transfer for the descriptor at the head of the
+ * software queue.
+ *******************************************************************************/
+static int32_t axi_dmac_start_segment(struct axi_dmac *dmac)
+{
+	struct axi_dmac_desc *desc = dmac->queue_head;
+	struct axi_dmac_slot *slot;
+	uint32_t address, x_len, y_len, stride;
+	uint32_t id;
+
+	address = desc->address + desc->offset;
+	if (desc->y_len > 1) {
+		x_len = desc->x_len;
+		y_len = desc->y_len;
+		stride = desc->stride;
+	} else {
+		x_len = min(desc->x_len - desc->offset,
+			    dmac->transfer_max_size + 1);
+		y_len = 1;
+		stride = 0;
+	}
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &id);
+
+	switch (dmac->direction) {
+	case DMA_DEV_TO_MEM:
+		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, address);
+		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, stride);
+		break;
+	case DMA_MEM_TO_DEV:
+		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, address);
+		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, stride);
+		break;
+	default:
+		return FAILURE; // Other directions are not supported yet
+	}
+	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, x_len - 1);
+	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, y_len - 1);
+	axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, dmac->flags & ~DMA_CYCLIC);
+	axi_dmac_write(dmac, AXI_DMAC_REG_START_TRANSFER, 0x1);
+
+	desc->offset += (desc->y_len > 1) ? desc->x_len : x_len;
+	desc->pending++;
+	desc->status = AXI_DMAC_DESC_ACTIVE;
+
+	slot = &dmac->active[(dmac->active_first + dmac->nb_active) %
+						 AXI_DMAC_MAX_ACTIVE];
+	slot->desc = desc;
+	slot->id = id;
+	slot->last = (desc->y_len > 1) || (desc->offset == desc->x_len);
+	dmac->nb_active++;
+
+	if (slot->last) {
+		dmac->queue_head = desc->next;
+		if (!dmac->queue_head)
+			dmac->queue_tail = NULL;
+	}
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief Complete the transfers finished by the hardware and keep its queue
+ * full with the descriptors that are waiting. Called from the default ISR,
+ * or with queue_busy set.
+ *******************************************************************************/
+static int32_t axi_dmac_process(struct axi_dmac *dmac)
+{
+	struct axi_dmac_slot *slot;
+	struct axi_dmac_desc *desc;
+	uint32_t done;
+	uint32_t reg_val;
+	int32_t ret;
+
+	if (dmac->nb_active) {
+		axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &done);
+		while (dmac->nb_active) {
+			slot = &dmac->active[dmac->active_first];
+			if (!(done & (1u << slot->id)))
+				break;
+
+			dmac->active_first = (dmac->active_first + 1) %
+					     AXI_DMAC_MAX_ACTIVE;
+			dmac->nb_active--;
+
+			desc = slot->desc;
+			desc->pending--;
+			if (slot->last && !desc->pending) {
+				desc->status = AXI_DMAC_DESC_DONE;
+				if (desc->complete)
+					desc->complete(desc, desc->ctx);
+			}
+		}
+
+		/* The hardware went idle with descriptors waiting */
+		if (!dmac->nb_active && dmac->queue_head)
+			dmac->nb_underruns++;
+	}
+
+	while (dmac->queue_head && dmac->nb_active < AXI_DMAC_MAX_ACTIVE) {
+		/* The hardware has not taken the previous transfer yet */
+		axi_dmac_read(dmac, AXI_DMAC_REG_START_TRANSFER, &reg_val);
+		if (reg_val & 1)
+			break;
+
+		ret = axi_dmac_start_segment(dmac);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief Complete the transfers finished by the hardware and keep its queue
+ * full with the descriptors that are waiting.
+ * Called by axi_dmac_submit() and axi_dmac_wait(), it can also be called
+ * periodically when the interrupt is not used. The default ISR does not touch
+ * the queue while it runs: when it fires, the queue is processed again, so
+ * that no end of transfer is missed.
+ *******************************************************************************/
+int32_t axi_dmac_poll(struct axi_dmac *dmac)
+{
+	int32_t ret;
+
+	do {
+		dmac->queue_busy = true;
+		dmac->poll_pending = false;
+		ret = axi_dmac_process(dmac);
+		dmac->queue_busy = false;
+	} while (ret == SUCCESS && dmac->poll_pending);
+
+	return ret;
+}
+
+/***************************************************************************//**
+ * @brief Queue a transfer. The descriptor must stay valid until its status
+ * becomes AXI_DMAC_DESC_DONE. The transfer is started right away if the
+ * hardware queue has room, so that consecutive descriptors are executed
+ * without a gap between them.
+ *******************************************************************************/
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_desc *desc)
+{
+	uint32_t reg_val;
+
+	if (!dmac || !desc || !desc->x_len)
+		return -EINVAL;
+	if (dmac->flags & DMA_CYCLIC)
+		return -EINVAL;
+	if (desc->y_len > 1 && (desc->x_len - 1 > dmac->transfer_max_size ||
+				desc->stride < desc->x_len))
+		return -EINVAL;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	}
+
+	desc->status = AXI_DMAC_DESC_QUEUED;
+	desc->next = NULL;
+	desc->offset = 0;
+	desc->pending = 0;
+
+	dmac->queue_busy = true;
+	if (dmac->queue_tail)
+		dmac->queue_tail->next = desc;
+	else
+		dmac->queue_head = desc;
+	dmac->queue_tail = desc;
+
+	return axi_dmac_poll(dmac);
+}
+
+/***************************************************************************//**
+ * @brief Wait for a queued descriptor to complete.
+ * @param timeout_us - Maximum time to wait. 0 to wait forever.
+ * @return SUCCESS when the descriptor completed, -ETIMEDOUT otherwise.
+ *******************************************************************************/
+int32_t axi_dmac_wait(struct axi_dmac *dmac, struct axi_dmac_desc *desc,
+		      uint32_t timeout_us)
+{
+	uint32_t elapsed = 0;
+	int32_t ret;
+
+	while (desc->status != AXI_DMAC_DESC_DONE) {
+		if (desc->status == AXI_DMAC_DESC_ABORTED)
+			return FAILURE;
+		if (timeout_us && elapsed++ >= timeout_us)
+			return -ETIMEDOUT;
+
+		ret = axi_dmac_poll(dmac);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (desc->status != AXI_DMAC_DESC_DONE)
+			udelay(1);
+	}
+
+	return SUCCESS;
+}
+
+/***************************************************************************//**
+ * @brief Stop the core and drop all the queued descriptors.
+ *******************************************************************************/
+int32_t axi_dmac_flush(struct axi_dmac *dmac)
+{
+	struct axi_dmac_desc *desc;
+
+	dmac->queue_busy = true;
+	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+
+	while (dmac->nb_active) {
+		desc = dmac->active[dmac->active_first].desc;
+		desc->status = AXI_DMAC_DESC_ABORTED;
+		dmac->active_first = (dmac->active_first + 1) %
+				     AXI_DMAC_MAX_ACTIVE;
+		dmac->nb_active--;
+	}
+	for (desc = dmac->queue_head; desc; desc = desc->next)
+		desc->status = AXI_DMAC_DESC_ABORTED;
+	dmac->queue_head = NULL;
+	dmac->queue_tail = NULL;
+
+	return axi_dmac_poll(dmac);
+}
+
 /***************************************************************************//**
  * @brief axi_dmac_init
  *******************************************************************************/
@@ -306,6 +548,13 @@ int32_t axi_dmac_init(struct axi_dmac **dmac_core,
 	dmac->big_transfer.address = 0;
 	dmac->big_transfer.size = 0;
 	dmac->big_transfer.size_done = 0;
+	dmac->queue_head = NULL;
+	dmac->queue_tail = NULL;
+	dmac->active_first = 0;
+	dmac->nb_active = 0;
+	dmac->queue_busy = false;
+	dmac->poll_pending = false;
+	dmac->nb_underruns = 0;
 
 	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, dmac->transfer_max_size);
 	axi_dmac_read(dmac, AXI_DMAC_REG_X_LENGTH, &dmac->transfer_max_size);
@@ -68,6 +68,9 @@
 #define AXI_DMAC_REG_SRC_STRIDE		0x424
 #define AXI_DMAC_REG_TRANSFER_DONE	0x428
 
+/* Number of transfers handed to the hardware at the same time */
+#define AXI_DMAC_MAX_ACTIVE			4
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -88,6 +91,47 @@ struct axi_dma_transfer {
 	volatile bool transfer_done;
 };
 
+enum axi_dmac_desc_status {
+	/* Waiting for a free slot in the hardware queue */
+	AXI_DMAC_DESC_QUEUED,
+	/* Handed to the hardware */
+	AXI_DMAC_DESC_ACTIVE,
+	/* Completed */
+	AXI_DMAC_DESC_DONE,
+	/* Dropped by axi_dmac_flush() */
+	AXI_DMAC_DESC_ABORTED
+};
+
+struct axi_dmac_desc;
+
+/* Called from the context processing the completion (ISR or polling) */
+typedef void (*axi_dmac_complete_cb)(struct axi_dmac_desc *desc, void *ctx);
+
+struct axi_dmac_desc {
+	/* Memory address of the first byte */
+	uint32_t address;
+	/* Bytes to transfer for 1D transfers, bytes per line for 2D */
+	uint32_t x_len;
+	/* Number of lines. 0 or 1 for 1D transfers */
+	uint32_t y_len;
+	/* Distance in bytes between the start of two lines (2D only) */
+	uint32_t stride;
+	/* Optional completion callback */
+	axi_dmac_complete_cb complete;
+	void *ctx;
+	/* Fields below are managed by the driver */
+	volatile enum axi_dmac_desc_status status;
+	struct axi_dmac_desc *next;
+	uint32_t offset;
+	volatile uint32_t pending;
+};
+
+struct axi_dmac_slot {
+	struct axi_dmac_desc *desc;
+	uint32_t id;
+	bool last;
+};
+
 struct axi_dmac {
 	const char *name;
 	uint32_t base;
@@ -95,6 +139,20 @@ struct axi_dmac {
 	uint32_t flags;
 	uint32_t transfer_max_size;
 	volatile struct axi_dma_transfer big_transfer;
+	/* Descriptors not yet fully handed to the hardware */
+	struct axi_dmac_desc *queue_head;
+	struct axi_dmac_desc *queue_tail;
+	/* Transfers handed to the hardware, oldest first */
+	struct axi_dmac_slot active[AXI_DMAC_MAX_ACTIVE];
+	uint32_t active_first;
+	volatile uint32_t nb_active;
+	/* Set while the queue is processed outside of the ISR */
+	volatile bool queue_busy;
+	/* Set by the ISR when it fired while queue_busy was set */
+	volatile bool poll_pending;
+	/* Times all the hardware transfers were found done while descriptors
+	 * were waiting: the hardware was idle until they were started */
+	volatile uint32_t nb_underruns;
 };
 
 struct axi_dmac_init {
@@ -117,6 +175,11 @@ int32_t axi_dmac_transfer_nonblocking(struct axi_dmac *dmac,
 int32_t axi_dmac_is_transfer_ready(struct axi_dmac *dmac, bool *rdy);
 int32_t axi_dmac_transfer(struct axi_dmac *dmac,
 			  uint32_t address, uint32_t size);
+int32_t axi_dmac_submit(struct axi_dmac *dmac, struct axi_dmac_desc *desc);
+int32_t axi_dmac_poll(struct axi_dmac *dmac);
+int32_t axi_dmac_wait(struct axi_dmac *dmac, struct axi_dmac_desc *desc,
+		      uint32_t timeout_us);
+int32_t axi_dmac_flush(struct axi_dmac *dmac);
 int32_t axi_dmac_init(struct axi_dmac **adc_core,
 		      const struct axi_dmac_init *init);
 int32_t axi_dmac_remove(struct axi_dmac *dmac);
@@ -45,6 +45,7 @@
 
 #include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
 #include "iio.h"
 #include "iio_axi_adc.h"
@@ -375,6 +376,92 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 	return SUCCESS;
 }
 
+/**
+ * @brief Queue a read of samples without waiting for the transfer to finish.
+ * The DMA moves from one queued read to the next one without a gap.
+ * @param dev - Instance of the iio_axi_adc
+ * @param buff - Buffer where to read samples
+ * @param nb_samples - Number of samples
+ * @return SUCCESS in case of success, -EBUSY if IIO_AXI_ADC_ASYNC_READS reads
+ * are already queued or negative value otherwise.
+ */
+int32_t iio_axi_adc_read_dev_async(void *dev, void *buff, uint32_t nb_samples)
+{
+	struct iio_axi_adc_desc *iio_adc;
+	struct axi_dmac_desc *desc;
+	int32_t ret;
+
+	if (!dev)
+		return FAILURE;
+
+	iio_adc = (struct iio_axi_adc_desc *)dev;
+	if (iio_adc->async_count == IIO_AXI_ADC_ASYNC_READS)
+		return -EBUSY;
+
+	desc = &iio_adc->async_descs[(iio_adc->async_first +
+				      iio_adc->async_count) %
+				     IIO_AXI_ADC_ASYNC_READS];
+	memset(desc, 0, sizeof(*desc));
+	desc->address = (uint32_t)(uintptr_t)buff;
+	desc->x_len = nb_samples * hweight8(iio_adc->mask) *
+		      (STORAGE_BITS / 8);
+
+	iio_adc->dmac->flags = 0;
+	ret = axi_dmac_submit(iio_adc->dmac, desc);
+	if (ret == -EINVAL)
+		return ret;
+	/* The read is queued, errors of the DMAC are reported when it is
+	 * polled by iio_axi_adc_read_dev_done */
+	iio_adc->async_count++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Check if the oldest read queued by iio_axi_adc_read_dev_async is
+ * done. Once done, it is removed from the queue.
+ * @param dev - Instance of the iio_axi_adc
+ * @param done - Set to true if the samples are available in the buffer
+ * @return SUCCESS in case of success or negative value otherwise.
+ */
+int32_t iio_axi_adc_read_dev_done(void *dev, bool *done)
+{
+	struct iio_axi_adc_desc *iio_adc;
+	struct axi_dmac_desc *desc;
+	int32_t ret;
+
+	if (!dev || !done)
+		return FAILURE;
+
+	iio_adc = (struct iio_axi_adc_desc *)dev;
+	if (!iio_adc->async_count)
+		return FAILURE;
+
+	desc = &iio_adc->async_descs[iio_adc->async_first];
+	if (desc->status != AXI_DMAC_DESC_DONE &&
+	    desc->status != AXI_DMAC_DESC_ABORTED) {
+		ret = axi_dmac_poll(iio_adc->dmac);
+		if (ret < 0)
+			return ret;
+	}
+
+	*done = desc->status == AXI_DMAC_DESC_DONE ||
+		desc->status == AXI_DMAC_DESC_ABORTED;
+	if (!*done)
+		return SUCCESS;
+
+	iio_adc->async_first = (iio_adc->async_first + 1) %
+			       IIO_AXI_ADC_ASYNC_READS;
+	iio_adc->async_count--;
+	if (desc->status == AXI_DMAC_DESC_ABORTED)
+		return FAILURE;
+
+	if (iio_adc->dcache_invalidate_range)
+		iio_adc->dcache_invalidate_range(desc->address, desc->x_len);
+
+	return SUCCESS;
+}
+
 /**
  * @brief Delete iio_device.
  * @param iio_device - Structure describing a device, channels and attributes.
@@ -446,6 +533,8 @@ static int32_t iio_axi_adc_create_device_descriptor(
 
 	iio_device->prepare_transfer = iio_axi_adc_prepare_transfer;
 	iio_device->read_dev = iio_axi_adc_read_dev;
+	iio_device->read_dev_async = iio_axi_adc_read_dev_async;
+	iio_device->read_dev_done = iio_axi_adc_read_dev_done;
 
 	return SUCCESS;
 error:
@@ -48,6 +48,13 @@
 #include "axi_adc_core.h"
 #include "axi_dmac.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Number of reads read_dev_async can queue to the DMA */
+#define IIO_AXI_ADC_ASYNC_READS	4
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -63,6 +70,12 @@ struct iio_axi_adc_desc {
 	uint32_t mask;
 	/** dma device */
 	struct axi_dmac *dmac;
+	/** Transfers queued by read_dev_async, in a ring */
+	struct axi_dmac_desc async_descs[IIO_AXI_ADC_ASYNC_READS];
+	/** Oldest transfer queued by read_dev_async */
+	uint32_t async_first;
+	/** Number of transfers queued by read_dev_async */
+	uint32_t async_count;
 	/** Invalidate cache memory function pointer */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
 	/** Custom implementation for get sampling frequency */
@@ -42,6 +42,7 @@
 /******************************************************************************/
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 #include "axi_io.h"
 #include "util.h"
@@ -121,6 +122,7 @@ int32_t adxcvr_drp_wait_idle(struct adxcvr *xcvr,
 
 	do {
 		adxcvr_read(xcvr, ADXCVR_REG_DRP_STATUS(drp_addr), &val);
+		xcvr->drp_stats.status_reads++;
 		if (!(val & ADXCVR_DRP_STATUS_BUSY))
 			return ADXCVR_DRP_STATUS_RDATA(val);
 
@@ -132,6 +134,23 @@ int32_t adxcvr_drp_wait_idle(struct adxcvr *xcvr,
 	return FAILURE;
 }
 
+/**
+ * @brief adxcvr_drp_select
+ */
+static void adxcvr_drp_select(struct adxcvr *xcvr,
+			      uint32_t drp_addr,
+			      uint32_t drp_sel)
+{
+	uint32_t *sel = &xcvr->drp_sel[drp_addr == ADXCVR_DRP_PORT_ADDR_CHANNEL];
+
+	if (*sel == drp_sel)
+		return;
+
+	adxcvr_write(xcvr, ADXCVR_REG_DRP_SEL(drp_addr), drp_sel);
+	xcvr->drp_stats.sel_writes++;
+	*sel = drp_sel;
+}
+
 /**
  * @brief adxcvr_drp_read
  */
@@ -150,8 +169,9 @@ int32_t adxcvr_drp_read(struct adxcvr *xcvr,
 
 	drp_sel = drp_port & 0xFF;
 
-	adxcvr_write(xcvr, ADXCVR_REG_DRP_SEL(drp_addr), drp_sel);
+	adxcvr_drp_select(xcvr, drp_addr, drp_sel);
 	adxcvr_write(xcvr, ADXCVR_REG_DRP_CTRL(drp_addr), ADXCVR_DRP_CTRL_ADDR(reg));
+	xcvr->drp_stats.reads++;
 
 	ret = adxcvr_drp_wait_idle(xcvr, drp_addr);
 	if (ret < 0)
@@ -180,9 +200,10 @@ int32_t adxcvr_drp_write(struct adxcvr *xcvr,
 
 	drp_sel = drp_port & 0xFF;
 
-	adxcvr_write(xcvr, ADXCVR_REG_DRP_SEL(drp_addr), drp_sel);
+	adxcvr_drp_select(xcvr, drp_addr, drp_sel);
 	adxcvr_write(xcvr, ADXCVR_REG_DRP_CTRL(drp_addr), (ADXCVR_DRP_CTRL_WR |
 			ADXCVR_DRP_CTRL_ADDR(reg) | ADXCVR_DRP_CTRL_WDATA(val)));
+	xcvr->drp_stats.writes++;
 
 	ret = adxcvr_drp_wait_idle(xcvr, drp_addr);
 	if (ret < 0)
@@ -191,6 +212,200 @@ int32_t adxcvr_drp_write(struct adxcvr *xcvr,
 	return SUCCESS;
 }
 
+/**
+ * @brief adxcvr_drp_queue_start
+ *
+ * Until adxcvr_drp_queue_commit(), the DRP field updates done through the
+ * xilinx_xcvr helpers are queued. Updates of the same register are merged,
+ * so that each register is read and written once, and updates of
+ * ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST) apply to all the lanes.
+ */
+int32_t adxcvr_drp_queue_start(struct adxcvr *xcvr)
+{
+	xcvr->drp_queue.nb_updates = 0;
+	xcvr->drp_queue.active = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief adxcvr_drp_queue_update
+ */
+int32_t adxcvr_drp_queue_update(struct adxcvr *xcvr,
+				uint32_t drp_port,
+				uint32_t reg,
+				uint32_t mask,
+				uint32_t val)
+{
+	struct adxcvr_drp_queue *queue = &xcvr->drp_queue;
+	struct adxcvr_drp_update *update;
+	uint32_t i;
+	int32_t ret;
+
+	mask &= 0xFFFF;
+	val &= mask;
+
+	for (i = 0; i < queue->nb_updates; i++) {
+		update = &queue->updates[i];
+		if (update->port == drp_port && update->reg == reg) {
+			update->val = (update->val & ~mask) | val;
+			update->mask |= mask;
+			return SUCCESS;
+		}
+	}
+
+	if (queue->nb_updates == ADXCVR_DRP_QUEUE_SIZE) {
+		ret = adxcvr_drp_queue_flush(xcvr);
+		if (ret < 0)
+			return ret;
+	}
+
+	update = &queue->updates[queue->nb_updates++];
+	update->port = drp_port;
+	update->reg = reg;
+	update->mask = mask;
+	update->val = val;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief adxcvr_drp_apply
+ */
+static int32_t adxcvr_drp_apply(struct adxcvr *xcvr,
+				uint32_t drp_port,
+				const struct adxcvr_drp_update *update)
+{
+	uint32_t val;
+	int32_t ret;
+
+	if (update->mask == 0xFFFF)
+		return adxcvr_drp_write(xcvr, drp_port, update->reg, update->val);
+
+	ret = adxcvr_drp_read(xcvr, drp_port, update->reg, &val);
+	if (ret < 0)
+		return ret;
+
+	if ((val & update->mask) == update->val)
+		return SUCCESS;
+
+	return adxcvr_drp_write(xcvr, drp_port, update->reg,
+				(val & ~update->mask) | update->val);
+}
+
+/**
+ * @brief adxcvr_drp_apply_all_lanes
+ */
+static int32_t adxcvr_drp_apply_all_lanes(struct adxcvr *xcvr,
+		const struct adxcvr_drp_update *update)
+{
+	uint32_t i, val, new_val, bcast_val = 0;
+	bool changed = false, uniform = true;
+	int32_t ret;
+
+	if (xcvr->drp_broadcast && update->mask == 0xFFFF)
+		return adxcvr_drp_apply(xcvr, update->port, update);
+
+	if (!xcvr->drp_broadcast) {
+		for (i = 0; i < xcvr->num_lanes; i++) {
+			ret = adxcvr_drp_apply(xcvr, ADXCVR_DRP_PORT_CHANNEL(i),
+					       update);
+			if (ret < 0)
+				return ret;
+		}
+
+		return SUCCESS;
+	}
+
+	/* One broadcast write if all the lanes end up with the same value */
+	for (i = 0; i < xcvr->num_lanes; i++) {
+		ret = adxcvr_drp_read(xcvr, ADXCVR_DRP_PORT_CHANNEL(i),
+				      update->reg, &val);
+		if (ret < 0)
+			return ret;
+
+		new_val = (val & ~update->mask) | update->val;
+		if (new_val != val)
+			changed = true;
+		if (i == 0)
+			bcast_val = new_val;
+		else if (new_val != bcast_val)
+			uniform = false;
+	}
+
+	if (!changed)
+		return SUCCESS;
+
+	if (uniform)
+		return adxcvr_drp_write(xcvr, update->port, update->reg,
+					bcast_val);
+
+	for (i = 0; i < xcvr->num_lanes; i++) {
+		ret = adxcvr_drp_apply(xcvr, ADXCVR_DRP_PORT_CHANNEL(i), update);
+		if (ret < 0)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief adxcvr_drp_queue_flush
+ *
+ * Write the queued updates, the queue stays active.
+ */
+int32_t adxcvr_drp_queue_flush(struct adxcvr *xcvr)
+{
+	struct adxcvr_drp_queue *queue = &xcvr->drp_queue;
+	struct adxcvr_drp_update *update;
+	uint32_t i;
+	int32_t ret = SUCCESS;
+
+	for (i = 0; i < queue->nb_updates; i++) {
+		update = &queue->updates[i];
+		if (update->port == ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST))
+			ret = adxcvr_drp_apply_all_lanes(xcvr, update);
+		else
+			ret = adxcvr_drp_apply(xcvr, update->port, update);
+		if (ret < 0)
+			break;
+	}
+
+	queue->nb_updates = 0;
+
+	return ret;
+}
+
+/**
+ * @brief adxcvr_drp_queue_commit
+ */
+int32_t adxcvr_drp_queue_commit(struct adxcvr *xcvr)
+{
+	int32_t ret;
+
+	ret = adxcvr_drp_queue_flush(xcvr);
+	xcvr->drp_queue.active = false;
+
+	return ret;
+}
+
+/**
+ * @brief adxcvr_drp_queue_discard
+ */
+void adxcvr_drp_queue_discard(struct adxcvr *xcvr)
+{
+	xcvr->drp_queue.nb_updates = 0;
+	xcvr->drp_queue.active = false;
+}
+
+/**
+ * @brief adxcvr_drp_stats_reset
+ */
+void adxcvr_drp_stats_reset(struct adxcvr *xcvr)
+{
+	memset(&xcvr->drp_stats, 0, sizeof(xcvr->drp_stats));
+}
+
 /**
  * @brief adxcvr_clk_set_rate
  */
@@ -215,51 +430,63 @@ int32_t adxcvr_clk_set_rate(struct adxcvr *xcvr,
 	if (ret < 0)
 		return ret;
 
-	for (i = 0; i < xcvr->num_lanes; i++) {
+	/* The lanes share the same settings */
+	adxcvr_drp_queue_start(xcvr);
 
-		if (xcvr->cpll_enable)
-			ret = xilinx_xcvr_cpll_write_config(&xcvr->xlx_xcvr,
-							    ADXCVR_DRP_PORT_CHANNEL(i),
-							    &cpll_conf);
-		else if (i % 4 == 0)
+	if (xcvr->cpll_enable) {
+		ret = xilinx_xcvr_cpll_write_config(&xcvr->xlx_xcvr,
+						    ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						    &cpll_conf);
+	} else {
+		for (i = 0; i < xcvr->num_lanes; i += 4) {
 			ret = xilinx_xcvr_qpll_write_config(&xcvr->xlx_xcvr,
 							    ADXCVR_DRP_PORT_COMMON(i),
 							    &qpll_conf);
-		if (ret < 0)
-			return ret;
-
-		ret = xilinx_xcvr_write_out_div(&xcvr->xlx_xcvr,
-						ADXCVR_DRP_PORT_CHANNEL(i),
-						xcvr->tx_enable ? -1 : (int32_t)out_div,
-						xcvr->tx_enable ? (int32_t)out_div : -1);
-		if (ret < 0)
-			return ret;
-
-		if (!xcvr->tx_enable) {
-			ret = xilinx_xcvr_configure_cdr(&xcvr->xlx_xcvr,
-							ADXCVR_DRP_PORT_CHANNEL(i),
-							rate, out_div,
-							xcvr->lpm_enable);
 			if (ret < 0)
-				return ret;
-
-			ret = xilinx_xcvr_write_rx_clk25_div(&xcvr->xlx_xcvr,
-							     ADXCVR_DRP_PORT_CHANNEL(i),
-							     clk25_div);
-		} else {
-			ret = xilinx_xcvr_write_tx_clk25_div(&xcvr->xlx_xcvr,
-							     ADXCVR_DRP_PORT_CHANNEL(i),
-							     clk25_div);
+				break;
 		}
+	}
+	if (ret < 0)
+		goto err;
+
+	ret = xilinx_xcvr_write_out_div(&xcvr->xlx_xcvr,
+					ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+					xcvr->tx_enable ? -1 : (int32_t)out_div,
+					xcvr->tx_enable ? (int32_t)out_div : -1);
+	if (ret < 0)
+		goto err;
 
+	if (!xcvr->tx_enable) {
+		ret = xilinx_xcvr_configure_cdr(&xcvr->xlx_xcvr,
+						ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						rate, out_div,
+						xcvr->lpm_enable);
 		if (ret < 0)
-			return ret;
+			goto err;
+
+		ret = xilinx_xcvr_write_rx_clk25_div(&xcvr->xlx_xcvr,
+						     ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						     clk25_div);
+	} else {
+		ret = xilinx_xcvr_write_tx_clk25_div(&xcvr->xlx_xcvr,
+						     ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						     clk25_div);
 	}
+	if (ret < 0)
+		goto err;
 
+	ret = adxcvr_drp_queue_commit(xcvr);
+	if (ret < 0)
+		return ret;
 
 	xcvr->lane_rate_khz = rate;
 
 	return SUCCESS;
+
+err:
+	adxcvr_drp_queue_discard(xcvr);
+
+	return ret;
 }
 
 /**
@@ -329,10 +556,9 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 {
 	struct adxcvr *xcvr;
 	uint32_t synth_conf, xcvr_type;
-	uint32_t i;
 	int32_t ret;
 
-	xcvr = (struct adxcvr *)malloc(sizeof(*xcvr));
+	xcvr = (struct adxcvr *)calloc(1, sizeof(*xcvr));
 	if (!xcvr)
 		return FAILURE;
 
@@ -346,6 +572,9 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 	xcvr->lane_rate_khz = init->lane_rate_khz;
 	xcvr->ref_rate_khz = init->ref_rate_khz;
 
+	xcvr->drp_sel[0] = ~0;
+	xcvr->drp_sel[1] = ~0;
+
 	adxcvr_read(xcvr, ADXCVR_REG_SYNTH, &synth_conf);
 	xcvr->tx_enable = (synth_conf >> 8) & 1;
 	xcvr->num_lanes = synth_conf & 0xff;
@@ -356,6 +585,10 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 	if (AXI_PCORE_VER_MAJOR(xcvr->xlx_xcvr.version) > 0x10)
 		adxcvr_get_info(xcvr);
 
+	/* Older cores may not decode the broadcast port select */
+	xcvr->drp_broadcast = AXI_PCORE_VER_MAJOR(xcvr->xlx_xcvr.version) >=
+			      ADXCVR_DRP_BROADCAST_VER_MAJOR;
+
 	/* Ensure compliance with legacy xcvr type */
 	if (AXI_PCORE_VER_MAJOR(xcvr->xlx_xcvr.version) <= 0x10) {
 		switch (xcvr_type) {
@@ -401,11 +634,11 @@ int32_t adxcvr_init(struct adxcvr **ad_xcvr,
 	xcvr->xlx_xcvr.ad_xcvr = xcvr;
 
 	if (!xcvr->tx_enable) {
-		for (i = 0; i < xcvr->num_lanes; i++) {
-			xilinx_xcvr_configure_lpm_dfe_mode(&xcvr->xlx_xcvr,
-							   ADXCVR_DRP_PORT_CHANNEL(i),
-							   xcvr->lpm_enable);
-		}
+		adxcvr_drp_queue_start(xcvr);
+		xilinx_xcvr_configure_lpm_dfe_mode(&xcvr->xlx_xcvr,
+						   ADXCVR_DRP_PORT_CHANNEL(ADXCVR_BROADCAST),
+						   xcvr->lpm_enable);
+		adxcvr_drp_queue_commit(xcvr);
 	}
 
 	if (xcvr->lane_rate_khz && xcvr->ref_rate_khz) {
@@ -46,9 +46,38 @@
 #include <stdbool.h>
 #include "xilinx_transceiver.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define ADXCVR_DRP_QUEUE_SIZE	32
+/* First core version that writes all the lanes on the 0xff port select */
+#define ADXCVR_DRP_BROADCAST_VER_MAJOR	0x11
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
+struct adxcvr_drp_update {
+	uint32_t port;
+	uint16_t reg;
+	uint16_t mask;
+	uint16_t val;
+};
+
+/* DRP field updates, written by adxcvr_drp_queue_commit() */
+struct adxcvr_drp_queue {
+	bool active;
+	uint32_t nb_updates;
+	struct adxcvr_drp_update updates[ADXCVR_DRP_QUEUE_SIZE];
+};
+
+/* DRP accesses since the initialization or adxcvr_drp_stats_reset() */
+struct adxcvr_drp_stats {
+	uint32_t reads;
+	uint32_t writes;
+	uint32_t status_reads;
+	uint32_t sel_writes;
+};
+
 struct adxcvr {
 	const char *name;
 	uint32_t base;
@@ -61,6 +90,15 @@ struct adxcvr {
 	uint32_t sys_clk_sel;
 	uint32_t out_clk_sel;
 	struct xilinx_xcvr xlx_xcvr;
+	/*
+	 * Channel writes go to all the lanes at once, set from core version
+	 * ADXCVR_DRP_BROADCAST_VER_MAJOR on
+	 */
+	bool drp_broadcast;
+	/* Last port selected on the common and channel DRP interfaces */
+	uint32_t drp_sel[2];
+	struct adxcvr_drp_queue drp_queue;
+	struct adxcvr_drp_stats drp_stats;
 };
 
 struct adxcvr_init {
@@ -85,6 +123,16 @@ int32_t adxcvr_drp_write(struct adxcvr *xcvr,
 			 uint32_t drp_port,
 			 uint32_t reg,
 			 uint32_t val);
+int32_t adxcvr_drp_queue_start(struct adxcvr *xcvr);
+int32_t adxcvr_drp_queue_update(struct adxcvr *xcvr,
+				uint32_t drp_port,
+				uint32_t reg,
+				uint32_t mask,
+				uint32_t val);
+int32_t adxcvr_drp_queue_flush(struct adxcvr *xcvr);
+int32_t adxcvr_drp_queue_commit(struct adxcvr *xcvr);
+void adxcvr_drp_queue_discard(struct adxcvr *xcvr);
+void adxcvr_drp_stats_reset(struct adxcvr *xcvr);
 int32_t adxcvr_status_error(struct adxcvr *xcvr);
 int32_t adxcvr_clk_enable(struct adxcvr *xcvr);
 int32_t adxcvr_clk_disable(struct adxcvr *xcvr);
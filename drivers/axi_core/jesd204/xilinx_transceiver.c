@@ -124,6 +124,14 @@ int32_t xilinx_xcvr_read(struct xilinx_xcvr *xcvr, uint32_t drp_port,
 	return adxcvr_drp_read(xcvr->ad_xcvr, drp_port, reg_addr, reg_val);
 }
 
+/**
+ * @brief xilinx_xcvr_drp_queued
+ */
+static bool xilinx_xcvr_drp_queued(struct xilinx_xcvr *xcvr)
+{
+	return xcvr->ad_xcvr && xcvr->ad_xcvr->drp_queue.active;
+}
+
 /**
  * @brief xilinx_xcvr_drp_read
  */
@@ -132,6 +140,13 @@ int32_t xilinx_xcvr_drp_read(struct xilinx_xcvr *xcvr,
 {
 	int32_t ret;
 
+	/* Read the values the queued updates leave */
+	if (xilinx_xcvr_drp_queued(xcvr)) {
+		ret = adxcvr_drp_queue_flush(xcvr->ad_xcvr);
+		if (ret < 0)
+			return ret;
+	}
+
 	ret = xilinx_xcvr_read(xcvr, drp_port, reg, val);
 
 	if (ret < 0) {
@@ -153,6 +168,10 @@ int32_t xilinx_xcvr_drp_write(struct xilinx_xcvr *xcvr,
 	uint32_t read_val;
 	int32_t ret;
 
+	if (xilinx_xcvr_drp_queued(xcvr))
+		return adxcvr_drp_queue_update(xcvr->ad_xcvr, drp_port, reg,
+					       0xFFFF, val);
+
 	ret = xilinx_xcvr_write(xcvr, drp_port, reg, val);
 	if (ret < 0) {
 		printf("%s: Failed to write reg %"PRIu32"-0x%"PRIX32": %"PRId32"\n",
@@ -178,12 +197,20 @@ int32_t xilinx_xcvr_drp_update(struct xilinx_xcvr *xcvr, uint32_t drp_port,
 	uint32_t read_val;
 	int32_t ret;
 
+	if (xilinx_xcvr_drp_queued(xcvr))
+		return adxcvr_drp_queue_update(xcvr->ad_xcvr, drp_port, reg,
+					       mask, val);
+
 	ret = xilinx_xcvr_drp_read(xcvr, drp_port, reg, &read_val);
 	if (ret < 0)
 		return ret;
 
 	val |= read_val & ~mask;
 
+	/* Skip the write and the read back if nothing changes */
+	if (val == read_val)
+		return SUCCESS;
+
 	return xilinx_xcvr_drp_write(xcvr, drp_port, reg, val);
 }
 
@@ -394,145 +421,294 @@ static void xilinx_xcvr_setup_qpll_vco_range(struct xilinx_xcvr *xcvr,
 }
 
 /**
- * @brief xilinx_xcvr_calc_cpll_config
+ * @brief xilinx_xcvr_cpll_vco_range
  */
-int32_t xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
-				     uint32_t refclk_khz, uint32_t lane_rate_khz,
-				     struct xilinx_xcvr_cpll_config *conf, uint32_t *out_div)
+static int32_t xilinx_xcvr_cpll_vco_range(struct xilinx_xcvr *xcvr,
+		uint32_t *vco_min, uint32_t *vco_max)
 {
-	uint32_t n1, n2, d, m;
-	uint32_t vco_freq;
-	uint32_t vco_min;
-	uint32_t vco_max;
+	switch (xcvr->type) {
+	case XILINX_XCVR_TYPE_S7_GTX2:
+		*vco_min = 1600000;
+		*vco_max = 3300000;
+		break;
+	case XILINX_XCVR_TYPE_US_GTH3:
+	case XILINX_XCVR_TYPE_US_GTH4:
+	case XILINX_XCVR_TYPE_US_GTY4:
+		*vco_min = 2000000;
+		*vco_max = 6250000;
+		break;
+	default:
+		return FAILURE;
+	}
+
+	if (AXI_PCORE_VER_MAJOR(xcvr->version) > 0x10)
+		xilinx_xcvr_setup_cpll_vco_range(xcvr, vco_max);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief xilinx_xcvr_qpll_vco_range
+ */
+static int32_t xilinx_xcvr_qpll_vco_range(struct xilinx_xcvr *xcvr,
+		const uint8_t **N,
+		uint32_t *vco0_min,
+		uint32_t *vco0_max,
+		uint32_t *vco1_min,
+		uint32_t *vco1_max)
+{
+	static const uint8_t N_gtx2[] = {16, 20, 32, 40, 64, 66, 80, 100, 0};
+	static const uint8_t N_gth34[] = {16, 20, 32, 40, 64, 66, 75, 80, 100,
+					  112, 120, 125, 150, 160, 0
+					 };
 
 	switch (xcvr->type) {
 	case XILINX_XCVR_TYPE_S7_GTX2:
-		vco_min = 1600000;
-		vco_max = 3300000;
+		*N = N_gtx2;
+		*vco0_min = 5930000;
+		*vco0_max = 8000000;
+		*vco1_min = 9800000;
+		*vco1_max = 12500000;
 		break;
 	case XILINX_XCVR_TYPE_US_GTH3:
 	case XILINX_XCVR_TYPE_US_GTH4:
 	case XILINX_XCVR_TYPE_US_GTY4:
-		vco_min = 2000000;
-		vco_max = 6250000;
+		*N = N_gth34;
+		*vco0_min = 9800000;
+		*vco0_max = 16375000;
+		*vco1_min = *vco0_min;
+		*vco1_max = *vco0_max;
 		break;
 	default:
 		return FAILURE;
 	}
 
 	if (AXI_PCORE_VER_MAJOR(xcvr->version) > 0x10)
-		xilinx_xcvr_setup_cpll_vco_range(xcvr, &vco_max);
+		xilinx_xcvr_setup_qpll_vco_range(xcvr,
+						 vco0_min, vco0_max,
+						 vco1_min, vco1_max);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief xilinx_xcvr_pll_better
+ */
+static bool xilinx_xcvr_pll_better(const struct xilinx_xcvr_pll_solution *a,
+				   const struct xilinx_xcvr_pll_solution *b)
+{
+	/* Rank by VCO margin, then by PFD frequency for a lower jitter */
+	return a->vco_margin_khz > b->vco_margin_khz ||
+	       (a->vco_margin_khz == b->vco_margin_khz &&
+		a->pfd_khz > b->pfd_khz);
+}
+
+/**
+ * @brief xilinx_xcvr_pll_plan_add
+ */
+static void xilinx_xcvr_pll_plan_add(struct xilinx_xcvr_pll_plan *plan,
+				     struct xilinx_xcvr_pll_solution *sol,
+				     uint32_t vco_min, uint32_t vco_max)
+{
+	uint32_t i, slot;
+
+	sol->vco_margin_khz = min(sol->vco_khz - vco_min, vco_max - sol->vco_khz);
+	plan->nb_found++;
+
+	if (plan->nb_solutions < XILINX_XCVR_PLL_MAX_SOLUTIONS) {
+		slot = plan->nb_solutions++;
+	} else {
+		/*
+		 * Keep solution 0, which the driver uses, and replace the lowest
+		 * ranked of the others. That one is never the best unless all of
+		 * them rank the same, in which case sol becomes the best below.
+		 */
+		slot = 1;
+		for (i = 2; i < XILINX_XCVR_PLL_MAX_SOLUTIONS; i++)
+			if (xilinx_xcvr_pll_better(&plan->solutions[slot],
+						   &plan->solutions[i]))
+				slot = i;
+
+		if (!xilinx_xcvr_pll_better(sol, &plan->solutions[slot]))
+			return;
+	}
+
+	plan->solutions[slot] = *sol;
+
+	if (slot && xilinx_xcvr_pll_better(sol, &plan->solutions[plan->best]))
+		plan->best = slot;
+}
+
+/**
+ * @brief xilinx_xcvr_get_cpll_plan
+ */
+int32_t xilinx_xcvr_get_cpll_plan(struct xilinx_xcvr *xcvr,
+				  uint32_t refclk_khz, uint32_t lane_rate_khz,
+				  const struct xilinx_xcvr_pll_plan **plan)
+{
+	struct xilinx_xcvr_pll_plan *p = &xcvr->cpll_plan;
+	struct xilinx_xcvr_pll_solution sol = {0};
+	uint32_t n1, n2, d, m;
+	uint32_t vco_min;
+	uint32_t vco_max;
+
+	*plan = p;
+
+	if (p->valid && p->refclk_khz == refclk_khz &&
+	    p->lane_rate_khz == lane_rate_khz)
+		return p->nb_solutions ? SUCCESS : FAILURE;
+
+	p->valid = false;
+	p->nb_found = 0;
+	p->nb_solutions = 0;
+	p->best = 0;
+
+	if (xilinx_xcvr_cpll_vco_range(xcvr, &vco_min, &vco_max) < 0)
+		return FAILURE;
 
 	for (m = 1; m <= 2; m++) {
 		for (d = 1; d <= 8; d <<= 1) {
 			for (n1 = 5; n1 >= 4; n1--) {
 				for (n2 = 5; n2 >= 1; n2--) {
-					vco_freq = refclk_khz * n1 * n2 / m;
+					sol.vco_khz = refclk_khz * n1 * n2 / m;
 
-					if (vco_freq > vco_max || vco_freq < vco_min)
+					if (sol.vco_khz > vco_max || sol.vco_khz < vco_min)
 						continue;
 
-					if (refclk_khz / m / d == lane_rate_khz / (2 * n1 * n2)) {
-						if (conf) {
-							conf->refclk_div = m;
-							conf->fb_div_N1 = n1;
-							conf->fb_div_N2 = n2;
-						}
-
-						if (out_div)
-							*out_div = d;
+					if (refclk_khz / m / d != lane_rate_khz / (2 * n1 * n2))
+						continue;
 
-						return SUCCESS;
-					}
+					sol.cpll.refclk_div = m;
+					sol.cpll.fb_div_N1 = n1;
+					sol.cpll.fb_div_N2 = n2;
+					sol.out_div = d;
+					sol.pfd_khz = refclk_khz / m;
+					xilinx_xcvr_pll_plan_add(p, &sol, vco_min, vco_max);
 				}
 			}
 		}
 	}
 
-	return FAILURE;
+	p->refclk_khz = refclk_khz;
+	p->lane_rate_khz = lane_rate_khz;
+	p->valid = true;
+
+	return p->nb_solutions ? SUCCESS : FAILURE;
 }
 
 /**
- * @brief xilinx_xcvr_calc_qpll_config
+ * @brief xilinx_xcvr_calc_cpll_config
  */
-int32_t xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr,
+int32_t xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
 				     uint32_t refclk_khz, uint32_t lane_rate_khz,
-				     struct xilinx_xcvr_qpll_config *conf, uint32_t *out_div)
+				     struct xilinx_xcvr_cpll_config *conf, uint32_t *out_div)
 {
+	const struct xilinx_xcvr_pll_plan *plan;
+	int32_t ret;
+
+	ret = xilinx_xcvr_get_cpll_plan(xcvr, refclk_khz, lane_rate_khz, &plan);
+	if (ret < 0)
+		return ret;
+
+	if (conf)
+		*conf = plan->solutions[0].cpll;
+
+	if (out_div)
+		*out_div = plan->solutions[0].out_div;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief xilinx_xcvr_get_qpll_plan
+ */
+int32_t xilinx_xcvr_get_qpll_plan(struct xilinx_xcvr *xcvr,
+				  uint32_t refclk_khz, uint32_t lane_rate_khz,
+				  const struct xilinx_xcvr_pll_plan **plan)
+{
+	struct xilinx_xcvr_pll_plan *p = &xcvr->qpll_plan;
+	struct xilinx_xcvr_pll_solution sol = {0};
 	uint32_t n, d, m;
-	uint32_t vco_freq;
-	uint32_t band;
 	uint32_t vco0_min;
 	uint32_t vco0_max;
 	uint32_t vco1_min;
 	uint32_t vco1_max;
 	const uint8_t *N;
 
-	static const uint8_t N_gtx2[] = {16, 20, 32, 40, 64, 66, 80, 100, 0};
-	static const uint8_t N_gth34[] = {16, 20, 32, 40, 64, 66, 75, 80, 100,
-					  112, 120, 125, 150, 160, 0
-					 };
+	*plan = p;
 
-	switch (xcvr->type) {
-	case XILINX_XCVR_TYPE_S7_GTX2:
-		N = N_gtx2;
-		vco0_min = 5930000;
-		vco0_max = 8000000;
-		vco1_min = 9800000;
-		vco1_max = 12500000;
-		break;
-	case XILINX_XCVR_TYPE_US_GTH3:
-	case XILINX_XCVR_TYPE_US_GTH4:
-	case XILINX_XCVR_TYPE_US_GTY4:
-		N = N_gth34;
-		vco0_min = 9800000;
-		vco0_max = 16375000;
-		vco1_min = vco0_min;
-		vco1_max = vco0_max;
-		break;
-	default:
-		return FAILURE;
-	}
+	if (p->valid && p->refclk_khz == refclk_khz &&
+	    p->lane_rate_khz == lane_rate_khz)
+		return p->nb_solutions ? SUCCESS : FAILURE;
 
-	if (AXI_PCORE_VER_MAJOR(xcvr->version) > 0x10)
-		xilinx_xcvr_setup_qpll_vco_range(xcvr,
-						 &vco0_min, &vco0_max,
-						 &vco1_min, &vco1_max);
+	p->valid = false;
+	p->nb_found = 0;
+	p->nb_solutions = 0;
+	p->best = 0;
+
+	if (xilinx_xcvr_qpll_vco_range(xcvr, &N, &vco0_min, &vco0_max,
+				       &vco1_min, &vco1_max) < 0)
+		return FAILURE;
 
 	for (m = 1; m <= 4; m++) {
 		for (d = 1; d <= 16; d <<= 1) {
 			for (n = 0; N[n] != 0; n++) {
-				vco_freq = refclk_khz * N[n] / m;
+				sol.vco_khz = refclk_khz * N[n] / m;
 
 				/*
 				 * high band = 9.8G to 12.5GHz VCO
 				 * low band = 5.93G to 8.0GHz VCO
 				 */
-				if (vco_freq >= vco1_min && vco_freq <= vco1_max)
-					band = 1;
-				else if (vco_freq >= vco0_min && vco_freq <= vco0_max)
-					band = 0;
+				if (sol.vco_khz >= vco1_min && sol.vco_khz <= vco1_max)
+					sol.qpll.band = 1;
+				else if (sol.vco_khz >= vco0_min && sol.vco_khz <= vco0_max)
+					sol.qpll.band = 0;
 				else
 					continue;
 
-				if (refclk_khz / m / d == lane_rate_khz / N[n]) {
-
-					if (conf) {
-						conf->refclk_div = m;
-						conf->fb_div = N[n];
-						conf->band = band;
-					}
-
-					if (out_div)
-						*out_div = d;
+				if (refclk_khz / m / d != lane_rate_khz / N[n])
+					continue;
 
-					return SUCCESS;
-				}
+				sol.qpll.refclk_div = m;
+				sol.qpll.fb_div = N[n];
+				sol.out_div = d;
+				sol.pfd_khz = refclk_khz / m;
+				if (sol.qpll.band)
+					xilinx_xcvr_pll_plan_add(p, &sol, vco1_min, vco1_max);
+				else
+					xilinx_xcvr_pll_plan_add(p, &sol, vco0_min, vco0_max);
 			}
 		}
 	}
 
-	return FAILURE;
+	p->refclk_khz = refclk_khz;
+	p->lane_rate_khz = lane_rate_khz;
+	p->valid = true;
+
+	return p->nb_solutions ? SUCCESS : FAILURE;
+}
+
+/**
+ * @brief xilinx_xcvr_calc_qpll_config
+ */
+int32_t xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr,
+				     uint32_t refclk_khz, uint32_t lane_rate_khz,
+				     struct xilinx_xcvr_qpll_config *conf, uint32_t *out_div)
+{
+	const struct xilinx_xcvr_pll_plan *plan;
+	int32_t ret;
+
+	ret = xilinx_xcvr_get_qpll_plan(xcvr, refclk_khz, lane_rate_khz, &plan);
+	if (ret < 0)
+		return ret;
+
+	if (conf)
+		*conf = plan->solutions[0].qpll;
+
+	if (out_div)
+		*out_div = plan->solutions[0].out_div;
+
+	return SUCCESS;
 }
 
 /**
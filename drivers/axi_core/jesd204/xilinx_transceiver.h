@@ -137,6 +137,49 @@ enum axi_fpga_dev_pack {
 	AXI_FPGA_DEV_FA,
 };
 
+struct xilinx_xcvr_cpll_config {
+	uint32_t refclk_div;
+	uint32_t fb_div_N1;
+	uint32_t fb_div_N2;
+};
+
+struct xilinx_xcvr_qpll_config {
+	uint32_t refclk_div;
+	uint32_t fb_div;
+	uint32_t band;
+};
+
+#define XILINX_XCVR_PLL_MAX_SOLUTIONS	16
+
+/* PLL settings for a lane rate, VCO frequencies in kHz */
+struct xilinx_xcvr_pll_solution {
+	struct xilinx_xcvr_cpll_config cpll;
+	struct xilinx_xcvr_qpll_config qpll;
+	uint32_t out_div;
+	uint32_t vco_khz;
+	uint32_t pfd_khz;
+	/* Distance of the VCO frequency to the closest edge of its range */
+	uint32_t vco_margin_khz;
+};
+
+/*
+ * Valid PLL settings for a reference clock and lane rate, in the order of
+ * the search. Solution 0 is the one used by the driver, best has the largest
+ * VCO margin and then the highest PFD frequency. When more than
+ * XILINX_XCVR_PLL_MAX_SOLUTIONS settings are found, solution 0 and the
+ * highest ranked others are kept, so best is never lost.
+ */
+struct xilinx_xcvr_pll_plan {
+	bool valid;
+	uint32_t refclk_khz;
+	uint32_t lane_rate_khz;
+	/* Valid settings found, nb_solutions of them are kept */
+	uint32_t nb_found;
+	uint32_t nb_solutions;
+	uint32_t best;
+	struct xilinx_xcvr_pll_solution solutions[XILINX_XCVR_PLL_MAX_SOLUTIONS];
+};
+
 struct xilinx_xcvr {
 	enum xilinx_xcvr_type type;
 	enum xilinx_xcvr_refclk_ppm refclk_ppm;
@@ -148,18 +191,9 @@ struct xilinx_xcvr {
 	enum axi_fpga_speed_grade speed_grade;
 	enum axi_fpga_dev_pack dev_package;
 	uint32_t voltage;
-};
-
-struct xilinx_xcvr_cpll_config {
-	uint32_t refclk_div;
-	uint32_t fb_div_N1;
-	uint32_t fb_div_N2;
-};
-
-struct xilinx_xcvr_qpll_config {
-	uint32_t refclk_div;
-	uint32_t fb_div;
-	uint32_t band;
+	/* Solver results of the last lane rate */
+	struct xilinx_xcvr_pll_plan cpll_plan;
+	struct xilinx_xcvr_pll_plan qpll_plan;
 };
 
 #define ENC_8B10B		810
@@ -175,6 +209,9 @@ int32_t xilinx_xcvr_configure_lpm_dfe_mode(struct xilinx_xcvr *xcvr,
 int32_t xilinx_xcvr_calc_cpll_config(struct xilinx_xcvr *xcvr,
 				     uint32_t refclk_hz, uint32_t lane_rate_khz,
 				     struct xilinx_xcvr_cpll_config *conf, uint32_t *out_div);
+int32_t xilinx_xcvr_get_cpll_plan(struct xilinx_xcvr *xcvr,
+				  uint32_t refclk_khz, uint32_t lane_rate_khz,
+				  const struct xilinx_xcvr_pll_plan **plan);
 int32_t xilinx_xcvr_cpll_read_config(struct xilinx_xcvr *xcvr,
 				     uint32_t drp_port, struct xilinx_xcvr_cpll_config *conf);
 int32_t xilinx_xcvr_cpll_write_config(struct xilinx_xcvr *xcvr,
@@ -185,6 +222,9 @@ int32_t xilinx_xcvr_cpll_calc_lane_rate(struct xilinx_xcvr *xcvr,
 int32_t xilinx_xcvr_calc_qpll_config(struct xilinx_xcvr *xcvr,
 				     uint32_t refclk_khz, uint32_t lane_rate_khz,
 				     struct xilinx_xcvr_qpll_config *conf, uint32_t *out_div);
+int32_t xilinx_xcvr_get_qpll_plan(struct xilinx_xcvr *xcvr,
+				  uint32_t refclk_khz, uint32_t lane_rate_khz,
+				  const struct xilinx_xcvr_pll_plan **plan);
 int32_t xilinx_xcvr_qpll_read_config(struct xilinx_xcvr *xcvr,
 				     uint32_t drp_port, struct xilinx_xcvr_qpll_config *conf);
 int32_t xilinx_xcvr_qpll_write_config(struct xilinx_xcvr *xcvr,
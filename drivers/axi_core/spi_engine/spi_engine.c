@@ -49,11 +49,12 @@ significant delays */
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <sleep.h>
+#include <string.h>
 #include <inttypes.h>
 
 #include "axi_dmac.h"
 #include "axi_io.h"
+#include "delay.h"
 #include "error.h"
 #include "spi_engine.h"
 
@@ -366,23 +367,21 @@ static int32_t spi_engine_write_cmd_reg(struct spi_engine_desc *desc,
 }
 
 /**
- * @brief Write a transfer command to the SPI engine's command fifo
+ * @brief Encode a transfer command
  *
  * @param desc Decriptor containing SPI Engine's parameters
  * @param read_write Read/Write operation flag
  * @param bytes_number Number of bytes to transfer
- * @return int32_t This function allways returns SUCCESS
+ * @return uint32_t The engine instruction
  */
-static int32_t spi_engine_transfer(struct spi_engine_desc *desc,
-				   uint8_t read_write,
-				   uint8_t bytes_number)
+static uint32_t spi_engine_transfer(struct spi_engine_desc *desc,
+				    uint8_t read_write,
+				    uint8_t bytes_number)
 {
 	uint8_t words_number;
 
 	words_number = spi_get_words_number(desc, bytes_number);
 
-	desc->offload_tx_len += words_number;
-
 	/*
 	 * Engine Wiki:
 	 *
@@ -391,24 +390,21 @@ static int32_t spi_engine_transfer(struct spi_engine_desc *desc,
 	 * The words number is zero based
 	 */
 
-	spi_engine_write_cmd_reg(desc,
-				 SPI_ENGINE_CMD_TRANSFER(read_write,
-						 words_number  - 1));
-
-	return SUCCESS;
+	return SPI_ENGINE_CMD_TRANSFER(read_write, words_number - 1);
 }
 
 /**
- * @brief Change the state of the chip select port
+ * @brief Encode a change of the state of the chip select port
  *
  * @param desc Decriptor containing SPI interface parameters
  * @param assert Chip select state.
  * 		 The supported values are :
  * 			-true (HIGH)
  * 			-false (LOW)
+ * @return uint32_t The engine instruction
  */
-static void spi_engine_set_cs(struct spi_desc *desc,
-			      bool assert)
+static uint32_t spi_engine_set_cs(struct spi_desc *desc,
+				  bool assert)
 {
 	uint8_t			mask;
 	struct spi_engine_desc	*eng_desc;
@@ -420,40 +416,39 @@ static void spi_engine_set_cs(struct spi_desc *desc,
 	if (!assert)
 		mask ^= BIT(desc->chip_select);
 
-	spi_engine_write_cmd_reg(eng_desc,
-				 SPI_ENGINE_CMD_ASSERT(eng_desc->cs_delay,
-						 mask));
+	return SPI_ENGINE_CMD_ASSERT(eng_desc->cs_delay, mask);
 }
 
 /**
- * @brief Add a delay bewtheen the engine commands
+ * @brief Encode a delay bewtheen the engine commands
  *
  * @param desc Decriptor containing SPI interface parameters
  * @param sleep_time_ns Number of nanoseconds to sleep between commands
+ * @return uint32_t The engine instruction
  */
-static void spi_gen_sleep_ns(struct spi_desc *desc,
-			     uint32_t sleep_time_ns)
+static uint32_t spi_gen_sleep_ns(struct spi_desc *desc,
+				 uint32_t sleep_time_ns)
 {
 	uint32_t 		sleep_div;
-	struct spi_engine_desc	*eng_desc;
-
-	eng_desc = desc->extra;
 
 	spi_get_sleep_div(desc, sleep_time_ns, &sleep_div);
 
-	spi_engine_write_cmd_reg(eng_desc, SPI_ENGINE_CMD_SLEEP(sleep_div));
+	return SPI_ENGINE_CMD_SLEEP(sleep_div);
 }
 
 /**
  * @brief Spi engine command interpreter
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param cmd Command to send to the engine
- * @return int32_t - SUCCESS if the command is transfered
+ * @param cmd Command to translate
+ * @param inst The engine instruction matching the command
+ * @return int32_t - 1 if the command was translated to an instruction
+ *		   - 0 if the command has no effect
  *		   - FAILURE if the command format is invalid
  */
-static int32_t spi_engine_write_cmd(struct spi_desc *desc,
-				    uint32_t cmd)
+static int32_t spi_engine_compile_cmd(struct spi_desc *desc,
+				      uint32_t cmd,
+				      uint32_t *inst)
 {
 	uint8_t				engine_command;
 	uint8_t				parameter;
@@ -468,16 +463,18 @@ static int32_t spi_engine_write_cmd(struct spi_desc *desc,
 
 	switch(engine_command) {
 	case SPI_ENGINE_INST_TRANSFER:
-		spi_engine_transfer(desc_extra, modifier, parameter);
+		*inst = spi_engine_transfer(desc_extra, modifier, parameter);
 		break;
 
 	case SPI_ENGINE_INST_ASSERT:
 		if(parameter == 0xFF) {
 			/* Set the CS HIGH */
-			spi_engine_set_cs(desc, true);
+			*inst = spi_engine_set_cs(desc, true);
 		} else if(parameter == 0x00) {
 			/* Set the CS LOW */
-			spi_engine_set_cs(desc, false);
+			*inst = spi_engine_set_cs(desc, false);
+		} else {
+			return 0;
 		}
 		break;
 
@@ -486,13 +483,15 @@ static int32_t spi_engine_write_cmd(struct spi_desc *desc,
 	case SPI_ENGINE_INST_SYNC_SLEEP:
 		/* SYNC instruction */
 		if(modifier == 0x00) {
-			spi_engine_write_cmd_reg(desc_extra, cmd);
+			*inst = cmd;
 		} else if(modifier == 0x01) {
-			spi_gen_sleep_ns(desc, parameter);
+			*inst = spi_gen_sleep_ns(desc, parameter);
+		} else {
+			return 0;
 		}
 		break;
 	case SPI_ENGINE_INST_CONFIG:
-		spi_engine_write_cmd_reg(desc_extra, cmd);
+		*inst = cmd;
 
 		break;
 
@@ -502,7 +501,48 @@ static int32_t spi_engine_write_cmd(struct spi_desc *desc,
 		break;
 	}
 
-	return SUCCESS;
+	return 1;
+}
+
+/**
+ * @brief Get the number of words moved by an engine instruction
+ *
+ * @param inst The engine instruction
+ * @return uint8_t Number of words, 0 for instructions other than transfers
+ */
+static uint8_t spi_engine_inst_words(uint32_t inst)
+{
+	if (((inst >> 12) & 0x0F) != SPI_ENGINE_INST_TRANSFER)
+		return 0;
+
+	/* The words number is zero based */
+	return (inst & 0xFF) + 1;
+}
+
+/**
+ * @brief Write a command to the SPI engine
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param cmd Command to send to the engine
+ * @return int32_t - SUCCESS if the command is transfered
+ *		   - FAILURE if the command format is invalid
+ */
+static int32_t spi_engine_write_cmd(struct spi_desc *desc,
+				    uint32_t cmd)
+{
+	struct spi_engine_desc		*desc_extra;
+	uint32_t			inst;
+	int32_t				ret;
+
+	desc_extra = desc->extra;
+
+	ret = spi_engine_compile_cmd(desc, cmd, &inst);
+	if (ret != 1)
+		return ret;
+
+	desc_extra->offload_tx_len += spi_engine_inst_words(inst);
+
+	return spi_engine_write_cmd_reg(desc_extra, inst);
 }
 
 /**
@@ -598,6 +638,9 @@ static int32_t spi_engine_transfer_message(struct spi_desc *desc,
 		/* Wait for the end sync signal */
 		while(sync_id != _sync_id);
 		_sync_id++;
+		/* Leave the ID of the offload programs out */
+		if (_sync_id == SPI_ENGINE_OFFLOAD_SYNC_ID)
+			_sync_id++;
 
 		/* Read a number of rx_length WORDS from the SDI line and store
 		them */
@@ -651,6 +694,9 @@ int32_t spi_engine_init(struct spi_desc **desc,
 	(*desc)->extra = eng_desc;
 
 	eng_desc->offload_config = OFFLOAD_DISABLED;
+	eng_desc->offload_tx_dma = NULL;
+	eng_desc->offload_rx_dma = NULL;
+	eng_desc->offload_session = NULL;
 	eng_desc->spi_engine_baseaddr = spi_engine_init->spi_engine_baseaddr;
 	eng_desc->type = spi_engine_init->type;
 	eng_desc->cs_delay = spi_engine_init->cs_delay;
@@ -660,7 +706,7 @@ int32_t spi_engine_init(struct spi_desc **desc,
 
 	/* Perform a reset */
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_RESET, 0x01);
-	usleep(1000);
+	mdelay(1);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_RESET, 0x00);
 
 	/* Get current data width */
@@ -771,6 +817,16 @@ int32_t spi_engine_offload_init(struct spi_desc *desc,
 	else
 		dma_flags = *(param->dma_flags);
 
+	/* Release the DMACs of a previous call */
+	if (eng_desc->offload_tx_dma) {
+		axi_dmac_remove(eng_desc->offload_tx_dma);
+		eng_desc->offload_tx_dma = NULL;
+	}
+	if (eng_desc->offload_rx_dma) {
+		axi_dmac_remove(eng_desc->offload_rx_dma);
+		eng_desc->offload_rx_dma = NULL;
+	}
+
 	if(param->offload_config & OFFLOAD_TX_EN) {
 		dmac_init.name = "DAC DMAC";
 		dmac_init.base = param->tx_dma_baseaddr;
@@ -819,6 +875,7 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 1);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 0);
+	eng_desc->offload_session = NULL;
 
 	eng_desc->offload_tx_len = 0;
 	eng_desc->offload_rx_len = 0;
@@ -859,13 +916,692 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 				  no_samples);
 	}
 
-	usleep(1000);
+	mdelay(1);
 
 	spi_engine_queue_free(&transfer.cmds);
 
 	return SUCCESS;
 }
 
+/**
+ * @brief Compile an offload message for the current engine configuration
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message, only the commands and their data are used
+ * @param prog The compiled program
+ * @return int32_t - SUCCESS if the message was compiled
+ *		   - -EINVAL if the message is invalid or does not fit in the
+ *		     offload memory
+ */
+static int32_t spi_engine_offload_compile(struct spi_desc *desc,
+		const struct spi_engine_offload_message *msg,
+		struct spi_engine_offload_program *prog)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		inst;
+	uint32_t		words;
+	uint32_t		i;
+	int32_t			ret;
+
+	eng_desc = desc->extra;
+
+	/* The programs are compared as a whole */
+	memset(prog, 0, sizeof(*prog));
+
+	/* Same configuration, in the same order, as the one that
+	spi_engine_compile_message() puts in front of the queue */
+	prog->cmds[prog->no_cmds++] = SPI_ENGINE_CMD_CONFIG(
+					      SPI_ENGINE_CMD_REG_CONFIG,
+					      desc->mode);
+	prog->cmds[prog->no_cmds++] = SPI_ENGINE_CMD_CONFIG(
+					      SPI_ENGINE_CMD_DATA_TRANSFER_LEN,
+					      eng_desc->data_width);
+	prog->cmds[prog->no_cmds++] = SPI_ENGINE_CMD_CONFIG(
+					      SPI_ENGINE_CMD_REG_CLK_DIV,
+					      eng_desc->clk_div);
+
+	words = 0;
+	for (i = 0; i < msg->no_commands; i++) {
+		ret = spi_engine_compile_cmd(desc, msg->commands[i], &inst);
+		if (ret < 0)
+			return -EINVAL;
+		if (!ret)
+			continue;
+
+		/* Keep room for the SYNC instruction */
+		if (prog->no_cmds == SPI_ENGINE_OFFLOAD_CMD_MAX - 1)
+			return -EINVAL;
+
+		prog->cmds[prog->no_cmds++] = inst;
+		words += spi_engine_inst_words(inst);
+	}
+
+	prog->cmds[prog->no_cmds++] =
+		SPI_ENGINE_CMD_SYNC(SPI_ENGINE_OFFLOAD_SYNC_ID);
+
+	if (msg->commands_data) {
+		if (words > SPI_ENGINE_OFFLOAD_SDO_MAX)
+			return -EINVAL;
+
+		memcpy(prog->sdo, msg->commands_data,
+		       words * sizeof(prog->sdo[0]));
+		prog->no_sdo = words;
+	}
+
+	prog->sample_bytes = words * spi_get_word_lenght(eng_desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Allocate the DMACs used by an offload session
+ *
+ * The captures of a session are one shot and complete when the DMA is done,
+ * DMA_CYCLIC is ignored if it is set in the DMAC flags.
+ *
+ * @param session The offload session
+ * @param desc Decriptor containing SPI interface parameters
+ * @param param Structure containing the offload init parameters
+ * @return int32_t - SUCCESS if the session was created
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_session_init(struct spi_engine_session **session,
+				struct spi_desc *desc,
+				const struct spi_engine_offload_init_param *param)
+{
+	struct spi_engine_session	*offload;
+	struct axi_dmac_init		dmac_init;
+	int32_t				ret;
+
+	if (!session || !desc || !param)
+		return -EINVAL;
+
+	if (!(param->offload_config & (OFFLOAD_TX_EN | OFFLOAD_RX_EN)))
+		return -EINVAL;
+
+	offload = (struct spi_engine_session *)calloc(1, sizeof(*offload));
+	if (!offload)
+		return -ENOMEM;
+
+	offload->spi_desc = desc;
+	offload->offload_config = param->offload_config;
+
+	dmac_init.flags = param->dma_flags ? *param->dma_flags : 0;
+	dmac_init.flags &= ~DMA_CYCLIC;
+
+	if (param->offload_config & OFFLOAD_TX_EN) {
+		dmac_init.name = "DAC DMAC";
+		dmac_init.base = param->tx_dma_baseaddr;
+		dmac_init.direction = DMA_MEM_TO_DEV;
+		ret = axi_dmac_init(&offload->tx_dma, &dmac_init);
+		if (ret != SUCCESS)
+			goto error;
+	}
+	if (param->offload_config & OFFLOAD_RX_EN) {
+		dmac_init.name = "ADC DMAC";
+		dmac_init.base = param->rx_dma_baseaddr;
+		dmac_init.direction = DMA_DEV_TO_MEM;
+		ret = axi_dmac_init(&offload->rx_dma, &dmac_init);
+		if (ret != SUCCESS)
+			goto error;
+	}
+
+	*session = offload;
+
+	return SUCCESS;
+
+error:
+	if (offload->tx_dma)
+		axi_dmac_remove(offload->tx_dma);
+	free(offload);
+
+	return ret;
+}
+
+/**
+ * @brief Load the program of an offload message in the offload memory
+ *
+ * The message is compiled for the current SPI mode, speed and transfer width.
+ * The offload memory is only written when the result differs from the
+ * program that is already loaded, so a capture with the same message and
+ * configuration does not touch the SPI engine.
+ *
+ * @param session The offload session
+ * @param msg Offload message, only the commands and their data are used
+ * @return int32_t - SUCCESS if the program is loaded
+ *		   - -EBUSY if a capture is running on the engine
+ *		   - -EINVAL if the message is invalid
+ */
+int32_t spi_engine_session_load(struct spi_engine_session *session,
+				const struct spi_engine_offload_message *msg)
+{
+	struct spi_engine_offload_program	prog;
+	struct spi_engine_desc			*eng_desc;
+	uint32_t				i;
+	int32_t					ret;
+
+	if (!session || !msg || !msg->commands)
+		return -EINVAL;
+
+	eng_desc = session->spi_desc->extra;
+
+	if (eng_desc->offload_session && eng_desc->offload_session->armed)
+		return -EBUSY;
+
+	ret = spi_engine_offload_compile(session->spi_desc, msg, &prog);
+	if (ret != SUCCESS)
+		return ret;
+
+	if (eng_desc->offload_session == session &&
+	    !memcmp(&prog, &session->prog, sizeof(prog)))
+		return SUCCESS;
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 1);
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 0);
+
+	for (i = 0; i < prog.no_cmds; i++)
+		spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CMD_MEM(0),
+				 prog.cmds[i]);
+	for (i = 0; i < prog.no_sdo; i++)
+		spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_SDO_MEM(0),
+				 prog.sdo[i]);
+
+	session->prog = prog;
+	eng_desc->offload_session = session;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start a capture of no_samples executions of the loaded program
+ *
+ * The DMA transfers are queued before the offload is enabled, so the first
+ * trigger is not lost. The function returns right away, the capture is
+ * completed by spi_engine_session_wait().
+ *
+ * @param session The offload session
+ * @param rx_addr Address where the received data is written
+ * @param tx_addr Address of the transmitted data
+ * @param no_samples Number of times the program is executed
+ * @return int32_t - SUCCESS if the capture was started
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_session_arm(struct spi_engine_session *session,
+			       uint32_t rx_addr, uint32_t tx_addr,
+			       uint32_t no_samples)
+{
+	struct spi_engine_desc	*eng_desc;
+	uint32_t		bytes;
+	int32_t			ret;
+
+	if (!session)
+		return -EINVAL;
+
+	if (session->armed)
+		return -EBUSY;
+
+	eng_desc = session->spi_desc->extra;
+
+	/* The offload memory was written by someone else since the load */
+	if (eng_desc->offload_session != session)
+		return FAILURE;
+
+	bytes = session->prog.sample_bytes * no_samples;
+	if (!bytes)
+		return -EINVAL;
+
+	if (session->rx_dma) {
+		session->rx_desc = (struct axi_dmac_desc) {
+			.address = rx_addr,
+			.x_len = bytes
+		};
+		ret = axi_dmac_submit(session->rx_dma, &session->rx_desc);
+		if (ret != SUCCESS)
+			return ret;
+	}
+	if (session->tx_dma) {
+		session->tx_desc = (struct axi_dmac_desc) {
+			.address = tx_addr,
+			.x_len = bytes
+		};
+		ret = axi_dmac_submit(session->tx_dma, &session->tx_desc);
+		if (ret != SUCCESS) {
+			if (session->rx_dma)
+				axi_dmac_flush(session->rx_dma);
+			return ret;
+		}
+	}
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0),
+			 SPI_ENGINE_OFFLOAD_CTRL_ENABLE);
+	session->armed = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Wait for the capture started by spi_engine_session_arm()
+ *
+ * The capture is done when the RX DMA has written all the samples, or when
+ * the TX DMA has read all the data if RX is not enabled. The offload is then
+ * disabled so the trigger stops running the program.
+ *
+ * @param session The offload session
+ * @param timeout_us Maximum time to wait. 0 to wait forever
+ * @return int32_t - SUCCESS if the capture completed
+ *		   - -ETIMEDOUT if the capture was aborted after the timeout
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_session_wait(struct spi_engine_session *session,
+				uint32_t timeout_us)
+{
+	struct spi_engine_desc	*eng_desc;
+	int32_t			ret = SUCCESS;
+
+	if (!session || !session->armed || session->streaming)
+		return -EINVAL;
+
+	eng_desc = session->spi_desc->extra;
+
+	if (session->rx_dma)
+		ret = axi_dmac_wait(session->rx_dma, &session->rx_desc,
+				    timeout_us);
+	if (ret == SUCCESS && session->tx_dma)
+		ret = axi_dmac_wait(session->tx_dma, &session->tx_desc,
+				    timeout_us);
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+
+	if (ret != SUCCESS) {
+		if (session->rx_dma)
+			axi_dmac_flush(session->rx_dma);
+		if (session->tx_dma)
+			axi_dmac_flush(session->tx_dma);
+	}
+
+	session->armed = false;
+
+	return ret;
+}
+
+/**
+ * @brief Load an offload message and capture no_samples executions of it
+ *
+ * @param session The offload session
+ * @param msg Offload message
+ * @param no_samples Number of times the message is transferred
+ * @return int32_t - SUCCESS if the capture completed
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_session_transfer(struct spi_engine_session *session,
+				    const struct spi_engine_offload_message *msg,
+				    uint32_t no_samples)
+{
+	int32_t ret;
+
+	ret = spi_engine_session_load(session, msg);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = spi_engine_session_arm(session, msg->rx_addr, msg->tx_addr,
+				     no_samples);
+	if (ret != SUCCESS)
+		return ret;
+
+	return spi_engine_session_wait(session, 0);
+}
+
+/**
+ * @brief Record that samples were lost after the data committed so far
+ * @param stream The stream
+ */
+static void spi_engine_stream_gap(struct spi_engine_stream *stream)
+{
+	uint32_t last, idx;
+
+	/* Both the DMAC and the ring ran out of periods at this position */
+	last = (stream->first_gap + stream->no_gaps - 1) %
+	       ARRAY_SIZE(stream->gaps);
+	if (stream->no_gaps && stream->gaps[last] == stream->write_bytes)
+		return;
+
+	stream->no_overruns++;
+	if (stream->no_gaps < ARRAY_SIZE(stream->gaps)) {
+		idx = (stream->first_gap + stream->no_gaps) %
+		      ARRAY_SIZE(stream->gaps);
+		stream->gaps[idx] = stream->write_bytes;
+		stream->no_gaps++;
+	}
+}
+
+/**
+ * @brief Start capturing continuously in a ring buffer
+ *
+ * The loaded program runs on each trigger until spi_engine_stream_stop(),
+ * its data is written in the ring by the RX DMA. The ring is split in
+ * no_periods transfers which are all queued before the offload is enabled,
+ * so the DMA always has a transfer to run and no sample is lost between
+ * transfers as long as the application releases the data in time. A period
+ * is only queued again once its data was released, the DMA never writes
+ * over data the application did not read.
+ *
+ * @param session The offload session, with a program loaded
+ * @param param Ring buffer parameters
+ * @return int32_t - SUCCESS if the capture was started
+ *		   - -EBUSY if a capture is running
+ *		   - -EINVAL if the parameters are invalid or TX is enabled
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_stream_start(struct spi_engine_session *session,
+		const struct spi_engine_stream_init_param *param)
+{
+	struct spi_engine_stream	*stream;
+	struct spi_engine_desc		*eng_desc;
+	uint32_t			i;
+	int32_t				ret;
+
+	if (!session || !param || !param->buff || !param->period_samples)
+		return -EINVAL;
+
+	/* The SDO data of a stream comes from the offload SDO memory */
+	if (!session->rx_dma || session->tx_dma)
+		return -EINVAL;
+
+	if (param->no_periods < 2 ||
+	    param->no_periods > SPI_ENGINE_STREAM_PERIODS_MAX)
+		return -EINVAL;
+
+	if (session->armed)
+		return -EBUSY;
+
+	eng_desc = session->spi_desc->extra;
+	if (eng_desc->offload_session != session)
+		return FAILURE;
+
+	stream = &session->stream;
+	memset(stream, 0, sizeof(*stream));
+	stream->no_periods = param->no_periods;
+	stream->period_bytes = session->prog.sample_bytes *
+			       param->period_samples;
+
+	ret = cb_init_with_buff(&stream->cb, param->buff,
+				stream->period_bytes * stream->no_periods);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (i = 0; i < stream->no_periods; i++) {
+		stream->periods[i] = (struct axi_dmac_desc) {
+			.address = (uint32_t)(uintptr_t)param->buff +
+			i * stream->period_bytes,
+			.x_len = stream->period_bytes
+		};
+		ret = axi_dmac_submit(session->rx_dma, &stream->periods[i]);
+		if (ret != SUCCESS) {
+			axi_dmac_flush(session->rx_dma);
+			cb_remove(stream->cb);
+			stream->cb = NULL;
+			return ret;
+		}
+	}
+	stream->no_queued = stream->no_periods;
+	stream->dma_underruns = session->rx_dma->nb_underruns;
+
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0),
+			 SPI_ENGINE_OFFLOAD_CTRL_ENABLE);
+	session->armed = true;
+	session->streaming = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Add the periods written by the DMA to the circular buffer and queue
+ * the released ones again
+ *
+ * Each completed period is committed to the circular buffer. It is queued to
+ * the DMA again only when the application released all its data, so when
+ * the application holds the data of all the periods the DMA runs out of
+ * transfers and the samples of the triggers that come until a period is
+ * released are lost. The DMAC only holds AXI_DMAC_MAX_ACTIVE periods, the
+ * others wait in its software queue. When it is not polled before they are
+ * all done, the samples are lost as well until the next poll. The position
+ * of each loss is recorded and reported by the spi_engine_stream_read()
+ * reaching it.
+ *
+ * Called by spi_engine_stream_read() and spi_engine_stream_release(). Can be
+ * called more often to keep the DMA busy when the reads are far apart, but
+ * not concurrently with them, e.g. not from the DMA interrupt. The DMAC
+ * default ISR may be installed, it then keeps the DMA busy.
+ *
+ * @param session The offload session
+ * @return int32_t - SUCCESS if the DMA progress was handled
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_stream_poll(struct spi_engine_session *session)
+{
+	struct spi_engine_stream	*stream;
+	struct axi_dmac_desc		*period;
+	uint32_t			held, idx;
+	uint32_t			underruns;
+	int32_t				ret;
+
+	if (!session || !session->streaming)
+		return -EINVAL;
+
+	stream = &session->stream;
+	ret = axi_dmac_poll(session->rx_dma);
+	if (ret != SUCCESS)
+		return ret;
+	underruns = session->rx_dma->nb_underruns;
+
+	while (stream->no_queued) {
+		period = &stream->periods[stream->next_period];
+		if (period->status != AXI_DMAC_DESC_DONE)
+			break;
+
+		cb_commit_write(stream->cb, stream->period_bytes);
+		stream->write_bytes += stream->period_bytes;
+		stream->no_queued--;
+		stream->next_period = (stream->next_period + 1) %
+				      stream->no_periods;
+	}
+
+	/*
+	 * The DMAC completed all the periods it held while others were
+	 * waiting for it. They are started now, so the data was lost after
+	 * the periods that are done.
+	 */
+	if (underruns != stream->dma_underruns) {
+		stream->dma_underruns = underruns;
+		spi_engine_stream_gap(stream);
+	}
+
+	/* The DMA ran out of periods, the data is lost from here on */
+	if (!stream->no_queued && !stream->starved) {
+		stream->starved = true;
+		spi_engine_stream_gap(stream);
+	}
+
+	/*
+	 * Queue the periods whose data was released. The write position is
+	 * always at a period boundary, so the unread data, the slice held by
+	 * the application included, spans the periods right before
+	 * next_period.
+	 */
+	held = DIV_ROUND_UP(stream->write_bytes - stream->read_bytes,
+			    stream->period_bytes);
+	while (stream->no_queued + held < stream->no_periods) {
+		idx = (stream->next_period + stream->no_queued) %
+		      stream->no_periods;
+		ret = axi_dmac_submit(session->rx_dma, &stream->periods[idx]);
+		if (ret != SUCCESS)
+			return ret;
+
+		stream->no_queued++;
+		stream->starved = false;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get a slice of the captured data
+ *
+ * The slice is contiguous, so it may be shorter than the data available when
+ * the data wraps around the end of the ring or when samples were lost after
+ * it. It stays valid until spi_engine_stream_release(), its period is not
+ * written by the DMA meanwhile.
+ *
+ * @param session The offload session
+ * @param size Maximum size of the slice, in bytes
+ * @param buff Where to store the address of the slice
+ * @param avail Where to store the size of the slice
+ * @return int32_t - SUCCESS if a slice was returned
+ *		   - -EOVERRUN if data was lost right before the slice, a slice
+ *		   is returned too
+ *		   - -EAGAIN if no data is available yet
+ *		   - -EBUSY if the application holds a slice
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_stream_read(struct spi_engine_session *session,
+			       uint32_t size, void **buff, uint32_t *avail)
+{
+	struct spi_engine_stream	*stream;
+	uint32_t			next_gap;
+	bool				overrun;
+	int32_t				ret;
+
+	if (!buff || !avail)
+		return -EINVAL;
+
+	ret = spi_engine_stream_poll(session);
+	if (ret != SUCCESS)
+		return ret;
+
+	stream = &session->stream;
+	next_gap = stream->first_gap;
+	overrun = stream->no_gaps &&
+		  stream->gaps[next_gap] == stream->read_bytes;
+	if (overrun)
+		next_gap = (next_gap + 1) % ARRAY_SIZE(stream->gaps);
+
+	/* A slice does not span a loss */
+	if (stream->no_gaps > (overrun ? 1 : 0))
+		size = min(size, stream->gaps[next_gap] - stream->read_bytes);
+
+	ret = cb_prepare_async_read(stream->cb, size, buff, avail);
+	if (ret != SUCCESS)
+		return ret;
+
+	stream->slice_bytes = *avail;
+	if (overrun) {
+		stream->first_gap = next_gap;
+		stream->no_gaps--;
+		return -EOVERRUN;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Release the slice returned by spi_engine_stream_read()
+ *
+ * The periods the application read entirely are queued to the DMA again.
+ *
+ * @param session The offload session
+ * @return int32_t - SUCCESS if the slice was released
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_stream_release(struct spi_engine_session *session)
+{
+	struct spi_engine_stream	*stream;
+	int32_t				ret;
+
+	if (!session || !session->streaming || !session->stream.slice_bytes)
+		return -EINVAL;
+
+	stream = &session->stream;
+	ret = cb_end_async_read(stream->cb);
+	if (ret != SUCCESS)
+		return ret;
+
+	stream->read_bytes += stream->slice_bytes;
+	stream->slice_bytes = 0;
+
+	return spi_engine_stream_poll(session);
+}
+
+/**
+ * @brief Stop the continuous capture
+ *
+ * The offload is disabled and the queued periods are dropped. The data that
+ * was not read is lost.
+ *
+ * @param session The offload session
+ * @return int32_t - SUCCESS if the capture was stopped
+ *		   - -EINVAL if no stream is running
+ */
+int32_t spi_engine_stream_stop(struct spi_engine_session *session)
+{
+	struct spi_engine_desc *eng_desc;
+
+	if (!session || !session->streaming)
+		return -EINVAL;
+
+	eng_desc = session->spi_desc->extra;
+	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+	axi_dmac_flush(session->rx_dma);
+
+	cb_remove(session->stream.cb);
+	session->stream.cb = NULL;
+	session->stream.slice_bytes = 0;
+	session->streaming = false;
+	session->armed = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by spi_engine_session_init()
+ *
+ * Must be called before the SPI engine is removed.
+ *
+ * @param session The offload session
+ * @return int32_t - SUCCESS if the session was freed
+ *		   - FAILURE if the session is NULL
+ */
+int32_t spi_engine_session_remove(struct spi_engine_session *session)
+{
+	struct spi_engine_desc	*eng_desc;
+
+	if (!session)
+		return FAILURE;
+
+	eng_desc = session->spi_desc->extra;
+
+	if (session->streaming) {
+		spi_engine_stream_stop(session);
+	} else if (session->armed) {
+		spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0);
+		if (session->rx_dma)
+			axi_dmac_flush(session->rx_dma);
+		if (session->tx_dma)
+			axi_dmac_flush(session->tx_dma);
+	}
+
+	if (eng_desc->offload_session == session)
+		eng_desc->offload_session = NULL;
+
+	if (session->tx_dma)
+		axi_dmac_remove(session->tx_dma);
+	if (session->rx_dma)
+		axi_dmac_remove(session->rx_dma);
+	free(session);
+
+	return SUCCESS;
+}
+
 /**
  * @brief Free the resources allocated by spi_init().
  *
@@ -878,9 +1614,9 @@ int32_t spi_engine_remove(struct spi_desc *desc)
 
 	eng_desc = desc->extra;
 
-	if(eng_desc->offload_config & OFFLOAD_TX_EN)
+	if(eng_desc->offload_tx_dma)
 		axi_dmac_remove(eng_desc->offload_tx_dma);
-	if(eng_desc->offload_config & OFFLOAD_RX_EN)
+	if(eng_desc->offload_rx_dma)
 		axi_dmac_remove(eng_desc->offload_rx_dma);
 	free(desc->extra);
 	free(desc);
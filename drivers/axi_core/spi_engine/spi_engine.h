@@ -46,6 +46,8 @@
 
 #include <stdint.h>
 
+#include "axi_dmac.h"
+#include "circular_buffer.h"
 #include "spi_extra.h"
 #include "spi_engine_private.h"
 
@@ -60,6 +62,15 @@
 
 #define SPI_ENGINE_MSG_QUEUE_END	0xFFFFFFFF
 
+/* Size of the program of an offload session, in instructions */
+#define SPI_ENGINE_OFFLOAD_CMD_MAX	32
+/* Size of the data of an offload session, in words */
+#define SPI_ENGINE_OFFLOAD_SDO_MAX	32
+/* SYNC ID of the offload programs, never used by FIFO mode transfers */
+#define SPI_ENGINE_OFFLOAD_SYNC_ID	0x00
+/* Maximum number of DMA periods in the ring of a stream */
+#define SPI_ENGINE_STREAM_PERIODS_MAX	16
+
 /* Spi engine commands */
 #define	WRITE(no_bytes)			((SPI_ENGINE_INST_TRANSFER << 12) |\
 	(SPI_ENGINE_INSTRUCTION_TRANSFER_W << 8) | no_bytes)
@@ -99,6 +110,8 @@ struct spi_engine_init_param {
 };
 
 
+struct spi_engine_session;
+
 /**
  * @struct spi_engine_desc
  * @brief  Structure representing an SPI engine device
@@ -132,6 +145,8 @@ struct spi_engine_desc {
 	uint8_t			data_width;
 	/** The maximum data width supported by the engine */
 	uint8_t 		max_data_width;
+	/** Session whose program is in the offload memory, NULL if none */
+	struct spi_engine_session *offload_session;
 };
 
 
@@ -170,6 +185,108 @@ struct spi_engine_offload_message {
 	uint32_t rx_addr;
 };
 
+/**
+ * @struct spi_engine_offload_program
+ * @brief  Offload message compiled for the current engine configuration
+ */
+struct spi_engine_offload_program {
+	/** Instructions written in the offload command memory */
+	uint32_t	cmds[SPI_ENGINE_OFFLOAD_CMD_MAX];
+	/** Number of instructions */
+	uint32_t	no_cmds;
+	/** Words written in the offload SDO memory */
+	uint32_t	sdo[SPI_ENGINE_OFFLOAD_SDO_MAX];
+	/** Number of SDO words */
+	uint32_t	no_sdo;
+	/** Number of bytes moved by the DMA on each trigger */
+	uint32_t	sample_bytes;
+};
+
+/**
+ * @struct spi_engine_stream_init_param
+ * @brief  Ring buffer written by a continuous offload capture
+ */
+struct spi_engine_stream_init_param {
+	/** DMA capable memory of the ring, no_periods periods long */
+	uint8_t		*buff;
+	/** Number of DMA transfers the ring is split in, at least 2 */
+	uint32_t	no_periods;
+	/** Executions of the offload program in each period */
+	uint32_t	period_samples;
+};
+
+/**
+ * @struct spi_engine_stream
+ * @brief  Continuous capture state. The ring is split in periods that are
+ * queued to the RX DMAC back to back, a period is added to the circular
+ * buffer when its transfer completes and is queued again once all its data
+ * was released by the application.
+ */
+struct spi_engine_stream {
+	/** Circular buffer over the ring, read by the application */
+	struct circular_buffer	*cb;
+	/** One DMA descriptor per period */
+	struct axi_dmac_desc	periods[SPI_ENGINE_STREAM_PERIODS_MAX];
+	/** Number of periods in the ring */
+	uint32_t		no_periods;
+	/** Size of a period in bytes */
+	uint32_t		period_bytes;
+	/** Period the DMA completes next */
+	uint32_t		next_period;
+	/** Number of periods queued to the DMA */
+	uint32_t		no_queued;
+	/** Bytes added to the circular buffer since the stream was started */
+	uint32_t		write_bytes;
+	/** Bytes released by the application since the stream was started */
+	uint32_t		read_bytes;
+	/** Size of the slice returned by spi_engine_stream_read(), 0 if the
+	 * application does not hold one */
+	uint32_t		slice_bytes;
+	/** Positions in the data, counted as write_bytes, where the DMA ran
+	 * out of periods and samples were lost, oldest first. Each gap follows
+	 * at least one period, so the ring holds one more gap than periods. */
+	uint32_t		gaps[SPI_ENGINE_STREAM_PERIODS_MAX + 1];
+	/** Index of the oldest gap in gaps */
+	uint32_t		first_gap;
+	/** Number of gaps the application did not read past yet */
+	uint32_t		no_gaps;
+	/** The DMA ran out of periods and none was queued since */
+	bool			starved;
+	/** DMAC underrun count when the gaps were last updated */
+	uint32_t		dma_underruns;
+	/** Number of times data was lost since the stream was started */
+	uint32_t		no_overruns;
+};
+
+/**
+ * @struct spi_engine_session
+ * @brief  Offload session, the offload module state kept between captures.
+ * The program is loaded in the offload memory only when it changes and the
+ * DMACs are allocated once, so a capture only has to program the DMA address
+ * and length.
+ */
+struct spi_engine_session {
+	/** SPI engine running the offload */
+	struct spi_desc		*spi_desc;
+	/** DMAC reading the SDO data, NULL if TX is not enabled */
+	struct axi_dmac		*tx_dma;
+	/** DMAC writing the SDI data, NULL if RX is not enabled */
+	struct axi_dmac		*rx_dma;
+	/** Offload's module transfer direction : TX, RX or both */
+	uint8_t			offload_config;
+	/** Program loaded by the last spi_engine_session_load() */
+	struct spi_engine_offload_program prog;
+	/** DMA descriptors of the capture in progress */
+	struct axi_dmac_desc	tx_desc;
+	struct axi_dmac_desc	rx_desc;
+	/** A capture was started and was not waited for yet */
+	bool			armed;
+	/** The capture is a stream, see spi_engine_stream_start() */
+	bool			streaming;
+	/** Continuous capture state */
+	struct spi_engine_stream stream;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
@@ -209,6 +326,50 @@ int32_t spi_engine_offload_transfer(struct spi_desc *desc,
 				    struct spi_engine_offload_message msg,
 				    uint32_t no_samples);
 
+/* Allocate the DMACs used by an offload session */
+int32_t spi_engine_session_init(struct spi_engine_session **session,
+				struct spi_desc *desc,
+				const struct spi_engine_offload_init_param *param);
+
+/* Load the program of an offload message, if it is not loaded already */
+int32_t spi_engine_session_load(struct spi_engine_session *session,
+				const struct spi_engine_offload_message *msg);
+
+/* Start a capture of no_samples executions of the loaded program */
+int32_t spi_engine_session_arm(struct spi_engine_session *session,
+			       uint32_t rx_addr, uint32_t tx_addr,
+			       uint32_t no_samples);
+
+/* Wait for the capture started by spi_engine_session_arm() */
+int32_t spi_engine_session_wait(struct spi_engine_session *session,
+				uint32_t timeout_us);
+
+/* Load an offload message and capture no_samples executions of it */
+int32_t spi_engine_session_transfer(struct spi_engine_session *session,
+				    const struct spi_engine_offload_message *msg,
+				    uint32_t no_samples);
+
+/* Start capturing continuously in a ring buffer */
+int32_t spi_engine_stream_start(struct spi_engine_session *session,
+		const struct spi_engine_stream_init_param *param);
+
+/* Add the periods written by the DMA to the circular buffer and queue the
+ * released ones again */
+int32_t spi_engine_stream_poll(struct spi_engine_session *session);
+
+/* Get a slice of the captured data */
+int32_t spi_engine_stream_read(struct spi_engine_session *session,
+			       uint32_t size, void **buff, uint32_t *avail);
+
+/* Release the slice returned by spi_engine_stream_read() */
+int32_t spi_engine_stream_release(struct spi_engine_session *session);
+
+/* Stop the continuous capture */
+int32_t spi_engine_stream_stop(struct spi_engine_session *session);
+
+/* Free the resources allocated by spi_engine_session_init() */
+int32_t spi_engine_session_remove(struct spi_engine_session *session);
+
 /* Set SPI transfer width */
 int32_t spi_engine_set_transfer_width(struct spi_desc *desc,
 				      uint8_t data_wdith);
@@ -47,6 +47,13 @@
 #include "adas1000.h"
 #include "crc.h"
 
+/*****************************************************************************/
+/************************ Variable Definitions *******************************/
+/*****************************************************************************/
+/** Frame CRC tables, processing a frame word per lookup step */
+DECLARE_CRC_TABLE(adas1000_crc16, 4);
+DECLARE_CRC_TABLE(adas1000_crc24, 4);
+
 /*****************************************************************************/
 /************************ Function Definitions *******************************/
 /*****************************************************************************/
@@ -106,6 +113,10 @@ int32_t adas1000_init(struct adas1000_dev **device,
 	if (!dev)
 		return FAILURE;
 
+	/** Create the frame CRC tables once, they don't depend on the device */
+	crc_populate_msb(&adas1000_crc16, 16, CRC_POLY_128KHZ);
+	crc_populate_msb(&adas1000_crc24, 24, CRC_POLY_2KHZ_16KHZ);
+
 	/** store the selected frame rate */
 	dev->frame_rate = init_param->frame_rate;
 
@@ -409,13 +420,8 @@ uint32_t adas1000_compute_frame_crc(struct adas1000_dev * device, uint8_t *buff)
 	uint32_t crc = 0xFFFFFFFFul;
 
 	/** Select the CRC poly and word size based on the frame rate. */
-	if(device->frame_rate == ADAS1000_128KHZ_FRAME_RATE) {
-		DECLARE_CRC16_TABLE(adas1000_crc16);
-		crc16_populate_msb(adas1000_crc16, CRC_POLY_128KHZ);
-		return crc16(adas1000_crc16, buff, device->frame_size, (uint16_t)crc);
-	} else {
-		DECLARE_CRC24_TABLE(adas1000_crc24);
-		crc24_populate_msb(adas1000_crc24, CRC_POLY_2KHZ_16KHZ);
-		return crc24(adas1000_crc24, buff, device->frame_size, crc);
-	}
+	if(device->frame_rate == ADAS1000_128KHZ_FRAME_RATE)
+		return crc_compute(&adas1000_crc16, buff, device->frame_size, crc);
+
+	return crc_compute(&adas1000_crc24, buff, device->frame_size, crc);
 }
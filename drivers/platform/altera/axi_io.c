@@ -77,3 +77,49 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return SUCCESS;
 }
 
+/**
+ * @brief AXI IO Altera specific read of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - buffer where returned data is stored
+ * @param nb_words - number of 32 bit registers to read
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read_block(uint32_t base, uint32_t offset, uint32_t *data,
+			  uint32_t nb_words)
+{
+	uint32_t i;
+
+	for (i = 0; i < nb_words; i++)
+		data[i] = IORD_32DIRECT(base, offset + i * 4);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO Altera specific write of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - data to be written
+ * @param nb_words - number of 32 bit registers to write
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_block(uint32_t base, uint32_t offset,
+			   const uint32_t *data, uint32_t nb_words)
+{
+	uint32_t i;
+
+	for (i = 0; i < nb_words; i++)
+		IOWR_32DIRECT(base, offset + i * 4, data[i]);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO Altera specific unmap function, the registers are not mapped.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_unmap_all(void)
+{
+	return SUCCESS;
+}
@@ -80,3 +80,50 @@ int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 
 	return SUCCESS;
 }
+
+/**
+ * @brief AXI IO generic read of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - buffer where returned data is stored
+ * @param nb_words - number of 32 bit registers to read
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read_block(uint32_t base, uint32_t offset, uint32_t *data,
+			  uint32_t nb_words)
+{
+	UNUSED_PARAM(base);
+	UNUSED_PARAM(offset);
+	UNUSED_PARAM(data);
+	UNUSED_PARAM(nb_words);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO generic write of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - data to be written
+ * @param nb_words - number of 32 bit registers to write
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_block(uint32_t base, uint32_t offset,
+			   const uint32_t *data, uint32_t nb_words)
+{
+	UNUSED_PARAM(base);
+	UNUSED_PARAM(offset);
+	UNUSED_PARAM(data);
+	UNUSED_PARAM(nb_words);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO generic unmap function, the registers are not mapped.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_unmap_all(void)
+{
+	return SUCCESS;
+}
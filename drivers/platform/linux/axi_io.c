@@ -42,123 +42,202 @@
 /******************************************************************************/
 #include <fcntl.h>
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include "error.h"
 #include "axi_io.h"
 
 /******************************************************************************/
-/************************ Functions Definitions *******************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum number of regions kept mapped at the same time */
+#define AXI_IO_MAX_MAPS		32
+
+/* Prefix of the UIO device files. It can be overwritten, for example to
+ * point to files in a tmpfs directory when no hardware is available. */
+#ifndef AXI_IO_UIO_PATH
+#define AXI_IO_UIO_PATH		"/dev/uio"
+#endif
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
 /******************************************************************************/
 
 /**
- * @brief AXI IO through UIO read/write function.
- * @param base - UIO index (/dev/uioX).
- * @param offset - Address offset.
- * @param read - Location where read data will be stored.
- * @param write - Data to be written.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @struct axi_io_map
+ * @brief Region mapped on the first access and kept mapped afterwards.
  */
-static int32_t uio_read_write(uint32_t base, uint32_t offset, uint32_t *read,
-			      uint32_t *write)
+struct axi_io_map {
+	/** UIO index or physical base address (DEVMEM) */
+	uint32_t	base;
+	/** Opened UIO device or /dev/mem */
+	int		fd;
+	/** Address of the mapping */
+	uint8_t		*addr;
+	/** Size of the mapping in bytes */
+	size_t		size;
+};
+
+static struct axi_io_map	axi_io_maps[AXI_IO_MAX_MAPS];
+static uint32_t			axi_io_nb_maps;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Round size up to a multiple of the page size */
+static size_t axi_io_page_align(size_t size)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+
+	return (size + page - 1) & ~(page - 1);
+}
+
+#ifndef DEVMEM
+/* Size of the first memory region of an UIO device, 0 if unknown */
+static size_t uio_region_size(uint32_t base, int fd)
+{
+	char		buf[64];
+	unsigned long	size;
+	struct stat	st;
+	FILE		*f;
+
+	sprintf(buf, "/sys/class/uio/uio%"PRIu32"/maps/map0/size", base);
+	f = fopen(buf, "r");
+	if (f) {
+		if (fscanf(f, "%lx", &size) != 1)
+			size = 0;
+		fclose(f);
+		if (size)
+			return size;
+	}
+
+	/* Regular file standing in for the device */
+	if (!fstat(fd, &st) && S_ISREG(st.st_mode))
+		return st.st_size;
+
+	return 0;
+}
+#endif
+
+/* Open the device backing a region */
+static int32_t axi_io_open(struct axi_io_map *map, uint32_t base)
 {
-	char buf[32];
-	int ret;
-	int uio_fd;
-	int32_t status = SUCCESS;
-	void *uio_addr;
+	char buf[64];
 
-	sprintf(buf, "/dev/uio%"PRIu32"", base);
+#ifdef DEVMEM
+	sprintf(buf, "/dev/mem");
+#else
+	sprintf(buf, AXI_IO_UIO_PATH"%"PRIu32"", base);
+#endif
 
-	uio_fd = open(buf, O_RDWR);
-	if (uio_fd < 0) {
+	map->fd = open(buf, O_RDWR | O_SYNC);
+	if (map->fd < 0) {
 		printf("%s: Can't open %s\n\r", __func__, buf);
 		return FAILURE;
 	}
+	map->base = base;
+	map->addr = NULL;
+	map->size = 0;
 
-	uio_addr = mmap(NULL,
-			offset + sizeof(*read),
-			PROT_READ|PROT_WRITE,
-			MAP_SHARED,
-			uio_fd,
-			0);
-	if (uio_addr == MAP_FAILED) {
-		printf("%s: mmap() failed\n\r", __func__);
-		status = FAILURE;
-		goto close;
-	}
+	return SUCCESS;
+}
 
-	if (read)
-		*read = *(uint32_t *)((uintptr_t)uio_addr + offset);
-	if (write)
-		*(uint32_t *)((uintptr_t)uio_addr + offset) = *write;
+/* Map at least min_size bytes of the region. Regions with a known size are
+ * mapped entirely, the others are extended when needed. */
+static int32_t axi_io_mmap(struct axi_io_map *map, size_t min_size)
+{
+	size_t	size;
+	off_t	offset;
+	void	*addr;
 
-	ret = munmap(uio_addr, offset + sizeof(*read));
-	if (ret < 0) {
-		printf("%s: munmap() failed\n\r", __func__);
-		status = FAILURE;
-	}
+#ifdef DEVMEM
+	size = 0;
+	offset = map->base;
+#else
+	size = uio_region_size(map->base, map->fd);
+	offset = 0;
+#endif
+	if (size < min_size)
+		size = min_size;
+	size = axi_io_page_align(size);
 
-close:
-	ret = close(uio_fd);
-	if (ret < 0) {
-		printf("%s: Can't close %s\n\r", __func__, buf);
-		status = FAILURE;
+	if (map->addr)
+		munmap(map->addr, map->size);
+
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd,
+		    offset);
+	if (addr == MAP_FAILED) {
+		printf("%s: mmap() failed\n\r", __func__);
+		map->addr = NULL;
+		map->size = 0;
+		return FAILURE;
 	}
+	map->addr = addr;
+	map->size = size;
 
-	return status;
+	return SUCCESS;
 }
 
-#ifdef DEVMEM
 /**
- * @brief AXI IO through devmem read/write function.
- * @param base - Base address.
+ * @brief Get the address where a register range of a region is mapped.
+ * The region is opened and mapped on the first access and stays mapped
+ * until axi_io_unmap_all().
+ * @param base - UIO index (/dev/uioX)/base address.
  * @param offset - Address offset.
- * @param read - Location where read data will be stored.
- * @param write - Data to be written.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @param len - Number of bytes that will be accessed.
+ * @param addr - Location where the address is stored.
+ * @return SUCCESS in case of success, -ENOMEM if AXI_IO_MAX_MAPS regions are
+ * mapped already, FAILURE otherwise.
  */
-static int32_t devmem_read_write(uint32_t base, uint32_t offset, uint32_t *read,
-				 uint32_t *write)
+static int32_t axi_io_get_addr(uint32_t base, uint32_t offset, size_t len,
+			       volatile uint32_t **addr)
 {
-	char command[64];
-	char answer[64];
-	FILE *stream;
-	int32_t ret;
-
-	if (write)
-		ret = snprintf(command, sizeof(command),
-			       "busybox devmem 0x%x w 0x%x", base + offset, *write);
-	else if (read)
-		ret = snprintf(command, sizeof(command),
-			       "busybox devmem 0x%x", base + offset);
-	else
-		return FAILURE;
+	struct axi_io_map	*map;
+	uint32_t		i;
+	int32_t			ret;
 
-	if (ret < 0 || ret >= (int32_t) sizeof(command))
-		return FAILURE;
+#ifdef DEVMEM
+	/* /dev/mem can only be mapped from a page boundary */
+	offset += base & (sysconf(_SC_PAGESIZE) - 1);
+	base &= ~(sysconf(_SC_PAGESIZE) - 1);
+#endif
 
-	stream = popen(command, "r");
-	if (stream == NULL)
-		return FAILURE;
+	map = NULL;
+	for (i = 0; i < axi_io_nb_maps; i++)
+		if (axi_io_maps[i].base == base) {
+			map = &axi_io_maps[i];
+			break;
+		}
 
-	if (!(fgets(answer, sizeof(answer), stream))) {
-		ret = FAILURE;
-		goto close;
+	if (!map) {
+		if (axi_io_nb_maps == AXI_IO_MAX_MAPS) {
+			printf("%s: Too many regions\n\r", __func__);
+			return -ENOMEM;
+		}
+		map = &axi_io_maps[axi_io_nb_maps];
+		ret = axi_io_open(map, base);
+		if (ret != SUCCESS)
+			return ret;
+		axi_io_nb_maps++;
 	}
 
-	if (read)
-		*read = strtol(answer, NULL, 0);
+	if (offset + len > map->size) {
+		ret = axi_io_mmap(map, offset + len);
+		if (ret != SUCCESS)
+			return ret;
+	}
 
-	ret = SUCCESS;
-close:
-	pclose(stream);
+	*addr = (volatile uint32_t *)(map->addr + offset);
 
-	return ret;
+	return SUCCESS;
 }
-#endif //DEVMEM
+
 /**
  * @brief AXI IO through UIO/devmem read function.
  * @param base - UIO index (/dev/uioX)/base address.
@@ -168,25 +247,109 @@ close:
  */
 int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
 {
-#ifdef DEVMEM
-	return devmem_read_write(base, offset, data, NULL);
-#else
-	return uio_read_write(base, offset, data, NULL);
-#endif
+	volatile uint32_t	*addr;
+	int32_t			ret;
+
+	ret = axi_io_get_addr(base, offset, sizeof(*data), &addr);
+	if (ret != SUCCESS)
+		return ret;
+
+	*data = *addr;
+
+	return SUCCESS;
 }
 
 /**
- * @brief AXI IO through UIO specific write function.
- * @param base - UIO index (/dev/uioX).
+ * @brief AXI IO through UIO/devmem write function.
+ * @param base - UIO index (/dev/uioX)/base address.
  * @param offset - Address offset.
  * @param data - Data to be written.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 {
-#ifdef DEVMEM
-	return devmem_read_write(base, offset, NULL, &data);
-#else
-	return uio_read_write(base, offset, NULL, &data);
-#endif
+	volatile uint32_t	*addr;
+	int32_t			ret;
+
+	ret = axi_io_get_addr(base, offset, sizeof(data), &addr);
+	if (ret != SUCCESS)
+		return ret;
+
+	*addr = data;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO through UIO/devmem read of consecutive registers.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Location where read data will be stored.
+ * @param nb_words - Number of 32 bit registers to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read_block(uint32_t base, uint32_t offset, uint32_t *data,
+			  uint32_t nb_words)
+{
+	volatile uint32_t	*addr;
+	uint32_t		i;
+	int32_t			ret;
+
+	ret = axi_io_get_addr(base, offset, nb_words * sizeof(*data), &addr);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (i = 0; i < nb_words; i++)
+		data[i] = addr[i];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO through UIO/devmem write of consecutive registers.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Data to be written.
+ * @param nb_words - Number of 32 bit registers to write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_block(uint32_t base, uint32_t offset,
+			   const uint32_t *data, uint32_t nb_words)
+{
+	volatile uint32_t	*addr;
+	uint32_t		i;
+	int32_t			ret;
+
+	ret = axi_io_get_addr(base, offset, nb_words * sizeof(*data), &addr);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (i = 0; i < nb_words; i++)
+		addr[i] = data[i];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unmap the regions mapped by the previous accesses and close their
+ * devices. A region accessed afterwards is mapped again.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_unmap_all(void)
+{
+	struct axi_io_map	*map;
+	int32_t			ret;
+	uint32_t		i;
+
+	ret = SUCCESS;
+	for (i = 0; i < axi_io_nb_maps; i++) {
+		map = &axi_io_maps[i];
+		if (map->addr && munmap(map->addr, map->size))
+			ret = FAILURE;
+		if (close(map->fd))
+			ret = FAILURE;
+	}
+	axi_io_nb_maps = 0;
+
+	return ret;
 }
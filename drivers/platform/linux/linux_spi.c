@@ -48,10 +48,23 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <linux/spi/spidev.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum size of a spidev message, set by the bufsiz module parameter */
+#define LINUX_SPI_BUFSIZ_PATH	"/sys/module/spidev/parameters/bufsiz"
+#define LINUX_SPI_BUFSIZ_DEFAULT	4096
+
+/* Maximum number of transfers of a SPI_IOC_MESSAGE() */
+#define LINUX_SPI_MAX_TRANSFERS	\
+	((1 << _IOC_SIZEBITS) / sizeof(struct spi_ioc_transfer) - 1)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -63,12 +76,40 @@
 struct linux_spi_desc {
 	/** /dev/spidev"device_id"."chip_select" file descriptor */
 	int spidev_fd;
+	/** Maximum number of bytes of a message */
+	uint32_t bufsiz;
+	/** Transfers of linux_spi_transfer(), kept between calls */
+	struct spi_ioc_transfer *tr;
+	/** Number of entries of tr */
+	uint32_t nb_tr;
 };
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * @brief Get the maximum size of a spidev message.
+ * @return The bufsiz parameter of the spidev module or its default value.
+ */
+static uint32_t linux_spi_get_bufsiz(void)
+{
+	unsigned int bufsiz;
+	FILE *f;
+	int ret;
+
+	f = fopen(LINUX_SPI_BUFSIZ_PATH, "r");
+	if (!f)
+		return LINUX_SPI_BUFSIZ_DEFAULT;
+
+	ret = fscanf(f, "%u", &bufsiz);
+	fclose(f);
+	if (ret != 1 || !bufsiz)
+		return LINUX_SPI_BUFSIZ_DEFAULT;
+
+	return bufsiz;
+}
+
 /**
  * @brief Initialize the SPI communication peripheral.
  * @param desc - The SPI descriptor.
@@ -93,6 +134,9 @@ int32_t linux_spi_init(struct spi_desc **desc,
 		goto free_desc;
 
 	descriptor->extra = linux_desc;
+	linux_desc->bufsiz = linux_spi_get_bufsiz();
+	linux_desc->tr = NULL;
+	linux_desc->nb_tr = 0;
 
 	snprintf(path, sizeof(path), "/dev/spidev%d.%d",
 		 param->device_id, param->chip_select);
@@ -157,7 +201,7 @@ int32_t linux_spi_write_and_read(struct spi_desc *desc,
 	linux_desc = desc->extra;
 
 	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(1), &tr);
-	if (ret == 1) {
+	if (ret < 0) {
 		printf("%s: Can't send spi message\n\r", __func__);
 		return FAILURE;
 	}
@@ -183,12 +227,23 @@ int32_t linux_spi_remove(struct spi_desc *desc)
 		return FAILURE;
 	}
 
+	free(linux_desc->tr);
 	free(desc->extra);
 	free(desc);
 
 	return SUCCESS;
 }
 
+/**
+ * @brief Send a list of messages. The messages are sent with as few
+ * SPI_IOC_MESSAGE() calls as the spidev limits allow, splitting the list
+ * only where CS is deasserted.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @return Number of bytes sent in case of success, negative error code
+ * otherwise.
+ */
 static int32_t linux_spi_transfer(struct spi_desc *desc,
 				  struct spi_msg *msgs,
 				  uint32_t len)
@@ -197,29 +252,70 @@ static int32_t linux_spi_transfer(struct spi_desc *desc,
 	struct spi_ioc_transfer *tr;
 	struct linux_spi_desc	*linux_desc;
 	int			ret;
-	uint32_t		i;
+	uint32_t		i, first, bytes, split, split_bytes;
+	int32_t			total = 0;
 
 	linux_desc = desc->extra;
 
-	tr = (struct spi_ioc_transfer *)calloc(len, sizeof(*tr));
-	if (!tr)
-		return -ENOMEM;
+	if (len > linux_desc->nb_tr) {
+		tr = (struct spi_ioc_transfer *)realloc(linux_desc->tr,
+							len * sizeof(*tr));
+		if (!tr)
+			return -ENOMEM;
+		linux_desc->tr = tr;
+		linux_desc->nb_tr = len;
+	}
+	tr = linux_desc->tr;
 
 	for (i = 0; i < len; i++) {
-		tr[i].tx_buf = msgs[i].tx_buff;
-		tr[i].rx_buf = msgs[i].rx_buff;
+		memset(&tr[i], 0, sizeof(tr[i]));
+		tr[i].tx_buf = (unsigned long)msgs[i].tx_buff;
+		tr[i].rx_buf = (unsigned long)msgs[i].rx_buff;
 		tr[i].len = msgs[i].bytes_number;
 		tr[i].cs_change = msgs[i].cs_change;
 	}
 
-	ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(len), tr);
-	if (ret < 0)
-		printf("%s: Can't send spi message (%d)\n\r", __func__, errno);
-
-	free(tr);
+	first = 0;
+	while (first < len) {
+		/* Largest run of transfers ending with CS deasserted */
+		bytes = 0;
+		split = 0;
+		split_bytes = 0;
+		for (i = first; i < len && i - first < LINUX_SPI_MAX_TRANSFERS;
+		     i++) {
+			if (bytes + tr[i].len > linux_desc->bufsiz && split)
+				break;
+			bytes += tr[i].len;
+			if (tr[i].cs_change || i == len - 1) {
+				split = i + 1;
+				split_bytes = bytes;
+			}
+		}
+		if (!split) {
+			/* Can't split a CS assertion, let spidev judge */
+			split = i;
+			split_bytes = bytes;
+		}
+
+		/* CS is deasserted at the end of the message, cs_change on the
+		 * last transfer would keep it asserted instead */
+		tr[split - 1].cs_change = 0;
+
+		ret = ioctl(linux_desc->spidev_fd, SPI_IOC_MESSAGE(split - first),
+			    &tr[first]);
+		if (ret < 0) {
+			printf("%s: Can't send spi message (%d)\n\r", __func__,
+			       errno);
+			return -errno;
+		}
+
+		total += split_bytes;
+		first = split;
+	}
 
-	return ret;
+	return total;
 }
+
 /**
  * @brief Linux platform specific SPI platform ops structure
  */
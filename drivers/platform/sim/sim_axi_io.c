@@ -0,0 +1,311 @@
+/***************************************************************************//**
+ *   @file   sim/sim_axi_io.c
+ *   @brief  Register level simulation of the AXI IO access.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include "error.h"
+#include "sim_axi_io.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* End of the memory the simulated DMA cores can address */
+#define SIM_DMA_ADDR_LIMIT	0x100000000ull
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static struct sim_axi_region	*sim_regions[SIM_AXI_MAX_REGIONS];
+static uint32_t			sim_nb_regions;
+/* Last accessed region, drivers usually access the same core repeatedly */
+static struct sim_axi_region	*sim_last_region;
+#ifndef MAP_32BIT
+/* Address asked for the next DMA memory, which must stay below 4GB */
+static uintptr_t		sim_dma_hint = 0x40000000;
+#endif
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Make a register region visible through axi_io_read()/axi_io_write().
+ * @param region - Region to add. Must stay valid until it is removed.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_axi_add_region(struct sim_axi_region *region)
+{
+	if (!region || !region->regs || !region->size)
+		return -EINVAL;
+
+	if (sim_axi_get_region(region->base))
+		return -EEXIST;
+
+	if (sim_nb_regions == SIM_AXI_MAX_REGIONS)
+		return -ENOMEM;
+
+	region->nb_reads = 0;
+	region->nb_writes = 0;
+	sim_regions[sim_nb_regions++] = region;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Remove a region added by sim_axi_add_region().
+ * @param region - Region to remove.
+ * @return SUCCESS in case of success, -ENOENT if the region was not added.
+ */
+int32_t sim_axi_remove_region(struct sim_axi_region *region)
+{
+	uint32_t i;
+
+	for (i = 0; i < sim_nb_regions; i++)
+		if (sim_regions[i] == region)
+			break;
+	if (i == sim_nb_regions)
+		return -ENOENT;
+
+	sim_regions[i] = sim_regions[--sim_nb_regions];
+	if (sim_last_region == region)
+		sim_last_region = NULL;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the region mapped at base.
+ * @param base - Base address of the region.
+ * @return The region or NULL if there is no region at base.
+ */
+struct sim_axi_region *sim_axi_get_region(uint32_t base)
+{
+	uint32_t i;
+
+	if (sim_last_region && sim_last_region->base == base)
+		return sim_last_region;
+
+	for (i = 0; i < sim_nb_regions; i++)
+		if (sim_regions[i]->base == base) {
+			sim_last_region = sim_regions[i];
+			return sim_last_region;
+		}
+
+	return NULL;
+}
+
+/* Get the region at base and check the access */
+static struct sim_axi_region *sim_axi_access(uint32_t base, uint32_t offset,
+		uint32_t nb_words)
+{
+	struct sim_axi_region *region;
+
+	region = sim_axi_get_region(base);
+	if (!region) {
+		printf("%s: No region at 0x%08"PRIx32"\n", __func__, base);
+		return NULL;
+	}
+
+	if ((offset & 0x3) || offset + nb_words * 4 > region->size) {
+		printf("%s: Invalid access at 0x%08"PRIx32" + 0x%"PRIx32"\n",
+		       __func__, base, offset);
+		return NULL;
+	}
+
+	return region;
+}
+
+/**
+ * @brief AXI IO simulated read function.
+ * @param base - Base address of the region.
+ * @param offset - Address offset.
+ * @param data - Location where read data will be stored.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
+{
+	struct sim_axi_region *region;
+
+	region = sim_axi_access(base, offset, 1);
+	if (!region)
+		return FAILURE;
+
+	region->nb_reads++;
+	if (region->ops && region->ops->read)
+		return region->ops->read(region, offset, data);
+
+	*data = region->regs[offset / 4];
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO simulated write function.
+ * @param base - Base address of the region.
+ * @param offset - Address offset.
+ * @param data - Data to be written.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
+{
+	struct sim_axi_region *region;
+
+	region = sim_axi_access(base, offset, 1);
+	if (!region)
+		return FAILURE;
+
+	region->nb_writes++;
+	if (region->ops && region->ops->write)
+		return region->ops->write(region, offset, data);
+
+	region->regs[offset / 4] = data;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO simulated read of consecutive registers.
+ * @param base - Base address of the region.
+ * @param offset - Address offset of the first register.
+ * @param data - Location where read data will be stored.
+ * @param nb_words - Number of 32 bit registers to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_read_block(uint32_t base, uint32_t offset, uint32_t *data,
+			  uint32_t nb_words)
+{
+	uint32_t i;
+	int32_t ret;
+
+	if (!sim_axi_access(base, offset, nb_words))
+		return FAILURE;
+
+	for (i = 0; i < nb_words; i++) {
+		ret = axi_io_read(base, offset + i * 4, &data[i]);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief AXI IO simulated write of consecutive registers.
+ * @param base - Base address of the region.
+ * @param offset - Address offset of the first register.
+ * @param data - Data to be written.
+ * @param nb_words - Number of 32 bit registers to write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t axi_io_write_block(uint32_t base, uint32_t offset,
+			   const uint32_t *data, uint32_t nb_words)
+{
+	uint32_t i;
+	int32_t ret;
+
+	if (!sim_axi_access(base, offset, nb_words))
+		return FAILURE;
+
+	for (i = 0; i < nb_words; i++) {
+		ret = axi_io_write(base, offset + i * 4, data[i]);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unmap the regions mapped by the previous accesses. The simulated
+ * regions are added with sim_axi_add_region() and are not mapped, so there is
+ * nothing to do.
+ * @return SUCCESS.
+ */
+int32_t axi_io_unmap_all(void)
+{
+	return SUCCESS;
+}
+
+/**
+ * @brief Allocate memory that simulated DMA cores can address.
+ * The DMA drivers use 32 bit addresses, so the memory is allocated in the
+ * low 4GB of the address space. MAP_32BIT only exists on x86-64, elsewhere
+ * the mapping is asked at a low address and checked.
+ * @param size - Size in bytes.
+ * @return Pointer to the memory or NULL on failure.
+ */
+void *sim_dma_alloc(uint32_t size)
+{
+	void *buff;
+
+#ifdef MAP_32BIT
+	buff = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (buff == MAP_FAILED)
+		return NULL;
+#else
+	buff = mmap((void *)sim_dma_hint, size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (buff == MAP_FAILED)
+		return NULL;
+	if ((uintptr_t)buff + size > SIM_DMA_ADDR_LIMIT) {
+		munmap(buff, size);
+		return NULL;
+	}
+	/* The next allocation is asked right after this one */
+	sim_dma_hint = (uintptr_t)buff + size;
+#endif
+
+	return buff;
+}
+
+/**
+ * @brief Free memory allocated by sim_dma_alloc().
+ * @param buff - Pointer returned by sim_dma_alloc().
+ * @param size - Size used for the allocation.
+ */
+void sim_dma_free(void *buff, uint32_t size)
+{
+	munmap(buff, size);
+}
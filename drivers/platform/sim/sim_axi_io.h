@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ *   @file   sim/sim_axi_io.h
+ *   @brief  Register level simulation of the AXI IO access.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef SIM_AXI_IO_H_
+#define SIM_AXI_IO_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include "axi_io.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum number of simulated register regions */
+#define SIM_AXI_MAX_REGIONS	16
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct sim_axi_region;
+
+/**
+ * @struct sim_axi_region_ops
+ * @brief Device model hooks. A NULL hook means plain memory behavior.
+ */
+struct sim_axi_region_ops {
+	/** Called on register reads, stores the value in data */
+	int32_t (*read)(struct sim_axi_region *region, uint32_t offset,
+			uint32_t *data);
+	/** Called on register writes */
+	int32_t (*write)(struct sim_axi_region *region, uint32_t offset,
+			 uint32_t data);
+};
+
+/**
+ * @struct sim_axi_region
+ * @brief Register file of a simulated AXI core.
+ */
+struct sim_axi_region {
+	/** Base address used by the driver of the core */
+	uint32_t			base;
+	/** Size of the register file in bytes */
+	uint32_t			size;
+	/** Register values */
+	uint32_t			*regs;
+	/** Device model, NULL for a plain register file */
+	const struct sim_axi_region_ops	*ops;
+	/** Device model private data */
+	void				*ctx;
+	/** Number of register reads done by the drivers */
+	uint64_t			nb_reads;
+	/** Number of register writes done by the drivers */
+	uint64_t			nb_writes;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Make a register region visible through axi_io_read()/axi_io_write(). */
+int32_t sim_axi_add_region(struct sim_axi_region *region);
+
+/* Remove a region added by sim_axi_add_region(). */
+int32_t sim_axi_remove_region(struct sim_axi_region *region);
+
+/* Get the region mapped at base. */
+struct sim_axi_region *sim_axi_get_region(uint32_t base);
+
+/* Allocate memory that simulated DMA cores can address. */
+void *sim_dma_alloc(uint32_t size);
+
+/* Free memory allocated by sim_dma_alloc(). */
+void sim_dma_free(void *buff, uint32_t size);
+
+#endif // SIM_AXI_IO_H_
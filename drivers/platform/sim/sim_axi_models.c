@@ -0,0 +1,425 @@
+/***************************************************************************//**
+ *   @file   sim/sim_axi_models.c
+ *   @brief  Models of the AXI DMAC, ADC and DAC cores.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <stdint.h>
+#include "error.h"
+#include "util.h"
+#include "axi_adc_core.h"
+#include "sim_axi_models.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* The ADC and DAC cores share the common registers */
+#define SIM_CONV_REG_RSTN		0x0040
+#define SIM_CONV_REG_CLK_FREQ		0x0054
+#define SIM_CONV_REG_CLK_RATIO		0x0058
+#define SIM_CONV_REG_STATUS		0x005C
+
+#define SIM_DMAC_DEFAULT_MAX_LENGTH	0x00FFFFFF
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Register read of the converter model */
+static int32_t sim_axi_conv_read(struct sim_axi_region *region,
+				 uint32_t offset, uint32_t *data)
+{
+	struct sim_axi_conv *conv = region->ctx;
+	uint32_t rstn;
+
+	switch (offset) {
+	case SIM_CONV_REG_STATUS:
+		rstn = AXI_ADC_MMCM_RSTN | AXI_ADC_RSTN;
+		*data = (region->regs[SIM_CONV_REG_RSTN / 4] & rstn) == rstn;
+		break;
+	case SIM_CONV_REG_CLK_FREQ:
+		/* The drivers compute the clock as (freq * ratio * 390625) >> 8 */
+		*data = (conv->clock_hz << 8) / 390625;
+		break;
+	case SIM_CONV_REG_CLK_RATIO:
+		*data = 1;
+		break;
+	default:
+		*data = region->regs[offset / 4];
+		break;
+	}
+
+	return SUCCESS;
+}
+
+/* Register write of the converter model */
+static int32_t sim_axi_conv_write(struct sim_axi_region *region,
+				  uint32_t offset, uint32_t data)
+{
+	/* The ADC channel status registers are write 1 to clear */
+	if (offset >= AXI_ADC_REG_CHAN_CNTRL(0) &&
+	    (offset & 0x3F) == (AXI_ADC_REG_CHAN_STATUS(0) & 0x3F)) {
+		region->regs[offset / 4] &= ~data;
+		return SUCCESS;
+	}
+
+	region->regs[offset / 4] = data;
+
+	return SUCCESS;
+}
+
+static const struct sim_axi_region_ops sim_axi_conv_ops = {
+	.read = sim_axi_conv_read,
+	.write = sim_axi_conv_write,
+};
+
+/* Move data between the converter and memory */
+static void sim_axi_conv_data(struct sim_axi_conv *conv, uint8_t *buff,
+			      uint32_t bytes, enum dma_direction direction)
+{
+	uint32_t i;
+
+	conv->bytes += bytes;
+	if (conv->data) {
+		conv->data(conv->ctx, buff, bytes);
+		return;
+	}
+
+	if (direction == DMA_MEM_TO_DEV)
+		return;
+
+	/* 16 bit ramp */
+	for (i = 0; i + 1 < bytes; i += 2) {
+		buff[i] = conv->ramp & 0xFF;
+		buff[i + 1] = conv->ramp >> 8;
+		conv->ramp++;
+	}
+}
+
+/**
+ * @brief Create an AXI ADC/DAC core model and map its registers.
+ * @param conv - The model.
+ * @param init - Model parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_axi_conv_init(struct sim_axi_conv **conv,
+			  const struct sim_axi_conv_init *init)
+{
+	struct sim_axi_conv *model;
+	int32_t ret;
+
+	model = (struct sim_axi_conv *)calloc(1, sizeof(*model));
+	if (!model)
+		return -ENOMEM;
+
+	model->region.regs = (uint32_t *)calloc(1, SIM_AXI_CONV_SIZE);
+	if (!model->region.regs) {
+		ret = -ENOMEM;
+		goto error;
+	}
+	model->region.base = init->base;
+	model->region.size = SIM_AXI_CONV_SIZE;
+	model->region.ops = &sim_axi_conv_ops;
+	model->region.ctx = model;
+	model->clock_hz = init->clock_hz;
+	model->data = init->data;
+	model->ctx = init->ctx;
+
+	ret = sim_axi_add_region(&model->region);
+	if (ret != SUCCESS)
+		goto error;
+
+	*conv = model;
+
+	return SUCCESS;
+error:
+	free(model->region.regs);
+	free(model);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by sim_axi_conv_init().
+ * @param conv - The model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_axi_conv_remove(struct sim_axi_conv *conv)
+{
+	if (!conv)
+		return FAILURE;
+
+	sim_axi_remove_region(&conv->region);
+	free(conv->region.regs);
+	free(conv);
+
+	return SUCCESS;
+}
+
+/* Signal the end of a transfer */
+static void sim_axi_dmac_done(struct sim_axi_dmac *dmac, uint32_t id)
+{
+	uint32_t *regs = dmac->region.regs;
+
+	dmac->nb_transfers++;
+	regs[AXI_DMAC_REG_TRANSFER_DONE / 4] |= 1u << id;
+	regs[AXI_DMAC_REG_IRQ_PENDING / 4] |= AXI_DMAC_IRQ_SOT |
+					      AXI_DMAC_IRQ_EOT;
+	if (~regs[AXI_DMAC_REG_IRQ_MASK / 4] & (AXI_DMAC_IRQ_SOT |
+			AXI_DMAC_IRQ_EOT))
+		dmac->irq_raised = true;
+}
+
+/* Deliver the interrupt. Transfers started from the handler are delivered by
+ * the outer call. */
+static void sim_axi_dmac_irq(struct sim_axi_dmac *dmac)
+{
+	while (dmac->irq_raised && dmac->isr && !dmac->in_isr) {
+		dmac->irq_raised = false;
+		dmac->in_isr = true;
+		dmac->isr(dmac->isr_instance);
+		dmac->in_isr = false;
+	}
+}
+
+/* Accept the transfer described by the DMAC registers */
+static void sim_axi_dmac_run(struct sim_axi_dmac *dmac)
+{
+	uint32_t *regs = dmac->region.regs;
+	struct sim_axi_dmac_xfer xfer, *slot;
+	uint32_t i;
+
+	xfer.id = regs[AXI_DMAC_REG_TRANSFER_ID / 4];
+	regs[AXI_DMAC_REG_TRANSFER_ID / 4] = (xfer.id + 1) %
+					     SIM_AXI_DMAC_NB_IDS;
+	regs[AXI_DMAC_REG_TRANSFER_DONE / 4] &= ~(1u << xfer.id);
+
+	if (dmac->direction == DMA_DEV_TO_MEM) {
+		xfer.address = regs[AXI_DMAC_REG_DEST_ADDRESS / 4];
+		xfer.stride = regs[AXI_DMAC_REG_DEST_STRIDE / 4];
+	} else {
+		xfer.address = regs[AXI_DMAC_REG_SRC_ADDRESS / 4];
+		xfer.stride = regs[AXI_DMAC_REG_SRC_STRIDE / 4];
+	}
+	xfer.x_len = regs[AXI_DMAC_REG_X_LENGTH / 4] + 1;
+	xfer.y_len = regs[AXI_DMAC_REG_Y_LENGTH / 4] + 1;
+	xfer.done = 0;
+
+	if (dmac->paced) {
+		slot = &dmac->queue[(dmac->queue_first + dmac->nb_queued) %
+						       SIM_AXI_DMAC_NB_IDS];
+		*slot = xfer;
+		dmac->nb_queued++;
+		return;
+	}
+
+	for (i = 0; i < xfer.y_len; i++)
+		if (dmac->conv)
+			sim_axi_conv_data(dmac->conv, (uint8_t *)(uintptr_t)
+					  (xfer.address + i * xfer.stride),
+					  xfer.x_len, dmac->direction);
+
+	dmac->bytes += xfer.x_len * xfer.y_len;
+	sim_axi_dmac_done(dmac, xfer.id);
+}
+
+/**
+ * @brief Move the data produced or consumed by the converter of a paced
+ * model, completing the transfers that get done.
+ * @param dmac - The model.
+ * @param bytes - Number of bytes of the converter.
+ * @return Number of bytes moved, less than bytes when the model ran out of
+ * transfers. The rest of the data is lost.
+ */
+uint64_t sim_axi_dmac_advance(struct sim_axi_dmac *dmac, uint64_t bytes)
+{
+	struct sim_axi_dmac_xfer *xfer;
+	uint32_t line, offset, n;
+	uint64_t moved = 0;
+
+	while (moved < bytes && dmac->nb_queued) {
+		xfer = &dmac->queue[dmac->queue_first];
+		line = xfer->done / xfer->x_len;
+		offset = xfer->done % xfer->x_len;
+		n = xfer->x_len - offset;
+		if (n > bytes - moved)
+			n = bytes - moved;
+
+		if (dmac->conv)
+			sim_axi_conv_data(dmac->conv, (uint8_t *)(uintptr_t)
+					  (xfer->address + line * xfer->stride +
+					   offset), n, dmac->direction);
+		xfer->done += n;
+		dmac->bytes += n;
+		moved += n;
+
+		if (xfer->done == xfer->x_len * xfer->y_len) {
+			dmac->queue_first = (dmac->queue_first + 1) %
+					    SIM_AXI_DMAC_NB_IDS;
+			dmac->nb_queued--;
+			sim_axi_dmac_done(dmac, xfer->id);
+			sim_axi_dmac_irq(dmac);
+		}
+	}
+
+	return moved;
+}
+
+/* Register read of the DMAC model */
+static int32_t sim_axi_dmac_read(struct sim_axi_region *region,
+				 uint32_t offset, uint32_t *data)
+{
+	struct sim_axi_dmac *dmac = region->ctx;
+
+	/* Transfers are accepted right away, unless the queue is full */
+	if (offset == AXI_DMAC_REG_START_TRANSFER)
+		*data = dmac->nb_queued == SIM_AXI_DMAC_NB_IDS;
+	else
+		*data = region->regs[offset / 4];
+
+	return SUCCESS;
+}
+
+/* Register write of the DMAC model */
+static int32_t sim_axi_dmac_write(struct sim_axi_region *region,
+				  uint32_t offset, uint32_t data)
+{
+	struct sim_axi_dmac *dmac = region->ctx;
+
+	switch (offset) {
+	case AXI_DMAC_REG_IRQ_PENDING:
+		region->regs[offset / 4] &= ~data;
+		break;
+	case AXI_DMAC_REG_X_LENGTH:
+		region->regs[offset / 4] = data & dmac->max_length;
+		break;
+	case AXI_DMAC_REG_START_TRANSFER:
+		if ((data & 1) && dmac->nb_queued < SIM_AXI_DMAC_NB_IDS &&
+		    (region->regs[AXI_DMAC_REG_CTRL / 4] & AXI_DMAC_CTRL_ENABLE))
+			sim_axi_dmac_run(dmac);
+		break;
+	case AXI_DMAC_REG_CTRL:
+		/* Disabling the core aborts the transfers */
+		if (!(data & AXI_DMAC_CTRL_ENABLE))
+			dmac->nb_queued = 0;
+		region->regs[offset / 4] = data;
+		break;
+	default:
+		region->regs[offset / 4] = data;
+		break;
+	}
+
+	/* Deliver the interrupt once the register access is done */
+	sim_axi_dmac_irq(dmac);
+
+	return SUCCESS;
+}
+
+static const struct sim_axi_region_ops sim_axi_dmac_ops = {
+	.read = sim_axi_dmac_read,
+	.write = sim_axi_dmac_write,
+};
+
+/**
+ * @brief Create an AXI DMAC core model and map its registers.
+ * @param dmac - The model.
+ * @param init - Model parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_axi_dmac_init(struct sim_axi_dmac **dmac,
+			  const struct sim_axi_dmac_init *init)
+{
+	struct sim_axi_dmac *model;
+	int32_t ret;
+
+	model = (struct sim_axi_dmac *)calloc(1, sizeof(*model));
+	if (!model)
+		return -ENOMEM;
+
+	model->region.regs = (uint32_t *)calloc(1, SIM_AXI_DMAC_SIZE);
+	if (!model->region.regs) {
+		ret = -ENOMEM;
+		goto error;
+	}
+	model->region.base = init->base;
+	model->region.size = SIM_AXI_DMAC_SIZE;
+	model->region.ops = &sim_axi_dmac_ops;
+	model->region.ctx = model;
+	model->direction = init->direction;
+	model->max_length = init->max_length ? init->max_length :
+			    SIM_DMAC_DEFAULT_MAX_LENGTH;
+	model->conv = init->conv;
+	model->isr = init->isr;
+	model->isr_instance = init->isr_instance;
+	model->paced = init->paced;
+	/* Interrupts are masked out of reset */
+	model->region.regs[AXI_DMAC_REG_IRQ_MASK / 4] = AXI_DMAC_IRQ_SOT |
+			AXI_DMAC_IRQ_EOT;
+
+	ret = sim_axi_add_region(&model->region);
+	if (ret != SUCCESS)
+		goto error;
+
+	*dmac = model;
+
+	return SUCCESS;
+error:
+	free(model->region.regs);
+	free(model);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by sim_axi_dmac_init().
+ * @param dmac - The model.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sim_axi_dmac_remove(struct sim_axi_dmac *dmac)
+{
+	if (!dmac)
+		return FAILURE;
+
+	sim_axi_remove_region(&dmac->region);
+	free(dmac->region.regs);
+	free(dmac);
+
+	return SUCCESS;
+}
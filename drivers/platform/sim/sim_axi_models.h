@@ -0,0 +1,179 @@
+/***************************************************************************//**
+ *   @file   sim/sim_axi_models.h
+ *   @brief  Models of the AXI DMAC, ADC and DAC cores.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef SIM_AXI_MODELS_H_
+#define SIM_AXI_MODELS_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "axi_dmac.h"
+#include "sim_axi_io.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define SIM_AXI_DMAC_SIZE		0x1000
+#define SIM_AXI_CONV_SIZE		0x4000
+
+/* Number of transfer IDs of the DMA core */
+#define SIM_AXI_DMAC_NB_IDS		4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Produces (ADC) or consumes (DAC) the data moved by the DMA.
+ */
+typedef void (*sim_axi_conv_data_fn)(void *ctx, uint8_t *buff,
+				     uint32_t bytes);
+
+/**
+ * @struct sim_axi_conv_init
+ * @brief Parameters of an AXI ADC or DAC core model.
+ */
+struct sim_axi_conv_init {
+	/** Base address used by the axi_adc/axi_dac driver */
+	uint32_t		base;
+	/** Interface clock reported by the core */
+	uint64_t		clock_hz;
+	/** Data callback. NULL generates a ramp (ADC) or drops the data */
+	sim_axi_conv_data_fn	data;
+	/** Private data of the data callback */
+	void			*ctx;
+};
+
+/**
+ * @struct sim_axi_conv
+ * @brief AXI ADC or DAC core model.
+ */
+struct sim_axi_conv {
+	struct sim_axi_region	region;
+	uint64_t		clock_hz;
+	sim_axi_conv_data_fn	data;
+	void			*ctx;
+	/** Next value of the default ramp */
+	uint16_t		ramp;
+	/** Number of bytes moved through the core */
+	uint64_t		bytes;
+};
+
+/**
+ * @struct sim_axi_dmac_init
+ * @brief Parameters of an AXI DMAC core model.
+ */
+struct sim_axi_dmac_init {
+	/** Base address used by the axi_dmac driver */
+	uint32_t		base;
+	/** Transfer direction, as configured in the axi_dmac driver */
+	enum dma_direction	direction;
+	/** Value read from X_LENGTH after writing all ones. 0 for 16MB */
+	uint32_t		max_length;
+	/** Converter at the other end of the DMA */
+	struct sim_axi_conv	*conv;
+	/** Interrupt handler, NULL when the interrupt is not used */
+	void			(*isr)(void *instance);
+	/** Parameter of the interrupt handler */
+	void			*isr_instance;
+	/** Transfers only progress in sim_axi_dmac_advance() */
+	bool			paced;
+};
+
+/**
+ * @struct sim_axi_dmac_xfer
+ * @brief Transfer accepted by a paced AXI DMAC core model.
+ */
+struct sim_axi_dmac_xfer {
+	uint32_t		id;
+	uint32_t		address;
+	uint32_t		stride;
+	uint32_t		x_len;
+	uint32_t		y_len;
+	/** Bytes already moved */
+	uint32_t		done;
+};
+
+/**
+ * @struct sim_axi_dmac
+ * @brief AXI DMAC core model. Transfers complete as soon as they are started,
+ * or at the rate of the converter when the model is paced.
+ */
+struct sim_axi_dmac {
+	struct sim_axi_region	region;
+	enum dma_direction	direction;
+	uint32_t		max_length;
+	struct sim_axi_conv	*conv;
+	void			(*isr)(void *instance);
+	void			*isr_instance;
+	bool			in_isr;
+	bool			irq_raised;
+	/** Number of completed transfers */
+	uint64_t		nb_transfers;
+	/** Number of bytes moved */
+	uint64_t		bytes;
+	bool			paced;
+	/** Transfers accepted by a paced model, oldest first */
+	struct sim_axi_dmac_xfer queue[SIM_AXI_DMAC_NB_IDS];
+	uint32_t		queue_first;
+	uint32_t		nb_queued;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Create an AXI ADC/DAC core model and map its registers. */
+int32_t sim_axi_conv_init(struct sim_axi_conv **conv,
+			  const struct sim_axi_conv_init *init);
+
+/* Free the resources allocated by sim_axi_conv_init(). */
+int32_t sim_axi_conv_remove(struct sim_axi_conv *conv);
+
+/* Create an AXI DMAC core model and map its registers. */
+int32_t sim_axi_dmac_init(struct sim_axi_dmac **dmac,
+			  const struct sim_axi_dmac_init *init);
+
+/* Move the data produced or consumed by the converter of a paced model. */
+uint64_t sim_axi_dmac_advance(struct sim_axi_dmac *dmac, uint64_t bytes);
+
+/* Free the resources allocated by sim_axi_dmac_init(). */
+int32_t sim_axi_dmac_remove(struct sim_axi_dmac *dmac);
+
+#endif // SIM_AXI_MODELS_H_
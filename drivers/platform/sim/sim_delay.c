@@ -0,0 +1,105 @@
+/***************************************************************************//**
+ *   @file   sim/sim_delay.c
+ *   @brief  Implementation of the simulated delay functions.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include "sim_delay.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+static uint64_t sim_time_us;
+
+/* Called on each delay, see sim_delay_set_hook() */
+static void (*sim_delay_hook)(void *ctx);
+static void *sim_delay_hook_ctx;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Generate microseconds delay. The simulated time is advanced without
+ * waiting, so that driver delays do not count in the measurements.
+ * @param usecs - Delay in microseconds.
+ * @return None.
+ */
+void udelay(uint32_t usecs)
+{
+	sim_time_us += usecs;
+	if (sim_delay_hook)
+		sim_delay_hook(sim_delay_hook_ctx);
+}
+
+/**
+ * @brief Generate miliseconds delay.
+ * @param msecs - Delay in miliseconds.
+ * @return None.
+ */
+void mdelay(uint32_t msecs)
+{
+	sim_time_us += (uint64_t)msecs * 1000;
+	if (sim_delay_hook)
+		sim_delay_hook(sim_delay_hook_ctx);
+}
+
+/**
+ * @brief Get the simulated time spent in delays.
+ * @return Time in microseconds.
+ */
+uint64_t sim_get_time_us(void)
+{
+	return sim_time_us;
+}
+
+/**
+ * @brief Set a function called on each delay, after the simulated time is
+ * advanced. It lets the simulated peripherals progress while a driver waits
+ * for them.
+ * @param hook - Function to call, NULL to remove it.
+ * @param ctx - Parameter passed to hook.
+ * @return None.
+ */
+void sim_delay_set_hook(void (*hook)(void *ctx), void *ctx)
+{
+	sim_delay_hook = hook;
+	sim_delay_hook_ctx = ctx;
+}
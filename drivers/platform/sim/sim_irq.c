@@ -0,0 +1,255 @@
+/***************************************************************************//**
+ *   @file   sim/sim_irq.c
+ *   @brief  Implementation of the simulated interrupt controller.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include "error.h"
+#include "sim_irq.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Initialize the simulated interrupt controller.
+ * @param desc - The interrupt controller descriptor.
+ * @param param - Interrupt controller initialization parameters.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t irq_ctrl_init(struct irq_ctrl_desc **desc,
+		      const struct irq_init_param *param)
+{
+	struct irq_ctrl_desc *descriptor;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	descriptor = (struct irq_ctrl_desc *)calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	descriptor->extra = calloc(1, sizeof(struct sim_irq_desc));
+	if (!descriptor->extra) {
+		free(descriptor);
+		return -ENOMEM;
+	}
+
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by irq_ctrl_init().
+ * @param desc - The interrupt controller descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_ctrl_remove(struct irq_ctrl_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Register a callback for an interrupt line.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - Interrupt line.
+ * @param callback_desc - Callback to be called when the line is raised.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_register_callback(struct irq_ctrl_desc *desc, uint32_t irq_id,
+			      struct callback_desc *callback_desc)
+{
+	struct sim_irq_desc *sim_desc;
+
+	if (!desc || !callback_desc || irq_id >= SIM_IRQ_NB_IRQS)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	sim_desc->callbacks[irq_id] = *callback_desc;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Unregister the callback of an interrupt line and disable it.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - Interrupt line.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_unregister(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_desc *sim_desc;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_IRQS)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	sim_desc->callbacks[irq_id].callback = NULL;
+	sim_desc->enabled[irq_id] = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable all the interrupts.
+ * @param desc - The interrupt controller descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_global_enable(struct irq_ctrl_desc *desc)
+{
+	struct sim_irq_desc *sim_desc;
+
+	if (!desc)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	sim_desc->global_enabled = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Disable all the interrupts.
+ * @param desc - The interrupt controller descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_global_disable(struct irq_ctrl_desc *desc)
+{
+	struct sim_irq_desc *sim_desc;
+
+	if (!desc)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	sim_desc->global_enabled = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Set the trigger level of an interrupt line. The simulated lines are
+ * raised by software, so only the line number is checked.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - Interrupt line.
+ * @param trig - Trigger level.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_trigger_level_set(struct irq_ctrl_desc *desc, uint32_t irq_id,
+			      enum irq_trig_level trig)
+{
+	if (!desc || irq_id >= SIM_IRQ_NB_IRQS)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Enable an interrupt line.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - Interrupt line.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_enable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_desc *sim_desc;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_IRQS)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	sim_desc->enabled[irq_id] = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Disable an interrupt line.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - Interrupt line.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t irq_disable(struct irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct sim_irq_desc *sim_desc;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_IRQS)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	sim_desc->enabled[irq_id] = false;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Raise an interrupt line: call its callback if the line and the
+ * interrupts are enabled.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - Interrupt line.
+ * @param event - Event passed to the callback.
+ * @param extra - Platform specific data passed to the callback.
+ * @return SUCCESS if the callback was called, FAILURE otherwise.
+ */
+int32_t sim_irq_raise(struct irq_ctrl_desc *desc, uint32_t irq_id,
+		      uint32_t event, void *extra)
+{
+	struct sim_irq_desc	*sim_desc;
+	struct callback_desc	*cb;
+
+	if (!desc || irq_id >= SIM_IRQ_NB_IRQS)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	cb = &sim_desc->callbacks[irq_id];
+	if (!sim_desc->global_enabled || !sim_desc->enabled[irq_id] ||
+	    !cb->callback)
+		return FAILURE;
+
+	cb->callback(cb->ctx, event, extra);
+
+	return SUCCESS;
+}
@@ -0,0 +1,223 @@
+/***************************************************************************//**
+ *   @file   sim/sim_spi.c
+ *   @brief  Implementation of the simulated SPI driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "spi.h"
+#include "sim_spi.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Device model of a register map accessed through the ADI SPI protocol.
+ * @param ctx - struct sim_spi_regmap of the device.
+ * @param data - Bytes sent, replaced with the bytes read.
+ * @param bytes_number - Number of bytes.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t sim_spi_regmap_xfer(void *ctx, uint8_t *data, uint32_t bytes_number)
+{
+	struct sim_spi_regmap *regmap = ctx;
+	uint32_t addr, i;
+	bool read;
+
+	if (bytes_number < 2)
+		return -EINVAL;
+
+	read = data[0] & 0x80;
+	addr = ((data[0] & 0x7F) << 8) | data[1];
+	if (addr + bytes_number - 2 > regmap->size)
+		return -EINVAL;
+
+	regmap->nb_xfers++;
+	regmap->nb_bytes += bytes_number;
+
+	data[0] = 0;
+	data[1] = 0;
+	for (i = 2; i < bytes_number; i++, addr++) {
+		if (read)
+			data[i] = regmap->regs[addr];
+		else
+			regmap->regs[addr] = data[i];
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Initialize the simulated SPI.
+ * @param desc - The SPI descriptor.
+ * @param param - The structure that contains the SPI parameters. The extra
+ *                field points to a struct sim_spi_init_param.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_init(struct spi_desc **desc,
+			    const struct spi_init_param *param)
+{
+	struct sim_spi_init_param *sim_param;
+	struct spi_desc *descriptor;
+
+	sim_param = param->extra;
+	if (!sim_param || !sim_param->xfer)
+		return -EINVAL;
+
+	descriptor = (struct spi_desc *)calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	descriptor->extra = calloc(1, sizeof(*sim_param));
+	if (!descriptor->extra) {
+		free(descriptor);
+		return -ENOMEM;
+	}
+	memcpy(descriptor->extra, sim_param, sizeof(*sim_param));
+
+	descriptor->device_id = param->device_id;
+	descriptor->max_speed_hz = param->max_speed_hz;
+	descriptor->chip_select = param->chip_select;
+	descriptor->mode = param->mode;
+	descriptor->bit_order = param->bit_order;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write and read data to/from the simulated device.
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted/received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_write_and_read(struct spi_desc *desc, uint8_t *data,
+				      uint16_t bytes_number)
+{
+	struct sim_spi_init_param *sim_desc = desc->extra;
+
+	return sim_desc->xfer(sim_desc->ctx, data, bytes_number);
+}
+
+/**
+ * @brief Send a list of messages. Consecutive messages without cs_change are
+ * seen by the device model as a single transfer.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Messages.
+ * @param len - Number of messages.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+static int32_t sim_spi_transfer(struct spi_desc *desc, struct spi_msg *msgs,
+				uint32_t len)
+{
+	struct sim_spi_init_param *sim_desc = desc->extra;
+	uint32_t first, last, i, bytes, pos;
+	uint8_t *buff;
+	int32_t ret;
+
+	for (first = 0; first < len; first = last + 1) {
+		bytes = 0;
+		for (last = first; last < len; last++) {
+			bytes += msgs[last].bytes_number;
+			if (msgs[last].cs_change)
+				break;
+		}
+		if (last == len)
+			last--;
+
+		buff = (uint8_t *)malloc(bytes);
+		if (!buff)
+			return -ENOMEM;
+
+		for (i = first, pos = 0; i <= last; i++) {
+			if (msgs[i].tx_buff)
+				memcpy(buff + pos, msgs[i].tx_buff,
+				       msgs[i].bytes_number);
+			else
+				memset(buff + pos, 0, msgs[i].bytes_number);
+			pos += msgs[i].bytes_number;
+		}
+
+		ret = sim_desc->xfer(sim_desc->ctx, buff, bytes);
+
+		for (i = first, pos = 0; i <= last; i++) {
+			if (msgs[i].rx_buff)
+				memcpy(msgs[i].rx_buff, buff + pos,
+				       msgs[i].bytes_number);
+			pos += msgs[i].bytes_number;
+		}
+		free(buff);
+
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by sim_spi_init().
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t sim_spi_remove(struct spi_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Simulated SPI platform ops structure
+ */
+const struct spi_platform_ops sim_spi_platform_ops = {
+	.init = &sim_spi_init,
+	.write_and_read = &sim_spi_write_and_read,
+	.transfer = &sim_spi_transfer,
+	.remove = &sim_spi_remove
+};
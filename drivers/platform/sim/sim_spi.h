@@ -0,0 +1,99 @@
+/***************************************************************************//**
+ *   @file   sim/sim_spi.h
+ *   @brief  Header containing extra types and spi_platform_ops used by the
+ *           simulated SPI driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef SIM_SPI_H_
+#define SIM_SPI_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include "spi.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Device model callback. Receives the bytes sent while the chip
+ * select is asserted and replaces them with the bytes read.
+ */
+typedef int32_t (*sim_spi_xfer_fn)(void *ctx, uint8_t *data,
+				   uint32_t bytes_number);
+
+/**
+ * @struct sim_spi_init_param
+ * @brief Simulated SPI extra parameters, passed in spi_init_param.extra.
+ */
+struct sim_spi_init_param {
+	/** Device model */
+	sim_spi_xfer_fn	xfer;
+	/** Private data of the device model */
+	void		*ctx;
+};
+
+/**
+ * @struct sim_spi_regmap
+ * @brief Device with the ADI SPI protocol: a 16 bit instruction word (read
+ * bit and 15 bit address) followed by the data bytes, the address being
+ * incremented after each byte. Used with sim_spi_regmap_xfer().
+ */
+struct sim_spi_regmap {
+	/** Register values */
+	uint8_t		*regs;
+	/** Number of registers */
+	uint32_t	size;
+	/** Number of chip select assertions */
+	uint64_t	nb_xfers;
+	/** Number of bytes transferred */
+	uint64_t	nb_bytes;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Device model of a register map accessed through the ADI SPI protocol. */
+int32_t sim_spi_regmap_xfer(void *ctx, uint8_t *data, uint32_t bytes_number);
+
+/**
+ * @brief Simulated SPI platform ops structure
+ */
+extern const struct spi_platform_ops sim_spi_platform_ops;
+
+#endif // SIM_SPI_H_
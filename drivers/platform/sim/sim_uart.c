@@ -0,0 +1,374 @@
+/***************************************************************************//**
+ *   @file   sim/sim_uart.c
+ *   @brief  Implementation of the simulated UART driver.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "error.h"
+#include "delay.h"
+#include "util.h"
+#include "sim_irq.h"
+#include "sim_uart.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Move the data available on the host file to the receive FIFO.
+ * @param sim_desc - The simulated UART state.
+ * @return None.
+ */
+static void sim_uart_fill(struct sim_uart_desc *sim_desc)
+{
+	uint32_t	end;
+	ssize_t		ret;
+
+	if (sim_desc->fifo_len == SIM_UART_FIFO_SIZE)
+		return;
+
+	if (!sim_desc->fifo_len)
+		sim_desc->fifo_start = 0;
+	end = sim_desc->fifo_start + sim_desc->fifo_len;
+	if (end < SIM_UART_FIFO_SIZE) {
+		ret = read(sim_desc->fd, sim_desc->fifo + end,
+			   SIM_UART_FIFO_SIZE - end);
+	} else {
+		end -= SIM_UART_FIFO_SIZE;
+		ret = read(sim_desc->fd, sim_desc->fifo + end,
+			   sim_desc->fifo_start - end);
+	}
+	if (ret > 0)
+		sim_desc->fifo_len += ret;
+}
+
+/**
+ * @brief Take data from the receive FIFO.
+ * @param sim_desc - The simulated UART state.
+ * @param data - Destination of the data.
+ * @param size - Maximum number of bytes.
+ * @return Number of bytes taken.
+ */
+static uint32_t sim_uart_pop(struct sim_uart_desc *sim_desc, uint8_t *data,
+			     uint32_t size)
+{
+	uint32_t	len;
+	uint32_t	first;
+
+	len = min(size, sim_desc->fifo_len);
+	first = min(len, SIM_UART_FIFO_SIZE - sim_desc->fifo_start);
+	memcpy(data, sim_desc->fifo + sim_desc->fifo_start, first);
+	memcpy(data + first, sim_desc->fifo, len - first);
+	sim_desc->fifo_start = (sim_desc->fifo_start + len) %
+			       SIM_UART_FIFO_SIZE;
+	sim_desc->fifo_len -= len;
+
+	return len;
+}
+
+/**
+ * @brief Initialize the simulated UART over a host file. A terminal is set
+ * in raw mode and the file is made nonblocking.
+ * @param desc - The UART descriptor.
+ * @param param - UART initialization parameters, extra is a
+ *                sim_uart_init_param.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
+{
+	struct sim_uart_init_param	*sim_param;
+	struct sim_uart_desc		*sim_desc;
+	struct uart_desc		*descriptor;
+	struct termios			tio;
+	int				flags;
+
+	if (!desc || !param || !param->extra)
+		return -EINVAL;
+
+	sim_param = param->extra;
+	if (isatty(sim_param->fd)) {
+		if (tcgetattr(sim_param->fd, &tio))
+			return -EIO;
+		cfmakeraw(&tio);
+		if (tcsetattr(sim_param->fd, TCSANOW, &tio))
+			return -EIO;
+	}
+	flags = fcntl(sim_param->fd, F_GETFL);
+	if (flags < 0 || fcntl(sim_param->fd, F_SETFL, flags | O_NONBLOCK))
+		return -EIO;
+
+	descriptor = (struct uart_desc *)calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	sim_desc = calloc(1, sizeof(*sim_desc));
+	if (!sim_desc) {
+		free(descriptor);
+		return -ENOMEM;
+	}
+
+	sim_desc->fd = sim_param->fd;
+	sim_desc->irq_desc = sim_param->irq_desc;
+	sim_desc->irq_id = sim_param->irq_id;
+	descriptor->device_id = param->device_id;
+	descriptor->baud_rate = param->baud_rate;
+	descriptor->extra = sim_desc;
+
+	*desc = descriptor;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by uart_init(). The host file is not
+ * closed.
+ * @param desc - The UART descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_remove(struct uart_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	free(desc->extra);
+	free(desc);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read data from the UART. The simulated time advances while waiting
+ * for data, so that the simulated peer can send it.
+ * @param desc - The UART descriptor.
+ * @param data - Destination of the data.
+ * @param bytes_number - Number of bytes to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number)
+{
+	struct sim_uart_desc	*sim_desc;
+	uint32_t		len;
+
+	if (!desc || !data)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	while (bytes_number) {
+		sim_uart_fill(sim_desc);
+		len = sim_uart_pop(sim_desc, data, bytes_number);
+		if (!len)
+			udelay(1);
+		data += len;
+		bytes_number -= len;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write data to the UART. The simulated time advances while the host
+ * file is full, so that the simulated peer can read it.
+ * @param desc - The UART descriptor.
+ * @param data - Data to write.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_write(struct uart_desc *desc, const uint8_t *data,
+		   uint32_t bytes_number)
+{
+	struct sim_uart_desc	*sim_desc;
+	ssize_t			ret;
+
+	if (!desc || !data)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	while (bytes_number) {
+		ret = write(sim_desc->fd, data, bytes_number);
+		if (ret < 0) {
+			if (errno != EAGAIN)
+				return FAILURE;
+			udelay(1);
+			continue;
+		}
+		data += ret;
+		bytes_number -= ret;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Start a read. The data is transferred by sim_uart_poll(), which
+ * raises IRQ_READ_DONE when the read is complete.
+ * @param desc - The UART descriptor.
+ * @param data - Destination of the data.
+ * @param bytes_number - Number of bytes to read.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_read_nonblocking(struct uart_desc *desc, uint8_t *data,
+			      uint32_t bytes_number)
+{
+	struct sim_uart_desc *sim_desc;
+
+	if (!desc || !data || !bytes_number)
+		return FAILURE;
+
+	sim_desc = desc->extra;
+	if (sim_desc->rx_len)
+		return FAILURE;
+
+	sim_desc->rx_buff = data;
+	sim_desc->rx_len = bytes_number;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Write data to the UART and raise IRQ_WRITE_DONE.
+ * @param desc - The UART descriptor.
+ * @param data - Data to write.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t uart_write_nonblocking(struct uart_desc *desc, const uint8_t *data,
+			       uint32_t bytes_number)
+{
+	struct sim_uart_desc	*sim_desc;
+	int32_t			ret;
+
+	ret = uart_write(desc, data, bytes_number);
+	if (ret != SUCCESS)
+		return ret;
+
+	sim_desc = desc->extra;
+	sim_irq_raise(sim_desc->irq_desc, sim_desc->irq_id, IRQ_WRITE_DONE,
+		      NULL);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Check if UART errors occurred. The errors are cleared.
+ * @param desc - The UART descriptor.
+ * @return The errors, 0 if none.
+ */
+uint32_t uart_get_errors(struct uart_desc *desc)
+{
+	struct sim_uart_desc	*sim_desc;
+	uint32_t		errors;
+
+	if (!desc)
+		return 0;
+
+	sim_desc = desc->extra;
+	errors = sim_desc->errors;
+	sim_desc->errors = 0;
+
+	return errors;
+}
+
+/**
+ * @brief Serve the pending nonblocking read from the received data and raise
+ * IRQ_READ_DONE when it is complete. The callback may start a new read, which
+ * is served in the same call.
+ * @param desc - The UART descriptor.
+ * @return Number of bytes transferred, negative error code otherwise.
+ */
+int32_t sim_uart_poll(struct uart_desc *desc)
+{
+	struct sim_uart_desc	*sim_desc;
+	uint32_t		len;
+	int32_t			total;
+
+	if (!desc)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	total = 0;
+	sim_uart_fill(sim_desc);
+	while (sim_desc->rx_len && sim_desc->fifo_len) {
+		len = sim_uart_pop(sim_desc, sim_desc->rx_buff,
+				   sim_desc->rx_len);
+		sim_desc->rx_buff += len;
+		sim_desc->rx_len -= len;
+		total += len;
+		if (!sim_desc->rx_len)
+			sim_irq_raise(sim_desc->irq_desc, sim_desc->irq_id,
+				      IRQ_READ_DONE, NULL);
+		if (!sim_desc->fifo_len)
+			sim_uart_fill(sim_desc);
+	}
+
+	return total;
+}
+
+/**
+ * @brief Read the data received until the line went idle, as a DMA receive
+ * stopped by an idle line interrupt. Used instead of uart_read_nonblocking().
+ * @param desc - The UART descriptor.
+ * @param data - Destination of the data.
+ * @param size - Size of data.
+ * @return Number of bytes read, negative error code otherwise.
+ */
+int32_t sim_uart_idle_read(struct uart_desc *desc, uint8_t *data,
+			   uint32_t size)
+{
+	struct sim_uart_desc	*sim_desc;
+	uint32_t		len;
+	ssize_t			ret;
+
+	if (!desc || !data)
+		return -EINVAL;
+
+	sim_desc = desc->extra;
+	len = sim_uart_pop(sim_desc, data, size);
+	if (len == size)
+		return len;
+
+	ret = read(sim_desc->fd, data + len, size - len);
+	if (ret > 0)
+		len += ret;
+
+	return len;
+}
@@ -0,0 +1,108 @@
+/***************************************************************************//**
+ *   @file   sim/sim_uart.h
+ *   @brief  Header file of the simulated UART.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef SIM_UART_H_
+#define SIM_UART_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include "uart.h"
+#include "irq.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Size of the receive FIFO of the simulated UART */
+#define SIM_UART_FIFO_SIZE	1024
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct sim_uart_init_param
+ * @brief Simulated UART parameters, passed in uart_init_param.extra.
+ */
+struct sim_uart_init_param {
+	/** Host file descriptor, e.g. the slave side of a pseudo terminal */
+	int			fd;
+	/** Interrupt controller where the UART events are raised */
+	struct irq_ctrl_desc	*irq_desc;
+	/** Interrupt line of the UART */
+	uint32_t		irq_id;
+};
+
+/**
+ * @struct sim_uart_desc
+ * @brief Simulated UART state, kept in uart_desc.extra.
+ */
+struct sim_uart_desc {
+	/** Host file descriptor */
+	int			fd;
+	/** Interrupt controller where the UART events are raised */
+	struct irq_ctrl_desc	*irq_desc;
+	/** Interrupt line of the UART */
+	uint32_t		irq_id;
+	/** Buffer of the pending uart_read_nonblocking() */
+	uint8_t			*rx_buff;
+	/** Bytes left to complete the pending uart_read_nonblocking() */
+	uint32_t		rx_len;
+	/** Receive FIFO */
+	uint8_t			fifo[SIM_UART_FIFO_SIZE];
+	/** Index of the first byte in the receive FIFO */
+	uint32_t		fifo_start;
+	/** Number of bytes in the receive FIFO */
+	uint32_t		fifo_len;
+	/** Errors reported by uart_get_errors() */
+	uint32_t		errors;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Serve the pending nonblocking read and raise its interrupt when done. */
+int32_t sim_uart_poll(struct uart_desc *desc);
+
+/* Read the data received until the line went idle. */
+int32_t sim_uart_idle_read(struct uart_desc *desc, uint8_t *data,
+			   uint32_t size);
+
+#endif // SIM_UART_H_
@@ -35,12 +35,13 @@
 #include <xparameters.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
+#include "util.h"
 #include "uart.h"
 #include "uart_extra.h"
 #ifdef XPAR_XUARTPS_NUM_INSTANCES
 #include "irq.h"
-#include "fifo.h"
 #include <xil_exception.h>
 #include <xuartps.h>
 #endif
@@ -61,49 +62,62 @@
 
 #ifdef XUARTPS_H
 /**
- * @brief Save received data into fifo.
- * @param desc - Instance descriptor containing a fifo element.
- * @return SUCCESS in case of success, FAILURE otherwise.
+ * @brief Move the received data to the ring and restart the reception.
+ *
+ * Called from the interrupt handler. The bytes that do not fit in the ring
+ * are dropped and counted in rx_dropped.
+ * @param xil_uart_desc - Xilinx UART descriptor.
+ * @param len - Number of bytes received in the UART buffer.
  */
-static int32_t uart_fifo_insert(struct uart_desc *desc)
+static void uart_ps_rx(struct xil_uart_desc *xil_uart_desc, uint32_t len)
 {
-	int32_t ret;
-	struct xil_uart_desc *xil_uart_desc = desc->extra;
-	struct irq_ctrl_desc *irq_desc = xil_uart_desc->irq_desc;
+	struct cb_region regions[2];
+	uint32_t i, n, written = 0;
+
+	cb_peek_write(xil_uart_desc->rx_cb, regions);
+	for (i = 0; i < 2; i++) {
+		n = min(len - written, regions[i].size);
+		memcpy(regions[i].buff, xil_uart_desc->buff + written, n);
+		written += n;
+	}
+	cb_commit_write(xil_uart_desc->rx_cb, written);
+	xil_uart_desc->rx_dropped += len - written;
 
-	if (xil_uart_desc->bytes_received > 0) {
-		ret = irq_disable(irq_desc, xil_uart_desc->irq_id);
-		if (ret < 0)
-			return ret;
-		ret = fifo_insert(&xil_uart_desc->fifo, xil_uart_desc->buff,
-				  xil_uart_desc->bytes_received);
-		if (ret < 0)
-			return ret;
-		xil_uart_desc->bytes_received = 0;
-		switch(xil_uart_desc->type) {
-		case UART_PS:
-			XUartPs_Recv(xil_uart_desc->instance, (u8*)(xil_uart_desc->buff),
-				     UART_BUFF_LENGTH);
-			break;
-		case UART_PL:
+	XUartPs_Recv(xil_uart_desc->instance, (u8*)(xil_uart_desc->buff),
+		     UART_BUFF_LENGTH);
+}
 
-			break;
-		default:
-			return FAILURE;
-			break;
+/**
+ * @brief Read data received by the PS UART.
+ * @param xil_uart_desc - Xilinx UART descriptor.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to read.
+ * @return Number of bytes read.
+ */
+static int32_t uart_ps_read(struct xil_uart_desc *xil_uart_desc, uint8_t *data,
+			    uint32_t bytes_number)
+{
+	struct cb_region regions[2];
+	uint32_t i = 0, j, n;
+
+	/* Wait until the interrupt handler receives all the bytes */
+	while (i < bytes_number) {
+		cb_peek_read(xil_uart_desc->rx_cb, regions);
+		for (j = 0; j < 2; j++) {
+			n = min(bytes_number - i, regions[j].size);
+			memcpy(data + i, regions[j].buff, n);
+			cb_commit_read(xil_uart_desc->rx_cb, n);
+			i += n;
 		}
-		ret = irq_enable(irq_desc, xil_uart_desc->irq_id);
-		if (ret < 0)
-			return ret;
 	}
 
-	return SUCCESS;
+	return bytes_number;
 }
 #endif // XUARTPS_H
 
 /**
- * @brief Read byte from fifo.
- * @param desc - Instance descriptor containing a fifo element
+ * @brief Read byte from the PL UART.
+ * @param desc - Instance descriptor.
  * @param data - read value.
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
@@ -113,29 +127,8 @@ static int32_t uart_read_byte(struct uart_desc *desc, uint8_t *data)
 #ifdef XUARTLITE_H
 	XUartLite *instance = xil_uart_desc->instance;
 #endif
-#ifdef XUARTPS_H
-	int32_t ret;
-#endif
 
 	switch(xil_uart_desc->type) {
-	case UART_PS:
-#ifdef XUARTPS_H
-		while (xil_uart_desc->fifo == NULL) {
-			/* nothing in fifo, wait until something is received */
-			ret = uart_fifo_insert(desc);
-			if (ret < 0)
-				return ret;
-		}
-
-		*data = xil_uart_desc->fifo->data[xil_uart_desc->fifo_read_offset];
-		xil_uart_desc->fifo_read_offset++;
-
-		if (xil_uart_desc->fifo->len - xil_uart_desc->fifo_read_offset <= 0) {
-			xil_uart_desc->fifo_read_offset = 0;
-			xil_uart_desc->fifo = fifo_remove(xil_uart_desc->fifo);
-		}
-#endif // XUARTPS_H
-		break;
 	case UART_PL:
 #ifdef XUARTLITE_H
 		while (!(Xil_In32(instance->RegBaseAddress + XUL_STATUS_REG_OFFSET) &
@@ -160,6 +153,14 @@ static int32_t uart_read_byte(struct uart_desc *desc, uint8_t *data)
 int32_t uart_read(struct uart_desc *desc, uint8_t *data, uint32_t bytes_number)
 {
 	ssize_t ret;
+
+#ifdef XUARTPS_H
+	struct xil_uart_desc *xil_uart_desc = desc->extra;
+
+	if (xil_uart_desc->type == UART_PS)
+		return uart_ps_read(xil_uart_desc, data, bytes_number);
+#endif // XUARTPS_H
+
 	for (uint32_t i = 0; i < bytes_number; i++) {
 		ret = uart_read_byte(desc, &data[i]);
 		if (ret < 0)
@@ -242,7 +243,7 @@ static void uart_irq_handler(void *call_back_ref, uint32_t event,
 		 * timeout just indicates the data stopped for configured character time
 		 */
 		case XUARTPS_EVENT_RECV_TOUT:
-			xil_uart_desc->bytes_received = data_len;
+			uart_ps_rx(xil_uart_desc, data_len);
 			break;
 		/*
 		 * Data was received with an error, keep the data but determine
@@ -396,9 +397,17 @@ int32_t uart_init(struct uart_desc **desc, struct uart_init_param *param)
 		 */
 		XUartPs_SetRecvTimeout(xil_uart_desc->instance, 8);
 
+		status = cb_init_with_buff(&xil_uart_desc->rx_cb,
+					   xil_uart_desc->rx_buff,
+					   UART_RX_BUFF_SIZE);
+		if (status != SUCCESS)
+			goto error_free_instance;
+
 		status = uart_irq_init(descriptor);
-		if (status != XST_SUCCESS)
+		if (status != XST_SUCCESS) {
+			cb_remove(xil_uart_desc->rx_cb);
 			goto error_free_instance;
+		}
 
 		*desc = descriptor;
 
@@ -453,6 +462,7 @@ error_free_descriptor:
 int32_t uart_remove(struct uart_desc *desc)
 {
 	struct xil_uart_desc *xil_uart_desc = desc->extra;
+	cb_remove(xil_uart_desc->rx_cb);
 	free(xil_uart_desc->instance);
 	free(xil_uart_desc);
 	free(desc);
@@ -44,11 +44,15 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include "circular_buffer.h"
+
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 
 #define UART_BUFF_LENGTH 256
+/* Received bytes waiting for uart_read(), a power of 2 for the lock-free ring */
+#define UART_RX_BUFF_SIZE 1024
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -90,16 +94,16 @@ struct xil_uart_desc {
 	uint32_t			irq_id;
 	/** Interrupt Request Descriptor */
 	struct irq_ctrl_desc *irq_desc;
-	/** FIFO */
-	struct fifo_element	*fifo;
-	/** FIFO read offset */
-	uint32_t 			fifo_read_offset;
+	/** Received bytes, filled by the interrupt handler */
+	struct circular_buffer	*rx_cb;
+	/** Storage of the received bytes */
+	uint8_t				rx_buff[UART_RX_BUFF_SIZE];
 	/** UART Buffer */
 	char 				buff[UART_BUFF_LENGTH];
-	/** Number of bytes received */
-	uint32_t 			bytes_received;
 	/** Total number of errors */
 	uint32_t 			total_error_count;
+	/** Received bytes dropped because rx_cb was full */
+	uint32_t			rx_dropped;
 	/** UART Instance */
 	void				*instance;
 };
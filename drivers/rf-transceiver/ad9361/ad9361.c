@@ -684,6 +684,268 @@ const char *ad9361_ensm_states[] = {
 	"rx", "rx_flush", "fdd", "fdd_flush"
 };
 
+/*
+ * Registers updated by the device: status, RSSI, ENSM, calibration results
+ * and table read ports. They are always read from the device.
+ */
+static const struct {
+	uint16_t first;
+	uint16_t last;
+} ad9361_volatile_regs[] = {
+	{REG_SPI_CONF, REG_SPI_CONF},
+	{REG_START_TEMP_READING, REG_TEMPERATURE},
+	{REG_ENSM_MODE, REG_STATE},
+	{REG_AUXADC_WORD_MSB, REG_AUXADC_LSB},
+	{REG_CH_1_OVERFLOW, REG_CH_2_OVERFLOW},
+	{REG_TX_FILTER_COEF_READ_DATA_1, REG_TX_FILTER_COEF_READ_DATA_2},
+	{REG_TX_RSSI1, REG_TX_RSSI_LSB},
+	{REG_TX1_OUT_1_PHASE_CORR, REG_TX2_OUT_2_OFFSET_Q},
+	{REG_QUAD_CAL_STATUS_TX1, REG_QUAD_CAL_COUNT},
+	{REG_TXBBF_OPAMP_A, REG_TX_BBF_TUNE_MODE},
+	{REG_RX_FILTER_COEF_READ_DATA_1, REG_RX_FILTER_COEF_READ_DATA_2},
+	{REG_GAIN_TABLE_READ_DATA1, REG_GAIN_TABLE_READ_DATA3},
+	{REG_GM_SUB_TABLE_GAIN_READ, REG_GM_SUB_TABLE_CTRL_READ},
+	{REG_GAIN_ERROR_READ, REG_GAIN_ERROR_READ},
+	{REG_LNA_GAIN_DIFF_READ_BACK, REG_LNA_GAIN_DIFF_READ_BACK},
+	{REG_CAL_TEMP_SENSOR_WORD, REG_CAL_TEMP_SENSOR_WORD},
+	{REG_CH1_ADC_POWER, REG_CH2_RX_FILTER_POWER},
+	{REG_RX1_INPUT_A_PHASE_CORR, REG_RX2_INPUT_BC_I_OFFSET},
+	{REG_RX1_BB_DC_WORD_I_MSB, REG_RX_PATH_GAIN_LSB},
+	{REG_INPUT_A_MSBS, REG_INPUTS_BC_MSBS},
+	{REG_RX_TIA_CONFIG, REG_RX_BBBW_KHZ},
+	{REG_RESET, REG_RESET},
+	{REG_RX_FORCE_ALC, REG_RX_ALC_VARACTOR},
+	{REG_RX_CAL_STATUS, REG_RX_CAL_STATUS},
+	{REG_RX_CP_OVERRANGE_VCO_LOCK, REG_RX_CP_OVERRANGE_VCO_LOCK},
+	{REG_RX_FAST_LOCK_PROGRAM_READ, REG_RX_FAST_LOCK_PROGRAM_READ},
+	{REG_TX_FORCE_ALC, REG_TX_ALCVARACT_OR},
+	{REG_TX_CAL_STATUS, REG_TX_CAL_STATUS},
+	{REG_TX_CP_OVERRANGE_VCO_LOCK, REG_TX_CP_OVERRANGE_VCO_LOCK},
+	{REG_DCXO_TEMPCO_READ, REG_DCXO_TEMPCO_READ},
+	{REG_DELTA_T_READ, REG_DELTA_T_READ},
+	{REG_TX_FAST_LOCK_PROGRAM_READ, REG_TX_FAST_LOCK_PROGRAM_READ},
+	{REG_GAIN_RX1, REG_OVRG_SIGS_RX2},
+};
+
+/**
+ * Get the register cache of a device.
+ * @param spi The SPI descriptor of the device.
+ * @return The register cache or NULL if the device has none.
+ */
+static inline struct ad9361_regcache *ad9361_regcache_get(struct spi_desc *spi)
+{
+	return spi->drv_data;
+}
+
+/**
+ * Allocate the register cache of a device. The cache is write-through:
+ * writes always reach the device, unless ad9361_regcache_cache_only() is
+ * enabled, and reads of non-volatile registers that were written or read
+ * before are served without a SPI transaction.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_regcache_init(struct ad9361_rf_phy *phy)
+{
+	struct ad9361_regcache *cache;
+	uint32_t i, reg;
+
+	cache = calloc(1, sizeof(*cache));
+	if (!cache)
+		return -ENOMEM;
+
+	for (i = 0; i < ARRAY_SIZE(ad9361_volatile_regs); i++)
+		for (reg = ad9361_volatile_regs[i].first;
+		     reg <= ad9361_volatile_regs[i].last; reg++)
+			cache->flags[reg] = AD9361_REGCACHE_VOLATILE;
+
+	/* Kept with the SPI descriptor, the only argument of the accessors */
+	phy->spi->drv_data = cache;
+	phy->regcache = cache;
+
+	return 0;
+}
+
+/**
+ * Free the register cache of a device.
+ * @param phy The AD9361 state structure.
+ */
+void ad9361_regcache_remove(struct ad9361_rf_phy *phy)
+{
+	if (!phy->regcache)
+		return;
+
+	phy->spi->drv_data = NULL;
+	free(phy->regcache);
+	phy->regcache = NULL;
+}
+
+/**
+ * Forget the cached values, after a reset of the device.
+ * @param phy The AD9361 state structure.
+ */
+void ad9361_regcache_drop(struct ad9361_rf_phy *phy)
+{
+	uint32_t reg;
+
+	if (!phy->regcache)
+		return;
+
+	for (reg = 0; reg < AD9361_NUM_REGS; reg++)
+		phy->regcache->flags[reg] &= AD9361_REGCACHE_VOLATILE;
+}
+
+/**
+ * Mark all the cached registers dirty, so that ad9361_regcache_sync() writes
+ * them to the device. Restores the state of the device after a reset.
+ * @param phy The AD9361 state structure.
+ */
+void ad9361_regcache_mark_dirty(struct ad9361_rf_phy *phy)
+{
+	uint32_t reg;
+
+	if (!phy->regcache)
+		return;
+
+	for (reg = 0; reg < AD9361_NUM_REGS; reg++)
+		if (phy->regcache->flags[reg] & AD9361_REGCACHE_VALID)
+			phy->regcache->flags[reg] |= AD9361_REGCACHE_DIRTY;
+}
+
+/**
+ * Enable/disable deferring the register writes to ad9361_regcache_sync().
+ * Writes of volatile registers are never deferred.
+ * @param phy The AD9361 state structure.
+ * @param enable Enable/disable option.
+ */
+void ad9361_regcache_cache_only(struct ad9361_rf_phy *phy, bool enable)
+{
+	if (phy->regcache)
+		phy->regcache->cache_only = enable;
+}
+
+/**
+ * Write the dirty registers to the device, with a single SPI batch.
+ * @param phy The AD9361 state structure.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_regcache_sync(struct ad9361_rf_phy *phy)
+{
+	struct ad9361_regcache *cache = phy->regcache;
+	bool cache_only;
+	uint32_t reg;
+	int32_t ret;
+
+	if (!cache)
+		return 0;
+
+	ret = spi_batch_begin(phy->spi);
+	if (ret < 0)
+		return ret;
+
+	cache_only = cache->cache_only;
+	cache->cache_only = false;
+	for (reg = 0; reg < AD9361_NUM_REGS; reg++) {
+		if (!(cache->flags[reg] & AD9361_REGCACHE_DIRTY))
+			continue;
+		ret = ad9361_spi_write(phy->spi, reg, cache->val[reg]);
+		if (ret < 0)
+			break;
+	}
+	cache->cache_only = cache_only;
+
+	if (ret < 0) {
+		spi_batch_end(phy->spi);
+		return ret;
+	}
+
+	return spi_batch_end(phy->spi);
+}
+
+/**
+ * Get the number of SPI transactions and of register reads served from the
+ * cache since the device was initialized or ad9361_regcache_reset_stats().
+ * @param phy The AD9361 state structure.
+ * @param spi_reads The number of SPI read transactions.
+ * @param spi_writes The number of SPI write transactions.
+ * @param cache_hits The number of register reads served from the cache.
+ */
+void ad9361_regcache_get_stats(struct ad9361_rf_phy *phy, uint32_t *spi_reads,
+			       uint32_t *spi_writes, uint32_t *cache_hits)
+{
+	struct ad9361_regcache *cache = phy->regcache;
+
+	*spi_reads = cache ? cache->spi_reads : 0;
+	*spi_writes = cache ? cache->spi_writes : 0;
+	*cache_hits = cache ? cache->cache_hits : 0;
+}
+
+/**
+ * Reset the statistics of ad9361_regcache_get_stats().
+ * @param phy The AD9361 state structure.
+ */
+void ad9361_regcache_reset_stats(struct ad9361_rf_phy *phy)
+{
+	if (!phy->regcache)
+		return;
+
+	phy->regcache->spi_reads = 0;
+	phy->regcache->spi_writes = 0;
+	phy->regcache->cache_hits = 0;
+}
+
+/**
+ * Read registers from the cache.
+ * @param cache The register cache.
+ * @param reg The address of the first register, the next ones are read
+ * 	      at decreasing addresses.
+ * @param rbuf The data buffer.
+ * @param num The number of registers.
+ * @return true if all the registers were in the cache.
+ */
+static bool ad9361_regcache_read(struct ad9361_regcache *cache, uint32_t reg,
+				 uint8_t *rbuf, uint32_t num)
+{
+	uint32_t i, r;
+
+	for (i = 0; i < num; i++) {
+		r = AD_ADDR(reg - i);
+		if ((cache->flags[r] & (AD9361_REGCACHE_VALID |
+					AD9361_REGCACHE_VOLATILE)) !=
+		    AD9361_REGCACHE_VALID)
+			return false;
+	}
+
+	for (i = 0; i < num; i++)
+		rbuf[i] = cache->val[AD_ADDR(reg - i)];
+
+	return true;
+}
+
+/**
+ * Update the cache with values written to or read from the device.
+ * @param cache The register cache.
+ * @param reg The address of the first register, the next ones are at
+ * 	      decreasing addresses.
+ * @param buf The register values.
+ * @param num The number of registers.
+ * @param flags AD9361_REGCACHE_DIRTY if the values weren't written.
+ */
+static void ad9361_regcache_update(struct ad9361_regcache *cache, uint32_t reg,
+				   const uint8_t *buf, uint32_t num,
+				   uint8_t flags)
+{
+	uint32_t i, r;
+
+	for (i = 0; i < num; i++) {
+		r = AD_ADDR(reg - i);
+		if (cache->flags[r] & AD9361_REGCACHE_VOLATILE)
+			continue;
+		cache->val[r] = buf[i];
+		cache->flags[r] = AD9361_REGCACHE_VALID | flags;
+	}
+}
+
 /**
  * SPI multiple bytes register read.
  * @param spi
@@ -695,26 +957,41 @@ const char *ad9361_ensm_states[] = {
 int32_t ad9361_spi_readm(struct spi_desc *spi, uint32_t reg,
 			 uint8_t *rbuf, uint32_t num)
 {
+	struct ad9361_regcache *cache = ad9361_regcache_get(spi);
+	uint8_t rbuffer[MAX_MBYTE_SPI + 2];
 	int32_t ret = 0;
+	uint32_t i, r;
 	uint16_t cmd;
-	uint8_t *rbuffer;
 	if (num > MAX_MBYTE_SPI)
 		return -EINVAL;
 
+	if (cache && ad9361_regcache_read(cache, reg, rbuf, num)) {
+		cache->cache_hits++;
+		return 0;
+	}
+
 	cmd = AD_READ | AD_CNT(num) | AD_ADDR(reg);
-	rbuffer = malloc(num + 2);
-	if(!rbuffer)
-		return -ENOMEM;
 	rbuffer[0] = cmd >> 8;
 	rbuffer[1] = cmd & 0xFF;
 	ret = spi_write_and_read(spi, &rbuffer[0], 2 + num);
 
-	if (ret < 0)
+	if (ret < 0) {
 		dev_err(&spi->dev, "Read Error %"PRId32, ret);
-	else
-		memcpy(rbuf, &rbuffer[2], num);
+		return ret;
+	}
+
+	if (cache) {
+		cache->spi_reads++;
+		/* Deferred writes are newer than the device content */
+		for (i = 0; i < num; i++) {
+			r = AD_ADDR(reg - i);
+			if (cache->flags[r] & AD9361_REGCACHE_DIRTY)
+				rbuffer[2 + i] = cache->val[r];
+		}
+		ad9361_regcache_update(cache, reg, &rbuffer[2], num, 0);
+	}
 
-	free(rbuffer);
+	memcpy(rbuf, &rbuffer[2], num);
 #ifdef _DEBUG
 	{
 		int32_t i;
@@ -792,7 +1069,9 @@ static int32_t __ad9361_spi_readf(struct spi_desc *spi, uint32_t reg,
 int32_t ad9361_spi_write(struct spi_desc *spi,
 			 uint32_t reg, uint32_t val)
 {
+	struct ad9361_regcache *cache = ad9361_regcache_get(spi);
 	uint8_t buf[3];
+	uint32_t i;
 	int32_t ret;
 	uint16_t cmd;
 
@@ -801,14 +1080,30 @@ int32_t ad9361_spi_write(struct spi_desc *spi,
 	buf[1] = cmd & 0xFF;
 	buf[2] = val;
 
-	ret = spi_write_and_read(spi, buf, 3);
+	if (cache) {
+		if (cache->cache_only &&
+		    !(cache->flags[AD_ADDR(reg)] & AD9361_REGCACHE_VOLATILE)) {
+			ad9361_regcache_update(cache, reg, &buf[2], 1,
+					       AD9361_REGCACHE_DIRTY);
+			return 0;
+		}
+		/* A soft reset restores the default values */
+		if (AD_ADDR(reg) == REG_SPI_CONF && (val & SOFT_RESET))
+			for (i = 0; i < AD9361_NUM_REGS; i++)
+				cache->flags[i] &= AD9361_REGCACHE_VOLATILE;
+		else
+			ad9361_regcache_update(cache, reg, &buf[2], 1, 0);
+		cache->spi_writes++;
+	}
+
+	ret = spi_batch_write(spi, buf, 3);
 	if (ret < 0) {
 		dev_err(&spi->dev, "Write Error %"PRId32, ret);
 		return ret;
 	}
 
 #ifdef _DEBUG
-	dev_dbg(&spi->dev, "%s: reg 0x%"PRIX32" val 0x%X", __func__, reg, buf[2]);
+	dev_dbg(&spi->dev, "%s: reg 0x%"PRIX32" val 0x%X", __func__, reg, (uint8_t)val);
 #endif
 
 	return 0;
@@ -864,13 +1159,32 @@ static int32_t __ad9361_spi_writef(struct spi_desc *spi, uint32_t reg,
 static int32_t ad9361_spi_writem(struct spi_desc *spi,
 				 uint32_t reg, uint8_t *tbuf, uint32_t num)
 {
+	struct ad9361_regcache *cache;
 	uint8_t buf[10];
+	uint32_t i;
 	int32_t ret;
 	uint16_t cmd;
 
 	if (num > MAX_MBYTE_SPI)
 		return -EINVAL;
 
+	cache = ad9361_regcache_get(spi);
+	if (cache) {
+		if (cache->cache_only) {
+			for (i = 0; i < num; i++)
+				if (cache->flags[AD_ADDR(reg - i)] &
+				    AD9361_REGCACHE_VOLATILE)
+					break;
+			if (i == num) {
+				ad9361_regcache_update(cache, reg, tbuf, num,
+						       AD9361_REGCACHE_DIRTY);
+				return 0;
+			}
+		}
+		ad9361_regcache_update(cache, reg, tbuf, num, 0);
+		cache->spi_writes++;
+	}
+
 	cmd = AD_WRITE | AD_CNT(num) | AD_ADDR(reg);
 	buf[0] = cmd >> 8;
 	buf[1] = cmd & 0xFF;
@@ -878,11 +1192,10 @@ static int32_t ad9361_spi_writem(struct spi_desc *spi,
 #ifndef ALTERA_PLATFORM
 	memcpy(&buf[2], tbuf, num);
 #else
-	int32_t i;
 	for (i = 0; i < num; i++)
 		buf[2 + i] =  tbuf[i];
 #endif
-	ret = spi_write_and_read(spi, buf, num + 2);
+	ret = spi_batch_write(spi, buf, num + 2);
 	if (ret < 0) {
 		dev_err(&spi->dev, "Write Error %"PRId32, ret);
 		return ret;
@@ -899,6 +1212,160 @@ static int32_t ad9361_spi_writem(struct spi_desc *spi,
 	return 0;
 }
 
+/**
+ * Allocate the buffer of a SPI command stream.
+ * @param stream The stream.
+ * @param size The size of the buffer [bytes].
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_stream_alloc(struct ad9361_spi_stream *stream,
+				   uint32_t size)
+{
+	uint8_t *buff;
+
+	if (stream->size < size) {
+		buff = realloc(stream->buff, size);
+		if (!buff)
+			return -ENOMEM;
+		stream->buff = buff;
+		stream->size = size;
+	}
+	stream->len = 0;
+	stream->nb_cmds = 0;
+
+	return 0;
+}
+
+/**
+ * Append a multiple bytes register write to a SPI command stream.
+ * @param stream The stream.
+ * @param reg The register address.
+ * @param tbuf The data buffer.
+ * @param num The number of bytes to write.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_stream_writem(struct ad9361_spi_stream *stream,
+				    uint32_t reg, const uint8_t *tbuf,
+				    uint32_t num)
+{
+	uint16_t cmd;
+
+	if (num > MAX_MBYTE_SPI)
+		return -EINVAL;
+	if (stream->len + num + 2 > stream->size)
+		return -ENOMEM;
+
+	cmd = AD_WRITE | AD_CNT(num) | AD_ADDR(reg);
+	stream->buff[stream->len++] = cmd >> 8;
+	stream->buff[stream->len++] = cmd & 0xFF;
+	memcpy(&stream->buff[stream->len], tbuf, num);
+	stream->len += num;
+	stream->nb_cmds++;
+
+	return 0;
+}
+
+/**
+ * Append a register write to a SPI command stream.
+ * @param stream The stream.
+ * @param reg The register address.
+ * @param val The value of the register.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_stream_write(struct ad9361_spi_stream *stream,
+				   uint32_t reg, uint8_t val)
+{
+	return ad9361_stream_writem(stream, reg, &val, 1);
+}
+
+/**
+ * Send a SPI command stream with a single spi_transfer(), one message per
+ * command. The stream is left unchanged, so it can be sent again. The
+ * register cache is updated, but the writes are not deferred by
+ * ad9361_regcache_cache_only().
+ * @param phy The AD9361 state structure.
+ * @param stream The stream.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_stream_submit(struct ad9361_rf_phy *phy,
+				    struct ad9361_spi_stream *stream)
+{
+	struct ad9361_regcache *cache = phy->regcache;
+	struct spi_msg *msgs;
+	uint32_t i, num, pos;
+	uint8_t *buff;
+	int32_t ret;
+
+	if (!stream->nb_cmds)
+		return 0;
+
+	if (phy->stream_max_msgs < stream->nb_cmds) {
+		msgs = realloc(phy->stream_msgs,
+			       stream->nb_cmds * sizeof(*msgs));
+		if (!msgs)
+			return -ENOMEM;
+		phy->stream_msgs = msgs;
+		phy->stream_max_msgs = stream->nb_cmds;
+	}
+	if (phy->stream_size < stream->len) {
+		buff = realloc(phy->stream_buff, stream->len);
+		if (!buff)
+			return -ENOMEM;
+		phy->stream_buff = buff;
+		phy->stream_size = stream->len;
+	}
+
+	/* The transfer overwrites the buffer with the data read back */
+	memcpy(phy->stream_buff, stream->buff, stream->len);
+
+	msgs = phy->stream_msgs;
+	for (i = 0, pos = 0; i < stream->nb_cmds; i++) {
+		buff = &stream->buff[pos];
+		num = ((buff[0] >> 4) & 0x7) + 1;
+		msgs[i].tx_buff = &phy->stream_buff[pos];
+		msgs[i].rx_buff = &phy->stream_buff[pos];
+		msgs[i].bytes_number = num + 2;
+		msgs[i].cs_change = 1;
+		if (cache) {
+			ad9361_regcache_update(cache,
+					       AD_ADDR((buff[0] << 8) | buff[1]),
+					       &buff[2], num, 0);
+			cache->spi_writes++;
+		}
+		pos += num + 2;
+	}
+
+	ret = spi_transfer(phy->spi, msgs, stream->nb_cmds);
+	if (ret < 0) {
+		dev_err(&phy->spi->dev, "Write Error %"PRId32, ret);
+		return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * Free the SPI command streams and their transfer buffers.
+ * @param phy The AD9361 state structure.
+ * @return None.
+ */
+void ad9361_streams_remove(struct ad9361_rf_phy *phy)
+{
+	uint32_t i;
+
+	for (i = 0; i < phy->gt_stream_num; i++)
+		free(phy->gt_stream[i].buff);
+	free(phy->gt_stream);
+	free(phy->stream_msgs);
+	free(phy->stream_buff);
+	phy->gt_stream = NULL;
+	phy->gt_stream_num = 0;
+	phy->stream_msgs = NULL;
+	phy->stream_max_msgs = 0;
+	phy->stream_buff = NULL;
+	phy->stream_size = 0;
+}
+
 /**
  * Validate RF BW frequency.
  * @param phy The AD9361 state structure.
@@ -1009,6 +1476,8 @@ int32_t ad9361_1rx1tx_channel_map(struct ad9361_rf_phy *phy, bool tx,
  */
 int32_t ad9361_reset(struct ad9361_rf_phy *phy)
 {
+	ad9361_regcache_drop(phy);
+
 	if (phy->gpio_desc_resetb) {
 		gpio_set_value(phy->gpio_desc_resetb, 0);
 		mdelay(1);
@@ -1399,6 +1868,88 @@ static int find_table_index(struct ad9361_rf_phy *phy, int gain)
 	return -EINVAL;
 }
 
+/**
+ * Get the SPI command stream that loads a gain table, building it the first
+ * time. Each row is written with the gain table clock running, followed by
+ * two dummy writes that give the device the required delay, so the whole
+ * table is sent with a single transfer.
+ * @param phy The AD9361 state structure.
+ * @param band The index of the table in gt_info.
+ * @param dest The destination [GT_RX1, GT_RX2].
+ * @param stream Set to the stream.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_gt_stream_get(struct ad9361_rf_phy *phy, uint32_t band,
+				    uint32_t dest,
+				    struct ad9361_spi_stream **stream)
+{
+	struct ad9361_spi_stream *s;
+	uint8_t (*tab)[3];
+	uint32_t i, index_max, lna, tag;
+	int32_t ret;
+
+	if (!phy->gt_stream) {
+		for (i = 0; phy->gt_info[i].tab != NULL; i++);
+		phy->gt_stream = calloc(i, sizeof(*phy->gt_stream));
+		if (!phy->gt_stream)
+			return -ENOMEM;
+		phy->gt_stream_num = i;
+	}
+	if (band >= phy->gt_stream_num)
+		return -EINVAL;
+
+	lna = phy->pdata->elna_ctrl.elna_in_gaintable_all_index_en ?
+	      EXT_LNA_CTRL : 0;
+	tag = (lna << 8) | dest;
+
+	s = &phy->gt_stream[band];
+	*stream = s;
+	if (s->nb_cmds && s->tag == tag)
+		return 0;
+
+	tab = phy->gt_info[band].tab;
+	index_max = phy->gt_info[band].max_index;
+
+	/* 3 bytes per write, 7 writes per row plus 5 to start and stop */
+	ret = ad9361_stream_alloc(s, (7 * index_max + 5) * 3);
+	if (ret < 0)
+		return ret;
+
+	ad9361_stream_write(s, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
+			    RECEIVER_SELECT(dest)); /* Start Gain Table Clock */
+
+	for (i = 0; i < index_max; i++) {
+		ad9361_stream_write(s, REG_GAIN_TABLE_ADDRESS, i); /* Gain Table Index */
+		ad9361_stream_write(s, REG_GAIN_TABLE_WRITE_DATA1,
+				    tab[i][0] | lna); /* Ext LNA, Int LNA, & Mixer Gain Word */
+		ad9361_stream_write(s, REG_GAIN_TABLE_WRITE_DATA2,
+				    tab[i][1]); /* TIA & LPF Word */
+		ad9361_stream_write(s, REG_GAIN_TABLE_WRITE_DATA3,
+				    tab[i][2]); /* DC Cal bit & Dig Gain Word */
+		ad9361_stream_write(s, REG_GAIN_TABLE_CONFIG,
+				    START_GAIN_TABLE_CLOCK |
+				    WRITE_GAIN_TABLE |
+				    RECEIVER_SELECT(dest)); /* Gain Table Index */
+		ad9361_stream_write(s, REG_GAIN_TABLE_READ_DATA1,
+				    0); /* Dummy Write to delay 3 ADCCLK/16 cycles */
+		ad9361_stream_write(s, REG_GAIN_TABLE_READ_DATA1,
+				    0); /* Dummy Write to delay ~1u */
+	}
+
+	ad9361_stream_write(s, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
+			    RECEIVER_SELECT(dest)); /* Clear Write Bit */
+	ad9361_stream_write(s, REG_GAIN_TABLE_READ_DATA1,
+			    0); /* Dummy Write to delay ~1u */
+	ad9361_stream_write(s, REG_GAIN_TABLE_READ_DATA1,
+			    0); /* Dummy Write to delay ~1u */
+	ad9361_stream_write(s, REG_GAIN_TABLE_CONFIG,
+			    0); /* Stop Gain Table Clock */
+
+	s->tag = tag;
+
+	return 0;
+}
+
 /**
  * Load the gain table for the selected frequency range and receiver.
  * @param phy The AD9361 state structure.
@@ -1410,8 +1961,9 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 			      uint32_t dest)
 {
 	struct spi_desc *spi = phy->spi;
+	struct ad9361_spi_stream *stream;
 	uint8_t (*tab)[3];
-	uint32_t band, index_max, i, lna, lpf_tia_mask, set_gain;
+	uint32_t band, index_max, i, lpf_tia_mask, set_gain;
 	int32_t ret, rx1_gain, rx2_gain;
 
 	dev_dbg(&phy->spi->dev, "%s: frequency %"PRIu64, __func__, freq);
@@ -1458,12 +2010,6 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 		rx2_gain = phy->gt_info[band].abs_gain_tbl[set_gain];
 	}
 
-	lna = phy->pdata->elna_ctrl.elna_in_gaintable_all_index_en ?
-	      EXT_LNA_CTRL : 0;
-
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
-			 RECEIVER_SELECT(dest)); /* Start Gain Table Clock */
-
 	/* TX QUAD Calibration */
 	if (phy->pdata->split_gt)
 		lpf_tia_mask = 0x20;
@@ -1472,35 +2018,17 @@ static int32_t ad9361_load_gt(struct ad9361_rf_phy *phy, uint64_t freq,
 
 	phy->tx_quad_lpf_tia_match = -EINVAL;
 
-	for (i = 0; i < index_max; i++) {
-		ad9361_spi_write(spi, REG_GAIN_TABLE_ADDRESS, i); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA1,
-				 tab[i][0] | lna); /* Ext LNA, Int LNA, & Mixer Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA2,
-				 tab[i][1]); /* TIA & LPF Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_WRITE_DATA3,
-				 tab[i][2]); /* DC Cal bit & Dig Gain Word */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG,
-				 START_GAIN_TABLE_CLOCK |
-				 WRITE_GAIN_TABLE |
-				 RECEIVER_SELECT(dest)); /* Gain Table Index */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay 3 ADCCLK/16 cycles */
-		ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-				 0); /* Dummy Write to delay ~1u */
-
+	for (i = 0; i < index_max; i++)
 		if ((tab[i][1] & lpf_tia_mask) == 0x20)
 			phy->tx_quad_lpf_tia_match = i;
 
-	}
+	ret = ad9361_gt_stream_get(phy, band, dest, &stream);
+	if (ret < 0)
+		return ret;
 
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, START_GAIN_TABLE_CLOCK |
-			 RECEIVER_SELECT(dest)); /* Clear Write Bit */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-			 0); /* Dummy Write to delay ~1u */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_READ_DATA1,
-			 0); /* Dummy Write to delay ~1u */
-	ad9361_spi_write(spi, REG_GAIN_TABLE_CONFIG, 0); /* Stop Gain Table Clock */
+	ret = ad9361_stream_submit(phy, stream);
+	if (ret < 0)
+		return ret;
 
 	phy->current_table = band;
 
@@ -1567,9 +2095,13 @@ static int32_t ad9361_clkout_control(struct ad9361_rf_phy *phy,
  */
 static int32_t ad9361_load_mixer_gm_subtable(struct ad9361_rf_phy *phy)
 {
-	int32_t i, addr;
+	int32_t i, addr, ret;
 	dev_dbg(&phy->spi->dev, "%s", __func__);
 
+	ret = spi_batch_begin(phy->spi);
+	if (ret < 0)
+		return ret;
+
 	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_CONFIG,
 			 START_GM_SUB_TABLE_CLOCK); /* Start Clock */
 
@@ -1594,7 +2126,7 @@ static int32_t ad9361_load_mixer_gm_subtable(struct ad9361_rf_phy *phy)
 	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_GAIN_READ, 0); /* Dummy Delay */
 	ad9361_spi_write(phy->spi, REG_GM_SUB_TABLE_CONFIG, 0); /* Stop Clock */
 
-	return 0;
+	return spi_batch_end(phy->spi);
 }
 
 /**
@@ -1710,20 +2242,41 @@ static uint32_t ad9361_rfvco_tableindex(uint32_t freq)
 }
 
 /**
- * Initialize the RFPLL VCO.
+ * Check if the TDD VCO table has to be used for the RFPLLs. In FDD mode with
+ * RX LO == TX LO frequency the TDD table reduces VCO pulling.
+ * @param phy The AD9361 state structure.
+ * @param tx_lo The TX LO frequency.
+ * @param rx_lo The RX LO frequency.
+ * @return true if the TDD table has to be used.
+ */
+static bool ad9361_rfpll_use_tdd_table(struct ad9361_rf_phy *phy,
+				       uint64_t tx_lo, uint64_t rx_lo)
+{
+	if (phy->pdata->fdd && !phy->pdata->fdd_independent_mode &&
+	    tx_lo != rx_lo)
+		return false;
+
+	return have_tdd_tables;
+}
+
+/**
+ * Add the RFPLL VCO initialization to a SPI command stream.
  * @param phy The AD9361 state structure.
  * @param tx Set true for TX_RFPLL.
  * @param vco_freq The VCO frequency [Hz].
  * @param ref_clk The reference clock frequency [Hz].
- * @return 0 in case of success
+ * @param tdd_table Set true to use the TDD VCO table.
+ * @param stream The stream.
+ * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t ad9361_rfpll_vco_init(struct ad9361_rf_phy *phy,
 				     bool tx, uint64_t vco_freq,
-				     uint32_t ref_clk)
+				     uint32_t ref_clk, bool tdd_table,
+				     struct ad9361_spi_stream *stream)
 {
 	struct spi_desc *spi = phy->spi;
 	const struct SynthLUT(*tab);
-	int32_t i = 0;
+	int32_t i = 0, alc_varactor, cp_current;
 	uint32_t range, offs = 0;
 
 	range = ad9361_rfvco_tableindex(ref_clk);
@@ -1734,22 +2287,10 @@ static int32_t ad9361_rfpll_vco_init(struct ad9361_rf_phy *phy,
 
 	do_div(&vco_freq, 1000000UL); /* vco_freq in MHz */
 
-	if ((phy->pdata->fdd && !phy->pdata->fdd_independent_mode)
-	    && (phy->current_tx_lo_freq != phy->current_rx_lo_freq)) {
+	if (tdd_table)
+		tab = &SynthLUT_TDD[range][0];
+	else
 		tab = &SynthLUT_FDD[range][0];
-		if (tx)
-			phy->current_tx_use_tdd_table = false;
-		else
-			phy->current_rx_use_tdd_table = false;
-	} else {
-		if (have_tdd_tables) {
-			tab = &SynthLUT_TDD[range][0];
-			if (tx)
-				phy->current_tx_use_tdd_table = true;
-			else
-				phy->current_rx_use_tdd_table = true;
-		}
-	}
 
 	if (tx)
 		offs = REG_TX_VCO_OUTPUT - REG_RX_VCO_OUTPUT;
@@ -1760,37 +2301,165 @@ static int32_t ad9361_rfpll_vco_init(struct ad9361_rf_phy *phy,
 	dev_dbg(&phy->spi->dev, "%s : freq %d MHz : index %"PRId32,
 		__func__, tab[i].VCO_MHz, i);
 
-	ad9361_spi_write(spi, REG_RX_VCO_OUTPUT + offs,
-			 VCO_OUTPUT_LEVEL(tab[i].VCO_Output_Level) |
-			 PORB_VCO_LOGIC);
-	ad9361_spi_writef(spi, REG_RX_ALC_VARACTOR + offs,
-			  VCO_VARACTOR(~0), tab[i].VCO_Varactor);
-	ad9361_spi_write(spi, REG_RX_VCO_BIAS_1 + offs,
-			 VCO_BIAS_REF(tab[i].VCO_Bias_Ref) |
-			 VCO_BIAS_TCF(tab[i].VCO_Bias_Tcf));
-
-	ad9361_spi_write(spi, REG_RX_FORCE_VCO_TUNE_1 + offs,
-			 VCO_CAL_OFFSET(tab[i].VCO_Cal_Offset));
-	ad9361_spi_write(spi, REG_RX_VCO_VARACTOR_CTRL_1 + offs,
-			 VCO_VARACTOR_REFERENCE(
-				 tab[i].VCO_Varactor_Reference));
-
-	ad9361_spi_write(spi, REG_RX_VCO_CAL_REF + offs, VCO_CAL_REF_TCF(0));
-
-	ad9361_spi_write(spi, REG_RX_VCO_VARACTOR_CTRL_0 + offs,
-			 VCO_VARACTOR_OFFSET(0) |
-			 VCO_VARACTOR_REFERENCE_TCF(7));
-
-	ad9361_spi_writef(spi, REG_RX_CP_CURRENT + offs, CHARGE_PUMP_CURRENT(~0),
-			  tab[i].Charge_Pump_Current);
-	ad9361_spi_write(spi, REG_RX_LOOP_FILTER_1 + offs,
-			 LOOP_FILTER_C2(tab[i].LF_C2) |
-			 LOOP_FILTER_C1(tab[i].LF_C1));
-	ad9361_spi_write(spi, REG_RX_LOOP_FILTER_2 + offs,
-			 LOOP_FILTER_R1(tab[i].LF_R1) |
-			 LOOP_FILTER_C3(tab[i].LF_C3));
-	ad9361_spi_write(spi, REG_RX_LOOP_FILTER_3 + offs,
-			 LOOP_FILTER_R3(tab[i].LF_R3));
+	alc_varactor = ad9361_spi_read(spi, REG_RX_ALC_VARACTOR + offs);
+	if (alc_varactor < 0)
+		return alc_varactor;
+
+	cp_current = ad9361_spi_read(spi, REG_RX_CP_CURRENT + offs);
+	if (cp_current < 0)
+		return cp_current;
+
+	ad9361_stream_write(stream, REG_RX_VCO_OUTPUT + offs,
+			    VCO_OUTPUT_LEVEL(tab[i].VCO_Output_Level) |
+			    PORB_VCO_LOGIC);
+	ad9361_stream_write(stream, REG_RX_ALC_VARACTOR + offs,
+			    (alc_varactor & ~VCO_VARACTOR(~0)) |
+			    VCO_VARACTOR(tab[i].VCO_Varactor));
+	ad9361_stream_write(stream, REG_RX_VCO_BIAS_1 + offs,
+			    VCO_BIAS_REF(tab[i].VCO_Bias_Ref) |
+			    VCO_BIAS_TCF(tab[i].VCO_Bias_Tcf));
+
+	ad9361_stream_write(stream, REG_RX_FORCE_VCO_TUNE_1 + offs,
+			    VCO_CAL_OFFSET(tab[i].VCO_Cal_Offset));
+	ad9361_stream_write(stream, REG_RX_VCO_VARACTOR_CTRL_1 + offs,
+			    VCO_VARACTOR_REFERENCE(
+				    tab[i].VCO_Varactor_Reference));
+
+	ad9361_stream_write(stream, REG_RX_VCO_CAL_REF + offs,
+			    VCO_CAL_REF_TCF(0));
+
+	ad9361_stream_write(stream, REG_RX_VCO_VARACTOR_CTRL_0 + offs,
+			    VCO_VARACTOR_OFFSET(0) |
+			    VCO_VARACTOR_REFERENCE_TCF(7));
+
+	ad9361_stream_write(stream, REG_RX_CP_CURRENT + offs,
+			    (cp_current & ~CHARGE_PUMP_CURRENT(~0)) |
+			    CHARGE_PUMP_CURRENT(tab[i].Charge_Pump_Current));
+	ad9361_stream_write(stream, REG_RX_LOOP_FILTER_1 + offs,
+			    LOOP_FILTER_C2(tab[i].LF_C2) |
+			    LOOP_FILTER_C1(tab[i].LF_C1));
+	ad9361_stream_write(stream, REG_RX_LOOP_FILTER_2 + offs,
+			    LOOP_FILTER_R1(tab[i].LF_R1) |
+			    LOOP_FILTER_C3(tab[i].LF_C3));
+
+	return ad9361_stream_write(stream, REG_RX_LOOP_FILTER_3 + offs,
+				   LOOP_FILTER_R3(tab[i].LF_R3));
+}
+
+/**
+ * Build the SPI command stream that tunes a RFPLL: the VCO initialization,
+ * the synthesizer words and the VCO divider.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @param vco_freq The VCO frequency [Hz].
+ * @param ref_clk The reference clock frequency [Hz].
+ * @param integer The integer value.
+ * @param fract The fractional value.
+ * @param vco_div The VCO divider.
+ * @param tdd_table Set true to use the TDD VCO table.
+ * @param stream The stream, with at least AD9361_RFPLL_IMAGE_SIZE bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_rfpll_tune_stream(struct ad9361_rf_phy *phy, bool tx,
+					uint64_t vco_freq, uint32_t ref_clk,
+					uint32_t integer, uint32_t fract,
+					int32_t vco_div, bool tdd_table,
+					struct ad9361_spi_stream *stream)
+{
+	uint32_t reg, div_mask;
+	int32_t ret, integer_1, dividers;
+	uint8_t buf[5];
+
+	if (tx) {
+		reg = REG_TX_FRACT_BYTE_2;
+		div_mask = TX_VCO_DIVIDER(~0);
+	} else {
+		reg = REG_RX_FRACT_BYTE_2;
+		div_mask = RX_VCO_DIVIDER(~0);
+	}
+
+	stream->len = 0;
+	stream->nb_cmds = 0;
+
+	ret = ad9361_rfpll_vco_init(phy, tx, vco_freq, ref_clk, tdd_table,
+				    stream);
+	if (ret < 0)
+		return ret;
+
+	integer_1 = ad9361_spi_read(phy->spi, reg - 3);
+	if (integer_1 < 0)
+		return integer_1;
+
+	dividers = ad9361_spi_read(phy->spi, REG_RFPLL_DIVIDERS);
+	if (dividers < 0)
+		return dividers;
+
+	buf[0] = SYNTH_FRACT_WORD(fract >> 16);
+	buf[1] = fract >> 8;
+	buf[2] = fract & 0xFF;
+	buf[3] = SYNTH_INTEGER_WORD(integer >> 8) |
+		 (~SYNTH_INTEGER_WORD(~0) & integer_1);
+	buf[4] = integer & 0xFF;
+
+	ad9361_stream_writem(stream, reg, buf, 5);
+
+	return ad9361_stream_write(stream, REG_RFPLL_DIVIDERS,
+				   (dividers & ~div_mask) |
+				   ((vco_div << find_first_bit(div_mask)) &
+				    div_mask));
+}
+
+/**
+ * Update the bits an RFPLL tuning stream does not own, such as the VCO
+ * divider of the other RFPLL, with the current register values. A stream
+ * built earlier would otherwise revert the changes made since.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @param stream The stream built by ad9361_rfpll_tune_stream().
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_rfpll_stream_refresh(struct ad9361_rf_phy *phy, bool tx,
+		struct ad9361_spi_stream *stream)
+{
+	uint32_t offs = tx ? REG_TX_VCO_OUTPUT - REG_RX_VCO_OUTPUT : 0;
+	const struct {
+		uint32_t	reg;
+		uint8_t		mask;
+	} owned[] = {
+		{REG_RX_ALC_VARACTOR + offs, VCO_VARACTOR(~0)},
+		{REG_RX_CP_CURRENT + offs, CHARGE_PUMP_CURRENT(~0)},
+		{
+			tx ? REG_TX_INTEGER_BYTE_1 : REG_RX_INTEGER_BYTE_1,
+			SYNTH_INTEGER_WORD(~0)
+		},
+		{
+			REG_RFPLL_DIVIDERS,
+			tx ? TX_VCO_DIVIDER(~0) : RX_VCO_DIVIDER(~0)
+		},
+	};
+	uint32_t i, j, pos, addr, num;
+	uint8_t *buff;
+	int32_t val;
+
+	for (i = 0; i < ARRAY_SIZE(owned); i++) {
+		/* Multiple bytes writes go down from the command address */
+		for (j = 0, pos = 0; j < stream->nb_cmds; j++) {
+			buff = &stream->buff[pos];
+			num = ((buff[0] >> 4) & 0x7) + 1;
+			addr = AD_ADDR((buff[0] << 8) | buff[1]);
+			pos += num + 2;
+			if (owned[i].reg > addr || owned[i].reg + num <= addr)
+				continue;
+
+			val = ad9361_spi_read(phy->spi, owned[i].reg);
+			if (val < 0)
+				return val;
+
+			buff += 2 + addr - owned[i].reg;
+			*buff = (*buff & owned[i].mask) | (val & ~owned[i].mask);
+			break;
+		}
+	}
 
 	return 0;
 }
@@ -2596,13 +3265,19 @@ static int32_t ad9361_rx_adc_setup(struct ad9361_rf_phy *phy,
 	data[38] = 0x00;
 	data[39] = 0x00;
 
+	ret = spi_batch_begin(phy->spi);
+	if (ret < 0)
+		return ret;
+
 	for (i = 0; i < 40; i++) {
 		ret = ad9361_spi_write(phy->spi, 0x200 + i, data[i]);
-		if (ret < 0)
+		if (ret < 0) {
+			spi_batch_end(phy->spi);
 			return ret;
+		}
 	}
 
-	return 0;
+	return spi_batch_end(phy->spi);
 }
 
 /**
@@ -3639,6 +4314,7 @@ static int32_t ad9361_pp_port_setup(struct ad9361_rf_phy *phy, bool restore_c3)
 {
 	struct spi_desc *spi = phy->spi;
 	struct ad9361_phy_platform_data *pd = phy->pdata;
+	int32_t ret;
 
 	dev_dbg(&phy->spi->dev, "%s", __func__);
 
@@ -3655,6 +4331,10 @@ static int32_t ad9361_pp_port_setup(struct ad9361_rf_phy *phy, bool restore_c3)
 	if (pd->port_ctrl.pp_conf[2] & FULL_PORT)
 		pd->port_ctrl.pp_conf[2] &= ~(HALF_DUPLEX_MODE | SINGLE_PORT_MODE);
 
+	ret = spi_batch_begin(spi);
+	if (ret < 0)
+		return ret;
+
 	ad9361_spi_write(spi, REG_PARALLEL_PORT_CONF_1, pd->port_ctrl.pp_conf[0]);
 	ad9361_spi_write(spi, REG_PARALLEL_PORT_CONF_2, pd->port_ctrl.pp_conf[1]);
 	ad9361_spi_write(spi, REG_PARALLEL_PORT_CONF_3, pd->port_ctrl.pp_conf[2]);
@@ -3674,7 +4354,7 @@ static int32_t ad9361_pp_port_setup(struct ad9361_rf_phy *phy, bool restore_c3)
 				  INVERT_RX2_RF_DC_CGOUT_WORD, 0);
 	}
 
-	return 0;
+	return spi_batch_end(spi);
 }
 
 /**
@@ -3688,6 +4368,7 @@ static int32_t ad9361_gc_setup(struct ad9361_rf_phy *phy,
 {
 	struct spi_desc *spi = phy->spi;
 	uint32_t reg, tmp1, tmp2;
+	int32_t ret;
 
 	dev_dbg(&phy->spi->dev, "%s", __func__);
 
@@ -3704,6 +4385,10 @@ static int32_t ad9361_gc_setup(struct ad9361_rf_phy *phy,
 	phy->agc_mode[0] = ctrl->rx1_mode;
 	phy->agc_mode[1] = ctrl->rx2_mode;
 
+	ret = spi_batch_begin(spi);
+	if (ret < 0)
+		return ret;
+
 	ad9361_spi_write(spi, REG_AGC_CONFIG_1, reg); // Gain Control Mode Select
 
 	/* AGC_USE_FULL_GAIN_TABLE handled in ad9361_load_gt() */
@@ -4019,7 +4704,13 @@ static int32_t ad9361_gc_setup(struct ad9361_rf_phy *phy,
 	ad9361_spi_writef(spi, REG_RX1_MANUAL_LMT_FULL_GAIN,
 			  POWER_MEAS_IN_STATE_5_MSB, reg >> 3);
 
-	return ad9361_gc_update(phy);
+	ret = ad9361_gc_update(phy);
+	if (ret < 0) {
+		spi_batch_end(spi);
+		return ret;
+	}
+
+	return spi_batch_end(spi);
 }
 
 /**
@@ -4105,9 +4796,14 @@ static int32_t ad9361_auxdac_setup(struct ad9361_rf_phy *phy,
 {
 	struct spi_desc *spi = phy->spi;
 	uint8_t tmp;
+	int32_t ret;
 
 	dev_dbg(&phy->spi->dev, "%s", __func__);
 
+	ret = spi_batch_begin(spi);
+	if (ret < 0)
+		return ret;
+
 	ad9361_auxdac_set(phy, 1, ctrl->dac1_default_value);
 	ad9361_auxdac_set(phy, 2, ctrl->dac2_default_value);
 
@@ -4128,7 +4824,7 @@ static int32_t ad9361_auxdac_setup(struct ad9361_rf_phy *phy,
 	ad9361_spi_write(spi, REG_AUXDAC2_RX_DELAY, ctrl->dac2_rx_delay_us);
 	ad9361_spi_write(spi, REG_AUXDAC2_TX_DELAY, ctrl->dac2_tx_delay_us);
 
-	return 0;
+	return spi_batch_end(spi);
 }
 
 /**
@@ -4144,12 +4840,17 @@ static int32_t ad9361_auxadc_setup(struct ad9361_rf_phy *phy,
 {
 	struct spi_desc *spi = phy->spi;
 	uint32_t val;
+	int32_t ret;
 
 	dev_dbg(&phy->spi->dev, "%s", __func__);
 
 	val = DIV_ROUND_CLOSEST(ctrl->temp_time_inteval_ms *
 				(bbpll_freq / 1000UL), (1 << 29));
 
+	ret = spi_batch_begin(spi);
+	if (ret < 0)
+		return ret;
+
 	ad9361_spi_write(spi, REG_TEMP_OFFSET, ctrl->offset);
 	ad9361_spi_write(spi, REG_START_TEMP_READING, 0x00);
 	ad9361_spi_write(spi, REG_TEMP_SENSE2,
@@ -4165,7 +4866,7 @@ static int32_t ad9361_auxadc_setup(struct ad9361_rf_phy *phy,
 			 AUX_ADC_DECIMATION(
 				 ilog2(ctrl->auxadc_decimation) - 8));
 
-	return 0;
+	return spi_batch_end(spi);
 }
 
 /**
@@ -4227,9 +4928,14 @@ static int32_t ad9361_gpo_setup(struct ad9361_rf_phy *phy,
 				struct gpo_control *ctrl)
 {
 	struct spi_desc *spi = phy->spi;
+	int32_t ret;
 
 	dev_dbg(&phy->spi->dev, "%s", __func__);
 
+	ret = spi_batch_begin(spi);
+	if (ret < 0)
+		return ret;
+
 	ad9361_spi_write(spi, REG_AUTO_GPO,
 			 GPO_ENABLE_AUTO_RX(ctrl->gpo0_slave_rx_en |
 					    (ctrl->gpo1_slave_rx_en << 1) |
@@ -4262,7 +4968,7 @@ static int32_t ad9361_gpo_setup(struct ad9361_rf_phy *phy,
 	ad9361_spi_writef(phy->spi, REG_EXTERNAL_LNA_CTRL, GPO_MANUAL_SELECT,
 			  ctrl->gpo_manual_mode_en);
 
-	return 0;
+	return spi_batch_end(spi);
 }
 
 /**
@@ -4917,7 +5623,7 @@ static int32_t ad9361_fastlock_readval(struct spi_desc *spi, bool tx,
 
 /**
  * Fastlock write value.
- * @param spi
+ * @param phy The AD9361 state structure.
  * @param tx
  * @param profile
  * @param word
@@ -4925,32 +5631,37 @@ static int32_t ad9361_fastlock_readval(struct spi_desc *spi, bool tx,
  * @param last
  * @return 0 in case of success, negative error code otherwise.
  */
-static int32_t ad9361_fastlock_writeval(struct spi_desc *spi, bool tx,
+static int32_t ad9361_fastlock_writeval(struct ad9361_rf_phy *phy, bool tx,
 					uint32_t profile, uint32_t word, uint8_t val, bool last)
 {
+	struct ad9361_spi_stream stream = {0};
+	uint8_t buff[4 * 3];
 	uint32_t offs = 0;
-	int32_t ret;
 
 	if (tx)
 		offs = REG_TX_FAST_LOCK_SETUP - REG_RX_FAST_LOCK_SETUP;
 
-	ret = ad9361_spi_write(spi, REG_RX_FAST_LOCK_PROGRAM_ADDR + offs,
-			       RX_FAST_LOCK_PROFILE_ADDR(profile) |
-			       RX_FAST_LOCK_PROFILE_WORD(word));
-	ret |= ad9361_spi_write(spi, REG_RX_FAST_LOCK_PROGRAM_DATA + offs, val);
-	ret |= ad9361_spi_write(spi, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs,
-				RX_FAST_LOCK_PROGRAM_WRITE |
-				RX_FAST_LOCK_PROGRAM_CLOCK_ENABLE);
+	stream.buff = buff;
+	stream.size = sizeof(buff);
+
+	ad9361_stream_write(&stream, REG_RX_FAST_LOCK_PROGRAM_ADDR + offs,
+			    RX_FAST_LOCK_PROFILE_ADDR(profile) |
+			    RX_FAST_LOCK_PROFILE_WORD(word));
+	ad9361_stream_write(&stream, REG_RX_FAST_LOCK_PROGRAM_DATA + offs, val);
+	ad9361_stream_write(&stream, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs,
+			    RX_FAST_LOCK_PROGRAM_WRITE |
+			    RX_FAST_LOCK_PROGRAM_CLOCK_ENABLE);
 
 	if (last) /* Stop Clocks */
-		ret |= ad9361_spi_write(spi,
-					REG_RX_FAST_LOCK_PROGRAM_CTRL + offs, 0);
+		ad9361_stream_write(&stream,
+				    REG_RX_FAST_LOCK_PROGRAM_CTRL + offs, 0);
 
-	return ret;
+	return ad9361_stream_submit(phy, &stream);
 }
 
 /**
- * Fastlock load values.
+ * Fastlock load values. The whole profile is programmed with a single
+ * transfer.
  * @param phy The AD9361 state structure.
  * @param tx
  * @param profile
@@ -4960,8 +5671,10 @@ static int32_t ad9361_fastlock_writeval(struct spi_desc *spi, bool tx,
 int32_t ad9361_fastlock_load(struct ad9361_rf_phy *phy, bool tx,
 			     uint32_t profile, uint8_t *values)
 {
+	struct ad9361_spi_stream stream = {0};
+	uint8_t stream_buff[4 + (RX_FAST_LOCK_CONFIG_WORD_NUM - 1) * 6 + 2 * 3];
 	uint32_t offs = 0;
-	int32_t i, ret = 0;
+	int32_t i, ret;
 	uint8_t buf[4];
 
 	dev_dbg(&phy->spi->dev, "%s: %s Profile %"PRIu32":",
@@ -4970,21 +5683,27 @@ int32_t ad9361_fastlock_load(struct ad9361_rf_phy *phy, bool tx,
 	if (tx)
 		offs = REG_TX_FAST_LOCK_SETUP - REG_RX_FAST_LOCK_SETUP;
 
+	stream.buff = stream_buff;
+	stream.size = sizeof(stream_buff);
+
 	buf[0] = values[0];
 	buf[1] = RX_FAST_LOCK_PROFILE_ADDR(profile) | RX_FAST_LOCK_PROFILE_WORD(0);
-	ad9361_spi_writem(phy->spi, REG_RX_FAST_LOCK_PROGRAM_DATA + offs, buf, 2);
+	ad9361_stream_writem(&stream, REG_RX_FAST_LOCK_PROGRAM_DATA + offs, buf, 2);
 
 	for (i = 1; i < RX_FAST_LOCK_CONFIG_WORD_NUM; i++) {
 		buf[0] = RX_FAST_LOCK_PROGRAM_WRITE | RX_FAST_LOCK_PROGRAM_CLOCK_ENABLE;
 		buf[1] = 0;
 		buf[2] = values[i];
 		buf[3] = RX_FAST_LOCK_PROFILE_ADDR(profile) | RX_FAST_LOCK_PROFILE_WORD(i);
-		ad9361_spi_writem(phy->spi, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs, buf, 4);
+		ad9361_stream_writem(&stream, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs,
+				     buf, 4);
 	}
 
-	ad9361_spi_write(phy->spi, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs,
-			 RX_FAST_LOCK_PROGRAM_WRITE | RX_FAST_LOCK_PROGRAM_CLOCK_ENABLE);
-	ad9361_spi_write(phy->spi, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs, 0);
+	ad9361_stream_write(&stream, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs,
+			    RX_FAST_LOCK_PROGRAM_WRITE | RX_FAST_LOCK_PROGRAM_CLOCK_ENABLE);
+	ad9361_stream_write(&stream, REG_RX_FAST_LOCK_PROGRAM_CTRL + offs, 0);
+
+	ret = ad9361_stream_submit(phy, &stream);
 
 	phy->fastlock.entry[tx][profile].flags = FASTLOOK_INIT;
 	phy->fastlock.entry[tx][profile].alc_orig = values[15];
@@ -5164,7 +5883,7 @@ int32_t ad9361_fastlock_recall(struct ad9361_rf_phy *phy, bool tx,
 		else
 			phy->fastlock.entry[tx][profile].alc_written = orig;
 
-		ad9361_fastlock_writeval(phy->spi, tx, profile, 0xF,
+		ad9361_fastlock_writeval(phy, tx, profile, 0xF,
 					 phy->fastlock.entry[tx][profile].alc_written, true);
 	}
 
@@ -6827,10 +7546,12 @@ int32_t ad9361_rfpll_int_set_rate(struct refclk_scale *clk_priv, uint32_t rate,
 				  uint32_t parent_rate)
 {
 	struct ad9361_rf_phy *phy = clk_priv->phy;
+	struct ad9361_spi_stream stream = {0};
+	uint8_t stream_buff[AD9361_RFPLL_IMAGE_SIZE];
 	uint64_t vco = 0;
-	uint8_t buf[5];
-	uint32_t reg, div_mask, lock_reg, fract = 0, integer = 0;
+	uint32_t div_mask, lock_reg, fract = 0, integer = 0;
 	int32_t vco_div, ret, fixup_other;
+	bool tx, tdd_table;
 
 	dev_dbg(&clk_priv->spi->dev,
 		"%s: %s Rate %"PRIu32" Hz Parent Rate %"PRIu32" Hz",
@@ -6847,14 +7568,12 @@ int32_t ad9361_rfpll_int_set_rate(struct refclk_scale *clk_priv, uint32_t rate,
 
 	switch (clk_priv->source) {
 	case RX_RFPLL_INT:
-		reg = REG_RX_FRACT_BYTE_2;
 		lock_reg = REG_RX_CP_OVERRANGE_VCO_LOCK;
 		div_mask = RX_VCO_DIVIDER(~0);
 		phy->cached_rx_rfpll_div = vco_div;
 		phy->current_rx_lo_freq = rate;
 		break;
 	case TX_RFPLL_INT:
-		reg = REG_TX_FRACT_BYTE_2;
 		lock_reg = REG_TX_CP_OVERRANGE_VCO_LOCK;
 		div_mask = TX_VCO_DIVIDER(~0);
 		phy->cached_tx_rfpll_div = vco_div;
@@ -6870,21 +7589,27 @@ int32_t ad9361_rfpll_int_set_rate(struct refclk_scale *clk_priv, uint32_t rate,
 		ad9361_trx_vco_cal_control(phy, clk_priv->source == TX_RFPLL_INT,
 					   true);
 
+	stream.buff = stream_buff;
+	stream.size = sizeof(stream_buff);
+
 	do {
 		fixup_other = 0;
-		ad9361_rfpll_vco_init(phy, div_mask == TX_VCO_DIVIDER(~0),
-				      vco, parent_rate);
+		tx = div_mask == TX_VCO_DIVIDER(~0);
+		tdd_table = ad9361_rfpll_use_tdd_table(phy, phy->current_tx_lo_freq,
+						       phy->current_rx_lo_freq);
+		if (tx)
+			phy->current_tx_use_tdd_table = tdd_table;
+		else
+			phy->current_rx_use_tdd_table = tdd_table;
 
-		buf[0] = SYNTH_FRACT_WORD(fract >> 16);
-		buf[1] = fract >> 8;
-		buf[2] = fract & 0xFF;
-		buf[3] = SYNTH_INTEGER_WORD(integer >> 8) |
-			 (~SYNTH_INTEGER_WORD(~0) &
-			  ad9361_spi_read(clk_priv->spi, reg - 3));
-		buf[4] = integer & 0xFF;
+		ret = ad9361_rfpll_tune_stream(phy, tx, vco, parent_rate, integer,
+					       fract, vco_div, tdd_table, &stream);
+		if (ret < 0)
+			break;
 
-		ad9361_spi_writem(clk_priv->spi, reg, buf, 5);
-		ad9361_spi_writef(clk_priv->spi, REG_RFPLL_DIVIDERS, div_mask, vco_div);
+		ret = ad9361_stream_submit(phy, &stream);
+		if (ret < 0)
+			break;
 
 		ret = ad9361_check_cal_done(phy, lock_reg, VCO_LOCK, 1);
 
@@ -6902,13 +7627,11 @@ int32_t ad9361_rfpll_int_set_rate(struct refclk_scale *clk_priv, uint32_t rate,
 
 			switch (clk_priv->source) {
 			case RX_RFPLL_INT:
-				reg = REG_TX_FRACT_BYTE_2;
 				lock_reg = REG_TX_CP_OVERRANGE_VCO_LOCK;
 				div_mask = TX_VCO_DIVIDER(~0);
 				_rate = phy->current_tx_lo_freq;
 				break;
 			case TX_RFPLL_INT:
-				reg = REG_RX_FRACT_BYTE_2;
 				lock_reg = REG_RX_CP_OVERRANGE_VCO_LOCK;
 				div_mask = RX_VCO_DIVIDER(~0);
 				_rate = phy->current_rx_lo_freq;
@@ -6937,6 +7660,299 @@ int32_t ad9361_rfpll_int_set_rate(struct refclk_scale *clk_priv, uint32_t rate,
 	return ret;
 }
 
+/**
+ * Tune a RFPLL with the image of a hop plan entry.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @param entry The hop plan entry.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad9361_hop_tune(struct ad9361_rf_phy *phy, bool tx,
+			       struct ad9361_hop_entry *entry)
+{
+	uint32_t lock_reg;
+	int32_t ret;
+
+	lock_reg = tx ? REG_TX_CP_OVERRANGE_VCO_LOCK :
+		   REG_RX_CP_OVERRANGE_VCO_LOCK;
+
+	ad9361_fastlock_prepare(phy, tx, 0, false);
+
+	/* Option to skip VCO cal in TDD mode when moving from TX/RX to Alert */
+	if (phy->pdata->tdd_skip_vco_cal)
+		ad9361_trx_vco_cal_control(phy, tx, true);
+
+	ret = ad9361_rfpll_stream_refresh(phy, tx, &entry->image);
+	if (ret == 0)
+		ret = ad9361_stream_submit(phy, &entry->image);
+	if (ret == 0)
+		ret = ad9361_check_cal_done(phy, lock_reg, VCO_LOCK, 1);
+
+	if (phy->pdata->tdd_skip_vco_cal)
+		ad9361_trx_vco_cal_control(phy, tx, false);
+
+	return ret;
+}
+
+/**
+ * Update the LO state after a hop.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @param entry The hop plan entry.
+ * @return None.
+ */
+static void ad9361_hop_update(struct ad9361_rf_phy *phy, bool tx,
+			      struct ad9361_hop_entry *entry)
+{
+	if (tx) {
+		phy->current_tx_lo_freq = entry->rate;
+		phy->cached_tx_rfpll_div = entry->vco_div;
+		phy->current_tx_use_tdd_table = entry->tdd_table;
+		phy->clks[TX_RFPLL_INT]->rate = entry->tuned_rate;
+		phy->clks[TX_RFPLL]->rate = entry->tuned_rate;
+	} else {
+		phy->current_rx_lo_freq = entry->rate;
+		phy->cached_rx_rfpll_div = entry->vco_div;
+		phy->current_rx_use_tdd_table = entry->tdd_table;
+		phy->clks[RX_RFPLL_INT]->rate = entry->tuned_rate;
+		phy->clks[RX_RFPLL]->rate = entry->tuned_rate;
+	}
+}
+
+/**
+ * Free the hop plan of a RFPLL.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @return None.
+ */
+void ad9361_hop_plan_remove(struct ad9361_rf_phy *phy, bool tx)
+{
+	struct ad9361_hop_plan *plan = phy->hop_plan[tx];
+
+	if (!plan)
+		return;
+
+	free(plan->entries);
+	free(plan);
+	phy->hop_plan[tx] = NULL;
+}
+
+/**
+ * Build the frequency hopping plan of a RFPLL. The dividers, the VCO
+ * settings and the synthesizer words of each frequency are computed once and
+ * kept as a SPI command stream, so that a hop only sends the stream and
+ * waits for the lock. With use_fastlock, the RFPLL is tuned to the first
+ * frequencies, which are then stored in the fast lock profiles 0 to 7 and
+ * recalled without a VCO calibration. The other profiles are overwritten and
+ * the LO is restored when the plan is built. On failure, no plan is kept.
+ * The streams and profiles depend on the LO of the other RFPLL, hops done
+ * after it changed take the normal tuning path. The bits of the streams that
+ * belong to other settings are read again on each hop.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @param freqs The LO frequencies [Hz].
+ * @param nb_freqs The number of frequencies.
+ * @param use_fastlock Store the first frequencies in fast lock profiles.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_plan_build(struct ad9361_rf_phy *phy, bool tx,
+			      const uint64_t *freqs, uint32_t nb_freqs,
+			      bool use_fastlock)
+{
+	struct refclk_scale *clk_priv;
+	struct ad9361_hop_entry *entry;
+	struct ad9361_hop_plan *plan;
+	uint32_t i, parent_rate, integer, fract, lo_rate;
+	int32_t vco_div, ret, ret_restore;
+	uint64_t vco;
+
+	if (!nb_freqs || (tx ? phy->pdata->use_ext_tx_lo :
+			  phy->pdata->use_ext_rx_lo))
+		return -EINVAL;
+
+	ad9361_hop_plan_remove(phy, tx);
+
+	plan = calloc(1, sizeof(*plan));
+	if (!plan)
+		return -ENOMEM;
+
+	plan->entries = calloc(nb_freqs, sizeof(*plan->entries));
+	if (!plan->entries) {
+		free(plan);
+		return -ENOMEM;
+	}
+	plan->nb_entries = nb_freqs;
+	plan->other_rate = tx ? phy->current_rx_lo_freq :
+			   phy->current_tx_lo_freq;
+
+	clk_priv = phy->ref_clk_scale[tx ? TX_RFPLL_INT : RX_RFPLL_INT];
+	parent_rate = phy->clks[clk_priv->parent_source]->rate;
+
+	for (i = 0; i < nb_freqs; i++) {
+		entry = &plan->entries[i];
+		entry->rate = ad9361_to_clk(freqs[i]);
+		entry->profile = -1;
+
+		ret = ad9361_calc_rfpll_int_divder(phy, clk_priv,
+						   ad9361_from_clk(entry->rate),
+						   parent_rate, &integer, &fract,
+						   &vco_div, &vco);
+		if (ret < 0)
+			goto error;
+
+		entry->vco_div = vco_div;
+		entry->tuned_rate = ad9361_to_clk(ad9361_calc_rfpll_int_freq(
+				parent_rate, integer, fract, vco_div));
+		if (tx)
+			entry->tdd_table = ad9361_rfpll_use_tdd_table(phy,
+					   entry->rate, plan->other_rate);
+		else
+			entry->tdd_table = ad9361_rfpll_use_tdd_table(phy,
+					   plan->other_rate, entry->rate);
+
+		entry->image.buff = entry->image_buff;
+		entry->image.size = sizeof(entry->image_buff);
+		ret = ad9361_rfpll_tune_stream(phy, tx, vco, parent_rate,
+					       integer, fract, vco_div,
+					       entry->tdd_table, &entry->image);
+		if (ret < 0)
+			goto error;
+	}
+
+	if (!use_fastlock) {
+		phy->hop_plan[tx] = plan;
+		return 0;
+	}
+
+	lo_rate = tx ? phy->current_tx_lo_freq : phy->current_rx_lo_freq;
+
+	for (i = 0; i < nb_freqs && i < ARRAY_SIZE(phy->fastlock.entry[tx]);
+	     i++) {
+		entry = &plan->entries[i];
+		ret = ad9361_hop_tune(phy, tx, entry);
+		if (ret < 0)
+			break;
+		ad9361_hop_update(phy, tx, entry);
+
+		ret = ad9361_fastlock_store(phy, tx, i);
+		if (ret < 0)
+			break;
+		entry->profile = i;
+	}
+
+	/* Restore the LO, also when a profile failed */
+	ret_restore = clk_set_rate(phy,
+				   phy->ref_clk_scale[tx ? TX_RFPLL : RX_RFPLL],
+				   lo_rate);
+	if (ret == 0)
+		ret = ret_restore;
+	if (ret < 0)
+		goto error;
+
+	phy->hop_plan[tx] = plan;
+
+	return 0;
+
+error:
+	free(plan->entries);
+	free(plan);
+
+	return ret;
+}
+
+/**
+ * Tune a RFPLL to a frequency of its hop plan. Fast lock profiles are
+ * recalled, the other frequencies are tuned with their precomputed SPI
+ * command stream. For the RX RFPLL, the gain table is loaded if the band
+ * changes. Unlike the normal tuning path, no TX quadrature calibration is
+ * run.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @param index The index of the frequency in the plan.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop(struct ad9361_rf_phy *phy, bool tx, uint32_t index)
+{
+	struct ad9361_hop_plan *plan = phy->hop_plan[tx];
+	struct ad9361_hop_entry *entry;
+	struct refclk_scale *clk_priv;
+	uint32_t other_rate;
+	bool other_tdd_table;
+	int32_t ret;
+
+	if (!plan || index >= plan->nb_entries)
+		return -EINVAL;
+
+	entry = &plan->entries[index];
+
+	if (tx) {
+		other_rate = phy->current_rx_lo_freq;
+		other_tdd_table = phy->current_rx_use_tdd_table;
+	} else {
+		other_rate = phy->current_tx_lo_freq;
+		other_tdd_table = phy->current_tx_use_tdd_table;
+	}
+
+	/* The profiles and the images were made for the other LO of the plan */
+	if (other_rate == plan->other_rate &&
+	    (!phy->pdata->fdd || phy->pdata->fdd_independent_mode ||
+	     other_tdd_table == entry->tdd_table)) {
+		if (entry->profile >= 0)
+			ret = ad9361_fastlock_recall(phy, tx, entry->profile);
+		else
+			ret = ad9361_hop_tune(phy, tx, entry);
+	} else {
+		/* The other RFPLL has to be tuned as well */
+		clk_priv = phy->ref_clk_scale[tx ? TX_RFPLL_INT : RX_RFPLL_INT];
+		ret = ad9361_rfpll_int_set_rate(clk_priv, entry->rate,
+						phy->clks[clk_priv->parent_source]->rate);
+	}
+	if (ret < 0)
+		return ret;
+
+	ad9361_hop_update(phy, tx, entry);
+
+	if (tx)
+		return 0;
+
+	return ad9361_load_gt(phy, ad9361_from_clk(entry->rate),
+			      GT_RX1 + GT_RX2);
+}
+
+/**
+ * Get the description of the hop plan of a RFPLL.
+ * @param phy The AD9361 state structure.
+ * @param tx Set true for TX_RFPLL.
+ * @param info The description.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_hop_plan_get_info(struct ad9361_rf_phy *phy, bool tx,
+				 struct ad9361_hop_plan_info *info)
+{
+	struct ad9361_hop_plan *plan = phy->hop_plan[tx];
+	struct ad9361_hop_entry *entry;
+	uint32_t i;
+
+	if (!plan)
+		return -EINVAL;
+
+	memset(info, 0, sizeof(*info));
+	info->nb_freqs = plan->nb_entries;
+	info->max_fastlock = ARRAY_SIZE(phy->fastlock.entry[tx]);
+	info->fastlock_delay_ns = tx ? phy->pdata->tx_fastlock_delay_ns :
+				  phy->pdata->rx_fastlock_delay_ns;
+
+	for (i = 0; i < plan->nb_entries; i++) {
+		entry = &plan->entries[i];
+		if (entry->profile >= 0)
+			info->nb_fastlock++;
+		info->image_cmds = max(info->image_cmds, entry->image.nb_cmds);
+		info->image_bytes = max(info->image_bytes, entry->image.len);
+	}
+
+	return 0;
+}
+
 /**
  * Recalculate the clock rate.
  * @param clk_priv The refclk_scale structure.
@@ -2806,6 +2806,17 @@
 #define AD_CNT(x)	((((x) - 1) & 0x7) << 12)
 #define AD_ADDR(x)	((x) & 0x3FF)
 
+/*
+*	Register Cache
+*/
+#define AD9361_NUM_REGS			0x400
+#define AD9361_REGCACHE_VALID		(1 << 0) /* Value known */
+#define AD9361_REGCACHE_DIRTY		(1 << 1) /* Not written to the device */
+#define AD9361_REGCACHE_VOLATILE	(1 << 2) /* Updated by the device */
+
+/* RFPLL tuning commands: 11 VCO writes, the synthesizer words and divider */
+#define AD9361_RFPLL_IMAGE_SIZE		(11 * 3 + 7 + 3)
+
 
 /*
 *	AD9361 Limits
@@ -3337,10 +3348,65 @@ enum dev_id {
 	ID_AD9363A
 };
 
+struct ad9361_regcache {
+	uint8_t			val[AD9361_NUM_REGS];
+	uint8_t			flags[AD9361_NUM_REGS];
+	/* Keep the writes in the cache until ad9361_regcache_sync() */
+	bool			cache_only;
+	/* Statistics, see ad9361_regcache_get_stats() */
+	uint32_t		spi_reads;
+	uint32_t		spi_writes;
+	uint32_t		cache_hits;
+};
+
+struct ad9361_spi_stream {
+	/* Write commands, each one with its header, sent back to back */
+	uint8_t			*buff;
+	uint32_t		size;
+	uint32_t		len;
+	uint32_t		nb_cmds;
+	/* Identifies the settings the stream was built for */
+	uint32_t		tag;
+};
+
+struct ad9361_hop_entry {
+	/* Requested and tuned LO frequency, see ad9361_to_clk() */
+	uint32_t		rate;
+	uint32_t		tuned_rate;
+	uint8_t			vco_div;
+	bool			tdd_table;
+	/* Fast lock profile holding the entry, -1 if none */
+	int8_t			profile;
+	/* RFPLL tuning commands */
+	struct ad9361_spi_stream	image;
+	uint8_t			image_buff[AD9361_RFPLL_IMAGE_SIZE];
+};
+
+struct ad9361_hop_plan {
+	uint32_t		nb_entries;
+	struct ad9361_hop_entry	*entries;
+	/* LO of the other RFPLL the images were built for */
+	uint32_t		other_rate;
+};
+
+struct ad9361_hop_plan_info {
+	/* Number of frequencies of the plan */
+	uint32_t		nb_freqs;
+	/* Frequencies held in fast lock profiles and number of profiles */
+	uint32_t		nb_fastlock;
+	uint32_t		max_fastlock;
+	/* SPI commands and bytes of the other hops, sent with one transfer */
+	uint32_t		image_cmds;
+	uint32_t		image_bytes;
+	/* Settling time of the fast lock hops [ns] */
+	uint32_t		fastlock_delay_ns;
+};
+
 struct ad9361_rf_phy {
 	enum dev_id		dev_sel;
 	uint8_t 		id_no;
 	struct spi_desc 	*spi;
+	struct ad9361_regcache	*regcache;
 	struct gpio_desc 	*gpio_desc_resetb;
 	struct gpio_desc 	*gpio_desc_sync;
 	struct gpio_desc 	*gpio_desc_cal_sw1;
@@ -3366,6 +3432,16 @@ struct ad9361_rf_phy {
 	int32_t			tx_quad_lpf_tia_match;
 	uint32_t		current_table;
 	struct gain_table_info  *gt_info;
+	/* Gain table streams, one per gt_info entry */
+	struct ad9361_spi_stream	*gt_stream;
+	uint32_t		gt_stream_num;
+	/* Transfer buffers of ad9361_stream_submit() */
+	struct spi_msg		*stream_msgs;
+	uint32_t		stream_max_msgs;
+	uint8_t			*stream_buff;
+	uint32_t		stream_size;
+	/* Frequency hopping plans, indexed by tx */
+	struct ad9361_hop_plan	*hop_plan[2];
 	bool 			ensm_pin_ctl_en;
 
 	bool			auto_cal_en;
@@ -3447,6 +3523,16 @@ int32_t ad9361_spi_read(struct spi_desc *spi, uint32_t reg);
 int32_t ad9361_spi_write(struct spi_desc *spi,
 			 uint32_t reg, uint32_t val);
 int32_t ad9361_reset(struct ad9361_rf_phy *phy);
+int32_t ad9361_regcache_init(struct ad9361_rf_phy *phy);
+void ad9361_regcache_remove(struct ad9361_rf_phy *phy);
+void ad9361_regcache_drop(struct ad9361_rf_phy *phy);
+void ad9361_regcache_mark_dirty(struct ad9361_rf_phy *phy);
+void ad9361_regcache_cache_only(struct ad9361_rf_phy *phy, bool enable);
+int32_t ad9361_regcache_sync(struct ad9361_rf_phy *phy);
+void ad9361_regcache_get_stats(struct ad9361_rf_phy *phy, uint32_t *spi_reads,
+			       uint32_t *spi_writes, uint32_t *cache_hits);
+void ad9361_regcache_reset_stats(struct ad9361_rf_phy *phy);
+void ad9361_streams_remove(struct ad9361_rf_phy *phy);
 int32_t ad9361_register_clocks(struct ad9361_rf_phy *phy);
 int32_t ad9361_unregister_clocks(struct ad9361_rf_phy *phy);
 uint32_t ad9361_gt(struct ad9361_rf_phy *phy);
@@ -3538,6 +3624,13 @@ int32_t ad9361_fastlock_load(struct ad9361_rf_phy *phy, bool tx,
 			     uint32_t profile, uint8_t *values);
 int32_t ad9361_fastlock_save(struct ad9361_rf_phy *phy, bool tx,
 			     uint32_t profile, uint8_t *values);
+int32_t ad9361_hop_plan_build(struct ad9361_rf_phy *phy, bool tx,
+			      const uint64_t *freqs, uint32_t nb_freqs,
+			      bool use_fastlock);
+void ad9361_hop_plan_remove(struct ad9361_rf_phy *phy, bool tx);
+int32_t ad9361_hop(struct ad9361_rf_phy *phy, bool tx, uint32_t index);
+int32_t ad9361_hop_plan_get_info(struct ad9361_rf_phy *phy, bool tx,
+				 struct ad9361_hop_plan_info *info);
 void ad9361_ensm_force_state(struct ad9361_rf_phy *phy, uint8_t ensm_state);
 uint8_t ad9361_ensm_get_state(struct ad9361_rf_phy *phy);
 void ad9361_ensm_restore_state(struct ad9361_rf_phy *phy, uint8_t ensm_state);
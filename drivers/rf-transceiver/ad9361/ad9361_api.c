@@ -494,6 +494,10 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 
 	spi_init(&phy->spi, &init_param->spi_param);
 
+	ret = ad9361_regcache_init(phy);
+	if (ret < 0)
+		goto out;
+
 	phy->pdata->port_ctrl.digital_io_ctrl = 0;
 	phy->pdata->port_ctrl.lvds_invert[0] = init_param->lvds_invert1_control;
 	phy->pdata->port_ctrl.lvds_invert[1] = init_param->lvds_invert2_control;
@@ -569,6 +573,8 @@ int32_t ad9361_init (struct ad9361_rf_phy **ad9361_phy,
 out_clk:
 	ad9361_unregister_clocks(phy);
 out:
+	ad9361_streams_remove(phy);
+	ad9361_regcache_remove(phy);
 #ifndef AXI_ADC_NOT_PRESENT
 	free(phy->adc_conv);
 	free(phy->adc_state);
@@ -589,6 +595,10 @@ out:
 int32_t ad9361_remove(struct ad9361_rf_phy *phy)
 {
 	ad9361_unregister_clocks(phy);
+	ad9361_hop_plan_remove(phy, 0);
+	ad9361_hop_plan_remove(phy, 1);
+	ad9361_streams_remove(phy);
+	ad9361_regcache_remove(phy);
 	spi_remove(phy->spi);
 	gpio_remove(phy->gpio_desc_resetb);
 	gpio_remove(phy->gpio_desc_sync);
@@ -1330,6 +1340,49 @@ int32_t ad9361_rx_fastlock_save(struct ad9361_rf_phy *phy, uint32_t profile,
 	return ad9361_fastlock_save(phy, 0, profile, values);
 }
 
+/**
+ * Set the RX frequency hopping plan. The tuning words of each frequency are
+ * computed once, so that a hop only sends them to the device. With
+ * use_fastlock, the first 8 frequencies are stored in the RX fastlock
+ * profiles, overwriting them.
+ * @param phy The AD9361 state structure.
+ * @param freqs_hz The LO frequencies [Hz].
+ * @param nb_freqs The number of frequencies.
+ * @param use_fastlock Store the first frequencies in fastlock profiles.
+ * 				  Accepted values:
+ * 				   0 - disable
+ * 				   1 - enable
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_set_rx_hop_plan(struct ad9361_rf_phy *phy, uint64_t *freqs_hz,
+				uint32_t nb_freqs, uint8_t use_fastlock)
+{
+	return ad9361_hop_plan_build(phy, 0, freqs_hz, nb_freqs, use_fastlock);
+}
+
+/**
+ * Tune the RX LO to a frequency of the hopping plan.
+ * @param phy The AD9361 state structure.
+ * @param index The index of the frequency in the plan.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_rx_hop(struct ad9361_rf_phy *phy, uint32_t index)
+{
+	return ad9361_hop(phy, 0, index);
+}
+
+/**
+ * Get the description of the RX frequency hopping plan.
+ * @param phy The AD9361 state structure.
+ * @param info A variable to store the description.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_get_rx_hop_plan_info(struct ad9361_rf_phy *phy,
+				     struct ad9361_hop_plan_info *info)
+{
+	return ad9361_hop_plan_get_info(phy, 0, info);
+}
+
 /**
  * Power down the RX Local Oscillator.
  * @param phy The AD9361 state structure.
@@ -1845,6 +1898,49 @@ int32_t ad9361_tx_fastlock_save(struct ad9361_rf_phy *phy, uint32_t profile,
 	return ad9361_fastlock_save(phy, 1, profile, values);
 }
 
+/**
+ * Set the TX frequency hopping plan. The tuning words of each frequency are
+ * computed once, so that a hop only sends them to the device. With
+ * use_fastlock, the first 8 frequencies are stored in the TX fastlock
+ * profiles, overwriting them.
+ * @param phy The AD9361 state structure.
+ * @param freqs_hz The LO frequencies [Hz].
+ * @param nb_freqs The number of frequencies.
+ * @param use_fastlock Store the first frequencies in fastlock profiles.
+ * 				  Accepted values:
+ * 				   0 - disable
+ * 				   1 - enable
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_set_tx_hop_plan(struct ad9361_rf_phy *phy, uint64_t *freqs_hz,
+				uint32_t nb_freqs, uint8_t use_fastlock)
+{
+	return ad9361_hop_plan_build(phy, 1, freqs_hz, nb_freqs, use_fastlock);
+}
+
+/**
+ * Tune the TX LO to a frequency of the hopping plan.
+ * @param phy The AD9361 state structure.
+ * @param index The index of the frequency in the plan.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_tx_hop(struct ad9361_rf_phy *phy, uint32_t index)
+{
+	return ad9361_hop(phy, 1, index);
+}
+
+/**
+ * Get the description of the TX frequency hopping plan.
+ * @param phy The AD9361 state structure.
+ * @param info A variable to store the description.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad9361_get_tx_hop_plan_info(struct ad9361_rf_phy *phy,
+				     struct ad9361_hop_plan_info *info)
+{
+	return ad9361_hop_plan_get_info(phy, 1, info);
+}
+
 /**
  * Power down the TX Local Oscillator.
  * @param phy The AD9361 state structure.
@@ -456,6 +456,14 @@ int32_t ad9361_rx_fastlock_load(struct ad9361_rf_phy *phy, uint32_t profile,
 /* Save RX fastlock profile. */
 int32_t ad9361_rx_fastlock_save(struct ad9361_rf_phy *phy, uint32_t profile,
 				uint8_t *values);
+/* Set the RX frequency hopping plan. */
+int32_t ad9361_set_rx_hop_plan(struct ad9361_rf_phy *phy, uint64_t *freqs_hz,
+				uint32_t nb_freqs, uint8_t use_fastlock);
+/* Tune the RX LO to a frequency of the hopping plan. */
+int32_t ad9361_rx_hop(struct ad9361_rf_phy *phy, uint32_t index);
+/* Get the description of the RX frequency hopping plan. */
+int32_t ad9361_get_rx_hop_plan_info(struct ad9361_rf_phy *phy,
+				     struct ad9361_hop_plan_info *info);
 /* Power down the RX Local Oscillator. */
 int32_t ad9361_rx_lo_powerdown(struct ad9361_rf_phy *phy, uint8_t option);
 /* Get the RX Local Oscillator power status. */
@@ -518,6 +526,14 @@ int32_t ad9361_tx_fastlock_load(struct ad9361_rf_phy *phy, uint32_t profile,
 /* Save TX fastlock profile. */
 int32_t ad9361_tx_fastlock_save(struct ad9361_rf_phy *phy, uint32_t profile,
 				uint8_t *values);
+/* Set the TX frequency hopping plan. */
+int32_t ad9361_set_tx_hop_plan(struct ad9361_rf_phy *phy, uint64_t *freqs_hz,
+				uint32_t nb_freqs, uint8_t use_fastlock);
+/* Tune the TX LO to a frequency of the hopping plan. */
+int32_t ad9361_tx_hop(struct ad9361_rf_phy *phy, uint32_t index);
+/* Get the description of the TX frequency hopping plan. */
+int32_t ad9361_get_tx_hop_plan_info(struct ad9361_rf_phy *phy,
+				     struct ad9361_hop_plan_info *info);
 /* Power down the TX Local Oscillator. */
 int32_t ad9361_tx_lo_powerdown(struct ad9361_rf_phy *phy, uint8_t option);
 /* Get the TX Local Oscillator power status. */
@@ -700,6 +700,11 @@ uint32_t TALISE_readArmMem(taliseDevice_t *device, uint32_t address,
 	uint32_t i;
 	uint8_t autoIncBit = 0;
 
+	uint32_t addrIndex = 0;
+	uint32_t dataIndex = 0;
+	uint32_t spiBufferSize = HAL_SPIWRITEARRAY_BUFFERSIZE;
+	uint16_t addrArray[HAL_SPIWRITEARRAY_BUFFERSIZE] = {0};
+
 	static const uint8_t READ_MEM_BIT = 0x80;
 	static const uint8_t LEGACY_MODE_BIT = 0x20;
 
@@ -760,13 +765,21 @@ uint32_t TALISE_readArmMem(taliseDevice_t *device, uint32_t address,
 	/* start read-back at correct byte offset */
 	/* without address auto increment set, 0x4 must be added to the address for correct indexing */
 	if (autoIncrement > 0) {
+		/* reading the data registers in bursts of spiBufferSize reads */
 		for (i = 0; i < bytesToRead; i++) {
-			halError = talSpiReadByte(device->devHalInfo,
-						  (uint16_t)(TALISE_ADDR_ARM_DMA_DATA0 + (((address & 0x3) + i) % 4)),
-						  &returnData[i]);
-			retVal = talApiErrHandler(device,TAL_ERRHDL_HAL_SPI, halError, retVal,
-						  TALACT_ERR_RESET_SPI);
-			IF_ERR_RETURN_U32(retVal);
+			addrArray[addrIndex++] = (uint16_t)(TALISE_ADDR_ARM_DMA_DATA0 + (((
+					address & 0x3) + i) % 4));
+
+			if ((addrIndex == spiBufferSize) || (i == (bytesToRead - 1))) {
+				halError = talSpiReadBytes(device->devHalInfo, &addrArray[0],
+							   &returnData[dataIndex], addrIndex);
+				retVal = talApiErrHandler(device,TAL_ERRHDL_HAL_SPI, halError, retVal,
+							  TALACT_ERR_RESET_SPI);
+				IF_ERR_RETURN_U32(retVal);
+
+				dataIndex = dataIndex + addrIndex;
+				addrIndex = 0;
+			}
 		}
 	} else {
 		for (i = 0; i < bytesToRead; i++) {
@@ -46,6 +46,7 @@
 #include "sd.h"
 #include "delay.h"
 #include "error.h"
+#include "util.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -59,6 +60,9 @@
 
 #define CMD0_RETRY_NUMBER		(5u)
 #define WAIT_RESP_TIMEOUT		(1000u) //1000ms
+/* Polls done without delay, then the delay between polls is doubled */
+#define WAIT_SPIN_POLLS			(64u)
+#define WAIT_MAX_BACKOFF_US		(1000u)
 
 #define R1_READY_STATE			(0x00u)
 #define R1_IDLE_STATE			(0x01u)
@@ -85,6 +89,7 @@
 #define STOP_TRANSMISSION_TOKEN		(0xFDu)
 #define MASK_RESPONSE_TOKEN		(0x0Eu)
 #define MASK_ERROR_TOKEN		(0xF0u)
+#define MAX_PRE_ERASE_BLOCKS		((1u << 23) - 1)
 
 
 /******************************************************************************/
@@ -92,30 +97,53 @@
 /******************************************************************************/
 
 /**
- * Read SD card bytes until one is different from 0xFF
+ * Read SD card bytes until one is different from idle. The first polls are
+ * done back to back, then the delay between polls is doubled up to
+ * WAIT_MAX_BACKOFF_US, so that short waits are not rounded up to a delay
+ * and long ones do not keep the bus busy.
  * @param sd_desc	- Instance of the SD card
- * @param data_out	- The read bytes is wrote here
+ * @param data_out	- The read byte is written here
+ * @param idle		- Value sent by the card while the wait is not over
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
+static int32_t wait_for_byte(struct sd_desc *sd_desc, uint8_t *data_out,
+			     uint8_t idle)
 {
-	uint32_t	not_timeout;
-	int32_t		ret;
-
-	ret = FAILURE;
-	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
+	uint32_t	polls;
+	uint32_t	backoff_us;
+	uint32_t	waited_us;
+
+	polls = 0;
+	backoff_us = 1;
+	waited_us = 0;
+	while (waited_us < WAIT_RESP_TIMEOUT * 1000) {
+		*data_out = 0xFF;
 		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc,
 						  data_out, 1))
-			break;
-		if (*data_out != 0xFF) {
-			ret = SUCCESS;
-			break;
-		}
-		mdelay(1);
-	} while (not_timeout--);
+			return FAILURE;
+		if (*data_out != idle)
+			return SUCCESS;
+		if (++polls < WAIT_SPIN_POLLS)
+			continue;
+		udelay(backoff_us);
+		waited_us += backoff_us;
+		if (backoff_us < WAIT_MAX_BACKOFF_US)
+			backoff_us = min(backoff_us * 2, WAIT_MAX_BACKOFF_US);
+	}
 
-	return ret;
+	return FAILURE;
+}
+
+/**
+ * Read SD card bytes until one is different from 0xFF
+ * @param sd_desc	- Instance of the SD card
+ * @param data_out	- The read bytes is wrote here
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static inline int32_t wait_for_response(struct sd_desc *sd_desc,
+					uint8_t *data_out)
+{
+	return wait_for_byte(sd_desc, data_out, 0xFF);
 }
 
 /**
@@ -123,26 +151,11 @@ static int32_t wait_for_response(struct sd_desc *sd_desc, uint8_t *data_out)
  * @param sd_desc - Instance of the SD card
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-static int32_t wait_until_not_busy(struct sd_desc *sd_desc)
+static inline int32_t wait_until_not_busy(struct sd_desc *sd_desc)
 {
-	uint32_t	not_timeout;
-	int32_t		ret;
-	uint8_t		data;
-
-	ret = FAILURE;
-	not_timeout = WAIT_RESP_TIMEOUT;
-	do {
-		data = 0xFF;
-		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, &data, 1))
-			break;
-		if (data != 0x00) {
-			ret = SUCCESS;
-			break;
-		}
-		mdelay(1);
-	} while (not_timeout--);
+	uint8_t	data;
 
-	return ret;
+	return wait_for_byte(sd_desc, &data, 0x00);
 }
 
 /**
@@ -175,7 +188,8 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 		cmd_desc_local.response_len = R1_LEN;
 		if (SUCCESS != send_command(sd_desc, &cmd_desc_local))
 			return FAILURE;
-		if (cmd_desc_local.response[0] != R1_IDLE_STATE) {
+		/* Idle during the initialization, ready after */
+		if (cmd_desc_local.response[0] & ~R1_IDLE_STATE) {
 			DEBUG_MSG("Not the expected response for CMD55\n");
 			return FAILURE;
 		}
@@ -220,23 +234,35 @@ static int32_t send_command(struct sd_desc *sd_desc, struct cmd_desc *cmd_desc)
 static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
 			   uint32_t nb_of_blocks)
 {
-	/* Send start block token */
+	struct spi_msg	msgs[3] = {0};
+	uint8_t		response;
+
+	/*
+	 * Start block token, data, CRC and the data response token in one
+	 * transfer. The data response follows the CRC, unless the card is
+	 * late.
+	 */
 	sd_desc->buff[0] = START_N_BLOCK_TOKEN;
 	if (nb_of_blocks == 1)
 		sd_desc->buff[0] = START_1_BLOCK_TOKEN;
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 1))
-		return FAILURE;
-
-	/* Send data with CRC */
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
-		return FAILURE;
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	memset(sd_desc->buff + 1, 0xFF, CRC_LEN + 1);
+	msgs[0].tx_buff = sd_desc->buff;
+	msgs[0].rx_buff = sd_desc->buff;
+	msgs[0].bytes_number = 1;
+	msgs[1].tx_buff = data;
+	msgs[1].rx_buff = data;
+	msgs[1].bytes_number = DATA_BLOCK_LEN;
+	msgs[2].tx_buff = sd_desc->buff + 1;
+	msgs[2].rx_buff = sd_desc->buff + 1;
+	msgs[2].bytes_number = CRC_LEN + 1;
+	msgs[2].cs_change = 1;
+	if (SUCCESS != spi_transfer(sd_desc->spi_desc, msgs, ARRAY_SIZE(msgs)))
 		return FAILURE;
 
 	/* Read response and check if write was ok */
-	uint8_t		response;
-	if (SUCCESS != wait_for_response(sd_desc, &response))
+	response = sd_desc->buff[1 + CRC_LEN];
+	if (response == 0xFF &&
+	    SUCCESS != wait_for_response(sd_desc, &response))
 		return FAILURE;
 	switch (response & MASK_RESPONSE_TOKEN) {
 	case 0x4:
@@ -265,6 +291,8 @@ static int32_t write_block(struct sd_desc *sd_desc, uint8_t *data,
  */
 static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 {
+	struct spi_msg	msgs[2] = {0};
+
 	/* Reading Start block token */
 	uint8_t	response;
 	if (SUCCESS != wait_for_response(sd_desc, &response))
@@ -295,14 +323,17 @@ static int32_t read_block(struct sd_desc *sd_desc, uint8_t *data)
 		return FAILURE;
 	}
 
-	/* Read data block */
+	/* Read data block and crc in one transfer */
 	memset(data, 0xff, DATA_BLOCK_LEN);
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, data, DATA_BLOCK_LEN))
-		return FAILURE;
-
-	/* Read crc*/
-	*((uint16_t *)sd_desc->buff) = 0xFFFF;
-	if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, CRC_LEN))
+	memset(sd_desc->buff, 0xFF, CRC_LEN);
+	msgs[0].tx_buff = data;
+	msgs[0].rx_buff = data;
+	msgs[0].bytes_number = DATA_BLOCK_LEN;
+	msgs[1].tx_buff = sd_desc->buff;
+	msgs[1].rx_buff = sd_desc->buff;
+	msgs[1].bytes_number = CRC_LEN;
+	msgs[1].cs_change = 1;
+	if (SUCCESS != spi_transfer(sd_desc->spi_desc, msgs, ARRAY_SIZE(msgs)))
 		return FAILURE;
 
 	return SUCCESS;
@@ -405,6 +436,8 @@ static int32_t read_multiple_blocks(struct sd_desc *sd_desc,
 	return SUCCESS;
 }
 
+static int32_t cache_flush(struct sd_desc *sd_desc);
+
 /**
  * Read data of size len from the specified address and store it in data.
  * This operation returns only when the read is complete
@@ -425,6 +458,13 @@ int32_t sd_read(struct sd_desc *sd_desc,
 	    address + len > sd_desc->memory_size)
 		return FAILURE;
 
+	/* Write the cached blocks first if they are read */
+	if (sd_desc->cache_nb && address < sd_desc->cache_addr +
+	    ((uint64_t)sd_desc->cache_nb << DATA_BLOCK_BITS) &&
+	    address + len > sd_desc->cache_addr)
+		if (SUCCESS != cache_flush(sd_desc))
+			return FAILURE;
+
 	/* Send read command */
 	cmd_desc.cmd = (get_nb_of_blocks(address, len) == 1) ? CMD(17): CMD(18);
 	cmd_desc.arg = address >> DATA_BLOCK_BITS;;
@@ -457,25 +497,20 @@ int32_t sd_read(struct sd_desc *sd_desc,
 }
 
 /**
- * Write data of size len to the specified address
- * This operation returns only when the write is complete
+ * Write data of size len to the specified address, bypassing the cache
  * @param sd_desc	- Instance of the SD card
  * @param data		- Data to write
  * @param address	- Address in memory where data will be written
  * @param len		- Length of data in bytes
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
-int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
-		 uint64_t len)
+static int32_t write_data(struct sd_desc *sd_desc, uint8_t *data,
+			  uint64_t address, uint64_t len)
 {
 	struct cmd_desc	cmd_desc;
 	uint8_t		first_block[DATA_BLOCK_LEN] __attribute__ ((aligned));
 	uint8_t		last_block[DATA_BLOCK_LEN] __attribute__ ((aligned));
-
-	/* Initial checks */
-	if (data == NULL || address > sd_desc->memory_size ||
-	    len > sd_desc->memory_size || address + len > sd_desc->memory_size)
-		return FAILURE;
+	uint32_t	nb_of_blocks;
 
 	/* Read first and last block in memory if needed to be updated with user data and then written back                                                                        */
 	/* If not writing from the beginning of a block or */
@@ -490,8 +525,23 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 		sd_read(sd_desc, last_block, (address + len - 1) & MASK_BLOCK_NUMBER,
 			DATA_BLOCK_LEN);
 
+	/* Let the card erase the blocks of a multiple block write before the
+	 * data arrives */
+	nb_of_blocks = get_nb_of_blocks(address, len);
+	if (nb_of_blocks != 1) {
+		cmd_desc.cmd = ACMD(23);
+		cmd_desc.arg = min(nb_of_blocks, MAX_PRE_ERASE_BLOCKS);
+		cmd_desc.response_len = R1_LEN;
+		if (SUCCESS != send_command(sd_desc, &cmd_desc))
+			return FAILURE;
+		if (cmd_desc.response[0] != R1_READY_STATE) {
+			DEBUG_MSG("Failed to set the pre-erase count\n");
+			return FAILURE;
+		}
+	}
+
 	/* Send write command to SD */
-	cmd_desc.cmd = (get_nb_of_blocks(address, len) == 1) ? CMD(24): CMD(25);
+	cmd_desc.cmd = (nb_of_blocks == 1) ? CMD(24): CMD(25);
 	cmd_desc.arg = address >> DATA_BLOCK_BITS; //Address of first block
 	cmd_desc.response_len = R1_LEN;
 	if (SUCCESS != send_command(sd_desc, &cmd_desc))
@@ -507,7 +557,7 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 		return FAILURE;
 
 	/* Send stop transmission token */
-	if (get_nb_of_blocks(address, len) != 1) {
+	if (nb_of_blocks != 1) {
 		sd_desc->buff[0] = STOP_TRANSMISSION_TOKEN;
 		sd_desc->buff[1] = 0xFF;
 		if (SUCCESS != spi_write_and_read(sd_desc->spi_desc, sd_desc->buff, 2))
@@ -519,6 +569,91 @@ int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
 	return SUCCESS;
 }
 
+/**
+ * Write the blocks held in the cache to the card
+ * @param sd_desc	- Instance of the SD card
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t cache_flush(struct sd_desc *sd_desc)
+{
+	uint32_t	nb;
+
+	nb = sd_desc->cache_nb;
+	if (!nb)
+		return SUCCESS;
+
+	/* The blocks are dropped even if the write fails */
+	sd_desc->cache_nb = 0;
+
+	return write_data(sd_desc, sd_desc->cache, sd_desc->cache_addr,
+			  (uint64_t)nb << DATA_BLOCK_BITS);
+}
+
+/**
+ * Write data of size len to the specified address
+ * When the cache is enabled, whole blocks written after each other are
+ * gathered and written by a single multiple block write, when the cache is
+ * full, when other data is accessed or by sd_sync(). Otherwise, this
+ * operation returns only when the write is complete.
+ * @param sd_desc	- Instance of the SD card
+ * @param data		- Data to write
+ * @param address	- Address in memory where data will be written
+ * @param len		- Length of data in bytes
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_write(struct sd_desc *sd_desc, uint8_t *data, uint64_t address,
+		 uint64_t len)
+{
+	uint32_t	nb;
+
+	/* Initial checks */
+	if (data == NULL || address > sd_desc->memory_size ||
+	    len > sd_desc->memory_size || address + len > sd_desc->memory_size)
+		return FAILURE;
+
+	/* Not following the cached blocks */
+	if (sd_desc->cache_nb && address != sd_desc->cache_addr +
+	    ((uint64_t)sd_desc->cache_nb << DATA_BLOCK_BITS))
+		if (SUCCESS != cache_flush(sd_desc))
+			return FAILURE;
+
+	nb = len >> DATA_BLOCK_BITS;
+	if (!sd_desc->cache_blocks || (address & MASK_ADDR_IN_BLOCK) ||
+	    (len & MASK_ADDR_IN_BLOCK) || nb > sd_desc->cache_blocks) {
+		if (SUCCESS != cache_flush(sd_desc))
+			return FAILURE;
+
+		return write_data(sd_desc, data, address, len);
+	}
+
+	if (sd_desc->cache_nb + nb > sd_desc->cache_blocks)
+		if (SUCCESS != cache_flush(sd_desc))
+			return FAILURE;
+
+	if (!sd_desc->cache_nb)
+		sd_desc->cache_addr = address;
+	memcpy(sd_desc->cache + ((uint32_t)sd_desc->cache_nb << DATA_BLOCK_BITS),
+	       data, len);
+	sd_desc->cache_nb += nb;
+	if (sd_desc->cache_nb == sd_desc->cache_blocks)
+		return cache_flush(sd_desc);
+
+	return SUCCESS;
+}
+
+/**
+ * Write the data held in the cache to the card
+ * @param sd_desc	- Instance of the SD card
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t sd_sync(struct sd_desc *sd_desc)
+{
+	if (!sd_desc)
+		return FAILURE;
+
+	return cache_flush(sd_desc);
+}
+
 /**
  * Initialize an instance of SD card and stores it to the parameter desc
  * @param sd_desc	- Pointer where to store the instance of the SD
@@ -539,6 +674,13 @@ int32_t sd_init(struct sd_desc **sd_desc, const struct sd_init_param *param)
 	if (!local_desc)
 		return FAILURE;
 	local_desc->spi_desc = param->spi_desc;
+	if (param->cache_blocks) {
+		local_desc->cache = malloc((uint64_t)param->cache_blocks <<
+					   DATA_BLOCK_BITS);
+		if (!local_desc->cache)
+			goto failure;
+		local_desc->cache_blocks = param->cache_blocks;
+	}
 
 	/* Synchronize SD card frequency: Send 10 dummy bytes*/
 	memset(local_desc->buff, 0xFF, 10);
@@ -627,20 +769,26 @@ int32_t sd_init(struct sd_desc **sd_desc, const struct sd_init_param *param)
 
 	return SUCCESS;
 failure:
+	free(local_desc->cache);
 	free(local_desc);
 	return FAILURE;
 }
 
 /**
- * Remove the initialize instance of SD card.
+ * Remove the initialize instance of SD card. The cached data is written
+ * first.
  * @param desc	- Instance of the SD card
  * @return SUCCESS in case of success, FAILURE otherwise.
  */
 int32_t sd_remove(struct sd_desc *desc)
 {
+	int32_t	ret;
+
 	if (desc == NULL)
 		return FAILURE;
 
+	ret = cache_flush(desc);
+	free(desc->cache);
 	free(desc);
-	return SUCCESS;
+	return ret;
 }
@@ -85,6 +85,8 @@
 struct sd_init_param {
 	/** Descriptor of an initialized SPI channel */
 	struct spi_desc *spi_desc;
+	/** Number of blocks of the write cache, 0 to write through */
+	uint32_t	cache_blocks;
 };
 
 /**
@@ -100,6 +102,14 @@ struct sd_desc {
 	uint8_t		high_capacity;
 	/** Buffer used for the driver implementation */
 	uint8_t		buff[18];
+	/** Blocks written after each other, waiting to be sent together */
+	uint8_t		*cache;
+	/** Size of the cache in blocks */
+	uint32_t	cache_blocks;
+	/** Address of the first cached block */
+	uint64_t	cache_addr;
+	/** Number of cached blocks */
+	uint32_t	cache_nb;
 };
 
 /**
@@ -132,6 +142,7 @@ int32_t sd_write(struct sd_desc *desc,
 		 uint8_t *data,
 		 uint64_t address,
 		 uint64_t len);
+int32_t sd_sync(struct sd_desc *desc);
 
 #endif /* __SD_H__ */
 
@@ -40,6 +40,7 @@
 #include <inttypes.h>
 #include "spi.h"
 #include <stdlib.h>
+#include <string.h>
 #include "error.h"
 
 /**
@@ -58,6 +59,8 @@ int32_t spi_init(struct spi_desc **desc,
 		return FAILURE;
 
 	(*desc)->platform_ops = param->platform_ops;
+	(*desc)->batch = NULL;
+	(*desc)->drv_data = NULL;
 
 	return SUCCESS;
 }
@@ -69,11 +72,48 @@ int32_t spi_init(struct spi_desc **desc,
  */
 int32_t spi_remove(struct spi_desc *desc)
 {
+	if (desc->batch) {
+		free(desc->batch->msgs);
+		free(desc->batch->dests);
+		free(desc->batch->buff);
+		free(desc->batch);
+		desc->batch = NULL;
+	}
+
 	return desc->platform_ops->remove(desc);
 }
 
+/* Copy an access to the queue of the descriptor, sending the queue first if
+ * it is full. dest is where the received data goes once sent. */
+static int32_t spi_batch_queue(struct spi_desc *desc, uint8_t *data,
+			       uint16_t bytes_number, uint8_t *dest)
+{
+	struct spi_batch *batch = desc->batch;
+	struct spi_msg *msg;
+	int32_t ret;
+
+	if (batch->nb_msgs == batch->max_msgs ||
+	    batch->used + bytes_number > batch->size) {
+		ret = spi_batch_flush(desc);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	batch->dests[batch->nb_msgs] = dest;
+	msg = &batch->msgs[batch->nb_msgs++];
+	msg->tx_buff = batch->buff + batch->used;
+	msg->rx_buff = msg->tx_buff;
+	msg->bytes_number = bytes_number;
+	msg->cs_change = 1;
+	memcpy(msg->tx_buff, data, bytes_number);
+	batch->used += bytes_number;
+
+	return SUCCESS;
+}
+
 /**
- * @brief Write and read data to/from SPI.
+ * @brief Write and read data to/from SPI. If accesses are queued on the
+ * descriptor, this one is sent with them, in the same transfer.
  * @param desc - The SPI descriptor.
  * @param data - The buffer with the transmitted/received data.
  * @param bytes_number - Number of bytes to write/read.
@@ -83,9 +123,42 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 			   uint8_t *data,
 			   uint16_t bytes_number)
 {
+	int32_t ret;
+
+	if (desc->batch && desc->batch->nb_msgs &&
+	    bytes_number <= desc->batch->size) {
+		ret = spi_batch_queue(desc, data, bytes_number, data);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		return spi_batch_flush(desc);
+	}
+
 	return desc->platform_ops->write_and_read(desc, data, bytes_number);
 }
 
+/* spi_transfer() without sending the queued writes first */
+static int32_t _spi_transfer(struct spi_desc *desc, struct spi_msg *msgs,
+			     uint32_t len)
+{
+	int32_t  ret;
+	uint32_t i;
+
+	if (desc->platform_ops->transfer)
+		return desc->platform_ops->transfer(desc, msgs, len);
+
+	for (i = 0; i < len; i++) {
+		if (msgs[i].rx_buff != msgs[i].tx_buff || !msgs[i].tx_buff)
+			return -EINVAL;
+		ret = desc->platform_ops->write_and_read(desc, msgs[i].rx_buff,
+				msgs[i].bytes_number);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief  Iterate over head list and send all spi messages
  * @param desc - The SPI descriptor.
@@ -95,23 +168,166 @@ int32_t spi_write_and_read(struct spi_desc *desc,
  */
 int32_t spi_transfer(struct spi_desc *desc, struct spi_msg *msgs, uint32_t len)
 {
-	int32_t  ret;
-	uint32_t i;
+	int32_t ret;
 
 	if (!desc || !desc->platform_ops)
 		return -EINVAL;
 
-	if (desc->platform_ops->transfer)
-		return desc->platform_ops->transfer(desc, msgs, len);
+	/* The queued writes go first */
+	ret = spi_batch_flush(desc);
+	if (IS_ERR_VALUE(ret))
+		return ret;
 
-	for (i = 0; i < len; i++) {
-		if (msgs[i].rx_buff != msgs[i].tx_buff || !msgs[i].tx_buff)
-			return -EINVAL;
-		ret = spi_write_and_read(desc, msgs[i].rx_buff,
-					 msgs[i].bytes_number);
-		if (IS_ERR_VALUE(ret))
-			return ret;
+	return _spi_transfer(desc, msgs, len);
+}
+
+/**
+ * @brief Start queuing the accesses done with spi_batch_write() and
+ * spi_batch_read(), to send them with a single transfer. The queue is
+ * allocated by the first call and kept until spi_remove(). Calls can be
+ * nested, the accesses are sent by the last spi_batch_end(), by
+ * spi_batch_flush(), when the queue is full or with any other access through
+ * the descriptor, so the order of the accesses is kept. Queued accesses must
+ * not be followed by delays the device relies on, call spi_batch_flush()
+ * before those.
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t spi_batch_begin(struct spi_desc *desc)
+{
+	struct spi_batch *batch;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->batch) {
+		batch = calloc(1, sizeof(*batch));
+		if (!batch)
+			return -ENOMEM;
+
+		batch->msgs = calloc(SPI_BATCH_MAX_MSGS, sizeof(*batch->msgs));
+		batch->dests = calloc(SPI_BATCH_MAX_MSGS,
+				      sizeof(*batch->dests));
+		batch->buff = malloc(SPI_BATCH_SIZE);
+		if (!batch->msgs || !batch->dests || !batch->buff) {
+			free(batch->msgs);
+			free(batch->dests);
+			free(batch->buff);
+			free(batch);
+			return -ENOMEM;
+		}
+		batch->max_msgs = SPI_BATCH_MAX_MSGS;
+		batch->size = SPI_BATCH_SIZE;
+
+		desc->batch = batch;
 	}
 
+	desc->batch->depth++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief End a spi_batch_begin() call. The queued accesses are sent when the
+ * outermost batch ends.
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t spi_batch_end(struct spi_desc *desc)
+{
+	if (!desc || !desc->batch || !desc->batch->depth)
+		return -EINVAL;
+
+	if (--desc->batch->depth)
+		return SUCCESS;
+
+	return spi_batch_flush(desc);
+}
+
+/**
+ * @brief Write data to SPI. The data is copied to the queue of the descriptor
+ * if a batch is started, or sent right away with spi_write_and_read().
+ * @param desc - The SPI descriptor.
+ * @param data - The data to write. Overwritten with the received data if it
+ *		 is sent right away.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, negative error code otherwise. Errors of
+ * queued writes are returned by the call sending them.
+ */
+int32_t spi_batch_write(struct spi_desc *desc, uint8_t *data,
+			uint16_t bytes_number)
+{
+	struct spi_batch *batch;
+
+	if (!desc)
+		return -EINVAL;
+
+	batch = desc->batch;
+	if (!batch || !batch->depth || bytes_number > batch->size)
+		return spi_write_and_read(desc, data, bytes_number);
+
+	return spi_batch_queue(desc, data, bytes_number, NULL);
+}
+
+/**
+ * @brief Write and read data to/from SPI. The data is copied to the queue of
+ * the descriptor if a batch is started, and the received data is copied back
+ * to data once the queue is sent, so data must stay valid until then. Call
+ * spi_batch_flush() to get it right away, in the same transfer as the queued
+ * accesses. Without a batch, the data is sent with spi_write_and_read().
+ * @param desc - The SPI descriptor.
+ * @param data - The data to write, overwritten with the received data.
+ * @param bytes_number - Number of bytes to write/read.
+ * @return SUCCESS in case of success, negative error code otherwise. Errors of
+ * queued accesses are returned by the call sending them.
+ */
+int32_t spi_batch_read(struct spi_desc *desc, uint8_t *data,
+		       uint16_t bytes_number)
+{
+	struct spi_batch *batch;
+
+	if (!desc)
+		return -EINVAL;
+
+	batch = desc->batch;
+	if (!batch || !batch->depth || bytes_number > batch->size)
+		return spi_write_and_read(desc, data, bytes_number);
+
+	return spi_batch_queue(desc, data, bytes_number, data);
+}
+
+/**
+ * @brief Send the accesses queued on a descriptor and copy the data received
+ * by the queued reads.
+ * @param desc - The SPI descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t spi_batch_flush(struct spi_desc *desc)
+{
+	struct spi_batch *batch;
+	uint32_t nb_msgs;
+	uint32_t i;
+	int32_t ret;
+
+	if (!desc)
+		return -EINVAL;
+
+	batch = desc->batch;
+	if (!batch || !batch->nb_msgs)
+		return SUCCESS;
+
+	nb_msgs = batch->nb_msgs;
+	batch->nb_msgs = 0;
+	batch->used = 0;
+
+	ret = _spi_transfer(desc, batch->msgs, nb_msgs);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	for (i = 0; i < nb_msgs; i++)
+		if (batch->dests[i])
+			memcpy(batch->dests[i], batch->msgs[i].rx_buff,
+			       batch->msgs[i].bytes_number);
+
 	return SUCCESS;
 }
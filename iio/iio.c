@@ -52,12 +52,12 @@
 #include "list.h"
 #include "error.h"
 #include "uart.h"
+#include "circular_buffer.h"
+#include "delay.h"
 #include <inttypes.h>
 
 #ifdef ENABLE_IIO_NETWORK
-#include "delay.h"
 #include "tcp_socket.h"
-#include "circular_buffer.h"
 #endif
 
 /******************************************************************************/
@@ -66,7 +66,20 @@
 
 #define IIOD_PORT		30431
 #define MAX_SOCKET_TO_HANDLE	4
+/* Bytes of pending commands buffered for each network client */
+#define IIO_CLIENT_BUFF_SIZE	256
+/* Largest command payload buffered before the command is executed. Larger
+ * payloads are received while the other clients wait. */
+#define IIO_CLIENT_BUFF_MAX	0x10000
+/* Time to wait for network events when no client has work to do */
+#define IIO_WAIT_TIMEOUT_MS	100
+/* Time between two polls of a continuous capture waiting for its DMA */
+#define IIO_CONT_POLL_US	10
+/* Number of chunks of the ring of a continuous capture */
+#define IIO_CONT_CHUNKS		4
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
+/* Maximum length of a channel id (e.g. "voltage0-voltage1") */
+#define IIO_CH_ID_SIZE		64
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -118,6 +131,47 @@ struct attr_fun_params {
 	struct iio_ch_info	*ch_info;
 };
 
+/**
+ * @struct iio_hash_entry
+ * @brief Entry of an open addressing hash table mapping names to objects.
+ */
+struct iio_hash_entry {
+	/** Name used as key, NULL if the entry is empty */
+	const char	*key;
+	/** Hash of key */
+	uint32_t	hash;
+	/** Object found by key */
+	void		*val;
+};
+
+/**
+ * @struct iio_hash
+ * @brief Lookup table built at registration time, so devices, channels
+ * and attributes are found without walking through all of them.
+ */
+struct iio_hash {
+	/** Number of entries, a power of 2 */
+	uint32_t		size;
+	/** Table entries */
+	struct iio_hash_entry	*entries;
+};
+
+/**
+ * @struct iio_ch_index
+ * @brief Lookup information of a channel.
+ */
+struct iio_ch_index {
+	/** Channel id used as key in the channel table */
+	char			id[IIO_CH_ID_SIZE];
+	/** Channel described by this entry */
+	struct iio_channel	*ch;
+	/** Attributes of the channel. Channels with the same attribute array
+	 * share the table of the first one */
+	struct iio_hash		*attrs;
+	/** Storage for attrs if the table is owned by this channel */
+	struct iio_hash		attrs_storage;
+};
+
 /**
  * @struct iio_interface
  * @brief Links a physical device instance "void *dev_instance"
@@ -130,6 +184,8 @@ struct iio_interface {
 	const char		*name;
 	/** Opened channels */
 	uint32_t		ch_mask;
+	/** Bytes of a sample of all the opened channels */
+	uint32_t		scan_size;
 	/** Physical instance of a device */
 	void			*dev_instance;
 	/** Used to read debug attributes */
@@ -138,24 +194,90 @@ struct iio_interface {
 	struct iio_device	*dev_descriptor;
 	struct iio_data_buffer	*write_buffer;
 	struct iio_data_buffer	*read_buffer;
+	/** Ring over read_buffer used in continuous capture mode */
+	struct circular_buffer	*read_cb;
+	/** Number of bytes captured at once in continuous capture mode. The
+	 * ring is made of IIO_CONT_CHUNKS chunks. */
+	uint32_t		chunk_size;
+	/** Chunk of the ring the device fills first */
+	uint32_t		next_chunk;
+	/** Number of chunks queued to the device, from next_chunk on */
+	uint32_t		chunks_queued;
+	/** Lookup information for each channel */
+	struct iio_ch_index	*ch_index;
+	/** Input and output channels, by id */
+	struct iio_hash		ch_table[2];
+	/** Device attributes, by name */
+	struct iio_hash		attr_table;
+	/** Debug attributes, by name */
+	struct iio_hash		debug_attr_table;
+	/** Buffer attributes, by name */
+	struct iio_hash		buffer_attr_table;
+};
+
+/**
+ * @struct iio_zero_copy_slice
+ * @brief Slice of a read buffer waiting to be sent on the physical link.
+ * libtinyiiod calls read_data() with its own scratch buffer and then
+ * writes that same buffer with write(), possibly in several calls. In zero
+ * copy mode read_data() only records where the data is and write() sends it
+ * from there, see iio_zero_copy_set().
+ */
+struct iio_zero_copy_slice {
+	/** Buffer given by libtinyiiod to iio_read_dev() */
+	const char		*scratch;
+	/** Data in the registered read buffer */
+	const char		*data;
+	/** Number of bytes pending */
+	size_t			len;
 };
 
+#ifdef ENABLE_IIO_NETWORK
+/**
+ * @struct iio_client
+ * @brief Connection of a network client. Each client has its own parser
+ * state so a partially received command doesn't block the other clients.
+ */
+struct iio_client {
+	/** Client socket, NULL if the slot is free */
+	struct tcp_socket_desc	*sock;
+	/** Parser instance of the client */
+	struct tinyiiod		*iiod;
+	/** Received data not yet consumed by the parser */
+	char			*buf;
+	/** Size of buf */
+	uint32_t		size;
+	/** Number of bytes in buf */
+	uint32_t		len;
+	/** Index of the next byte from buf to be given to the parser */
+	uint32_t		pos;
+	/** Set when the connection was closed by the peer */
+	bool			disconnected;
+};
+#endif
+
 struct iio_desc {
 	struct tinyiiod		*iiod;
 	struct tinyiiod_ops	*iiod_ops;
 	enum pysical_link_type	phy_type;
 	void			*phy_desc;
 	struct list_desc	*interfaces_list;
+	/* Registered interfaces, by device id */
+	struct iio_hash		dev_table;
 	char			*xml_desc;
 	uint32_t		xml_size;
 	uint32_t		xml_size_to_last_dev;
 	uint32_t		dev_count;
 	struct uart_desc	*uart_desc;
+	bool			zero_copy;
+	struct iio_zero_copy_slice	zc_slice;
 #ifdef ENABLE_IIO_NETWORK
-	/* FIFO for socket descriptors */
-	struct circular_buffer	*sockets;
-	/* Client socket active during an iio_step */
-	struct tcp_socket_desc	*current_sock;
+	/* Connected clients */
+	struct iio_client	*clients;
+	/* Maximum number of connected clients */
+	uint32_t		max_clients;
+	/* Client whose command is being executed */
+	struct iio_client	*current_client;
 	/* Instance of server socket */
 	struct tcp_socket_desc	*server;
 #endif
@@ -169,97 +291,244 @@ static struct iio_desc			*g_desc;
 
 #ifdef ENABLE_IIO_NETWORK
 
-static inline int32_t _pop_sock(struct iio_desc *desc,
-				struct tcp_socket_desc **sock)
+/* Accept all waiting connections. Connections over the client limit are
+ * closed */
+static int32_t iio_accept_clients(struct iio_desc *desc)
 {
-	return cb_read(desc->sockets, sock, sizeof(*sock));
+	struct tcp_socket_desc	*sock;
+	struct iio_client	*cli;
+	uint32_t		i;
+	int32_t			ret;
+
+	while (true) {
+		ret = socket_accept(desc->server, &sock);
+		if (ret == -EAGAIN)
+			return SUCCESS;
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		cli = NULL;
+		for (i = 0; i < desc->max_clients; i++)
+			if (!desc->clients[i].sock) {
+				cli = &desc->clients[i];
+				break;
+			}
+		if (!cli) {
+			socket_remove(sock);
+			continue;
+		}
+
+		cli->buf = malloc(IIO_CLIENT_BUFF_SIZE);
+		cli->iiod = tinyiiod_create(desc->iiod_ops);
+		if (!cli->buf || !cli->iiod) {
+			free(cli->buf);
+			if (cli->iiod)
+				tinyiiod_destroy(cli->iiod);
+			cli->buf = NULL;
+			cli->iiod = NULL;
+			socket_remove(sock);
+			return -ENOMEM;
+		}
+		cli->size = IIO_CLIENT_BUFF_SIZE;
+		cli->sock = sock;
+		cli->len = 0;
+		cli->pos = 0;
+		cli->disconnected = false;
+	}
 }
 
-static inline int32_t _push_sock(struct iio_desc *desc,
-				 struct tcp_socket_desc *sock)
+/* Close the connection and free the slot of the client */
+static void iio_remove_client(struct iio_client *cli)
 {
-	return cb_write(desc->sockets, &sock, sizeof(sock));
+	socket_remove(cli->sock);
+	tinyiiod_destroy(cli->iiod);
+	free(cli->buf);
+	cli->sock = NULL;
+	cli->iiod = NULL;
+	cli->buf = NULL;
 }
 
-static inline int32_t _nb_active_sockets(struct iio_desc *desc)
+/*
+ * Number of bytes of the next command of the client, counting the payload of
+ * WRITE and WRITEBUF, whose size ends the command line. 0 if the command line
+ * is not received yet. Like the parser, skip the empty lines before it.
+ */
+static uint32_t iio_client_cmd_size(struct iio_client *cli)
 {
-	uint32_t size;
+	char		*start = cli->buf + cli->pos;
+	char		*end = cli->buf + cli->len;
+	char		*line, *eol, *num, *p;
+	uint32_t	payload;
+
+	line = start;
+	while (line < end && *line == '\n')
+		line++;
+	eol = memchr(line, '\n', end - line);
+	if (!eol)
+		return 0;
 
-	cb_size(desc->sockets, &size);
+	payload = 0;
+	if (eol - line > 5 && !strncmp(line, "WRITE", 5)) {
+		p = eol;
+		while (p > line && isspace((unsigned char)p[-1]))
+			p--;
+		num = p;
+		while (num > line && isdigit((unsigned char)num[-1]))
+			num--;
+		if (num < p && num[-1] == ' ')
+			for (; num < p && payload < IIO_CLIENT_BUFF_MAX; num++)
+				payload = payload * 10 + *num - '0';
+		payload = min(payload, (uint32_t)IIO_CLIENT_BUFF_MAX);
+	}
 
-	return size / sizeof(struct tcp_socket_desc *);
+	return eol - start + 1 + payload;
 }
 
-/* Blocking until new socket available.
- * Will iterate through a list of sockets */
-static int32_t _get_next_socket(struct iio_desc *desc)
+/* Read, without blocking, the data available for the client */
+static int32_t iio_client_recv(struct iio_client *cli)
 {
-	struct tcp_socket_desc	*sock;
-	int32_t			ret;
-	uint32_t		nb_active_sockets;
+	uint32_t	size;
+	char		*buf;
+	int32_t		ret;
 
-	/* Get all new waiting sockets.
-	 * If none is available, wait until first connection */
-	do {
-		ret = socket_accept(desc->server, &sock);
-		if (ret == -EAGAIN) {
-			nb_active_sockets = _nb_active_sockets(desc);
-			if (nb_active_sockets == 0) {
-				/* Wait until a connection exists */
-				mdelay(1);
-				continue;
-			} else {
-				break;
-			}
-		} else if (IS_ERR_VALUE(ret)) {
-			return ret;
+	/* Move unconsumed data to the beginning of the buffer */
+	if (cli->pos) {
+		memmove(cli->buf, cli->buf + cli->pos, cli->len - cli->pos);
+		cli->len -= cli->pos;
+		cli->pos = 0;
+	}
+
+	/* Make room for the payload of the next command, shrink back once the
+	 * large commands are executed. Without memory, the payload is received
+	 * by the parser. */
+	size = max(iio_client_cmd_size(cli), cli->len);
+	size = max(size, (uint32_t)IIO_CLIENT_BUFF_SIZE);
+	if (size != cli->size) {
+		buf = realloc(cli->buf, size);
+		if (buf) {
+			cli->buf = buf;
+			cli->size = size;
 		}
-		/* Add socket to queue */
-		ret = _push_sock(desc, sock);
-		if (IS_ERR_VALUE(ret))
-			return ret;
-	} while (true);
+	}
+
+	if (cli->len == cli->size)
+		return SUCCESS;
 
-	ret = _pop_sock(desc, &desc->current_sock);
+	ret = socket_recv(cli->sock, cli->buf + cli->len,
+			  cli->size - cli->len);
+	if (ret == -EAGAIN)
+		return SUCCESS;
 	if (IS_ERR_VALUE(ret)) {
-		desc->current_sock = NULL;
+		cli->disconnected = true;
 		return ret;
 	}
+	cli->len += ret;
 
 	return SUCCESS;
 }
 
-static int32_t network_read(const void *data, uint32_t len)
+/* A command can be executed once its line and its payload are received, so
+ * that the parser doesn't wait on the client. A full buffer is given to the
+ * parser anyway: it holds an invalid command or the first part of a payload
+ * too large to be buffered. */
+static inline bool iio_client_has_command(struct iio_client *cli)
 {
-	uint32_t	i;
-	int32_t		ret;
+	uint32_t size;
 
-	if ((int32_t)g_desc->current_sock == -1)
-		return -1;
+	if (cli->disconnected || cli->pos == cli->len)
+		return false;
 
-	if (g_desc->current_sock == NULL) {
-		ret = _get_next_socket(g_desc);
-		if (IS_ERR_VALUE(ret))
-			return ret;
+	size = iio_client_cmd_size(cli);
+	if (size && cli->len - cli->pos >= size)
+		return true;
+
+	return !cli->pos && cli->len == cli->size;
+}
+
+/* Wait until a client sends data or a new client connects */
+static void iio_wait_network_events(struct iio_desc *desc)
+{
+	struct tcp_socket_desc	*socks[MAX_SOCKETS_TO_WAIT];
+	uint32_t		nb_socks;
+	uint32_t		i;
+	int32_t			ret;
+
+	nb_socks = 0;
+	socks[nb_socks++] = desc->server;
+	for (i = 0; i < desc->max_clients; i++)
+		if (desc->clients[i].sock)
+			socks[nb_socks++] = desc->clients[i].sock;
+
+	ret = socket_wait(socks, nb_socks, IIO_WAIT_TIMEOUT_MS);
+	if (IS_ERR_VALUE(ret))
+		/* Network can't wait for events, poll again later */
+		mdelay(1);
+}
+
+/* Execute all the complete commands received from the clients */
+static int32_t iio_network_step(struct iio_desc *desc)
+{
+	struct iio_client	*cli;
+	bool			executed;
+	uint32_t		i;
+	int32_t			ret;
+
+	ret = iio_accept_clients(desc);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	executed = false;
+	for (i = 0; i < desc->max_clients; i++) {
+		cli = &desc->clients[i];
+		if (!cli->sock)
+			continue;
+
+		iio_client_recv(cli);
+		desc->current_client = cli;
+		while (iio_client_has_command(cli)) {
+			tinyiiod_read_command(cli->iiod);
+			executed = true;
+		}
+		desc->current_client = NULL;
+
+		if (cli->disconnected)
+			iio_remove_client(cli);
 	}
 
-	i = 0;
-	do {
-		ret = socket_recv(g_desc->current_sock,
-				  (void *)((uint8_t *)data + i), len - i);
+	if (!executed)
+		iio_wait_network_events(desc);
+
+	return SUCCESS;
+}
+
+static int32_t network_read(const void *data, uint32_t len)
+{
+	struct iio_client	*cli = g_desc->current_client;
+	uint32_t		i;
+	int32_t			ret;
+
+	if (!cli || cli->disconnected)
+		return -ENOTCONN;
+
+	/* Commands are served from the already received data */
+	i = min(len, cli->len - cli->pos);
+	memcpy((uint8_t *)data, cli->buf + cli->pos, i);
+	cli->pos += i;
+
+	/* Payload of a command may not be received yet, wait for it */
+	while (i < len) {
+		ret = socket_recv(cli->sock, (uint8_t *)data + i, len - i);
+		if (ret == -EAGAIN) {
+			socket_wait(&cli->sock, 1, IIO_WAIT_TIMEOUT_MS);
+			continue;
+		}
 		if (IS_ERR_VALUE(ret)) {
+			cli->disconnected = true;
 			*(int8_t *)data = '*';
-			break;
+			return ret;
 		}
 
 		i += ret;
-	} while (i < len);
-
-	if (ret == -ENOTCONN) {
-		/* A socket connection is disconnected, so we release
-		 * the resources and don't add it again in the list */
-		socket_remove(g_desc->current_sock);
-		g_desc->current_sock = (void *)-1;
 	}
 
 	return i;
@@ -279,18 +548,70 @@ static ssize_t iio_phy_read(char *buf, size_t len)
 	return -EINVAL;
 }
 
+/*
+ * Record the slice read_data() leaves in the read buffer instead of copying
+ * it to scratch. This relies on libtinyiiod writing scratch before calling
+ * read_data() again, as its buffer read command does. When the previous
+ * slice was not sent, the contract is broken: zero copy is turned off and
+ * false is returned, the caller must copy the data to scratch.
+ */
+static bool iio_zero_copy_set(char *scratch, const char *data, size_t len)
+{
+	struct iio_zero_copy_slice *zc = &g_desc->zc_slice;
+
+	if (zc->len) {
+		g_desc->zero_copy = false;
+		zc->len = 0;
+		return false;
+	}
+
+	zc->scratch = scratch;
+	zc->data = data;
+	zc->len = len;
+
+	return true;
+}
+
 /** Write to a peripheral device (UART, USB, NETWORK) */
 static ssize_t iio_phy_write(const char *buf, size_t len)
 {
-	if (g_desc->phy_type == USE_UART)
-		return (ssize_t)uart_write(g_desc->uart_desc,
-					   (uint8_t *)buf, (size_t)len);
+	struct iio_zero_copy_slice *zc = &g_desc->zc_slice;
+	bool zc_write;
+	ssize_t ret;
+
+	/* Send the pending slice straight from the read buffer */
+	zc_write = zc->len && buf == zc->scratch;
+	if (zc_write) {
+		len = min(len, zc->len);
+		buf = zc->data;
+	}
+
+	ret = -EINVAL;
+	if (g_desc->phy_type == USE_UART) {
+		/* uart_write() returns SUCCESS once all the data is sent */
+		ret = (ssize_t)uart_write(g_desc->uart_desc,
+					  (uint8_t *)buf, (size_t)len);
+		if (ret >= 0)
+			ret = len;
+	}
 #ifdef ENABLE_IIO_NETWORK
 	else
-		return socket_send(g_desc->current_sock, buf, len);
+		ret = socket_send(g_desc->current_client->sock, buf, len);
 #endif
 
-	return -EINVAL;
+	if (zc_write) {
+		if (ret < 0) {
+			/* Drop the slice, the next read records a new one */
+			zc->len = 0;
+		} else {
+			/* The rest is sent by the next writes of scratch */
+			zc->scratch += ret;
+			zc->data += ret;
+			zc->len -= ret;
+		}
+	}
+
+	return ret;
 }
 
 static inline void _print_ch_id(char *buff, struct iio_channel *ch)
@@ -313,50 +634,130 @@ static inline void _print_ch_id(char *buff, struct iio_channel *ch)
 	}
 }
 
+/* FNV-1a hash of a string */
+static uint32_t iio_hash_str(const char *str)
+{
+	uint32_t hash = 2166136261u;
+
+	while (*str) {
+		hash ^= (uint8_t)*str++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/* Allocate a table with room for nb_keys keys */
+static int32_t iio_hash_init(struct iio_hash *table, uint32_t nb_keys)
+{
+	uint32_t size;
+
+	/* Keep the load factor under 1/2 so probing sequences stay short */
+	size = 1;
+	while (size < 2 * nb_keys)
+		size <<= 1;
+
+	table->entries = calloc(size, sizeof(*table->entries));
+	if (!table->entries)
+		return -ENOMEM;
+	table->size = size;
+
+	return SUCCESS;
+}
+
+static void iio_hash_remove(struct iio_hash *table)
+{
+	free(table->entries);
+	table->entries = NULL;
+	table->size = 0;
+}
+
+/* Add a key to a table that has room for it. Existing keys are kept. */
+static void iio_hash_add(struct iio_hash *table, const char *key, void *val)
+{
+	struct iio_hash_entry	*entry;
+	uint32_t		hash;
+	uint32_t		i;
+
+	hash = iio_hash_str(key);
+	i = hash & (table->size - 1);
+	while (table->entries[i].key) {
+		entry = &table->entries[i];
+		if (entry->hash == hash && !strcmp(entry->key, key))
+			return;
+		i = (i + 1) & (table->size - 1);
+	}
+
+	table->entries[i].key = key;
+	table->entries[i].hash = hash;
+	table->entries[i].val = val;
+}
+
+static void *iio_hash_find(struct iio_hash *table, const char *key)
+{
+	struct iio_hash_entry	*entry;
+	uint32_t		hash;
+	uint32_t		i;
+
+	if (!table->size)
+		return NULL;
+
+	hash = iio_hash_str(key);
+	i = hash & (table->size - 1);
+	while (table->entries[i].key) {
+		entry = &table->entries[i];
+		if (entry->hash == hash && !strcmp(entry->key, key))
+			return entry->val;
+		i = (i + 1) & (table->size - 1);
+	}
+
+	return NULL;
+}
+
+/* Build a table with the attributes of a NULL terminated array */
+static int32_t iio_hash_attributes(struct iio_hash *table,
+				   struct iio_attribute *attributes)
+{
+	uint32_t	i;
+	int32_t		ret;
+
+	if (!attributes)
+		return SUCCESS;
+
+	for (i = 0; attributes[i].name; i++)
+		;
+
+	ret = iio_hash_init(table, i);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	for (i = 0; attributes[i].name; i++)
+		iio_hash_add(table, attributes[i].name, &attributes[i]);
+
+	return SUCCESS;
+}
+
 /**
- * @brief Get channel ID from a list of channels.
+ * @brief Get channel from the channels of a device.
  * @param channel - Channel name.
- * @param desc - Device descriptor
+ * @param intf - Interface of the device
  * @param ch_out - If "true" is output channel, if "false" is input channel.
- * @return Channel ID, or negative value if attribute is not found.
+ * @return Channel index, or NULL if channel is not found.
  */
-static inline struct iio_channel *iio_get_channel(const char *channel,
-		struct iio_device *desc, bool ch_out)
+static inline struct iio_ch_index *iio_get_channel(const char *channel,
+		struct iio_interface *intf, bool ch_out)
 {
-	int16_t i = 0;
-	char	ch_id[64];
-
-	while (i < desc->num_ch) {
-		_print_ch_id(ch_id, &desc->channels[i]);
-		if (!strcmp(channel, ch_id) &&
-		    (desc->channels[i].ch_out == ch_out))
-			return &desc->channels[i];
-		i++;
-	}
-
-	return NULL;
+	return iio_hash_find(&intf->ch_table[ch_out], channel);
 }
 
 /**
  * @brief Find interface with "device_name".
  * @param device_name - Device name.
- * @param iio_interfaces - List of interfaces.
  * @return Interface pointer if interface is found, NULL otherwise.
  */
 static struct iio_interface *iio_get_interface(const char *device_name)
 {
-	struct iio_interface	*interface;
-	struct iio_interface	cmp_val;
-	int32_t					ret;
-
-	strcpy(cmp_val.dev_id, device_name);
-
-	ret = list_read_find(g_desc->interfaces_list,
-			     (void **)&interface, &cmp_val);
-	if (IS_ERR_VALUE(ret))
-		return NULL;
-
-	return interface;
+	return iio_hash_find(&g_desc->dev_table, device_name);
 }
 
 /**
@@ -429,42 +830,37 @@ static ssize_t iio_write_all_attr(struct attr_fun_params *params,
 /**
  * @brief Read/write attribute.
  * @param params - Structure describing parameters for store and show functions
- * @param attributes - Array of attributes.
+ * @param table - Attributes table.
  * @param attr_name - Attribute name to be modified
  * @param is_write -If it has value "1", writes attribute, otherwise reads
  * 		attribute.
  * @return Length of chars written/read or negative value in case of error.
  */
 static ssize_t iio_rd_wr_attribute(struct attr_fun_params *params,
-				   struct iio_attribute *attributes,
+				   struct iio_hash *table,
 				   char *attr_name,
 				   bool is_write)
 {
-	int16_t i = 0;
+	struct iio_attribute *attr;
 
-	/* Search attribute */
-	while (attributes[i].name) {
-		if (!strcmp(attr_name, attributes[i].name))
-			break;
-		i++;
-	}
+	if (!table)
+		return -ENOENT;
 
-	if (!attributes[i].name)
+	attr = iio_hash_find(table, attr_name);
+	if (!attr)
 		return -ENOENT;
 
 	if (is_write) {
-		if (!attributes[i].store)
+		if (!attr->store)
 			return -ENOENT;
 
-		return attributes[i].store(params->dev_instance, params->buf,
-					   params->len, params->ch_info,
-					   attributes[i].priv);
+		return attr->store(params->dev_instance, params->buf,
+				   params->len, params->ch_info, attr->priv);
 	} else {
-		if (!attributes[i].show)
+		if (!attr->show)
 			return -ENOENT;
-		return attributes[i].show(params->dev_instance, params->buf,
-					  params->len, params->ch_info,
-					  attributes[i].priv);
+		return attr->show(params->dev_instance, params->buf,
+				  params->len, params->ch_info, attr->priv);
 	}
 }
 
@@ -657,6 +1053,7 @@ static ssize_t iio_read_attr(const char *device_id, const char *attr, char *buf,
 	struct iio_interface	*dev;
 	struct attr_fun_params	params;
 	struct iio_attribute	*attributes;
+	struct iio_hash		*table;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
@@ -667,6 +1064,7 @@ static ssize_t iio_read_attr(const char *device_id, const char *attr, char *buf,
 	params.dev_instance = dev->dev_instance;
 	params.ch_info = NULL;
 	attributes = NULL;
+	table = NULL;
 	switch (type) {
 	case IIO_ATTR_TYPE_DEBUG:
 		if (strcmp(attr, REG_ACCESS_ATTRIBUTE) == 0) {
@@ -676,19 +1074,22 @@ static ssize_t iio_read_attr(const char *device_id, const char *attr, char *buf,
 				return -ENOENT;
 		}
 		attributes = dev->dev_descriptor->debug_attributes;
+		table = &dev->debug_attr_table;
 		break;
 	case IIO_ATTR_TYPE_DEVICE:
 		attributes = dev->dev_descriptor->attributes;
+		table = &dev->attr_table;
 		break;
 	case IIO_ATTR_TYPE_BUFFER:
 		attributes = dev->dev_descriptor->buffer_attributes;
+		table = &dev->buffer_attr_table;
 		break;
 	}
 
 	if (!strcmp(attr, ""))
 		return iio_read_all_attr(&params, attributes);
 	else
-		return iio_rd_wr_attribute(&params,attributes, (char *)attr, 0);
+		return iio_rd_wr_attribute(&params, table, (char *)attr, 0);
 }
 
 /**
@@ -707,6 +1108,7 @@ static ssize_t iio_write_attr(const char *device_id, const char *attr,
 	struct iio_interface	*dev;
 	struct attr_fun_params	params;
 	struct iio_attribute	*attributes;
+	struct iio_hash		*table;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
@@ -717,6 +1119,7 @@ static ssize_t iio_write_attr(const char *device_id, const char *attr,
 	params.dev_instance = dev->dev_instance;
 	params.ch_info = NULL;
 	attributes = NULL;
+	table = NULL;
 	switch (type) {
 	case IIO_ATTR_TYPE_DEBUG:
 		if (strcmp(attr, REG_ACCESS_ATTRIBUTE) == 0) {
@@ -726,19 +1129,22 @@ static ssize_t iio_write_attr(const char *device_id, const char *attr,
 				return -ENOENT;
 		}
 		attributes = dev->dev_descriptor->debug_attributes;
+		table = &dev->debug_attr_table;
 		break;
 	case IIO_ATTR_TYPE_DEVICE:
 		attributes = dev->dev_descriptor->attributes;
+		table = &dev->attr_table;
 		break;
 	case IIO_ATTR_TYPE_BUFFER:
 		attributes = dev->dev_descriptor->buffer_attributes;
+		table = &dev->buffer_attr_table;
 		break;
 	}
 
 	if (!strcmp(attr, ""))
 		return iio_write_all_attr(&params, attributes);
 	else
-		return iio_rd_wr_attribute(&params, attributes, (char *)attr, 1);
+		return iio_rd_wr_attribute(&params, table, (char *)attr, 1);
 }
 
 /**
@@ -757,15 +1163,17 @@ static ssize_t iio_ch_read_attr(const char *device_id, const char *channel,
 	struct iio_interface	*dev;
 	struct iio_ch_info	ch_info;
 	struct iio_channel	*ch;
+	struct iio_ch_index	*ch_idx;
 	struct attr_fun_params	params;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
 		return FAILURE;
 
-	ch = iio_get_channel(channel, dev->dev_descriptor, ch_out);
-	if (!ch)
+	ch_idx = iio_get_channel(channel, dev, ch_out);
+	if (!ch_idx)
 		return -ENOENT;
+	ch = ch_idx->ch;
 
 	ch_info.ch_out = ch_out;
 	ch_info.ch_num = ch->channel;
@@ -779,7 +1187,8 @@ static ssize_t iio_ch_read_attr(const char *device_id, const char *channel,
 	if (!strcmp(attr, ""))
 		return iio_read_all_attr(&params, ch->attributes);
 	else
-		return iio_rd_wr_attribute(&params, ch->attributes, (char *)attr, 0);
+		return iio_rd_wr_attribute(&params, ch_idx->attrs, (char *)attr,
+					   0);
 }
 
 /**
@@ -798,15 +1207,17 @@ static ssize_t iio_ch_write_attr(const char *device_id, const char *channel,
 	struct iio_interface	*dev;
 	struct iio_ch_info	ch_info;
 	struct iio_channel	*ch;
+	struct iio_ch_index	*ch_idx;
 	struct attr_fun_params	params;
 
 	dev = iio_get_interface(device_id);
 	if (!dev)
 		return -ENOENT;
 
-	ch = iio_get_channel(channel, dev->dev_descriptor, ch_out);
-	if (!ch)
+	ch_idx = iio_get_channel(channel, dev, ch_out);
+	if (!ch_idx)
 		return -ENOENT;
+	ch = ch_idx->ch;
 
 	ch_info.ch_out = ch_out;
 	ch_info.ch_num = ch->channel;
@@ -820,7 +1231,203 @@ static ssize_t iio_ch_write_attr(const char *device_id, const char *channel,
 	if (!strcmp(attr, ""))
 		return iio_write_all_attr(&params, ch->attributes);
 	else
-		return iio_rd_wr_attribute(&params, ch->attributes, (char *)attr, 1);
+		return iio_rd_wr_attribute(&params, ch_idx->attrs, (char *)attr,
+					   1);
+}
+
+/* Number of bytes of one sample of all the channels in mask */
+static uint32_t iio_scan_size(struct iio_device *dev, uint32_t mask)
+{
+	uint32_t size = 0;
+	uint32_t ch;
+
+	while (mask) {
+		ch = find_first_set_bit(mask);
+		mask &= mask - 1;
+		if (dev->channels[ch].scan_type)
+			size += dev->channels[ch].scan_type->storagebits / 8;
+	}
+
+	return size;
+}
+
+static uint32_t bytes_to_samples(struct iio_interface *intf, uint32_t bytes)
+{
+	if (!intf->scan_size)
+		return 0;
+
+	return bytes / intf->scan_size;
+}
+
+/*
+ * Queue to the device the chunks of a continuous capture that hold no unread
+ * data, so that it moves from one to the next without a gap.
+ */
+static int32_t iio_cont_queue(struct iio_interface *intf)
+{
+	uint8_t		*buff;
+	uint32_t	size;
+	uint32_t	idx;
+	int32_t		ret;
+
+	cb_size(intf->read_cb, &size);
+	while (size + (intf->chunks_queued + 1) * intf->chunk_size <=
+	       IIO_CONT_CHUNKS * intf->chunk_size) {
+		idx = (intf->next_chunk + intf->chunks_queued) %
+		      IIO_CONT_CHUNKS;
+		buff = (uint8_t *)intf->read_buffer->buff +
+		       idx * intf->chunk_size;
+		ret = intf->dev_descriptor->read_dev_async(intf->dev_instance,
+				buff, bytes_to_samples(intf, intf->chunk_size));
+		/* The device queue is full */
+		if (ret == -EBUSY && intf->chunks_queued)
+			break;
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		intf->chunks_queued++;
+	}
+
+	return SUCCESS;
+}
+
+/*
+ * Add the chunks the device captured to the ring and queue the free ones
+ * again. When the device ran out of chunks because the client did not read
+ * the data in time, samples were lost: an overrun is counted and, if the ring
+ * is full, the oldest unread data is dropped to make room for a chunk.
+ */
+static int32_t iio_cont_poll(struct iio_interface *intf)
+{
+	uint32_t	ring_size = IIO_CONT_CHUNKS * intf->chunk_size;
+	uint32_t	size;
+	bool		done;
+	bool		completed = false;
+	int32_t		ret;
+
+	while (intf->chunks_queued) {
+		ret = intf->dev_descriptor->read_dev_done(intf->dev_instance,
+				&done);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		if (!done)
+			break;
+
+		cb_commit_write(intf->read_cb, intf->chunk_size);
+		intf->next_chunk = (intf->next_chunk + 1) % IIO_CONT_CHUNKS;
+		intf->chunks_queued--;
+		completed = true;
+	}
+
+	if (completed && !intf->chunks_queued) {
+		intf->read_buffer->overruns++;
+		cb_size(intf->read_cb, &size);
+		if (size + intf->chunk_size > ring_size)
+			cb_commit_read(intf->read_cb,
+				       size + intf->chunk_size - ring_size);
+	}
+
+	return iio_cont_queue(intf);
+}
+
+/* Start a continuous capture into the read buffer of the interface */
+static int32_t iio_cont_start(struct iio_interface *intf)
+{
+	struct iio_data_buffer	*r_buff = intf->read_buffer;
+	int32_t			ret;
+
+	if (!intf->dev_descriptor->read_dev_async ||
+	    !intf->dev_descriptor->read_dev_done)
+		return -ENOENT;
+
+	if (!intf->scan_size)
+		return -EINVAL;
+
+	/* The chunks are each a multiple of a scan */
+	intf->chunk_size = r_buff->size / IIO_CONT_CHUNKS;
+	intf->chunk_size -= intf->chunk_size % intf->scan_size;
+	if (!intf->chunk_size)
+		return -EINVAL;
+
+	ret = cb_init_with_buff(&intf->read_cb, r_buff->buff,
+				IIO_CONT_CHUNKS * intf->chunk_size);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	r_buff->overruns = 0;
+	intf->next_chunk = 0;
+	intf->chunks_queued = 0;
+	ret = iio_cont_queue(intf);
+	if (IS_ERR_VALUE(ret) && !intf->chunks_queued) {
+		cb_remove(intf->read_cb);
+		intf->read_cb = NULL;
+		return ret;
+	}
+
+	return SUCCESS;
+}
+
+/* Wait for the queued chunks and stop the continuous capture */
+static int32_t iio_cont_stop(struct iio_interface *intf)
+{
+	bool	done;
+	int32_t	ret;
+
+	while (intf->chunks_queued) {
+		ret = intf->dev_descriptor->read_dev_done(intf->dev_instance,
+				&done);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		if (done)
+			intf->chunks_queued--;
+		else
+			udelay(IIO_CONT_POLL_US);
+	}
+
+	cb_remove(intf->read_cb);
+	intf->read_cb = NULL;
+
+	return SUCCESS;
+}
+
+/*
+ * Read bytes_count bytes of captured data, waiting for them if needed.
+ * Capture of new chunks is restarted while waiting.
+ */
+static ssize_t iio_cont_read(struct iio_interface *intf, char *pbuf,
+			     size_t bytes_count)
+{
+	void		*data;
+	uint32_t	avail;
+	size_t		i;
+	int32_t		ret;
+
+	i = 0;
+	while (i < bytes_count) {
+		ret = iio_cont_poll(intf);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+
+		ret = cb_prepare_async_read(intf->read_cb, bytes_count - i,
+					    &data, &avail);
+		if (ret == -EAGAIN) {
+			/* Leave the bus to the DMA until the chunk is done */
+			udelay(IIO_CONT_POLL_US);
+			continue;
+		}
+		if (IS_ERR_VALUE(ret) && ret != -EOVERRUN)
+			return ret;
+
+		/* Read index is updated now but the memory is only reused
+		 * after the next poll, once the slice is sent */
+		if (!g_desc->zero_copy || avail != bytes_count ||
+		    !iio_zero_copy_set(pbuf, data, avail))
+			memcpy(pbuf + i, data, avail);
+		cb_end_async_read(intf->read_cb);
+		i += avail;
+	}
+
+	return bytes_count;
 }
 
 /**
@@ -835,6 +1442,7 @@ static int32_t iio_open_dev(const char *device, size_t sample_size,
 {
 	struct iio_interface *iface;
 	uint32_t ch_mask;
+	int32_t ret;
 
 	iface = iio_get_interface(device);
 	if (!iface)
@@ -846,10 +1454,18 @@ static int32_t iio_open_dev(const char *device, size_t sample_size,
 		return -ENOENT;
 
 	iface->ch_mask = mask;
+	iface->scan_size = iio_scan_size(iface->dev_descriptor, mask);
+
+	if (iface->dev_descriptor->prepare_transfer) {
+		ret = iface->dev_descriptor->prepare_transfer(
+			      iface->dev_instance, mask);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
 
-	if (iface->dev_descriptor->prepare_transfer)
-		return iface->dev_descriptor->prepare_transfer(
-			       iface->dev_instance, mask);
+	if (iface->read_buffer && iface->read_buffer->continuous &&
+	    !iface->read_cb)
+		return iio_cont_start(iface);
 
 	return SUCCESS;
 }
@@ -862,12 +1478,20 @@ static int32_t iio_open_dev(const char *device, size_t sample_size,
 static int32_t iio_close_dev(const char *device)
 {
 	struct iio_interface *iface;
+	int32_t ret;
 
 	iface = iio_get_interface(device);
 	if (!iface)
 		return FAILURE;
 
+	if (iface->read_cb) {
+		ret = iio_cont_stop(iface);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+	}
+
 	iface->ch_mask = 0;
+	iface->scan_size = 0;
 	if (iface->dev_descriptor->end_transfer)
 		return iface->dev_descriptor->end_transfer(iface->dev_instance);
 
@@ -893,34 +1517,6 @@ static int32_t iio_get_mask(const char *device, uint32_t *mask)
 	return SUCCESS;
 }
 
-static uint32_t bytes_to_samples(struct iio_interface *intf, uint32_t bytes)
-{
-	uint32_t bytes_per_sample;
-	uint32_t first_ch;
-	bool	 first_ch_found;
-	uint32_t nb_active_ch;
-	uint32_t mask;
-
-	mask = intf->ch_mask;
-	first_ch = 0;
-	nb_active_ch = 0;
-	first_ch_found = false;
-	while (mask) {
-		if ((mask & 1)) {
-			if (!first_ch_found)
-				first_ch_found = true;
-			else
-				first_ch++;
-			nb_active_ch++;
-		}
-		mask >>= 1;
-	}
-	bytes_per_sample = intf->dev_descriptor->channels[first_ch]
-			   .scan_type->storagebits / 8;
-
-	return bytes / bytes_per_sample / nb_active_ch;
-}
-
 /**
  * @brief Transfer data from device into RAM.
  * @param device - String containing device name.
@@ -935,6 +1531,14 @@ static ssize_t iio_transfer_dev_to_mem(const char *device, size_t bytes_count)
 	ssize_t			ret;
 
 	r_buff = iio_interface->read_buffer;
+	if (r_buff && iio_interface->read_cb) {
+		/* Data is already being captured, it is consumed as the client
+		 * reads it */
+		if (bytes_count > IIO_CONT_CHUNKS * iio_interface->chunk_size)
+			return -ENOMEM;
+		ret = iio_cont_poll(iio_interface);
+		return ret < 0 ? ret : (ssize_t)bytes_count;
+	}
 	if (r_buff && iio_interface->dev_descriptor->read_dev) {
 		if (bytes_count > r_buff->size)
 			return -ENOMEM;
@@ -953,6 +1557,8 @@ static ssize_t iio_transfer_dev_to_mem(const char *device, size_t bytes_count)
  * "iio_transfer_dev_to_mem()" first.
  * This function is probably called multiple times by libtinyiiod after a
  * "iio_transfer_dev_to_mem" call, since we can only read "bytes_count" bytes.
+ * In zero copy mode pbuf is left untouched and the chunk is sent directly from
+ * the read buffer when libtinyiiod writes pbuf to the physical link.
  * @param device - String containing device name.
  * @param pbuf - Buffer where value is stored.
  * @param offset - Offset to the remaining data after reading n chunks.
@@ -965,11 +1571,19 @@ static ssize_t iio_read_dev(const char *device, char *pbuf, size_t offset,
 	struct iio_interface *iio_interface = iio_get_interface(device);
 	struct iio_data_buffer *r_buff;
 
+	if (iio_interface->read_cb)
+		return iio_cont_read(iio_interface, pbuf, bytes_count);
+
 	r_buff = iio_interface->read_buffer;
 	if (r_buff) {
 		if (offset + bytes_count > r_buff->size)
 			return -ENOMEM;
 
+		if (g_desc->zero_copy &&
+		    iio_zero_copy_set(pbuf, (char *)r_buff->buff + offset,
+				      bytes_count))
+			return bytes_count;
+
 		memcpy(pbuf, r_buff->buff + offset, bytes_count);
 
 		return bytes_count;
@@ -1056,17 +1670,8 @@ static ssize_t iio_get_xml(char **outxml)
 ssize_t iio_step(struct iio_desc *desc)
 {
 #ifdef ENABLE_IIO_NETWORK
-	int32_t ret;
-
-	if (desc->phy_type == USE_NETWORK) {
-		if (desc->current_sock != NULL &&
-		    (int32_t)desc->current_sock != -1) {
-			ret = _push_sock(desc, desc->current_sock);
-			if (IS_ERR_VALUE(ret))
-				return ret;
-		}
-		desc->current_sock = NULL;
-	}
+	if (desc->phy_type == USE_NETWORK)
+		return iio_network_step(desc);
 #endif
 	return tinyiiod_read_command(desc->iiod);
 }
@@ -1241,6 +1846,129 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 	return i;
 }
 
+/* Free the lookup tables of an interface */
+static void iio_free_indexes(struct iio_interface *intf)
+{
+	uint32_t i;
+
+	if (intf->ch_index) {
+		for (i = 0; i < intf->dev_descriptor->num_ch; i++)
+			iio_hash_remove(&intf->ch_index[i].attrs_storage);
+		free(intf->ch_index);
+		intf->ch_index = NULL;
+	}
+	iio_hash_remove(&intf->ch_table[0]);
+	iio_hash_remove(&intf->ch_table[1]);
+	iio_hash_remove(&intf->attr_table);
+	iio_hash_remove(&intf->debug_attr_table);
+	iio_hash_remove(&intf->buffer_attr_table);
+}
+
+/* Build the lookup tables for channels and attributes of an interface */
+static int32_t iio_build_indexes(struct iio_interface *intf)
+{
+	struct iio_device	*dev = intf->dev_descriptor;
+	struct iio_ch_index	*idx;
+	uint32_t		nb_ch[2] = {0, 0};
+	uint32_t		i;
+	uint32_t		j;
+	int32_t			ret;
+
+	ret = iio_hash_attributes(&intf->attr_table, dev->attributes);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+	ret = iio_hash_attributes(&intf->debug_attr_table,
+				  dev->debug_attributes);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+	ret = iio_hash_attributes(&intf->buffer_attr_table,
+				  dev->buffer_attributes);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+
+	if (!dev->channels || !dev->num_ch)
+		return SUCCESS;
+
+	intf->ch_index = calloc(dev->num_ch, sizeof(*intf->ch_index));
+	if (!intf->ch_index) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	for (i = 0; i < dev->num_ch; i++)
+		nb_ch[dev->channels[i].ch_out]++;
+	ret = iio_hash_init(&intf->ch_table[0], nb_ch[0]);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+	ret = iio_hash_init(&intf->ch_table[1], nb_ch[1]);
+	if (IS_ERR_VALUE(ret))
+		goto error;
+
+	for (i = 0; i < dev->num_ch; i++) {
+		idx = &intf->ch_index[i];
+		idx->ch = &dev->channels[i];
+		_print_ch_id(idx->id, idx->ch);
+		iio_hash_add(&intf->ch_table[idx->ch->ch_out], idx->id, idx);
+
+		/* Reuse the table of a channel with the same attributes */
+		for (j = 0; j < i; j++)
+			if (intf->ch_index[j].ch->attributes ==
+			    idx->ch->attributes) {
+				idx->attrs = intf->ch_index[j].attrs;
+				break;
+			}
+		if (j < i)
+			continue;
+
+		ret = iio_hash_attributes(&idx->attrs_storage,
+					  idx->ch->attributes);
+		if (IS_ERR_VALUE(ret))
+			goto error;
+		idx->attrs = &idx->attrs_storage;
+	}
+
+	return SUCCESS;
+error:
+	iio_free_indexes(intf);
+
+	return ret;
+}
+
+/* Rebuild the device table from the list of registered interfaces, skip
+ * excepted. The previous table is kept if it fails. */
+static int32_t iio_build_dev_table(struct iio_desc *desc,
+				   struct iio_interface *skip)
+{
+	struct iio_interface	*intf;
+	struct iio_hash		table;
+	uint32_t		size;
+	uint32_t		i;
+	int32_t			ret;
+
+	ret = list_get_size(desc->interfaces_list, &size);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = iio_hash_init(&table, size);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+
+	for (i = 0; i < size; i++) {
+		ret = list_read_idx(desc->interfaces_list, (void **)&intf, i);
+		if (IS_ERR_VALUE(ret)) {
+			iio_hash_remove(&table);
+			return ret;
+		}
+		if (intf != skip)
+			iio_hash_add(&table, intf->dev_id, intf);
+	}
+
+	iio_hash_remove(&desc->dev_table);
+	desc->dev_table = table;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Register interface.
  * @param desc - iio descriptor
@@ -1271,6 +1999,13 @@ ssize_t iio_register(struct iio_desc *desc, struct iio_device *dev_descriptor,
 	iio_interface->dev_descriptor = dev_descriptor;
 	iio_interface->read_buffer = read_buff;
 	iio_interface->write_buffer = write_buff;
+	sprintf((char *)iio_interface->dev_id, "device%d", (int)desc->dev_count);
+
+	ret = iio_build_indexes(iio_interface);
+	if (IS_ERR_VALUE(ret)) {
+		free(iio_interface);
+		return ret;
+	}
 
 	/* Get number of bytes needed for the xml of the new device */
 	n = iio_generate_device_xml(iio_interface->dev_descriptor,
@@ -1280,25 +2015,34 @@ ssize_t iio_register(struct iio_desc *desc, struct iio_device *dev_descriptor,
 	new_size = desc->xml_size + n;
 	aux = realloc(desc->xml_desc, new_size);
 	if (!aux) {
+		iio_free_indexes(iio_interface);
 		free(iio_interface);
 		return -ENOMEM;
 	}
+	desc->xml_desc = aux;
 
 	ret = desc->interfaces_list->push(desc->interfaces_list, iio_interface);
 	if (IS_ERR_VALUE(ret)) {
+		iio_free_indexes(iio_interface);
+		free(iio_interface);
+		return ret;
+	}
+
+	ret = iio_build_dev_table(desc, NULL);
+	if (IS_ERR_VALUE(ret)) {
+		list_get_find(desc->interfaces_list, (void **)&iio_interface,
+			      iio_interface);
+		iio_free_indexes(iio_interface);
 		free(iio_interface);
-		free(aux);
 		return ret;
 	}
 
-	desc->xml_desc = aux;
 	/* Print the new device xml at the end of the xml */
 	iio_generate_device_xml(iio_interface->dev_descriptor,
 				(char *)iio_interface->name,
 				desc->dev_count,
 				desc->xml_desc + desc->xml_size_to_last_dev,
 				new_size - desc->xml_size_to_last_dev);
-	sprintf((char *)iio_interface->dev_id, "device%d", (int)desc->dev_count);
 	desc->xml_size_to_last_dev += n;
 	desc->xml_size += n;
 	/* Copy end header at the end */
@@ -1318,23 +2062,40 @@ ssize_t iio_register(struct iio_desc *desc, struct iio_device *dev_descriptor,
 ssize_t iio_unregister(struct iio_desc *desc, char *name)
 {
 	struct iio_interface	*to_remove_interface;
-	struct iio_interface	search_interface;
+	uint32_t		size;
+	uint32_t		i;
 	int32_t			ret;
 	int32_t			n;
 	char			*aux;
 
-	/* Get if the item is found, get will remove it from the list */
-	search_interface.name = name;
-	ret = list_get_find(desc->interfaces_list,
-			    (void **)&to_remove_interface, &search_interface);
+	/* The list is sorted by device id, look for the name */
+	ret = list_get_size(desc->interfaces_list, &size);
 	if (IS_ERR_VALUE(ret))
 		return ret;
-	free(to_remove_interface);
+	for (i = 0; i < size; i++) {
+		ret = list_read_idx(desc->interfaces_list,
+				    (void **)&to_remove_interface, i);
+		if (IS_ERR_VALUE(ret))
+			return ret;
+		if (!strcmp(to_remove_interface->name, name))
+			break;
+	}
+	if (i == size)
+		return FAILURE;
+
+	/* The interface is only removed once the table without it is built,
+	 * so that nothing changes on failure */
+	ret = iio_build_dev_table(desc, to_remove_interface);
+	if (IS_ERR_VALUE(ret))
+		return ret;
+	list_get_idx(desc->interfaces_list, (void **)&to_remove_interface, i);
 
 	/* Get number of bytes needed for the xml of the device */
 	n = iio_generate_device_xml(to_remove_interface->dev_descriptor,
 				    (char *)to_remove_interface->name,
 				    desc->dev_count, NULL, -1);
+	iio_free_indexes(to_remove_interface);
+	free(to_remove_interface);
 
 	/* Overwritte the deleted device */
 	aux = desc->xml_desc + desc->xml_size_to_last_dev - n;
@@ -1405,6 +2166,7 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	ldesc->xml_size_to_last_dev = sizeof(header) - 1;
 
 	ldesc->phy_type = init_param->phy_type;
+	ldesc->zero_copy = init_param->zero_copy;
 	if (init_param->phy_type == USE_UART) {
 		ldesc->uart_desc = init_param->uart_desc;
 	}
@@ -1420,9 +2182,15 @@ ssize_t iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		ret = socket_listen(ldesc->server, MAX_BACKLOG);
 		if (IS_ERR_VALUE(ret))
 			goto free_pylink;
-		ret = cb_init(&ldesc->sockets, sizeof(struct tcp_socket_desc *)
-			      * MAX_SOCKET_TO_HANDLE);
-		if (IS_ERR_VALUE(ret))
+		ldesc->max_clients = init_param->max_clients ?
+				     init_param->max_clients :
+				     MAX_SOCKET_TO_HANDLE;
+		/* The server socket is waited together with the clients */
+		if (ldesc->max_clients > MAX_SOCKETS_TO_WAIT - 1)
+			ldesc->max_clients = MAX_SOCKETS_TO_WAIT - 1;
+		ldesc->clients = calloc(ldesc->max_clients,
+					sizeof(*ldesc->clients));
+		if (!ldesc->clients)
 			goto free_pylink;
 	}
 #endif
@@ -1455,8 +2223,8 @@ free_pylink:
 #ifdef ENABLE_IIO_NETWORK
 	if (ldesc->phy_type == USE_NETWORK) {
 		socket_remove(ldesc->server);
-		if (ldesc->sockets)
-			cb_remove(ldesc->sockets);
+		if (ldesc->clients)
+			free(ldesc->clients);
 	}
 #endif
 free_desc:
@@ -1475,11 +2243,17 @@ free_ops:
 ssize_t iio_remove(struct iio_desc *desc)
 {
 	struct iio_interface	*iio_interface;
+#ifdef ENABLE_IIO_NETWORK
+	uint32_t		i;
+#endif
 
 	while (SUCCESS == list_get_first(desc->interfaces_list,
-					 (void **)&iio_interface))
+					 (void **)&iio_interface)) {
+		iio_free_indexes(iio_interface);
 		free(iio_interface);
+	}
 	list_remove(desc->interfaces_list);
+	iio_hash_remove(&desc->dev_table);
 
 	free(desc->iiod_ops);
 	tinyiiod_destroy(desc->iiod);
@@ -1491,8 +2265,11 @@ ssize_t iio_remove(struct iio_desc *desc)
 	}
 #ifdef ENABLE_IIO_NETWORK
 	else {
+		for (i = 0; i < desc->max_clients; i++)
+			if (desc->clients[i].sock)
+				iio_remove_client(&desc->clients[i]);
+		free(desc->clients);
 		socket_remove(desc->server);
-		cb_remove(desc->sockets);
 	}
 #endif
 
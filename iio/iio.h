@@ -72,6 +72,16 @@ struct iio_init_param {
 		struct tcp_socket_init_param *tcp_socket_init_param;
 #endif
 	};
+	/* If set, buffer reads are sent directly from the registered read
+	 * buffer instead of being copied into libtinyiiod's buffer first.
+	 * libtinyiiod must write the buffer given to read_data() before
+	 * calling it again, zero copy is turned off otherwise. */
+	bool			zero_copy;
+#ifdef ENABLE_IIO_NETWORK
+	/* Maximum number of clients connected at the same time. If 0, the
+	 * default value is used: MAX_SOCKET_TO_HANDLE from iio.c */
+	uint32_t		max_clients;
+#endif
 };
 
 /******************************************************************************/
@@ -68,6 +68,11 @@
 // The default baudrate iio_app will use to print messages to console.
 #define UART_BAUDRATE_DEFAULT	115200
 
+#ifdef LINUX_PLATFORM
+// Number of clients served at the same time by the network server.
+#define IIO_APP_MAX_CLIENTS	32
+#endif
+
 char *uart_data_size[] = {
 	"5",
 	"6",
@@ -258,6 +263,7 @@ int32_t iio_app_run(struct iio_app_device *devices, int32_t len)
 
 	iio_init_param.phy_type = USE_NETWORK;
 	iio_init_param.tcp_socket_init_param = &socket_param;
+	iio_init_param.max_clients = 0;
 
 #elif defined(LINUX_PLATFORM)
 	socket_param.net = &linux_net;
@@ -265,10 +271,16 @@ int32_t iio_app_run(struct iio_app_device *devices, int32_t len)
 
 	iio_init_param.phy_type = USE_NETWORK;
 	iio_init_param.tcp_socket_init_param = &socket_param;
+	iio_init_param.max_clients = IIO_APP_MAX_CLIENTS;
 #else
 	iio_init_param.phy_type = USE_UART;
 	iio_init_param.uart_desc = uart_desc;
 #endif//USE_TCP_SOCKET
+#ifdef IIO_ZERO_COPY
+	iio_init_param.zero_copy = true;
+#else
+	iio_init_param.zero_copy = false;
+#endif
 
 	status = iio_init(&iio_desc, &iio_init_param);
 	if(status < 0)
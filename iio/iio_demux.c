@@ -0,0 +1,803 @@
+/***************************************************************************//**
+ *   @file   iio_demux.c
+ *   @brief  Implementation of the IIO capture demultiplexer.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "error.h"
+#include "iio_demux.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define IIO_DEMUX_SIMD_GATHER
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+/* vqtbl1q_u8() is only available on AArch64 */
+#if defined(__aarch64__)
+#define IIO_DEMUX_SIMD_GATHER
+#endif
+#endif
+
+/*
+ * A raw sample is converted to an IIO sample by:
+ *	value = (raw >> raw.shift) & GENMASK(raw.realbits - 1, 0)
+ *	value is sign extended if raw.sign is 's'
+ *	sample = value << out.shift
+ * The kernels differ only in how they walk the active channels.
+ */
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+static inline uint16_t iio_demux_swab16(uint16_t v)
+{
+	return (uint16_t)((v << 8) | (v >> 8));
+}
+
+static inline uint32_t iio_demux_swab32(uint32_t v)
+{
+	return (v << 24) | ((v << 8) & 0x00ff0000) | ((v >> 8) & 0x0000ff00) |
+	       (v >> 24);
+}
+
+static inline uint32_t iio_demux_load(const uint8_t *src, uint8_t bytes,
+				      bool swap)
+{
+	uint16_t v16;
+	uint32_t v32;
+
+	if (bytes == 1)
+		return *src;
+
+	if (bytes == 2) {
+		memcpy(&v16, src, sizeof(v16));
+		return swap ? iio_demux_swab16(v16) : v16;
+	}
+
+	memcpy(&v32, src, sizeof(v32));
+
+	return swap ? iio_demux_swab32(v32) : v32;
+}
+
+static inline void iio_demux_store(uint8_t *dst, uint32_t v, uint8_t bytes,
+				   bool swap)
+{
+	uint16_t v16;
+
+	if (bytes == 1) {
+		*dst = (uint8_t)v;
+	} else if (bytes == 2) {
+		v16 = swap ? iio_demux_swab16((uint16_t)v) : (uint16_t)v;
+		memcpy(dst, &v16, sizeof(v16));
+	} else {
+		if (swap)
+			v = iio_demux_swab32(v);
+		memcpy(dst, &v, sizeof(v));
+	}
+}
+
+/*
+ * Conversion parameters, copied to the stack by the scalar kernels. The byte
+ * stores may alias the descriptor, which would otherwise be read again for
+ * each sample.
+ */
+struct iio_demux_params {
+	uint32_t	in_mask;
+	/* Sign bit of the value, 0 for unsigned samples */
+	uint32_t	sign_bit;
+	uint8_t		in_shift;
+	uint8_t		out_shift;
+	bool		in_swap;
+	bool		out_swap;
+};
+
+static inline void iio_demux_params_get(const struct iio_demux *demux,
+					struct iio_demux_params *p)
+{
+	p->in_mask = demux->in_mask;
+	p->sign_bit = demux->sign_shift ? 1u << (31 - demux->sign_shift) : 0;
+	p->in_shift = demux->in_shift;
+	p->out_shift = demux->out_shift;
+	p->in_swap = demux->in_swap;
+	p->out_swap = demux->out_swap;
+}
+
+/* Convert a sample. The kernels for samples of the CPU endianness pass
+ * swap as false, leaving no branch in their loops. */
+static inline void iio_demux_sample(const struct iio_demux_params *p,
+				    const uint8_t *src, uint8_t *dst,
+				    uint8_t in_bytes, uint8_t out_bytes,
+				    bool swap)
+{
+	uint32_t v;
+
+	v = iio_demux_load(src, in_bytes, swap && p->in_swap);
+	v = (v >> p->in_shift) & p->in_mask;
+	/* Sign extension, without effect if sign_bit is 0 */
+	v = (v ^ p->sign_bit) - p->sign_bit;
+	iio_demux_store(dst, v << p->out_shift, out_bytes, swap && p->out_swap);
+}
+
+/* Convert contiguous samples, the sizes are constant after inlining */
+static inline void iio_demux_convert_samples(const struct iio_demux *demux,
+		const uint8_t *src, uint8_t *dst, uint32_t nb_samples,
+		uint8_t in_bytes, uint8_t out_bytes, bool swap)
+{
+	struct iio_demux_params p;
+	uint32_t i;
+
+	iio_demux_params_get(demux, &p);
+	for (i = 0; i < nb_samples; i++, src += in_bytes, dst += out_bytes)
+		iio_demux_sample(&p, src, dst, in_bytes, out_bytes, swap);
+}
+
+/* Convert the active samples of each scan, by offset */
+static inline void iio_demux_gather_scans(const struct iio_demux *demux,
+		const uint8_t *src, uint8_t *dst, uint32_t nb_scans,
+		uint8_t in_bytes, uint8_t out_bytes, bool swap)
+{
+	uint32_t in_scan_bytes = demux->in_scan_bytes;
+	uint32_t nb_active = demux->nb_active;
+	uint8_t offsets[IIO_DEMUX_MAX_CHANNELS];
+	struct iio_demux_params p;
+	uint32_t i;
+	uint32_t k;
+
+	iio_demux_params_get(demux, &p);
+	memcpy(offsets, demux->offsets, nb_active);
+	for (i = 0; i < nb_scans; i++, src += in_scan_bytes)
+		for (k = 0; k < nb_active; k++, dst += out_bytes)
+			iio_demux_sample(&p, src + offsets[k], dst, in_bytes,
+					 out_bytes, swap);
+}
+
+#if defined(__SSSE3__)
+/* Byte shuffles swapping the bytes of 16 and 32 bit lanes */
+static const uint8_t iio_demux_swap_16[16] = {
+	1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14
+};
+
+static const uint8_t iio_demux_swap_32[16] = {
+	3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+};
+
+/* Low halves of 4 32 bit lanes, in little and big endian */
+static const uint8_t iio_demux_pack_16[2][16] = {
+	{
+		0, 1, 4, 5, 8, 9, 12, 13,
+		0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+	},
+	{
+		1, 0, 5, 4, 9, 8, 13, 12,
+		0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+	},
+};
+
+/* Conversion constants, loaded once per run */
+struct iio_demux_simd {
+	__m128i	in_shift;
+	__m128i	in_mask;
+	__m128i	sign_shift;
+	__m128i	out_shift;
+	__m128i	in_swap;
+	__m128i	out_swap;
+};
+
+static void iio_demux_simd_setup(const struct iio_demux *demux,
+				 struct iio_demux_simd *c, uint8_t lane_bytes)
+{
+	static const uint8_t identity[16] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+	};
+	const uint8_t *swap;
+
+	swap = lane_bytes == 2 ? iio_demux_swap_16 : iio_demux_swap_32;
+	c->in_shift = _mm_cvtsi32_si128(demux->in_shift);
+	c->out_shift = _mm_cvtsi32_si128(demux->out_shift);
+	if (lane_bytes == 2) {
+		c->in_mask = _mm_set1_epi16((int16_t)demux->in_mask);
+		c->sign_shift = _mm_cvtsi32_si128(demux->sign_shift ?
+						  demux->sign_shift - 16 : 0);
+	} else {
+		c->in_mask = _mm_set1_epi32((int32_t)demux->in_mask);
+		c->sign_shift = _mm_cvtsi32_si128(demux->sign_shift);
+	}
+	c->in_swap = _mm_loadu_si128((const __m128i *)(demux->in_swap ?
+				     swap : identity));
+	c->out_swap = _mm_loadu_si128((const __m128i *)(demux->out_swap ?
+				      swap : identity));
+}
+
+static inline __m128i iio_demux_lanes_16(__m128i v,
+		const struct iio_demux_simd *c)
+{
+	v = _mm_and_si128(_mm_srl_epi16(v, c->in_shift), c->in_mask);
+	v = _mm_sra_epi16(_mm_sll_epi16(v, c->sign_shift), c->sign_shift);
+
+	return _mm_sll_epi16(v, c->out_shift);
+}
+
+static inline __m128i iio_demux_lanes_32(__m128i v,
+		const struct iio_demux_simd *c)
+{
+	v = _mm_and_si128(_mm_srl_epi32(v, c->in_shift), c->in_mask);
+	v = _mm_sra_epi32(_mm_sll_epi32(v, c->sign_shift), c->sign_shift);
+
+	return _mm_sll_epi32(v, c->out_shift);
+}
+
+/* Contiguous 16 and 32 bit samples, returns the number of converted ones */
+static uint32_t iio_demux_convert_simd(const struct iio_demux *demux,
+				       const uint8_t *src, uint8_t *dst,
+				       uint32_t nb_samples)
+{
+	struct iio_demux_simd c;
+	__m128i v, w, pack;
+	uint32_t i = 0;
+
+	if (demux->in_bytes == 2 && demux->out_bytes == 2) {
+		iio_demux_simd_setup(demux, &c, 2);
+		for (; i + 8 <= nb_samples; i += 8) {
+			v = _mm_loadu_si128((const __m128i *)(src + i * 2));
+			v = iio_demux_lanes_16(_mm_shuffle_epi8(v, c.in_swap),
+					       &c);
+			_mm_storeu_si128((__m128i *)(dst + i * 2),
+					 _mm_shuffle_epi8(v, c.out_swap));
+		}
+	} else if (demux->in_bytes == 4 && demux->out_bytes == 4) {
+		iio_demux_simd_setup(demux, &c, 4);
+		for (; i + 4 <= nb_samples; i += 4) {
+			v = _mm_loadu_si128((const __m128i *)(src + i * 4));
+			v = iio_demux_lanes_32(_mm_shuffle_epi8(v, c.in_swap),
+					       &c);
+			_mm_storeu_si128((__m128i *)(dst + i * 4),
+					 _mm_shuffle_epi8(v, c.out_swap));
+		}
+	} else if (demux->in_bytes == 4 && demux->out_bytes == 2) {
+		iio_demux_simd_setup(demux, &c, 4);
+		pack = _mm_loadu_si128((const __m128i *)
+				       iio_demux_pack_16[demux->out_swap]);
+		for (; i + 8 <= nb_samples; i += 8, src += 32) {
+			v = _mm_loadu_si128((const __m128i *)src);
+			w = _mm_loadu_si128((const __m128i *)(src + 16));
+			v = iio_demux_lanes_32(_mm_shuffle_epi8(v, c.in_swap),
+					       &c);
+			w = iio_demux_lanes_32(_mm_shuffle_epi8(w, c.in_swap),
+					       &c);
+			v = _mm_unpacklo_epi64(_mm_shuffle_epi8(v, pack),
+					       _mm_shuffle_epi8(w, pack));
+			_mm_storeu_si128((__m128i *)(dst + i * 2), v);
+		}
+	}
+
+	return i;
+}
+
+/* Compact the active samples of each 16 bytes block of a scan */
+static void iio_demux_gather_simd(const struct iio_demux *demux,
+				  const uint8_t *src, uint8_t *dst,
+				  uint32_t nb_scans)
+{
+	uint8_t offsets[IIO_DEMUX_MAX_BLOCKS];
+	uint8_t advance[IIO_DEMUX_MAX_BLOCKS];
+	__m128i shuffle[IIO_DEMUX_MAX_BLOCKS];
+	uint32_t in_scan_bytes = demux->in_scan_bytes;
+	uint32_t nb_blocks = demux->nb_blocks;
+	struct iio_demux_simd c;
+	uint32_t nb_simd;
+	uint32_t i, b;
+	__m128i v;
+
+	iio_demux_simd_setup(demux, &c, demux->in_bytes);
+	for (b = 0; b < nb_blocks; b++) {
+		shuffle[b] = _mm_loadu_si128((const __m128i *)
+					     demux->shuffle[b]);
+		offsets[b] = demux->block_offsets[b];
+		advance[b] = demux->advance[b];
+	}
+
+	nb_simd = 0;
+	if (nb_scans > demux->tail_scans)
+		nb_simd = nb_scans - demux->tail_scans;
+	if (demux->in_bytes == 2) {
+		for (i = 0; i < nb_simd; i++, src += in_scan_bytes)
+			for (b = 0; b < nb_blocks; b++) {
+				v = _mm_loadu_si128((const __m128i *)
+						    (src + offsets[b]));
+				v = _mm_shuffle_epi8(v, shuffle[b]);
+				_mm_storeu_si128((__m128i *)dst,
+						 iio_demux_lanes_16(v, &c));
+				dst += advance[b];
+			}
+		iio_demux_gather_scans(demux, src, dst, nb_scans - nb_simd,
+				       2, 2, true);
+	} else {
+		for (i = 0; i < nb_simd; i++, src += in_scan_bytes)
+			for (b = 0; b < nb_blocks; b++) {
+				v = _mm_loadu_si128((const __m128i *)
+						    (src + offsets[b]));
+				v = _mm_shuffle_epi8(v, shuffle[b]);
+				_mm_storeu_si128((__m128i *)dst,
+						 iio_demux_lanes_32(v, &c));
+				dst += advance[b];
+			}
+		iio_demux_gather_scans(demux, src, dst, nb_scans - nb_simd,
+				       4, 4, true);
+	}
+}
+#elif defined(__ARM_NEON)
+/* Conversion constants, loaded once per run. Right shifts are negated. */
+struct iio_demux_simd {
+	int32x4_t	in_shift;
+	uint32x4_t	in_mask;
+	int32x4_t	sign_shift;
+	int32x4_t	sign_shift_neg;
+	int32x4_t	out_shift;
+	int16x8_t	in_shift_16;
+	uint16x8_t	in_mask_16;
+	int16x8_t	sign_shift_16;
+	int16x8_t	sign_shift_neg_16;
+	int16x8_t	out_shift_16;
+};
+
+static void iio_demux_simd_setup(const struct iio_demux *demux,
+				 struct iio_demux_simd *c)
+{
+	int16_t sign_16 = demux->sign_shift ? demux->sign_shift - 16 : 0;
+
+	c->in_shift = vdupq_n_s32(-(int32_t)demux->in_shift);
+	c->in_mask = vdupq_n_u32(demux->in_mask);
+	c->sign_shift = vdupq_n_s32(demux->sign_shift);
+	c->sign_shift_neg = vdupq_n_s32(-(int32_t)demux->sign_shift);
+	c->out_shift = vdupq_n_s32(demux->out_shift);
+	c->in_shift_16 = vdupq_n_s16(-(int16_t)demux->in_shift);
+	c->in_mask_16 = vdupq_n_u16((uint16_t)demux->in_mask);
+	c->sign_shift_16 = vdupq_n_s16(sign_16);
+	c->sign_shift_neg_16 = vdupq_n_s16(-sign_16);
+	c->out_shift_16 = vdupq_n_s16(demux->out_shift);
+}
+
+static inline uint8x16_t iio_demux_lanes_16(uint8x16_t in,
+		const struct iio_demux_simd *c)
+{
+	uint16x8_t v = vreinterpretq_u16_u8(in);
+
+	v = vandq_u16(vshlq_u16(v, c->in_shift_16), c->in_mask_16);
+	v = vreinterpretq_u16_s16(vshlq_s16(vreinterpretq_s16_u16(
+			vshlq_u16(v, c->sign_shift_16)), c->sign_shift_neg_16));
+
+	return vreinterpretq_u8_u16(vshlq_u16(v, c->out_shift_16));
+}
+
+static inline uint32x4_t iio_demux_lanes_32(uint8x16_t in,
+		const struct iio_demux_simd *c)
+{
+	uint32x4_t v = vreinterpretq_u32_u8(in);
+
+	v = vandq_u32(vshlq_u32(v, c->in_shift), c->in_mask);
+	v = vreinterpretq_u32_s32(vshlq_s32(vreinterpretq_s32_u32(
+			vshlq_u32(v, c->sign_shift)), c->sign_shift_neg));
+
+	return vshlq_u32(v, c->out_shift);
+}
+
+/* Contiguous 16 and 32 bit samples, returns the number of converted ones */
+static uint32_t iio_demux_convert_simd(const struct iio_demux *demux,
+				       const uint8_t *src, uint8_t *dst,
+				       uint32_t nb_samples)
+{
+	struct iio_demux_simd c;
+	uint8x16_t v, w;
+	uint16x8_t p;
+	uint32_t i = 0;
+
+	iio_demux_simd_setup(demux, &c);
+	if (demux->in_bytes == 2 && demux->out_bytes == 2) {
+		for (; i + 8 <= nb_samples; i += 8) {
+			v = vld1q_u8(src + i * 2);
+			if (demux->in_swap)
+				v = vrev16q_u8(v);
+			v = iio_demux_lanes_16(v, &c);
+			if (demux->out_swap)
+				v = vrev16q_u8(v);
+			vst1q_u8(dst + i * 2, v);
+		}
+	} else if (demux->in_bytes == 4 && demux->out_bytes == 4) {
+		for (; i + 4 <= nb_samples; i += 4) {
+			v = vld1q_u8(src + i * 4);
+			if (demux->in_swap)
+				v = vrev32q_u8(v);
+			v = vreinterpretq_u8_u32(iio_demux_lanes_32(v, &c));
+			if (demux->out_swap)
+				v = vrev32q_u8(v);
+			vst1q_u8(dst + i * 4, v);
+		}
+	} else if (demux->in_bytes == 4 && demux->out_bytes == 2) {
+		for (; i + 8 <= nb_samples; i += 8) {
+			v = vld1q_u8(src + i * 4);
+			w = vld1q_u8(src + i * 4 + 16);
+			if (demux->in_swap) {
+				v = vrev32q_u8(v);
+				w = vrev32q_u8(w);
+			}
+			p = vcombine_u16(vmovn_u32(iio_demux_lanes_32(v, &c)),
+					 vmovn_u32(iio_demux_lanes_32(w, &c)));
+			v = vreinterpretq_u8_u16(p);
+			if (demux->out_swap)
+				v = vrev16q_u8(v);
+			vst1q_u8(dst + i * 2, v);
+		}
+	}
+
+	return i;
+}
+
+#if defined(IIO_DEMUX_SIMD_GATHER)
+/* Compact the active samples of each 16 bytes block of a scan */
+static void iio_demux_gather_simd(const struct iio_demux *demux,
+				  const uint8_t *src, uint8_t *dst,
+				  uint32_t nb_scans)
+{
+	uint8_t offsets[IIO_DEMUX_MAX_BLOCKS];
+	uint8_t advance[IIO_DEMUX_MAX_BLOCKS];
+	uint8x16_t shuffle[IIO_DEMUX_MAX_BLOCKS];
+	uint32_t in_scan_bytes = demux->in_scan_bytes;
+	uint32_t nb_blocks = demux->nb_blocks;
+	struct iio_demux_simd c;
+	uint32_t nb_simd;
+	uint32_t i, b;
+	uint8x16_t v;
+
+	iio_demux_simd_setup(demux, &c);
+	for (b = 0; b < nb_blocks; b++) {
+		shuffle[b] = vld1q_u8(demux->shuffle[b]);
+		offsets[b] = demux->block_offsets[b];
+		advance[b] = demux->advance[b];
+	}
+
+	nb_simd = 0;
+	if (nb_scans > demux->tail_scans)
+		nb_simd = nb_scans - demux->tail_scans;
+	if (demux->in_bytes == 2) {
+		for (i = 0; i < nb_simd; i++, src += in_scan_bytes)
+			for (b = 0; b < nb_blocks; b++) {
+				v = vqtbl1q_u8(vld1q_u8(src + offsets[b]),
+					       shuffle[b]);
+				vst1q_u8(dst, iio_demux_lanes_16(v, &c));
+				dst += advance[b];
+			}
+		iio_demux_gather_scans(demux, src, dst, nb_scans - nb_simd,
+				       2, 2, true);
+	} else {
+		for (i = 0; i < nb_simd; i++, src += in_scan_bytes)
+			for (b = 0; b < nb_blocks; b++) {
+				v = vqtbl1q_u8(vld1q_u8(src + offsets[b]),
+					       shuffle[b]);
+				vst1q_u8(dst, vreinterpretq_u8_u32(
+						 iio_demux_lanes_32(v, &c)));
+				dst += advance[b];
+			}
+		iio_demux_gather_scans(demux, src, dst, nb_scans - nb_simd,
+				       4, 4, true);
+	}
+}
+#endif
+#else
+/* Contiguous 16 and 32 bit samples, returns the number of converted ones */
+static uint32_t iio_demux_convert_simd(const struct iio_demux *demux,
+				       const uint8_t *src, uint8_t *dst,
+				       uint32_t nb_samples)
+{
+	return 0;
+}
+#endif
+
+/* All channels are active and samples are stored as they are captured */
+static void iio_demux_copy(const struct iio_demux *demux, const uint8_t *src,
+			   uint8_t *dst, uint32_t nb_scans)
+{
+	memcpy(dst, src, nb_scans * demux->in_scan_bytes);
+}
+
+/* All channels are active, each sample is converted */
+static void iio_demux_convert_all(const struct iio_demux *demux,
+				  const uint8_t *src, uint8_t *dst,
+				  uint32_t nb_scans)
+{
+	uint32_t nb_samples = nb_scans * demux->nb_channels;
+	uint32_t i;
+
+	i = iio_demux_convert_simd(demux, src, dst, nb_samples);
+	src += i * demux->in_bytes;
+	dst += i * demux->out_bytes;
+	nb_samples -= i;
+
+	if (demux->in_swap || demux->out_swap)
+		iio_demux_convert_samples(demux, src, dst, nb_samples,
+					  demux->in_bytes, demux->out_bytes,
+					  true);
+	else if (demux->in_bytes == 2 && demux->out_bytes == 2)
+		iio_demux_convert_samples(demux, src, dst, nb_samples, 2, 2,
+					  false);
+	else if (demux->in_bytes == 4 && demux->out_bytes == 4)
+		iio_demux_convert_samples(demux, src, dst, nb_samples, 4, 4,
+					  false);
+	else if (demux->in_bytes == 4 && demux->out_bytes == 2)
+		iio_demux_convert_samples(demux, src, dst, nb_samples, 4, 2,
+					  false);
+	else
+		iio_demux_convert_samples(demux, src, dst, nb_samples,
+					  demux->in_bytes, demux->out_bytes,
+					  false);
+}
+
+static void iio_demux_gather_16(const struct iio_demux *demux,
+				const uint8_t *src, uint8_t *dst,
+				uint32_t nb_scans)
+{
+	iio_demux_gather_scans(demux, src, dst, nb_scans, 2, 2, false);
+}
+
+static void iio_demux_gather_32(const struct iio_demux *demux,
+				const uint8_t *src, uint8_t *dst,
+				uint32_t nb_scans)
+{
+	iio_demux_gather_scans(demux, src, dst, nb_scans, 4, 4, false);
+}
+
+static void iio_demux_gather_32_16(const struct iio_demux *demux,
+				   const uint8_t *src, uint8_t *dst,
+				   uint32_t nb_scans)
+{
+	iio_demux_gather_scans(demux, src, dst, nb_scans, 4, 2, false);
+}
+
+static void iio_demux_gather_any(const struct iio_demux *demux,
+				 const uint8_t *src, uint8_t *dst,
+				 uint32_t nb_scans)
+{
+	iio_demux_gather_scans(demux, src, dst, nb_scans, demux->in_bytes,
+			       demux->out_bytes, true);
+}
+
+/* Check that a sample size is handled by the kernels */
+static bool iio_demux_valid_storage(uint8_t storagebits)
+{
+	return storagebits == 8 || storagebits == 16 || storagebits == 32;
+}
+
+static bool iio_demux_host_is_big_endian(void)
+{
+	const uint16_t v = 1;
+
+	return *(const uint8_t *)&v == 0;
+}
+
+/**
+ * @brief Initialize the demultiplexer for a raw and an IIO layout.
+ * @param demux - The demultiplexer descriptor.
+ * @param param - The raw and IIO layouts.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_demux_init(struct iio_demux **demux,
+		       const struct iio_demux_init_param *param)
+{
+	const struct scan_type *raw, *out;
+	struct iio_demux *d;
+	bool host_be;
+
+	if (!demux || !param || !param->raw || !param->out)
+		return -EINVAL;
+
+	raw = param->raw;
+	out = param->out;
+	if (!param->nb_channels ||
+	    param->nb_channels > IIO_DEMUX_MAX_CHANNELS ||
+	    !iio_demux_valid_storage(raw->storagebits) ||
+	    !iio_demux_valid_storage(out->storagebits) ||
+	    !raw->realbits || raw->realbits + raw->shift > raw->storagebits ||
+	    raw->realbits + out->shift > out->storagebits)
+		return -EINVAL;
+
+	d = (struct iio_demux *)calloc(1, sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	host_be = iio_demux_host_is_big_endian();
+	d->nb_channels = param->nb_channels;
+	d->in_bytes = raw->storagebits / 8;
+	d->in_shift = raw->shift;
+	d->in_swap = raw->is_big_endian != host_be;
+	d->in_mask = 0xFFFFFFFF >> (32 - raw->realbits);
+	d->sign_shift = raw->sign == 's' ? 32 - raw->realbits : 0;
+	d->out_bytes = out->storagebits / 8;
+	d->out_shift = out->shift;
+	d->out_swap = out->is_big_endian != host_be;
+	d->in_scan_bytes = d->nb_channels * d->in_bytes;
+
+	*demux = d;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Free the resources allocated by iio_demux_init().
+ * @param demux - The demultiplexer descriptor.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_demux_remove(struct iio_demux *demux)
+{
+	if (!demux)
+		return -EINVAL;
+
+	free(demux);
+
+	return SUCCESS;
+}
+
+#if defined(IIO_DEMUX_SIMD_GATHER)
+/* Build the byte shuffle compacting the active samples of each block */
+static bool iio_demux_compile_simd(struct iio_demux *demux)
+{
+	uint32_t b, k, j, n, pos, off;
+	uint8_t last = demux->in_bytes - 1;
+
+	if (demux->in_bytes != demux->out_bytes || demux->in_bytes == 1 ||
+	    demux->out_swap || demux->in_scan_bytes % 16 ||
+	    demux->in_scan_bytes / 16 > IIO_DEMUX_MAX_BLOCKS)
+		return false;
+
+	memset(demux->shuffle, 0x80, sizeof(demux->shuffle));
+	for (b = 0, k = 0, n = 0; b < demux->in_scan_bytes / 16; b++) {
+		pos = 0;
+		for (; k < demux->nb_active && demux->offsets[k] < (b + 1) * 16;
+		     k++) {
+			off = demux->offsets[k] - b * 16;
+			for (j = 0; j < demux->in_bytes; j++)
+				demux->shuffle[n][pos++] = off +
+							   (demux->in_swap ?
+							    last - j : j);
+		}
+		/* Blocks without active samples are skipped */
+		if (!pos)
+			continue;
+		demux->block_offsets[n] = b * 16;
+		demux->advance[n++] = pos;
+	}
+	/* Blocks with few active samples are faster to gather one by one */
+	if (demux->out_scan_bytes < n * 8)
+		return false;
+
+	demux->nb_blocks = n;
+	/* The last store of a scan may write 16 bytes past its end */
+	demux->tail_scans = (16 + demux->out_scan_bytes - 1) /
+			    demux->out_scan_bytes;
+
+	return true;
+}
+#endif
+
+/**
+ * @brief Select the active channels and the kernel processing them.
+ * @param demux - The demultiplexer descriptor.
+ * @param mask - Active channels, bit n set for channel n.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_demux_compile(struct iio_demux *demux, uint32_t mask)
+{
+	uint32_t all;
+	bool identity;
+	uint32_t ch;
+
+	if (!demux)
+		return -EINVAL;
+
+	all = 0xFFFFFFFF >> (32 - demux->nb_channels);
+	if (!mask || (mask & ~all))
+		return -EINVAL;
+
+	demux->mask = mask;
+	demux->nb_active = 0;
+	for (ch = 0; ch < demux->nb_channels; ch++)
+		if (mask & (1u << ch))
+			demux->offsets[demux->nb_active++] = ch *
+							     demux->in_bytes;
+	demux->out_scan_bytes = demux->nb_active * demux->out_bytes;
+
+	identity = demux->in_bytes == demux->out_bytes && !demux->in_shift &&
+		   !demux->out_shift && demux->in_swap == demux->out_swap &&
+		   demux->in_mask == 0xFFFFFFFF >> (32 - demux->in_bytes * 8);
+
+	if (mask == all && identity) {
+		demux->kernel = iio_demux_copy;
+		demux->kernel_name = "copy";
+		return SUCCESS;
+	}
+
+	if (mask == all) {
+		demux->kernel = iio_demux_convert_all;
+		demux->kernel_name = "convert";
+		return SUCCESS;
+	}
+
+#if defined(IIO_DEMUX_SIMD_GATHER)
+	if (iio_demux_compile_simd(demux)) {
+		demux->kernel = iio_demux_gather_simd;
+		demux->kernel_name = "gather simd";
+		return SUCCESS;
+	}
+#endif
+
+	demux->kernel_name = "gather";
+	if (demux->in_swap || demux->out_swap)
+		demux->kernel = iio_demux_gather_any;
+	else if (demux->in_bytes == 2 && demux->out_bytes == 2)
+		demux->kernel = iio_demux_gather_16;
+	else if (demux->in_bytes == 4 && demux->out_bytes == 4)
+		demux->kernel = iio_demux_gather_32;
+	else if (demux->in_bytes == 4 && demux->out_bytes == 2)
+		demux->kernel = iio_demux_gather_32_16;
+	else
+		demux->kernel = iio_demux_gather_any;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Convert raw scans to scans of the active channels.
+ * @param demux - The demultiplexer descriptor, compiled.
+ * @param src - Raw scans. It is not modified.
+ * @param dst - Scans of the active channels. It must not overlap src.
+ * @param nb_scans - Number of scans.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t iio_demux_run(const struct iio_demux *demux, const void *src,
+		      void *dst, uint32_t nb_scans)
+{
+	if (!demux || !demux->kernel || !src || !dst)
+		return -EINVAL;
+
+	demux->kernel(demux, src, dst, nb_scans);
+
+	return SUCCESS;
+}
@@ -0,0 +1,159 @@
+/***************************************************************************//**
+ *   @file   iio_demux.h
+ *   @brief  Header file of the IIO capture demultiplexer.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_DEMUX_H_
+#define IIO_DEMUX_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "iio_types.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Maximum number of channels of a raw scan */
+#define IIO_DEMUX_MAX_CHANNELS		32
+/* Maximum size of a raw scan handled by the SIMD gather kernels */
+#define IIO_DEMUX_MAX_BLOCKS		4
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+struct iio_demux;
+
+/**
+ * @brief Kernel processing a number of scans.
+ * @param demux - Demultiplexer descriptor.
+ * @param src - Raw scans, with all the channels.
+ * @param dst - Scans of the active channels, in IIO layout.
+ * @param nb_scans - Number of scans.
+ */
+typedef void (*iio_demux_kernel)(const struct iio_demux *demux,
+				 const uint8_t *src, uint8_t *dst,
+				 uint32_t nb_scans);
+
+/**
+ * @struct iio_demux_init_param
+ * @brief Layout of the data captured by a device and of the data sent to the
+ * IIO client. Every raw scan holds a sample of each channel, in channel
+ * order.
+ */
+struct iio_demux_init_param {
+	/** Number of channels of a raw scan */
+	uint32_t			nb_channels;
+	/** Layout of a raw sample. realbits are extracted after shift. */
+	const struct scan_type		*raw;
+	/** Layout of an IIO sample. realbits are stored shifted left by
+	 *  shift in storagebits. */
+	const struct scan_type		*out;
+};
+
+/**
+ * @struct iio_demux
+ * @brief Demultiplexer descriptor. iio_demux_compile() selects the channels
+ * and the kernel.
+ */
+struct iio_demux {
+	/** Number of channels of a raw scan */
+	uint32_t		nb_channels;
+	/** Raw sample size, in bytes */
+	uint8_t			in_bytes;
+	/** Raw sample shift */
+	uint8_t			in_shift;
+	/** Raw samples have a different endianness than the CPU */
+	bool			in_swap;
+	/** Mask of the raw sample, after shift */
+	uint32_t		in_mask;
+	/** 32 - realbits for signed samples, 0 otherwise */
+	uint8_t			sign_shift;
+	/** IIO sample size, in bytes */
+	uint8_t			out_bytes;
+	/** IIO sample shift */
+	uint8_t			out_shift;
+	/** IIO samples have a different endianness than the CPU */
+	bool			out_swap;
+	/** Active channels */
+	uint32_t		mask;
+	/** Number of active channels */
+	uint32_t		nb_active;
+	/** Byte offset of each active channel in a raw scan */
+	uint8_t			offsets[IIO_DEMUX_MAX_CHANNELS];
+	/** Size of a raw scan */
+	uint32_t		in_scan_bytes;
+	/** Size of a scan of the active channels */
+	uint32_t		out_scan_bytes;
+	/** Number of 16 bytes blocks of a raw scan holding active samples,
+	 *  SIMD gather only */
+	uint32_t		nb_blocks;
+	/** Scans at the end of a run left to the scalar gather, because the
+	 *  SIMD stores write up to 16 bytes at once */
+	uint32_t		tail_scans;
+	/** Offset of each block in a raw scan */
+	uint8_t			block_offsets[IIO_DEMUX_MAX_BLOCKS];
+	/** Byte shuffle of each block, compacting its active samples */
+	uint8_t			shuffle[IIO_DEMUX_MAX_BLOCKS][16];
+	/** Number of bytes each block adds to the output */
+	uint8_t			advance[IIO_DEMUX_MAX_BLOCKS];
+	/** Kernel selected for the active channels */
+	iio_demux_kernel	kernel;
+	/** Name of the kernel, for reports */
+	const char		*kernel_name;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the demultiplexer for a raw and an IIO layout */
+int32_t iio_demux_init(struct iio_demux **demux,
+		       const struct iio_demux_init_param *param);
+/* Free the resources allocated by iio_demux_init() */
+int32_t iio_demux_remove(struct iio_demux *demux);
+/* Select the active channels and the kernel processing them */
+int32_t iio_demux_compile(struct iio_demux *demux, uint32_t mask);
+/* Convert raw scans to scans of the active channels */
+int32_t iio_demux_run(const struct iio_demux *demux, const void *src,
+		      void *dst, uint32_t nb_scans);
+
+#endif /* IIO_DEMUX_H_ */
@@ -190,6 +190,14 @@ struct iio_channel {
 struct iio_data_buffer {
 	uint32_t	size;
 	void		*buff;
+	/** Read buffers only. If set, the device keeps capturing into buff,
+	 * used as a ring of IIO_CONT_CHUNKS chunks, while data is sent to the
+	 * client. The device must implement read_dev_async and read_dev_done
+	 * and should queue several reads, so that it captures without gaps. */
+	bool		continuous;
+	/** Number of times samples were lost in continuous capture because
+	 * the client did not read the data in time */
+	uint32_t	overruns;
 };
 
 /**
@@ -220,6 +228,14 @@ struct iio_device {
 	 * samples * (storage_size_of_first_active_ch / 8) * nb_active_channels
 	 */
 	int32_t	(*write_dev)(void *dev, void *buff, uint32_t nb_samples);
+	/* Queue a read of nb_samples into buff and return without waiting for
+	 * it to finish. Used for continuous capture. The reads are done in
+	 * order, back to back. Returns -EBUSY when no more reads can be
+	 * queued. */
+	int32_t	(*read_dev_async)(void *dev, void *buff, uint32_t nb_samples);
+	/* Set done when the oldest read queued by read_dev_async has
+	 * finished. It is then removed from the queue. */
+	int32_t	(*read_dev_done)(void *dev, bool *done);
 	/* Read device register */
 	int32_t (*debug_reg_read)(void *dev, uint32_t reg, uint32_t *readval);
 	/* Write device register */
@@ -56,4 +56,15 @@ int32_t axi_io_read(uint32_t base, uint32_t offset, uint32_t *data);
 /* AXI IO Write data */
 int32_t axi_io_write(uint32_t base, uint32_t offset, uint32_t data);
 
+/* AXI IO Read consecutive registers */
+int32_t axi_io_read_block(uint32_t base, uint32_t offset, uint32_t *data,
+			  uint32_t nb_words);
+
+/* AXI IO Write consecutive registers */
+int32_t axi_io_write_block(uint32_t base, uint32_t offset,
+			   const uint32_t *data, uint32_t nb_words);
+
+/* AXI IO Unmap the regions mapped by the previous accesses */
+int32_t axi_io_unmap_all(void);
+
 #endif // AXI_IO_H_
@@ -58,11 +58,24 @@
  */
 struct circular_buffer;
 
+/**
+ * @struct cb_region
+ * @brief Contiguous part of the buffer, see \ref cb_peek_read
+ */
+struct cb_region {
+	/** Address in the buffer */
+	void		*buff;
+	/** Size in bytes */
+	uint32_t	size;
+};
+
 /******************************************************************************/
 /************************ Functions Declarations ******************************/
 /******************************************************************************/
 
 int32_t cb_init(struct circular_buffer **desc, uint32_t size);
+int32_t cb_init_with_buff(struct circular_buffer **desc, void *buff,
+			  uint32_t size);
 int32_t cb_remove(struct circular_buffer *desc);
 int32_t cb_size(struct circular_buffer *desc, uint32_t *size);
 
@@ -82,4 +95,10 @@ int32_t cb_prepare_async_read(struct circular_buffer *desc,
 			      uint32_t *raw_size_avilable);
 int32_t cb_end_async_read(struct circular_buffer *desc);
 
+int32_t cb_peek_write(struct circular_buffer *desc, struct cb_region regions[2]);
+int32_t cb_commit_write(struct circular_buffer *desc, uint32_t size);
+
+int32_t cb_peek_read(struct circular_buffer *desc, struct cb_region regions[2]);
+int32_t cb_commit_read(struct circular_buffer *desc, uint32_t size);
+
 #endif
@@ -43,4 +43,42 @@
 #include "crc16.h"
 #include "crc24.h"
 
+#define CRC_TABLE_SIZE 256
+
+/* Maximum number of bytes processed per step, see crc_populate_msb() */
+#define CRC_MAX_SLICES 8
+
+/* Lookup tables for a CRC of up to 32 bits, processing _slices bytes at a
+ * time. _slices is 1, 4 or 8, at the cost of _slices KB of tables. */
+#define DECLARE_CRC_TABLE(_table, _slices) \
+	static uint32_t _table##_entries[(_slices) * CRC_TABLE_SIZE]; \
+	static struct crc_table _table = { \
+		.entries = _table##_entries, \
+		.nb_slices = (_slices) \
+	}
+
+struct crc_table {
+	/** nb_slices lookup tables of CRC_TABLE_SIZE entries */
+	uint32_t *entries;
+	/** Number of bytes processed per lookup step */
+	uint8_t nb_slices;
+	/** CRC width in bits */
+	uint8_t width;
+};
+
+/* Streaming CRC computation */
+struct crc_ctx {
+	const struct crc_table *table;
+	uint32_t crc;
+};
+
+void crc_populate_msb(struct crc_table *table, uint8_t width,
+		      uint32_t polynomial);
+uint32_t crc_compute(const struct crc_table *table, const uint8_t *pdata,
+		     size_t nbytes, uint32_t crc);
+void crc_init(struct crc_ctx *ctx, const struct crc_table *table,
+	      uint32_t crc);
+void crc_update(struct crc_ctx *ctx, const uint8_t *pdata, size_t nbytes);
+uint32_t crc_final(struct crc_ctx *ctx);
+
 #endif // __CRC_H
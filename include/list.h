@@ -97,6 +97,19 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Number of index levels of a \ref LIST_PRIORITY_LIST */
+#define LIST_MAX_LEVELS		8
+
+/** Size of a list element, including the links of the index levels */
+#define LIST_ELEM_SIZE		((4 + 2 * LIST_MAX_LEVELS) * sizeof(void *))
+
+/** Size of a pool of nb list elements, see \ref list_init_pool */
+#define LIST_POOL_SIZE(nb)	((nb) * LIST_ELEM_SIZE)
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -252,6 +265,8 @@ struct list_desc {
 
 int32_t list_init(struct list_desc **list_desc, enum adapter_type type,
 		  f_cmp comparator);
+int32_t list_init_pool(struct list_desc **list_desc, enum adapter_type type,
+		       f_cmp comparator, void *pool, uint32_t nb_elements);
 int32_t list_remove(struct list_desc *list_desc);
 int32_t list_get_size(struct list_desc *list_desc, uint32_t *out_size);
 
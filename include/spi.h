@@ -53,6 +53,10 @@
 #define	SPI_CPHA	0x01
 #define	SPI_CPOL	0x02
 
+/* Default sizes of the access queue of a descriptor, see spi_batch_begin() */
+#define SPI_BATCH_MAX_MSGS	128
+#define SPI_BATCH_SIZE		1024
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -98,6 +102,31 @@ struct spi_msg {
 	uint8_t			cs_change;
 };
 
+/**
+ * @struct spi_batch
+ * @brief Writes and reads queued on a SPI descriptor, sent with a single
+ * transfer.
+ */
+struct spi_batch {
+	/** One message per queued access */
+	struct spi_msg		*msgs;
+	/** Where to copy the data received by each message once sent, NULL
+	 * for the writes */
+	uint8_t			**dests;
+	/** Number of entries of msgs and dests */
+	uint32_t		max_msgs;
+	/** Number of queued accesses */
+	uint32_t		nb_msgs;
+	/** Arena holding the data of the queued accesses */
+	uint8_t			*buff;
+	/** Size of buff */
+	uint32_t		size;
+	/** Bytes of buff in use */
+	uint32_t		used;
+	/** Number of nested spi_batch_begin() calls */
+	uint32_t		depth;
+};
+
 /**
  * @struct spi_platform_ops
  * @brief Structure holding SPI function pointers that point to the platform
@@ -143,6 +172,11 @@ typedef struct spi_desc {
 	const struct spi_platform_ops *platform_ops;
 	/**  SPI extra parameters (device specific) */
 	void		*extra;
+	/** Access queue, allocated by the first spi_batch_begin() */
+	struct spi_batch	*batch;
+	/** State of the device driver kept with the descriptor, NULL after
+	 * spi_init() */
+	void		*drv_data;
 } spi_desc;
 
 /**
@@ -180,5 +214,22 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 /* Iterate over the spi_msg array and send all messages at once */
 int32_t spi_transfer(struct spi_desc *desc, struct spi_msg *msgs, uint32_t len);
 
+/* Start queuing the accesses done with spi_batch_write()/spi_batch_read(). */
+int32_t spi_batch_begin(struct spi_desc *desc);
+
+/* Send the queued accesses and stop queuing. */
+int32_t spi_batch_end(struct spi_desc *desc);
+
+/* Write data, or queue it if a batch is started. */
+int32_t spi_batch_write(struct spi_desc *desc, uint8_t *data,
+			uint16_t bytes_number);
+
+/* Write and read data, or queue it if a batch is started. */
+int32_t spi_batch_read(struct spi_desc *desc, uint8_t *data,
+		       uint16_t bytes_number);
+
+/* Send the queued accesses. */
+int32_t spi_batch_flush(struct spi_desc *desc);
+
 
 #endif // SPI_H_
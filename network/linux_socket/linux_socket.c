@@ -58,6 +58,7 @@
 #include <netdb.h>
 #include <string.h>
 #include <fcntl.h>
+#include <poll.h>
 
 /******************************************************************************/
 /*************************** FUnctions Declarations *******************************/
@@ -253,17 +254,46 @@ static int32_t linux_socket_accept(void *desc, uint32_t sock_id,
 				   uint32_t *client_socket_id)
 {
 	int32_t ret;
+	int one = 1;
 
 	ret = accept4(sock_id, NULL, NULL, SOCK_NONBLOCK);
 
 	if(ret < 0)
 		return -errno;
 
+	/* Answers are sent in small parts, don't wait for the peer's ack to
+	 * send the next one */
+	setsockopt(ret, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
 	*client_socket_id = ret;
 
 	return SUCCESS;
 }
 
+/** @brief See \ref network_interface.socket_wait */
+static int32_t linux_socket_wait(void *desc, uint32_t *sock_ids,
+				 uint32_t nb_sockets, uint32_t timeout_ms)
+{
+	struct pollfd	fds[MAX_SOCKETS_TO_WAIT];
+	uint32_t	i;
+	int32_t		ret;
+
+	if (nb_sockets > MAX_SOCKETS_TO_WAIT)
+		return -EINVAL;
+
+	for (i = 0; i < nb_sockets; i++) {
+		fds[i].fd = sock_ids[i];
+		fds[i].events = POLLIN;
+		fds[i].revents = 0;
+	}
+
+	ret = poll(fds, nb_sockets, timeout_ms);
+	if (ret < 0)
+		return -errno;
+
+	return ret;
+}
+
 struct network_interface linux_net = {
 	.socket_open = (int32_t (*)(void *, uint32_t *, enum socket_protocol,
 				    uint32_t)) linux_socket_open,
@@ -276,7 +306,8 @@ struct network_interface linux_net = {
 	.socket_recvfrom = (int32_t (*)(void *, uint32_t, void *, uint32_t, struct socket_address* from))linux_socket_recvfrom,
 	.socket_bind = (int32_t (*)(void *, uint32_t, uint16_t))linux_socket_bind,
 	.socket_listen = (int32_t (*)(void *, uint32_t, uint32_t))linux_socket_listen,
-	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept
+	.socket_accept= (int32_t (*)(void *, uint32_t, uint32_t*))linux_socket_accept,
+	.socket_wait = (int32_t (*)(void *, uint32_t *, uint32_t, uint32_t))linux_socket_wait
 };
 
 #endif
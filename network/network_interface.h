@@ -47,6 +47,13 @@
 
 #include <stdint.h>
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Maximum number of sockets that can be given to socket_wait */
+#define MAX_SOCKETS_TO_WAIT	64
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -218,6 +225,22 @@ struct network_interface {
 	 */
 	int32_t (*socket_accept)(void *net, uint32_t sock_id,
 				 uint32_t *client_socket_id);
+
+	/**
+	 * @brief Wait until at least one of the sockets can be read.
+	 *
+	 * A listening socket is ready when a new connection can be accepted.
+	 * Optional, it may be left NULL if the network can't wait for events.
+	 * @param net - Network interface
+	 * @param sock_ids - Ids of the sockets to wait for
+	 * @param nb_sockets - Number of sockets (at most MAX_SOCKETS_TO_WAIT)
+	 * @param timeout_ms - Maximum time to wait
+	 * @return
+	 *  - Number of ready sockets, 0 if the timeout expired
+	 *  - \ref Negative error code on failure
+	 */
+	int32_t (*socket_wait)(void *net, uint32_t *sock_ids,
+			       uint32_t nb_sockets, uint32_t timeout_ms);
 };
 
 #endif
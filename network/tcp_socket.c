@@ -466,3 +466,32 @@ int32_t socket_accept(struct tcp_socket_desc *desc,
 	return SUCCESS;
 }
 
+/**
+ * @brief Wait until one of the sockets has data or a pending connection.
+ * All the sockets must use the same network interface.
+ * @param socks - Sockets to wait for
+ * @param nb_socks - Number of sockets
+ * @param timeout_ms - Maximum time to wait
+ * @return
+ *  - Number of ready sockets, 0 if the timeout expired
+ *  - -ENOSYS : The network interface can't wait for events
+ *  - Negative error code on failure
+ */
+int32_t socket_wait(struct tcp_socket_desc **socks, uint32_t nb_socks,
+		    uint32_t timeout_ms)
+{
+	uint32_t	ids[MAX_SOCKETS_TO_WAIT];
+	uint32_t	i;
+
+	if (!socks || !nb_socks || nb_socks > MAX_SOCKETS_TO_WAIT)
+		return -EINVAL;
+
+	if (!socks[0]->net->socket_wait)
+		return -ENOSYS;
+
+	for (i = 0; i < nb_socks; i++)
+		ids[i] = socks[i]->id;
+
+	return socks[0]->net->socket_wait(socks[0]->net->net, ids, nb_socks,
+					  timeout_ms);
+}
@@ -156,4 +156,8 @@ int32_t socket_listen(struct tcp_socket_desc *desc, uint32_t back_log);
 int32_t socket_accept(struct tcp_socket_desc *desc,
 		      struct tcp_socket_desc **new_client);
 
+/* Wait for incoming data or connections on multiple sockets */
+int32_t socket_wait(struct tcp_socket_desc **socks, uint32_t nb_socks,
+		    uint32_t timeout_ms);
+
 #endif
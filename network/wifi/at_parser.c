@@ -59,10 +59,6 @@
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 
-/* Should be sizeof(async_msgs)/sizeof(*async_msgs) */
-#define NB_ASYNC_MESSAGES	3
-/* Should be sizeof(responses)/sizeof(*responses) */
-#define NB_RESPONSE_MESSAGES	4
 /* Max command length: at+cwsap=max_ssid_32,max_pass_64,0,0 -> 110 characters */
 #define CMD_BUFF_LEN		120u
 /* Maybe this could be smaller. Here must one response at a time */
@@ -71,6 +67,8 @@
 #define PUI8(X)			((uint8_t *)(X))
 /* Timeout waiting for module response. (20 seconds) */
 #define MODULE_TIMEOUT		20000
+/* Period of the checks for the response of a command */
+#define RESPONSE_POLL_US	10
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -106,6 +104,37 @@ static const struct cmd_desc g_map[] = {
 	{{PUI8("+PING"), 5}, AT_SET_OP}
 };
 
+/* Messages searched in the data received from the module, see g_msgs */
+enum at_msg {
+	/* Responses of the commands */
+	AT_MSG_ERROR,
+	AT_MSG_FAIL,
+	AT_MSG_OK,
+	AT_MSG_SEND_OK,
+	/* Asynchronous messages */
+	AT_MSG_CLOSED,
+	AT_MSG_WIFI_DISCONNECT,
+	AT_MSG_WIFI_GOT_IP,
+	/* Header of a payload, followed by <conn,>len: */
+	AT_MSG_IPD,
+	NB_AT_MSGS,
+	AT_MSG_NONE = NB_AT_MSGS
+};
+
+static const struct at_buff g_msgs[NB_AT_MSGS] = {
+	{PUI8("\r\nERROR\r\n"), 9},
+	{PUI8("\r\nFAIL\r\n"), 8},
+	{PUI8("\r\nOK\r\n"), 6},
+	{PUI8("\r\nSEND OK\r\n"), 11},
+	{PUI8("CLOSED\r\n"), 8},
+	{PUI8("WIFI DISCONNECT\r\n"), 17},
+	{PUI8("WIFI GOT IP\r\n"), 13},
+	{PUI8("\r\n+IPD,"), 7}
+};
+
+/* Message sent by the module when the reset is done */
+static const struct at_buff g_ready_msg = {PUI8("ready\r\n"), 7};
+
 /* Structure storing a connection status */
 struct connection_desc {
 	/* Connection buffer */
@@ -149,6 +178,9 @@ struct at_desc {
 	struct at_buff		cmd;
 	/* Buffer to read one char */
 	uint8_t			read_ch;
+	/* The data is passed by chunks to at_rx() instead of read by the
+	 * uart callback */
+	bool			rx_chunks;
 
 	/* - Control fields */
 	/* Variable to store errors */
@@ -169,10 +201,12 @@ struct at_desc {
 	}			callback_operation;
 	/* Indexes in the ready message */
 	uint8_t			ready_idx;
-	/* Indexes in the async response given by the driver */
-	uint8_t			async_idx[NB_ASYNC_MESSAGES];
-	/* Indexes in the response given by the driver */
-	uint8_t			resp_idx[NB_RESPONSE_MESSAGES];
+	/* Indexes in the messages of g_msgs */
+	uint8_t			msg_idx[NB_AT_MSGS];
+	/* Characters starting a message of g_msgs or '>', one bit each */
+	uint8_t			msg_start[256 / 8];
+	/* Last response received, AT_MSG_NONE if waiting for it */
+	volatile enum at_msg	response;
 	/* Ipd idx */
 	uint8_t			ipd_idx;
 	/* State of ipd command message */
@@ -214,19 +248,36 @@ static inline bool match_message(const struct at_buff *msg, uint8_t *idx,
 	return false;
 }
 
+/* Update the matching index of the messages first to last with ch and return
+ * the first message fully matched, or AT_MSG_NONE */
+static inline enum at_msg match_messages(struct at_desc *desc,
+		enum at_msg first, enum at_msg last, uint8_t ch)
+{
+	enum at_msg	i;
+
+	for (i = first; i <= last; i++)
+		if (match_message(&g_msgs[i], &desc->msg_idx[i], ch))
+			return i;
+
+	return AT_MSG_NONE;
+}
+
 /* Check if new payload message have been received and set the payload size in
  * to_read if so.
  */
 static inline bool is_payload_message(struct at_desc *desc, uint8_t ch)
 {
-	static const struct at_buff	at_ipd = {PUI8("\r\n+IPD,"), 7};
+	const struct at_buff	*at_ipd = &g_msgs[AT_MSG_IPD];
 	/* max_ch_search = at_ipd.len + sizeof("0,1024") */
 	bool		ret;
 
 	ret = false;
 	/* Update ipd_idx until at_ipd message is matched */
-	if (desc->ipd_idx < at_ipd.len) {
-		if (match_message(&at_ipd, &desc->ipd_idx, ch)) {
+	if (desc->ipd_stat == NOT_MATCH) {
+		if (match_messages(desc, AT_MSG_IPD, AT_MSG_IPD, ch) ==
+		    AT_MSG_IPD) {
+			desc->ipd_idx = at_ipd->len;
+			desc->msg_idx[AT_MSG_IPD] = 0;
 			if (desc->multiple_conections)
 				desc->ipd_stat = RAEDING_CONN;
 			else
@@ -277,8 +328,8 @@ reset:
 	return ret;
 }
 
-static inline int32_t check_conn_id(struct at_desc *desc, struct at_buff *msg,
-				    int32_t msg_idx)
+static inline int32_t check_conn_id(struct at_desc *desc,
+				    const struct at_buff *msg)
 {
 	int32_t	id;
 	int32_t	j;
@@ -311,7 +362,7 @@ static inline int32_t check_conn_id(struct at_desc *desc, struct at_buff *msg,
 		desc->connection_callback(desc->callback_ctx,
 					  AT_CLOSED_CONNECTION, id, NULL);
 	} else {//Not id
-		desc->async_idx[msg_idx] = 0;
+		desc->msg_idx[AT_MSG_CLOSED] = 0;
 		return false;
 	}
 
@@ -321,28 +372,18 @@ static inline int32_t check_conn_id(struct at_desc *desc, struct at_buff *msg,
 /* Check if an asynchronous messages was sent by the module and update desc */
 static bool is_async_messages(struct at_desc *desc, uint8_t ch)
 {
-	const static struct at_buff async_msgs[NB_ASYNC_MESSAGES] = {
-		{PUI8("CLOSED\r\n"), 8},
-		{PUI8("WIFI DISCONNECT\r\n"), 17},
-		{PUI8("WIFI GOT IP\r\n"), 13}
-	};
+	enum at_msg	msg;
 
-	int32_t	i;
-
-	for (i = 0; i < NB_ASYNC_MESSAGES; i++) {
-		if (match_message(&async_msgs[i], &desc->async_idx[i], ch))
-			break;
-	}
-
-	switch (i) {
-	case 0: //Match CLOSED\r\n
-		if (check_conn_id(desc, (struct at_buff *)&async_msgs[i], i))
+	msg = match_messages(desc, AT_MSG_CLOSED, AT_MSG_WIFI_GOT_IP, ch);
+	switch (msg) {
+	case AT_MSG_CLOSED:
+		if (check_conn_id(desc, &g_msgs[msg]))
 			return false;
 		break;
-	case 1: //WIFI DISCONNECT\r\n
+	case AT_MSG_WIFI_DISCONNECT:
 		desc->is_wifi_connected = false;
 		break;
-	case 2:
+	case AT_MSG_WIFI_GOT_IP:
 		desc->is_wifi_connected = true;
 		break;
 	default:
@@ -350,11 +391,203 @@ static bool is_async_messages(struct at_desc *desc, uint8_t ch)
 	}
 
 	/* Clear response indexes */
-	memset(desc->async_idx, 0, sizeof(desc->async_idx));
+	memset(&desc->msg_idx[AT_MSG_CLOSED], 0, AT_MSG_WIFI_GOT_IP -
+	       AT_MSG_CLOSED + 1);
 
 	return true;
 }
 
+/* Check if the response of a command has been received. The response is
+ * removed from the result and saved for wait_for_response() */
+static inline void is_response_message(struct at_desc *desc, uint8_t ch)
+{
+	enum at_msg	msg;
+
+	msg = match_messages(desc, AT_MSG_ERROR, AT_MSG_SEND_OK, ch);
+	if (msg == AT_MSG_NONE)
+		return;
+
+	/* The result may have been reset by an overflow in the meantime */
+	if (desc->result.len >= g_msgs[msg].len)
+		desc->result.len -= g_msgs[msg].len;
+	else
+		desc->result.len = 0;
+	memset(desc->msg_idx, 0, AT_MSG_SEND_OK - AT_MSG_ERROR + 1);
+	desc->response = msg;
+}
+
+/* True if a message may be in progress and each character must be checked */
+static inline bool is_matching(struct at_desc *desc)
+{
+	uint32_t	i;
+
+	if (desc->ipd_stat != NOT_MATCH)
+		return true;
+	for (i = 0; i < NB_AT_MSGS; i++)
+		if (desc->msg_idx[i])
+			return true;
+
+	return false;
+}
+
+/*
+ * Number of characters at the beginning of data that can not start a message.
+ * They do not change the matching state and go directly to the result.
+ */
+static inline uint32_t skip_len(struct at_desc *desc, const uint8_t *data,
+				uint32_t len)
+{
+	uint32_t	i;
+
+	for (i = 0; i < len; i++)
+		if (desc->msg_start[data[i] >> 3] & (1u << (data[i] & 7)))
+			break;
+
+	return i;
+}
+
+/* Add characters that are not part of a message to the result */
+static void add_to_result(struct at_desc *desc, const uint8_t *data,
+			  uint32_t len)
+{
+	uint32_t	n;
+
+	while (len) {
+		if (desc->result.len >= RESULT_BUFF_LEN) {
+			/* The character is dropped */
+			desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+			desc->result.len = 0;
+			data++;
+			len--;
+			continue;
+		}
+		n = min(len, RESULT_BUFF_LEN - desc->result.len);
+		memcpy(desc->result.buff + desc->result.len, data, n);
+		desc->result.len += n;
+		data += n;
+		len -= n;
+	}
+}
+
+/* Interpret a character received while reading responses. Return true if it
+ * ends a payload header */
+static bool parse_char(struct at_desc *desc, uint8_t ch)
+{
+	bool	in_header;
+
+	in_header = desc->ipd_stat != NOT_MATCH;
+	if (is_payload_message(desc, ch))
+		/* New payload received */
+		return true;
+
+	if (ch == '>' && desc->callback_operation == WAITING_SEND) {
+		desc->callback_operation = READING_RESPONSES;
+	} else if (desc->result.len >= RESULT_BUFF_LEN) {
+		desc->errors |= AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
+		desc->result.len = 0;
+	} else if (in_header && desc->ipd_stat != NOT_MATCH) {
+		/* The connection and length of a payload header can not be
+		 * part of other messages. They are removed from the result
+		 * with the header */
+		desc->result.buff[desc->result.len++] = ch;
+	} else if (!is_async_messages(desc, ch)) {
+		/* Add received character to result buffer */
+		desc->result.buff[desc->result.len++] = ch;
+		is_response_message(desc, ch);
+	}
+
+	return false;
+}
+
+/* Notify a new connection. Application needs to set a cbuff for the
+ * connection where data will be written. */
+static void start_conn(struct at_desc *desc)
+{
+	struct connection_desc	*conn;
+
+	conn = &desc->conn[desc->current_conn];
+	if (conn->active)
+		return;
+
+	desc->connection_callback(desc->callback_ctx, AT_NEW_CONNECTION,
+				  desc->current_conn, &conn->cbuff);
+	if (conn->cbuff)
+		conn->active = true;
+	/*
+	 * Else, a AT_STOP_CONNECTION command should be sent to the
+	 * esp8266 module. (Application rejects the connection)
+	 * This could be done only if implement at_run_cmd with
+	 * uart_write_nonblocking
+	 */
+}
+
+/* Copy the payload at the beginning of data to the connection buffer and
+ * return its length */
+static uint32_t parse_payload(struct at_desc *desc, const uint8_t *data,
+			      uint32_t len)
+{
+	struct connection_desc	*conn;
+
+	conn = &desc->conn[desc->current_conn];
+	len = min(len, conn->to_read);
+	if (conn->cbuff)
+		cb_write(conn->cbuff, data, len);
+	conn->to_read -= len;
+	if (!conn->to_read) {
+		desc->callback_operation = READING_RESPONSES;
+		desc->current_conn = -1;
+	}
+
+	return len;
+}
+
+/*
+ * Interpret data received from the module, in chunks of any size.
+ * The characters that can not start a message are added to the result in
+ * bulk and the payload is copied to the connection buffers. When receiving
+ * byte by byte (rx_chunks not set), parsing stops at the end of a payload
+ * header and the number of bytes parsed is returned.
+ */
+static uint32_t at_parse(struct at_desc *desc, const uint8_t *data,
+			 uint32_t len)
+{
+	uint32_t	i;
+	uint32_t	n;
+
+	i = 0;
+	while (i < len) {
+		switch (desc->callback_operation) {
+		case RESETTING_MODULE:
+			if (match_message(&g_ready_msg, &desc->ready_idx,
+					  data[i]))
+				desc->callback_operation = READING_RESPONSES;
+			i++;
+			break;
+		case READING_PAYLOAD:
+			i += parse_payload(desc, data + i, len - i);
+			break;
+		case WAITING_SEND:
+		case READING_RESPONSES:
+			if (!is_matching(desc)) {
+				n = skip_len(desc, data + i, len - i);
+				add_to_result(desc, data + i, n);
+				i += n;
+				if (i == len)
+					break;
+			}
+			if (parse_char(desc, data[i++])) {
+				desc->callback_operation = READING_PAYLOAD;
+				start_conn(desc);
+				if (!desc->rx_chunks)
+					return i;
+			}
+			break;
+		}
+	}
+
+	return i;
+}
+
 /* Mark the circular buffer transaction as ended */
 static inline void end_conn_read(struct at_desc *desc)
 {
@@ -366,7 +599,7 @@ static inline void end_conn_read(struct at_desc *desc)
 }
 
 /* Start new read operation */
-static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
+static inline void start_conn_read(struct at_desc *desc)
 {
 	struct connection_desc	*conn;
 	uint8_t			*buff;
@@ -375,25 +608,6 @@ static inline void start_conn_read(struct at_desc *desc, bool is_new_message)
 
 	conn = &desc->conn[desc->current_conn];
 
-	if (is_new_message && !conn->active) {
-		/*
-		 * Notify that a new connection has started. Application needs
-		 * to set a cbuff for the connection where data will be written.
-		 */
-		desc->connection_callback(desc->callback_ctx,
-					  AT_NEW_CONNECTION,
-					  desc->current_conn,
-					  &conn->cbuff);
-		if (conn->cbuff)
-			conn->active = true;
-		/*
-		 * Else, a AT_STOP_CONNECTION command should be sent to the
-		 * esp8266 module. (Application rejects the connection)
-		 * This could be done only if implement at_run_cmd with
-		 * uart_write_nonblocking
-		 */
-	}
-
 	if (!conn->cbuff)
 		/* There is no buffer set for this connection */
 		goto dummy_read;
@@ -419,36 +633,18 @@ dummy_read:
 /* Handle the uart events */
 static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
 {
-	static const struct at_buff ready_msg = {PUI8("ready\r\n"), 7};
-
 	switch (event) {
 	case IRQ_READ_DONE:
 		switch (desc->callback_operation) {
 		case RESETTING_MODULE:
-			if (match_message(&ready_msg, &desc->ready_idx,
-					  desc->read_ch))
-				desc->callback_operation = READING_RESPONSES;
-			break;
 		case WAITING_SEND:
 		case READING_RESPONSES:
-			if (is_payload_message(desc, desc->read_ch)) {
-				/* New payload received */
-				desc->callback_operation = READING_PAYLOAD;
-				start_conn_read(desc, true);
+			at_parse(desc, &desc->read_ch, 1);
+			if (desc->callback_operation == READING_PAYLOAD) {
+				/* Read the payload directly in the buffer */
+				start_conn_read(desc);
 				return ;
 			}
-
-			if (desc->read_ch == '>' && desc->callback_operation ==
-			    WAITING_SEND) {
-				desc->callback_operation = READING_RESPONSES;
-			} else if (desc->result.len >= RESULT_BUFF_LEN) {
-				desc->errors |=
-					AT_ERROR_INTERNAL_BUFFER_OVERFLOW;
-				desc->result.len = 0;
-			} else if (!is_async_messages(desc, desc->read_ch))
-				/* Add received character to result buffer */
-				desc->result.buff[desc->result.len++] =
-					desc->read_ch;
 			break;
 		case READING_PAYLOAD:
 			/* Receiving payload from connection */
@@ -458,7 +654,7 @@ static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
 				desc->current_conn = -1;
 				break;
 			} else {
-				start_conn_read(desc, false);
+				start_conn_read(desc);
 				return ;
 			}
 			break;
@@ -476,53 +672,52 @@ static void at_callback(struct at_desc *desc, uint32_t event, uint8_t *data)
 	uart_read_nonblocking(desc->uart_desc, &desc->read_ch, 1);
 }
 
+/**
+ * @brief Interpret data received from the module.
+ *
+ * Used when the parser is initialized without \ref at_init_param.irq_desc :
+ * the platform receives the data, e.g. with DMA transfers ended by an idle
+ * line interrupt, and passes each chunk to this function. The commands wait
+ * for their response, so it is called from the interrupt, or another thread,
+ * from before at_start() until at_remove(). The payload of the connections is
+ * copied to their buffers.
+ * @param desc - AT parser reference
+ * @param data - Received data
+ * @param len - Size of the data, any size
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t at_rx(struct at_desc *desc, const uint8_t *data, uint32_t len)
+{
+	if (!desc || !desc->rx_chunks || (!data && len))
+		return FAILURE;
+
+	at_parse(desc, data, len);
+
+	return SUCCESS;
+}
+
 /* Wait the response for the last command for MODULE_TIMEOUT milliseconds */
 static int32_t wait_for_response(struct at_desc *desc)
 {
-	const static struct at_buff responses[NB_RESPONSE_MESSAGES] = {
-		{PUI8("\r\nERROR\r\n"), 9},
-		{PUI8("\r\nFAIL\r\n"), 8},
-		{PUI8("\r\nOK\r\n"), 6},
-		{PUI8("\r\nSEND OK\r\n"), 11}
-	};
 	uint32_t	timeout;
-	uint32_t	result;
-	uint32_t	i;
-	uint32_t	j;
+	int32_t		result;
 
-	i = 0;
-	timeout = MODULE_TIMEOUT;
-	result = FAILURE;
-	do {
-		if (i < desc->result.len) {
-			for (j = 0; j < NB_RESPONSE_MESSAGES; j++)
-				if (match_message(&responses[j],
-						  &desc->resp_idx[j],
-						  desc->result.buff[i]))
-					break;
+	timeout = MODULE_TIMEOUT * (1000 / RESPONSE_POLL_US);
+	while (desc->response == AT_MSG_NONE && --timeout)
+		udelay(RESPONSE_POLL_US);
 
-			i++;
-			switch (j) {
-			case 0: // \r\nERROR\r\n
-			case 1: // \r\nFAIL\r\n
-				result = FAILURE;
-				goto end;
-			case 2: // \r\nOK\r\n
-			case 3: // \r\nSEND OK\r\n
-				result = SUCCESS;
-				goto end;
-			default:
-				break;
-			}
-		}
-		mdelay(1);
-	} while (--timeout);
-
-end:
-	if (timeout) //If a response arrived clean the result
-		desc->result.len -= desc->resp_idx[j];
-
-	memset(desc->resp_idx, 0, sizeof(desc->resp_idx));
+	switch (desc->response) {
+	case AT_MSG_OK:
+	case AT_MSG_SEND_OK:
+		result = SUCCESS;
+		break;
+	default:
+		result = FAILURE;
+		break;
+	}
+	desc->response = AT_MSG_NONE;
 
 	return result;
 }
@@ -533,6 +728,7 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 {
 	uint32_t timeout = MODULE_TIMEOUT;
 
+	desc->response = AT_MSG_NONE;
 	uart_write(desc->uart_desc, desc->cmd.buff, desc->cmd.len);
 	if (cmd == AT_SEND) {
 		desc->callback_operation = WAITING_SEND;
@@ -548,6 +744,7 @@ static int32_t send_cmd(struct at_desc *desc, enum at_cmd cmd,
 		if (timeout == 0)
 			return FAILURE;
 		/* Write payload */
+		desc->response = AT_MSG_NONE;
 		uart_write(desc->uart_desc, in_param->send_data.data.buff,
 			   in_param->send_data.data.len);
 	} else if (cmd == AT_DISCONNECT_NETWORK) {
@@ -777,6 +974,7 @@ static void build_cmd(struct at_desc *desc, enum at_cmd cmd,
 /* Send ATE0 command to stop echo */
 static int32_t stop_echo(struct at_desc *desc)
 {
+	desc->response = AT_MSG_NONE;
 	uart_write(desc->uart_desc, (uint8_t *)"ATE0\r\n", 6);
 
 	if (SUCCESS != wait_for_response(desc))
@@ -805,7 +1003,7 @@ static int32_t handle_special(struct at_desc *desc, enum at_cmd cmd)
 		if (!timeout)
 			return FAILURE;
 
-		desc->callback_operation = READING_PAYLOAD;
+		desc->callback_operation = READING_RESPONSES;
 		desc->result.len = 0;
 		if (SUCCESS != stop_echo(desc))
 			return FAILURE;
@@ -895,10 +1093,57 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 	return SUCCESS;
 }
 
+/**
+ * @brief Configure the module: disable the echo, test it and read the
+ * connection type.
+ *
+ * Called by \ref at_init when the parser reads the UART. Without
+ * \ref at_init_param.irq_desc , the application calls it after at_init(), once
+ * it passes the data received from the module to at_rx().
+ * @param desc - AT parser reference
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t at_start(struct at_desc *desc)
+{
+	union in_out_param	result;
+	uint32_t		conn;
+	uint8_t			*str;
+
+	if (!desc)
+		return FAILURE;
+
+	/* Disable echoing response */
+	if (SUCCESS != stop_echo(desc))
+		return FAILURE;
+
+	/* Test AT */
+	if (SUCCESS != at_run_cmd(desc, AT_ATTENTION, AT_EXECUTE_OP, NULL))
+		return FAILURE;
+
+	/* Get the connection type */
+	if (SUCCESS != at_run_cmd(desc, AT_SET_CONNECTION_TYPE, AT_QUERY_OP,
+				  &result))
+		return FAILURE;
+
+	/* Convert to null terminated string in order to use sscanf */
+	at_to_str(&str, &result.out.result);
+	sscanf((char *)str, "+CIPMUX:%"PRIu32"\r\n", &conn);
+
+	desc->cmd.len = 0;
+	desc->multiple_conections = conn ? true : false;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Initialize the AT parser
+ *
+ * Without \ref at_init_param.irq_desc , nothing is sent to the module: the
+ * application then passes the received data to at_rx() and calls at_start().
  * @param desc - Address where to store the AT parser reference used by the
- * driver functions.
+ * driver functions
  * @param param - Initializing data
  * @return
  *  - \ref SUCCESS : On success
@@ -907,10 +1152,9 @@ int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 {
 	struct at_desc		*ldesc;
-	union in_out_param	result;
 	struct callback_desc	callback_desc;
-	uint32_t		conn;
-	uint8_t			*str;
+	uint32_t		i;
+	uint8_t			ch;
 
 	if (!desc || !param || !param->connection_callback)
 		return FAILURE;
@@ -925,6 +1169,32 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	ldesc->uart_desc = param->uart_desc;
 	ldesc->irq_desc = param->irq_desc;
 	ldesc->uart_irq_id = param->uart_irq_id;
+	ldesc->response = AT_MSG_NONE;
+	ldesc->current_conn = -1;
+
+	/* Characters that may start a message */
+	for (i = 0; i < NB_AT_MSGS; i++) {
+		ch = g_msgs[i].buff[0];
+		ldesc->msg_start[ch >> 3] |= 1u << (ch & 7);
+	}
+	ldesc->msg_start['>' >> 3] |= 1u << ('>' & 7);
+
+	/* Link buffer structure with static buffers */
+	ldesc->result.buff = ldesc->buffers.result_buff;
+	ldesc->result.len = 0;
+	ldesc->cmd.buff = ldesc->buffers.cmd_buff;
+	ldesc->cmd.len = CMD_BUFF_LEN;
+
+	ldesc->callback_operation = READING_RESPONSES;
+
+	if (!ldesc->irq_desc) {
+		/* The data is received by the application, see at_rx() */
+		ldesc->rx_chunks = true;
+		*desc = ldesc;
+
+		return SUCCESS;
+	}
+
 	callback_desc.callback =
 		(void (*)(void*, uint32_t, void*))at_callback;
 	callback_desc.ctx = ldesc;
@@ -940,34 +1210,8 @@ int32_t at_init(struct at_desc **desc, const struct at_init_param *param)
 	/* The read will be handled by the callback */
 	uart_read_nonblocking(ldesc->uart_desc, &ldesc->read_ch, 1);
 
-	/* Link buffer structure with static buffers */
-	ldesc->result.buff = ldesc->buffers.result_buff;
-	ldesc->result.len = 0;
-	ldesc->cmd.buff = ldesc->buffers.cmd_buff;
-	ldesc->cmd.len = CMD_BUFF_LEN;
-
-	ldesc->callback_operation = READING_RESPONSES;
-
-	/* Disable echoing response */
-	if (SUCCESS != stop_echo(ldesc))
-		goto free_irq;
-
-	/* Test AT */
-	if (SUCCESS != at_run_cmd(ldesc, AT_ATTENTION, AT_EXECUTE_OP, NULL))
-		goto free_irq;
-
-	/* Get the connection type */
-	if (SUCCESS == at_run_cmd(ldesc, AT_SET_CONNECTION_TYPE, AT_QUERY_OP,
-				  &result)) {
-		/* Convert to null terminated string in order to use sscanf */
-		at_to_str(&str, &result.out.result);
-		sscanf((char *)str, "+CIPMUX:%"PRIu32"\r\n", &conn);
-
-		ldesc->cmd.len = 0;
-		ldesc->multiple_conections = conn ? true : false;
-	} else {
+	if (SUCCESS != at_start(ldesc))
 		goto free_irq;
-	}
 
 	*desc = ldesc;
 	return SUCCESS;
@@ -992,7 +1236,8 @@ int32_t at_remove(struct at_desc *desc)
 	if (!desc)
 		return FAILURE;
 
-	irq_unregister(desc->irq_desc, desc->uart_irq_id);
+	if (desc->irq_desc)
+		irq_unregister(desc->irq_desc, desc->uart_irq_id);
 	free(desc);
 
 	return SUCCESS;
@@ -314,6 +314,14 @@ union in_out_param {
 struct at_init_param {
 	/* Should be initialized outside in order to fill uart_irq_conf */
 	struct uart_desc	*uart_desc;
+	/*
+	 * If set, the parser reads the UART from its interrupt: the responses
+	 * one byte per interrupt, the UART reads having a fixed size, and each
+	 * payload in one read.
+	 * If NULL, the parser does not read from the UART: the data received
+	 * from the module must be passed to at_rx() and the module is
+	 * configured by at_start() instead of at_init()
+	 */
 	struct irq_ctrl_desc	*irq_desc;
 	uint32_t		uart_irq_id;
 	void			*uart_irq_conf;
@@ -346,6 +354,11 @@ int32_t at_init(struct at_desc **desc,const struct at_init_param *param);
 /* Free resources used by parser */
 int32_t at_remove(struct at_desc *desc);
 
+/* Configure the module */
+int32_t at_start(struct at_desc *desc);
+/* Interpret data received from the module */
+int32_t at_rx(struct at_desc *desc, const uint8_t *data, uint32_t len);
+
 /* Execute an AT command */
 int32_t at_run_cmd(struct at_desc *desc, enum at_cmd cmd, enum cmd_operation op,
 		   union in_out_param *param);
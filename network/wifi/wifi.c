@@ -291,8 +291,35 @@ static void _wifi_connection_callback(void *ctx, enum at_event event,
 	}
 }
 
+/* Reset the module and set it as client with multiple connections */
+static int32_t _wifi_configure(struct wifi_desc *desc)
+{
+	union in_out_param	par;
+	int32_t			result;
+
+	result = at_run_cmd(desc->at, AT_RESET, AT_EXECUTE_OP, NULL);
+	if (IS_ERR_VALUE(result))
+		return FAILURE;
+
+	par.in.wifi_mode = CLIENT;
+	result = at_run_cmd(desc->at, AT_SET_OPERATION_MODE, AT_SET_OP, &par);
+	if (IS_ERR_VALUE(result))
+		return FAILURE;
+
+	par.in.conn_type = MULTIPLE_CONNECTION;
+	result = at_run_cmd(desc->at, AT_SET_CONNECTION_TYPE, AT_SET_OP, &par);
+	if (IS_ERR_VALUE(result))
+		return FAILURE;
+
+	return SUCCESS;
+}
+
 /**
  * @brief Allocate resources and initializes a wifi descriptor
+ *
+ * Without \ref wifi_init_param.irq_desc , the module is not configured yet:
+ * the application passes the data received from the module to wifi_rx() and
+ * calls wifi_start().
  * @param desc - Address where to store the wifi descriptor
  * @param param - Initializing data
  * @return
@@ -304,7 +331,6 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 	struct wifi_desc	*ldesc;
 	struct at_init_param	at_param;
 	int32_t			result;
-	union in_out_param	par;
 
 	if (!desc || !param)
 		return FAILURE;
@@ -330,19 +356,11 @@ int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param)
 
 	wifi_init_interface(ldesc);
 
-	result = at_run_cmd(ldesc->at, AT_RESET, AT_EXECUTE_OP, NULL);
-	if (IS_ERR_VALUE(result))
-		goto at_err;
-
-	par.in.wifi_mode = CLIENT;
-	result = at_run_cmd(ldesc->at, AT_SET_OPERATION_MODE, AT_SET_OP, &par);
-	if (IS_ERR_VALUE(result))
-		goto at_err;
-
-	par.in.conn_type = MULTIPLE_CONNECTION;
-	result = at_run_cmd(ldesc->at, AT_SET_CONNECTION_TYPE, AT_SET_OP, &par);
-	if (IS_ERR_VALUE(result))
-		goto at_err;
+	if (param->irq_desc) {
+		result = _wifi_configure(ldesc);
+		if (IS_ERR_VALUE(result))
+			goto at_err;
+	}
 	*desc = ldesc;
 
 	return SUCCESS;
@@ -354,6 +372,43 @@ ldesc_err:
 	return FAILURE;
 }
 
+/**
+ * @brief Configure the module, when initialized without
+ * \ref wifi_init_param.irq_desc
+ * @param desc - Wifi descriptor
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t wifi_start(struct wifi_desc *desc)
+{
+	if (!desc)
+		return FAILURE;
+
+	if (SUCCESS != at_start(desc->at))
+		return FAILURE;
+
+	return _wifi_configure(desc);
+}
+
+/**
+ * @brief Pass data received from the module, when initialized without
+ * \ref wifi_init_param.irq_desc . See at_rx().
+ * @param desc - Wifi descriptor
+ * @param data - Received data
+ * @param len - Size of the data, any size
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t wifi_rx(struct wifi_desc *desc, const uint8_t *data, uint32_t len)
+{
+	if (!desc)
+		return FAILURE;
+
+	return at_rx(desc->at, data, len);
+}
+
 /**
  * @brief Deallocate resources from the wifi descriptor
  * @param desc - Wifi descriptor
@@ -67,7 +67,10 @@ struct wifi_desc;
 struct wifi_init_param {
 	/** Uart descriptor where ESP8266 is connected */
 	struct uart_desc	*uart_desc;
-	/** Irq controler descriptor */
+	/**
+	 * Irq controler descriptor. If NULL, the received data is passed to
+	 * wifi_rx() and the module is configured by wifi_start()
+	 */
 	struct irq_ctrl_desc	*irq_desc;
 	/** Id of the UART interrupt */
 	uint32_t		uart_irq_id;
@@ -81,6 +84,10 @@ struct wifi_init_param {
 
 /* Wifi init */
 int32_t wifi_init(struct wifi_desc **desc, struct wifi_init_param *param);
+/* Wifi start, when initialized without irq_desc */
+int32_t wifi_start(struct wifi_desc *desc);
+/* Wifi receive, when initialized without irq_desc */
+int32_t wifi_rx(struct wifi_desc *desc, const uint8_t *data, uint32_t len);
 /* Wifi remove */
 int32_t wifi_remove(struct wifi_desc *desc);
 /* Wifi connect */
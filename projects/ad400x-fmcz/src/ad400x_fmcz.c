@@ -16,6 +16,8 @@
 /********************** Macros and Constants Definitions **********************/
 /******************************************************************************/
 #define AD400x_EVB_SAMPLE_NO			10000
+#define AD400x_EVB_STREAM_PERIODS		4
+#define AD400x_EVB_STREAM_PERIOD_SAMPLES	1024
 #define AD400X_DMA_BASEADDR             XPAR_AXI_AD40XX_DMA_BASEADDR
 #define AD400X_SPI_ENGINE_BASEADDR      XPAR_SPI_AD40XX_AXI_REGMAP_BASEADDR
 #define AD400x_SPI_CS                   0
@@ -35,6 +37,13 @@ int main()
 		.rx_dma_baseaddr = AD400X_DMA_BASEADDR,
 	};
 	struct spi_engine_offload_message msg;
+	struct spi_engine_stream_init_param stream_init_param = {
+		.buff = (uint8_t *)0x800000,
+		.no_periods = AD400x_EVB_STREAM_PERIODS,
+		.period_samples = AD400x_EVB_STREAM_PERIOD_SAMPLES,
+	};
+	struct spi_engine_session *session;
+	uint32_t avail;
 	uint32_t commands_data[2] = {0xFF, 0xFF};
 	int32_t ret, data, i;
 	enum ad400x_supported_dev_ids dev_id = ID_AD4020;
@@ -80,6 +89,49 @@ int main()
 			xil_printf("ADC: %d\n\r", adc_data);
 		}
 	}
+	/* Continuous offload example, the samples are read from a ring buffer
+	 * while the DMA keeps writing it */
+	else if (SPI_ENGINE_OFFLOAD_EXAMPLE == 2) {
+		ret = spi_engine_session_init(&session, dev->spi_desc,
+					      &spi_engine_offload_init_param);
+		if (ret != SUCCESS)
+			return FAILURE;
+
+		msg.commands = spi_eng_msg_cmds;
+		msg.no_commands = ARRAY_SIZE(spi_eng_msg_cmds);
+		msg.commands_data = commands_data;
+
+		ret = spi_engine_session_load(session, &msg);
+		if (ret != SUCCESS)
+			return ret;
+
+		ret = spi_engine_stream_start(session, &stream_init_param);
+		if (ret != SUCCESS)
+			return ret;
+
+		while(1) {
+			ret = spi_engine_stream_read(session, UINT32_MAX,
+						     (void **)&offload_data,
+						     &avail);
+			if (ret == -EAGAIN)
+				continue;
+			if (ret == -EOVERRUN)
+				xil_printf("Overrun, samples were lost\n\r");
+			else if (ret != SUCCESS)
+				return ret;
+
+			Xil_DCacheInvalidateRange((uint32_t)offload_data, avail);
+			for(i = 0; i < avail / 4; i++) {
+				data = offload_data[i] &
+				       GENMASK(ad400x_device_resol[dev_id], 0);
+				if (data > 524287)
+					data = data - 1048576;
+				printf("ADC: %"PRIi32" \n", data);
+			}
+
+			spi_engine_stream_release(session);
+		}
+	}
 	/* Offload example */
 	else {
 		ret = spi_engine_offload_init(dev->spi_desc, &spi_engine_offload_init_param);
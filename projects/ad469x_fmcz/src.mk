@@ -17,6 +17,7 @@ SRCS += $(DRIVERS)/spi/spi.c						\
 	$(DRIVERS)/axi_core/clk_axi_clkgen/clk_axi_clkgen.c		\
 	$(DRIVERS)/axi_core/axi_pwmgen/axi_pwm.c			\
 	$(DRIVERS)/axi_core/spi_engine/spi_engine.c			\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(NO-OS)/util/util.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 	$(PLATFORM_DRIVERS)/xilinx_gpio.c				\
@@ -45,6 +46,7 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/pwm.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/delay.h						\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
@@ -16,6 +16,7 @@ SRCS += $(PROJECT)/src/ad5766_core.c					\
 	$(DRIVERS)/gpio/gpio.c						\
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c				\
 	$(DRIVERS)/axi_core/spi_engine/spi_engine.c			\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(NO-OS)/util/util.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 	$(PLATFORM_DRIVERS)/xilinx_gpio.c				\
@@ -33,6 +34,7 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/spi.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/delay.h						\
 	$(INCLUDE)/print_log.h						\
 	$(INCLUDE)/util.h
@@ -32,6 +32,7 @@ SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 ifeq (y,$(strip $(TINYIIOD)))
 LIBRARIES += iio
 SRCS += $(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(NO-OS)/util/list.c						\
 	$(DRIVERS)/axi_core/iio_axi_adc/iio_axi_adc.c				\
 	$(PLATFORM_DRIVERS)/uart.c					\
@@ -61,6 +62,7 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/print_log.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS += $(INCLUDE)/fifo.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
@@ -75,7 +75,7 @@ int main(void)
 	struct iio_desc  *iio_device;
 
 	/* iio initialization structure */
-	struct iio_init_param iio_inital;
+	struct iio_init_param iio_inital = { 0 };
 
 	/* Initialization for UART. */
 	struct uart_init_param uart_init_par;
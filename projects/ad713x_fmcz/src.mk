@@ -16,6 +16,7 @@ SRCS += $(DRIVERS)/spi/spi.c						\
 	$(DRIVERS)/gpio/gpio.c						\
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c				\
 	$(DRIVERS)/axi_core/spi_engine/spi_engine.c			\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(NO-OS)/util/util.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 	$(PLATFORM_DRIVERS)/xilinx_gpio.c				\
@@ -40,6 +41,7 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/spi.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/delay.h						\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
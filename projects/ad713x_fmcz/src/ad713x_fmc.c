@@ -83,6 +83,7 @@ int main()
 	int32_t ret;
 	struct spi_engine_offload_init_param spi_engine_offload_init_param;
 	struct spi_engine_offload_message spi_engine_offload_message;
+	struct spi_engine_session *offload;
 	uint32_t spi_eng_msg_cmds[2];
 	static struct xil_spi_init_param spi_engine_init_params = {
 		.type = SPI_PS,
@@ -224,7 +225,8 @@ int main()
 	if (ret != SUCCESS)
 		return FAILURE;
 
-	ret = spi_engine_offload_init(spi_eng_desc, &spi_engine_offload_init_param);
+	ret = spi_engine_session_init(&offload, spi_eng_desc,
+				      &spi_engine_offload_init_param);
 	if (ret != SUCCESS)
 		return FAILURE;
 
@@ -244,7 +246,7 @@ int main()
 	struct iio_ad713x_init_par iio_ad713x_init_par = {
 		.dev = ad713x_dev_2,
 		.num_channels = 8,
-		.spi_eng_desc = spi_eng_desc,
+		.offload = offload,
 		.spi_engine_offload_message = &spi_engine_offload_message,
 		.dcache_invalidate_range = (void (*)(uint32_t, uint32_t))Xil_DCacheInvalidateRange,
 	};
@@ -274,13 +276,11 @@ int main()
 
 #endif /* IIO_SUPPORT */
 
-	ret = spi_engine_offload_transfer(spi_eng_desc, spi_engine_offload_message,
+	ret = spi_engine_session_transfer(offload, &spi_engine_offload_message,
 					  (AD7134_FMC_CH_NO * AD7134_FMC_SAMPLE_NO));
 	if (ret != SUCCESS)
 		return ret;
 
-	mdelay(1000);
-
 	Xil_DCacheInvalidateRange(0x800000, 16384 * 16);
 
 	const float lsb = 4.096 / (pow(2, 23));
@@ -308,6 +308,7 @@ int main()
 		offload_data += j; /* go to the next address in memory */
 	}
 
+	spi_engine_session_remove(offload);
 	ad713x_remove(ad713x_dev_1);
 	ad713x_remove(ad713x_dev_2);
 	print("Bye\n\r");
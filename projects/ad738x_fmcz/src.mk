@@ -14,6 +14,7 @@ SRCS += $(DRIVERS)/adc/ad738x/ad738x.c					\
 	$(DRIVERS)/spi/spi.c						\
 	$(DRIVERS)/axi_core/axi_dmac/axi_dmac.c				\
 	$(DRIVERS)/axi_core/spi_engine/spi_engine.c			\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(NO-OS)/util/util.c
 SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 	$(PLATFORM_DRIVERS)/xilinx_spi.c				\
@@ -28,6 +29,7 @@ INCS +=	$(PLATFORM_DRIVERS)/spi_extra.h
 INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/spi.h						\
 	$(INCLUDE)/error.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/delay.h						\
 	$(INCLUDE)/print_log.h						\
 	$(INCLUDE)/util.h
@@ -119,6 +119,7 @@ int main()
 		.tx_dma_baseaddr = AD77681_DMA_1_BASEADDR
 	};
 	struct spi_engine_offload_message spi_engine_offload_message;
+	struct spi_engine_session *offload;
 
 	Xil_ICacheEnable();
 	Xil_DCacheEnable();
@@ -148,7 +149,7 @@ int main()
 			mdelay(1000);
 		}
 	} else {
-		ret = spi_engine_offload_init(adc_dev->spi_desc,
+		ret = spi_engine_session_init(&offload, adc_dev->spi_desc,
 					      &spi_engine_offload_init_param);
 		if (ret != SUCCESS)
 			return FAILURE;
@@ -159,13 +160,11 @@ int main()
 		spi_engine_offload_message.rx_addr = 0x800000;
 		spi_engine_offload_message.tx_addr = 0xA000000;
 
-		ret = spi_engine_offload_transfer(adc_dev->spi_desc, spi_engine_offload_message,
+		ret = spi_engine_session_transfer(offload, &spi_engine_offload_message,
 						  AD77681_EVB_SAMPLE_NO);
 		if (ret != SUCCESS)
 			return ret;
 
-		mdelay(1000);
-
 		Xil_DCacheInvalidateRange(spi_engine_offload_message.rx_addr,
 					  AD77681_EVB_SAMPLE_NO * 4);
 
@@ -173,6 +172,8 @@ int main()
 			printf("%x\r\n", *data);
 			data += sizeof(uint8_t);
 		}
+
+		spi_engine_session_remove(offload);
 	}
 
 	printf("Bye\n");
@@ -14,6 +14,7 @@ SRCS += $(PROJECT)/src/ad7768_evb.c
 SRCS += $(NO-OS)/util/fifo.c
 SRCS += $(NO-OS)/util/util.c
 SRCS += $(NO-OS)/util/list.c
+SRCS += $(NO-OS)/util/circular_buffer.c
 
 # Add to INCS inlcude files to be build in the porject
 INCS += $(INCLUDE)/error.h
@@ -28,6 +29,7 @@ INCS += $(INCLUDE)/list.h
 INCS += $(INCLUDE)/uart.h
 INCS += $(INCLUDE)/irq.h
 INCS += $(INCLUDE)/fifo.h
+INCS += $(INCLUDE)/circular_buffer.h
 INCS += $(PROJECT)/src/parameters.h
 
 # Add to SRC_DIRS directories to be used in the build. All .c and .h files from
@@ -45,6 +45,7 @@ SRCS += $(PROJECT)/src/app_iio.c					\
 	$(PLATFORM_DRIVERS)/irq.c					\
 	$(NO-OS)/util/list.c						\
 	$(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(DRIVERS)/axi_core/iio_axi_adc/iio_axi_adc.c				\
 	$(DRIVERS)/axi_core/iio_axi_dac/iio_axi_dac.c
 endif
@@ -99,6 +100,7 @@ INCS += $(PROJECT)/src/app_iio.h					\
 	$(PLATFORM_DRIVERS)/irq_extra.h					\
 	$(PLATFORM_DRIVERS)/uart_extra.h				\
 	$(INCLUDE)/fifo.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/list.h						\
 	$(DRIVERS)/axi_core/iio_axi_adc/iio_axi_adc.h				\
 	$(DRIVERS)/axi_core/iio_axi_dac/iio_axi_dac.h
@@ -40,6 +40,7 @@ SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 	$(PLATFORM_DRIVERS)/delay.c
 ifeq (y,$(strip $(TINYIIOD)))
 SRCS += $(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(DRIVERS)/axi_core/iio_axi_adc/iio_axi_adc.c				\
 	$(NO-OS)/iio/iio_app/iio_app.c					\
 	$(NO-OS)/util/list.c						\
@@ -74,6 +75,7 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/util.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS += $(INCLUDE)/fifo.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
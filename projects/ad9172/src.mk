@@ -36,6 +36,7 @@ SRCS +=	$(PLATFORM_DRIVERS)/axi_io.c					\
 	$(PLATFORM_DRIVERS)/delay.c
 ifeq (y,$(strip $(TINYIIOD)))
 SRCS += $(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(NO-OS)/util/list.c						\
 	$(DRIVERS)/axi_core/iio_axi_dac/iio_axi_dac.c				\
 	$(PLATFORM_DRIVERS)/uart.c					\
@@ -69,6 +70,7 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/util.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS += $(INCLUDE)/fifo.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
@@ -21,6 +21,7 @@ SRCS += $(DRIVERS)/adc/ad9265/ad9265.c					\
 	$(NO-OS)/util/util.c
 ifeq (y,$(strip $(TINYIIOD)))
 SRCS += $(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(DRIVERS)/axi_core/iio_axi_adc/iio_axi_adc.c				\
 	$(NO-OS)/util/list.c						\
 	$(PLATFORM_DRIVERS)/uart.c					\
@@ -45,6 +46,7 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/util.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS +=	$(INCLUDE)/fifo.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
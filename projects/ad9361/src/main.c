@@ -57,6 +57,7 @@
 #ifdef LINUX_PLATFORM
 #include "linux_spi.h"
 #include "linux_gpio.h"
+#include "axi_io.h"
 #else
 #include "irq_extra.h"
 #endif //LINUX
@@ -723,7 +724,7 @@ int main(void)
 	/**
 	 * iio application configurations.
 	 */
-	struct iio_init_param iio_init_par;
+	struct iio_init_param iio_init_par = { 0 };
 
 	/**
 	 * iio axi adc configurations.
@@ -967,5 +968,9 @@ int main(void)
 	}
 #endif
 
+#ifdef LINUX_PLATFORM
+	axi_io_unmap_all();
+#endif
+
 	return 0;
 }
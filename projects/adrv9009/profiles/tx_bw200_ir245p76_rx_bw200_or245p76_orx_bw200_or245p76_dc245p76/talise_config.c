@@ -84,8 +84,8 @@ taliseInit_t talInit = {
 	.spiSettings =
 	{
 		.MSBFirst            = 1,  /* 1 = MSBFirst, 0 = LSBFirst */
-		.enSpiStreaming      = 0,  /* Not implemented in ADIs platform layer. SW feature to improve SPI throughput */
-		.autoIncAddrUp       = 1,  /* Not implemented in ADIs platform layer. For SPI Streaming, set address increment direction. 1= next addr = addr+1, 0:addr=addr-1 */
+		.enSpiStreaming      = 1,  /* SW feature to improve SPI throughput, used by ADIHAL_spiWriteBytes()/ADIHAL_spiReadBytes() */
+		.autoIncAddrUp       = 1,  /* For SPI Streaming, set address increment direction. 1= next addr = addr+1, 0:addr=addr-1 */
 		.fourWireMode        = 1,  /* 1: Use 4-wire SPI, 0: 3-wire SPI (SDIO pin is bidirectional). NOTE: ADI's FPGA platform always uses 4-wire mode */
 		.cmosPadDrvStrength  = TAL_CMOSPAD_DRV_2X /* Drive strength of CMOS pads when used as outputs (SDIO, SDO, GP_INTERRUPT, GPIO 1, GPIO 0) */
 	},
@@ -54,13 +54,15 @@ ifeq (y,$(strip $(TINYIIOD)))
 SRC_DIRS += $(NO-OS)/iio/iio_app
 LIBRARIES += iio
 SRCS += $(NO-OS)/util/fifo.c						\
+	$(NO-OS)/util/circular_buffer.c					\
 	$(NO-OS)/util/list.c						\
 	$(DRIVERS)/axi_core/iio_axi_adc/iio_axi_adc.c				\
 	$(DRIVERS)/axi_core/iio_axi_dac/iio_axi_dac.c                          \
 	$(PLATFORM_DRIVERS)/uart.c					\
 	$(PLATFORM_DRIVERS)/irq.c
 endif
-SRCS +=	$(NO-OS)/util/util.c
+SRCS +=	$(NO-OS)/util/util.c						\
+	$(NO-OS)/util/crc.c
 ifeq (xilinx,$(strip $(PLATFORM)))
 SRCS += $(DRIVERS)/axi_core/jesd204/xilinx_transceiver.c		\
 	$(DRIVERS)/axi_core/jesd204/axi_adxcvr.c			\
@@ -137,9 +139,14 @@ INCS +=	$(INCLUDE)/axi_io.h						\
 	$(INCLUDE)/gpio.h						\
 	$(INCLUDE)/error.h						\
 	$(INCLUDE)/delay.h						\
-	$(INCLUDE)/util.h
+	$(INCLUDE)/util.h						\
+	$(INCLUDE)/crc.h						\
+	$(INCLUDE)/crc8.h						\
+	$(INCLUDE)/crc16.h						\
+	$(INCLUDE)/crc24.h
 ifeq (y,$(strip $(TINYIIOD)))
 INCS +=	$(INCLUDE)/fifo.h						\
+	$(INCLUDE)/circular_buffer.h					\
 	$(INCLUDE)/irq.h						\
 	$(INCLUDE)/uart.h						\
 	$(INCLUDE)/list.h						\
@@ -54,6 +54,10 @@
 //#define ADRV9008_1
 //#define ADRV9008_2
 
+/* Uncomment to read back the ARM and stream processor images once they are
+ * loaded and compare their CRC with the one of the binaries: */
+// #define TALISE_VERIFY_IMAGES
+
 /* To build a specific example, uncomment one (only one) of the lines below: */
 // #define DAC_DMA_EXAMPLE
 // #define IIO_SUPPORT
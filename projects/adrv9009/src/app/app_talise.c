@@ -46,11 +46,13 @@
 #include "error.h"
 #include "delay.h"
 #include "util.h"
+#include "crc.h"
 
 // talise
 #include "talise.h"
 #include "talise_jesd204.h"
 #include "talise_arm.h"
+#include "talise_arm_macros.h"
 #include "talise_radioctrl.h"
 #include "talise_cals.h"
 #include "talise_config.h"
@@ -73,6 +75,36 @@
 #include "app_jesd.h"
 
 
+#ifdef TALISE_VERIFY_IMAGES
+/* Bytes read back from the ARM memory at a time */
+#define TALISE_VERIFY_CHUNK	1024
+
+/* Read back an image loaded in the ARM memory and compare its CRC-32 */
+static bool talise_verify_image(taliseDevice_t * const pd, uint32_t address,
+				uint8_t *image, uint32_t size)
+{
+	DECLARE_CRC_TABLE(crc32_table, 4);
+	uint8_t buf[TALISE_VERIFY_CHUNK];
+	struct crc_ctx ctx;
+	uint32_t i, len;
+
+	if (!crc32_table.width)
+		crc_populate_msb(&crc32_table, 32, 0x04C11DB7);
+
+	crc_init(&ctx, &crc32_table, 0xFFFFFFFF);
+	for (i = 0; i < size; i += len) {
+		len = min(size - i, TALISE_VERIFY_CHUNK);
+		if (TALISE_readArmMem(pd, address + i, buf, len, 1) !=
+		    TALACT_NO_ACTION)
+			return false;
+		crc_update(&ctx, buf, len);
+	}
+
+	return crc_final(&ctx) ==
+	       crc_compute(&crc32_table, image, size, 0xFFFFFFFF);
+}
+#endif
+
 bool adrv9009_check_sysref_rate(uint32_t lmfc, uint32_t sysref)
 {
 	uint32_t div, mod;
@@ -212,6 +244,18 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 			printf("error: TALISE_loadStreamFromBinary() failed\n");
 			goto error_11;
 		}
+#ifdef TALISE_VERIFY_IMAGES
+		/* Base address and size from the stream image header */
+		if (!talise_verify_image(pd,
+					 ((uint32_t)streamBinary[3] << 24) |
+					 (streamBinary[2] << 16) |
+					 (streamBinary[1] << 8) | streamBinary[0],
+					 &streamBinary[0],
+					 (streamBinary[11] << 8) | streamBinary[10])) {
+			printf("error: stream image read back failed\n");
+			goto error_11;
+		}
+#endif
 
 		talAction = TALISE_loadArmFromBinary(pd, &armBinary[0], count);
 		if (talAction != TALACT_NO_ACTION) {
@@ -219,6 +263,13 @@ adiHalErr_t talise_setup(taliseDevice_t * const pd, taliseInit_t * const pi)
 			printf("error: TALISE_loadArmFromBinary() failed\n");
 			goto error_11;
 		}
+#ifdef TALISE_VERIFY_IMAGES
+		if (!talise_verify_image(pd, TALISE_ADDR_ARM_START_PROG_ADDR,
+					 &armBinary[0], count)) {
+			printf("error: ARM image read back failed\n");
+			goto error_11;
+		}
+#endif
 
 		/* TALISE_verifyArmChecksum() will timeout after 200ms
 		 * if ARM checksum is not computed
@@ -26,6 +26,12 @@ struct adi_hal {
 	uint8_t			spi_adrv_csn;
 	void 			*extra_gpio;
 	uint8_t			gpio_adrv_resetb_num;
+	/* SPI mode of the device, followed from the SPI configuration writes */
+	uint8_t			spi_streaming;
+	uint8_t			spi_addr_ascend;
+	/* Transactions of ADIHAL_spiWriteBytes() and ADIHAL_spiReadBytes() */
+	struct spi_msg		*spi_msgs;
+	uint8_t			*spi_buf;
 };
 
 /**
@@ -287,6 +293,11 @@ adiHalErr_t ADIHAL_spiWriteByte(void *devHalInfo, uint16_t addr, uint8_t data);
  * If the platform layer SPI driver has no way to write an array to the SPI
  * driver, have this function call ADIHAL_spiWriteByte in a for loop.
  *
+ * The no-OS implementation sends the writes with a single spi_transfer().
+ * When SPI streaming is enabled in the device, runs of consecutive addresses
+ * (in the direction set by the address ascension bit) are written by one
+ * streaming transaction.
+ *
  * Each address element corresponds to the same index element in the data
  * array.  addr[0] is the SPI address for data[0], addr[1] is the SPI addr
  * for data[1], etc.
@@ -365,6 +376,9 @@ adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo, uint16_t addr,
  * This function shall perform multi SPI read from an ADI Device. The SPI
  * read implementation must support 16 bit addressing and 8-bit data bytes.
  *
+ * The no-OS implementation groups the reads the same way as
+ * ADIHAL_spiWriteBytes().
+ *
  * Returns an error of type adiHalErr_t. Error returned will depend on platform
  * specific implementation. API expects ADIHAL_OK if function completed successfully.
  * Any other value represents an error or warning to the API. Error return list
@@ -41,19 +41,161 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include "adi_hal.h"
 #include "parameters.h"
 #include "spi.h"
-#include "spi_extra.h"
 #include "gpio.h"
+#ifdef SIM_PLATFORM
+#include "sim_spi.h"
+#include "sim_gpio.h"
+#else
+#include "spi_extra.h"
 #include "gpio_extra.h"
+#endif
 #include "error.h"
 #include "delay.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#if defined(SIM_PLATFORM)
+#define HAL_SPI_OPS		sim_spi_platform_ops
+#define HAL_GPIO_OPS		sim_gpio_platform_ops
+#elif defined(ALTERA_PLATFORM)
+#define HAL_SPI_OPS		altera_platform_ops
+#define HAL_GPIO_OPS		altera_gpio_platform_ops
+#else
+#define HAL_SPI_OPS		xil_platform_ops
+#define HAL_GPIO_OPS		xil_gpio_platform_ops
+#endif
+
+/* SPI configuration registers of the device */
+#define HAL_SPI_CONFIG_A	0x0000
+#define HAL_SPI_CONFIG_B	0x0001
+#define HAL_SPI_SOFT_RESET	0x81
+#define HAL_SPI_ADDR_ASCEND	0x20
+#define HAL_SPI_SINGLE_INSTR	0x80
+
+/* Instruction bytes preceding the data of a transaction */
+#define HAL_SPI_INSTR_LEN	2
+/* Maximum number of data bytes of a streaming transaction */
+#define HAL_SPI_STREAM_MAX	64
+/* Maximum number of transactions and bytes sent by one spi_transfer() */
+#define HAL_SPI_XFER_MSGS	128
+#define HAL_SPI_XFER_SIZE	1024
+
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
 
+/* Follow the SPI configuration of the device after a register write */
+static void hal_spi_track(struct adi_hal *hal, uint16_t addr, uint8_t data)
+{
+	if (addr == HAL_SPI_CONFIG_A) {
+		if (data & HAL_SPI_SOFT_RESET) {
+			hal->spi_streaming = 0;
+			hal->spi_addr_ascend = 0;
+		} else {
+			hal->spi_addr_ascend = !!(data & HAL_SPI_ADDR_ASCEND);
+		}
+	} else if (addr == HAL_SPI_CONFIG_B) {
+		hal->spi_streaming = !(data & HAL_SPI_SINGLE_INSTR);
+	}
+}
+
+/*
+ * Number of accesses starting with addr[0] that can be done by a single
+ * transaction: the addresses following each other in the direction of the
+ * streaming mode, or one access if streaming is disabled.
+ */
+static uint32_t hal_spi_run(struct adi_hal *hal, uint16_t *addr,
+			    uint32_t count)
+{
+	uint16_t step;
+	uint32_t len;
+
+	if (!hal->spi_streaming)
+		return 1;
+
+	step = hal->spi_addr_ascend ? 1 : (uint16_t)-1;
+	for (len = 1; len < count && len < HAL_SPI_STREAM_MAX; len++)
+		if (addr[len] != (uint16_t)(addr[len - 1] + step))
+			break;
+
+	return len;
+}
+
+/*
+ * Write or read count registers with as few spi_transfer() calls as
+ * possible, one transaction per run of consecutive addresses. A write to the
+ * SPI configuration ends the transfer, so that the following transactions
+ * are built for the new mode.
+ */
+static adiHalErr_t hal_spi_bulk(struct adi_hal *hal, uint16_t *addr,
+				uint8_t *data, uint32_t count, bool read)
+{
+	struct spi_msg *msg;
+	uint32_t first, used, nb_msgs, len, i, j;
+	bool reconfig;
+	uint8_t *buf;
+	int32_t ret;
+
+	if (!hal->spi_msgs || !hal->spi_buf)
+		return ADIHAL_GEN_SW;
+
+	i = 0;
+	while (i < count) {
+		first = i;
+		used = 0;
+		nb_msgs = 0;
+		reconfig = false;
+		while (i < count && nb_msgs < HAL_SPI_XFER_MSGS && !reconfig) {
+			len = hal_spi_run(hal, &addr[i], count - i);
+			if (used + HAL_SPI_INSTR_LEN + len > HAL_SPI_XFER_SIZE)
+				break;
+
+			buf = hal->spi_buf + used;
+			buf[0] = (read ? 0x80 : 0x00) | ((addr[i] >> 8) & 0x7F);
+			buf[1] = addr[i] & 0xFF;
+			if (read)
+				memset(&buf[HAL_SPI_INSTR_LEN], 0, len);
+			else
+				memcpy(&buf[HAL_SPI_INSTR_LEN], &data[i], len);
+
+			msg = &hal->spi_msgs[nb_msgs++];
+			msg->tx_buff = buf;
+			msg->rx_buff = buf;
+			msg->bytes_number = HAL_SPI_INSTR_LEN + len;
+			msg->cs_change = 1;
+			used += msg->bytes_number;
+
+			for (j = i; j < i + len && !read; j++) {
+				if (addr[j] > HAL_SPI_CONFIG_B)
+					continue;
+				hal_spi_track(hal, addr[j], data[j]);
+				reconfig = true;
+			}
+			i += len;
+		}
+
+		ret = spi_transfer(hal->spi_adrv_desc, hal->spi_msgs, nb_msgs);
+		if (ret != SUCCESS)
+			return ADIHAL_SPI_FAIL;
+
+		for (j = 0; j < nb_msgs && read; j++) {
+			len = hal->spi_msgs[j].bytes_number - HAL_SPI_INSTR_LEN;
+			memcpy(&data[first],
+			       &hal->spi_msgs[j].rx_buff[HAL_SPI_INSTR_LEN], len);
+			first += len;
+		}
+	}
+
+	return ADIHAL_OK;
+}
+
 adiHalErr_t ADIHAL_setTimeout(void *devHalInfo, uint32_t halTimeout_ms)
 {
 	return ADIHAL_OK;
@@ -68,17 +210,9 @@ adiHalErr_t ADIHAL_openHw(void *devHalInfo, uint32_t halTimeout_ms)
 	int32_t status = 0;
 
 	gpio_adrv_resetb_param.number = dev_hal_data->gpio_adrv_resetb_num;
-#ifndef ALTERA_PLATFORM
-	gpio_adrv_resetb_param.platform_ops = &xil_gpio_platform_ops;
-#else
-	gpio_adrv_resetb_param.platform_ops = &altera_gpio_platform_ops;
-#endif
+	gpio_adrv_resetb_param.platform_ops = &HAL_GPIO_OPS;
 	gpio_adrv_sysref_req_param.number = SYSREF_REQ_GPIO;
-#ifndef ALTERA_PLATFORM
-	gpio_adrv_sysref_req_param.platform_ops = &xil_gpio_platform_ops;
-#else
-	gpio_adrv_sysref_req_param.platform_ops = &altera_gpio_platform_ops;
-#endif
+	gpio_adrv_sysref_req_param.platform_ops = &HAL_GPIO_OPS;
 
 	if (dev_hal_data->extra_gpio) {
 		gpio_adrv_resetb_param.extra = dev_hal_data->extra_gpio;
@@ -91,16 +225,20 @@ adiHalErr_t ADIHAL_openHw(void *devHalInfo, uint32_t halTimeout_ms)
 	spi_param.max_speed_hz = 25000000;
 	spi_param.mode = SPI_MODE_0;
 	spi_param.chip_select = dev_hal_data->spi_adrv_csn;
-#ifndef ALTERA_PLATFORM
-	spi_param.platform_ops = &xil_platform_ops;
-#else
-	spi_param.platform_ops = &altera_platform_ops;
-#endif
+	spi_param.platform_ops = &HAL_SPI_OPS;
 	if (dev_hal_data->extra_spi)
 		spi_param.extra = dev_hal_data->extra_spi;
 
 	status |= spi_init(&dev_hal_data->spi_adrv_desc, &spi_param);
 
+	dev_hal_data->spi_streaming = 0;
+	dev_hal_data->spi_addr_ascend = 0;
+	dev_hal_data->spi_msgs = calloc(HAL_SPI_XFER_MSGS,
+					sizeof(*dev_hal_data->spi_msgs));
+	dev_hal_data->spi_buf = calloc(HAL_SPI_XFER_SIZE, 1);
+	if (!dev_hal_data->spi_msgs || !dev_hal_data->spi_buf)
+		status = FAILURE;
+
 	status |= gpio_get(&dev_hal_data->gpio_adrv_sysref_req,
 			   &gpio_adrv_sysref_req_param);
 
@@ -121,6 +259,11 @@ adiHalErr_t ADIHAL_closeHw(void *devHalInfo)
 
 	status |= spi_remove(dev_hal_data->spi_adrv_desc);
 
+	free(dev_hal_data->spi_msgs);
+	free(dev_hal_data->spi_buf);
+	dev_hal_data->spi_msgs = NULL;
+	dev_hal_data->spi_buf = NULL;
+
 	if (status != SUCCESS)
 		return ADIHAL_ERR;
 	else
@@ -138,6 +281,10 @@ adiHalErr_t ADIHAL_resetHw(void *devHalInfo)
 	gpio_direction_output(devHalData->gpio_adrv_resetb, 1);
 	mdelay(10);
 
+	/* The SPI configuration is back to its default */
+	devHalData->spi_streaming = 0;
+	devHalData->spi_addr_ascend = 0;
+
 	return ADIHAL_OK;
 }
 
@@ -174,23 +321,16 @@ adiHalErr_t ADIHAL_spiWriteByte(void *devHalInfo,
 
 	if (status != SUCCESS)
 		return ADIHAL_SPI_FAIL;
-	else
-		return ADIHAL_OK;
+
+	hal_spi_track(devHalData, addr, data);
+
+	return ADIHAL_OK;
 }
 
 adiHalErr_t ADIHAL_spiWriteBytes(void *devHalInfo,
 				 uint16_t *addr, uint8_t *data, uint32_t count)
 {
-	adiHalErr_t errVal;
-	uint32_t i;
-
-	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiWriteByte(devHalInfo, addr[i], data[i]);
-		if (errVal)
-			return errVal;
-	}
-
-	return ADIHAL_OK;
+	return hal_spi_bulk(devHalInfo, addr, data, count, false);
 }
 
 adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
@@ -217,16 +357,7 @@ adiHalErr_t ADIHAL_spiReadByte(void *devHalInfo,
 adiHalErr_t ADIHAL_spiReadBytes(void *devHalInfo,
 				uint16_t *addr, uint8_t *readdata, uint32_t count)
 {
-	adiHalErr_t errVal;
-	uint32_t i;
-
-	for (i = 0; i < count; i++) {
-		errVal = ADIHAL_spiReadByte(devHalInfo, addr[i], &readdata[i]);
-		if (errVal)
-			return errVal;
-	}
-
-	return ADIHAL_OK;
+	return hal_spi_bulk(devHalInfo, addr, readdata, count, true);
 }
 
 adiHalErr_t ADIHAL_spiWriteField(void *devHalInfo,
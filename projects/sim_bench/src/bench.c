@@ -0,0 +1,152 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench.c
+ *   @brief  Helpers of the simulation benchmark.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "error.h"
+#include "util.h"
+#include "sim_spi.h"
+#include "bench.h"
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/* Counters of the SPI device model in use */
+static struct bench_spi_stats	*bench_spi_stats;
+static struct spi_platform_ops	bench_spi_ops;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Monotonic time in nanoseconds */
+uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* Print the result of a measurement */
+void bench_report(const char *name, uint64_t ns, uint32_t iterations,
+		  uint64_t bytes, struct sim_axi_region *region,
+		  uint64_t reads, uint64_t writes)
+{
+	printf("%-24s %10.3f us/call", name, ns / 1000.0 / iterations);
+	if (bytes)
+		printf(" %10.1f MB/s", bytes * 1000.0 / ns);
+	if (region)
+		printf(" %6.1f rd %6.1f wr /call",
+		       (double)(region->nb_reads - reads) / iterations,
+		       (double)(region->nb_writes - writes) / iterations);
+	printf("\n");
+}
+
+/* Check bytes which are a counter, *next being the expected first byte */
+int32_t bench_check_counter(uint8_t *data, uint32_t len, uint8_t *next)
+{
+	static uint8_t counter[512];
+	uint32_t i, n;
+
+	if (!counter[1])
+		for (i = 0; i < ARRAY_SIZE(counter); i++)
+			counter[i] = i;
+
+	for (i = 0; i < len; i += n) {
+		n = min(len - i, (uint32_t)256);
+		if (memcmp(data + i, counter + *next, n))
+			return FAILURE;
+		*next += n;
+	}
+
+	return SUCCESS;
+}
+
+static int32_t bench_spi_write_and_read(struct spi_desc *desc, uint8_t *data,
+					uint16_t bytes_number)
+{
+	bench_spi_stats->nb_calls++;
+
+	return sim_spi_platform_ops.write_and_read(desc, data, bytes_number);
+}
+
+static int32_t bench_spi_transfer(struct spi_desc *desc, struct spi_msg *msgs,
+				  uint32_t len)
+{
+	bench_spi_stats->nb_calls++;
+
+	return sim_spi_platform_ops.transfer(desc, msgs, len);
+}
+
+/* Simulated SPI platform counting its calls in stats. The device model counts
+ * the chip select assertions and bytes. */
+struct spi_platform_ops *bench_spi_counting_ops(struct bench_spi_stats *stats)
+{
+	bench_spi_stats = stats;
+	bench_spi_ops = sim_spi_platform_ops;
+	bench_spi_ops.write_and_read = bench_spi_write_and_read;
+	bench_spi_ops.transfer = bench_spi_transfer;
+
+	return &bench_spi_ops;
+}
+
+/* Print the SPI traffic since start, per call, and the latency it would have
+ * on hardware with call_ns per platform call and a clk_hz SPI clock */
+void bench_spi_report(const char *name, uint64_t ns, uint32_t iterations,
+		      const struct bench_spi_stats *stats,
+		      const struct bench_spi_stats *start, uint32_t call_ns,
+		      uint32_t clk_hz)
+{
+	double calls, xfers, bytes;
+
+	calls = (double)(stats->nb_calls - start->nb_calls) / iterations;
+	xfers = (double)(stats->nb_xfers - start->nb_xfers) / iterations;
+	bytes = (double)(stats->nb_bytes - start->nb_bytes) / iterations;
+
+	printf("%-24s %10.3f us/call %8.0f calls %8.0f CS %8.0f bytes /call,"
+	       " %10.1f us on hardware\n", name, ns / 1000.0 / iterations,
+	       calls, xfers, bytes,
+	       (calls * call_ns + bytes * 8e9 / clk_hz) / 1000.0);
+}
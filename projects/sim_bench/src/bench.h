@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench.h
+ *   @brief  Helpers and test areas of the simulation benchmark.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include "spi.h"
+#include "sim_axi_io.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* SPI traffic of a device model: platform calls, chip select assertions and
+ * bytes */
+struct bench_spi_stats {
+	uint64_t	nb_calls;
+	uint64_t	nb_xfers;
+	uint64_t	nb_bytes;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Monotonic time in nanoseconds */
+uint64_t bench_now_ns(void);
+/* Print the result of a measurement */
+void bench_report(const char *name, uint64_t ns, uint32_t iterations,
+		  uint64_t bytes, struct sim_axi_region *region,
+		  uint64_t reads, uint64_t writes);
+/* Check bytes which are a counter, *next being the expected first byte */
+int32_t bench_check_counter(uint8_t *data, uint32_t len, uint8_t *next);
+/* Simulated SPI platform counting its calls in stats */
+struct spi_platform_ops *bench_spi_counting_ops(struct bench_spi_stats *stats);
+/* Print the SPI traffic since start and its latency on hardware */
+void bench_spi_report(const char *name, uint64_t ns, uint32_t iterations,
+		      const struct bench_spi_stats *stats,
+		      const struct bench_spi_stats *start, uint32_t call_ns,
+		      uint32_t clk_hz);
+
+/* Test areas, see readme.txt */
+int32_t bench_dmac(void);
+int32_t bench_spi_engine(void);
+int32_t bench_util(void);
+int32_t bench_wifi(void);
+int32_t bench_iio(void);
+int32_t bench_sd(void);
+int32_t bench_xcvr(void);
+int32_t bench_ad9361(void);
+int32_t bench_talise(void);
+int32_t bench_ad9081(void);
+int32_t bench_uio(void);
+
+#endif // __BENCH_H__
@@ -0,0 +1,419 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_ad9081.c
+ *   @brief  AD9081 API against a model of its register map.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "delay.h"
+#include "adi_ad9081_hal.h"
+#include "sim_spi.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* AD9081 register, keyed by the value of the page registers */
+struct bench_ad9081_reg {
+	uint8_t		page[AD9081_HAL_PAGE_REGS];
+	uint16_t	addr;
+	uint8_t		value;
+	bool		used;
+};
+
+/* AD9081 register map, see bench_ad9081_xfer() */
+struct bench_ad9081_model {
+	/* Page registers and SPI enables of the DAC and ADC cores */
+	uint8_t			page[AD9081_HAL_PAGE_REGS];
+	/* SPI configuration, register 0 */
+	uint8_t			spi_config;
+	/* Hash table of the other registers */
+	struct bench_ad9081_reg	*regs;
+	uint32_t		nb_regs;
+	struct bench_spi_stats	spi;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static struct bench_ad9081_model bench_ad9081_model;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Index of the AD9081 page registers, -1 for the other registers */
+static int32_t bench_ad9081_page(uint16_t addr)
+{
+	if (addr >= REG_ADC_COARSE_PAGE_ADDR &&
+	    addr <= REG_PFILT_COEFF_PAGE_ADDR)
+		return addr - REG_ADC_COARSE_PAGE_ADDR;
+	if (addr == REG_SPI_ENABLE_DAC_ADDR || addr == REG_SPI_ENABLE_ADC_ADDR)
+		return 8 + addr - REG_SPI_ENABLE_DAC_ADDR;
+
+	return -1;
+}
+
+/* Register of the map, with the current page selection */
+static struct bench_ad9081_reg *bench_ad9081_reg(
+	struct bench_ad9081_model *model, uint16_t addr, const uint8_t *page)
+{
+	struct bench_ad9081_reg *reg;
+	uint32_t hash, i;
+
+	hash = addr * 2654435761u;
+	for (i = 0; i < AD9081_HAL_PAGE_REGS; i++)
+		hash = (hash ^ page[i]) * 16777619u;
+
+	for (i = 0; i < BENCH_AD9081_MAP_SIZE; i++) {
+		reg = &model->regs[(hash + i) & (BENCH_AD9081_MAP_SIZE - 1)];
+		if (!reg->used) {
+			reg->used = true;
+			reg->addr = addr;
+			memcpy(reg->page, page, AD9081_HAL_PAGE_REGS);
+			model->nb_regs++;
+			return reg;
+		}
+		if (reg->addr == addr &&
+		    !memcmp(reg->page, page, AD9081_HAL_PAGE_REGS))
+			return reg;
+	}
+
+	return NULL;
+}
+
+/*
+ * AD9081 device model: a register map in which every register other than
+ * the page registers is paged, the page registers selecting the DAC, channel,
+ * DDC or link that it belongs to. Streaming transactions decrement the
+ * address, as after a reset, unless register 0 selects the address ascension.
+ */
+static int32_t bench_ad9081_xfer(void *ctx, uint8_t *data,
+				 uint32_t bytes_number)
+{
+	struct bench_ad9081_model *model = ctx;
+	struct bench_ad9081_reg *reg;
+	uint16_t addr;
+	int32_t page;
+	int32_t step;
+	uint32_t i;
+	bool read;
+
+	if (bytes_number < 3)
+		return -EINVAL;
+
+	read = data[0] & 0x80;
+	addr = ((data[0] & 0x3F) << 8) | data[1];
+	step = (model->spi_config & 0x24) == 0x24 ? 1 : -1;
+
+	model->spi.nb_xfers++;
+	model->spi.nb_bytes += bytes_number;
+
+	data[0] = 0;
+	data[1] = 0;
+	for (i = 2; i < bytes_number; i++, addr += step) {
+		if (addr == REG_SPI_INTFCONFA_ADDR) {
+			if (!read)
+				model->spi_config = data[i] & ~0x81;
+			data[i] = model->spi_config;
+			continue;
+		}
+		page = bench_ad9081_page(addr);
+		if (page >= 0) {
+			if (!read)
+				model->page[page] = data[i];
+			data[i] = model->page[page];
+			continue;
+		}
+		reg = bench_ad9081_reg(model, addr, model->page);
+		if (!reg)
+			return -ENOMEM;
+		if (!read)
+			reg->value = data[i];
+		data[i] = reg->value;
+	}
+
+	return SUCCESS;
+}
+
+/* SPI access of the API, as implemented by drivers/adc/ad9081/ad9081.c */
+static int32_t bench_ad9081_spi_xfer(void *user_data, uint8_t *in_data,
+				     uint8_t *out_data, uint32_t size_bytes)
+{
+	uint8_t data[AD9081_HAL_STREAM_MAX + 2];
+	uint16_t bytes_number = size_bytes & 0xFF;
+
+	if (bytes_number > sizeof(data))
+		return FAILURE;
+
+	memcpy(data, in_data, bytes_number);
+	if (spi_write_and_read(user_data, data, bytes_number) != SUCCESS)
+		return FAILURE;
+	if (out_data)
+		memcpy(out_data, data, bytes_number);
+
+	return SUCCESS;
+}
+
+static int32_t bench_ad9081_delay_us(void *user_data, uint32_t us)
+{
+	udelay(us);
+
+	return SUCCESS;
+}
+
+/* Print the SPI traffic of an AD9081 operation and its estimated latency */
+static void bench_ad9081_report(const char *name, uint64_t ns,
+				uint32_t iterations,
+				const struct bench_spi_stats *start)
+{
+	bench_spi_report(name, ns, iterations, &bench_ad9081_model.spi, start,
+			 BENCH_AD9081_CALL_NS, BENCH_AD9081_CLK_HZ);
+}
+
+/* NCO retunes and JESD204 RX link configurations, with the HAL transactions
+ * enabled or accessing the registers one by one */
+static int32_t bench_ad9081_run(const char *name, struct spi_desc *spi,
+				bool txn)
+{
+	struct bench_ad9081_model *model = &bench_ad9081_model;
+	adi_cms_jesd_param_t jesd_param = {
+		.jesd_l = 4, .jesd_f = 4, .jesd_m = 8, .jesd_s = 1,
+		.jesd_k = 32, .jesd_n = 16, .jesd_np = 16, .jesd_subclass = 1,
+		.jesd_scr = 1, .jesd_jesdv = 1, .jesd_mode_id = 9
+	};
+	static const char * const call_names[AD9081_HAL_CALL_NUM] = {
+		"reg_get", "reg_set", "bf_get", "bf_set", "multi_bf_get",
+		"multi_bf_set", "txn flush"
+	};
+	struct bench_spi_stats start_spi;
+	adi_ad9081_hal_stats_t stats;
+	adi_ad9081_device_t *dev;
+	int64_t shift;
+	uint64_t start;
+	char label[32];
+	uint32_t i;
+	int32_t ret;
+
+	dev = calloc(1, sizeof(*dev));
+	if (!dev)
+		return -ENOMEM;
+	dev->hal_info.user_data = spi;
+	dev->hal_info.msb = SPI_MSB_FIRST;
+	dev->hal_info.addr_inc = SPI_ADDR_INC_AUTO;
+	dev->hal_info.spi_xfer = bench_ad9081_spi_xfer;
+	dev->hal_info.delay_us = bench_ad9081_delay_us;
+	dev->dev_info.dac_freq_hz = BENCH_AD9081_DAC_HZ;
+	dev->dev_info.adc_freq_hz = BENCH_AD9081_ADC_HZ;
+	ret = adi_ad9081_hal_txn_enable_set(dev, txn);
+	if (ret != API_CMS_ERROR_OK)
+		goto out;
+
+	/* After a reset the device decrements the streaming addresses: the
+	 * HAL must access the registers one by one until the SPI is set up */
+	ret = adi_ad9081_device_reset(dev, AD9081_SOFT_RESET);
+	if (ret != API_CMS_ERROR_OK)
+		goto out;
+	ret = adi_ad9081_dac_duc_nco_set(dev, AD9081_DAC_ALL,
+					 AD9081_DAC_CH_ALL,
+					 BENCH_AD9081_NCO_HZ);
+	if (ret != API_CMS_ERROR_OK)
+		goto out;
+	ret = adi_ad9081_device_spi_config(dev);
+	if (ret != API_CMS_ERROR_OK)
+		goto out;
+	adi_ad9081_hal_stats_reset(dev);
+
+	snprintf(label, sizeof(label), "ad9081 dac nco %s", name);
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9081_RETUNES; i++) {
+		shift = BENCH_AD9081_NCO_HZ + i * BENCH_AD9081_NCO_STEP_HZ;
+		ret = adi_ad9081_dac_duc_nco_set(dev, AD9081_DAC_ALL,
+						 AD9081_DAC_CH_ALL, shift);
+		if (ret != API_CMS_ERROR_OK)
+			goto out;
+	}
+	bench_ad9081_report(label, bench_now_ns() - start,
+			    BENCH_AD9081_RETUNES, &start_spi);
+
+	snprintf(label, sizeof(label), "ad9081 coarse nco %s", name);
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9081_RETUNES; i++) {
+		shift = BENCH_AD9081_NCO_HZ + i * BENCH_AD9081_NCO_STEP_HZ;
+		ret = adi_ad9081_adc_ddc_coarse_nco_set(dev,
+							AD9081_ADC_CDDC_ALL,
+							shift);
+		if (ret != API_CMS_ERROR_OK)
+			goto out;
+	}
+	bench_ad9081_report(label, bench_now_ns() - start,
+			    BENCH_AD9081_RETUNES, &start_spi);
+
+	snprintf(label, sizeof(label), "ad9081 fine nco %s", name);
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9081_RETUNES; i++) {
+		shift = BENCH_AD9081_NCO_STEP_HZ * i;
+		ret = adi_ad9081_adc_ddc_fine_nco_set(dev, AD9081_ADC_FDDC_ALL,
+						      shift);
+		if (ret != API_CMS_ERROR_OK)
+			goto out;
+	}
+	bench_ad9081_report(label, bench_now_ns() - start,
+			    BENCH_AD9081_RETUNES, &start_spi);
+
+	snprintf(label, sizeof(label), "ad9081 jrx link %s", name);
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9081_LINK_CONFIGS; i++) {
+		jesd_param.jesd_jesdv = (i & 1) ? 2 : 1;
+		ret = adi_ad9081_jesd_rx_link_config_set(dev, AD9081_LINK_ALL,
+							 &jesd_param);
+		if (ret != API_CMS_ERROR_OK)
+			goto out;
+	}
+	bench_ad9081_report(label, bench_now_ns() - start,
+			    BENCH_AD9081_LINK_CONFIGS, &start_spi);
+
+	/* SPI traffic of each HAL entry point, over all the operations */
+	adi_ad9081_hal_stats_get(dev, &stats);
+	for (i = 0; i < AD9081_HAL_CALL_NUM; i++) {
+		if (!stats.call[i].calls)
+			continue;
+		snprintf(label, sizeof(label), "  %s", call_names[i]);
+		printf("%-24s %10"PRIu32" calls %8"PRIu32" CS %10"PRIu32
+		       " bytes\n", label, stats.call[i].calls,
+		       stats.call[i].xfers, stats.call[i].bytes);
+	}
+	if (stats.shadow_hits)
+		printf("%-24s %10"PRIu32" reads elided\n", "  shadow",
+		       stats.shadow_hits);
+out:
+	free(dev);
+
+	return ret;
+}
+
+/* The register map left by the operations is the same with transactions */
+static int32_t bench_ad9081_compare(struct bench_ad9081_reg *legacy,
+				    uint32_t nb_legacy)
+{
+	struct bench_ad9081_model *model = &bench_ad9081_model;
+	struct bench_ad9081_reg *reg;
+	uint32_t i;
+
+	if (model->nb_regs != nb_legacy)
+		return FAILURE;
+	for (i = 0; i < BENCH_AD9081_MAP_SIZE; i++) {
+		if (!legacy[i].used)
+			continue;
+		reg = bench_ad9081_reg(model, legacy[i].addr, legacy[i].page);
+		if (!reg || reg->value != legacy[i].value)
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/* AD9081 NCO retunes and JESD204 link configurations, accessing the
+ * registers one by one and through the HAL transactions */
+int32_t bench_ad9081(void)
+{
+	struct bench_ad9081_model *model = &bench_ad9081_model;
+	struct sim_spi_init_param sim_param = {
+		.xfer = bench_ad9081_xfer,
+		.ctx = model
+	};
+	struct spi_init_param spi_param = {
+		.max_speed_hz = BENCH_AD9081_CLK_HZ,
+		.mode = SPI_MODE_0,
+		.platform_ops = bench_spi_counting_ops(&model->spi),
+		.extra = &sim_param
+	};
+	size_t size = BENCH_AD9081_MAP_SIZE * sizeof(struct bench_ad9081_reg);
+	struct bench_ad9081_reg *legacy;
+	struct spi_desc *spi;
+	uint32_t nb_legacy;
+	int32_t ret;
+
+	model->regs = calloc(1, size);
+	legacy = malloc(size);
+	ret = -ENOMEM;
+	if (!model->regs || !legacy)
+		goto out;
+
+	ret = spi_init(&spi, &spi_param);
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_ad9081_run("legacy", spi, false);
+	if (ret != SUCCESS)
+		goto out_spi;
+	memcpy(legacy, model->regs, size);
+	nb_legacy = model->nb_regs;
+
+	memset(model->regs, 0, size);
+	memset(model->page, 0, sizeof(model->page));
+	model->spi_config = 0;
+	model->nb_regs = 0;
+	ret = bench_ad9081_run("txn", spi, true);
+	if (ret != SUCCESS)
+		goto out_spi;
+
+	ret = bench_ad9081_compare(legacy, nb_legacy);
+	if (ret != SUCCESS)
+		printf("ad9081: register map differs with transactions\n");
+out_spi:
+	spi_remove(spi);
+out:
+	free(legacy);
+	free(model->regs);
+	model->regs = NULL;
+
+	return ret;
+}
@@ -0,0 +1,247 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_ad9361.c
+ *   @brief  AD9361 driver against a model of its register map.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include "error.h"
+#include "ad9361.h"
+#include "ad9361_api.h"
+#include "ad9361_init_param.h"
+#include "sim_spi.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* AD9361 register map, see bench_ad9361_xfer() */
+struct bench_ad9361_model {
+	uint8_t			regs[AD9361_NUM_REGS];
+	struct bench_spi_stats	spi;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static struct bench_ad9361_model bench_ad9361_model;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/*
+ * AD9361 device model: the register map of sim_spi_regmap_xfer() with the
+ * AD9361 instruction format, self clearing calibrations, ENSM states
+ * following the forced states and locked synthesizers.
+ */
+static int32_t bench_ad9361_xfer(void *ctx, uint8_t *data,
+				 uint32_t bytes_number)
+{
+	struct bench_ad9361_model *model = ctx;
+	uint32_t addr, reg, i;
+	bool write;
+
+	if (bytes_number < 2)
+		return -EINVAL;
+
+	write = data[0] & 0x80;
+	addr = ((data[0] << 8) | data[1]) & 0x3FF;
+
+	model->spi.nb_xfers++;
+	model->spi.nb_bytes += bytes_number;
+
+	data[0] = 0;
+	data[1] = 0;
+	for (i = 2; i < bytes_number; i++) {
+		reg = (addr - (i - 2)) & 0x3FF;
+		if (!write) {
+			data[i] = model->regs[reg];
+			continue;
+		}
+		switch (reg) {
+		case REG_PRODUCT_ID:
+		case REG_RX_CAL_STATUS:
+		case REG_TX_CAL_STATUS:
+		case REG_RX_CP_OVERRANGE_VCO_LOCK:
+		case REG_TX_CP_OVERRANGE_VCO_LOCK:
+		case REG_CH_1_OVERFLOW:
+			/* Read only */
+			break;
+		case REG_CALIBRATION_CTRL:
+			/* The calibrations complete immediately */
+			model->regs[reg] = 0;
+			break;
+		case REG_ENSM_CONFIG_1:
+			model->regs[reg] = data[i];
+			if (data[i] & (FORCE_ALERT_STATE | TO_ALERT))
+				model->regs[REG_STATE] = ENSM_STATE_ALERT;
+			if ((data[i] & FORCE_RX_ON) && (data[i] & FORCE_TX_ON))
+				model->regs[REG_STATE] = ENSM_STATE_FDD;
+			else if (data[i] & FORCE_RX_ON)
+				model->regs[REG_STATE] = ENSM_STATE_RX;
+			else if (data[i] & FORCE_TX_ON)
+				model->regs[REG_STATE] = ENSM_STATE_TX;
+			break;
+		default:
+			model->regs[reg] = data[i];
+			break;
+		}
+	}
+
+	return SUCCESS;
+}
+
+/* Print the SPI traffic of an AD9361 operation and its estimated latency */
+static void bench_ad9361_report(const char *name, uint64_t ns,
+				uint32_t iterations,
+				const struct bench_spi_stats *start)
+{
+	bench_spi_report(name, ns, iterations, &bench_ad9361_model.spi, start,
+			 BENCH_SPI_CALL_NS, BENCH_SPI_CLK_HZ);
+}
+
+/* AD9361 initialization, RX LO band switches and hops */
+int32_t bench_ad9361(void)
+{
+	struct bench_ad9361_model *model = &bench_ad9361_model;
+	struct sim_spi_init_param sim_param = {
+		.xfer = bench_ad9361_xfer,
+		.ctx = model
+	};
+	struct bench_spi_stats start_spi;
+	struct ad9361_hop_plan_info info;
+	uint64_t freqs[BENCH_AD9361_HOPS];
+	struct ad9361_rf_phy *phy;
+	uint64_t start, lo;
+	uint32_t i;
+	int32_t ret;
+
+	bench_ad9361_init_param.spi_param.platform_ops =
+		bench_spi_counting_ops(&model->spi);
+	bench_ad9361_init_param.spi_param.extra = &sim_param;
+
+	/* Values the initialization depends on */
+	model->regs[REG_PRODUCT_ID] = PRODUCT_ID_9361 | 0x2;
+	model->regs[REG_RX_CAL_STATUS] = 0xFF;
+	model->regs[REG_TX_CAL_STATUS] = 0xFF;
+	model->regs[REG_RX_CP_OVERRANGE_VCO_LOCK] = 0xFF;
+	model->regs[REG_TX_CP_OVERRANGE_VCO_LOCK] = 0xFF;
+	model->regs[REG_CH_1_OVERFLOW] = 0xFF;
+	model->regs[REG_RX_BBF_C3_MSB] = 0x10;
+	model->regs[REG_RX_BBF_C3_LSB] = 0x20;
+	model->regs[REG_RX_BBF_R2346] = 0x08;
+
+	start_spi = model->spi;
+	start = bench_now_ns();
+	ret = ad9361_init(&phy, &bench_ad9361_init_param);
+	if (ret != SUCCESS)
+		return ret;
+	bench_ad9361_report("ad9361_init", bench_now_ns() - start, 1,
+			    &start_spi);
+
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9361_SWITCHES; i++) {
+		lo = (i & 1) ? BENCH_AD9361_LO_LOW_HZ : BENCH_AD9361_LO_HIGH_HZ;
+		ret = ad9361_set_rx_lo_freq(phy, lo);
+		if (ret != SUCCESS)
+			break;
+	}
+	bench_ad9361_report("ad9361 band switch", bench_now_ns() - start,
+			    BENCH_AD9361_SWITCHES, &start_spi);
+
+	/* RX LO hops within a band */
+	for (i = 0; i < BENCH_AD9361_HOPS; i++)
+		freqs[i] = BENCH_AD9361_HOP_BASE_HZ + i * BENCH_AD9361_HOP_STEP_HZ;
+
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9361_SWITCHES; i++) {
+		ret = ad9361_set_rx_lo_freq(phy, freqs[i % BENCH_AD9361_HOPS]);
+		if (ret != SUCCESS)
+			break;
+	}
+	bench_ad9361_report("ad9361 set_rx_lo_freq", bench_now_ns() - start,
+			    BENCH_AD9361_SWITCHES, &start_spi);
+
+	start_spi = model->spi;
+	start = bench_now_ns();
+	ret = ad9361_set_rx_hop_plan(phy, freqs, BENCH_AD9361_HOPS, 1);
+	if (ret != SUCCESS)
+		goto out;
+	bench_ad9361_report("ad9361 hop plan", bench_now_ns() - start, 1,
+			    &start_spi);
+
+	ad9361_get_rx_hop_plan_info(phy, &info);
+	printf("hop plan: %"PRIu32" frequencies, %"PRIu32"/%"PRIu32
+	       " in fastlock profiles, images of %"PRIu32" commands %"PRIu32
+	       " bytes\n", info.nb_freqs, info.nb_fastlock, info.max_fastlock,
+	       info.image_cmds, info.image_bytes);
+
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9361_SWITCHES; i++) {
+		ret = ad9361_rx_hop(phy, i % info.nb_fastlock);
+		if (ret != SUCCESS)
+			break;
+	}
+	bench_ad9361_report("ad9361 fastlock hop", bench_now_ns() - start,
+			    BENCH_AD9361_SWITCHES, &start_spi);
+
+	start_spi = model->spi;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_AD9361_SWITCHES; i++) {
+		ret = ad9361_rx_hop(phy, info.nb_fastlock +
+				    i % (info.nb_freqs - info.nb_fastlock));
+		if (ret != SUCCESS)
+			break;
+	}
+	bench_ad9361_report("ad9361 image hop", bench_now_ns() - start,
+			    BENCH_AD9361_SWITCHES, &start_spi);
+
+out:
+
+	ad9361_remove(phy);
+
+	return ret;
+}
@@ -0,0 +1,891 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_dmac.c
+ *   @brief  AXI ADC, DMAC and SPI Engine drivers against models of the cores.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "axi_adc_core.h"
+#include "axi_dmac.h"
+#include "iio_axi_adc.h"
+#include "spi_engine.h"
+#include "sim_axi_io.h"
+#include "sim_axi_models.h"
+#include "sim_delay.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* Descriptors and bytes per descriptor of the interrupt test */
+#define BENCH_DMAC_IRQ_DESCS		(2 * AXI_DMAC_MAX_ACTIVE)
+#define BENCH_DMAC_IRQ_BYTES		4096
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* SPI Engine registers and the program of its offload memory */
+struct bench_offload_model {
+	struct sim_axi_region region;
+	uint32_t regs[0x200 / 4];
+	uint32_t cmds[SPI_ENGINE_OFFLOAD_CMD_MAX];
+	uint32_t nb_cmds;
+	/* Number of offload memory resets */
+	uint64_t nb_loads;
+};
+
+/* ADC sampling at BENCH_STREAM_ODR_HZ behind the SPI Engine offload, see
+ * bench_stream_step() */
+struct bench_stream {
+	struct bench_offload_model *engine;
+	struct sim_axi_dmac *dmac;
+	uint64_t start_us;
+	/* Index of the next conversion, the value of its sample */
+	uint32_t next;
+	/* Value of the next sample written by the DMA */
+	uint16_t value;
+	/* Samples received by the application */
+	uint64_t delivered;
+};
+
+/* Paced DMAC model whose transfers complete while the driver reads
+ * TRANSFER_DONE, see bench_dmac_irq_read() */
+struct bench_dmac_irq {
+	struct sim_axi_dmac *model;
+	const struct sim_axi_region_ops *ops;
+	/* Complete the active transfers on the next TRANSFER_DONE read */
+	bool armed;
+	/* Completion callbacks run */
+	uint32_t completed;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static struct bench_dmac_irq bench_dmac_irq_ctx;
+static struct sim_axi_region_ops bench_dmac_irq_ops;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Check the ramp generated by the ADC model */
+static int32_t bench_check_ramp(uint16_t *buff, uint32_t nb)
+{
+	uint32_t i;
+
+	for (i = 1; i < nb; i++)
+		if ((uint16_t)(buff[i - 1] + 1) != buff[i]) {
+			printf("Data mismatch at sample %"PRIu32"\n", i);
+			return FAILURE;
+		}
+
+	return SUCCESS;
+}
+
+/* iio_axi_adc_read_dev() through the blocking axi_dmac_transfer() */
+static int32_t bench_iio_read(struct iio_device *iio_dev, void *adc_dev,
+			      struct sim_axi_dmac *sim_dmac, uint16_t *buff,
+			      uint32_t bytes)
+{
+	uint64_t start, reads, writes;
+	uint32_t i;
+	int32_t ret;
+
+	ret = iio_dev->prepare_transfer(adc_dev, (1 << RX_NB_CHANNELS) - 1);
+	if (ret != SUCCESS)
+		return ret;
+
+	reads = sim_dmac->region.nb_reads;
+	writes = sim_dmac->region.nb_writes;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		ret = iio_dev->read_dev(adc_dev, buff, BENCH_NB_SAMPLES);
+		if (ret != SUCCESS)
+			return ret;
+	}
+	bench_report("iio_axi_adc_read_dev", bench_now_ns() - start,
+		     BENCH_ITERATIONS, (uint64_t)bytes * BENCH_ITERATIONS,
+		     &sim_dmac->region, reads, writes);
+
+	return bench_check_ramp(buff, bytes / 2);
+}
+
+/* Back to back transfers through the descriptor queue */
+static int32_t bench_dmac_queue(struct axi_dmac *dmac,
+				struct sim_axi_dmac *sim_dmac, uint16_t *buff,
+				uint32_t bytes)
+{
+	struct axi_dmac_desc descs[BENCH_NB_DESCS];
+	uint32_t desc_bytes = bytes / BENCH_NB_DESCS;
+	uint64_t start, reads, writes;
+	uint32_t i, j;
+	int32_t ret;
+
+	memset(descs, 0, sizeof(descs));
+	for (j = 0; j < BENCH_NB_DESCS; j++) {
+		descs[j].address = (uint32_t)(uintptr_t)buff + j * desc_bytes;
+		descs[j].x_len = desc_bytes;
+	}
+
+	reads = sim_dmac->region.nb_reads;
+	writes = sim_dmac->region.nb_writes;
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		for (j = 0; j < BENCH_NB_DESCS; j++) {
+			ret = axi_dmac_submit(dmac, &descs[j]);
+			if (ret != SUCCESS)
+				return ret;
+		}
+		for (j = 0; j < BENCH_NB_DESCS; j++) {
+			ret = axi_dmac_wait(dmac, &descs[j], 1000);
+			if (ret != SUCCESS)
+				return ret;
+		}
+	}
+	bench_report("axi_dmac_submit", bench_now_ns() - start,
+		     BENCH_ITERATIONS, (uint64_t)bytes * BENCH_ITERATIONS,
+		     &sim_dmac->region, reads, writes);
+
+	return bench_check_ramp(buff, bytes / 2);
+}
+
+/* ADC and DMAC cores: reads through iio_axi_adc, then the descriptor queue */
+static int32_t bench_dmac_adc(void)
+{
+	struct sim_axi_conv_init sim_adc_init = {
+		.base = RX_CORE_BASEADDR,
+		.clock_hz = RX_CLOCK_HZ
+	};
+	struct sim_axi_dmac_init sim_dmac_init = {
+		.base = RX_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM
+	};
+	struct axi_adc_init adc_init = {
+		.name = "sim-adc",
+		.base = RX_CORE_BASEADDR,
+		.num_channels = RX_NB_CHANNELS
+	};
+	struct axi_dmac_init dmac_init = {
+		.name = "sim-dmac",
+		.base = RX_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM
+	};
+	struct iio_axi_adc_init_param iio_adc_init;
+	struct iio_axi_adc_desc *iio_adc;
+	struct iio_device *iio_dev;
+	struct sim_axi_conv *sim_adc;
+	struct sim_axi_dmac *sim_dmac;
+	struct axi_adc *adc;
+	struct axi_dmac *dmac;
+	uint16_t *buff;
+	uint32_t bytes;
+	uint64_t start;
+	int32_t ret;
+
+	bytes = BENCH_NB_SAMPLES * RX_NB_CHANNELS * sizeof(uint16_t);
+	buff = sim_dma_alloc(bytes);
+	if (!buff)
+		return -ENOMEM;
+
+	ret = sim_axi_conv_init(&sim_adc, &sim_adc_init);
+	if (ret != SUCCESS)
+		goto out;
+
+	sim_dmac_init.conv = sim_adc;
+	sim_dmac_init.isr = axi_dmac_default_isr;
+	ret = sim_axi_dmac_init(&sim_dmac, &sim_dmac_init);
+	if (ret != SUCCESS)
+		goto out_conv;
+
+	start = bench_now_ns();
+	ret = axi_adc_init(&adc, &adc_init);
+	if (ret != SUCCESS)
+		goto out_sim_dmac;
+	bench_report("axi_adc_init", bench_now_ns() - start, 1, 0,
+		     &sim_adc->region, 0, 0);
+
+	ret = axi_dmac_init(&dmac, &dmac_init);
+	if (ret != SUCCESS)
+		goto out_adc;
+	sim_dmac->isr_instance = dmac;
+
+	iio_adc_init = (struct iio_axi_adc_init_param) {
+		.rx_adc = adc,
+		.rx_dmac = dmac
+	};
+	ret = iio_axi_adc_init(&iio_adc, &iio_adc_init);
+	if (ret != SUCCESS)
+		goto out_dmac;
+	iio_axi_adc_get_dev_descriptor(iio_adc, &iio_dev);
+
+	ret = bench_iio_read(iio_dev, iio_adc, sim_dmac, buff, bytes);
+	if (ret == SUCCESS)
+		ret = bench_dmac_queue(dmac, sim_dmac, buff, bytes);
+
+	iio_axi_adc_remove(iio_adc);
+out_dmac:
+	axi_dmac_remove(dmac);
+out_adc:
+	axi_adc_remove(adc);
+out_sim_dmac:
+	sim_axi_dmac_remove(sim_dmac);
+out_conv:
+	sim_axi_conv_remove(sim_adc);
+out:
+	sim_dma_free(buff, bytes);
+
+	return ret;
+}
+
+/* DMAC model read: the end of transfer interrupt fires in the middle of the
+ * driver queue processing, just after the completed transfers were read */
+static int32_t bench_dmac_irq_read(struct sim_axi_region *region,
+				   uint32_t offset, uint32_t *data)
+{
+	struct bench_dmac_irq *bench = &bench_dmac_irq_ctx;
+	int32_t ret;
+
+	ret = bench->ops->read(region, offset, data);
+	if (offset == AXI_DMAC_REG_TRANSFER_DONE && bench->armed) {
+		bench->armed = false;
+		sim_axi_dmac_advance(bench->model, bench->model->nb_queued *
+				     (uint64_t)BENCH_DMAC_IRQ_BYTES);
+	}
+
+	return ret;
+}
+
+static void bench_dmac_irq_complete(struct axi_dmac_desc *desc, void *ctx)
+{
+	struct bench_dmac_irq *bench = ctx;
+
+	bench->completed++;
+}
+
+/*
+ * Queue more descriptors than the hardware takes, the interrupt completing
+ * all the active transfers during the last axi_dmac_submit(). The application
+ * does not poll afterwards: the ISR must refill the hardware queue until all
+ * the descriptors complete.
+ */
+static int32_t bench_dmac_irq(void)
+{
+	struct bench_dmac_irq *bench = &bench_dmac_irq_ctx;
+	struct sim_axi_dmac_init sim_dmac_init = {
+		.base = RX_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM,
+		.isr = axi_dmac_default_isr,
+		.paced = true
+	};
+	struct axi_dmac_init dmac_init = {
+		.name = "sim-dmac",
+		.base = RX_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM
+	};
+	struct axi_dmac_desc descs[BENCH_DMAC_IRQ_DESCS] = { 0 };
+	struct axi_dmac *dmac;
+	uint32_t i;
+	int32_t ret;
+
+	memset(bench, 0, sizeof(*bench));
+	ret = sim_axi_dmac_init(&bench->model, &sim_dmac_init);
+	if (ret != SUCCESS)
+		return ret;
+	bench->ops = bench->model->region.ops;
+	bench_dmac_irq_ops = *bench->ops;
+	bench_dmac_irq_ops.read = bench_dmac_irq_read;
+	bench->model->region.ops = &bench_dmac_irq_ops;
+
+	ret = axi_dmac_init(&dmac, &dmac_init);
+	if (ret != SUCCESS)
+		goto out_model;
+	bench->model->isr_instance = dmac;
+
+	for (i = 0; i < BENCH_DMAC_IRQ_DESCS; i++) {
+		/* The model does not move data without a converter */
+		descs[i].address = i * BENCH_DMAC_IRQ_BYTES;
+		descs[i].x_len = BENCH_DMAC_IRQ_BYTES;
+		descs[i].complete = bench_dmac_irq_complete;
+		descs[i].ctx = bench;
+		bench->armed = (i == BENCH_DMAC_IRQ_DESCS - 1);
+		ret = axi_dmac_submit(dmac, &descs[i]);
+		if (ret != SUCCESS)
+			goto out_dmac;
+	}
+
+	while (sim_axi_dmac_advance(bench->model, BENCH_DMAC_IRQ_BYTES))
+		;
+
+	printf("axi_dmac irq in submit   %"PRIu32"/%u transfers completed\n",
+	       bench->completed, BENCH_DMAC_IRQ_DESCS);
+	if (bench->completed != BENCH_DMAC_IRQ_DESCS)
+		ret = FAILURE;
+
+	axi_dmac_flush(dmac);
+out_dmac:
+	axi_dmac_remove(dmac);
+out_model:
+	sim_axi_dmac_remove(bench->model);
+
+	return ret;
+}
+
+/* AXI DMAC driver: throughput, then completions reported by the interrupt */
+int32_t bench_dmac(void)
+{
+	int32_t ret;
+
+	ret = bench_dmac_adc();
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_dmac_irq();
+}
+
+/* SPI Engine model: keeps the program written in the offload memory */
+static int32_t bench_offload_write(struct sim_axi_region *region,
+				   uint32_t offset, uint32_t data)
+{
+	struct bench_offload_model *model = region->ctx;
+
+	region->regs[offset / 4] = data;
+
+	if (offset == SPI_ENGINE_REG_OFFLOAD_RESET(0) && data) {
+		model->nb_cmds = 0;
+		model->nb_loads++;
+	} else if (offset == SPI_ENGINE_REG_OFFLOAD_CMD_MEM(0) &&
+		   model->nb_cmds < SPI_ENGINE_OFFLOAD_CMD_MAX) {
+		model->cmds[model->nb_cmds++] = data;
+	}
+
+	return SUCCESS;
+}
+
+/* Print the engine and DMAC accesses, program loads and delays of captures */
+static void bench_offload_report(const char *name, uint64_t ns,
+				 struct bench_offload_model *model,
+				 const struct bench_offload_model *start,
+				 struct sim_axi_dmac *sim_dmac,
+				 uint64_t dma_writes, uint64_t start_us)
+{
+	bench_report(name, ns, BENCH_OFFLOAD_CAPTURES, 0, &model->region,
+		     start->region.nb_reads, start->region.nb_writes);
+	printf("%-24s %6.1f DMA wr %6.3f loads %8.1f us delay /call\n", "",
+	       (double)(sim_dmac->region.nb_writes - dma_writes) /
+	       BENCH_OFFLOAD_CAPTURES,
+	       (double)(model->nb_loads - start->nb_loads) /
+	       BENCH_OFFLOAD_CAPTURES,
+	       (double)(sim_get_time_us() - start_us) /
+	       BENCH_OFFLOAD_CAPTURES);
+}
+
+/*
+ * SPI Engine offload captures with the ad738x_read_data() program, set up
+ * before each capture as the drivers used to or kept in a session.
+ */
+static int32_t bench_spi_engine_offload(void)
+{
+	static const struct sim_axi_region_ops ops = {
+		.write = bench_offload_write
+	};
+	struct spi_engine_init_param engine_init = {
+		.ref_clk_hz = BENCH_OFFLOAD_REF_CLK_HZ,
+		.type = SPI_ENGINE,
+		.spi_engine_baseaddr = SPI_ENGINE_BASEADDR,
+		.cs_delay = 0,
+		.data_width = 16
+	};
+	struct spi_init_param spi_init_param = {
+		.max_speed_hz = BENCH_OFFLOAD_SPI_HZ,
+		.chip_select = SPI_CS,
+		.mode = SPI_MODE_0,
+		.platform_ops = &spi_eng_platform_ops,
+		.extra = &engine_init
+	};
+	struct sim_axi_dmac_init sim_dmac_init = {
+		.base = SPI_ENGINE_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM
+	};
+	struct spi_engine_offload_init_param offload_init = {
+		.rx_dma_baseaddr = SPI_ENGINE_DMA_BASEADDR,
+		.offload_config = OFFLOAD_RX_EN
+	};
+	uint32_t commands[] = {CS_LOW, WRITE_READ(2), CS_HIGH};
+	uint32_t commands_data[2] = {0, 0};
+	struct spi_engine_offload_message msg;
+	struct bench_offload_model *model, start_model;
+	struct spi_engine_session *session;
+	struct sim_axi_dmac *sim_dmac;
+	uint32_t legacy[SPI_ENGINE_OFFLOAD_CMD_MAX];
+	uint32_t nb_legacy, bytes, i;
+	uint64_t start, start_us, dma_writes;
+	struct spi_desc *spi;
+	uint16_t *buff;
+	int32_t ret;
+
+	bytes = BENCH_OFFLOAD_SAMPLES * sizeof(*buff);
+	buff = sim_dma_alloc(bytes);
+	if (!buff)
+		return FAILURE;
+
+	model = calloc(1, sizeof(*model));
+	if (!model) {
+		ret = FAILURE;
+		goto out_buff;
+	}
+
+	model->region.base = SPI_ENGINE_BASEADDR;
+	model->region.size = sizeof(model->regs);
+	model->region.regs = model->regs;
+	model->region.ops = &ops;
+	model->region.ctx = model;
+	model->regs[SPI_ENGINE_REG_DATA_WIDTH / 4] = 32;
+
+	ret = sim_axi_add_region(&model->region);
+	if (ret != SUCCESS)
+		goto out_model;
+
+	ret = sim_axi_dmac_init(&sim_dmac, &sim_dmac_init);
+	if (ret != SUCCESS)
+		goto out_region;
+
+	ret = spi_init(&spi, &spi_init_param);
+	if (ret != SUCCESS)
+		goto out_dmac;
+
+	msg.commands = commands;
+	msg.no_commands = ARRAY_SIZE(commands);
+	msg.commands_data = commands_data;
+	msg.rx_addr = (uint32_t)(uintptr_t)buff;
+	msg.tx_addr = 0;
+
+	start_model = *model;
+	dma_writes = sim_dmac->region.nb_writes;
+	start_us = sim_get_time_us();
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_OFFLOAD_CAPTURES; i++) {
+		ret = spi_engine_offload_init(spi, &offload_init);
+		if (ret != SUCCESS)
+			goto out_spi;
+
+		ret = spi_engine_offload_transfer(spi, msg,
+						  BENCH_OFFLOAD_SAMPLES);
+		if (ret != SUCCESS)
+			goto out_spi;
+	}
+	bench_offload_report("offload init+transfer", bench_now_ns() - start,
+			     model, &start_model, sim_dmac, dma_writes,
+			     start_us);
+
+	memcpy(legacy, model->cmds, sizeof(legacy));
+	nb_legacy = model->nb_cmds;
+
+	ret = spi_engine_session_init(&session, spi, &offload_init);
+	if (ret != SUCCESS)
+		goto out_spi;
+
+	start_model = *model;
+	dma_writes = sim_dmac->region.nb_writes;
+	start_us = sim_get_time_us();
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_OFFLOAD_CAPTURES; i++) {
+		ret = spi_engine_session_transfer(session, &msg,
+						  BENCH_OFFLOAD_SAMPLES);
+		if (ret != SUCCESS)
+			goto out_session;
+	}
+	bench_offload_report("offload session", bench_now_ns() - start,
+			     model, &start_model, sim_dmac, dma_writes,
+			     start_us);
+
+	/* Same program, but for the ID of the final SYNC */
+	if (nb_legacy != model->nb_cmds ||
+	    memcmp(legacy, model->cmds, (nb_legacy - 1) * sizeof(legacy[0])))
+		printf("spi_engine: offload programs differ\n");
+
+out_session:
+	spi_engine_session_remove(session);
+out_spi:
+	spi_remove(spi);
+out_dmac:
+	sim_axi_dmac_remove(sim_dmac);
+out_region:
+	sim_axi_remove_region(&model->region);
+out_model:
+	free(model);
+out_buff:
+	sim_dma_free(buff, bytes);
+
+	return ret;
+}
+
+/* ADC data moved by the offload DMA, each sample holds its conversion index */
+static void bench_stream_data(void *ctx, uint8_t *buff, uint32_t bytes)
+{
+	struct bench_stream *bench = ctx;
+	uint16_t *samples = (uint16_t *)buff;
+	uint32_t i;
+
+	for (i = 0; i < bytes / sizeof(*samples); i++)
+		samples[i] = bench->value++;
+}
+
+/*
+ * Run the conversions that happened since the last delay. Their samples are
+ * written by the DMA while the offload is enabled and the DMA has transfers
+ * queued, the others are lost.
+ */
+static void bench_stream_step(void *ctx)
+{
+	struct bench_stream *bench = ctx;
+	uint32_t due, nb;
+
+	due = (sim_get_time_us() - bench->start_us) * BENCH_STREAM_ODR_HZ /
+	      1000000;
+	nb = due - bench->next;
+	if (bench->engine->regs[SPI_ENGINE_REG_OFFLOAD_CTRL(0) / 4] &
+	    SPI_ENGINE_OFFLOAD_CTRL_ENABLE) {
+		bench->value = bench->next;
+		sim_axi_dmac_advance(bench->dmac, nb * sizeof(uint16_t));
+	}
+	bench->next = due;
+}
+
+/* Print the share of the conversions received by the application and the data
+ * errors */
+static void bench_stream_report(const char *name, uint64_t ns,
+				struct bench_stream *bench, uint32_t overruns,
+				uint32_t errors)
+{
+	printf("%-24s %10.3f ms %6.2f %% received %6"PRIu32" overruns "
+	       "%6"PRIu32" errors\n", name, ns / 1000000.0,
+	       bench->delivered * 100.0 / bench->next, overruns, errors);
+}
+
+/* Check that samples follow each other, as long as no loss was reported */
+static uint32_t bench_stream_check(struct bench_stream *bench,
+				   uint16_t *samples, uint32_t nb,
+				   uint16_t *expected, bool lost)
+{
+	uint32_t i, errors = 0;
+
+	for (i = 0; i < nb; i++) {
+		if (samples[i] != *expected && !(lost && !i))
+			errors++;
+		*expected = samples[i] + 1;
+	}
+	bench->delivered += nb;
+
+	return errors;
+}
+
+/*
+ * Bounded captures of BENCH_STREAM_PERIOD_SAMPLES samples, processed at
+ * process_ns per sample between the captures. The conversions done while the
+ * offload is stopped are lost.
+ */
+static int32_t bench_stream_captures(struct bench_stream *bench,
+				     struct spi_engine_session *session,
+				     uint16_t *buff, uint32_t process_ns)
+{
+	uint32_t nb = BENCH_STREAM_PERIOD_SAMPLES;
+	uint32_t errors, gaps;
+	uint16_t expected;
+	uint64_t start;
+	int32_t ret;
+
+	errors = 0;
+	gaps = 0;
+	expected = 0;
+	start = bench_now_ns();
+	while (sim_get_time_us() - bench->start_us < BENCH_STREAM_US) {
+		ret = spi_engine_session_arm(session, (uint32_t)(uintptr_t)buff,
+					     0, nb);
+		if (ret != SUCCESS)
+			return ret;
+
+		ret = spi_engine_session_wait(session, 0);
+		if (ret != SUCCESS)
+			return ret;
+
+		if (buff[0] != expected)
+			gaps++;
+		errors += bench_stream_check(bench, buff, nb, &expected, true);
+		udelay(nb * process_ns / 1000);
+	}
+	bench_stream_report("captures", bench_now_ns() - start, bench, gaps,
+			    errors);
+
+	return SUCCESS;
+}
+
+/*
+ * Continuous capture in a ring of no_periods periods, the slices being
+ * processed at process_ns per sample. The data may only be discontinuous
+ * where an overrun is reported and the slices must keep their content until
+ * they are released.
+ */
+static int32_t bench_stream_run(const char *name, struct bench_stream *bench,
+				struct spi_engine_session *session,
+				uint16_t *buff, uint32_t no_periods,
+				uint32_t process_ns)
+{
+	struct spi_engine_stream_init_param stream_init = {
+		.buff = (uint8_t *)buff,
+		.no_periods = no_periods,
+		.period_samples = BENCH_STREAM_PERIOD_SAMPLES
+	};
+	uint32_t errors, overruns, avail, nb;
+	uint16_t *samples, expected;
+	uint64_t start;
+	int32_t ret;
+
+	bench->start_us = sim_get_time_us();
+	bench->next = 0;
+	bench->delivered = 0;
+	ret = spi_engine_stream_start(session, &stream_init);
+	if (ret != SUCCESS)
+		return ret;
+
+	errors = 0;
+	overruns = 0;
+	expected = 0;
+	start = bench_now_ns();
+	while (sim_get_time_us() - bench->start_us < BENCH_STREAM_US) {
+		ret = spi_engine_stream_read(session, BENCH_STREAM_PERIOD_SAMPLES *
+					     sizeof(*samples),
+					     (void **)&samples, &avail);
+		if (ret == -EAGAIN) {
+			udelay(1);
+			continue;
+		}
+		if (ret == -EOVERRUN)
+			overruns++;
+		else if (ret != SUCCESS)
+			goto out;
+
+		/* The slice is checked once processed, the DMA must not have
+		 * written it meanwhile */
+		nb = avail / sizeof(*samples);
+		udelay(nb * process_ns / 1000);
+		errors += bench_stream_check(bench, samples, nb, &expected,
+					     ret == -EOVERRUN);
+
+		ret = spi_engine_stream_release(session);
+		if (ret != SUCCESS)
+			goto out;
+	}
+	bench_stream_report(name, bench_now_ns() - start, bench, overruns,
+			    errors);
+	ret = SUCCESS;
+out:
+	spi_engine_stream_stop(session);
+
+	return ret;
+}
+
+/*
+ * Continuous sampling with the ad738x_read_data() program: bounded captures
+ * against a stream, with a reader keeping up with the ADC, a slow one and one
+ * holding each slice for several periods. The slow reader and one holding the
+ * slices for longer than the DMAC queue lasts also read a ring of more
+ * periods than the DMAC queues, the DMAC running dry while periods wait in
+ * the driver.
+ */
+static int32_t bench_spi_engine_stream(void)
+{
+	static const struct sim_axi_region_ops ops = {
+		.write = bench_offload_write
+	};
+	struct spi_engine_init_param engine_init = {
+		.ref_clk_hz = BENCH_OFFLOAD_REF_CLK_HZ,
+		.type = SPI_ENGINE,
+		.spi_engine_baseaddr = SPI_ENGINE_BASEADDR,
+		.cs_delay = 0,
+		.data_width = 16
+	};
+	struct spi_init_param spi_init_param = {
+		.max_speed_hz = BENCH_OFFLOAD_SPI_HZ,
+		.chip_select = SPI_CS,
+		.mode = SPI_MODE_0,
+		.platform_ops = &spi_eng_platform_ops,
+		.extra = &engine_init
+	};
+	struct sim_axi_dmac_init sim_dmac_init = {
+		.base = SPI_ENGINE_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM,
+		.paced = true
+	};
+	struct spi_engine_offload_init_param offload_init = {
+		.rx_dma_baseaddr = SPI_ENGINE_DMA_BASEADDR,
+		.offload_config = OFFLOAD_RX_EN
+	};
+	uint32_t commands[] = {CS_LOW, WRITE_READ(2), CS_HIGH};
+	uint32_t commands_data[2] = {0, 0};
+	struct spi_engine_offload_message msg;
+	struct spi_engine_session *session;
+	struct bench_offload_model *model;
+	struct bench_stream bench;
+	struct sim_axi_conv conv;
+	struct spi_desc *spi;
+	uint16_t *buff;
+	uint32_t bytes;
+	int32_t ret;
+
+	bytes = BENCH_STREAM_DEEP_PERIODS * BENCH_STREAM_PERIOD_SAMPLES *
+		sizeof(*buff);
+	buff = sim_dma_alloc(bytes);
+	if (!buff)
+		return FAILURE;
+
+	model = calloc(1, sizeof(*model));
+	if (!model) {
+		ret = FAILURE;
+		goto out_buff;
+	}
+
+	model->region.base = SPI_ENGINE_BASEADDR;
+	model->region.size = sizeof(model->regs);
+	model->region.regs = model->regs;
+	model->region.ops = &ops;
+	model->region.ctx = model;
+	model->regs[SPI_ENGINE_REG_DATA_WIDTH / 4] = 32;
+
+	ret = sim_axi_add_region(&model->region);
+	if (ret != SUCCESS)
+		goto out_model;
+
+	memset(&bench, 0, sizeof(bench));
+	memset(&conv, 0, sizeof(conv));
+	conv.data = bench_stream_data;
+	conv.ctx = &bench;
+	sim_dmac_init.conv = &conv;
+	ret = sim_axi_dmac_init(&bench.dmac, &sim_dmac_init);
+	if (ret != SUCCESS)
+		goto out_region;
+	bench.engine = model;
+
+	ret = spi_init(&spi, &spi_init_param);
+	if (ret != SUCCESS)
+		goto out_dmac;
+
+	ret = spi_engine_session_init(&session, spi, &offload_init);
+	if (ret != SUCCESS)
+		goto out_spi;
+
+	msg.commands = commands;
+	msg.no_commands = ARRAY_SIZE(commands);
+	msg.commands_data = commands_data;
+	ret = spi_engine_session_load(session, &msg);
+	if (ret != SUCCESS)
+		goto out_session;
+
+	/* The model writes 16 bit samples */
+	if (session->prog.sample_bytes != sizeof(*buff)) {
+		ret = FAILURE;
+		goto out_session;
+	}
+
+	sim_delay_set_hook(bench_stream_step, &bench);
+
+	bench.start_us = sim_get_time_us();
+	ret = bench_stream_captures(&bench, session, buff, BENCH_STREAM_FAST_NS);
+	if (ret != SUCCESS)
+		goto out_hook;
+
+	ret = bench_stream_run("stream", &bench, session, buff,
+			       BENCH_STREAM_PERIODS, BENCH_STREAM_FAST_NS);
+	if (ret != SUCCESS)
+		goto out_hook;
+
+	ret = bench_stream_run("stream, slow reader", &bench, session, buff,
+			       BENCH_STREAM_PERIODS, BENCH_STREAM_SLOW_NS);
+	if (ret != SUCCESS)
+		goto out_hook;
+
+	ret = bench_stream_run("stream, holding reader", &bench, session, buff,
+			       BENCH_STREAM_PERIODS, BENCH_STREAM_HOLD_NS);
+	if (ret != SUCCESS)
+		goto out_hook;
+
+	ret = bench_stream_run("deep stream, slow", &bench, session, buff,
+			       BENCH_STREAM_DEEP_PERIODS, BENCH_STREAM_SLOW_NS);
+	if (ret != SUCCESS)
+		goto out_hook;
+
+	ret = bench_stream_run("deep stream, late", &bench, session, buff,
+			       BENCH_STREAM_DEEP_PERIODS, BENCH_STREAM_LATE_NS);
+out_hook:
+	sim_delay_set_hook(NULL, NULL);
+out_session:
+	spi_engine_session_remove(session);
+out_spi:
+	spi_remove(spi);
+out_dmac:
+	sim_axi_dmac_remove(bench.dmac);
+out_region:
+	sim_axi_remove_region(&model->region);
+out_model:
+	free(model);
+out_buff:
+	sim_dma_free(buff, bytes);
+
+	return ret;
+}
+
+/* SPI Engine offload captures, then continuous sampling */
+int32_t bench_spi_engine(void)
+{
+	int32_t ret;
+
+	ret = bench_spi_engine_offload();
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_spi_engine_stream();
+}
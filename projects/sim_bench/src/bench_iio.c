@@ -0,0 +1,1286 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_iio.c
+ *   @brief  IIO capture post-processing and IIO server.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "error.h"
+#include "util.h"
+#include "iio.h"
+#include "iio_demux.h"
+#include "axi_adc_core.h"
+#include "axi_dmac.h"
+#include "iio_axi_adc.h"
+#include "sim_axi_io.h"
+#include "sim_axi_models.h"
+#include "sim_delay.h"
+#include "tcp_socket.h"
+#include "linux_socket.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Capture post-processing test */
+struct bench_demux_case {
+	const char		*name;
+	uint32_t		nb_channels;
+	const struct scan_type	*raw;
+	const struct scan_type	*out;
+	uint32_t		mask;
+	/** Loop of the driver, if any, bench_demux_legacy() otherwise */
+	void (*legacy)(const struct bench_demux_case *c, const uint8_t *src,
+		       uint8_t *dst, uint32_t nb_scans);
+};
+
+/* IIO device whose attributes, and the ones of its channels, return their
+ * index, plus 1000 times the channel number plus one for the channels */
+struct bench_iio_dev {
+	struct iio_device	desc;
+	struct iio_channel	channels[BENCH_IIO_CHANNELS];
+	struct iio_attribute	*attrs;
+	char			(*names)[16];
+	uint32_t		nb_attrs;
+};
+
+/* In-memory network of the lookup test: a single client sends the commands
+ * of script and the answers of the server are compared with the expected
+ * ones as they are sent. Without answers, the bytes sent are only hashed. */
+struct bench_iio_net {
+	struct network_interface	net;
+	bool				connected;
+	char				*script;
+	uint32_t			script_len;
+	uint32_t			script_pos;
+	char				*answers;
+	uint32_t			answers_len;
+	uint32_t			answers_pos;
+	bool				mismatch;
+	uint64_t			sent;
+	uint64_t			hash;
+};
+
+/* Continuous capture test: the ADC words hold their conversion index and the
+ * client reads them through the in-memory network, at the rate of its link.
+ * The network must stay the first member, it is the context of its ops. */
+struct bench_iio_cont {
+	struct bench_iio_net	net;
+	struct sim_axi_dmac	*dmac;
+	/* Link rate of the client, in bytes per us */
+	uint32_t		link_rate;
+	uint64_t		link_bytes;
+	uint64_t		start_us;
+	/* Next conversion and value written by the DMA */
+	uint64_t		next;
+	uint16_t		value;
+	/* Parsing of the answers: data bytes of the READBUF whose mask line is
+	 * expected, then data bytes left in the current one */
+	uint32_t		pending;
+	uint32_t		data_left;
+	char			line[16];
+	uint32_t		line_len;
+	uint8_t			lsb;
+	bool			odd;
+	uint16_t		expected;
+	uint64_t		received;
+	uint32_t		discontinuities;
+	bool			error;
+};
+
+/* Network client of the load test, reading the answers through buf */
+struct bench_iio_client {
+	pthread_t		thread;
+	int			fd;
+	struct bench_iio_dev	*dev;
+	/* Index of the client and attribute reads it does */
+	uint32_t		id;
+	uint32_t		round_trips;
+	char			buf[256];
+	uint32_t		len;
+	uint32_t		pos;
+	int32_t			ret;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/* Raw and IIO layouts of the capture post-processing tests */
+static const struct scan_type bench_demux_ad713x = {'u', 24, 32, 7, false};
+static const struct scan_type bench_demux_u32 = {'u', 32, 32, 0, false};
+static const struct scan_type bench_demux_s16 = {'s', 16, 16, 0, false};
+static const struct scan_type bench_demux_be_s14 = {'s', 14, 16, 2, true};
+static const struct scan_type bench_demux_s16_32 = {'s', 16, 32, 16, false};
+
+/* Stops the server thread of the load test */
+static volatile bool bench_iio_stop;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Load and store a sample, the pointer being to its first byte */
+static uint32_t bench_demux_load(const uint8_t *src, const struct scan_type *t)
+{
+	uint32_t v = 0;
+	uint8_t bytes = t->storagebits / 8;
+	uint8_t i;
+
+	for (i = 0; i < bytes; i++)
+		v |= (uint32_t)src[t->is_big_endian ? i : bytes - 1 - i] <<
+		     ((bytes - 1 - i) * 8);
+
+	return v;
+}
+
+static void bench_demux_store(uint8_t *dst, uint32_t v,
+			      const struct scan_type *t)
+{
+	uint8_t bytes = t->storagebits / 8;
+	uint8_t i;
+
+	for (i = 0; i < bytes; i++)
+		dst[t->is_big_endian ? bytes - 1 - i : i] = v >> (i * 8);
+}
+
+/* Sample by sample post-processing, as done by the drivers, walking all
+ * the channels of each scan and checking the mask for each of them */
+static void bench_demux_legacy(const struct bench_demux_case *c,
+			       const uint8_t *src, uint8_t *dst,
+			       uint32_t nb_scans)
+{
+	uint32_t in_bytes = c->raw->storagebits / 8;
+	uint32_t out_bytes = c->out->storagebits / 8;
+	uint32_t i, ch, v, pad;
+
+	for (i = 0; i < nb_scans; i++, src += c->nb_channels * in_bytes) {
+		for (ch = 0; ch < c->nb_channels; ch++) {
+			if (!(c->mask & BIT(ch)))
+				continue;
+			v = bench_demux_load(src + ch * in_bytes, c->raw);
+			pad = 32 - c->raw->realbits;
+			v = (v >> c->raw->shift) & (0xFFFFFFFF >> pad);
+			if (c->raw->sign == 's' && pad)
+				v = (uint32_t)((int32_t)(v << pad) >> pad);
+			bench_demux_store(dst, v << c->out->shift, c->out);
+			dst += out_bytes;
+		}
+	}
+}
+
+/* Loop of _iio_ad713x_read_dev() before the demultiplexer */
+static void bench_demux_ad713x_legacy(const struct bench_demux_case *c,
+				      const uint8_t *src, uint8_t *dst,
+				      uint32_t nb_scans)
+{
+	const uint32_t *rx = (const uint32_t *)src;
+	uint32_t *buff = (uint32_t *)dst;
+	uint32_t data;
+	uint8_t  ch;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0, j = 0; i < nb_scans; i++)
+		for (ch = 0; ch < c->nb_channels; ch++)
+			if (c->mask & BIT(ch)) {
+				data = rx[i * c->nb_channels + ch];
+				data <<= 1;
+				data &= 0xffffff00;
+				data >>= 8;
+				buff[j++] = data;
+			}
+}
+
+/* Capture post-processing, in samples of the active channels per second */
+static int32_t bench_demux(void)
+{
+	static const struct bench_demux_case cases[] = {
+		/* AD713x offload words */
+		{
+			"ad713x", 8, &bench_demux_ad713x, &bench_demux_u32,
+			0xFF, bench_demux_ad713x_legacy
+		},
+		{
+			"ad713x", 8, &bench_demux_ad713x, &bench_demux_u32,
+			0x0F, bench_demux_ad713x_legacy
+		},
+		{
+			"ad713x", 8, &bench_demux_ad713x, &bench_demux_u32,
+			0x55, bench_demux_ad713x_legacy
+		},
+		{
+			"ad713x", 8, &bench_demux_ad713x, &bench_demux_u32,
+			0x01, bench_demux_ad713x_legacy
+		},
+		/* 16 bit samples stored as captured */
+		{"s16", 8, &bench_demux_s16, &bench_demux_s16, 0xFF},
+		{"s16", 8, &bench_demux_s16, &bench_demux_s16, 0x33},
+		/* 14 bit big endian samples with 2 status bits */
+		{"be s14", 4, &bench_demux_be_s14, &bench_demux_s16, 0x0F},
+		{"be s14", 4, &bench_demux_be_s14, &bench_demux_s16, 0x05},
+		/* 16 bit samples in the upper half of 32 bit words */
+		{"s16 in 32", 4, &bench_demux_s16_32, &bench_demux_s16, 0x0F},
+		{"s16 in 32", 4, &bench_demux_s16_32, &bench_demux_s16, 0x06},
+	};
+	void (*legacy_loop)(const struct bench_demux_case *c,
+			    const uint8_t *src, uint8_t *dst,
+			    uint32_t nb_scans);
+	struct iio_demux_init_param init;
+	struct iio_demux *demux;
+	uint8_t *raw, *legacy, *out;
+	uint64_t start, t_legacy, t_demux, nb;
+	uint32_t i, j, size;
+	int32_t ret = SUCCESS;
+
+	size = BENCH_DEMUX_SCANS * IIO_DEMUX_MAX_CHANNELS * 4;
+	raw = malloc(size);
+	legacy = malloc(size);
+	out = malloc(size);
+	if (!raw || !legacy || !out) {
+		ret = -ENOMEM;
+		goto free;
+	}
+	for (i = 0; i < size; i++)
+		raw[i] = i * 167 + (i >> 8);
+
+	for (i = 0; i < ARRAY_SIZE(cases); i++) {
+		init = (struct iio_demux_init_param) {
+			.nb_channels = cases[i].nb_channels,
+			.raw = cases[i].raw,
+			.out = cases[i].out
+		};
+		ret = iio_demux_init(&demux, &init);
+		if (ret != SUCCESS)
+			goto free;
+		ret = iio_demux_compile(demux, cases[i].mask);
+		if (ret != SUCCESS) {
+			iio_demux_remove(demux);
+			goto free;
+		}
+
+		legacy_loop = cases[i].legacy ? cases[i].legacy :
+			      bench_demux_legacy;
+		start = bench_now_ns();
+		for (j = 0; j < BENCH_DEMUX_ITERATIONS; j++)
+			legacy_loop(&cases[i], raw, legacy, BENCH_DEMUX_SCANS);
+		t_legacy = bench_now_ns() - start;
+
+		start = bench_now_ns();
+		for (j = 0; j < BENCH_DEMUX_ITERATIONS; j++)
+			iio_demux_run(demux, raw, out, BENCH_DEMUX_SCANS);
+		t_demux = bench_now_ns() - start;
+
+		nb = (uint64_t)BENCH_DEMUX_SCANS * BENCH_DEMUX_ITERATIONS *
+		     demux->nb_active;
+		printf("demux %-9s mask 0x%02"PRIx32" legacy %6.3f GSa/s, "
+		       "%-11s %6.3f GSa/s\n", cases[i].name, cases[i].mask,
+		       (double)nb / t_legacy, demux->kernel_name,
+		       (double)nb / t_demux);
+
+		if (memcmp(legacy, out, BENCH_DEMUX_SCANS *
+			   demux->out_scan_bytes)) {
+			printf("Data mismatch in demux %s\n", cases[i].name);
+			ret = FAILURE;
+		}
+		iio_demux_remove(demux);
+		if (ret != SUCCESS)
+			goto free;
+	}
+
+free:
+	free(raw);
+	free(legacy);
+	free(out);
+
+	return ret;
+}
+
+/* Value of the attribute idx of the bench IIO device, see bench_iio_dev */
+static int32_t bench_iio_value(const struct iio_ch_info *channel, intptr_t idx)
+{
+	return idx + (channel ? 1000 * (channel->ch_num + 1) : 0);
+}
+
+static ssize_t bench_iio_show(void *device, char *buf, size_t len,
+			      const struct iio_ch_info *channel, intptr_t priv)
+{
+	return snprintf(buf, len, "%"PRIi32, bench_iio_value(channel, priv));
+}
+
+static ssize_t bench_iio_store(void *device, char *buf, size_t len,
+			       const struct iio_ch_info *channel, intptr_t priv)
+{
+	return len;
+}
+
+/* Device with nb_attrs attributes, and as many for each input channel */
+static int32_t bench_iio_dev_init(struct bench_iio_dev *dev, uint32_t nb_attrs)
+{
+	uint32_t i;
+
+	memset(dev, 0, sizeof(*dev));
+	dev->nb_attrs = nb_attrs;
+	dev->attrs = calloc(nb_attrs + 1, sizeof(*dev->attrs));
+	dev->names = calloc(nb_attrs, sizeof(*dev->names));
+	if (!dev->attrs || !dev->names) {
+		free(dev->attrs);
+		free(dev->names);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < nb_attrs; i++) {
+		sprintf(dev->names[i], "attr_%"PRIu32, i);
+		dev->attrs[i].name = dev->names[i];
+		dev->attrs[i].priv = i;
+		dev->attrs[i].show = bench_iio_show;
+		dev->attrs[i].store = bench_iio_store;
+	}
+	for (i = 0; i < BENCH_IIO_CHANNELS; i++) {
+		dev->channels[i].ch_type = IIO_VOLTAGE;
+		dev->channels[i].channel = i;
+		dev->channels[i].scan_index = i;
+		dev->channels[i].indexed = true;
+		dev->channels[i].attributes = dev->attrs;
+	}
+	dev->desc.num_ch = BENCH_IIO_CHANNELS;
+	dev->desc.channels = dev->channels;
+	dev->desc.attributes = dev->attrs;
+
+	return SUCCESS;
+}
+
+static void bench_iio_dev_remove(struct bench_iio_dev *dev)
+{
+	free(dev->attrs);
+	free(dev->names);
+}
+
+/* Attribute and channel of the n-th command, spread over the device */
+static void bench_iio_target(struct bench_iio_dev *dev, uint32_t n,
+			     uint32_t *attr, int32_t *ch)
+{
+	*attr = (n * 7919) % dev->nb_attrs;
+	/* Every other command reads a device attribute */
+	*ch = (n & 1) ? (int32_t)((n >> 1) % BENCH_IIO_CHANNELS) : -1;
+}
+
+/* Command reading an attribute and the answer of the server */
+static uint32_t bench_iio_command(char *cmd, char *answer, const char *dev_id,
+				  struct bench_iio_dev *dev, uint32_t n)
+{
+	struct iio_ch_info info = { 0 };
+	char value[16];
+	uint32_t attr;
+	int32_t ch;
+	int len;
+
+	bench_iio_target(dev, n, &attr, &ch);
+	info.ch_num = ch;
+	len = sprintf(value, "%"PRIi32,
+		      bench_iio_value(ch < 0 ? NULL : &info, attr));
+	if (answer)
+		sprintf(answer, "%d\n%s\n", len, value);
+	if (ch < 0)
+		return sprintf(cmd, "READ %s %s\r\n", dev_id, dev->names[attr]);
+
+	return sprintf(cmd, "READ %s INPUT voltage%"PRIi32" %s\r\n", dev_id, ch,
+		       dev->names[attr]);
+}
+
+/* Lookups of the IIO core before its hash tables: the id of each channel is
+ * printed and compared, then the attribute names are compared one by one */
+static struct iio_attribute *bench_iio_legacy_find(struct bench_iio_dev *dev,
+		const char *channel, const char *attr)
+{
+	struct iio_attribute *attrs;
+	char ch_id[64];
+	int16_t i;
+
+	attrs = dev->desc.attributes;
+	if (channel) {
+		for (i = 0; i < dev->desc.num_ch; i++) {
+			sprintf(ch_id, "%s%d", "voltage",
+				dev->desc.channels[i].channel);
+			if (!strcmp(channel, ch_id) &&
+			    !dev->desc.channels[i].ch_out)
+				break;
+		}
+		if (i == dev->desc.num_ch)
+			return NULL;
+		attrs = dev->desc.channels[i].attributes;
+	}
+
+	for (i = 0; attrs[i].name; i++)
+		if (!strcmp(attr, attrs[i].name))
+			return &attrs[i];
+
+	return NULL;
+}
+
+static int32_t bench_iio_net_open(void *net, uint32_t *sock_id,
+				  enum socket_protocol proto,
+				  uint32_t buff_size)
+{
+	*sock_id = 0;
+
+	return SUCCESS;
+}
+
+static int32_t bench_iio_net_close(void *net, uint32_t sock_id)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_iio_net_bind(void *net, uint32_t sock_id, uint16_t port)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_iio_net_listen(void *net, uint32_t sock_id,
+				    uint32_t back_log)
+{
+	return SUCCESS;
+}
+
+static int32_t bench_iio_net_accept(void *net, uint32_t sock_id,
+				    uint32_t *client_id)
+{
+	struct bench_iio_net *bnet = net;
+
+	if (bnet->connected)
+		return -EAGAIN;
+	bnet->connected = true;
+	*client_id = 1;
+
+	return SUCCESS;
+}
+
+/* The script is received by chunks of the size asked by the server */
+static int32_t bench_iio_net_recv(void *net, uint32_t sock_id, void *data,
+				  uint32_t size)
+{
+	struct bench_iio_net *bnet = net;
+
+	size = min(size, bnet->script_len - bnet->script_pos);
+	if (!size)
+		return -EAGAIN;
+	memcpy(data, bnet->script + bnet->script_pos, size);
+	bnet->script_pos += size;
+
+	return size;
+}
+
+static int32_t bench_iio_net_send(void *net, uint32_t sock_id,
+				  const void *data, uint32_t size)
+{
+	struct bench_iio_net *bnet = net;
+	const uint8_t *bytes = data;
+	uint64_t word;
+	uint32_t i;
+
+	if (!bnet->answers) {
+		/* FNV-1a on 64 bit words, the stream position included since
+		 * the sends are not aligned */
+		for (i = 0; i < size; i += sizeof(word)) {
+			word = 0;
+			memcpy(&word, bytes + i, min(size - i, sizeof(word)));
+			bnet->hash = (bnet->hash ^ word ^ (bnet->sent + i)) *
+				     1099511628211ull;
+		}
+		bnet->sent += size;
+		return size;
+	}
+
+	if (size > bnet->answers_len - bnet->answers_pos ||
+	    memcmp(bnet->answers + bnet->answers_pos, data, size))
+		bnet->mismatch = true;
+	bnet->answers_pos += size;
+
+	return size;
+}
+
+/* Read attributes of dev through the server on the in-memory network, then
+ * find the same attributes as the IIO core did before its hash tables */
+static int32_t bench_iio_lookup_run(struct bench_iio_dev *dev)
+{
+	struct tcp_socket_init_param socket_param = { 0 };
+	struct iio_init_param init_param = { 0 };
+	struct bench_iio_net bnet = { 0 };
+	struct iio_desc *desc;
+	uint32_t i, attr, idle;
+	char name[48], ch_id[16];
+	uint64_t start;
+	int32_t ret, ch;
+
+	bnet.net = (struct network_interface) {
+		.net = &bnet,
+		.socket_open = bench_iio_net_open,
+		.socket_close = bench_iio_net_close,
+		.socket_bind = bench_iio_net_bind,
+		.socket_listen = bench_iio_net_listen,
+		.socket_accept = bench_iio_net_accept,
+		.socket_recv = bench_iio_net_recv,
+		.socket_send = bench_iio_net_send
+	};
+	bnet.script = malloc(BENCH_IIO_LOOKUPS * 64);
+	bnet.answers = malloc(BENCH_IIO_LOOKUPS * 32);
+	if (!bnet.script || !bnet.answers) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	for (i = 0; i < BENCH_IIO_LOOKUPS; i++) {
+		bnet.script_len += bench_iio_command(
+					   bnet.script + bnet.script_len,
+					   bnet.answers + bnet.answers_len,
+					   "device0", dev, i);
+		bnet.answers_len += strlen(bnet.answers + bnet.answers_len);
+	}
+
+	socket_param.net = &bnet.net;
+	init_param.phy_type = USE_NETWORK;
+	init_param.tcp_socket_init_param = &socket_param;
+	init_param.max_clients = 1;
+	ret = iio_init(&desc, &init_param);
+	if (ret != SUCCESS)
+		goto out;
+	ret = iio_register(desc, &dev->desc, "bench-iio", dev, NULL, NULL);
+	if (ret != SUCCESS)
+		goto remove;
+
+	/* Once the script is sent, the last commands take one more step */
+	idle = 0;
+	start = bench_now_ns();
+	while (bnet.answers_pos < bnet.answers_len && !bnet.mismatch &&
+	       idle < 2) {
+		ret = iio_step(desc);
+		if (ret != SUCCESS)
+			goto remove;
+		if (bnet.script_pos == bnet.script_len)
+			idle++;
+	}
+	sprintf(name, "iio read %"PRIu32" attrs", dev->nb_attrs);
+	bench_report(name, bench_now_ns() - start, BENCH_IIO_LOOKUPS, 0, NULL,
+		     0, 0);
+	if (bnet.mismatch || bnet.answers_pos != bnet.answers_len) {
+		printf("%s: wrong answers after %"PRIu32" bytes\n", name,
+		       bnet.answers_pos);
+		ret = FAILURE;
+		goto remove;
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_IIO_LOOKUPS; i++) {
+		bench_iio_target(dev, i, &attr, &ch);
+		if (ch >= 0)
+			sprintf(ch_id, "voltage%"PRIi32, ch);
+		if (bench_iio_legacy_find(dev, ch < 0 ? NULL : ch_id,
+					  dev->names[attr]) !=
+		    &dev->attrs[attr]) {
+			ret = FAILURE;
+			goto remove;
+		}
+	}
+	sprintf(name, "iio legacy find %"PRIu32, dev->nb_attrs);
+	bench_report(name, bench_now_ns() - start, BENCH_IIO_LOOKUPS, 0, NULL,
+		     0, 0);
+remove:
+	iio_remove(desc);
+out:
+	free(bnet.script);
+	free(bnet.answers);
+
+	return ret;
+}
+
+static int32_t bench_iio_read_dev(void *dev, void *buff, uint32_t nb_samples)
+{
+	return SUCCESS;
+}
+
+/* Buffer reads of BENCH_IIO_READBUF_BYTES through the server on the in-memory
+ * network, the data being copied to the libtinyiiod buffer or sent from the
+ * read buffer. The bytes sent are hashed in hash. */
+static int32_t bench_iio_readbuf_run(struct bench_iio_dev *dev, bool zero_copy,
+				     uint8_t *data, uint64_t *hash)
+{
+	struct tcp_socket_init_param socket_param = { 0 };
+	struct iio_init_param init_param = { 0 };
+	struct iio_data_buffer read_buff = {
+		.size = BENCH_IIO_READBUF_BYTES,
+		.buff = data
+	};
+	struct bench_iio_net bnet = { 0 };
+	struct iio_desc *desc;
+	uint64_t start, sent;
+	uint32_t i, pos, idle;
+	int32_t ret;
+
+	bnet.net = (struct network_interface) {
+		.net = &bnet,
+		.socket_open = bench_iio_net_open,
+		.socket_close = bench_iio_net_close,
+		.socket_bind = bench_iio_net_bind,
+		.socket_listen = bench_iio_net_listen,
+		.socket_accept = bench_iio_net_accept,
+		.socket_recv = bench_iio_net_recv,
+		.socket_send = bench_iio_net_send
+	};
+	bnet.hash = 14695981039346656037ull;
+	bnet.script = malloc(BENCH_IIO_READBUFS * 32 + 64);
+	if (!bnet.script)
+		return -ENOMEM;
+	bnet.script_len = sprintf(bnet.script, "OPEN device0 2 %x\r\n",
+				  (1u << BENCH_IIO_CHANNELS) - 1);
+	for (i = 0; i < BENCH_IIO_READBUFS; i++)
+		bnet.script_len += sprintf(bnet.script + bnet.script_len,
+					   "READBUF device0 %u\r\n",
+					   BENCH_IIO_READBUF_BYTES);
+	bnet.script_len += sprintf(bnet.script + bnet.script_len,
+				   "CLOSE device0\r\n");
+
+	socket_param.net = &bnet.net;
+	init_param.phy_type = USE_NETWORK;
+	init_param.tcp_socket_init_param = &socket_param;
+	init_param.max_clients = 1;
+	init_param.zero_copy = zero_copy;
+	ret = iio_init(&desc, &init_param);
+	if (ret != SUCCESS)
+		goto out;
+	dev->desc.read_dev = bench_iio_read_dev;
+	ret = iio_register(desc, &dev->desc, "bench-iio", dev, &read_buff,
+			   NULL);
+	if (ret != SUCCESS)
+		goto remove;
+
+	/* Until the server neither receives nor sends anymore */
+	idle = 0;
+	start = bench_now_ns();
+	while (idle < 2) {
+		pos = bnet.script_pos;
+		sent = bnet.sent;
+		ret = iio_step(desc);
+		if (ret != SUCCESS)
+			goto remove;
+		if (pos == bnet.script_pos && sent == bnet.sent)
+			idle++;
+		else
+			idle = 0;
+	}
+	bench_report(zero_copy ? "iio readbuf zero copy" : "iio readbuf copy",
+		     bench_now_ns() - start, BENCH_IIO_READBUFS,
+		     (uint64_t)BENCH_IIO_READBUFS * BENCH_IIO_READBUF_BYTES,
+		     NULL, 0, 0);
+	if (bnet.script_pos != bnet.script_len ||
+	    bnet.sent < (uint64_t)BENCH_IIO_READBUFS * BENCH_IIO_READBUF_BYTES)
+		ret = FAILURE;
+	*hash = bnet.hash;
+remove:
+	dev->desc.read_dev = NULL;
+	iio_remove(desc);
+out:
+	free(bnet.script);
+
+	return ret;
+}
+
+/* Buffer reads sent from the libtinyiiod buffer and from the read buffer,
+ * which must send the same bytes */
+static int32_t bench_iio_readbuf(struct bench_iio_dev *dev)
+{
+	uint64_t copy_hash, zc_hash;
+	uint8_t *data;
+	uint32_t i;
+	int32_t ret;
+
+	data = malloc(BENCH_IIO_READBUF_BYTES);
+	if (!data)
+		return -ENOMEM;
+	for (i = 0; i < BENCH_IIO_READBUF_BYTES; i++)
+		data[i] = i * 7;
+
+	ret = bench_iio_readbuf_run(dev, false, data, &copy_hash);
+	if (ret == SUCCESS)
+		ret = bench_iio_readbuf_run(dev, true, data, &zc_hash);
+	if (ret == SUCCESS && copy_hash != zc_hash) {
+		printf("iio readbuf: zero copy sent other data\n");
+		ret = FAILURE;
+	}
+	free(data);
+
+	return ret;
+}
+
+/* ADC data moved by the DMA, each word holds its conversion index */
+static void bench_iio_cont_data(void *ctx, uint8_t *buff, uint32_t bytes)
+{
+	struct bench_iio_cont *bench = ctx;
+	uint16_t *words = (uint16_t *)buff;
+	uint32_t i;
+
+	for (i = 0; i < bytes / sizeof(*words); i++)
+		words[i] = bench->value++;
+}
+
+/* Run the conversions that happened since the last delay. They are lost when
+ * the DMA has no transfer queued. */
+static void bench_iio_cont_step(void *ctx)
+{
+	struct bench_iio_cont *bench = ctx;
+	uint64_t due;
+
+	due = (sim_get_time_us() - bench->start_us) * BENCH_IIO_CONT_RATE /
+	      sizeof(uint16_t);
+	bench->value = bench->next;
+	sim_axi_dmac_advance(bench->dmac, (due - bench->next) *
+			     sizeof(uint16_t));
+	bench->next = due;
+}
+
+/* Check that the words received follow each other */
+static void bench_iio_cont_word(struct bench_iio_cont *bench, uint16_t word)
+{
+	if (bench->received && word != bench->expected)
+		bench->discontinuities++;
+	bench->expected = word + 1;
+	bench->received++;
+}
+
+/* Answers of the server: the size of each READBUF, its mask, then the data.
+ * Sending takes the time the link of the client needs. */
+static int32_t bench_iio_cont_send(void *net, uint32_t sock_id,
+				   const void *data, uint32_t size)
+{
+	struct bench_iio_cont *bench = net;
+	const uint8_t *bytes = data;
+	uint32_t i;
+	long value;
+
+	for (i = 0; i < size; i++) {
+		if (bench->data_left) {
+			if (bench->odd)
+				bench_iio_cont_word(bench, bench->lsb |
+						    (bytes[i] << 8));
+			else
+				bench->lsb = bytes[i];
+			bench->odd = !bench->odd;
+			bench->data_left--;
+			continue;
+		}
+		if (bytes[i] != '\n') {
+			if (bench->line_len < sizeof(bench->line) - 1)
+				bench->line[bench->line_len++] = bytes[i];
+			continue;
+		}
+		bench->line[bench->line_len] = '\0';
+		bench->line_len = 0;
+		if (bench->pending) {
+			/* Mask of the READBUF, the data follows */
+			bench->data_left = bench->pending;
+			bench->pending = 0;
+			continue;
+		}
+		value = strtol(bench->line, NULL, 10);
+		if (value < 0)
+			bench->error = true;
+		else
+			bench->pending = value;
+	}
+
+	bench->link_bytes += size;
+	udelay(bench->link_bytes / bench->link_rate -
+	       (bench->link_bytes - size) / bench->link_rate);
+
+	return size;
+}
+
+/* Continuous capture of an AXI ADC through iio_axi_adc, with a paced DMAC
+ * model, read by a client whose link moves link_rate bytes per us. Each
+ * overrun may show as two discontinuities: the samples the DMA did not
+ * capture and the unread data dropped to make room for them. */
+static int32_t bench_iio_cont_run(const char *name, uint32_t link_rate)
+{
+	struct sim_axi_conv_init sim_adc_init = {
+		.base = RX_CORE_BASEADDR,
+		.clock_hz = RX_CLOCK_HZ,
+		.data = bench_iio_cont_data
+	};
+	struct sim_axi_dmac_init sim_dmac_init = {
+		.base = RX_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM,
+		.isr = axi_dmac_default_isr,
+		.paced = true
+	};
+	struct axi_adc_init adc_init = {
+		.name = "sim-adc",
+		.base = RX_CORE_BASEADDR,
+		.num_channels = RX_NB_CHANNELS
+	};
+	struct axi_dmac_init dmac_init = {
+		.name = "sim-dmac",
+		.base = RX_DMA_BASEADDR,
+		.direction = DMA_DEV_TO_MEM
+	};
+	struct tcp_socket_init_param socket_param = { 0 };
+	struct iio_init_param init_param = { 0 };
+	struct iio_data_buffer read_buff = {
+		.size = BENCH_IIO_CONT_BYTES,
+		.continuous = true
+	};
+	struct iio_axi_adc_init_param iio_adc_init;
+	struct iio_axi_adc_desc *iio_adc;
+	struct iio_device *iio_dev;
+	struct bench_iio_cont bench = { 0 };
+	struct sim_axi_conv *sim_adc;
+	struct iio_desc *desc;
+	struct axi_adc *adc;
+	struct axi_dmac *dmac;
+	uint64_t start, sent;
+	uint32_t i, pos, idle;
+	int32_t ret;
+
+	bench.net.net = (struct network_interface) {
+		.net = &bench,
+		.socket_open = bench_iio_net_open,
+		.socket_close = bench_iio_net_close,
+		.socket_bind = bench_iio_net_bind,
+		.socket_listen = bench_iio_net_listen,
+		.socket_accept = bench_iio_net_accept,
+		.socket_recv = bench_iio_net_recv,
+		.socket_send = bench_iio_cont_send
+	};
+	bench.link_rate = link_rate;
+	bench.net.script = malloc(BENCH_IIO_CONT_READS * 32 + 64);
+	read_buff.buff = sim_dma_alloc(BENCH_IIO_CONT_BYTES);
+	if (!bench.net.script || !read_buff.buff) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	bench.net.script_len = sprintf(bench.net.script,
+				       "OPEN device0 2 %x\r\n",
+				       (1u << RX_NB_CHANNELS) - 1);
+	for (i = 0; i < BENCH_IIO_CONT_READS; i++)
+		bench.net.script_len += sprintf(bench.net.script +
+						bench.net.script_len,
+						"READBUF device0 %u\r\n",
+						BENCH_IIO_CONT_READ_BYTES);
+	bench.net.script_len += sprintf(bench.net.script +
+					bench.net.script_len,
+					"CLOSE device0\r\n");
+
+	sim_adc_init.ctx = &bench;
+	ret = sim_axi_conv_init(&sim_adc, &sim_adc_init);
+	if (ret != SUCCESS)
+		goto out;
+	sim_dmac_init.conv = sim_adc;
+	ret = sim_axi_dmac_init(&bench.dmac, &sim_dmac_init);
+	if (ret != SUCCESS)
+		goto out_conv;
+	ret = axi_adc_init(&adc, &adc_init);
+	if (ret != SUCCESS)
+		goto out_sim_dmac;
+	ret = axi_dmac_init(&dmac, &dmac_init);
+	if (ret != SUCCESS)
+		goto out_adc;
+	bench.dmac->isr_instance = dmac;
+	iio_adc_init = (struct iio_axi_adc_init_param) {
+		.rx_adc = adc,
+		.rx_dmac = dmac
+	};
+	ret = iio_axi_adc_init(&iio_adc, &iio_adc_init);
+	if (ret != SUCCESS)
+		goto out_dmac;
+	iio_axi_adc_get_dev_descriptor(iio_adc, &iio_dev);
+
+	socket_param.net = &bench.net.net;
+	init_param.phy_type = USE_NETWORK;
+	init_param.tcp_socket_init_param = &socket_param;
+	init_param.max_clients = 1;
+	ret = iio_init(&desc, &init_param);
+	if (ret != SUCCESS)
+		goto out_iio_adc;
+	ret = iio_register(desc, iio_dev, "bench-adc", iio_adc, &read_buff,
+			   NULL);
+	if (ret != SUCCESS)
+		goto remove;
+
+	bench.start_us = sim_get_time_us();
+	sim_delay_set_hook(bench_iio_cont_step, &bench);
+	/* Until the server neither receives nor sends anymore */
+	idle = 0;
+	start = bench_now_ns();
+	while (idle < 2) {
+		pos = bench.net.script_pos;
+		sent = bench.link_bytes;
+		ret = iio_step(desc);
+		if (ret != SUCCESS)
+			break;
+		if (pos == bench.net.script_pos && sent == bench.link_bytes)
+			idle++;
+		else
+			idle = 0;
+	}
+	sim_delay_set_hook(NULL, NULL);
+	printf("%-24s %10.3f ms %6.2f %% received %6"PRIu32" overruns "
+	       "%6"PRIu32" discontinuities\n", name,
+	       (bench_now_ns() - start) / 1000000.0,
+	       bench.received * 100.0 / max(bench.next, 1ull),
+	       read_buff.overruns, bench.discontinuities);
+	if (ret == SUCCESS && (bench.error ||
+			       bench.net.script_pos != bench.net.script_len ||
+			       bench.discontinuities > 2 * read_buff.overruns))
+		ret = FAILURE;
+remove:
+	iio_remove(desc);
+out_iio_adc:
+	iio_axi_adc_remove(iio_adc);
+out_dmac:
+	axi_dmac_remove(dmac);
+out_adc:
+	axi_adc_remove(adc);
+out_sim_dmac:
+	sim_axi_dmac_remove(bench.dmac);
+out_conv:
+	sim_axi_conv_remove(sim_adc);
+out:
+	if (read_buff.buff)
+		sim_dma_free(read_buff.buff, BENCH_IIO_CONT_BYTES);
+	free(bench.net.script);
+
+	return ret;
+}
+
+/* Continuous capture read by a client keeping up with the ADC, then by a
+ * client too slow for it */
+static int32_t bench_iio_cont(void)
+{
+	int32_t ret;
+
+	ret = bench_iio_cont_run("iio continuous, fast",
+				 BENCH_IIO_CONT_FAST_LINK);
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_iio_cont_run("iio continuous, slow",
+				  BENCH_IIO_CONT_SLOW_LINK);
+}
+
+static int32_t bench_iio_getc(struct bench_iio_client *cli, char *c)
+{
+	ssize_t ret;
+
+	if (cli->pos == cli->len) {
+		ret = recv(cli->fd, cli->buf, sizeof(cli->buf), 0);
+		if (ret <= 0)
+			return -ETIMEDOUT;
+		cli->len = ret;
+		cli->pos = 0;
+	}
+	*c = cli->buf[cli->pos++];
+
+	return SUCCESS;
+}
+
+/* Read an answer of the server, up to its last line feed */
+static int32_t bench_iio_answer(struct bench_iio_client *cli, char *answer,
+				uint32_t size, uint32_t lines)
+{
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; lines && i < size - 1; i++) {
+		ret = bench_iio_getc(cli, &answer[i]);
+		if (ret != SUCCESS)
+			return ret;
+		if (answer[i] == '\n')
+			lines--;
+		/* A failed read has no value line */
+		if (i == 0 && answer[i] == '-')
+			lines = 1;
+	}
+	answer[i] = '\0';
+
+	return lines ? -EINVAL : SUCCESS;
+}
+
+static int32_t bench_iio_connect(struct bench_iio_client *cli)
+{
+	struct timeval timeout = { .tv_sec = BENCH_IIO_TIMEOUT_S };
+	struct sockaddr_in addr = { 0 };
+	int one = 1;
+
+	cli->fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (cli->fd < 0)
+		return -errno;
+	setsockopt(cli->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	setsockopt(cli->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+		   sizeof(timeout));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(BENCH_IIO_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (connect(cli->fd, (struct sockaddr *)&addr, sizeof(addr))) {
+		close(cli->fd);
+		return -errno;
+	}
+	cli->len = 0;
+	cli->pos = 0;
+
+	return SUCCESS;
+}
+
+/* Client of the load test: attribute reads, one at a time */
+static void *bench_iio_client_run(void *arg)
+{
+	struct bench_iio_client *cli = arg;
+	char cmd[64], expected[32], answer[32];
+	uint32_t i, len;
+
+	for (i = 0; i < cli->round_trips; i++) {
+		len = bench_iio_command(cmd, expected, "device0", cli->dev,
+					cli->id * cli->round_trips + i);
+		if (send(cli->fd, cmd, len, 0) != len) {
+			cli->ret = -errno;
+			return NULL;
+		}
+		cli->ret = bench_iio_answer(cli, answer, sizeof(answer), 2);
+		if (cli->ret != SUCCESS)
+			return NULL;
+		if (strcmp(answer, expected)) {
+			cli->ret = -EINVAL;
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+/* Serve the clients until stop is set */
+static void *bench_iio_serve(void *arg)
+{
+	struct iio_desc *desc = arg;
+
+	while (!bench_iio_stop)
+		iio_step(desc);
+
+	return NULL;
+}
+
+/* Share the round trips between the first nb_clients clients */
+static int32_t bench_iio_load_run(struct bench_iio_dev *dev,
+				  struct bench_iio_client *clients,
+				  uint32_t nb_clients)
+{
+	uint32_t i, started;
+	char name[48];
+	uint64_t start;
+	int32_t ret;
+
+	for (i = 0; i < nb_clients; i++) {
+		clients[i].dev = dev;
+		clients[i].id = i;
+		clients[i].round_trips = BENCH_IIO_ROUND_TRIPS / nb_clients;
+		clients[i].ret = SUCCESS;
+	}
+
+	ret = SUCCESS;
+	start = bench_now_ns();
+	for (started = 0; started < nb_clients; started++)
+		if (pthread_create(&clients[started].thread, NULL,
+				   bench_iio_client_run, &clients[started])) {
+			ret = FAILURE;
+			break;
+		}
+	for (i = 0; i < started; i++) {
+		pthread_join(clients[i].thread, NULL);
+		if (clients[i].ret != SUCCESS) {
+			printf("iio client %"PRIu32"/%"PRIu32": error %"PRIi32
+			       "\n", i, nb_clients, clients[i].ret);
+			ret = FAILURE;
+		}
+	}
+	if (ret == SUCCESS) {
+		sprintf(name, "iio %"PRIu32" clients", nb_clients);
+		bench_report(name, bench_now_ns() - start,
+			     clients[0].round_trips * nb_clients, 0, NULL, 0,
+			     0);
+	}
+
+	return ret;
+}
+
+/* Attribute round trips on the loopback interface with 1, 4 and
+ * BENCH_IIO_CLIENTS clients, while another client holds a write whose
+ * payload is half sent. All the clients stay connected between the runs. */
+static int32_t bench_iio_load(struct bench_iio_dev *dev)
+{
+	static const char cmd[] = "WRITE device0 attr_0 8\r\n1234";
+	struct tcp_socket_init_param socket_param = { 0 };
+	struct iio_init_param init_param = { 0 };
+	struct bench_iio_client *clients;
+	struct bench_iio_client stalled = { 0 };
+	struct iio_desc *desc;
+	pthread_t server;
+	char answer[32];
+	uint32_t i, connected;
+	int32_t ret;
+
+	clients = calloc(BENCH_IIO_CLIENTS, sizeof(*clients));
+	if (!clients)
+		return -ENOMEM;
+
+	/* The server answers clients which may have given up */
+	signal(SIGPIPE, SIG_IGN);
+
+	socket_param.net = &linux_net;
+	init_param.phy_type = USE_NETWORK;
+	init_param.tcp_socket_init_param = &socket_param;
+	init_param.max_clients = BENCH_IIO_CLIENTS + 1;
+	ret = iio_init(&desc, &init_param);
+	if (ret != SUCCESS)
+		goto out;
+	ret = iio_register(desc, &dev->desc, "bench-iio", dev, NULL, NULL);
+	if (ret != SUCCESS)
+		goto remove;
+
+	bench_iio_stop = false;
+	if (pthread_create(&server, NULL, bench_iio_serve, desc)) {
+		ret = FAILURE;
+		goto remove;
+	}
+
+	connected = 0;
+	ret = bench_iio_connect(&stalled);
+	if (ret != SUCCESS)
+		goto stop;
+	if (send(stalled.fd, cmd, sizeof(cmd) - 1, 0) != sizeof(cmd) - 1) {
+		ret = FAILURE;
+		goto close;
+	}
+	for (connected = 0; connected < BENCH_IIO_CLIENTS; connected++) {
+		ret = bench_iio_connect(&clients[connected]);
+		if (ret != SUCCESS)
+			goto close;
+	}
+	/* Let the server receive the partial write */
+	usleep(10000);
+
+	ret = bench_iio_load_run(dev, clients, 1);
+	if (ret == SUCCESS)
+		ret = bench_iio_load_run(dev, clients, 4);
+	if (ret == SUCCESS)
+		ret = bench_iio_load_run(dev, clients, BENCH_IIO_CLIENTS);
+	if (ret != SUCCESS) {
+		printf("iio load: blocked by the client sending a payload\n");
+		goto close;
+	}
+
+	/* The write completes once its payload is received */
+	if (send(stalled.fd, "5678", 4, 0) != 4 ||
+	    bench_iio_answer(&stalled, answer, sizeof(answer), 1) != SUCCESS ||
+	    strcmp(answer, "8\n")) {
+		printf("iio load: write not answered\n");
+		ret = FAILURE;
+	}
+close:
+	for (i = 0; i < connected; i++)
+		close(clients[i].fd);
+	close(stalled.fd);
+stop:
+	bench_iio_stop = true;
+	pthread_join(server, NULL);
+remove:
+	iio_remove(desc);
+out:
+	free(clients);
+
+	return ret;
+}
+
+/* IIO server: attribute lookups, buffer reads and continuous capture, then
+ * round trips with several clients */
+static int32_t bench_iio_server(void)
+{
+	struct bench_iio_dev dev;
+	int32_t ret;
+
+	ret = bench_iio_dev_init(&dev, 16);
+	if (ret != SUCCESS)
+		return ret;
+	ret = bench_iio_lookup_run(&dev);
+	if (ret == SUCCESS)
+		ret = bench_iio_readbuf(&dev);
+	bench_iio_dev_remove(&dev);
+	if (ret == SUCCESS)
+		ret = bench_iio_cont();
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_iio_dev_init(&dev, 256);
+	if (ret != SUCCESS)
+		return ret;
+	ret = bench_iio_lookup_run(&dev);
+	if (ret == SUCCESS)
+		ret = bench_iio_load(&dev);
+	bench_iio_dev_remove(&dev);
+
+	return ret;
+}
+
+/* Capture post-processing, then the IIO server */
+int32_t bench_iio(void)
+{
+	int32_t ret;
+
+	ret = bench_demux();
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_iio_server();
+}
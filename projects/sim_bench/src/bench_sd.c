@@ -0,0 +1,450 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_sd.c
+ *   @brief  SD card driver against a model of an SPI SD card.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "sd.h"
+#include "sim_delay.h"
+#include "sim_spi.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* State of the simulated SD card */
+enum bench_sd_state {
+	BENCH_SD_IDLE,
+	/* Sending blocks after CMD17 or CMD18 */
+	BENCH_SD_READ,
+	/* Waiting for a start block or stop transmission token */
+	BENCH_SD_WRITE,
+	/* Receiving a block and its CRC */
+	BENCH_SD_WRITE_DATA
+};
+
+/* SD card in SPI mode, see bench_sd_xfer() */
+struct bench_sd_model {
+	uint8_t			*mem;
+	uint32_t		nb_blocks;
+	/* Command being received */
+	uint8_t			cmd[6];
+	uint32_t		cmd_len;
+	/* The last command was CMD55 */
+	bool			app_cmd;
+	/* Initialization done, after the second ACMD41 */
+	bool			ready;
+	uint32_t		nb_acmd41;
+	enum bench_sd_state	state;
+	/* Multiple block read or write, and the current block */
+	bool			multi;
+	uint32_t		block;
+	/* Block being written */
+	uint8_t			data[DATA_BLOCK_LEN + 2];
+	uint32_t		data_len;
+	/* Bytes to send */
+	uint8_t			out[DATA_BLOCK_LEN + 8];
+	uint32_t		out_start;
+	uint32_t		out_len;
+	/* End of the read access time and of the programming time */
+	uint64_t		access_until_ns;
+	uint64_t		busy_until_ns;
+	/* Chip select assertions, bytes and bytes read while busy */
+	uint64_t		nb_xfers;
+	uint64_t		nb_bytes;
+	uint64_t		nb_busy_polls;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Time of the simulated SD card: the simulated delays, the SPI calls and the
+ * bytes clocked on the bus */
+static uint64_t bench_sd_now_ns(struct bench_sd_model *card)
+{
+	return sim_get_time_us() * 1000 + card->nb_xfers * BENCH_SD_CALL_NS +
+	       card->nb_bytes * 8000000000ull / BENCH_SD_CLK_HZ;
+}
+
+/* Queue bytes sent by the simulated SD card */
+static void bench_sd_out(struct bench_sd_model *card, const uint8_t *data,
+			 uint32_t len)
+{
+	if (card->out_start) {
+		memmove(card->out, card->out + card->out_start, card->out_len);
+		card->out_start = 0;
+	}
+	memcpy(card->out + card->out_len, data, len);
+	card->out_len += len;
+}
+
+/* Execute a command received by the simulated SD card */
+static void bench_sd_cmd(struct bench_sd_model *card, uint64_t now)
+{
+	uint8_t resp[DATA_BLOCK_LEN + 4];
+	uint32_t arg, c_size;
+	bool app_cmd;
+
+	arg = ((uint32_t)card->cmd[1] << 24) | (card->cmd[2] << 16) |
+	      (card->cmd[3] << 8) | card->cmd[4];
+	app_cmd = card->app_cmd;
+	card->app_cmd = false;
+
+	/* Response after one byte */
+	resp[0] = 0xFF;
+	resp[1] = card->ready ? 0x00 : 0x01;
+	switch (card->cmd[0] & 0x3F) {
+	case 0:
+		card->ready = false;
+		card->nb_acmd41 = 0;
+		resp[1] = 0x01;
+		bench_sd_out(card, resp, 2);
+		break;
+	case 8:
+		resp[2] = 0x00;
+		resp[3] = 0x00;
+		resp[4] = 0x01;
+		resp[5] = 0xAA;
+		bench_sd_out(card, resp, 6);
+		break;
+	case 9:
+		/* CSD version 2.0 with the card size */
+		c_size = card->nb_blocks / 1024 - 1;
+		memset(resp + 2, 0, 21);
+		resp[2] = 0xFF;
+		resp[3] = 0xFE;
+		resp[4] = 0x40;
+		resp[4 + 7] = (c_size >> 16) & 0x3F;
+		resp[4 + 8] = c_size >> 8;
+		resp[4 + 9] = c_size;
+		bench_sd_out(card, resp, 22);
+		break;
+	case 12:
+		card->state = BENCH_SD_IDLE;
+		card->out_len = 0;
+		bench_sd_out(card, resp, 2);
+		break;
+	case 17:
+	case 18:
+		card->state = BENCH_SD_READ;
+		card->multi = (card->cmd[0] & 0x3F) == 18;
+		card->block = arg;
+		card->access_until_ns = now + BENCH_SD_ACCESS_US * 1000;
+		bench_sd_out(card, resp, 2);
+		break;
+	case 23:
+		/* Pre-erase count, the programming time does not depend on it */
+		bench_sd_out(card, resp, 2);
+		break;
+	case 24:
+	case 25:
+		card->state = BENCH_SD_WRITE;
+		card->multi = (card->cmd[0] & 0x3F) == 25;
+		card->block = arg;
+		bench_sd_out(card, resp, 2);
+		break;
+	case 41:
+		if (app_cmd && ++card->nb_acmd41 > 1) {
+			card->ready = true;
+			resp[1] = 0x00;
+		}
+		bench_sd_out(card, resp, 2);
+		break;
+	case 55:
+		card->app_cmd = true;
+		bench_sd_out(card, resp, 2);
+		break;
+	case 58:
+		/* OCR with the card capacity status bit */
+		resp[2] = 0xC0;
+		resp[3] = 0xFF;
+		resp[4] = 0x80;
+		resp[5] = 0x00;
+		bench_sd_out(card, resp, 6);
+		break;
+	default:
+		resp[1] |= 0x04;
+		bench_sd_out(card, resp, 2);
+		break;
+	}
+}
+
+/* Receive a byte of a written block, the block is stored with its CRC */
+static void bench_sd_write(struct bench_sd_model *card, uint8_t in,
+			   uint64_t now)
+{
+	uint8_t resp = 0x05;
+
+	card->data[card->data_len++] = in;
+	if (card->data_len < DATA_BLOCK_LEN + 2)
+		return;
+
+	if (card->block < card->nb_blocks)
+		memcpy(card->mem + (uint64_t)card->block * DATA_BLOCK_LEN,
+		       card->data, DATA_BLOCK_LEN);
+	card->block++;
+	bench_sd_out(card, &resp, 1);
+	card->busy_until_ns = now + (card->multi ? BENCH_SD_BLOCK_BUSY_US :
+				     BENCH_SD_PROG_US) * 1000;
+	card->state = card->multi ? BENCH_SD_WRITE : BENCH_SD_IDLE;
+}
+
+/* Byte sent by the simulated SD card for the byte received */
+static uint8_t bench_sd_byte(struct bench_sd_model *card, uint8_t in,
+			     uint64_t now)
+{
+	uint8_t token = 0xFE;
+	uint8_t crc[2] = { 0xFF, 0xFF };
+	uint8_t out = 0xFF;
+
+	/* Programming: the card holds the line low and ignores the input */
+	if (!card->out_len && now < card->busy_until_ns) {
+		card->nb_busy_polls++;
+		return 0x00;
+	}
+
+	switch (card->state) {
+	case BENCH_SD_IDLE:
+	case BENCH_SD_READ:
+		/* Commands are ignored while a response is sent, except
+		 * CMD12 which stops a multiple block read */
+		if (card->cmd_len || ((in & 0xC0) == 0x40 &&
+				      (!card->out_len ||
+				       card->state == BENCH_SD_READ))) {
+			card->cmd[card->cmd_len++] = in;
+			if (card->cmd_len == 6) {
+				card->cmd_len = 0;
+				card->out_len = 0;
+				bench_sd_cmd(card, now);
+				return 0xFF;
+			}
+			break;
+		}
+		if (card->state != BENCH_SD_READ || card->out_len)
+			break;
+		if (now < card->access_until_ns)
+			return 0xFF;
+		/* Next block, with its token and CRC */
+		bench_sd_out(card, &token, 1);
+		bench_sd_out(card, card->mem + (uint64_t)card->block *
+			     DATA_BLOCK_LEN, DATA_BLOCK_LEN);
+		bench_sd_out(card, crc, 2);
+		card->block++;
+		card->access_until_ns = now + BENCH_SD_ACCESS_US * 1000;
+		if (!card->multi)
+			card->state = BENCH_SD_IDLE;
+		break;
+	case BENCH_SD_WRITE:
+		if (in == 0xFE || in == 0xFC) {
+			card->state = BENCH_SD_WRITE_DATA;
+			card->data_len = 0;
+		} else if (in == 0xFD) {
+			card->state = BENCH_SD_IDLE;
+			card->busy_until_ns = now + BENCH_SD_PROG_US * 1000;
+		}
+		break;
+	case BENCH_SD_WRITE_DATA:
+		/* The data response comes with the next byte */
+		bench_sd_write(card, in, now);
+		return 0xFF;
+	}
+
+	if (card->out_len) {
+		out = card->out[card->out_start++];
+		card->out_len--;
+	}
+
+	return out;
+}
+
+/*
+ * SD card in SPI mode, SDHC, with the commands used by the driver. The
+ * response of a command comes after one byte, the read data after
+ * BENCH_SD_ACCESS_US and the card is busy BENCH_SD_PROG_US after a single
+ * block write or a multiple block write, and BENCH_SD_BLOCK_BUSY_US after
+ * each block of a multiple block write.
+ */
+static int32_t bench_sd_xfer(void *ctx, uint8_t *data, uint32_t bytes_number)
+{
+	struct bench_sd_model *card = ctx;
+	uint64_t now;
+	uint32_t i;
+
+	card->nb_xfers++;
+	now = bench_sd_now_ns(card);
+	for (i = 0; i < bytes_number; i++) {
+		data[i] = bench_sd_byte(card, data[i],
+					now + i * 8000000000ull /
+					BENCH_SD_CLK_HZ);
+	}
+	card->nb_bytes += bytes_number;
+
+	return SUCCESS;
+}
+
+/* Print the SPI traffic of SD card accesses and their estimated speed */
+static void bench_sd_report(const char *name, uint64_t ns, uint32_t iterations,
+			    struct bench_sd_model *card,
+			    struct bench_sd_model *start, uint64_t start_hw_ns)
+{
+	uint64_t hw_ns;
+
+	hw_ns = bench_sd_now_ns(card) - start_hw_ns;
+	printf("%-24s %10.3f us/call %6.1f calls %7.0f bytes %6.1f polls /call,"
+	       " %6.2f MB/s on hardware\n", name, ns / 1000.0 / iterations,
+	       (double)(card->nb_xfers - start->nb_xfers) / iterations,
+	       (double)(card->nb_bytes - start->nb_bytes) / iterations,
+	       (double)(card->nb_busy_polls - start->nb_busy_polls) /
+	       iterations, BENCH_SD_BYTES * 1000.0 / hw_ns);
+}
+
+/* Log BENCH_SD_BYTES to the card by BENCH_SD_WRITE_SIZE, as FatFs writes a
+ * file sector by sector, then read them back by BENCH_SD_READ_SIZE */
+static int32_t bench_sd_run(const char *name, uint32_t cache_blocks)
+{
+	struct bench_sd_model *card;
+	struct bench_sd_model start_card;
+	struct sim_spi_init_param sim_param = {
+		.xfer = bench_sd_xfer
+	};
+	struct spi_init_param spi_param = {
+		.max_speed_hz = BENCH_SD_CLK_HZ,
+		.mode = SPI_MODE_0,
+		.platform_ops = &sim_spi_platform_ops,
+		.extra = &sim_param
+	};
+	struct sd_init_param sd_param = {
+		.cache_blocks = cache_blocks
+	};
+	struct sd_desc *sd;
+	uint8_t *data;
+	uint64_t start, start_hw, i, j;
+	char label[32];
+	int32_t ret;
+
+	card = calloc(1, sizeof(*card));
+	data = malloc(BENCH_SD_READ_SIZE);
+	if (!card || !data) {
+		ret = -ENOMEM;
+		goto free_card;
+	}
+	card->nb_blocks = BENCH_SD_BLOCKS;
+	card->mem = calloc(BENCH_SD_BLOCKS, DATA_BLOCK_LEN);
+	if (!card->mem) {
+		ret = -ENOMEM;
+		goto free_card;
+	}
+
+	sim_param.ctx = card;
+	ret = spi_init(&sd_param.spi_desc, &spi_param);
+	if (ret != SUCCESS)
+		goto free_mem;
+
+	ret = sd_init(&sd, &sd_param);
+	if (ret != SUCCESS)
+		goto free_spi;
+
+	start_card = *card;
+	start_hw = bench_sd_now_ns(card);
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_SD_BYTES; i += BENCH_SD_WRITE_SIZE) {
+		memset(data, (uint8_t)(i / BENCH_SD_WRITE_SIZE),
+		       BENCH_SD_WRITE_SIZE);
+		ret = sd_write(sd, data, i, BENCH_SD_WRITE_SIZE);
+		if (ret != SUCCESS)
+			goto free_sd;
+	}
+	ret = sd_sync(sd);
+	if (ret != SUCCESS)
+		goto free_sd;
+	snprintf(label, sizeof(label), "%s write", name);
+	bench_sd_report(label, bench_now_ns() - start,
+			BENCH_SD_BYTES / BENCH_SD_WRITE_SIZE, card, &start_card,
+			start_hw);
+
+	start_card = *card;
+	start_hw = bench_sd_now_ns(card);
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_SD_BYTES; i += BENCH_SD_READ_SIZE) {
+		ret = sd_read(sd, data, i, BENCH_SD_READ_SIZE);
+		if (ret != SUCCESS)
+			goto free_sd;
+		/* Each logged sector holds its index */
+		for (j = 0; j < BENCH_SD_READ_SIZE; j += BENCH_SD_WRITE_SIZE)
+			if (data[j] != (uint8_t)((i + j) / BENCH_SD_WRITE_SIZE) ||
+			    data[j + BENCH_SD_WRITE_SIZE - 1] != data[j])
+				ret = FAILURE;
+	}
+	snprintf(label, sizeof(label), "%s read", name);
+	bench_sd_report(label, bench_now_ns() - start,
+			BENCH_SD_BYTES / BENCH_SD_READ_SIZE, card, &start_card,
+			start_hw);
+
+free_sd:
+	sd_remove(sd);
+free_spi:
+	spi_remove(sd_param.spi_desc);
+free_mem:
+	free(card->mem);
+free_card:
+	free(data);
+	free(card);
+
+	return ret;
+}
+
+/* SD card logging, writing through and with the write cache */
+int32_t bench_sd(void)
+{
+	int32_t ret;
+
+	ret = bench_sd_run("sd", 0);
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_sd_run("sd cached", BENCH_SD_CACHE_BLOCKS);
+}
@@ -0,0 +1,338 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_talise.c
+ *   @brief  ADRV9009 HAL against a model of the device SPI and ARM memory.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "crc.h"
+#include "adi_hal.h"
+#include "talise.h"
+#include "talise_arm.h"
+#include "talise_arm_macros.h"
+#include "talise_radioctrl.h"
+#include "talise_reg_addr_macros.h"
+#include "sim_spi.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* ADRV9009 SPI registers and ARM memory, see bench_talise_xfer() */
+struct bench_talise_model {
+	uint8_t			regs[0x4000];
+	uint8_t			prog[TALISE_ADDR_ARM_END_PROG_ADDR -
+				     TALISE_ADDR_ARM_START_PROG_ADDR];
+	uint8_t			data[TALISE_ADDR_ARM_END_DATA_ADDR -
+				     TALISE_ADDR_ARM_START_DATA_ADDR];
+	struct bench_spi_stats	spi;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+static struct bench_talise_model bench_talise_model;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/*
+ * ADRV9009 device model: the SPI configuration registers, with streaming
+ * transactions refused in single instruction mode, and the ARM memory
+ * accessed through the DMA registers.
+ */
+static uint8_t bench_talise_access(struct bench_talise_model *model,
+				   uint16_t addr, uint8_t data, bool read)
+{
+	uint8_t *regs = model->regs;
+	uint32_t word;
+	uint8_t *mem;
+
+	switch (addr) {
+	case TALISE_ADDR_VENDOR_ID_0:
+	case TALISE_ADDR_VENDOR_ID_1:
+	case TALISE_ADDR_SCRATCH_PAD_READ_ONLY_UPPER_ADDRESS_SPACE:
+		/* Read only */
+		return regs[addr];
+	case TALISE_ADDR_ARM_DMA_DATA0 ... TALISE_ADDR_ARM_DMA_DATA3:
+		break;
+	default:
+		if (!read)
+			regs[addr] = data;
+		return regs[addr];
+	}
+
+	/* Address bits 17:2, the data memory being selected by bit 6 */
+	word = (regs[TALISE_ADDR_ARM_DMA_ADDR1] << 10) |
+	       (regs[TALISE_ADDR_ARM_DMA_ADDR0] << 2);
+	if (regs[TALISE_ADDR_ARM_DMA_CTL] & 0x40)
+		mem = word < sizeof(model->data) ? &model->data[word] : NULL;
+	else
+		mem = word < sizeof(model->prog) ? &model->prog[word] : NULL;
+	if (mem) {
+		mem += addr - TALISE_ADDR_ARM_DMA_DATA0;
+		if (read)
+			data = *mem;
+		else
+			*mem = data;
+	}
+
+	/* Auto increment after the last byte of a word */
+	if (addr == TALISE_ADDR_ARM_DMA_DATA3 &&
+	    (regs[TALISE_ADDR_ARM_DMA_CTL] & 0x02)) {
+		word += 4;
+		regs[TALISE_ADDR_ARM_DMA_ADDR0] = word >> 2;
+		regs[TALISE_ADDR_ARM_DMA_ADDR1] = word >> 10;
+	}
+
+	return data;
+}
+
+static int32_t bench_talise_xfer(void *ctx, uint8_t *data,
+				 uint32_t bytes_number)
+{
+	struct bench_talise_model *model = ctx;
+	uint16_t addr, step;
+	uint32_t i;
+	bool read;
+
+	if (bytes_number < 3)
+		return -EINVAL;
+	if (bytes_number > 3 &&
+	    (model->regs[TALISE_ADDR_SPI_INTERFACE_CONFIG_B] & 0x80))
+		return -EINVAL;
+
+	read = data[0] & 0x80;
+	addr = ((data[0] & 0x7F) << 8) | data[1];
+	step = (model->regs[TALISE_ADDR_SPI_INTERFACE_CONFIG_A] & 0x20) ?
+	       1 : (uint16_t)-1;
+
+	model->spi.nb_xfers++;
+	model->spi.nb_bytes += bytes_number;
+
+	data[0] = 0;
+	data[1] = 0;
+	for (i = 2; i < bytes_number; i++, addr += step)
+		data[i] = bench_talise_access(model, addr & 0x3FFF, data[i],
+					      read);
+
+	return SUCCESS;
+}
+
+/* Print the SPI traffic of an ADRV9009 operation and its estimated latency */
+static void bench_talise_report(const char *name, uint64_t ns,
+				const struct bench_spi_stats *start)
+{
+	bench_spi_report(name, ns, 1, &bench_talise_model.spi, start,
+			 BENCH_TALISE_CALL_NS, BENCH_TALISE_CLK_HZ);
+}
+
+/* Read back an image from the ARM memory and compare its CRC-32 */
+static int32_t bench_talise_verify(taliseDevice_t *dev, uint32_t address,
+				   uint8_t *image, uint32_t size)
+{
+	DECLARE_CRC_TABLE(crc32_table, 4);
+	uint8_t buf[1024];
+	struct crc_ctx ctx;
+	uint32_t i, len;
+
+	if (!crc32_table.width)
+		crc_populate_msb(&crc32_table, 32, 0x04C11DB7);
+
+	crc_init(&ctx, &crc32_table, 0xFFFFFFFF);
+	for (i = 0; i < size; i += len) {
+		len = min(size - i, sizeof(buf));
+		if (TALISE_readArmMem(dev, address + i, buf, len, 1))
+			return FAILURE;
+		crc_update(&ctx, buf, len);
+	}
+
+	if (crc_final(&ctx) != crc_compute(&crc32_table, image, size,
+					   0xFFFFFFFF))
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+/*
+ * Stream processor and ARM images loading. Without transfer(), as with the
+ * Xilinx SPI driver, each transaction is a platform call.
+ */
+static int32_t bench_talise_run(const char *name, uint8_t streaming,
+				bool transfer, uint8_t *stream, uint8_t *arm)
+{
+	struct bench_talise_model *model = &bench_talise_model;
+	struct sim_spi_init_param sim_param = {
+		.xfer = bench_talise_xfer,
+		.ctx = model
+	};
+	taliseSpiSettings_t spi_settings = {
+		.MSBFirst = 1,
+		.enSpiStreaming = streaming,
+		.autoIncAddrUp = 1,
+		.fourWireMode = 1,
+		.cmosPadDrvStrength = TAL_CMOSPAD_DRV_2X
+	};
+	struct adi_hal hal = {
+		.extra_spi = &sim_param
+	};
+	taliseDevice_t dev = {
+		.devHalInfo = &hal
+	};
+	struct bench_spi_stats start_spi;
+	struct spi_platform_ops *ops;
+	struct spi_desc *spi;
+	uint64_t start;
+	char label[32];
+	int32_t ret;
+
+	memset(model, 0, sizeof(*model));
+	model->regs[TALISE_ADDR_SPI_INTERFACE_CONFIG_B] = 0x80;
+	model->regs[TALISE_ADDR_VENDOR_ID_0] = 0x56;
+	model->regs[TALISE_ADDR_VENDOR_ID_1] = 0x04;
+	model->regs[TALISE_ADDR_SCRATCH_PAD_READ_ONLY_UPPER_ADDRESS_SPACE] = 0xA5;
+
+	if (ADIHAL_openHw(&hal, 100) != ADIHAL_OK)
+		return FAILURE;
+	ops = bench_spi_counting_ops(&model->spi);
+	if (!transfer)
+		ops->transfer = NULL;
+	spi = hal.spi_adrv_desc;
+	spi->platform_ops = ops;
+
+	ret = FAILURE;
+	if (TALISE_setSpiSettings(&dev, &spi_settings))
+		goto out;
+
+	snprintf(label, sizeof(label), "talise stream %s", name);
+	start_spi = model->spi;
+	start = bench_now_ns();
+	if (TALISE_loadStreamFromBinary(&dev, stream))
+		goto out;
+	bench_talise_report(label, bench_now_ns() - start, &start_spi);
+
+	snprintf(label, sizeof(label), "talise arm %s", name);
+	start_spi = model->spi;
+	start = bench_now_ns();
+	if (TALISE_writeArmMem(&dev, TALISE_ADDR_ARM_START_PROG_ADDR, arm,
+			       BENCH_TALISE_ARM_SIZE))
+		goto out;
+	bench_talise_report(label, bench_now_ns() - start, &start_spi);
+
+	if (memcmp(model->prog, arm, BENCH_TALISE_ARM_SIZE) ||
+	    memcmp(&model->data[BENCH_TALISE_STREAM_ADDR -
+				TALISE_ADDR_ARM_START_DATA_ADDR],
+		   stream, BENCH_TALISE_STREAM_SIZE)) {
+		printf("talise %s: images corrupted\n", name);
+		goto out;
+	}
+
+	snprintf(label, sizeof(label), "talise readback %s", name);
+	start_spi = model->spi;
+	start = bench_now_ns();
+	ret = bench_talise_verify(&dev, TALISE_ADDR_ARM_START_PROG_ADDR, arm,
+				  BENCH_TALISE_ARM_SIZE);
+	if (ret != SUCCESS) {
+		printf("talise %s: read back failed\n", name);
+		goto out;
+	}
+	bench_talise_report(label, bench_now_ns() - start, &start_spi);
+
+out:
+	spi->platform_ops = &sim_spi_platform_ops;
+	ADIHAL_closeHw(&hal);
+
+	return ret;
+}
+
+/* ADRV9009 images loading, with single register transactions, with SPI
+ * streaming and with SPI streaming on a platform implementing transfer() */
+int32_t bench_talise(void)
+{
+	uint8_t *stream, *arm;
+	uint32_t i, seed;
+	int32_t ret;
+
+	stream = malloc(BENCH_TALISE_STREAM_SIZE);
+	arm = malloc(BENCH_TALISE_ARM_SIZE);
+	ret = -ENOMEM;
+	if (!stream || !arm)
+		goto out;
+
+	seed = 1;
+	for (i = 0; i < BENCH_TALISE_ARM_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		arm[i] = seed >> 16;
+	}
+	for (i = 0; i < BENCH_TALISE_STREAM_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		stream[i] = seed >> 16;
+	}
+	/* Stream image header: image address, stream base address, number of
+	 * streams and image size */
+	for (i = 0; i < 4; i++) {
+		stream[i] = BENCH_TALISE_STREAM_ADDR >> (8 * i);
+		stream[4 + i] = BENCH_TALISE_STREAM_ADDR >> (8 * i);
+	}
+	stream[8] = 16;
+	stream[10] = BENCH_TALISE_STREAM_SIZE & 0xFF;
+	stream[11] = BENCH_TALISE_STREAM_SIZE >> 8;
+
+	ret = bench_talise_run("single", 0, false, stream, arm);
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_talise_run("streamed", 1, false, stream, arm);
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_talise_run("xfer", 1, true, stream, arm);
+out:
+	free(stream);
+	free(arm);
+
+	return ret;
+}
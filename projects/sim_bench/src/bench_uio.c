@@ -0,0 +1,212 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_uio.c
+ *   @brief  Linux axi_io backend on a mock UIO device.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "error.h"
+#include "parameters.h"
+
+/* The Linux backend is built here, next to the sim one, with its functions
+ * renamed. Its UIO devices are files of BENCH_UIO_PATH. */
+#define axi_io_read		uio_axi_io_read
+#define axi_io_write		uio_axi_io_write
+#define axi_io_read_block	uio_axi_io_read_block
+#define axi_io_write_block	uio_axi_io_write_block
+#define axi_io_unmap_all	uio_axi_io_unmap_all
+#define AXI_IO_UIO_PATH		BENCH_UIO_PATH
+#include "axi_io.c"
+
+#include "bench.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Register write of the Linux backend before the mappings were kept: the
+ * device is opened and mapped for each access */
+static int32_t bench_uio_legacy_write(uint32_t base, uint32_t offset,
+				      uint32_t data)
+{
+	char buf[64];
+	int32_t ret = SUCCESS;
+	void *addr;
+	int fd;
+
+	sprintf(buf, BENCH_UIO_PATH"%"PRIu32"", base);
+	fd = open(buf, O_RDWR);
+	if (fd < 0)
+		return FAILURE;
+
+	addr = mmap(NULL, offset + sizeof(data), PROT_READ | PROT_WRITE,
+		    MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		ret = FAILURE;
+		goto close;
+	}
+	*(volatile uint32_t *)((uintptr_t)addr + offset) = data;
+	if (munmap(addr, offset + sizeof(data)) < 0)
+		ret = FAILURE;
+close:
+	close(fd);
+
+	return ret;
+}
+
+static void bench_uio_report(const char *name, uint64_t ns, uint32_t accesses)
+{
+	printf("%-24s %10.3f us/access %10.3f M accesses/s\n", name,
+	       ns / 1000.0 / accesses, accesses * 1000.0 / ns);
+}
+
+/* Check that the device holds the words written by the last pass */
+static int32_t bench_uio_check(int fd, uint32_t pass)
+{
+	uint32_t words[BENCH_UIO_WORDS];
+	uint32_t i;
+
+	if (pread(fd, words, sizeof(words), 0) != sizeof(words))
+		return FAILURE;
+	for (i = 0; i < BENCH_UIO_WORDS; i++)
+		if (words[i] != pass * BENCH_UIO_WORDS + i)
+			return FAILURE;
+
+	return SUCCESS;
+}
+
+/*
+ * Register accesses to a mock UIO device, a file of BENCH_UIO_SIZE bytes in a
+ * tmpfs directory. Passes over BENCH_UIO_WORDS consecutive registers are
+ * written with a device mapping per access, as the backend did, then with
+ * the mapping kept by axi_io_write() and axi_io_write_block(), and read with
+ * axi_io_read().
+ */
+int32_t bench_uio(void)
+{
+	uint32_t words[BENCH_UIO_WORDS];
+	char path[64];
+	uint64_t start;
+	uint32_t i, pass, data;
+	int32_t ret;
+	int fd;
+
+	sprintf(path, BENCH_UIO_PATH"%u", BENCH_UIO_INDEX);
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) {
+		printf("uio: can't create %s\n", path);
+		return FAILURE;
+	}
+	if (ftruncate(fd, BENCH_UIO_SIZE)) {
+		ret = FAILURE;
+		goto out;
+	}
+
+	start = bench_now_ns();
+	for (pass = 0; pass < BENCH_UIO_LEGACY_PASSES; pass++)
+		for (i = 0; i < BENCH_UIO_WORDS; i++) {
+			ret = bench_uio_legacy_write(BENCH_UIO_INDEX, i * 4,
+						     pass * BENCH_UIO_WORDS +
+						     i);
+			if (ret != SUCCESS)
+				goto out;
+		}
+	bench_uio_report("uio legacy write", bench_now_ns() - start,
+			 BENCH_UIO_LEGACY_PASSES * BENCH_UIO_WORDS);
+	ret = bench_uio_check(fd, pass - 1);
+	if (ret != SUCCESS)
+		goto out;
+
+	start = bench_now_ns();
+	for (pass = 0; pass < BENCH_UIO_PASSES; pass++)
+		for (i = 0; i < BENCH_UIO_WORDS; i++) {
+			ret = uio_axi_io_write(BENCH_UIO_INDEX, i * 4,
+					       pass * BENCH_UIO_WORDS + i);
+			if (ret != SUCCESS)
+				goto unmap;
+		}
+	bench_uio_report("uio write", bench_now_ns() - start,
+			 BENCH_UIO_PASSES * BENCH_UIO_WORDS);
+	ret = bench_uio_check(fd, pass - 1);
+	if (ret != SUCCESS)
+		goto unmap;
+
+	start = bench_now_ns();
+	for (pass = 0; pass < BENCH_UIO_PASSES; pass++) {
+		for (i = 0; i < BENCH_UIO_WORDS; i++)
+			words[i] = pass * BENCH_UIO_WORDS + i;
+		ret = uio_axi_io_write_block(BENCH_UIO_INDEX, 0, words,
+					     BENCH_UIO_WORDS);
+		if (ret != SUCCESS)
+			goto unmap;
+	}
+	bench_uio_report("uio write block", bench_now_ns() - start,
+			 BENCH_UIO_PASSES * BENCH_UIO_WORDS);
+	ret = bench_uio_check(fd, pass - 1);
+	if (ret != SUCCESS)
+		goto unmap;
+
+	start = bench_now_ns();
+	for (pass = 0; pass < BENCH_UIO_PASSES; pass++)
+		for (i = 0; i < BENCH_UIO_WORDS; i++) {
+			ret = uio_axi_io_read(BENCH_UIO_INDEX, i * 4, &data);
+			if (ret != SUCCESS)
+				goto unmap;
+			if (data != (BENCH_UIO_PASSES - 1) *
+			    BENCH_UIO_WORDS + i) {
+				ret = FAILURE;
+				goto unmap;
+			}
+		}
+	bench_uio_report("uio read", bench_now_ns() - start,
+			 BENCH_UIO_PASSES * BENCH_UIO_WORDS);
+
+unmap:
+	if (uio_axi_io_unmap_all() != SUCCESS)
+		ret = FAILURE;
+out:
+	close(fd);
+	unlink(path);
+
+	return ret;
+}
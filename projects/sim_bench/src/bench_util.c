@@ -0,0 +1,732 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_util.c
+ *   @brief  SPI layer and utilities of util/.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "error.h"
+#include "util.h"
+#include "spi.h"
+#include "sample_unpack.h"
+#include "crc.h"
+#include "circular_buffer.h"
+#include "fifo.h"
+#include "list.h"
+#include "sim_spi.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Producer thread of the SPSC test */
+struct bench_cb_producer {
+	struct circular_buffer *cb;
+	uint32_t nb_full;
+	/* Set by the consumer when it gives up */
+	volatile bool stop;
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/* Last result of the CRC tests */
+static volatile uint32_t bench_crc_sink;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Register accesses through the SPI layer */
+static int32_t bench_spi(void)
+{
+	static uint8_t regs[BENCH_REGMAP_SIZE];
+	struct sim_spi_regmap regmap = {
+		.regs = regs,
+		.size = BENCH_REGMAP_SIZE
+	};
+	struct sim_spi_init_param sim_param = {
+		.xfer = sim_spi_regmap_xfer,
+		.ctx = &regmap
+	};
+	struct spi_init_param param = {
+		.device_id = SPI_DEVICE_ID,
+		.chip_select = SPI_CS,
+		.mode = SPI_MODE_0,
+		.platform_ops = &sim_spi_platform_ops,
+		.extra = &sim_param
+	};
+	struct spi_desc *spi;
+	uint8_t buf[3];
+	uint64_t start;
+	uint32_t i;
+	int32_t ret;
+
+	ret = spi_init(&spi, &param);
+	if (ret != SUCCESS)
+		return ret;
+
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_ITERATIONS * 100; i++) {
+		buf[0] = (i & 1) ? 0x80 : 0x00;
+		buf[1] = i % BENCH_REGMAP_SIZE;
+		buf[2] = i;
+		ret = spi_write_and_read(spi, buf, sizeof(buf));
+		if (ret != SUCCESS)
+			break;
+	}
+	bench_report("spi_write_and_read", bench_now_ns() - start,
+		     BENCH_ITERATIONS * 100, 0, NULL, 0, 0);
+
+	spi_remove(spi);
+
+	return ret;
+}
+
+/* Unpacking of packed ADC samples */
+static int32_t bench_unpack(uint8_t *packed, uint32_t *samples)
+{
+	static const struct {
+		uint8_t bits;
+		uint32_t flags;
+	} formats[] = {
+		{12, 0}, {14, 0}, {16, SAMPLE_UNPACK_SIGN_EXT},
+		{16, SAMPLE_UNPACK_STATUS}, {18, 0}, {20, 0},
+		{24, SAMPLE_UNPACK_SIGN_EXT}, {26, 0},
+	};
+	uint64_t start;
+	uint32_t i, j;
+	char name[32];
+	int32_t ret;
+
+	for (i = 0; i < BENCH_NB_SAMPLES; i++)
+		packed[i] = i * 7;
+
+	for (i = 0; i < ARRAY_SIZE(formats); i++) {
+		start = bench_now_ns();
+		for (j = 0; j < BENCH_ITERATIONS; j++) {
+			ret = sample_unpack(packed, samples, BENCH_UNPACK_SAMPLES,
+					    formats[i].bits, formats[i].flags);
+			if (ret != SUCCESS)
+				return ret;
+		}
+		sprintf(name, "sample_unpack %u%s", formats[i].bits,
+			formats[i].flags & SAMPLE_UNPACK_STATUS ? "+status" : "");
+		bench_report(name, bench_now_ns() - start, BENCH_ITERATIONS,
+			     (uint64_t)BENCH_UNPACK_SAMPLES * 4 * BENCH_ITERATIONS,
+			     NULL, 0, 0);
+	}
+
+	return SUCCESS;
+}
+
+/* Legacy byte wise CRC of a given width */
+static uint32_t bench_crc_legacy(uint8_t width, uint32_t poly,
+				 const uint8_t *data, uint32_t size,
+				 uint32_t crc)
+{
+	DECLARE_CRC8_TABLE(t8);
+	DECLARE_CRC16_TABLE(t16);
+	DECLARE_CRC24_TABLE(t24);
+	static uint32_t populated[3];
+
+	switch (width) {
+	case 8:
+		if (populated[0] != poly) {
+			crc8_populate_msb(t8, poly);
+			populated[0] = poly;
+		}
+		return crc8(t8, data, size, crc);
+	case 16:
+		if (populated[1] != poly) {
+			crc16_populate_msb(t16, poly);
+			populated[1] = poly;
+		}
+		return crc16(t16, data, size, crc);
+	default:
+		if (populated[2] != poly) {
+			crc24_populate_msb(t24, poly);
+			populated[2] = poly;
+		}
+		return crc24(t24, data, size, crc);
+	}
+}
+
+/* Sliced CRC engine against the byte wise crc8(), crc16() and crc24() */
+static int32_t bench_crc(uint8_t *data)
+{
+	static const struct {
+		const char *name;
+		uint8_t width;
+		uint32_t poly;
+	} polys[] = {
+		{"crc8 ad7124", 8, 0x07},
+		{"crc16 ad7606", 16, 0x755b},
+		{"crc16 adas1000", 16, 0x1021},
+		{"crc24 adas1000", 24, 0x5D6DCB},
+	};
+	static const uint32_t sizes[] = {BENCH_CRC_FRAME_SIZE, BENCH_CRC_SIZE};
+	static const uint8_t slices[] = {1, 4, 8};
+	DECLARE_CRC_TABLE(table, CRC_MAX_SLICES);
+	struct crc_ctx ctx;
+	uint32_t i, j, k, n, iterations;
+	uint32_t ref, crc = 0;
+	uint64_t start;
+	char name[48];
+
+	for (i = 0; i < BENCH_CRC_SIZE; i++)
+		data[i] = i * 13 + (i >> 8);
+
+	for (i = 0; i < ARRAY_SIZE(polys); i++) {
+		/* Bit exact check, including the split and the initial value */
+		for (k = 0; k < ARRAY_SIZE(slices); k++) {
+			table.nb_slices = slices[k];
+			crc_populate_msb(&table, polys[i].width, polys[i].poly);
+			for (n = 0; n < 64; n++) {
+				ref = bench_crc_legacy(polys[i].width, polys[i].poly,
+						       data, n * 7, 0xFFFFFFFF);
+				crc_init(&ctx, &table, 0xFFFFFFFF);
+				crc_update(&ctx, data, n * 3);
+				crc_update(&ctx, data + n * 3, n * 4);
+				if (crc_final(&ctx) != ref) {
+					printf("%s mismatch, %u slices %"PRIu32
+					       " bytes\n", polys[i].name, slices[k],
+					       n * 7);
+					return FAILURE;
+				}
+			}
+		}
+
+		for (j = 0; j < ARRAY_SIZE(sizes); j++) {
+			iterations = BENCH_ITERATIONS * BENCH_CRC_SIZE / sizes[j];
+
+			start = bench_now_ns();
+			for (n = 0; n < iterations; n++)
+				crc ^= bench_crc_legacy(polys[i].width, polys[i].poly,
+							data, sizes[j], crc);
+			sprintf(name, "%s %"PRIu32" legacy", polys[i].name,
+				sizes[j]);
+			bench_report(name, bench_now_ns() - start, iterations,
+				     (uint64_t)sizes[j] * iterations, NULL, 0, 0);
+
+			for (k = 0; k < ARRAY_SIZE(slices); k++) {
+				table.nb_slices = slices[k];
+				crc_populate_msb(&table, polys[i].width,
+						 polys[i].poly);
+				start = bench_now_ns();
+				for (n = 0; n < iterations; n++)
+					crc ^= crc_compute(&table, data, sizes[j],
+							   crc);
+				sprintf(name, "%s %"PRIu32" x%u", polys[i].name,
+					sizes[j], slices[k]);
+				bench_report(name, bench_now_ns() - start,
+					     iterations,
+					     (uint64_t)sizes[j] * iterations,
+					     NULL, 0, 0);
+			}
+		}
+	}
+
+	/* Keep the computations from being optimized out */
+	bench_crc_sink = crc;
+
+	return SUCCESS;
+}
+
+/* UART receive path: BENCH_FIFO_CHUNK bytes received at once by the
+ * interrupt handler, read by BENCH_FIFO_READ bytes, through the element FIFO
+ * (read byte by byte as uart_read() did) and through the circular buffer, the
+ * way uart_ps_rx() and uart_ps_read() use it */
+static int32_t bench_fifo(void)
+{
+	uint8_t chunk[BENCH_FIFO_CHUNK];
+	uint8_t data[BENCH_FIFO_READ];
+	uint8_t storage[BENCH_FIFO_CB_SIZE];
+	struct fifo_element *fifo = NULL;
+	struct circular_buffer *cb;
+	struct cb_region regions[2];
+	uint32_t i, j, k, n, offset, len;
+	uint64_t start;
+	uint8_t next;
+	int32_t ret;
+
+	for (i = 0; i < BENCH_FIFO_CHUNK; i++)
+		chunk[i] = i;
+
+	/* Chunks of BENCH_FIFO_CHUNK bytes, a multiple of 256 keeps the counter
+	 * continuous */
+	start = bench_now_ns();
+	next = 0;
+	offset = 0;
+	for (i = 0; i < BENCH_FIFO_BYTES / BENCH_FIFO_CHUNK; i++) {
+		ret = fifo_insert(&fifo, (char *)chunk, BENCH_FIFO_CHUNK);
+		if (ret != SUCCESS)
+			return ret;
+		for (j = 0; j < BENCH_FIFO_CHUNK; j++) {
+			data[j % BENCH_FIFO_READ] = fifo->data[offset++];
+			if (offset == fifo->len) {
+				offset = 0;
+				fifo = fifo_remove(fifo);
+			}
+			if ((j + 1) % BENCH_FIFO_READ == 0 &&
+			    bench_check_counter(data, BENCH_FIFO_READ, &next))
+				return FAILURE;
+		}
+	}
+	bench_report("fifo element", bench_now_ns() - start,
+		     BENCH_FIFO_BYTES / BENCH_FIFO_READ, BENCH_FIFO_BYTES, NULL,
+		     0, 0);
+
+	ret = cb_init_with_buff(&cb, storage, BENCH_FIFO_CB_SIZE);
+	if (ret != SUCCESS)
+		return ret;
+
+	start = bench_now_ns();
+	next = 0;
+	for (i = 0; i < BENCH_FIFO_BYTES / BENCH_FIFO_CHUNK; i++) {
+		cb_peek_write(cb, regions);
+		for (j = 0, len = 0; j < 2; j++) {
+			n = min(BENCH_FIFO_CHUNK - len, regions[j].size);
+			memcpy(regions[j].buff, chunk + len, n);
+			len += n;
+		}
+		cb_commit_write(cb, len);
+		if (len != BENCH_FIFO_CHUNK) {
+			ret = FAILURE;
+			goto out;
+		}
+
+		cb_size(cb, &len);
+		while (len >= BENCH_FIFO_READ) {
+			cb_peek_read(cb, regions);
+			for (j = 0, k = 0; j < 2; j++) {
+				n = min(BENCH_FIFO_READ - k, regions[j].size);
+				memcpy(data + k, regions[j].buff, n);
+				cb_commit_read(cb, n);
+				k += n;
+			}
+			ret = bench_check_counter(data, BENCH_FIFO_READ, &next);
+			if (ret != SUCCESS)
+				goto out;
+			len -= BENCH_FIFO_READ;
+		}
+	}
+	bench_report("fifo uart cb", bench_now_ns() - start,
+		     BENCH_FIFO_BYTES / BENCH_FIFO_READ, BENCH_FIFO_BYTES, NULL,
+		     0, 0);
+
+	ret = len ? FAILURE : SUCCESS;
+out:
+	cb_remove(cb);
+
+	return ret;
+}
+
+/* Write BENCH_FIFO_BYTES to a circular buffer by BENCH_FIFO_CHUNK bytes and
+ * read them by BENCH_FIFO_READ bytes, with cb_write()/cb_read() or through the
+ * regions of cb_peek_write()/cb_peek_read(), which check the data in place
+ * instead of copying it */
+static int32_t bench_cb_run(const char *name, uint32_t size, bool peek)
+{
+	struct circular_buffer *cb;
+	struct cb_region regions[2];
+	uint8_t chunk[BENCH_FIFO_CHUNK];
+	uint8_t data[BENCH_FIFO_READ];
+	uint32_t i, j, n, len, avail;
+	uint64_t start;
+	uint8_t next;
+	int32_t ret;
+
+	ret = cb_init(&cb, size);
+	if (ret != SUCCESS)
+		return ret;
+
+	for (i = 0; i < BENCH_FIFO_CHUNK; i++)
+		chunk[i] = i;
+
+	start = bench_now_ns();
+	next = 0;
+	for (i = 0; i < BENCH_FIFO_BYTES / BENCH_FIFO_CHUNK; i++) {
+		if (!peek) {
+			ret = cb_write(cb, chunk, BENCH_FIFO_CHUNK);
+			if (ret != SUCCESS)
+				goto out;
+			cb_size(cb, &avail);
+			while (avail >= BENCH_FIFO_READ) {
+				ret = cb_read(cb, data, BENCH_FIFO_READ);
+				if (ret != SUCCESS)
+					goto out;
+				ret = bench_check_counter(data, BENCH_FIFO_READ, &next);
+				if (ret != SUCCESS)
+					goto out;
+				avail -= BENCH_FIFO_READ;
+			}
+			continue;
+		}
+
+		cb_peek_write(cb, regions);
+		if (regions[0].size + regions[1].size < BENCH_FIFO_CHUNK) {
+			ret = FAILURE;
+			goto out;
+		}
+		n = min(regions[0].size, (uint32_t)BENCH_FIFO_CHUNK);
+		memcpy(regions[0].buff, chunk, n);
+		memcpy(regions[1].buff, chunk + n, BENCH_FIFO_CHUNK - n);
+		cb_commit_write(cb, BENCH_FIFO_CHUNK);
+
+		/* Same reads as cb_read(), checking the data in place */
+		cb_size(cb, &avail);
+		while (avail >= BENCH_FIFO_READ) {
+			cb_peek_read(cb, regions);
+			for (j = 0, n = 0; j < 2; j++) {
+				len = min(BENCH_FIFO_READ - n, regions[j].size);
+				ret = bench_check_counter(regions[j].buff, len,
+						       &next);
+				if (ret != SUCCESS)
+					goto out;
+				n += len;
+			}
+			cb_commit_read(cb, BENCH_FIFO_READ);
+			avail -= BENCH_FIFO_READ;
+		}
+	}
+	bench_report(name, bench_now_ns() - start,
+		     BENCH_FIFO_BYTES / BENCH_FIFO_READ, BENCH_FIFO_BYTES, NULL,
+		     0, 0);
+
+	cb_size(cb, &avail);
+	ret = avail ? FAILURE : SUCCESS;
+out:
+	cb_remove(cb);
+
+	return ret;
+}
+
+/* Byte at a position of the SPSC stream, differs for positions 256 apart */
+static inline uint8_t bench_cb_byte(uint32_t pos)
+{
+	return pos ^ (pos >> 8) ^ (pos >> 16);
+}
+
+/* Byte n of the two regions of cb_peek_write() or cb_peek_read() */
+static inline uint8_t *bench_cb_at(struct cb_region *regions, uint32_t n)
+{
+	if (n < regions[0].size)
+		return (uint8_t *)regions[0].buff + n;
+
+	return (uint8_t *)regions[1].buff + n - regions[0].size;
+}
+
+/* Producer thread: odd sized chunks written through cb_peek_write() */
+static void *bench_cb_produce(void *arg)
+{
+	struct bench_cb_producer *producer = arg;
+	struct cb_region regions[2];
+	uint32_t pos, i, n, len;
+
+	for (pos = 0, i = 0; pos < BENCH_CB_SPSC_BYTES && !producer->stop; i++) {
+		cb_peek_write(producer->cb, regions);
+		len = min(BENCH_CB_SPSC_BYTES - pos,
+			  1 + i * 37 % BENCH_CB_SPSC_CHUNK);
+		len = min(len, regions[0].size + regions[1].size);
+		if (!len) {
+			producer->nb_full++;
+			sched_yield();
+			continue;
+		}
+
+		for (n = 0; n < len; n++)
+			*bench_cb_at(regions, n) = bench_cb_byte(pos + n);
+		cb_commit_write(producer->cb, len);
+		pos += len;
+
+		/* Vary the fill level even when the threads share a core */
+		if (i % 3 == 0)
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+/*
+ * Circular buffer shared by a producer and a consumer thread. The consumer
+ * alternates cb_read() and cb_peek_read() with odd sizes, so that the
+ * accesses cross the end of the buffer at every offset, and checks each byte.
+ */
+static int32_t bench_cb_spsc(void)
+{
+	struct bench_cb_producer producer = { 0 };
+	struct cb_region regions[2];
+	uint8_t data[BENCH_CB_SPSC_CHUNK];
+	uint32_t pos, i, n, len, avail, nb_empty = 0;
+	pthread_t thread;
+	uint64_t start;
+	int32_t ret;
+
+	ret = cb_init(&producer.cb, BENCH_FIFO_CB_SIZE);
+	if (ret != SUCCESS)
+		return ret;
+
+	start = bench_now_ns();
+	if (pthread_create(&thread, NULL, bench_cb_produce, &producer)) {
+		cb_remove(producer.cb);
+		return FAILURE;
+	}
+
+	for (pos = 0, i = 0; pos < BENCH_CB_SPSC_BYTES; i++) {
+		ret = cb_size(producer.cb, &avail);
+		if (ret != SUCCESS)
+			break;
+		len = min(avail, 1 + i * 53 % BENCH_CB_SPSC_CHUNK);
+		if (!len) {
+			nb_empty++;
+			sched_yield();
+			continue;
+		}
+
+		if (i % 2) {
+			ret = cb_read(producer.cb, data, len);
+			if (ret != SUCCESS)
+				break;
+			for (n = 0; n < len; n++)
+				if (data[n] != bench_cb_byte(pos + n))
+					break;
+		} else {
+			ret = cb_peek_read(producer.cb, regions);
+			if (ret != SUCCESS)
+				break;
+			for (n = 0; n < len; n++)
+				if (*bench_cb_at(regions, n) != bench_cb_byte(pos + n))
+					break;
+			cb_commit_read(producer.cb, n);
+		}
+		if (n != len) {
+			printf("cb spsc: wrong byte at %"PRIu32"\n", pos + n);
+			ret = FAILURE;
+			break;
+		}
+		pos += len;
+
+		if (i % 5 == 0)
+			sched_yield();
+	}
+
+	producer.stop = true;
+	pthread_join(thread, NULL);
+
+	bench_report("cb spsc 2 threads", bench_now_ns() - start, i,
+		     BENCH_CB_SPSC_BYTES, NULL, 0, 0);
+	printf("%-24s %"PRIu32" full, %"PRIu32" empty\n", "",
+	       producer.nb_full, nb_empty);
+	cb_remove(producer.cb);
+
+	return ret;
+}
+
+/* Circular buffer with and without the power of 2 arithmetic */
+static int32_t bench_cb(void)
+{
+	int32_t ret;
+
+	ret = bench_cb_run("cb non pow2", BENCH_FIFO_CB_SIZE - 24, false);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_cb_run("cb pow2", BENCH_FIFO_CB_SIZE, false);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_cb_run("cb pow2 peek", BENCH_FIFO_CB_SIZE, true);
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_cb_spsc();
+}
+
+/* Compare the list items, which are keys */
+static int32_t bench_list_cmp(void *data1, void *data2)
+{
+	uint32_t a = *(uint32_t *)data1;
+	uint32_t b = *(uint32_t *)data2;
+
+	return (a > b) - (a < b);
+}
+
+/* Add, find and remove the keys, checking the order of the list */
+static int32_t bench_list_run(const char *type, struct list_desc *list,
+			      uint32_t *keys)
+{
+	uint32_t i, size, prev;
+	uint64_t start;
+	char name[48];
+	void *data;
+
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_LIST_SIZE; i++)
+		if (list_add_find(list, &keys[i]) != SUCCESS)
+			return FAILURE;
+	sprintf(name, "list %s add", type);
+	bench_report(name, bench_now_ns() - start, BENCH_LIST_SIZE, 0, NULL, 0,
+		     0);
+
+	list_get_size(list, &size);
+	if (size != BENCH_LIST_SIZE)
+		return FAILURE;
+	prev = 0;
+	for (i = 0; i < size; i++) {
+		list_read_idx(list, &data, i);
+		if (*(uint32_t *)data < prev) {
+			printf("list %s: out of order at %"PRIu32"\n", type, i);
+			return FAILURE;
+		}
+		prev = *(uint32_t *)data;
+	}
+
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_LIST_SIZE; i++)
+		if (list_read_find(list, &data, &keys[i]) != SUCCESS ||
+		    *(uint32_t *)data != keys[i])
+			return FAILURE;
+	sprintf(name, "list %s find", type);
+	bench_report(name, bench_now_ns() - start, BENCH_LIST_SIZE, 0, NULL, 0,
+		     0);
+
+	start = bench_now_ns();
+	for (i = 0; i < BENCH_LIST_SIZE; i++)
+		if (list_get_find(list, &data, &keys[i]) != SUCCESS)
+			return FAILURE;
+	sprintf(name, "list %s remove", type);
+	bench_report(name, bench_now_ns() - start, BENCH_LIST_SIZE, 0, NULL, 0,
+		     0);
+
+	list_get_size(list, &size);
+
+	return size ? FAILURE : SUCCESS;
+}
+
+/* Ordered insertion into a linear list, and into a priority list with and
+ * without an element pool */
+static int32_t bench_list(void)
+{
+	struct list_desc *list;
+	uint32_t *keys;
+	uint32_t i, x;
+	int32_t ret;
+
+	keys = malloc(BENCH_LIST_SIZE * sizeof(*keys));
+	if (!keys)
+		return FAILURE;
+	x = 1;
+	for (i = 0; i < BENCH_LIST_SIZE; i++) {
+		x = x * 1664525 + 1013904223;
+		keys[i] = x >> 8;
+	}
+
+	ret = list_init(&list, LIST_DEFAULT, bench_list_cmp);
+	if (ret != SUCCESS)
+		goto out;
+	ret = bench_list_run("linear", list, keys);
+	list_remove(list);
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = list_init(&list, LIST_PRIORITY_LIST, bench_list_cmp);
+	if (ret != SUCCESS)
+		goto out;
+	ret = bench_list_run("index", list, keys);
+	list_remove(list);
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = list_init_pool(&list, LIST_PRIORITY_LIST, bench_list_cmp, NULL,
+			     BENCH_LIST_SIZE);
+	if (ret != SUCCESS)
+		goto out;
+	ret = bench_list_run("index pool", list, keys);
+	list_remove(list);
+out:
+	free(keys);
+
+	return ret;
+}
+
+/* SPI layer, sample unpacking, CRC, FIFO, circular buffer and lists */
+int32_t bench_util(void)
+{
+	uint8_t *buff;
+	int32_t ret;
+
+	/* Packed samples, then the unpacked ones */
+	buff = malloc(BENCH_UNPACK_SAMPLES * sizeof(uint32_t) * 2);
+	if (!buff)
+		return -ENOMEM;
+
+	ret = bench_spi();
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_unpack(buff, (uint32_t *)buff + BENCH_UNPACK_SAMPLES);
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_crc(buff);
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_fifo();
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_cb();
+	if (ret != SUCCESS)
+		goto out;
+
+	ret = bench_list();
+out:
+	free(buff);
+
+	return ret;
+}
@@ -0,0 +1,446 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_wifi.c
+ *   @brief  AT parser and wifi layer against a simulated ESP8266 module.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+/* posix_openpt() and ptsname() */
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "error.h"
+#include "util.h"
+#include "irq.h"
+#include "uart.h"
+#include "circular_buffer.h"
+#include "at_parser.h"
+#include "wifi.h"
+#include "sim_delay.h"
+#include "sim_irq.h"
+#include "sim_uart.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* ESP8266 module simulated on the master side of a pseudo terminal */
+struct bench_at_module {
+	int		fd;
+	/* Command being received */
+	char		cmd[32];
+	uint32_t	cmd_len;
+	/* Data not yet written to the pseudo terminal */
+	uint8_t		out[4096];
+	uint32_t	out_start;
+	uint32_t	out_len;
+	/* Payload left to send, by +IPD messages of packet bytes */
+	uint32_t	packet;
+	uint32_t	to_stream;
+	uint8_t		next;
+};
+
+/* AT parser receiving from the simulated module */
+struct bench_at {
+	struct bench_at_module	module;
+	/* Pseudo terminal, interrupt controller and UART of the parser */
+	int			slave;
+	struct irq_ctrl_desc	*irq;
+	struct uart_desc	*uart;
+	/* Parser, or wifi layer above it */
+	struct at_desc		*at;
+	struct wifi_desc	*wifi;
+	/* Buffer given to connection 0 and the same once it is opened */
+	struct circular_buffer	*conn_cb;
+	struct circular_buffer	*cb;
+	/* Data passed to at_rx() instead of read by the parser */
+	bool			chunks;
+	/* Next payload byte and payload received */
+	uint8_t			next;
+	uint64_t		received;
+	int32_t			error;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* newlib extension used by the AT parser, missing from the host C library.
+ * Only base 10 is used. */
+char *itoa(int value, char *str, int base)
+{
+	sprintf(str, "%d", value);
+
+	return str;
+}
+
+/* Queue data sent by the simulated module */
+static int32_t bench_at_module_out(struct bench_at_module *module,
+				   const void *data, uint32_t len)
+{
+	if (module->out_start) {
+		memmove(module->out, module->out + module->out_start,
+			module->out_len);
+		module->out_start = 0;
+	}
+	if (module->out_len + len > sizeof(module->out))
+		return FAILURE;
+
+	memcpy(module->out + module->out_len, data, len);
+	module->out_len += len;
+
+	return SUCCESS;
+}
+
+/* Answer a command received by the simulated module */
+static void bench_at_module_cmd(struct bench_at_module *module)
+{
+	static const char *ok = "\r\nOK\r\n";
+	const char *cmd = module->cmd;
+
+	if (!strcmp(cmd, "ATE0") || !strcmp(cmd, "AT") ||
+	    !strcmp(cmd, "AT+CWMODE=1") || !strcmp(cmd, "AT+CIPMUX=1") ||
+	    !strcmp(cmd, "AT+CWQAP")) {
+		bench_at_module_out(module, ok, strlen(ok));
+	} else if (!strcmp(cmd, "AT+RST")) {
+		bench_at_module_out(module, ok, strlen(ok));
+		bench_at_module_out(module, "\r\nready\r\n", 9);
+	} else if (!strcmp(cmd, "AT+CIPMUX?")) {
+		bench_at_module_out(module, "+CIPMUX:1\r\n", 11);
+		bench_at_module_out(module, ok, strlen(ok));
+	} else {
+		bench_at_module_out(module, "\r\nERROR\r\n", 9);
+	}
+}
+
+/* Run the simulated ESP8266 module on the master side of the pseudo terminal:
+ * answer the commands and stream the payload of connection 0 as +IPD
+ * messages of module->packet bytes, the payload being a counter */
+static void bench_at_module_step(struct bench_at_module *module)
+{
+	char header[32];
+	uint32_t i, len;
+	ssize_t ret;
+	char ch;
+
+	while (read(module->fd, &ch, 1) == 1) {
+		if (ch == '\r')
+			continue;
+		if (ch != '\n') {
+			if (module->cmd_len < sizeof(module->cmd) - 1)
+				module->cmd[module->cmd_len++] = ch;
+			continue;
+		}
+		module->cmd[module->cmd_len] = '\0';
+		module->cmd_len = 0;
+		bench_at_module_cmd(module);
+	}
+
+	while (module->to_stream) {
+		len = min(module->packet, module->to_stream);
+		i = sprintf(header, "\r\n+IPD,0,%"PRIu32":", len);
+		if (module->out_len + i + len > sizeof(module->out))
+			break;
+		bench_at_module_out(module, header, i);
+		for (i = 0; i < len; i++)
+			module->out[module->out_len++] = module->next++;
+		module->to_stream -= len;
+	}
+
+	if (module->out_len) {
+		ret = write(module->fd, module->out + module->out_start,
+			    module->out_len);
+		if (ret > 0) {
+			module->out_start += ret;
+			module->out_len -= ret;
+		}
+	}
+}
+
+/* Move the data received from the module to the parser, then read the
+ * connection buffer and check it. Called on each delay as well. */
+static void bench_at_step(void *ctx)
+{
+	struct bench_at *bench = ctx;
+	uint8_t data[BENCH_AT_CHUNK];
+	uint32_t avail;
+	int32_t len;
+
+	bench_at_module_step(&bench->module);
+
+	if (bench->chunks) {
+		do {
+			len = sim_uart_idle_read(bench->uart, data,
+						 BENCH_AT_CHUNK);
+			if (len <= 0)
+				break;
+			if (bench->wifi)
+				wifi_rx(bench->wifi, data, len);
+			else
+				at_rx(bench->at, data, len);
+		} while (len == BENCH_AT_CHUNK);
+	} else {
+		sim_uart_poll(bench->uart);
+	}
+
+	if (!bench->cb)
+		return;
+	cb_size(bench->cb, &avail);
+	while (avail) {
+		len = min(avail, (uint32_t)BENCH_AT_CHUNK);
+		if (cb_read(bench->cb, data, len) != SUCCESS ||
+		    bench_check_counter(data, len, &bench->next) != SUCCESS)
+			bench->error = FAILURE;
+		bench->received += len;
+		avail -= len;
+	}
+}
+
+/* Connections opened by the simulated module */
+static void bench_at_connection(void *ctx, enum at_event event,
+				uint32_t conn_id, struct circular_buffer **cb)
+{
+	struct bench_at *bench = ctx;
+
+	if (conn_id != 0)
+		return;
+
+	if (event == AT_NEW_CONNECTION) {
+		*cb = bench->conn_cb;
+		bench->cb = bench->conn_cb;
+	} else {
+		bench->cb = NULL;
+	}
+}
+
+/* Connect a UART, interrupting on BENCH_AT_IRQ_ID, to the simulated module
+ * through a pseudo terminal */
+static int32_t bench_at_open(struct bench_at *bench)
+{
+	struct irq_init_param irq_param = { 0 };
+	struct sim_uart_init_param sim_uart_param = { 0 };
+	struct uart_init_param uart_param = {
+		.baud_rate = 115200,
+		.size = UART_CS_8,
+		.parity = UART_PAR_NO,
+		.stop = UART_STOP_1,
+		.extra = &sim_uart_param
+	};
+	int32_t ret;
+	int master, flags;
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0)
+		return FAILURE;
+	if (grantpt(master) || unlockpt(master))
+		goto close_master;
+	bench->slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (bench->slave < 0)
+		goto close_master;
+	flags = fcntl(master, F_GETFL);
+	if (flags < 0 || fcntl(master, F_SETFL, flags | O_NONBLOCK))
+		goto close_slave;
+
+	ret = irq_ctrl_init(&bench->irq, &irq_param);
+	if (ret != SUCCESS)
+		goto close_slave;
+	irq_global_enable(bench->irq);
+
+	sim_uart_param.fd = bench->slave;
+	sim_uart_param.irq_desc = bench->irq;
+	sim_uart_param.irq_id = BENCH_AT_IRQ_ID;
+	ret = uart_init(&bench->uart, &uart_param);
+	if (ret != SUCCESS)
+		goto free_irq;
+
+	bench->module.fd = master;
+	sim_delay_set_hook(bench_at_step, bench);
+
+	return SUCCESS;
+
+free_irq:
+	irq_ctrl_remove(bench->irq);
+close_slave:
+	close(bench->slave);
+close_master:
+	close(master);
+
+	return FAILURE;
+}
+
+/* Free what bench_at_open() allocated */
+static void bench_at_close(struct bench_at *bench)
+{
+	sim_delay_set_hook(NULL, NULL);
+	uart_remove(bench->uart);
+	irq_ctrl_remove(bench->irq);
+	close(bench->slave);
+	close(bench->module.fd);
+}
+
+/* Receive BENCH_AT_BYTES from a connection of the simulated module, with the
+ * parser reading the UART from its interrupt or fed with chunks by at_rx() */
+static int32_t bench_at_run(const char *name, uint32_t packet, bool chunks)
+{
+	struct at_init_param at_param = { 0 };
+	struct bench_at *bench;
+	uint64_t start;
+	int32_t ret;
+
+	bench = calloc(1, sizeof(*bench));
+	if (!bench)
+		return -ENOMEM;
+
+	ret = cb_init(&bench->conn_cb, BENCH_AT_CB_SIZE);
+	if (ret != SUCCESS)
+		goto free_bench;
+
+	bench->module.packet = packet;
+	bench->chunks = chunks;
+	ret = bench_at_open(bench);
+	if (ret != SUCCESS)
+		goto free_cb;
+
+	at_param.uart_desc = bench->uart;
+	at_param.irq_desc = chunks ? NULL : bench->irq;
+	at_param.uart_irq_id = BENCH_AT_IRQ_ID;
+	at_param.callback_ctx = bench;
+	at_param.connection_callback = bench_at_connection;
+	ret = at_init(&bench->at, &at_param);
+	if (ret != SUCCESS)
+		goto close;
+	if (chunks) {
+		ret = at_start(bench->at);
+		if (ret != SUCCESS)
+			goto remove;
+	}
+
+	/* The module connects and sends the payload */
+	bench_at_module_out(&bench->module, "0,CONNECT\r\n", 11);
+	bench->module.to_stream = BENCH_AT_BYTES;
+	start = bench_now_ns();
+	while (bench->received < BENCH_AT_BYTES && !bench->error)
+		bench_at_step(bench);
+	bench_report(name, bench_now_ns() - start,
+		     BENCH_AT_BYTES / packet, BENCH_AT_BYTES, NULL, 0, 0);
+
+	/* The parser still answers commands, without errors */
+	ret = bench->error;
+	if (ret == SUCCESS)
+		ret = at_run_cmd(bench->at, AT_ATTENTION, AT_EXECUTE_OP, NULL);
+
+remove:
+	at_remove(bench->at);
+close:
+	bench_at_close(bench);
+free_cb:
+	cb_remove(bench->conn_cb);
+free_bench:
+	free(bench);
+
+	return ret;
+}
+
+/* Initialize the wifi layer with the data received in chunks: wifi_init()
+ * does not wait for the module and wifi_start() configures it through
+ * wifi_rx() */
+static int32_t bench_at_wifi(void)
+{
+	struct wifi_init_param wifi_param = { 0 };
+	struct bench_at *bench;
+	int32_t ret;
+
+	bench = calloc(1, sizeof(*bench));
+	if (!bench)
+		return -ENOMEM;
+
+	bench->chunks = true;
+	ret = bench_at_open(bench);
+	if (ret != SUCCESS)
+		goto free_bench;
+
+	/* Nothing is received until wifi_init() returns */
+	sim_delay_set_hook(NULL, NULL);
+	wifi_param.uart_desc = bench->uart;
+	ret = wifi_init(&bench->wifi, &wifi_param);
+	if (ret != SUCCESS)
+		goto close;
+
+	sim_delay_set_hook(bench_at_step, bench);
+	ret = wifi_start(bench->wifi);
+	if (ret != SUCCESS)
+		printf("wifi_start failed\n");
+
+	wifi_remove(bench->wifi);
+close:
+	bench_at_close(bench);
+free_bench:
+	free(bench);
+
+	return ret;
+}
+
+/* Payload of a connection received by the AT parser through a pseudo
+ * terminal, in small and in full size +IPD messages */
+int32_t bench_wifi(void)
+{
+	int32_t ret;
+
+	ret = bench_at_wifi();
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_at_run("at irq 64", 64, false);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_at_run("at chunks 64", 64, true);
+	if (ret != SUCCESS)
+		return ret;
+
+	ret = bench_at_run("at irq 1460", 1460, false);
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_at_run("at chunks 1460", 1460, true);
+}
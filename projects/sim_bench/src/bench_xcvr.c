@@ -0,0 +1,626 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/bench_xcvr.c
+ *   @brief  Xilinx transceiver PLL solver and ADXCVR driver on a model of the core.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "axi_adxcvr.h"
+#include "xilinx_transceiver.h"
+#include "sim_axi_io.h"
+#include "parameters.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* DRP registers of the transceiver lanes and of their QPLLs */
+struct bench_xcvr_model {
+	struct sim_axi_region region;
+	uint32_t regs[0x200 / 4];
+	uint16_t common[BENCH_XCVR_LANES][0x1000];
+	uint16_t channel[BENCH_XCVR_LANES][0x1000];
+	uint32_t nb_drp_reads;
+	uint32_t nb_drp_writes;
+};
+
+/* Reference PLL search: the first setting and the best ranked one */
+struct bench_xcvr_ref {
+	uint32_t nb_found;
+	uint32_t m, n1, n2, n, band, d;
+	uint32_t best_margin_khz;
+	uint32_t best_pfd_khz;
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/*
+ * ADXCVR model: a DRP access completes when its control register is written,
+ * writes with the 0xff port select go to all the ports.
+ */
+static int32_t bench_xcvr_write(struct sim_axi_region *region,
+				uint32_t offset, uint32_t data)
+{
+	struct bench_xcvr_model *model = region->ctx;
+	uint16_t (*drp)[0x1000];
+	uint32_t sel, reg, i;
+
+	region->regs[offset / 4] = data;
+
+	/* DRP control registers of the common and channel interfaces */
+	if (offset == 0x44)
+		drp = model->common;
+	else if (offset == 0x64)
+		drp = model->channel;
+	else
+		return SUCCESS;
+
+	sel = region->regs[(offset - 4) / 4];
+	reg = (data >> 16) & 0xFFF;
+
+	if (data & (1 << 28)) {
+		model->nb_drp_writes++;
+		for (i = 0; i < BENCH_XCVR_LANES; i++)
+			if (sel == 0xFF || sel == i)
+				drp[i][reg] = data & 0xFFFF;
+	} else {
+		model->nb_drp_reads++;
+		region->regs[(offset + 4) / 4] = sel < BENCH_XCVR_LANES ?
+						 drp[sel][reg] : 0;
+	}
+
+	return SUCCESS;
+}
+
+/*
+ * Print the DRP accesses of a transceiver operation, returns FAILURE if the
+ * driver counted other ones since its last adxcvr_drp_stats_reset()
+ */
+static int32_t bench_xcvr_report(const char *name, uint64_t ns,
+				 struct adxcvr *xcvr,
+				 struct bench_xcvr_model *model,
+				 const struct bench_xcvr_model *start)
+{
+	uint32_t reads = model->nb_drp_reads - start->nb_drp_reads;
+	uint32_t writes = model->nb_drp_writes - start->nb_drp_writes;
+
+	bench_report(name, ns, 1, 0, &model->region, start->region.nb_reads,
+		     start->region.nb_writes);
+	printf("%-24s %6"PRIu32" DRP rd %6"PRIu32" DRP wr\n", "", reads,
+	       writes);
+
+	if (xcvr->drp_stats.reads != reads || xcvr->drp_stats.writes != writes) {
+		printf("%s: drp_stats %"PRIu32" rd %"PRIu32" wr\n", name,
+		       xcvr->drp_stats.reads, xcvr->drp_stats.writes);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/* JESD204 RX transceiver bring-up and lane rate changes */
+static int32_t bench_xcvr_drp(void)
+{
+	static const struct xcvr_types {
+		const char *name;
+		enum xilinx_xcvr_type type;
+	} types[] = {
+		{"gtx2", XILINX_XCVR_TYPE_S7_GTX2},
+		{"gth4", XILINX_XCVR_TYPE_US_GTH4},
+	};
+	static const struct sim_axi_region_ops ops = {
+		.write = bench_xcvr_write
+	};
+	struct adxcvr_init init = {
+		.name = "sim-xcvr",
+		.base = RX_XCVR_BASEADDR,
+		.sys_clk_sel = 3,
+		.out_clk_sel = 4,
+		.cpll_enable = false,
+		.lpm_enable = true,
+		.lane_rate_khz = BENCH_XCVR_RATE0_KHZ,
+		.ref_rate_khz = BENCH_XCVR_REFCLK_KHZ
+	};
+	struct bench_xcvr_model *model, start_model;
+	struct adxcvr *xcvr;
+	uint32_t i, broadcast;
+	uint64_t start;
+	char name[48];
+	int32_t ret;
+
+	model = calloc(1, sizeof(*model));
+	if (!model)
+		return FAILURE;
+
+	model->region.base = RX_XCVR_BASEADDR;
+	model->region.size = sizeof(model->regs);
+	model->region.regs = model->regs;
+	model->region.ops = &ops;
+	model->region.ctx = model;
+	model->regs[AXI_REG_VERSION / 4] = AXI_PCORE_VER(0x11, 0, 'a');
+	model->regs[AXI_REG_FPGA_INFO / 4] = AXI_FPGA_SPEED_2 << 8;
+	model->regs[AXI_REG_FPGA_VOLTAGE / 4] = 850;
+	model->regs[0x14 / 4] = 1;
+
+	ret = sim_axi_add_region(&model->region);
+	if (ret != SUCCESS)
+		goto out;
+
+	for (i = 0; i < ARRAY_SIZE(types); i++) {
+		for (broadcast = 0; broadcast < 2; broadcast++) {
+			memset(model->common, 0, sizeof(model->common));
+			memset(model->channel, 0, sizeof(model->channel));
+			model->regs[0x24 / 4] = BENCH_XCVR_LANES |
+						(types[i].type << 16);
+
+			start_model = *model;
+			start = bench_now_ns();
+			ret = adxcvr_init(&xcvr, &init);
+			if (ret != SUCCESS)
+				goto out;
+			if (broadcast) {
+				sprintf(name, "%s adxcvr_init", types[i].name);
+				ret = bench_xcvr_report(name, bench_now_ns() - start,
+							xcvr, model, &start_model);
+				if (ret != SUCCESS)
+					goto remove;
+			}
+
+			/* A core version 0x11 model, which does broadcast */
+			if (!xcvr->drp_broadcast) {
+				ret = FAILURE;
+				goto remove;
+			}
+			xcvr->drp_broadcast = broadcast;
+
+			adxcvr_drp_stats_reset(xcvr);
+			start_model = *model;
+			start = bench_now_ns();
+			ret = adxcvr_clk_set_rate(xcvr, BENCH_XCVR_RATE1_KHZ,
+						  BENCH_XCVR_REFCLK_KHZ);
+			if (ret != SUCCESS)
+				goto remove;
+			sprintf(name, "%s set rate%s", types[i].name,
+				broadcast ? " bcast" : "");
+			ret = bench_xcvr_report(name, bench_now_ns() - start, xcvr,
+						model, &start_model);
+			if (ret != SUCCESS)
+				goto remove;
+
+			adxcvr_drp_stats_reset(xcvr);
+			start_model = *model;
+			start = bench_now_ns();
+			ret = adxcvr_clk_set_rate(xcvr, BENCH_XCVR_RATE1_KHZ,
+						  BENCH_XCVR_REFCLK_KHZ);
+			if (ret != SUCCESS)
+				goto remove;
+			sprintf(name, "%s same rate%s", types[i].name,
+				broadcast ? " bcast" : "");
+			ret = bench_xcvr_report(name, bench_now_ns() - start, xcvr,
+						model, &start_model);
+			if (ret != SUCCESS)
+				goto remove;
+
+			adxcvr_remove(xcvr);
+		}
+	}
+
+	sim_axi_remove_region(&model->region);
+	free(model);
+
+	return SUCCESS;
+
+remove:
+	adxcvr_remove(xcvr);
+	sim_axi_remove_region(&model->region);
+out:
+	free(model);
+
+	return ret;
+}
+
+/* VCO ranges of the solver before the plans, copied from it */
+static void bench_xcvr_ref_range(struct xilinx_xcvr *xcvr, uint32_t *cpll,
+				 uint32_t *qpll)
+{
+	bool us = xcvr->type != XILINX_XCVR_TYPE_S7_GTX2;
+	bool ver = AXI_PCORE_VER_MAJOR(xcvr->version) > 0x10;
+
+	cpll[0] = us ? 2000000 : 1600000;
+	cpll[1] = us ? 6250000 : 3300000;
+	qpll[0] = us ? 9800000 : 5930000;
+	qpll[1] = us ? 16375000 : 8000000;
+	qpll[2] = us ? qpll[0] : 9800000;
+	qpll[3] = us ? qpll[1] : 12500000;
+
+	if (!ver)
+		return;
+
+	if (us) {
+		if (xcvr->voltage < 850 || (xcvr->speed_grade / 10) == 1)
+			cpll[1] = 4250000;
+		qpll[2] = 8000000;
+		qpll[3] = 13000000;
+		if ((xcvr->speed_grade / 10) == 1) {
+			qpll[1] = 12500000;
+			qpll[3] = qpll[1];
+		}
+		if (xcvr->voltage == 720) {
+			if ((xcvr->speed_grade / 10) == 2)
+				qpll[1] = 12500000;
+			else if ((xcvr->speed_grade / 10) == 1)
+				qpll[1] = 10312500;
+			qpll[3] = qpll[1];
+		}
+	} else {
+		if (xcvr->dev_package == AXI_FPGA_DEV_FB ||
+		    xcvr->dev_package == AXI_FPGA_DEV_SB)
+			qpll[1] = 6600000;
+		if ((xcvr->speed_grade / 10) == 2)
+			qpll[3] = 10312500;
+	}
+}
+
+static void bench_xcvr_ref_rank(struct bench_xcvr_ref *ref, uint32_t vco,
+				uint32_t vco_min, uint32_t vco_max,
+				uint32_t pfd)
+{
+	uint32_t margin = min(vco - vco_min, vco_max - vco);
+
+	if (ref->nb_found++ && (margin < ref->best_margin_khz ||
+				(margin == ref->best_margin_khz &&
+				 pfd <= ref->best_pfd_khz)))
+		return;
+
+	ref->best_margin_khz = margin;
+	ref->best_pfd_khz = pfd;
+}
+
+static void bench_xcvr_ref_cpll(const uint32_t *range, uint32_t refclk,
+				uint32_t rate, struct bench_xcvr_ref *ref)
+{
+	uint32_t n1, n2, d, m, vco;
+
+	memset(ref, 0, sizeof(*ref));
+
+	for (m = 1; m <= 2; m++)
+		for (d = 1; d <= 8; d <<= 1)
+			for (n1 = 5; n1 >= 4; n1--)
+				for (n2 = 5; n2 >= 1; n2--) {
+					vco = refclk * n1 * n2 / m;
+					if (vco > range[1] || vco < range[0])
+						continue;
+					if (refclk / m / d != rate / (2 * n1 * n2))
+						continue;
+					if (!ref->nb_found) {
+						ref->m = m;
+						ref->n1 = n1;
+						ref->n2 = n2;
+						ref->d = d;
+					}
+					bench_xcvr_ref_rank(ref, vco, range[0],
+							    range[1], refclk / m);
+				}
+}
+
+static void bench_xcvr_ref_qpll(const uint8_t *N, const uint32_t *range,
+				uint32_t refclk, uint32_t rate,
+				struct bench_xcvr_ref *ref)
+{
+	uint32_t n, d, m, vco, band;
+
+	memset(ref, 0, sizeof(*ref));
+
+	for (m = 1; m <= 4; m++)
+		for (d = 1; d <= 16; d <<= 1)
+			for (n = 0; N[n] != 0; n++) {
+				vco = refclk * N[n] / m;
+				if (vco >= range[2] && vco <= range[3])
+					band = 1;
+				else if (vco >= range[0] && vco <= range[1])
+					band = 0;
+				else
+					continue;
+				if (refclk / m / d != rate / N[n])
+					continue;
+				if (!ref->nb_found) {
+					ref->m = m;
+					ref->n = N[n];
+					ref->band = band;
+					ref->d = d;
+				}
+				bench_xcvr_ref_rank(ref, vco, range[2 * band],
+						    range[2 * band + 1], refclk / m);
+			}
+}
+
+/* Compare a plan with the reference search, returns the mismatches */
+static uint32_t bench_xcvr_pll_compare(const struct xilinx_xcvr_pll_plan *plan,
+				       const struct bench_xcvr_ref *ref,
+				       uint32_t *nb_full)
+{
+	const struct xilinx_xcvr_pll_solution *best;
+
+	best = &plan->solutions[plan->best];
+	if (plan->nb_found > plan->nb_solutions)
+		(*nb_full)++;
+
+	return plan->nb_found != ref->nb_found ||
+	       best->vco_margin_khz != ref->best_margin_khz ||
+	       best->pfd_khz != ref->best_pfd_khz;
+}
+
+/*
+ * Check calc_*_config() and the best ranked solution of the plans against the
+ * reference search, for the lane rates the dividers reach from refclk_khz.
+ */
+static uint32_t bench_xcvr_pll_check_refclk(struct xilinx_xcvr *xcvr,
+		uint32_t refclk_khz,
+		uint32_t *nb_checks,
+		uint32_t *nb_full)
+{
+	static const uint8_t N_gtx2[] = {16, 20, 32, 40, 64, 66, 80, 100, 0};
+	static const uint8_t N_gth34[] = {16, 20, 32, 40, 64, 66, 75, 80, 100,
+					  112, 120, 125, 150, 160, 0
+					 };
+	/* 2 * N1 * N2 of the CPLL and N of the QPLL, over M * D */
+	static const uint8_t mul[] = {2, 4, 6, 8, 10, 12, 16, 20, 24, 30, 32, 40,
+				      50, 64, 66, 75, 80, 100, 112, 120, 125,
+				      150, 160
+				     };
+	static const uint8_t div[] = {1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+	const struct xilinx_xcvr_pll_plan *plan;
+	struct xilinx_xcvr_cpll_config cpll;
+	struct xilinx_xcvr_qpll_config qpll;
+	struct bench_xcvr_ref ref;
+	uint32_t cpll_range[2], qpll_range[4];
+	uint32_t nb_errors = 0;
+	uint32_t k, rate, out_div;
+	const uint8_t *N;
+	int32_t ret;
+
+	bench_xcvr_ref_range(xcvr, cpll_range, qpll_range);
+	N = (xcvr->type == XILINX_XCVR_TYPE_S7_GTX2) ? N_gtx2 : N_gth34;
+
+	/* Each rate and the one above, which the divisions truncate */
+	for (k = 0; k < ARRAY_SIZE(mul) * ARRAY_SIZE(div) * 2; k++) {
+		rate = refclk_khz * mul[k / 2 % ARRAY_SIZE(mul)] /
+		       div[k / 2 / ARRAY_SIZE(mul)] + k % 2;
+		if (rate < 500000 || rate > 32750000)
+			continue;
+
+		bench_xcvr_ref_cpll(cpll_range, refclk_khz, rate, &ref);
+		ret = xilinx_xcvr_calc_cpll_config(xcvr, refclk_khz, rate,
+						   &cpll, &out_div);
+		if ((ret == SUCCESS) != (ref.nb_found != 0))
+			nb_errors++;
+		else if (ret == SUCCESS) {
+			if (cpll.refclk_div != ref.m || cpll.fb_div_N1 != ref.n1 ||
+			    cpll.fb_div_N2 != ref.n2 || out_div != ref.d)
+				nb_errors++;
+			xilinx_xcvr_get_cpll_plan(xcvr, refclk_khz, rate, &plan);
+			nb_errors += bench_xcvr_pll_compare(plan, &ref, nb_full);
+		}
+
+		bench_xcvr_ref_qpll(N, qpll_range, refclk_khz, rate, &ref);
+		ret = xilinx_xcvr_calc_qpll_config(xcvr, refclk_khz, rate,
+						   &qpll, &out_div);
+		if ((ret == SUCCESS) != (ref.nb_found != 0))
+			nb_errors++;
+		else if (ret == SUCCESS) {
+			if (qpll.refclk_div != ref.m || qpll.fb_div != ref.n ||
+			    qpll.band != ref.band || out_div != ref.d)
+				nb_errors++;
+			xilinx_xcvr_get_qpll_plan(xcvr, refclk_khz, rate, &plan);
+			nb_errors += bench_xcvr_pll_compare(plan, &ref, nb_full);
+		}
+
+		*nb_checks += 2;
+	}
+
+	return nb_errors;
+}
+
+/* PLL solver against the reference search, for all the supported devices */
+static int32_t bench_xcvr_pll_check(void)
+{
+	static const enum xilinx_xcvr_type types[] = {
+		XILINX_XCVR_TYPE_S7_GTX2, XILINX_XCVR_TYPE_US_GTH3,
+		XILINX_XCVR_TYPE_US_GTH4, XILINX_XCVR_TYPE_US_GTY4,
+	};
+	static const enum axi_fpga_speed_grade grades[] = {
+		AXI_FPGA_SPEED_1, AXI_FPGA_SPEED_2, AXI_FPGA_SPEED_3,
+	};
+	static const uint32_t voltages[] = {720, 850, 900};
+	static const uint32_t refclks[] = {
+		61440, 100000, 122880, 125000, 153600, 156250, 184320, 200000,
+		245760, 250000, 307200, 312500, 368640, 491520, 500000, 737280,
+	};
+	struct xilinx_xcvr xcvr;
+	uint32_t nb_checks = 0, nb_full = 0, nb_errors = 0;
+	uint32_t i, r, major;
+
+	/* Type, core version, speed grade, voltage and package */
+	for (i = 0; i < ARRAY_SIZE(types) * 2 * ARRAY_SIZE(grades) *
+	     ARRAY_SIZE(voltages) * 2; i++) {
+		major = 0x10 + (i / 4) % 2;
+		memset(&xcvr, 0, sizeof(xcvr));
+		xcvr.type = types[i % ARRAY_SIZE(types)];
+		xcvr.version = AXI_PCORE_VER(major, 0, 'a');
+		xcvr.speed_grade = grades[(i / 8) % ARRAY_SIZE(grades)];
+		xcvr.voltage = voltages[(i / 24) % ARRAY_SIZE(voltages)];
+		xcvr.dev_package = (i / 72) ? AXI_FPGA_DEV_FB : AXI_FPGA_DEV_FF;
+
+		for (r = 0; r < ARRAY_SIZE(refclks); r++)
+			nb_errors += bench_xcvr_pll_check_refclk(&xcvr, refclks[r],
+					&nb_checks,
+					&nb_full);
+	}
+
+	printf("xcvr pll check: %"PRIu32" searches, %"PRIu32
+	       " with a full plan, %"PRIu32" errors\n", nb_checks, nb_full,
+	       nb_errors);
+
+	return nb_errors ? FAILURE : SUCCESS;
+}
+
+/* Transceiver PLL solver, with and without the cached plan */
+static int32_t bench_xcvr_pll(void)
+{
+	static const struct {
+		const char *name;
+		enum xilinx_xcvr_type type;
+	} types[] = {
+		{"gtx2", XILINX_XCVR_TYPE_S7_GTX2},
+		{"gth3", XILINX_XCVR_TYPE_US_GTH3},
+		{"gth4", XILINX_XCVR_TYPE_US_GTH4},
+		{"gty4", XILINX_XCVR_TYPE_US_GTY4},
+	};
+	static const struct {
+		uint32_t refclk_khz;
+		uint32_t lane_rate_khz;
+	} rates[] = {
+		{122880, 2457600},
+		{245760, 4915200},
+		{307200, 6144000},
+		{245760, 9830400},
+		{250000, 10000000},
+	};
+	const struct xilinx_xcvr_pll_plan *plan;
+	const struct xilinx_xcvr_pll_solution *sol;
+	struct xilinx_xcvr xcvr;
+	uint32_t i, j, n;
+	uint64_t start;
+	char name[48];
+	int32_t ret;
+
+	ret = bench_xcvr_pll_check();
+	if (ret != SUCCESS)
+		return ret;
+
+	for (i = 0; i < ARRAY_SIZE(types); i++) {
+		memset(&xcvr, 0, sizeof(xcvr));
+		xcvr.type = types[i].type;
+		xcvr.version = AXI_PCORE_VER(0x11, 0, 'a');
+		xcvr.speed_grade = AXI_FPGA_SPEED_2;
+		xcvr.voltage = 850;
+
+		for (j = 0; j < ARRAY_SIZE(rates); j++) {
+			/* The QPLL covers all the rates, the CPLL the lower ones */
+			ret = xilinx_xcvr_calc_qpll_config(&xcvr, rates[j].refclk_khz,
+							   rates[j].lane_rate_khz,
+							   NULL, NULL);
+			if (ret != SUCCESS) {
+				printf("%s: no QPLL setting for %"PRIu32" kHz\n",
+				       types[i].name, rates[j].lane_rate_khz);
+				return ret;
+			}
+
+			start = bench_now_ns();
+			for (n = 0; n < BENCH_ITERATIONS; n++) {
+				xcvr.qpll_plan.valid = false;
+				xilinx_xcvr_calc_qpll_config(&xcvr, rates[j].refclk_khz,
+							     rates[j].lane_rate_khz,
+							     NULL, NULL);
+			}
+			sprintf(name, "%s qpll %"PRIu32" solve", types[i].name,
+				rates[j].lane_rate_khz);
+			bench_report(name, bench_now_ns() - start,
+				     BENCH_ITERATIONS, 0, NULL, 0, 0);
+
+			start = bench_now_ns();
+			for (n = 0; n < BENCH_ITERATIONS; n++)
+				xilinx_xcvr_calc_qpll_config(&xcvr, rates[j].refclk_khz,
+							     rates[j].lane_rate_khz,
+							     NULL, NULL);
+			sprintf(name, "%s qpll %"PRIu32" cached", types[i].name,
+				rates[j].lane_rate_khz);
+			bench_report(name, bench_now_ns() - start,
+				     BENCH_ITERATIONS, 0, NULL, 0, 0);
+
+			xilinx_xcvr_get_qpll_plan(&xcvr, rates[j].refclk_khz,
+						  rates[j].lane_rate_khz, &plan);
+			sol = &plan->solutions[plan->best];
+			printf("%s qpll %"PRIu32": %"PRIu32" solutions, margin %"
+			       PRIu32" kHz, best %"PRIu32" kHz (M %"PRIu32
+			       " N %"PRIu32" D %"PRIu32")\n", types[i].name,
+			       rates[j].lane_rate_khz, plan->nb_solutions,
+			       plan->solutions[0].vco_margin_khz,
+			       sol->vco_margin_khz, sol->qpll.refclk_div,
+			       sol->qpll.fb_div, sol->out_div);
+
+			if (xilinx_xcvr_get_cpll_plan(&xcvr, rates[j].refclk_khz,
+						      rates[j].lane_rate_khz,
+						      &plan) != SUCCESS)
+				continue;
+
+			sol = &plan->solutions[plan->best];
+			printf("%s cpll %"PRIu32": %"PRIu32" solutions, margin %"
+			       PRIu32" kHz, best %"PRIu32" kHz (M %"PRIu32
+			       " N1 %"PRIu32" N2 %"PRIu32" D %"PRIu32")\n",
+			       types[i].name, rates[j].lane_rate_khz,
+			       plan->nb_solutions,
+			       plan->solutions[0].vco_margin_khz,
+			       sol->vco_margin_khz, sol->cpll.refclk_div,
+			       sol->cpll.fb_div_N1, sol->cpll.fb_div_N2,
+			       sol->out_div);
+		}
+	}
+
+	return SUCCESS;
+}
+
+/* Transceiver PLL solver, then DRP accesses of the ADXCVR driver */
+int32_t bench_xcvr(void)
+{
+	int32_t ret;
+
+	ret = bench_xcvr_pll();
+	if (ret != SUCCESS)
+		return ret;
+
+	return bench_xcvr_drp();
+}
@@ -0,0 +1,137 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/main.c
+ *   @brief  Benchmark of the AXI core drivers on the simulated platform.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "error.h"
+#include "util.h"
+#include "sim_delay.h"
+#include "bench.h"
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Test area, named on the command line */
+struct bench_area {
+	const char	*name;
+	int32_t		(*run)(void);
+};
+
+/******************************************************************************/
+/************************ Variables Definitions *******************************/
+/******************************************************************************/
+
+/* Areas in the order they run */
+static const struct bench_area bench_areas[] = {
+	{"dmac", bench_dmac},
+	{"spi_engine", bench_spi_engine},
+	{"util", bench_util},
+	{"wifi", bench_wifi},
+	{"iio", bench_iio},
+	{"sd", bench_sd},
+	{"xcvr", bench_xcvr},
+	{"ad9361", bench_ad9361},
+	{"talise", bench_talise},
+	{"ad9081", bench_ad9081},
+	{"uio", bench_uio},
+};
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/* Index of the area called name, -1 if there is none */
+static int32_t bench_find_area(const char *name)
+{
+	uint32_t i;
+
+	for (i = 0; i < ARRAY_SIZE(bench_areas); i++)
+		if (!strcmp(bench_areas[i].name, name))
+			return i;
+
+	return -1;
+}
+
+/**
+ * @brief Run the driver hot paths against the simulated cores and print the
+ * time spent per call.
+ * @param argc - Number of arguments.
+ * @param argv - Areas to run, all of them if none is given.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int main(int argc, char **argv)
+{
+	bool run[ARRAY_SIZE(bench_areas)];
+	int32_t ret, area;
+	uint32_t i, j;
+
+	for (i = 0; i < ARRAY_SIZE(bench_areas); i++)
+		run[i] = argc < 2;
+	for (i = 1; i < (uint32_t)argc; i++) {
+		area = bench_find_area(argv[i]);
+		if (area < 0) {
+			printf("Unknown area %s, the areas are:", argv[i]);
+			for (j = 0; j < ARRAY_SIZE(bench_areas); j++)
+				printf(" %s", bench_areas[j].name);
+			printf("\n");
+			return -EINVAL;
+		}
+		run[area] = true;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bench_areas); i++) {
+		if (!run[i])
+			continue;
+		ret = bench_areas[i].run();
+		if (ret != SUCCESS) {
+			printf("%s: error %"PRIi32"\n", bench_areas[i].name,
+			       ret);
+			return ret;
+		}
+	}
+
+	printf("Simulated delays: %"PRIu64" us\n", sim_get_time_us());
+
+	return SUCCESS;
+}
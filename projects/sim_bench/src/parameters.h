@@ -0,0 +1,196 @@
+/***************************************************************************//**
+ *   @file   sim_bench/src/parameters.h
+ *   @brief  Parameters definitions for the simulation benchmark.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#ifndef __PARAMETERS_H__
+#define __PARAMETERS_H__
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define RX_CORE_BASEADDR		0x44A00000
+#define TX_CORE_BASEADDR		0x44A04000
+#define RX_DMA_BASEADDR			0x7C400000
+#define TX_DMA_BASEADDR			0x7C420000
+#define RX_XCVR_BASEADDR		0x44A60000
+#define SPI_ENGINE_BASEADDR		0x44A70000
+#define SPI_ENGINE_DMA_BASEADDR		0x7C440000
+
+#define SPI_DEVICE_ID			0
+#define SPI_CS				0
+
+#define RX_NB_CHANNELS			4
+#define RX_CLOCK_HZ			245760000
+
+/* Samples per channel read by each iio_axi_adc_read_dev() call */
+#define BENCH_NB_SAMPLES		16384
+/* Number of calls of each measured function */
+#define BENCH_ITERATIONS		2000
+/* Number of queued descriptors in the axi_dmac_submit() test */
+#define BENCH_NB_DESCS			4
+/* SPI Engine offload: reference and SPI clocks, samples per capture and
+ * number of captures */
+#define BENCH_OFFLOAD_REF_CLK_HZ	100000000
+#define BENCH_OFFLOAD_SPI_HZ		25000000
+#define BENCH_OFFLOAD_SAMPLES		1024
+#define BENCH_OFFLOAD_CAPTURES		1000
+/* SPI Engine continuous capture: ADC output data rate, periods of the ring,
+ * of a ring longer than the DMAC queue, and their size, simulated duration of
+ * each test and processing time of a sample by a reader keeping up with the
+ * ADC, by a slow one, by one holding each slice for three periods and by one
+ * holding it for five periods */
+#define BENCH_STREAM_ODR_HZ		2000000
+#define BENCH_STREAM_PERIODS		4
+#define BENCH_STREAM_DEEP_PERIODS	16
+#define BENCH_STREAM_PERIOD_SAMPLES	1024
+#define BENCH_STREAM_US			100000
+#define BENCH_STREAM_FAST_NS		100
+#define BENCH_STREAM_SLOW_NS		600
+#define BENCH_STREAM_HOLD_NS		1500
+#define BENCH_STREAM_LATE_NS		2600
+/* Samples unpacked by each sample_unpack() call */
+#define BENCH_UNPACK_SAMPLES		4096
+/* Scans processed by each capture post-processing call and number of calls */
+#define BENCH_DEMUX_SCANS		4096
+#define BENCH_DEMUX_ITERATIONS		200
+/* Size of an ADC frame and of a bulk buffer in the CRC tests */
+#define BENCH_CRC_FRAME_SIZE		36
+#define BENCH_CRC_SIZE			4096
+/* UART receive path: bytes received, size of the chunks received by the
+ * interrupt handler, of the uart_read() calls and of the circular buffer */
+#define BENCH_FIFO_BYTES		(4 * 1024 * 1024)
+#define BENCH_FIFO_CHUNK		256
+#define BENCH_FIFO_READ			64
+#define BENCH_FIFO_CB_SIZE		1024
+/* Circular buffer shared by two threads: bytes and largest access */
+#define BENCH_CB_SPSC_BYTES		(64 * 1024 * 1024)
+#define BENCH_CB_SPSC_CHUNK		300
+/* Number of keys of the list tests */
+#define BENCH_LIST_SIZE			2048
+/* AT parser: payload received from the simulated module, size of the chunks
+ * passed to at_rx(), of the connection buffer and UART interrupt line */
+#define BENCH_AT_BYTES			(4 * 1024 * 1024)
+#define BENCH_AT_CHUNK			1024
+#define BENCH_AT_CB_SIZE		8192
+#define BENCH_AT_IRQ_ID			0
+/* IIO server: channels of the device, attribute reads of the lookup test,
+ * round trips of the load test, clients of its largest run, port of iio.c,
+ * time after which a client waiting for an answer gives up, and size and
+ * number of the buffer reads of the zero copy test */
+#define BENCH_IIO_CHANNELS		8
+#define BENCH_IIO_LOOKUPS		200000
+#define BENCH_IIO_ROUND_TRIPS		20000
+#define BENCH_IIO_CLIENTS		32
+#define BENCH_IIO_PORT			30431
+#define BENCH_IIO_TIMEOUT_S		2
+#define BENCH_IIO_READBUF_BYTES		65536
+#define BENCH_IIO_READBUFS		500
+/* IIO continuous capture: size of the read buffer, of the client buffer
+ * reads and number of reads, rate of the ADC in bytes per us and rate of the
+ * link of a client keeping up with it and of a slower one */
+#define BENCH_IIO_CONT_BYTES		16384
+#define BENCH_IIO_CONT_READ_BYTES	4096
+#define BENCH_IIO_CONT_READS		256
+#define BENCH_IIO_CONT_RATE		8
+#define BENCH_IIO_CONT_FAST_LINK	32
+#define BENCH_IIO_CONT_SLOW_LINK	4
+/* Mock UIO device: prefix and index of its file, size, registers written by
+ * each pass and passes with a mapping per access and with a kept mapping */
+#define BENCH_UIO_PATH			"/dev/shm/sim_bench_uio"
+#define BENCH_UIO_INDEX			200
+#define BENCH_UIO_SIZE			65536
+#define BENCH_UIO_WORDS			256
+#define BENCH_UIO_LEGACY_PASSES		40
+#define BENCH_UIO_PASSES		4000
+/* SD card: number of blocks, bytes logged, size of the writes (a FatFs
+ * sector), of the reads and of the write cache in blocks */
+#define BENCH_SD_BLOCKS			16384
+#define BENCH_SD_BYTES			(2 * 1024 * 1024)
+#define BENCH_SD_WRITE_SIZE		512
+#define BENCH_SD_READ_SIZE		4096
+#define BENCH_SD_CACHE_BLOCKS		64
+/* SD card timings: cost of a SPI call on a microcontroller, SPI clock, read
+ * access time, programming time of a single block write or of a multiple
+ * block write and busy time after each block of a multiple block write */
+#define BENCH_SD_CALL_NS		1000
+#define BENCH_SD_CLK_HZ			25000000
+#define BENCH_SD_ACCESS_US		100
+#define BENCH_SD_PROG_US		250
+#define BENCH_SD_BLOCK_BUSY_US		20
+/* Size of the simulated SPI register map */
+#define BENCH_REGMAP_SIZE		0x400
+/* AD9361 RX LO band switches, alternating between two gain tables */
+#define BENCH_AD9361_SWITCHES		100
+#define BENCH_AD9361_LO_LOW_HZ		900000000ULL
+#define BENCH_AD9361_LO_HIGH_HZ		2400000000ULL
+/* AD9361 RX LO hop plan, the frequencies past the 8 fastlock profiles are
+ * tuned from their precomputed images */
+#define BENCH_AD9361_HOPS		16
+#define BENCH_AD9361_HOP_BASE_HZ	2400000000ULL
+#define BENCH_AD9361_HOP_STEP_HZ	5000000ULL
+/* JESD204 transceiver lanes, reference clock and lane rates */
+#define BENCH_XCVR_LANES		8
+#define BENCH_XCVR_REFCLK_KHZ		245760
+#define BENCH_XCVR_RATE0_KHZ		9830400
+#define BENCH_XCVR_RATE1_KHZ		4915200
+/* ADRV9009: cost of a SPI call with the Zynq SPI driver, SPI clock of the
+ * HAL, size of the ARM and stream processor images and address of the
+ * latter */
+#define BENCH_TALISE_CALL_NS		5000
+#define BENCH_TALISE_CLK_HZ		25000000
+#define BENCH_TALISE_ARM_SIZE		114688
+#define BENCH_TALISE_STREAM_SIZE	4096
+#define BENCH_TALISE_STREAM_ADDR	0x20008000
+/* AD9081: cost of a SPI call with the Zynq SPI driver, SPI clock, number of
+ * NCO retunes and of JESD204 link configurations, converter clocks, NCO
+ * shifts and entries of the register map model */
+#define BENCH_AD9081_CALL_NS		5000
+#define BENCH_AD9081_CLK_HZ		10000000
+#define BENCH_AD9081_RETUNES		100
+#define BENCH_AD9081_LINK_CONFIGS	20
+#define BENCH_AD9081_DAC_HZ		12000000000ULL
+#define BENCH_AD9081_ADC_HZ		4000000000ULL
+#define BENCH_AD9081_NCO_HZ		1000000000LL
+#define BENCH_AD9081_NCO_STEP_HZ	1000000LL
+#define BENCH_AD9081_MAP_SIZE		8192
+/* SYSREF request GPIO of the ADRV9009 HAL */
+#define SYSREF_REQ_GPIO			1
+/* Cost of a SPI transfer call (spidev ioctl) and SPI clock, used to
+ * estimate the latency on hardware */
+#define BENCH_SPI_CALL_NS		20000
+#define BENCH_SPI_CLK_HZ		10000000
+
+#endif // __PARAMETERS_H__
@@ -48,6 +48,41 @@
 #include "circular_buffer.h"
 #include "error.h"
 #include "util.h"
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+	!defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#endif
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/* The read and write pointers are kept on different cache lines */
+#define CB_CACHE_LINE	64
+
+#ifdef ATOMIC_INT_LOCK_FREE
+typedef _Atomic uint32_t cb_pos_t;
+#define cb_load(pos)		atomic_load_explicit(pos, memory_order_acquire)
+#define cb_load_relaxed(pos)	atomic_load_explicit(pos, memory_order_relaxed)
+#define cb_store(pos, val)	atomic_store_explicit(pos, val, \
+					memory_order_release)
+#else
+typedef volatile uint32_t cb_pos_t;
+#define cb_load(pos)		cb_load_barrier(pos)
+#define cb_load_relaxed(pos)	(*(pos))
+#define cb_store(pos, val)	cb_store_barrier(pos, val)
+#endif
+
+/*
+ * Without C11 atomics, GCC compatible compilers get a full barrier. Other
+ * compilers only get the volatile accesses, so the reader and the writer must
+ * then run on the same core.
+ */
+#if defined(__GNUC__)
+#define cb_barrier()		__sync_synchronize()
+#else
+#define cb_barrier()
+#endif
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -66,6 +101,9 @@ struct cb_ptr {
 	bool		async_started;
 	/** Number of bytes to update after an async transaction is finished */
 	uint32_t	async_size;
+	/** Free running position, used instead of idx and spin_count when the
+	 * size is a power of 2 */
+	cb_pos_t	pos;
 };
 
 /**
@@ -75,23 +113,99 @@ struct cb_ptr {
 struct circular_buffer {
 	/** Size of the buffer in bytes */
 	uint32_t	size;
+	/** size - 1 if size is a power of 2, 0 otherwise */
+	uint32_t	mask;
 	/** Address of the buffer */
 	int8_t		*buff;
+	/** Set if buff was allocated in cb_init and must be freed */
+	bool		own_buff;
+	uint8_t		pad0[CB_CACHE_LINE];
 	/** Write pointer */
 	struct cb_ptr	write;
+	uint8_t		pad1[CB_CACHE_LINE];
 	/** Read pointer */
 	struct cb_ptr	read;
+	uint8_t		pad2[CB_CACHE_LINE];
 };
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+#ifndef ATOMIC_INT_LOCK_FREE
+/* Read a position before the data it publishes */
+static inline uint32_t cb_load_barrier(cb_pos_t *pos)
+{
+	uint32_t val = *pos;
+
+	cb_barrier();
+
+	return val;
+}
+
+/* Publish a position after the data copied before */
+static inline void cb_store_barrier(cb_pos_t *pos, uint32_t val)
+{
+	cb_barrier();
+	*pos = val;
+}
+#endif
+
+/* Set the size of the buffer and select the power of 2 arithmetic */
+static void cb_set_size(struct circular_buffer *desc, uint32_t size)
+{
+	desc->size = size;
+	desc->mask = (size & (size - 1)) ? 0 : size - 1;
+}
+
+/* Index in the buffer of a read or write pointer */
+static inline uint32_t cb_ptr_idx(struct circular_buffer *desc,
+				  struct cb_ptr *ptr)
+{
+	if (desc->mask)
+		return cb_load_relaxed(&ptr->pos) & desc->mask;
+
+	return ptr->idx;
+}
+
+/* Move a pointer forward, size is at most desc->size */
+static inline void cb_ptr_advance(struct circular_buffer *desc,
+				  struct cb_ptr *ptr, uint32_t size)
+{
+	uint32_t new_val;
+
+	if (desc->mask) {
+		/* Publishes the data copied before to the other side */
+		cb_store(&ptr->pos, cb_load_relaxed(&ptr->pos) + size);
+		return;
+	}
+
+	new_val = ptr->idx + size;
+	if (new_val >= desc->size) {
+		ptr->spin_count++;
+		new_val %= desc->size;
+	}
+	ptr->idx = new_val;
+}
+
+/* Drop the data overwritten by the writer, keeping the last desc->size bytes */
+static void cb_read_recover(struct circular_buffer *desc)
+{
+	if (desc->mask) {
+		cb_store(&desc->read.pos, cb_load(&desc->write.pos) - desc->size);
+		return;
+	}
+
+	desc->read.spin_count = desc->write.spin_count - 1;
+	desc->read.idx = desc->write.idx;
+}
+
 /**
  * @brief Create circular buffer structure
  *
  * @note Circular buffer implementation is thread safe for one write
- * and one reader.
+ * and one reader. With a power of 2 size, the positions are updated with C11
+ * atomics, so the reader and the writer may run on different cores.
  * If multiple writer or multiple readers access the circular buffer then
  * function that updates the structure should be called inside a critical
  * critical section.
@@ -115,12 +229,48 @@ int32_t cb_init(struct circular_buffer **desc, uint32_t buff_size)
 
 	*desc = ldesc;
 
-	ldesc->size = buff_size;
+	cb_set_size(ldesc, buff_size);
 	ldesc->buff = calloc(1, buff_size);
 	if (!ldesc->buff) {
 		free(ldesc);
 		return -ENOMEM;
 	}
+	ldesc->own_buff = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Create circular buffer structure over an existing buffer
+ *
+ * Same as \ref cb_init but the memory is given by the caller (e.g. a DMA
+ * capable buffer). The memory is not freed by \ref cb_remove.
+ *
+ * @param desc - Where to store the circular buffer reference
+ * @param buff - Memory used to store the data
+ * @param buff_size - Buffer size
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - -EINVAL : Wrong parameters used
+ *  - -ENOMEM : Memory allocation failed
+ */
+int32_t cb_init_with_buff(struct circular_buffer **desc, void *buff,
+			  uint32_t buff_size)
+{
+	struct circular_buffer	*ldesc;
+
+	if (!desc || !buff || !buff_size)
+		return -EINVAL;
+
+	ldesc = (struct circular_buffer*)calloc(1, sizeof(*ldesc));
+	if (!ldesc)
+		return -ENOMEM;
+
+	cb_set_size(ldesc, buff_size);
+	ldesc->buff = buff;
+	ldesc->own_buff = false;
+
+	*desc = ldesc;
 
 	return SUCCESS;
 }
@@ -137,7 +287,7 @@ int32_t cb_remove(struct circular_buffer *desc)
 	if (!desc)
 		return FAILURE;
 
-	if (desc->buff)
+	if (desc->buff && desc->own_buff)
 		free(desc->buff);
 	free(desc);
 
@@ -160,6 +310,16 @@ int32_t cb_size(struct circular_buffer *desc, uint32_t *size)
 	if (!desc || !size)
 		return -EINVAL;
 
+	if (desc->mask) {
+		*size = cb_load(&desc->write.pos) - cb_load(&desc->read.pos);
+		if (*size > desc->size) {
+			*size = desc->size;
+			return -EOVERRUN;
+		}
+
+		return SUCCESS;
+	}
+
 	if (desc->write.spin_count > desc->read.spin_count)
 		nb_spins = desc->write.spin_count - desc->read.spin_count;
 	else
@@ -192,6 +352,7 @@ static int32_t cb_prepare_async_operation(struct circular_buffer *desc,
 {
 	struct cb_ptr	*ptr;
 	uint32_t	available_size;
+	uint32_t	idx;
 	int32_t		ret;
 
 	if (!desc || !buff || !raw_size_available)
@@ -207,11 +368,9 @@ static int32_t cb_prepare_async_operation(struct circular_buffer *desc,
 
 	if (is_read) {
 		ret = cb_size(desc, &available_size);
-		if (ret == -EOVERRUN) {
+		if (ret == -EOVERRUN)
 			/* Update read index */
-			desc->read.spin_count = desc->write.spin_count - 1;
-			desc->read.idx = desc->write.idx;
-		}
+			cb_read_recover(desc);
 
 		/* We can only read available data */
 		requested_size = min(requested_size, available_size);
@@ -220,12 +379,13 @@ static int32_t cb_prepare_async_operation(struct circular_buffer *desc,
 	}
 
 	/* Size to end of buffer */
-	ptr->async_size = min(requested_size, desc->size - ptr->idx);
+	idx = cb_ptr_idx(desc, ptr);
+	ptr->async_size = min(requested_size, desc->size - idx);
 
 	*raw_size_available = ptr->async_size;
 
 	/* Convert index to address in the buffer */
-	*buff = (void *)(desc->buff + ptr->idx);
+	*buff = (void *)(desc->buff + idx);
 
 	ptr->async_started = true;
 
@@ -240,8 +400,6 @@ static int32_t cb_end_async_operation(struct circular_buffer *desc,
 				      bool is_read)
 {
 	struct cb_ptr	*ptr;
-	uint32_t	new_val;
-
 
 	if (!desc)
 		return -EINVAL;
@@ -254,18 +412,71 @@ static int32_t cb_end_async_operation(struct circular_buffer *desc,
 		return FAILURE;
 
 	/* Update pointer value */
-	new_val = ptr->idx + ptr->async_size;
-	if (new_val >= desc->size) {
-		ptr->spin_count++;
-		new_val %= desc->size;
-	}
-	ptr->idx = new_val;
+	cb_ptr_advance(desc, ptr, ptr->async_size);
 	ptr->async_size = 0;
 	ptr->async_started = false;
 
 	return SUCCESS;
 }
 
+/* Copy size bytes between data and the buffer, starting from index idx */
+static inline void cb_copy(struct circular_buffer *desc, uint32_t idx,
+			   uint8_t *data, uint32_t size, bool is_read)
+{
+	uint32_t n = min(size, desc->size - idx);
+
+	if (is_read) {
+		memcpy(data, desc->buff + idx, n);
+		memcpy(data + n, desc->buff, size - n);
+	} else {
+		memcpy(desc->buff + idx, data, n);
+		memcpy(desc->buff, data + n, size - n);
+	}
+}
+
+/*
+ * cb_write/read for power of 2 sizes, copying across the end of the buffer
+ * and only polling the write position while waiting for data
+ */
+static int32_t cb_operation_pow2(struct circular_buffer *desc,
+				 uint8_t *data, uint32_t size,
+				 bool is_read)
+{
+	uint32_t	rd, wr, n, i;
+	bool		sticky_overrun;
+
+	sticky_overrun = false;
+	i = 0;
+	while (i < size) {
+		if (!is_read) {
+			wr = cb_load_relaxed(&desc->write.pos);
+			n = min(size - i, desc->size);
+			cb_copy(desc, wr & desc->mask, data + i, n, false);
+			cb_store(&desc->write.pos, wr + n);
+			i += n;
+			continue;
+		}
+
+		rd = cb_load_relaxed(&desc->read.pos);
+		wr = cb_load(&desc->write.pos);
+		if (wr - rd > desc->size) {
+			sticky_overrun = true;
+			rd = wr - desc->size;
+		}
+		n = min(size - i, wr - rd);
+		if (!n)
+			continue;
+		cb_copy(desc, rd & desc->mask, data + i, n, true);
+		cb_store(&desc->read.pos, rd + n);
+		i += n;
+	}
+
+	if (sticky_overrun)
+		return -EOVERRUN;
+
+	return SUCCESS;
+}
+
 /*
  * Functionality described at cb_write/read having the is_read
  * parameter to specifiy if it is a read or write operation
@@ -283,6 +494,10 @@ static int32_t cb_operation(struct circular_buffer *desc,
 	if (!desc || !data || !size)
 		return -EINVAL;
 
+	if (desc->mask && !(is_read ? desc->read.async_started :
+			    desc->write.async_started))
+		return cb_operation_pow2(desc, data, size, is_read);
+
 	sticky_overrun = 0;
 	i = 0;
 	while (i < size) {
@@ -410,3 +625,111 @@ int32_t cb_read(struct circular_buffer *desc, void *data, uint32_t size)
 {
 	return cb_operation(desc, data, size, 1);
 }
+
+/*
+ * Functionality described at cb_peek_write/read having the is_read
+ * parameter to specifiy if it is a read or write operation
+ */
+static int32_t cb_peek_operation(struct circular_buffer *desc,
+				 struct cb_region regions[2], bool is_read)
+{
+	struct cb_ptr	*ptr;
+	uint32_t	used_size;
+	uint32_t	size;
+	uint32_t	idx;
+	int32_t		ret;
+
+	if (!desc || !regions)
+		return -EINVAL;
+
+	ptr = is_read ? &desc->read : &desc->write;
+	if (ptr->async_started)
+		return -EBUSY;
+
+	ret = cb_size(desc, &used_size);
+	if (is_read && ret == -EOVERRUN)
+		cb_read_recover(desc);
+	size = is_read ? used_size : desc->size - used_size;
+
+	idx = cb_ptr_idx(desc, ptr);
+	regions[0].buff = desc->buff + idx;
+	regions[0].size = min(size, desc->size - idx);
+	regions[1].buff = desc->buff;
+	regions[1].size = size - regions[0].size;
+
+	return is_read ? ret : SUCCESS;
+}
+
+/**
+ * @brief Get the free space of the buffer, without copying data.
+ *
+ * The space is returned as two regions, the second one being used when it
+ * wraps around the end of the buffer. Data written to the regions is added to
+ * the buffer by \ref cb_commit_write. Unlike \ref cb_write, the unread data is
+ * never overwritten.
+ *
+ * @param desc - Circular buffer reference
+ * @param regions - Where to store the free regions, the sizes may be 0
+ * @return
+ *  - \ref SUCCESS - No errors
+ *  - -EINVAL      - Wrong parameters used
+ *  - -EBUSY       - Asynchronous write started
+ */
+int32_t cb_peek_write(struct circular_buffer *desc, struct cb_region regions[2])
+{
+	return cb_peek_operation(desc, regions, 0);
+}
+
+/**
+ * @brief Get the data available in the buffer, without copying it.
+ *
+ * The data is returned as two regions, the second one being used when it
+ * wraps around the end of the buffer. The data is removed from the buffer by
+ * \ref cb_commit_read.
+ *
+ * @param desc - Circular buffer reference
+ * @param regions - Where to store the data regions, the sizes may be 0
+ * @return
+ *  - \ref SUCCESS   - No errors
+ *  - -EINVAL        - Wrong parameters used
+ *  - -EBUSY         - Asynchronous read started
+ *  - -EOVERRUN      - An overrun occurred and some data have been overwritten
+ */
+int32_t cb_peek_read(struct circular_buffer *desc, struct cb_region regions[2])
+{
+	return cb_peek_operation(desc, regions, 1);
+}
+
+/**
+ * \defgroup commit_group Commit functions
+ * @brief Add the data written to the regions of \ref cb_peek_write or remove
+ * the data read from the regions of \ref cb_peek_read
+ *
+ * @param desc - Circular buffer reference
+ * @param size - Number of bytes written or read, at most the total size of the
+ * regions
+ * @return
+ *  - \ref SUCCESS   - No errors
+ *  - -EINVAL        - Wrong parameters used
+ * @{
+ */
+int32_t cb_commit_write(struct circular_buffer *desc, uint32_t size)
+{
+	if (!desc || size > desc->size)
+		return -EINVAL;
+
+	cb_ptr_advance(desc, &desc->write, size);
+
+	return SUCCESS;
+}
+
+int32_t cb_commit_read(struct circular_buffer *desc, uint32_t size)
+{
+	if (!desc || size > desc->size)
+		return -EINVAL;
+
+	cb_ptr_advance(desc, &desc->read, size);
+
+	return SUCCESS;
+}
+/** @} */
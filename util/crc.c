@@ -0,0 +1,193 @@
+/***************************************************************************//**
+ *   @file   crc.c
+ *   @brief  Source file of the generic CRC computation.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#include "crc.h"
+
+/*
+ * The CRC register is kept aligned to the msb of a 32 bit word whatever the
+ * CRC width is, so that the same tables and steps work for all widths:
+ * table[0][n] is the CRC of byte n and table[k][n] the CRC of byte n
+ * followed by k zero bytes, which lets the slices of a word be processed
+ * independently.
+ */
+
+/* Load 4 bytes as a big endian word */
+static inline uint32_t crc_load_be32(const uint8_t *pdata)
+{
+	return ((uint32_t)pdata[0] << 24) | ((uint32_t)pdata[1] << 16) |
+	       ((uint32_t)pdata[2] << 8) | pdata[3];
+}
+
+/***************************************************************************//**
+ * @brief Creates the CRC lookup tables for a given polynomial.
+ *
+ * @param table      - Table declared with DECLARE_CRC_TABLE().
+ * @param width      - CRC width in bits, from 8 to 32.
+ * @param polynomial - msb-first representation of desired polynomial, as for
+ *                     crc8_populate_msb(), crc16_populate_msb() and
+ *                     crc24_populate_msb().
+ *
+ * @return None.
+*******************************************************************************/
+void crc_populate_msb(struct crc_table *table, uint8_t width,
+		      uint32_t polynomial)
+{
+	uint32_t *t0, *tk;
+	uint32_t poly, crc;
+	uint16_t n;
+	uint8_t bit, k;
+
+	if (!table || width < 8 || width > 32)
+		return;
+
+	table->width = width;
+	poly = polynomial << (32 - width);
+	t0 = table->entries;
+
+	for (n = 0; n < CRC_TABLE_SIZE; n++) {
+		crc = (uint32_t)n << 24;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc & 0x80000000) ? (crc << 1) ^ poly : crc << 1;
+		t0[n] = crc;
+	}
+
+	for (k = 1; k < table->nb_slices; k++) {
+		tk = table->entries + k * CRC_TABLE_SIZE;
+		for (n = 0; n < CRC_TABLE_SIZE; n++) {
+			crc = tk[n - CRC_TABLE_SIZE];
+			tk[n] = (crc << 8) ^ t0[crc >> 24];
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief Computes the CRC over a buffer of data.
+ *
+ * @param table     - Lookup tables created by crc_populate_msb().
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC over.
+ * @param crc       - Initial value for the CRC computation. Can be used to
+ *                    cascade calls to this function by providing a previous
+ *                    output of this function as the crc parameter.
+ *
+ * @return crc      - Computed CRC value.
+*******************************************************************************/
+uint32_t crc_compute(const struct crc_table *table, const uint8_t *pdata,
+		     size_t nbytes, uint32_t crc)
+{
+	const uint32_t *t = table->entries;
+	uint8_t shift = 32 - table->width;
+
+	crc <<= shift;
+
+	if (table->nb_slices >= 8) {
+		while (nbytes >= 8) {
+			crc ^= crc_load_be32(pdata);
+			crc = t[7 * CRC_TABLE_SIZE + (crc >> 24)] ^
+			      t[6 * CRC_TABLE_SIZE + ((crc >> 16) & 0xff)] ^
+			      t[5 * CRC_TABLE_SIZE + ((crc >> 8) & 0xff)] ^
+			      t[4 * CRC_TABLE_SIZE + (crc & 0xff)] ^
+			      t[3 * CRC_TABLE_SIZE + pdata[4]] ^
+			      t[2 * CRC_TABLE_SIZE + pdata[5]] ^
+			      t[1 * CRC_TABLE_SIZE + pdata[6]] ^
+			      t[pdata[7]];
+			pdata += 8;
+			nbytes -= 8;
+		}
+	}
+
+	if (table->nb_slices >= 4) {
+		while (nbytes >= 4) {
+			crc ^= crc_load_be32(pdata);
+			crc = t[3 * CRC_TABLE_SIZE + (crc >> 24)] ^
+			      t[2 * CRC_TABLE_SIZE + ((crc >> 16) & 0xff)] ^
+			      t[1 * CRC_TABLE_SIZE + ((crc >> 8) & 0xff)] ^
+			      t[crc & 0xff];
+			pdata += 4;
+			nbytes -= 4;
+		}
+	}
+
+	while (nbytes--) {
+		crc = (crc << 8) ^ t[(crc >> 24) ^ *pdata];
+		pdata++;
+	}
+
+	return crc >> shift;
+}
+
+/***************************************************************************//**
+ * @brief Starts a CRC computation over data received in several chunks.
+ *
+ * @param ctx       - Computation context.
+ * @param table     - Lookup tables created by crc_populate_msb().
+ * @param crc       - Initial value for the CRC computation.
+ *
+ * @return None.
+*******************************************************************************/
+void crc_init(struct crc_ctx *ctx, const struct crc_table *table,
+	      uint32_t crc)
+{
+	ctx->table = table;
+	ctx->crc = crc;
+}
+
+/***************************************************************************//**
+ * @brief Adds a chunk of data to a CRC computation.
+ *
+ * @param ctx       - Context initialized by crc_init().
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes of the chunk.
+ *
+ * @return None.
+*******************************************************************************/
+void crc_update(struct crc_ctx *ctx, const uint8_t *pdata, size_t nbytes)
+{
+	ctx->crc = crc_compute(ctx->table, pdata, nbytes, ctx->crc);
+}
+
+/***************************************************************************//**
+ * @brief Gets the CRC of the data added to a computation.
+ *
+ * @param ctx       - Context initialized by crc_init().
+ *
+ * @return crc      - Computed CRC value.
+*******************************************************************************/
+uint32_t crc_final(struct crc_ctx *ctx)
+{
+	return ctx->crc;
+}
@@ -49,6 +49,17 @@
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
 
+/**
+ * @struct list_level
+ * @brief Links of an element in one level of the ordered index
+ */
+struct list_level {
+	/** Previous element of the level */
+	struct list_elem	*prev;
+	/** Next element of the level */
+	struct list_elem	*next;
+};
+
 /**
  * @struct list_elem
  * @brief Format of each element of the list
@@ -60,6 +71,10 @@ struct list_elem {
 	struct list_elem	*prev;
 	/** Reference to next element */
 	struct list_elem	*next;
+	/** Number of index levels the element is part of */
+	uint32_t		nb_levels;
+	/** Links of the index levels */
+	struct list_level	levels[];
 };
 
 /**
@@ -90,6 +105,20 @@ struct _list_desc {
 	uint32_t		nb_iterators;
 	/** Internal list iterator */
 	struct iterator		l_it;
+	/** The list was created as a \ref LIST_PRIORITY_LIST */
+	bool			ordered;
+	/** All the elements are in ascending order and the index is valid */
+	bool			sorted;
+	/** First element of each index level, valid while sorted */
+	struct list_elem	*level_first[LIST_MAX_LEVELS];
+	/** State of the index level generator */
+	uint32_t		seed;
+	/** Element pool, NULL if the elements are allocated on insertion */
+	uint8_t			*pool;
+	/** The pool was allocated by list_init_pool() */
+	bool			pool_allocated;
+	/** Free elements of the pool */
+	struct list_elem	*free_elems;
 };
 
 /** @brief Default function used to compare element in the list ( \ref f_cmp) */
@@ -98,29 +127,142 @@ static int32_t default_comparator(void *data1, void *data2)
 	return (int32_t)(data1 - data2);
 }
 
+/** @brief Size of the elements of a list with nb_levels index levels */
+static inline uint32_t elem_size(uint32_t nb_levels)
+{
+	return sizeof(struct list_elem) + nb_levels * sizeof(struct list_level);
+}
+
 /**
  * @brief Creates a new list elements an configure its value
+ * @param list - List reference, the element is taken from its pool if any
  * @param data - To set list_elem.data
  * @param prev - To set list_elem.prev
  * @param next - To set list_elem.next
+ * @param nb_levels - Number of index levels of the element
  * @return Address of the new element or NULL if allocation fails.
  */
-static inline struct list_elem *create_element(void *data,
+static inline struct list_elem *create_element(struct _list_desc *list,
+		void *data,
 		struct list_elem *prev,
-		struct list_elem *next)
+		struct list_elem *next,
+		uint32_t nb_levels)
 {
 	struct list_elem *elem;
 
-	elem = (struct list_elem *)calloc(1, sizeof(*elem));
-	if (!elem)
-		return NULL;
+	if (list->pool) {
+		elem = list->free_elems;
+		if (!elem)
+			return NULL;
+		list->free_elems = elem->next;
+	} else {
+		elem = (struct list_elem *)calloc(1, elem_size(nb_levels));
+		if (!elem)
+			return NULL;
+	}
 	elem->data = data;
 	elem->prev = prev;
 	elem->next = next;
+	elem->nb_levels = nb_levels;
 
 	return (elem);
 }
 
+/**
+ * @brief Remove an element from the index and free it
+ * @param list - List reference
+ * @param elem - Element, already unlinked from the list
+ */
+static inline void free_element(struct _list_desc *list,
+				struct list_elem *elem)
+{
+	struct list_level	*level;
+	uint32_t		i;
+
+	for (i = 0; i < elem->nb_levels; i++) {
+		level = &elem->levels[i];
+		if (level->prev)
+			level->prev->levels[i].next = level->next;
+		else
+			list->level_first[i] = level->next;
+		if (level->next)
+			level->next->levels[i].prev = level->prev;
+	}
+
+	/* An empty ordered list is sorted again */
+	if (list->nb_elements == 0)
+		list->sorted = list->ordered;
+
+	if (list->pool) {
+		elem->next = list->free_elems;
+		list->free_elems = elem;
+	} else {
+		free(elem);
+	}
+}
+
+/**
+ * @brief Pick the number of index levels of a new element, a level holding
+ * one element out of four of the level below
+ * @param list - List reference
+ * @return Number of levels
+ */
+static inline uint32_t random_levels(struct _list_desc *list)
+{
+	uint32_t nb_levels = 0;
+	uint32_t x = list->seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	list->seed = x;
+
+	while (nb_levels < LIST_MAX_LEVELS && !(x & 3)) {
+		nb_levels++;
+		x >>= 2;
+	}
+
+	return nb_levels;
+}
+
+/**
+ * @brief Search a sorted list using its index
+ * @param list - List reference
+ * @param data - Data to compare the elements with
+ * @param after_equal - Skip the elements equal to data as well
+ * @param update - If not NULL, filled with the last element before data on
+ * each index level
+ * @return The last element lower than data (or equal with after_equal), NULL
+ * if there is none.
+ */
+static struct list_elem *index_search(struct _list_desc *list, void *data,
+				      bool after_equal,
+				      struct list_elem **update)
+{
+	struct list_elem	*elem = NULL;
+	struct list_elem	*next;
+	int32_t			i, ret;
+
+	for (i = LIST_MAX_LEVELS; i >= 0; i--) {
+		if (i == 0)
+			next = elem ? elem->next : list->first;
+		else
+			next = elem ? elem->levels[i - 1].next :
+			       list->level_first[i - 1];
+		while (next) {
+			ret = list->comparator(next->data, data);
+			if (ret > 0 || (ret == 0 && !after_equal))
+				break;
+			elem = next;
+			next = i ? elem->levels[i - 1].next : elem->next;
+		}
+		if (update && i)
+			update[i - 1] = elem;
+	}
+
+	return elem;
+}
+
 /**
  * @brief Updates the necesary link on the list elements to add or remove one
  * @param prev - Low element
@@ -207,10 +349,34 @@ static inline void set_adapter(struct list_desc *ad, enum adapter_type type)
  */
 int32_t list_init(struct list_desc **list_desc, enum adapter_type type,
 		  f_cmp comparator)
+{
+	return list_init_pool(list_desc, type, comparator, NULL, 0);
+}
+
+/**
+ * @brief Create a new empty list whose elements are taken from a pool.
+ *
+ * Adding elements does not allocate memory, it fails when all the elements of
+ * the pool are used.
+ * @param list_desc - Where to store the reference of the new created list
+ * @param type - Type of adapter to use.
+ * @param comparator - Used to compare item when using an ordered list or when
+ * using the \em find functions.
+ * @param pool - Pointer aligned buffer of \ref LIST_POOL_SIZE (nb_elements)
+ * bytes, allocated by the function if NULL.
+ * @param nb_elements - Number of elements of the pool. If 0, the elements are
+ * allocated when they are added, as with \ref list_init.
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+int32_t list_init_pool(struct list_desc **list_desc, enum adapter_type type,
+		       f_cmp comparator, void *pool, uint32_t nb_elements)
 {
 	struct list_desc	*l_desc;
 	struct _list_desc	*list;
-
+	struct list_elem	*elem;
+	uint32_t		size, i;
 
 	if (!list_desc)
 		return FAILURE;
@@ -223,6 +389,30 @@ int32_t list_init(struct list_desc **list_desc, enum adapter_type type,
 		return FAILURE;
 	}
 
+	/* Only the ordered lists use the index */
+	list->ordered = type == LIST_PRIORITY_LIST;
+	list->sorted = list->ordered;
+	list->seed = 0x9E3779B9;
+
+	if (nb_elements) {
+		size = elem_size(list->ordered ? LIST_MAX_LEVELS : 0);
+		if (!pool) {
+			pool = calloc(nb_elements, size);
+			if (!pool) {
+				free(list);
+				free(l_desc);
+				return FAILURE;
+			}
+			list->pool_allocated = true;
+		}
+		list->pool = pool;
+		for (i = nb_elements; i > 0; i--) {
+			elem = (struct list_elem *)(list->pool + (i - 1) * size);
+			elem->next = list->free_elems;
+			list->free_elems = elem;
+		}
+	}
+
 	*list_desc = l_desc;
 	l_desc->priv_desc = list;
 	list->comparator = comparator ? comparator : default_comparator;
@@ -259,6 +449,8 @@ int32_t list_remove(struct list_desc *list_desc)
 	/* Remove all the elements */
 	while (SUCCESS == list_get_first(list_desc, &data))
 		;
+	if (list->pool_allocated)
+		free(list->pool);
 	free(list_desc->priv_desc);
 	free(list_desc);
 
@@ -301,10 +493,12 @@ int32_t list_add_first(struct list_desc *list_desc, void *data)
 
 	prev = NULL;
 	next = list->first;
-	elem = create_element(data, prev, next);
+	elem = create_element(list, data, prev, next, 0);
 	if (!elem)
 		return FAILURE;
 
+	list->sorted = false;
+
 	update_links(prev, elem, next);
 
 	update_desc(list, elem, list->last);
@@ -328,10 +522,12 @@ int32_t list_add_last(struct list_desc *list_desc, void *data)
 
 	prev = list->last;
 	next = NULL;
-	elem = create_element(data, prev, next);
+	elem = create_element(list, data, prev, next, 0);
 	if (!elem)
 		return FAILURE;
 
+	list->sorted = false;
+
 	update_links(prev, elem, next);
 
 	update_desc(list, list->first, elem);
@@ -363,6 +559,54 @@ int32_t list_add_idx(struct list_desc *list_desc, void *data, uint32_t idx)
 	return iterator_insert(&(list->l_it), data, 0);
 }
 
+/**
+ * @brief Add element to a sorted list and to its index
+ * @param list - List reference
+ * @param data - Data to store in a list element
+ * @return
+ *  - \ref SUCCESS : On success
+ *  - \ref FAILURE : Otherwise
+ */
+static int32_t list_add_sorted(struct _list_desc *list, void *data)
+{
+	struct list_elem	*update[LIST_MAX_LEVELS];
+	struct list_elem	*prev;
+	struct list_elem	*next;
+	struct list_elem	*elem;
+	struct list_level	*level;
+	uint32_t		i;
+
+	/* After the equal elements, as the linear insertion */
+	prev = index_search(list, data, true, update);
+	next = prev ? prev->next : list->first;
+	elem = create_element(list, data, prev, next, random_levels(list));
+	if (!elem)
+		return FAILURE;
+
+	update_links(prev, elem, next);
+	if (!prev)
+		update_desc(list, elem, list->last);
+	else if (!next)
+		update_desc(list, list->first, elem);
+	list->nb_elements++;
+
+	for (i = 0; i < elem->nb_levels; i++) {
+		level = &elem->levels[i];
+		level->prev = update[i];
+		if (update[i]) {
+			level->next = update[i]->levels[i].next;
+			update[i]->levels[i].next = elem;
+		} else {
+			level->next = list->level_first[i];
+			list->level_first[i] = elem;
+		}
+		if (level->next)
+			level->next->levels[i].prev = elem;
+	}
+
+	return SUCCESS;
+}
+
 /** @brief Add element in ascending order. Refer to \ref f_add */
 int32_t list_add_find(struct list_desc *list_desc, void *data)
 {
@@ -373,6 +617,8 @@ int32_t list_add_find(struct list_desc *list_desc, void *data)
 		return FAILURE;
 	list = list_desc->priv_desc;
 
+	if (list->sorted)
+		return list_add_sorted(list, data);
 
 	/* Based on place iterator */
 	elem = list->first;
@@ -401,6 +647,7 @@ int32_t list_edit_first(struct list_desc *list_desc, void *new_data)
 
 	list = list_desc->priv_desc;
 	list->first->data = new_data;
+	list->sorted = false;
 
 	return SUCCESS;
 }
@@ -415,6 +662,7 @@ int32_t list_edit_last(struct list_desc *list_desc, void *new_data)
 
 	list = list_desc->priv_desc;
 	list->last->data = new_data;
+	list->sorted = false;
 
 	return SUCCESS;
 }
@@ -558,7 +806,7 @@ int32_t list_get_first(struct list_desc *list_desc, void **data)
 	list->nb_elements--;
 
 	*data = elem->data;
-	free(elem);
+	free_element(list, elem);
 
 	return SUCCESS;
 }
@@ -588,7 +836,7 @@ int32_t list_get_last(struct list_desc *list_desc, void **data)
 	list->nb_elements--;
 
 	*data = elem->data;
-	free(elem);
+	free_element(list, elem);
 
 	return SUCCESS;
 }
@@ -730,6 +978,16 @@ int32_t iterator_find(struct iterator *iter, void *cmp_data)
 	if (!it)
 		return FAILURE;
 
+	if (it->list->sorted) {
+		elem = index_search(it->list, cmp_data, false, NULL);
+		elem = elem ? elem->next : it->list->first;
+		if (!elem || it->list->comparator(elem->data, cmp_data))
+			return FAILURE;
+		it->elem = elem;
+
+		return SUCCESS;
+	}
+
 	elem = it->list->first;
 	while (elem) {
 		if (0 == it->list->comparator(elem->data, cmp_data)) {
@@ -753,6 +1011,7 @@ int32_t iterator_edit(struct iterator *iter, void *new_data)
 		return FAILURE;
 
 	it->elem->data = new_data;
+	it->list->sorted = false;
 
 	return SUCCESS;
 }
@@ -784,7 +1043,7 @@ int32_t iterator_get(struct iterator *iter, void **data)
 		next = it->elem->prev;
 	else
 		next = it->elem->next;
-	free(it->elem);
+	free_element(it->list, it->elem);
 	it->elem = next;
 
 	return SUCCESS;
@@ -828,12 +1087,14 @@ int32_t iterator_insert(struct iterator *iter, void *data, bool after)
 		return list_add_first(&list_desc, data);
 
 	if (after)
-		elem = create_element(data, it->elem, it->elem->next);
+		elem = create_element(it->list, data, it->elem, it->elem->next, 0);
 	else
-		elem = create_element(data, it->elem->prev, it->elem);
+		elem = create_element(it->list, data, it->elem->prev, it->elem, 0);
 	if (!elem)
 		return FAILURE;
 
+	it->list->sorted = false;
+
 	update_links(elem->prev, elem, elem->next);
 
 	it->list->nb_elements++;
@@ -0,0 +1,346 @@
+/***************************************************************************//**
+ *   @file   sample_unpack.c
+ *   @brief  Unpacking of big endian samples packed back to back.
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+#include "error.h"
+#include "sample_unpack.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+ * Every path below first places the bits of a sample at the top of a 32 bit
+ * word, with the most significant bit at bit 31. Shifting the word right by
+ * (32 - bits), arithmetically for signed samples, drops the status and the
+ * bits of the following sample.
+ */
+
+/* Load 8 bytes as a big endian word */
+static inline uint64_t sample_load_be64(const uint8_t *src)
+{
+#if defined(__GNUC__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+	(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	uint64_t w;
+
+	memcpy(&w, src, sizeof(w));
+
+	return __builtin_bswap64(w);
+#else
+	return ((uint64_t)src[0] << 56) | ((uint64_t)src[1] << 48) |
+	       ((uint64_t)src[2] << 40) | ((uint64_t)src[3] << 32) |
+	       ((uint64_t)src[4] << 24) | ((uint64_t)src[5] << 16) |
+	       ((uint64_t)src[6] << 8) | (uint64_t)src[7];
+#endif
+}
+
+/* Shift the top aligned word down to the sample value */
+static inline uint32_t sample_finish(uint32_t word, uint8_t shift, bool sign)
+{
+	if (sign)
+		return (uint32_t)((int32_t)word >> shift);
+
+	return word >> shift;
+}
+
+/* Extract the sample starting at bit pos of a 64 bit window */
+static inline uint32_t sample_extract(uint64_t window, uint32_t pos,
+				      uint8_t shift, bool sign)
+{
+	return sample_finish((uint32_t)((window << (pos & 7)) >> 32), shift,
+			     sign);
+}
+
+/*
+ * Groups of 8 samples, which take width bytes. With a constant width the
+ * offsets and shifts are constants, the callers pass one.
+ */
+static inline uint32_t sample_unpack_groups(const uint8_t *src, uint32_t *dst,
+		uint32_t nb_samples, uint8_t width, uint8_t shift, bool sign)
+{
+	uint32_t nb_bytes = ((uint64_t)nb_samples * width + 7) / 8;
+	uint32_t i;
+
+#define SAMPLE_GROUP_EXTRACT(k) \
+	dst[i + (k)] = sample_extract(sample_load_be64(src + ((k) * width) / 8), \
+				      (k) * width, shift, sign)
+
+	/* The window of the last sample of a group ends 8 bytes after it */
+	for (i = 0; i + 8 <= nb_samples &&
+	     (i / 8) * width + (7 * width) / 8 + 8 <= nb_bytes; i += 8) {
+		SAMPLE_GROUP_EXTRACT(0);
+		SAMPLE_GROUP_EXTRACT(1);
+		SAMPLE_GROUP_EXTRACT(2);
+		SAMPLE_GROUP_EXTRACT(3);
+		SAMPLE_GROUP_EXTRACT(4);
+		SAMPLE_GROUP_EXTRACT(5);
+		SAMPLE_GROUP_EXTRACT(6);
+		SAMPLE_GROUP_EXTRACT(7);
+		src += width;
+	}
+
+#undef SAMPLE_GROUP_EXTRACT
+
+	return i;
+}
+
+/* Any width: the sample is extracted from a 64 bit window of the input */
+static void sample_unpack_bits(const uint8_t *src, uint32_t *dst,
+			       uint32_t nb_samples, uint8_t width,
+			       uint8_t shift, bool sign)
+{
+	uint32_t nb_bytes = ((uint64_t)nb_samples * width + 7) / 8;
+	uint64_t pos = 0;
+	uint64_t window;
+	uint32_t off, i, k;
+
+	switch (width) {
+	case 12:
+		i = sample_unpack_groups(src, dst, nb_samples, 12, shift, sign);
+		break;
+	case 14:
+		i = sample_unpack_groups(src, dst, nb_samples, 14, shift, sign);
+		break;
+	case 18:
+		i = sample_unpack_groups(src, dst, nb_samples, 18, shift, sign);
+		break;
+	case 20:
+		i = sample_unpack_groups(src, dst, nb_samples, 20, shift, sign);
+		break;
+	case 26:
+		i = sample_unpack_groups(src, dst, nb_samples, 26, shift, sign);
+		break;
+	case 28:
+		i = sample_unpack_groups(src, dst, nb_samples, 28, shift, sign);
+		break;
+	default:
+		i = 0;
+		break;
+	}
+	pos = (uint64_t)i * width;
+
+	for (; i < nb_samples; i++, pos += width) {
+		off = pos >> 3;
+		if (off + 8 <= nb_bytes) {
+			window = sample_load_be64(src + off);
+		} else {
+			/* Do not read past the end of the input */
+			window = 0;
+			for (k = 0; k < 8; k++)
+				window = (window << 8) |
+					 (off + k < nb_bytes ? src[off + k] : 0);
+		}
+		dst[i] = sample_extract(window, pos, shift, sign);
+	}
+}
+
+#if defined(__SSSE3__)
+/* Byte shuffles placing 4 big endian samples at the top of 32 bit words */
+static const uint8_t sample_shuffle_16[2][16] = {
+	{
+		0x80, 0x80, 1, 0, 0x80, 0x80, 3, 2,
+		0x80, 0x80, 5, 4, 0x80, 0x80, 7, 6
+	},
+	{
+		0x80, 0x80, 9, 8, 0x80, 0x80, 11, 10,
+		0x80, 0x80, 13, 12, 0x80, 0x80, 15, 14
+	},
+};
+
+static const uint8_t sample_shuffle_24[16] = {
+	0x80, 2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9
+};
+
+/* 4 words to 4 samples */
+static inline __m128i sample_finish_x4(__m128i words, __m128i shift, bool sign)
+{
+	return sign ? _mm_sra_epi32(words, shift) : _mm_srl_epi32(words, shift);
+}
+
+/* 16 and 24 bit samples, returns the number of unpacked samples */
+static uint32_t sample_unpack_simd(const uint8_t *src, uint32_t *dst,
+				   uint32_t nb_samples, uint8_t width,
+				   uint8_t shift, bool sign)
+{
+	__m128i sh = _mm_cvtsi32_si128(shift);
+	__m128i in, m0, m1;
+	uint32_t i = 0;
+
+	if (width == 16) {
+		m0 = _mm_loadu_si128((const __m128i *)sample_shuffle_16[0]);
+		m1 = _mm_loadu_si128((const __m128i *)sample_shuffle_16[1]);
+		for (; i + 8 <= nb_samples; i += 8) {
+			in = _mm_loadu_si128((const __m128i *)(src + i * 2));
+			_mm_storeu_si128((__m128i *)(dst + i),
+					 sample_finish_x4(_mm_shuffle_epi8(in, m0),
+							 sh, sign));
+			_mm_storeu_si128((__m128i *)(dst + i + 4),
+					 sample_finish_x4(_mm_shuffle_epi8(in, m1),
+							 sh, sign));
+		}
+	} else if (width == 24) {
+		m0 = _mm_loadu_si128((const __m128i *)sample_shuffle_24);
+		/* 16 bytes are loaded for each 12 bytes group */
+		for (; i * 3 + 16 <= nb_samples * 3; i += 4) {
+			in = _mm_loadu_si128((const __m128i *)(src + i * 3));
+			_mm_storeu_si128((__m128i *)(dst + i),
+					 sample_finish_x4(_mm_shuffle_epi8(in, m0),
+							 sh, sign));
+		}
+	}
+
+	return i;
+}
+#elif defined(__ARM_NEON)
+/* 4 words to 4 samples, sh holds the negated shift */
+static inline uint32x4_t sample_finish_x4(uint32x4_t words, int32x4_t sh,
+		bool sign)
+{
+	if (sign)
+		return vreinterpretq_u32_s32(vshlq_s32(vreinterpretq_s32_u32(words),
+						       sh));
+
+	return vshlq_u32(words, sh);
+}
+
+/* 16 and 24 bit samples, returns the number of unpacked samples */
+static uint32_t sample_unpack_simd(const uint8_t *src, uint32_t *dst,
+				   uint32_t nb_samples, uint8_t width,
+				   uint8_t shift, bool sign)
+{
+	int32x4_t sh = vdupq_n_s32(-(int32_t)shift);
+	uint32x4_t lo, hi;
+	uint16x8_t top, low;
+	uint8x8x3_t in3;
+	uint8x8x2_t in2;
+	uint32_t i = 0;
+
+	if (width == 16) {
+		for (; i + 8 <= nb_samples; i += 8) {
+			/* Deinterleave the high and low bytes */
+			in2 = vld2_u8(src + i * 2);
+			top = vorrq_u16(vshll_n_u8(in2.val[0], 8),
+					vmovl_u8(in2.val[1]));
+			lo = vshll_n_u16(vget_low_u16(top), 16);
+			hi = vshll_n_u16(vget_high_u16(top), 16);
+			vst1q_u32(dst + i, sample_finish_x4(lo, sh, sign));
+			vst1q_u32(dst + i + 4, sample_finish_x4(hi, sh, sign));
+		}
+	} else if (width == 24) {
+		for (; i + 8 <= nb_samples; i += 8) {
+			in3 = vld3_u8(src + i * 3);
+			top = vorrq_u16(vshll_n_u8(in3.val[0], 8),
+					vmovl_u8(in3.val[1]));
+			low = vmovl_u8(in3.val[2]);
+			lo = vorrq_u32(vshll_n_u16(vget_low_u16(top), 16),
+				       vshll_n_u16(vget_low_u16(low), 8));
+			hi = vorrq_u32(vshll_n_u16(vget_high_u16(top), 16),
+				       vshll_n_u16(vget_high_u16(low), 8));
+			vst1q_u32(dst + i, sample_finish_x4(lo, sh, sign));
+			vst1q_u32(dst + i + 4, sample_finish_x4(hi, sh, sign));
+		}
+	}
+
+	return i;
+}
+#else
+/* 16 and 24 bit samples, returns the number of unpacked samples */
+static uint32_t sample_unpack_simd(const uint8_t *src, uint32_t *dst,
+				   uint32_t nb_samples, uint8_t width,
+				   uint8_t shift, bool sign)
+{
+	uint32_t word, i;
+
+	if (width == 16) {
+		for (i = 0; i < nb_samples; i++, src += 2) {
+			word = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16);
+			dst[i] = sample_finish(word, shift, sign);
+		}
+	} else {
+		for (i = 0; i < nb_samples; i++, src += 3) {
+			word = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) |
+			       ((uint32_t)src[2] << 8);
+			dst[i] = sample_finish(word, shift, sign);
+		}
+	}
+
+	return nb_samples;
+}
+#endif
+
+/***************************************************************************//**
+ * @brief Unpack big endian samples packed back to back into 32 bit words.
+ *
+ * Samples of any width up to 32 bits are supported, 16 and 24 bit samples
+ * (including 16 bit samples with status) use SIMD instructions when available.
+ * src and dst may not overlap.
+ *
+ * @param src        - Packed samples.
+ * @param dst        - Unpacked samples, one per 32 bit word.
+ * @param nb_samples - Number of samples.
+ * @param bits       - Number of bits of a sample, without the status.
+ * @param flags      - SAMPLE_UNPACK_SIGN_EXT to sign extend the samples,
+ *                     SAMPLE_UNPACK_STATUS when each sample is followed by an
+ *                     8 bit status that is to be dropped.
+ *
+ * @return SUCCESS in case of success, -EINVAL if the width is not supported.
+*******************************************************************************/
+int32_t sample_unpack(const uint8_t *src, uint32_t *dst, uint32_t nb_samples,
+		      uint8_t bits, uint32_t flags)
+{
+	bool sign = flags & SAMPLE_UNPACK_SIGN_EXT;
+	uint8_t width = bits;
+	uint8_t shift = 32 - bits;
+	uint32_t done = 0;
+
+	if (flags & SAMPLE_UNPACK_STATUS)
+		width += 8;
+	if (!bits || width > 32)
+		return -EINVAL;
+
+	if (width == 16 || width == 24)
+		done = sample_unpack_simd(src, dst, nb_samples, width, shift, sign);
+
+	if (done < nb_samples)
+		sample_unpack_bits(src + done * width / 8, dst + done,
+				   nb_samples - done, width, shift, sign);
+
+	return SUCCESS;
+}